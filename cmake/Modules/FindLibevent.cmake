@@ -17,10 +17,12 @@ endforeach()
 find_path(LIBEVENT_INCLUDE_DIRS event.h PATHS ${LibEvent_INCLUDE_PATHS})
 # "lib" prefix is needed on Windows
 find_library(LIBEVENT_LIBRARIES NAMES event libevent PATHS ${LibEvent_LIBRARIES_PATHS})
+# pthread support, needed by evthread_use_pthreads()
+find_library(LIBEVENT_PTHREADS_LIBRARIES NAMES event_pthreads PATHS ${LibEvent_LIBRARIES_PATHS})
 
-if (LIBEVENT_LIBRARIES AND LIBEVENT_INCLUDE_DIRS)
+if (LIBEVENT_LIBRARIES AND LIBEVENT_PTHREADS_LIBRARIES AND LIBEVENT_INCLUDE_DIRS)
   set(Libevent_FOUND TRUE)
-  set(LIBEVENT_LIBRARIES ${LIBEVENT_LIBRARIES})
+  set(LIBEVENT_LIBRARIES ${LIBEVENT_LIBRARIES} ${LIBEVENT_PTHREADS_LIBRARIES})
 else ()
   set(Libevent_FOUND FALSE)
 endif ()
@@ -38,5 +40,6 @@ endif ()
 
 mark_as_advanced(
     LIBEVENT_LIBRARIES
+    LIBEVENT_PTHREADS_LIBRARIES
     LIBEVENT_INCLUDE_DIRS
   )
@@ -0,0 +1,16 @@
+#!/bin/bash
+# Group commit sweep : commits/s and fsync count for each commit delay (us)
+# at 1-64 backends. Each summary line ends with "<commits/s> <fsyncs>".
+WRITE=1.0
+DURATION=5000
+for delay in 0 100 500 1000
+do
+	filename="group_commit_${delay}.log"
+	for backend in 1 2 4 8 16 32 64
+	do
+		./logger -l 1 -a 1 -y 1 -w 0 -m ${delay} -b ${backend} -u ${WRITE} -d ${DURATION}
+		sleep 1
+		echo "-m ${delay} -b ${backend} -u ${WRITE}" >> $filename
+		tail -n 1 outputfile.summary >> $filename
+	done
+done
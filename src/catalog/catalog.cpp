@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <atomic>
 #include <iostream>
 
 #include "catalog/catalog.h"
@@ -22,6 +23,9 @@
 namespace peloton {
 namespace catalog {
 
+// Version of the schema, see GetSchemaVersion()
+static std::atomic<uint64_t> schema_version(0);
+
 // Get instance of the global catalog
 std::unique_ptr<Catalog> Catalog::GetInstance(void) {
   static std::unique_ptr<Catalog> global_catalog (new Catalog());
@@ -54,6 +58,7 @@ Result Catalog::CreateDatabase(std::string database_name) {
   storage::Database *database = new storage::Database(database_id);
   database->setDBName(database_name);
   databases.push_back(database);
+  BumpSchemaVersion();
   // Update catalog_db with this database info
   auto tuple = GetDatabaseCatalogTuple(databases[START_OID]->GetTableWithName(DATABASE_CATALOG_NAME)->GetSchema(),
 		  database_id,
@@ -80,6 +85,7 @@ Result Catalog::CreateTable(std::string database_name, std::string table_name, s
 			  database_id, table_id, schema.release(), table_name,
 			  DEFAULT_TUPLES_PER_TILEGROUP, own_schema, adapt_table);
 	  GetDatabaseWithOid(database_id)->AddTable(table);
+	  BumpSchemaVersion();
 	  // Update catalog_table with this table info
 	  auto tuple = GetTableCatalogTuple(databases[START_OID]->GetTableWithName(TABLE_CATALOG_NAME)->GetSchema(),
 			  table_id, table_name, database_id, database->GetDBName());
@@ -115,6 +121,7 @@ Result Catalog::DropDatabase(std::string database_name) {
 	// Drop the database
     LOG_INFO("Deleting database from database vector");
 	databases.erase(databases.begin() + database_offset);
+	BumpSchemaVersion();
   }
   else{
 	  LOG_INFO("Database is not found!");
@@ -138,6 +145,7 @@ Result Catalog::DropTable(std::string database_name, std::string table_name) {
 		  catalog::DeleteTuple(GetDatabaseWithName(CATALOG_DATABASE_NAME)->GetTableWithName(TABLE_CATALOG_NAME), table_id);
 		  LOG_INFO("Deleting table!");
 		  database->DropTableWithOid(table_id);
+		  BumpSchemaVersion();
 		  return Result::RESULT_SUCCESS;
 	  }
 	  else{
@@ -258,5 +266,9 @@ int Catalog::GetDatabaseCount() { return databases.size(); }
 
 oid_t Catalog::GetNewID() { return id_cntr++;}
 
+uint64_t Catalog::GetSchemaVersion() { return schema_version.load(); }
+
+void Catalog::BumpSchemaVersion() { schema_version++; }
+
 }
 }
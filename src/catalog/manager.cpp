@@ -155,5 +155,51 @@ index::Index *Manager::GetIndexWithOid(const oid_t database_oid,
   return nullptr;
 }
 
+//===--------------------------------------------------------------------===//
+// STATISTICS
+//===--------------------------------------------------------------------===//
+
+void Manager::SetTableStats(const oid_t table_oid,
+                            std::shared_ptr<optimizer::TableStats> stats) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  table_stats[table_oid] = stats;
+}
+
+std::shared_ptr<optimizer::TableStats> Manager::GetTableStats(
+    const oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  auto it = table_stats.find(table_oid);
+  if (it == table_stats.end()) return nullptr;
+  return it->second;
+}
+
+void Manager::DropTableStats(const oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  table_stats.erase(table_oid);
+}
+
+void Manager::AddTableWriteStats(
+    const oid_t table_oid, std::shared_ptr<optimizer::TableWriteStats> stats) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  table_write_stats[table_oid] = stats;
+}
+
+std::shared_ptr<optimizer::TableWriteStats> Manager::GetTableWriteStats(
+    const oid_t table_oid) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  auto it = table_write_stats.find(table_oid);
+  if (it == table_write_stats.end()) return nullptr;
+  return it->second;
+}
+
+void Manager::DropTableWriteStats(const oid_t table_oid,
+                                  const optimizer::TableWriteStats *stats) {
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  auto it = table_write_stats.find(table_oid);
+  if (it != table_write_stats.end() && it->second.get() == stats) {
+    table_write_stats.erase(it);
+  }
+}
+
 }  // End catalog namespace
 }  // End peloton namespace
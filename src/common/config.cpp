@@ -18,3 +18,12 @@ DEFINE_uint64(max_connections, 64,
               "Maximum number of connections (default: 64)");
 DEFINE_string(socket_family, "AF_INET", "Socket family (AF_UNIX, AF_INET)");
 DEFINE_bool(h, false, "Show help");
+DEFINE_string(connection_model, "event",
+              "Connection handling model (event, thread)");
+DEFINE_uint64(io_threads, 2,
+              "Number of event server I/O threads (default: 2)");
+DEFINE_uint64(worker_threads, 16,
+              "Number of event server worker threads (default: 16)");
+DEFINE_uint64(max_in_flight, 256,
+              "Maximum number of connections queued or executing in the "
+              "event server worker pool (default: 256)");
@@ -31,4 +31,29 @@ char *peloton_log_directory;
 // Wait Time Out
 int64_t peloton_wait_timeout;
 
+// Group commit delay (in microseconds)
 int peloton_flush_frequency_micros;
+
+// Max commits in a group commit (0 means no limit)
+int peloton_group_commit_size;
+
+// Threads of a hash aggregation (0 or 1 means no parallel aggregation)
+int peloton_aggregate_thread_count;
+
+// Threads of a radix hash join (0 means the tuple at a time hash join)
+int peloton_hash_join_thread_count;
+
+// Bytes an order by buffers before it spills sorted runs (0 means no bound)
+int64_t peloton_sort_memory_budget;
+
+// Period of the cold tile group compressor (in ms, 0 means no compressor)
+int peloton_compression_period;
+
+// Threads of log recovery (0 or 1 means the log is replayed while read)
+int peloton_recovery_thread_count;
+
+// Threads of fuzzy checkpoints and their recovery (0 or 1 means serial)
+int peloton_checkpoint_thread_count;
+
+// Tuples ANALYZE samples per table (0 means 30000)
+int peloton_stats_sample_size;
@@ -14,6 +14,7 @@
 #include "common/init.h"
 
 #include "libcds/cds/init.h"
+#include "storage/tile_group_compressor.h"
 
 #include <google/protobuf/stubs/common.h>
 
@@ -24,10 +25,19 @@ void PelotonInit::Initialize() {
   // Initialize CDS library
   cds::Initialize();
 
+  // Compress cold tile groups in the background
+  if (peloton_compression_period > 0) {
+    storage::TileGroupCompressor::GetInstance().StartCompressor(
+        peloton_compression_period);
+  }
+
 }
 
 void PelotonInit::Shutdown() {
 
+  // Stop compressing tile groups
+  storage::TileGroupCompressor::GetInstance().StopCompressor();
+
   // Terminate CDS library
   cds::Terminate();
 
@@ -80,4 +80,12 @@ const std::shared_ptr<planner::AbstractPlan>& Statement::GetPlanTree() const {
   return plan_tree;
 }
 
+void Statement::SetParamValues(const std::vector<Value>& param_values_){
+  param_values = param_values_;
+}
+
+const std::vector<Value>& Statement::GetParamValues() const {
+  return param_values;
+}
+
 }  // namespace peloton
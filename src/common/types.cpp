@@ -658,6 +658,7 @@ std::string PlanNodeTypeToString(PlanNodeType type) {
     case PLAN_NODE_TYPE_SEND: { return "SEND"; }
     case PLAN_NODE_TYPE_RECEIVE: { return "RECEIVE"; }
     case PLAN_NODE_TYPE_PRINT: { return "PRINT"; }
+    case PLAN_NODE_TYPE_GATHER: { return "GATHER"; }
     case PLAN_NODE_TYPE_AGGREGATE: { return "AGGREGATE"; }
     case PLAN_NODE_TYPE_HASHAGGREGATE: { return "HASHAGGREGATE"; }
     case PLAN_NODE_TYPE_UNION: { return "UNION"; }
@@ -703,6 +704,8 @@ PlanNodeType StringToPlanNodeType(const std::string& str) {
     return PLAN_NODE_TYPE_RECEIVE;
   } else if (str == "PRINT") {
     return PLAN_NODE_TYPE_PRINT;
+  } else if (str == "GATHER") {
+    return PLAN_NODE_TYPE_GATHER;
   } else if (str == "AGGREGATE") {
     return PLAN_NODE_TYPE_AGGREGATE;
   } else if (str == "HASHAGGREGATE") {
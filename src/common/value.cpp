@@ -127,9 +127,14 @@ Value::Value(const Value &other) {
   }
 }
 
-Value Value::Clone(const Value &src, VarlenPool *varlen_pool UNUSED_ATTRIBUTE) {
+Value Value::Clone(const Value &src, VarlenPool *varlen_pool) {
   Value rv = src;
 
+  // An inlined value points into the storage of its tuple
+  if (varlen_pool != nullptr && rv.m_sourceInlined) {
+    rv.AllocateObjectFromInlinedValue(varlen_pool);
+  }
+
   return rv;
 }
 
@@ -11,11 +11,226 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <chrono>
+
 #include "concurrency/epoch_manager.h"
+#include "common/exception.h"
+#include "common/logger.h"
 
 namespace peloton {
 namespace concurrency {
 
-//  volatile cid_t EpochManager::curr_epoch_ = 1;
+constexpr size_t EpochSlot::MAX_EPOCH;
+
+namespace {
+
+// Releases the slot of a thread when the thread exits
+struct EpochSlotHandle {
+  EpochSlot *slot = nullptr;
+
+  ~EpochSlotHandle() {
+    if (slot != nullptr) {
+      slot->Init();
+      slot->in_use_ = false;
+    }
+  }
+};
+
+thread_local EpochSlotHandle epoch_slot_handle;
+
+}  // namespace
+
+EpochManager::EpochManager()
+    : epoch_slot_count_(0),
+      current_epoch_(0),
+      tail_epoch_(0),
+      max_dead_cid_(0),
+      tail_update_count_(0),
+      epoch_length_(EPOCH_LENGTH),
+      finish_(false) {
+  ts_thread_ = std::thread(&EpochManager::Start, this);
+}
+
+EpochManager::~EpochManager() {
+  finish_ = true;
+  ts_thread_.join();
+}
+
+void EpochManager::Reset() {
+  finish_ = true;
+  ts_thread_.join();
+
+  current_epoch_ = 0;
+  tail_epoch_ = 0;
+  max_dead_cid_ = 0;
+  for (size_t slot_itr = 0; slot_itr < epoch_slot_count_; slot_itr++) {
+    epoch_slots_[slot_itr].max_cid_ = 0;
+  }
+
+  finish_ = false;
+  ts_thread_ = std::thread(&EpochManager::Start, this);
+}
+
+size_t EpochManager::EnterEpoch(cid_t begin_cid) {
+  auto &slot = GetThreadSlot();
+
+  slot.depth_++;
+  if (slot.depth_ == 1) {
+    // The background thread may advance the epoch before it sees our
+    // registration, so register again until the epoch holds still
+    auto epoch = current_epoch_.load();
+    while (true) {
+      slot.epoch_ = epoch;
+      auto latest_epoch = current_epoch_.load();
+      if (latest_epoch == epoch) break;
+      epoch = latest_epoch;
+    }
+  }
+
+  if (begin_cid != 0 && slot.cid_depth_ == 0) {
+    slot.begin_cid_ = begin_cid;
+    slot.cid_depth_ = slot.depth_;
+    if (begin_cid > slot.max_cid_.load()) {
+      slot.max_cid_ = begin_cid;
+    }
+  }
+
+  return slot.epoch_.load();
+}
+
+size_t EpochManager::EnterEpoch(const std::function<cid_t()> &next_begin_cid,
+                                cid_t &begin_cid) {
+  auto epoch = EnterEpoch(0);
+  auto &slot = GetThreadSlot();
+
+  // A nested txn is covered by the begin cid of the outer one
+  if (slot.cid_depth_ != 0) {
+    begin_cid = next_begin_cid();
+    return epoch;
+  }
+
+  slot.cid_depth_ = slot.depth_;
+  while (true) {
+    begin_cid = next_begin_cid();
+    slot.begin_cid_ = begin_cid;
+    if (begin_cid > slot.max_cid_.load()) {
+      slot.max_cid_ = begin_cid;
+    }
+
+    // Passes that begin from now on see the begin cid, one that read the
+    // slot before may still raise the max dead txn cid past it
+    WaitForTailUpdate();
+    if (begin_cid >= max_dead_cid_.load()) break;
+
+    LOG_TRACE("Begin cid %lu is behind the max dead txn cid", begin_cid);
+  }
+
+  return epoch;
+}
+
+void EpochManager::ExitEpoch(UNUSED_ATTRIBUTE size_t epoch) {
+  auto &slot = GetThreadSlot();
+
+  PL_ASSERT(slot.depth_ > 0);
+  PL_ASSERT(epoch >= slot.epoch_.load());
+
+  if (slot.depth_ == slot.cid_depth_) {
+    slot.begin_cid_ = MAX_CID;
+    slot.cid_depth_ = 0;
+  }
+
+  slot.depth_--;
+  if (slot.depth_ == 0) {
+    slot.epoch_ = EpochSlot::MAX_EPOCH;
+  }
+}
+
+void EpochManager::Start() {
+  while (!finish_) {
+    // the epoch advances every epoch length.
+    std::this_thread::sleep_for(std::chrono::milliseconds(epoch_length_));
+
+    current_epoch_++;
+
+    UpdateTail();
+  }
+}
+
+void EpochManager::UpdateTail() {
+  tail_update_count_++;
+
+  auto current_epoch = current_epoch_.load();
+
+  size_t tail_epoch = current_epoch;
+  cid_t min_active_cid = MAX_CID;
+  cid_t max_cid = 0;
+
+  size_t slot_count = epoch_slot_count_.load();
+  for (size_t slot_itr = 0; slot_itr < slot_count; slot_itr++) {
+    auto &slot = epoch_slots_[slot_itr];
+
+    // Read the max cid first, a txn that raised it has published its
+    // begin cid already
+    max_cid = std::max(max_cid, slot.max_cid_.load());
+    min_active_cid = std::min(min_active_cid, slot.begin_cid_.load());
+    tail_epoch = std::min(tail_epoch, slot.epoch_.load());
+  }
+
+  if (tail_epoch > tail_epoch_.load()) {
+    tail_epoch_ = tail_epoch;
+  }
+
+  // Every txn that began before the oldest running one is dead
+  cid_t max_dead_cid = max_cid;
+  if (min_active_cid != MAX_CID) {
+    max_dead_cid = std::min(max_dead_cid, min_active_cid - 1);
+  }
+  AtomicMax(max_dead_cid_, max_dead_cid);
+
+  tail_update_count_++;
 }
+
+void EpochManager::WaitForTailUpdate() {
+  auto update_count = tail_update_count_.load();
+  if (update_count % 2 == 0) return;
+
+  while (tail_update_count_.load() == update_count) {
+    std::this_thread::yield();
+  }
 }
+
+EpochSlot &EpochManager::GetThreadSlot() {
+  if (epoch_slot_handle.slot != nullptr) {
+    return *epoch_slot_handle.slot;
+  }
+
+  // Claim a free slot. A slot is held until its thread exits, so waiting
+  // for one could take forever.
+  for (size_t slot_itr = 0; slot_itr < MAX_EPOCH_THREAD_COUNT; slot_itr++) {
+    auto &slot = epoch_slots_[slot_itr];
+    bool expected = false;
+    if (slot.in_use_.compare_exchange_strong(expected, true) == false) {
+      continue;
+    }
+
+    // Let the background thread see the slot
+    auto slot_count = epoch_slot_count_.load();
+    while (slot_count < slot_itr + 1 &&
+           epoch_slot_count_.compare_exchange_weak(slot_count,
+                                                   slot_itr + 1) == false)
+      ;
+
+    epoch_slot_handle.slot = &slot;
+    return slot;
+  }
+
+  LOG_ERROR("More than %d threads use the epoch manager",
+            MAX_EPOCH_THREAD_COUNT);
+  throw TransactionException("More than " +
+                             std::to_string(MAX_EPOCH_THREAD_COUNT) +
+                             " threads use the epoch manager");
+}
+
+}  // End concurrency namespace
+}  // End peloton namespace
@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+
 #include "concurrency/transaction_manager.h"
 #include "expression/container_tuple.h"
 
@@ -20,6 +22,159 @@ namespace concurrency {
 // Current transaction for the backend thread
 thread_local Transaction *current_txn;
 
+namespace {
+
+// Ids the backend thread took from a txn manager, [next_id, end_id)
+struct IdBlock {
+  const TransactionManager *owner = nullptr;
+  size_t generation = 0;
+  uint64_t start_id = 0;
+  uint64_t next_id = 0;
+  uint64_t end_id = 0;
+  // ids taken at the next refill
+  uint64_t size = 0;
+};
+
+thread_local IdBlock txn_id_block;
+thread_local IdBlock commit_id_block;
+
+}  // namespace
+
+txn_id_t TransactionManager::GetNextTransactionId() {
+  auto &block = txn_id_block;
+  auto generation = block_generation_.load();
+
+  if (block.next_id == block.end_id || block.owner != this ||
+      block.generation != generation) {
+    block.owner = this;
+    block.generation = generation;
+    block.next_id = next_txn_id_.fetch_add(TXN_ID_BLOCK_SIZE);
+    block.end_id = block.next_id + TXN_ID_BLOCK_SIZE;
+  }
+
+  return block.next_id++;
+}
+
+cid_t TransactionManager::GetNextThreadCommitId() {
+  auto &block = commit_id_block;
+  auto generation = block_generation_.load();
+
+  // Both are read mostly, only writers and the epoch thread move them
+  cid_t published_cid = max_published_cid_.load();
+  cid_t stale_cid = std::max(
+      published_cid, EpochManagerFactory::GetInstance().GetMaxDeadTxnCid());
+
+  bool used_up = (block.next_id == block.end_id);
+  bool stale = (block.next_id <= stale_cid);
+  if (used_up || stale || block.owner != this ||
+      block.generation != generation) {
+    // Only commits of other threads make a block stale, and under writes
+    // they do so before most of its ids are used. The block halves whenever
+    // ids go to waste and doubles whenever it is used up before a commit
+    // landed in it, so writers end up taking one id per begin and readers a
+    // whole block.
+    if (block.owner != this || block.generation != generation) {
+      block.size = COMMIT_ID_BLOCK_SIZE;
+    } else if (used_up == false) {
+      block.size = std::max<uint64_t>(block.size / 2, 1);
+    } else if (block.start_id > published_cid) {
+      block.size = std::min<uint64_t>(block.size * 2, COMMIT_ID_BLOCK_SIZE);
+    }
+
+    block.owner = this;
+    block.generation = generation;
+    block.start_id = next_cid_.fetch_add(block.size);
+    block.next_id = block.start_id;
+    block.end_id = block.start_id + block.size;
+  }
+
+  cid_t commit_id = block.next_id++;
+  // wait if we do not yet have a grant for this commit id
+  while (commit_id > maximum_grant_cid_.load())
+    ;
+  return commit_id;
+}
+
+void GetPositionList(const VisibilityBitmap &bitmap,
+                     std::vector<oid_t> &position_list) {
+  oid_t word_count = bitmap.size();
+  for (oid_t word_itr = 0; word_itr < word_count; word_itr++) {
+    uint64_t word = bitmap[word_itr];
+    while (word != 0) {
+      position_list.push_back(word_itr * 64 + __builtin_ctzll(word));
+      // clear the lowest set bit
+      word &= word - 1;
+    }
+  }
+}
+
+/*
+ * The branches of IsVisible() folded into a single expression. A version
+ * owned by another transaction that has not committed has a begin cid of
+ * MAX_CID, which no snapshot has reached, so it needs no case of its own.
+ * "fetch" reads the txn id and the begin/end cids of a slot.
+ */
+template <typename Fetch>
+static void FillVisibilityBitmap(Fetch fetch, const oid_t tuple_count,
+                                 const cid_t begin_cid, const txn_id_t txn_id,
+                                 const std::pair<cid_t, cid_t> &dirty_range,
+                                 VisibilityBitmap &bitmap) {
+  bitmap.assign((tuple_count + 63) / 64, 0);
+
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    txn_id_t tuple_txn_id;
+    cid_t tuple_begin_cid;
+    cid_t tuple_end_cid;
+    fetch(tuple_id, tuple_txn_id, tuple_begin_cid, tuple_end_cid);
+
+    bool available = (tuple_txn_id != INVALID_TXN_ID) &
+                     !((tuple_begin_cid > dirty_range.first) &
+                       (tuple_begin_cid <= dirty_range.second));
+    bool own = (tuple_txn_id == txn_id);
+    bool own_visible =
+        (tuple_begin_cid == MAX_CID) & (tuple_end_cid != INVALID_CID);
+    bool other_visible =
+        (begin_cid >= tuple_begin_cid) & (begin_cid < tuple_end_cid);
+    bool visible =
+        available & ((own & own_visible) | (!own & other_visible));
+
+    bitmap[tuple_id / 64] |= uint64_t(visible) << (tuple_id % 64);
+  }
+}
+
+oid_t TransactionManager::ComputeVisibility(
+    const storage::TileGroupHeader *const tile_group_header,
+    const cid_t &begin_cid, const txn_id_t &txn_id,
+    VisibilityBitmap &bitmap) {
+  oid_t tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+
+  const txn_id_t *txn_ids = tile_group_header->GetTransactionIdArray();
+  if (txn_ids != nullptr) {
+    // column layout, stream through the arrays
+    const cid_t *begin_cids = tile_group_header->GetBeginCommitIdArray();
+    const cid_t *end_cids = tile_group_header->GetEndCommitIdArray();
+    FillVisibilityBitmap(
+        [=](oid_t tuple_id, txn_id_t &tuple_txn_id, cid_t &tuple_begin_cid,
+            cid_t &tuple_end_cid) {
+          tuple_txn_id = txn_ids[tuple_id];
+          tuple_begin_cid = begin_cids[tuple_id];
+          tuple_end_cid = end_cids[tuple_id];
+        },
+        tuple_count, begin_cid, txn_id, dirty_range_, bitmap);
+  } else {
+    FillVisibilityBitmap(
+        [=](oid_t tuple_id, txn_id_t &tuple_txn_id, cid_t &tuple_begin_cid,
+            cid_t &tuple_end_cid) {
+          tuple_txn_id = tile_group_header->GetTransactionId(tuple_id);
+          tuple_begin_cid = tile_group_header->GetBeginCommitId(tuple_id);
+          tuple_end_cid = tile_group_header->GetEndCommitId(tuple_id);
+        },
+        tuple_count, begin_cid, txn_id, dirty_range_, bitmap);
+  }
+
+  return tuple_count;
+}
+
 bool TransactionManager::IsOccupied(const ItemPointer &position) {
   auto tile_group_header =
       catalog::Manager::GetInstance().GetTileGroup(position.block)->GetHeader();
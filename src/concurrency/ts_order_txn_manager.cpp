@@ -305,6 +305,9 @@ Result TsOrderTxnManager::CommitTransaction() {
   // generate transaction id.
   cid_t end_commit_id = current_txn->GetBeginCommitId();
 
+  // Txns that begin from now on must come after this one
+  PublishCommitId(end_commit_id);
+
   auto &rw_set = current_txn->GetRWSet();
 
   // TODO: Add optimization for read only
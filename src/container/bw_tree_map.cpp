@@ -0,0 +1,865 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bw_tree_map.cpp
+//
+// Identification: src/container/bw_tree_map.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <thread>
+
+#include "container/bw_tree_map.h"
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "common/types.h"
+#include "concurrency/epoch_manager.h"
+
+#include "index/index_key.h"
+
+namespace peloton {
+
+namespace {
+
+// Keeps the nodes seen by an operation from being freed under it
+class EpochGuard {
+ public:
+  EpochGuard()
+      : epoch_(concurrency::EpochManagerFactory::GetInstance().EnterEpoch(0)) {}
+
+  ~EpochGuard() {
+    concurrency::EpochManagerFactory::GetInstance().ExitEpoch(epoch_);
+  }
+
+ private:
+  size_t epoch_;
+};
+
+}  // namespace
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+BW_TREE_MAP_TYPE::Node::Node(NodeType type, const Node *next)
+    : type(type),
+      next(next),
+      base(next == nullptr ? static_cast<const BaseNode *>(this) : next->base),
+      chain_length(next == nullptr ? 0 : next->chain_length + 1) {}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+BW_TREE_MAP_TYPE::BwTreeMap()
+    : next_node_id_(0),
+      root_id_(INVALID_NODE_ID),
+      garbage_head_(nullptr),
+      garbage_count_(0),
+      garbage_collection_epoch_(0),
+      collecting_garbage_(false) {
+  for (auto &mapping_chunk : mapping_chunks_) {
+    mapping_chunk.store(nullptr);
+  }
+
+  // The tree starts out as a single empty leaf
+  NodeId root_id = AllocateNodeId();
+  GetSlot(root_id).store(new LeafNode());
+  root_id_ = root_id;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+BW_TREE_MAP_TYPE::~BwTreeMap() {
+  // No operation can be running anymore, everything goes at once
+  NodeId node_count = std::min<NodeId>(next_node_id_.load(),
+                                       MAPPING_CHUNK_SIZE * MAPPING_CHUNK_COUNT);
+  for (NodeId node_id = 0; node_id < node_count; node_id++) {
+    const Node *head = GetNode(node_id);
+    if (head == nullptr) continue;
+
+    if (head->IsLeaf()) {
+      auto contents = CollectLeaf(head);
+      for (auto &item : contents.items) {
+        value_deleter_(item.second);
+      }
+      for (auto &value : contents.dead_values) {
+        value_deleter_(value);
+      }
+    }
+
+    FreeChain(head);
+  }
+
+  GarbageNode *garbage = garbage_head_.load();
+  while (garbage != nullptr) {
+    GarbageNode *next = garbage->next;
+    FreeChain(garbage->chain);
+    for (auto &value : garbage->values) {
+      value_deleter_(value);
+    }
+    delete garbage;
+    garbage = next;
+  }
+
+  for (auto &mapping_chunk : mapping_chunks_) {
+    delete[] mapping_chunk.load();
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Operations
+//===--------------------------------------------------------------------===//
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Insert(const KeyType &key, const ValueType &value) {
+  EpochGuard epoch_guard;
+
+  while (true) {
+    const Node *head;
+    NodeId parent_id;
+    NodeId node_id = FindLeaf(&key, head, parent_id);
+
+    if (InstallLeafDelta(node_id, parent_id, head, NODE_TYPE_LEAF_INSERT, key,
+                         value)) {
+      return;
+    }
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+bool BW_TREE_MAP_TYPE::ConditionalInsert(
+    const KeyType &key, const ValueType &value,
+    std::function<bool(const ValueType &)> predicate) {
+  EpochGuard epoch_guard;
+
+  while (true) {
+    const Node *head;
+    NodeId parent_id;
+    NodeId node_id = FindLeaf(&key, head, parent_id);
+
+    // The delta only goes in if the leaf did not change since the check
+    std::vector<ValueType> values;
+    CollectValues(head, key, values);
+    for (auto &existing_value : values) {
+      if (predicate(existing_value)) return false;
+    }
+
+    if (InstallLeafDelta(node_id, parent_id, head, NODE_TYPE_LEAF_INSERT, key,
+                         value)) {
+      return true;
+    }
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+bool BW_TREE_MAP_TYPE::Delete(const KeyType &key, const ValueType &value) {
+  EpochGuard epoch_guard;
+
+  while (true) {
+    const Node *head;
+    NodeId parent_id;
+    NodeId node_id = FindLeaf(&key, head, parent_id);
+
+    // Don't grow the chain if there is nothing to delete
+    std::vector<ValueType> values;
+    CollectValues(head, key, values);
+    bool found = false;
+    for (auto &existing_value : values) {
+      if (value_equals_(existing_value, value)) {
+        found = true;
+        break;
+      }
+    }
+    if (found == false) return false;
+
+    if (InstallLeafDelta(node_id, parent_id, head, NODE_TYPE_LEAF_DELETE, key,
+                         value)) {
+      return true;
+    }
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Find(const KeyType &key,
+                            std::vector<ValueType> &values) {
+  EpochGuard epoch_guard;
+
+  const Node *head;
+  NodeId parent_id;
+  FindLeaf(&key, head, parent_id);
+
+  CollectValues(head, key, values);
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Find(const KeyType &key,
+                            std::function<void(const ValueType &)> visitor) {
+  EpochGuard epoch_guard;
+
+  const Node *head;
+  NodeId parent_id;
+  FindLeaf(&key, head, parent_id);
+
+  std::vector<ValueType> values;
+  CollectValues(head, key, values);
+  for (auto &value : values) {
+    visitor(value);
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Scan(
+    const KeyType *low_key, const KeyType *high_key,
+    std::vector<std::pair<KeyType, ValueType>> &result) {
+  Scan(low_key, high_key,
+       [&result](const KeyType &key, const ValueType &value) {
+         result.emplace_back(key, value);
+       });
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Scan(
+    const KeyType *low_key, const KeyType *high_key,
+    std::function<void(const KeyType &, const ValueType &)> visitor) {
+  EpochGuard epoch_guard;
+
+  const Node *head;
+  NodeId parent_id;
+  FindLeaf(low_key, head, parent_id);
+
+  // Walk the leaves through their right siblings, the ranges of the
+  // siblings line up even if they split in the meantime
+  while (true) {
+    auto contents = CollectLeaf(head);
+    for (auto &item : contents.items) {
+      if (low_key != nullptr && Compare(item.first, *low_key) < 0) continue;
+      if (high_key != nullptr && Compare(item.first, *high_key) > 0) return;
+      visitor(item.first, item.second);
+    }
+
+    const BaseNode *base = head->base;
+    if (base->has_high_key == false) return;
+    if (high_key != nullptr && Compare(base->high_key, *high_key) > 0) return;
+
+    head = GetNode(base->right_sibling);
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Mapping table
+//===--------------------------------------------------------------------===//
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+std::atomic<const typename BW_TREE_MAP_TYPE::Node *> &BW_TREE_MAP_TYPE::GetSlot(
+    NodeId node_id) const {
+  auto mapping_chunk = mapping_chunks_[node_id / MAPPING_CHUNK_SIZE].load(
+      std::memory_order_acquire);
+  return mapping_chunk[node_id % MAPPING_CHUNK_SIZE];
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+typename BW_TREE_MAP_TYPE::NodeId BW_TREE_MAP_TYPE::AllocateNodeId() {
+  NodeId node_id = next_node_id_.fetch_add(1);
+
+  size_t chunk_offset = node_id / MAPPING_CHUNK_SIZE;
+  if (chunk_offset >= MAPPING_CHUNK_COUNT) {
+    throw IndexException("Bw-Tree mapping table is full");
+  }
+
+  // The first id of a chunk is not necessarily allocated first
+  if (mapping_chunks_[chunk_offset].load() == nullptr) {
+    auto mapping_chunk = new std::atomic<const Node *>[MAPPING_CHUNK_SIZE];
+    for (size_t slot_itr = 0; slot_itr < MAPPING_CHUNK_SIZE; slot_itr++) {
+      mapping_chunk[slot_itr].store(nullptr);
+    }
+
+    std::atomic<const Node *> *expected = nullptr;
+    if (mapping_chunks_[chunk_offset].compare_exchange_strong(
+            expected, mapping_chunk) == false) {
+      delete[] mapping_chunk;
+    }
+  }
+
+  return node_id;
+}
+
+//===--------------------------------------------------------------------===//
+// Traversal
+//===--------------------------------------------------------------------===//
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+typename BW_TREE_MAP_TYPE::NodeId BW_TREE_MAP_TYPE::FindLeaf(
+    const KeyType *key, const Node *&head, NodeId &parent_id) {
+  NodeId node_id = root_id_.load();
+  parent_id = INVALID_NODE_ID;
+
+  while (true) {
+    const Node *node = GetNode(node_id);
+    const BaseNode *base = node->base;
+
+    if (key != nullptr && IsBeyondHighKey(base, *key)) {
+      // The node split and the parent does not route to the sibling yet
+      if (parent_id != INVALID_NODE_ID) {
+        PostSeparator(parent_id, base->high_key, base->right_sibling);
+      }
+      node_id = base->right_sibling;
+      continue;
+    }
+
+    if (node->IsLeaf()) {
+      head = node;
+      return node_id;
+    }
+
+    if (node->chain_length >= DELTA_CHAIN_MAX_LENGTH) {
+      Consolidate(node_id, parent_id, node);
+    }
+
+    parent_id = node_id;
+    node_id = RouteInner(node, key);
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+typename BW_TREE_MAP_TYPE::NodeId BW_TREE_MAP_TYPE::RouteInner(
+    const Node *head, const KeyType *key) const {
+  const Node *node = head;
+
+  // Newer separators are more precise than the older ones
+  for (; node->type == NODE_TYPE_INNER_INSERT; node = node->next) {
+    if (key == nullptr) continue;
+
+    auto delta = static_cast<const InnerInsertDelta *>(node);
+    if (Compare(*key, delta->key) >= 0 &&
+        (delta->has_next_key == false || Compare(*key, delta->next_key) < 0)) {
+      return delta->child;
+    }
+  }
+
+  auto &children = static_cast<const InnerNode *>(node)->children;
+  if (key == nullptr) return children[0].second;
+
+  // Last child whose separator is not greater than the key
+  size_t low = 1;
+  size_t high = children.size();
+  while (low < high) {
+    size_t middle = (low + high) / 2;
+    if (Compare(children[middle].first, *key) <= 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  return children[low - 1].second;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+typename BW_TREE_MAP_TYPE::NodeId BW_TREE_MAP_TYPE::FindNodeAtLevel(
+    const KeyType &key, size_t level) {
+  while (true) {
+    NodeId node_id = root_id_.load();
+
+    // The root split but the new root is not installed yet
+    if (GetNode(node_id)->base->level < level) {
+      std::this_thread::yield();
+      continue;
+    }
+
+    while (true) {
+      const Node *node = GetNode(node_id);
+      const BaseNode *base = node->base;
+
+      if (IsBeyondHighKey(base, key)) {
+        node_id = base->right_sibling;
+      } else if (base->level == level) {
+        return node_id;
+      } else {
+        node_id = RouteInner(node, &key);
+      }
+    }
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+bool BW_TREE_MAP_TYPE::IsDeleted(const std::vector<ValueType> &deleted_values,
+                                 const ValueType &value) const {
+  for (auto &deleted_value : deleted_values) {
+    if (value_equals_(value, deleted_value)) return true;
+  }
+  return false;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::CollectValues(const Node *head, const KeyType &key,
+                                     std::vector<ValueType> &values) const {
+  // Values deleted by the records seen so far
+  std::vector<ValueType> deleted_values;
+
+  const Node *node = head;
+  for (; node->type != NODE_TYPE_LEAF; node = node->next) {
+    auto delta = static_cast<const LeafDelta *>(node);
+    if (Compare(delta->key, key) != 0) continue;
+
+    if (node->type == NODE_TYPE_LEAF_DELETE) {
+      deleted_values.push_back(delta->value);
+    } else if (IsDeleted(deleted_values, delta->value) == false) {
+      values.push_back(delta->value);
+    }
+  }
+
+  auto &items = static_cast<const LeafNode *>(node)->items;
+  auto item_itr = std::lower_bound(
+      items.begin(), items.end(), key,
+      [this](const std::pair<KeyType, ValueType> &item, const KeyType &key) {
+        return Compare(item.first, key) < 0;
+      });
+  for (; item_itr != items.end() && Compare(item_itr->first, key) == 0;
+       ++item_itr) {
+    if (IsDeleted(deleted_values, item_itr->second) == false) {
+      values.push_back(item_itr->second);
+    }
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+typename BW_TREE_MAP_TYPE::LeafContents BW_TREE_MAP_TYPE::CollectLeaf(
+    const Node *head) const {
+  LeafContents contents;
+
+  std::vector<const LeafDelta *> deltas;
+  const Node *node = head;
+  for (; node->type != NODE_TYPE_LEAF; node = node->next) {
+    deltas.push_back(static_cast<const LeafDelta *>(node));
+  }
+
+  auto &items = contents.items;
+  items = static_cast<const LeafNode *>(node)->items;
+  std::vector<std::pair<KeyType, ValueType>> inserted_items;
+
+  // A delete only hides the pairs that are older than itself
+  auto remove_deleted = [this, &contents](
+      std::vector<std::pair<KeyType, ValueType>> &items,
+      const LeafDelta *delta) {
+    size_t kept_count = 0;
+    for (size_t item_itr = 0; item_itr < items.size(); item_itr++) {
+      if (Compare(items[item_itr].first, delta->key) == 0 &&
+          value_equals_(items[item_itr].second, delta->value)) {
+        contents.dead_values.push_back(items[item_itr].second);
+      } else {
+        items[kept_count++] = items[item_itr];
+      }
+    }
+    items.resize(kept_count, items.front());
+  };
+
+  for (auto delta_itr = deltas.rbegin(); delta_itr != deltas.rend();
+       ++delta_itr) {
+    auto delta = *delta_itr;
+    if (delta->type == NODE_TYPE_LEAF_INSERT) {
+      inserted_items.emplace_back(delta->key, delta->value);
+    } else {
+      if (items.empty() == false) remove_deleted(items, delta);
+      if (inserted_items.empty() == false) {
+        remove_deleted(inserted_items, delta);
+      }
+      contents.dead_values.push_back(delta->value);
+    }
+  }
+
+  if (inserted_items.empty() == false) {
+    auto key_less = [this](const std::pair<KeyType, ValueType> &lhs,
+                           const std::pair<KeyType, ValueType> &rhs) {
+      return Compare(lhs.first, rhs.first) < 0;
+    };
+
+    std::stable_sort(inserted_items.begin(), inserted_items.end(), key_less);
+
+    std::vector<std::pair<KeyType, ValueType>> merged_items;
+    merged_items.reserve(items.size() + inserted_items.size());
+    std::merge(items.begin(), items.end(), inserted_items.begin(),
+               inserted_items.end(), std::back_inserter(merged_items),
+               key_less);
+    items.swap(merged_items);
+  }
+
+  return contents;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+std::vector<std::pair<KeyType, typename BW_TREE_MAP_TYPE::NodeId>>
+BW_TREE_MAP_TYPE::CollectInner(const Node *head) const {
+  std::vector<const InnerInsertDelta *> deltas;
+  const Node *node = head;
+  for (; node->type != NODE_TYPE_INNER; node = node->next) {
+    deltas.push_back(static_cast<const InnerInsertDelta *>(node));
+  }
+
+  auto children = static_cast<const InnerNode *>(node)->children;
+
+  for (auto delta_itr = deltas.rbegin(); delta_itr != deltas.rend();
+       ++delta_itr) {
+    auto delta = *delta_itr;
+
+    // The separator of the first child is never compared
+    auto child_itr = std::lower_bound(
+        children.begin() + 1, children.end(), delta->key,
+        [this](const std::pair<KeyType, NodeId> &child, const KeyType &key) {
+          return Compare(child.first, key) < 0;
+        });
+
+    if (child_itr != children.end() &&
+        Compare(child_itr->first, delta->key) == 0) {
+      child_itr->second = delta->child;
+    } else {
+      children.insert(child_itr, std::make_pair(delta->key, delta->child));
+    }
+  }
+
+  return children;
+}
+
+//===--------------------------------------------------------------------===//
+// Structure modifications
+//===--------------------------------------------------------------------===//
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+bool BW_TREE_MAP_TYPE::InstallLeafDelta(NodeId node_id, NodeId parent_id,
+                                        const Node *head, NodeType type,
+                                        const KeyType &key,
+                                        const ValueType &value) {
+  auto delta = new LeafDelta(type, head, key, value);
+
+  if (InstallNode(node_id, head, delta) == false) {
+    delete delta;
+    return false;
+  }
+
+  if (delta->chain_length >= DELTA_CHAIN_MAX_LENGTH) {
+    Consolidate(node_id, parent_id, delta);
+  }
+
+  return true;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Consolidate(NodeId node_id, NodeId parent_id,
+                                   const Node *head) {
+  const BaseNode *base = head->base;
+
+  if (head->IsLeaf()) {
+    auto contents = CollectLeaf(head);
+    auto &items = contents.items;
+
+    LeafNode *left = new LeafNode();
+    LeafNode *right = nullptr;
+
+    size_t split_position = 0;
+    if (items.size() > LEAF_NODE_MAX_SIZE) {
+      split_position = GetSplitPosition(items);
+    }
+
+    if (split_position != 0) {
+      right = new LeafNode();
+      right->items.assign(items.begin() + split_position, items.end());
+      items.resize(split_position, items.front());
+    }
+    left->items.swap(items);
+
+    if (InstallConsolidation(node_id, parent_id, head, left, right)) {
+      Retire(head, std::move(contents.dead_values));
+    }
+  } else {
+    auto children = CollectInner(head);
+
+    InnerNode *left = new InnerNode();
+    InnerNode *right = nullptr;
+    left->level = base->level;
+
+    if (children.size() > INNER_NODE_MAX_SIZE) {
+      size_t split_position = children.size() / 2;
+      right = new InnerNode();
+      right->level = base->level;
+      right->children.assign(children.begin() + split_position,
+                             children.end());
+      children.resize(split_position, children.front());
+    }
+    left->children.swap(children);
+
+    if (InstallConsolidation(node_id, parent_id, head, left, right)) {
+      Retire(head, std::vector<ValueType>());
+    }
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+size_t BW_TREE_MAP_TYPE::GetSplitPosition(
+    const std::vector<std::pair<KeyType, ValueType>> &items) const {
+  // All the pairs of a key stay in the same leaf
+  size_t middle = items.size() / 2;
+  const KeyType &middle_key = items[middle].first;
+
+  size_t split_position = middle;
+  while (split_position > 0 &&
+         Compare(items[split_position - 1].first, middle_key) == 0) {
+    split_position--;
+  }
+
+  if (split_position == 0) {
+    split_position = middle + 1;
+    while (split_position < items.size() &&
+           Compare(items[split_position].first, middle_key) == 0) {
+      split_position++;
+    }
+  }
+
+  // A single key can't be split
+  if (split_position == items.size()) return 0;
+
+  return split_position;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+bool BW_TREE_MAP_TYPE::InstallConsolidation(NodeId node_id, NodeId parent_id,
+                                            const Node *head, BaseNode *left,
+                                            BaseNode *right) {
+  const BaseNode *base = head->base;
+
+  left->has_high_key = base->has_high_key;
+  left->high_key = base->high_key;
+  left->right_sibling = base->right_sibling;
+
+  // The sibling takes over the upper part of the range
+  NodeId right_id = INVALID_NODE_ID;
+  if (right != nullptr) {
+    right->has_high_key = base->has_high_key;
+    right->high_key = base->high_key;
+    right->right_sibling = base->right_sibling;
+
+    right_id = AllocateNodeId();
+    GetSlot(right_id).store(right);
+
+    left->has_high_key = true;
+    left->high_key = right->IsLeaf()
+                         ? static_cast<LeafNode *>(right)->items.front().first
+                         : static_cast<InnerNode *>(right)->children.front().first;
+    left->right_sibling = right_id;
+  }
+
+  if (InstallNode(node_id, head, left) == false) {
+    // Someone else changed the node first, none of this was seen
+    if (right != nullptr) {
+      GetSlot(right_id).store(nullptr);
+      FreeNode(right);
+    }
+    FreeNode(left);
+    return false;
+  }
+
+  if (right != nullptr) {
+    LOG_TRACE("Split node %lu at level %lu", node_id, base->level);
+    CompleteSplit(node_id, parent_id, left->high_key, right_id, base->level);
+  }
+
+  return true;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::CompleteSplit(NodeId node_id, NodeId parent_id,
+                                     const KeyType &key, NodeId right_id,
+                                     size_t level) {
+  if (parent_id != INVALID_NODE_ID) {
+    PostSeparator(parent_id, key, right_id);
+    return;
+  }
+
+  // Without a parent, the node may be the root. Grow the tree.
+  if (root_id_.load() == node_id) {
+    auto new_root = new InnerNode();
+    new_root->level = level + 1;
+    new_root->children.emplace_back(key, node_id);
+    new_root->children.emplace_back(key, right_id);
+
+    NodeId new_root_id = AllocateNodeId();
+    GetSlot(new_root_id).store(new_root);
+
+    NodeId expected = node_id;
+    if (root_id_.compare_exchange_strong(expected, new_root_id)) return;
+
+    GetSlot(new_root_id).store(nullptr);
+    FreeNode(new_root);
+  }
+
+  PostSeparator(FindNodeAtLevel(key, level + 1), key, right_id);
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::PostSeparator(NodeId parent_id, const KeyType &key,
+                                     NodeId child_id) {
+  const BaseNode *child = GetNode(child_id)->base;
+
+  while (true) {
+    const Node *head = GetNode(parent_id);
+    const BaseNode *base = head->base;
+
+    if (IsBeyondHighKey(base, key)) {
+      parent_id = base->right_sibling;
+      continue;
+    }
+
+    // Already posted by someone else
+    if (RouteInner(head, &key) == child_id) return;
+
+    auto delta = new InnerInsertDelta(head);
+    delta->key = key;
+    delta->child = child_id;
+    delta->has_next_key = child->has_high_key;
+    delta->next_key = child->high_key;
+
+    if (InstallNode(parent_id, head, delta)) {
+      if (delta->chain_length >= DELTA_CHAIN_MAX_LENGTH) {
+        Consolidate(parent_id, INVALID_NODE_ID, delta);
+      }
+      return;
+    }
+
+    delete delta;
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Memory reclamation
+//===--------------------------------------------------------------------===//
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::Retire(const Node *chain,
+                              std::vector<ValueType> &&values) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // The chain is unreachable already, so only operations of the current or
+  // earlier epochs can still be looking at it
+  auto garbage = new GarbageNode();
+  garbage->epoch = epoch_manager.GetCurrentEpoch();
+  garbage->chain = chain;
+  garbage->values = std::move(values);
+  garbage->next = garbage_head_.load();
+  while (garbage_head_.compare_exchange_weak(garbage->next, garbage) == false)
+    ;
+
+  if (garbage_count_.fetch_add(1) + 1 >= GARBAGE_COLLECTION_THRESHOLD &&
+      garbage_collection_epoch_.load() != garbage->epoch) {
+    PerformGarbageCollection();
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::PerformGarbageCollection() {
+  bool expected = false;
+  if (collecting_garbage_.compare_exchange_strong(expected, true) == false) {
+    return;
+  }
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  garbage_collection_epoch_ = epoch_manager.GetCurrentEpoch();
+  size_t tail_epoch = epoch_manager.GetTailEpoch();
+
+  GarbageNode *garbage = garbage_head_.exchange(nullptr);
+  GarbageNode *kept_head = nullptr;
+  GarbageNode *kept_tail = nullptr;
+  size_t freed_count = 0;
+
+  while (garbage != nullptr) {
+    GarbageNode *next = garbage->next;
+
+    if (garbage->epoch < tail_epoch) {
+      FreeChain(garbage->chain);
+      for (auto &value : garbage->values) {
+        value_deleter_(value);
+      }
+      delete garbage;
+      freed_count++;
+    } else {
+      garbage->next = nullptr;
+      if (kept_tail == nullptr) {
+        kept_head = garbage;
+      } else {
+        kept_tail->next = garbage;
+      }
+      kept_tail = garbage;
+    }
+
+    garbage = next;
+  }
+
+  // Put back what is still visible
+  if (kept_head != nullptr) {
+    kept_tail->next = garbage_head_.load();
+    while (garbage_head_.compare_exchange_weak(kept_tail->next, kept_head) ==
+           false)
+      ;
+  }
+
+  LOG_TRACE("Freed %lu retired chains", freed_count);
+  garbage_count_ -= freed_count;
+
+  collecting_garbage_ = false;
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::FreeNode(const Node *node) {
+  switch (node->type) {
+    case NODE_TYPE_LEAF:
+      delete static_cast<const LeafNode *>(node);
+      break;
+    case NODE_TYPE_LEAF_INSERT:
+    case NODE_TYPE_LEAF_DELETE:
+      delete static_cast<const LeafDelta *>(node);
+      break;
+    case NODE_TYPE_INNER:
+      delete static_cast<const InnerNode *>(node);
+      break;
+    case NODE_TYPE_INNER_INSERT:
+      delete static_cast<const InnerInsertDelta *>(node);
+      break;
+  }
+}
+
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+void BW_TREE_MAP_TYPE::FreeChain(const Node *head) {
+  while (head != nullptr) {
+    const Node *next = head->next;
+    FreeNode(head);
+    head = next;
+  }
+}
+
+// Explicit template instantiation
+
+template class BwTreeMap<index::GenericKey<4>, ItemPointer *,
+                         index::GenericComparatorRaw<4>,
+                         ItemPointerPtrEqualityChecker,
+                         std::default_delete<ItemPointer>>;
+template class BwTreeMap<index::GenericKey<8>, ItemPointer *,
+                         index::GenericComparatorRaw<8>,
+                         ItemPointerPtrEqualityChecker,
+                         std::default_delete<ItemPointer>>;
+template class BwTreeMap<index::GenericKey<16>, ItemPointer *,
+                         index::GenericComparatorRaw<16>,
+                         ItemPointerPtrEqualityChecker,
+                         std::default_delete<ItemPointer>>;
+template class BwTreeMap<index::GenericKey<64>, ItemPointer *,
+                         index::GenericComparatorRaw<64>,
+                         ItemPointerPtrEqualityChecker,
+                         std::default_delete<ItemPointer>>;
+template class BwTreeMap<index::GenericKey<256>, ItemPointer *,
+                         index::GenericComparatorRaw<256>,
+                         ItemPointerPtrEqualityChecker,
+                         std::default_delete<ItemPointer>>;
+
+template class BwTreeMap<index::TupleKey, ItemPointer *,
+                         index::TupleKeyComparatorRaw,
+                         ItemPointerPtrEqualityChecker,
+                         std::default_delete<ItemPointer>>;
+
+}  // End peloton namespace
@@ -100,6 +100,11 @@ bool AggregateExecutor::DExecute() {
   // Get an aggregator
   std::unique_ptr<AbstractAggregator> aggregator(nullptr);
 
+  // A parallel hash aggregation needs the whole input before it starts
+  bool parallel_hash = (node.GetAggregateStrategy() == AGGREGATE_TYPE_HASH &&
+                        peloton_aggregate_thread_count > 1);
+  std::vector<std::unique_ptr<LogicalTile>> input_tiles;
+
   // Get input tiles and aggregate them
   while (children_[0]->Execute() == true) {
     std::unique_ptr<LogicalTile> tile(children_[0]->GetOutput());
@@ -128,6 +133,11 @@ bool AggregateExecutor::DExecute() {
       }
     }
 
+    if (parallel_hash) {
+      input_tiles.push_back(std::move(tile));
+      continue;
+    }
+
     LOG_TRACE("Looping over tile..");
 
     for (oid_t tuple_id : *tile) {
@@ -141,6 +151,20 @@ bool AggregateExecutor::DExecute() {
     LOG_TRACE("Finished processing logical tile");
   }
 
+  if (parallel_hash && aggregator.get() != nullptr) {
+    std::vector<LogicalTile *> tiles;
+    for (auto &tile : input_tiles) {
+      tiles.push_back(tile.get());
+    }
+
+    auto hash_aggregator = static_cast<HashAggregator *>(aggregator.get());
+    if (hash_aggregator->AdvanceParallel(tiles,
+                                         peloton_aggregate_thread_count) ==
+        false) {
+      return false;
+    }
+  }
+
   LOG_TRACE("Finalizing..");
   if (!aggregator.get() || !aggregator->Finalize()) {
     // If there's no tuples in the table and only if no group-by in the query,
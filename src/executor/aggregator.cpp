@@ -11,43 +11,68 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <cstring>
 #include <set>
 
 #include "executor/aggregator.h"
 #include "executor/executor_context.h"
+#include "executor/executor_util.h"
+#include "executor/logical_tile.h"
 #include "common/logger.h"
+#include "common/value_peeker.h"
 #include "storage/data_table.h"
 #include "concurrency/transaction_manager_factory.h"
 
 namespace peloton {
 namespace executor {
 
+template <typename AggType, typename... Args>
+static Agg *NewAgg(void *storage, Args... args) {
+  if (storage == nullptr) {
+    return new AggType(args...);
+  }
+  return new (storage) AggType(args...);
+}
+
+const size_t AGG_STATE_SIZE = [] {
+  size_t size = std::max({sizeof(CountAgg), sizeof(CountStarAgg),
+                          sizeof(SumAgg), sizeof(AvgAgg), sizeof(MinAgg),
+                          sizeof(MaxAgg)});
+  size_t alignment = alignof(std::max_align_t);
+  return (size + alignment - 1) / alignment * alignment;
+}();
+
 /*
  * Create an instance of an aggregator for the specified aggregate
  * type, column type, and result type. The object is constructed in
  * memory from the provided memrory pool.
  */
 Agg *GetAggInstance(ExpressionType agg_type) {
+  return GetAggInstance(agg_type, nullptr);
+}
+
+Agg *GetAggInstance(ExpressionType agg_type, void *storage) {
   Agg *aggregator;
 
   switch (agg_type) {
     case EXPRESSION_TYPE_AGGREGATE_COUNT:
-      aggregator = new CountAgg();
+      aggregator = NewAgg<CountAgg>(storage);
       break;
     case EXPRESSION_TYPE_AGGREGATE_COUNT_STAR:
-      aggregator = new CountStarAgg();
+      aggregator = NewAgg<CountStarAgg>(storage);
       break;
     case EXPRESSION_TYPE_AGGREGATE_SUM:
-      aggregator = new SumAgg();
+      aggregator = NewAgg<SumAgg>(storage);
       break;
     case EXPRESSION_TYPE_AGGREGATE_AVG:
-      aggregator = new AvgAgg(false);
+      aggregator = NewAgg<AvgAgg>(storage, false);
       break;
     case EXPRESSION_TYPE_AGGREGATE_MIN:
-      aggregator = new MinAgg();
+      aggregator = NewAgg<MinAgg>(storage);
       break;
     case EXPRESSION_TYPE_AGGREGATE_MAX:
-      aggregator = new MaxAgg();
+      aggregator = NewAgg<MaxAgg>(storage);
       break;
     default: {
       std::string message =
@@ -146,71 +171,250 @@ bool Helper(const planner::AggregatePlan *node, Agg **aggregates,
   return true;
 }
 
+//===--------------------------------------------------------------------===//
+// Aggregate Hash Table
+//===--------------------------------------------------------------------===//
+
+static inline uint64_t HashKey(const uint64_t *key, size_t key_width) {
+  uint64_t hash = key_width;
+  for (size_t word_itr = 0; word_itr < key_width; word_itr++) {
+    hash = MixHash(hash + key[word_itr] + 0x9e3779b97f4a7c15ULL);
+  }
+  return hash;
+}
+
+AggregateHashTable::AggregateHashTable(const planner::AggregatePlan *node,
+                                       size_t num_input_columns,
+                                       size_t key_width)
+    : node_(node),
+      num_input_columns_(num_input_columns),
+      key_width_(key_width),
+      agg_count_(node->GetUniqueAggTerms().size()) {
+  slots_.resize(256, Slot{0, INVALID_OID});
+  slot_mask_ = slots_.size() - 1;
+}
+
+AggregateHashTable::~AggregateHashTable() {
+  // The states live in the chunks, only their destructors are left to run
+  for (oid_t group_id = 0; group_id < group_count_; group_id++) {
+    for (oid_t aggno = 0; aggno < agg_count_; aggno++) {
+      GetAggregate(group_id, aggno)->~Agg();
+    }
+  }
+}
+
+oid_t AggregateHashTable::FindGroup(uint64_t hash, const uint64_t *key) const {
+  auto hash_tag = GetHashTag(hash);
+  auto key_size = key_width_ * sizeof(uint64_t);
+
+  for (size_t slot_itr = hash & slot_mask_;;
+       slot_itr = (slot_itr + 1) & slot_mask_) {
+    auto &slot = slots_[slot_itr];
+    if (slot.group_id == INVALID_OID) {
+      return INVALID_OID;
+    }
+
+    if (slot.hash_tag == hash_tag &&
+        memcmp(&group_keys_[slot.group_id * key_width_], key, key_size) == 0) {
+      return slot.group_id;
+    }
+  }
+}
+
+oid_t AggregateHashTable::FindGroup(
+    uint64_t hash, const std::vector<Value> &key_values) const {
+  auto hash_tag = GetHashTag(hash);
+  auto &group_by_col_ids = node_->GetGroupbyColIds();
+
+  for (size_t slot_itr = hash & slot_mask_;;
+       slot_itr = (slot_itr + 1) & slot_mask_) {
+    auto &slot = slots_[slot_itr];
+    if (slot.group_id == INVALID_OID) {
+      return INVALID_OID;
+    }
+
+    if (slot.hash_tag != hash_tag) {
+      continue;
+    }
+
+    // Compare with the group-by columns of the delegate tuple
+    auto delegate_values = &delegate_values_[slot.group_id * num_input_columns_];
+    bool equal = true;
+    for (oid_t column_itr = 0; column_itr < group_by_col_ids.size();
+         column_itr++) {
+      if (delegate_values[group_by_col_ids[column_itr]].Compare(
+              key_values[column_itr]) != 0) {
+        equal = false;
+        break;
+      }
+    }
+
+    if (equal) {
+      return slot.group_id;
+    }
+  }
+}
+
+oid_t AggregateHashTable::AddGroup(uint64_t hash, const uint64_t *key,
+                                   const AbstractTuple *tuple) {
+  // Keep the slot array at most half full
+  if ((group_count_ + 1) * 2 > slots_.size()) {
+    Grow();
+  }
+
+  oid_t group_id = group_count_++;
+  group_hashes_.push_back(hash);
+  group_keys_.insert(group_keys_.end(), key, key + key_width_);
+
+  // Make a deep copy of the first tuple we meet
+  for (oid_t column_itr = 0; column_itr < num_input_columns_; column_itr++) {
+    delegate_values_.push_back(
+        ValueFactory::Clone(tuple->GetValue(column_itr), nullptr));
+  }
+
+  if (group_id % groups_per_chunk == 0) {
+    state_chunks_.emplace_back(
+        new char[groups_per_chunk * agg_count_ * AGG_STATE_SIZE]);
+  }
+
+  auto &aggregate_terms = node_->GetUniqueAggTerms();
+  for (oid_t aggno = 0; aggno < agg_count_; aggno++) {
+    auto aggregate = GetAggInstance(aggregate_terms[aggno].aggtype,
+                                    GetAggregate(group_id, aggno));
+    aggregate->SetDistinct(aggregate_terms[aggno].distinct);
+  }
+
+  size_t slot_itr = hash & slot_mask_;
+  while (slots_[slot_itr].group_id != INVALID_OID) {
+    slot_itr = (slot_itr + 1) & slot_mask_;
+  }
+  slots_[slot_itr] = Slot{GetHashTag(hash), group_id};
+
+  return group_id;
+}
+
+void AggregateHashTable::GetDelegateTupleValues(
+    oid_t group_id, std::vector<Value> &values) const {
+  auto begin = delegate_values_.begin() + group_id * num_input_columns_;
+  values.assign(begin, begin + num_input_columns_);
+}
+
+void AggregateHashTable::Grow() {
+  std::vector<Slot> slots(slots_.size() * 2, Slot{0, INVALID_OID});
+  slot_mask_ = slots.size() - 1;
+
+  // Group ids are dense, so the slots are rebuilt from the stored hashes
+  for (oid_t group_id = 0; group_id < group_count_; group_id++) {
+    auto hash = group_hashes_[group_id];
+    size_t slot_itr = hash & slot_mask_;
+    while (slots[slot_itr].group_id != INVALID_OID) {
+      slot_itr = (slot_itr + 1) & slot_mask_;
+    }
+    slots[slot_itr] = Slot{GetHashTag(hash), group_id};
+  }
+
+  slots_.swap(slots);
+}
+
 //===--------------------------------------------------------------------===//
 // Hash Aggregator
 //===--------------------------------------------------------------------===//
+
 HashAggregator::HashAggregator(const planner::AggregatePlan *node,
                                storage::DataTable *output_table,
                                executor::ExecutorContext *econtext,
                                size_t num_input_columns)
     : AbstractAggregator(node, output_table, econtext),
       num_input_columns(num_input_columns) {
-  group_by_key_values.resize(node->GetGroupbyColIds().size(),
-                             ValueFactory::GetNullValue());
+  group_by_key_values.reserve(node->GetGroupbyColIds().size());
 }
 
-HashAggregator::~HashAggregator() {
-  for (auto entry : aggregates_map) {
-    // Clean up allocated storage
-    for (size_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      delete entry.second->aggregates[aggno];
+HashAggregator::~HashAggregator() {}
+
+void HashAggregator::InitKeyLayout(const AbstractTuple *tuple) {
+  key_layout_ready_ = true;
+
+  // Null bits come first, then every column in the width of its type
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+  size_t key_size = (group_by_col_ids.size() + 7) / 8;
+
+  for (auto column_id : group_by_col_ids) {
+    size_t column_size;
+    switch (tuple->GetValue(column_id).GetValueType()) {
+      case VALUE_TYPE_TINYINT:
+        column_size = sizeof(int8_t);
+        break;
+      case VALUE_TYPE_SMALLINT:
+        column_size = sizeof(int16_t);
+        break;
+      case VALUE_TYPE_INTEGER:
+        column_size = sizeof(int32_t);
+        break;
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_TIMESTAMP:
+        column_size = sizeof(int64_t);
+        break;
+      default:
+        LOG_TRACE("Group-by keys are compared as values");
+        key_columns_.clear();
+        return;
     }
-    delete[] entry.second->aggregates;
 
-    delete entry.second;
+    key_columns_.emplace_back(key_size, column_size);
+    key_size += column_size;
   }
+
+  key_width_ = (key_size + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  probe_key_.resize(key_width_);
+  LOG_TRACE("Group-by keys are packed into %lu words", key_width_);
 }
 
-bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
-  AggregateList *aggregate_list;
+uint64_t HashAggregator::BuildKey(const AbstractTuple *tuple, uint64_t *key,
+                                  std::vector<Value> &key_values) const {
+  auto &group_by_col_ids = node->GetGroupbyColIds();
+  key_values.clear();
+
+  if (key_width_ == 0) {
+    size_t seed = 0;
+    for (auto column_id : group_by_col_ids) {
+      Value value = tuple->GetValue(column_id);
+      value.HashCombine(seed);
+      key_values.push_back(value);
+    }
+    return MixHash(seed);
+  }
+
+  memset(key, 0, key_width_ * sizeof(uint64_t));
+  auto key_bytes = reinterpret_cast<unsigned char *>(key);
 
-  // Configure a group-by-key and search for the required group.
-  group_by_key_values.clear();
-  for (oid_t column_itr = 0; column_itr < node->GetGroupbyColIds().size();
+  for (oid_t column_itr = 0; column_itr < group_by_col_ids.size();
        column_itr++) {
-    Value cur_tuple_val =
-        cur_tuple->GetValue(node->GetGroupbyColIds()[column_itr]);
-    group_by_key_values.push_back(cur_tuple_val);
+    Value value = tuple->GetValue(group_by_col_ids[column_itr]);
+    if (value.IsNull()) {
+      key_bytes[column_itr / 8] |= (1 << (column_itr % 8));
+      continue;
+    }
+
+    // The low bytes hold the value, on little endian machines
+    int64_t raw_value = ValuePeeker::PeekAsRawInt64(value);
+    memcpy(key_bytes + key_columns_[column_itr].first, &raw_value,
+           key_columns_[column_itr].second);
   }
 
-  auto map_itr = aggregates_map.find(group_by_key_values);
+  return HashKey(key, key_width_);
+}
+
+void HashAggregator::AdvanceGroup(AggregateHashTable *partition,
+                                  uint64_t hash, const uint64_t *key,
+                                  const std::vector<Value> &key_values,
+                                  const AbstractTuple *tuple) {
+  oid_t group_id = (key_width_ == 0) ? partition->FindGroup(hash, key_values)
+                                     : partition->FindGroup(hash, key);
 
   // Group not found. Make a new entry in the hash for this new group.
-  if (map_itr == aggregates_map.end()) {
+  if (group_id == INVALID_OID) {
     LOG_TRACE("Group-by key not found. Start a new group.");
-    // Allocate new aggregate list
-    aggregate_list = new AggregateList();
-    aggregate_list->aggregates = new Agg *[node->GetUniqueAggTerms().size()];
-    // Make a deep copy of the first tuple we meet
-    for (size_t col_id = 0; col_id < num_input_columns; col_id++) {
-      aggregate_list->first_tuple_values.push_back(
-          ValueFactory::Clone(cur_tuple->GetValue(col_id), nullptr));
-    };
-
-    for (oid_t aggno = 0; aggno < node->GetUniqueAggTerms().size(); aggno++) {
-      aggregate_list->aggregates[aggno] =
-          GetAggInstance(node->GetUniqueAggTerms()[aggno].aggtype);
-
-      bool distinct = node->GetUniqueAggTerms()[aggno].distinct;
-      aggregate_list->aggregates[aggno]->SetDistinct(distinct);
-    }
-
-    aggregates_map.insert(
-        HashAggregateMapType::value_type(group_by_key_values, aggregate_list));
-  }
-  // Otherwise, the list is the second item of the pair.
-  else {
-    aggregate_list = map_itr->second;
+    group_id = partition->AddGroup(hash, key, tuple);
   }
 
   // Update the aggregation calculation
@@ -219,22 +423,128 @@ bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
     Value value = ValueFactory::GetIntegerValue(1);
     if (predicate) {
       value = node->GetUniqueAggTerms()[aggno].expression->Evaluate(
-          cur_tuple, nullptr, this->executor_context);
+          tuple, nullptr, this->executor_context);
     }
-    aggregate_list->aggregates[aggno]->Advance(value);
+    partition->GetAggregate(group_id, aggno)->Advance(value);
   }
+}
+
+bool HashAggregator::Advance(AbstractTuple *cur_tuple) {
+  if (key_layout_ready_ == false) {
+    InitKeyLayout(cur_tuple);
+    partitions_.emplace_back(
+        new AggregateHashTable(node, num_input_columns, key_width_));
+  }
+
+  auto hash = BuildKey(cur_tuple, probe_key_.data(), group_by_key_values);
+  AdvanceGroup(partitions_[GetPartition(hash)].get(), hash, probe_key_.data(),
+               group_by_key_values, cur_tuple);
+
+  return true;
+}
+
+bool HashAggregator::AdvanceParallel(const std::vector<LogicalTile *> &tiles,
+                                     size_t thread_count) {
+  PL_ASSERT(partitions_.empty());
+  PL_ASSERT(thread_count > 0);
+
+  for (auto tile : tiles) {
+    auto tuple_itr = tile->begin();
+    if (tuple_itr != tile->end()) {
+      expression::ContainerTuple<LogicalTile> tuple(tile, *tuple_itr);
+      InitKeyLayout(&tuple);
+      break;
+    }
+  }
+
+  // No input
+  if (key_layout_ready_ == false) {
+    return true;
+  }
+
+  partition_bits_ = AGGREGATE_PARTITION_BITS;
+  size_t partition_count = 1UL << partition_bits_;
+  for (size_t partition_itr = 0; partition_itr < partition_count;
+       partition_itr++) {
+    partitions_.emplace_back(
+        new AggregateHashTable(node, num_input_columns, key_width_));
+  }
+
+  struct PartitionEntry {
+    oid_t tile_itr;
+    oid_t tuple_id;
+    uint64_t hash;
+  };
+
+  // Tuples every thread scattered, by partition
+  std::vector<std::vector<std::vector<PartitionEntry>>> entries(
+      thread_count, std::vector<std::vector<PartitionEntry>>(partition_count));
+
+  // 1) Scatter the tuples of a share of the tiles by the hash of their key
+  RunTasks(thread_count, thread_count, [&](size_t thread_itr) {
+    std::vector<uint64_t> key(key_width_);
+    std::vector<Value> key_values;
+    auto &thread_entries = entries[thread_itr];
+
+    for (size_t tile_itr = thread_itr; tile_itr < tiles.size();
+         tile_itr += thread_count) {
+      auto tile = tiles[tile_itr];
+      for (oid_t tuple_id : *tile) {
+        expression::ContainerTuple<LogicalTile> tuple(tile, tuple_id);
+        auto hash = BuildKey(&tuple, key.data(), key_values);
+        thread_entries[GetPartition(hash)].push_back(
+            PartitionEntry{static_cast<oid_t>(tile_itr), tuple_id, hash});
+      }
+    }
+  });
+
+  // 2) Aggregate every partition in a single thread
+  RunTasks(thread_count, partition_count, [&](size_t partition_itr) {
+    std::vector<uint64_t> key(key_width_);
+    std::vector<Value> key_values;
+    auto partition = partitions_[partition_itr].get();
+
+    for (auto &thread_entries : entries) {
+      auto &partition_entries = thread_entries[partition_itr];
+      for (auto &entry : partition_entries) {
+        expression::ContainerTuple<LogicalTile> tuple(tiles[entry.tile_itr],
+                                                      entry.tuple_id);
+        BuildKey(&tuple, key.data(), key_values);
+        AdvanceGroup(partition, entry.hash, key.data(), key_values, &tuple);
+      }
+      std::vector<PartitionEntry>().swap(partition_entries);
+    }
+  });
 
   return true;
 }
 
+size_t HashAggregator::GetGroupCount() const {
+  size_t group_count = 0;
+  for (auto &partition : partitions_) {
+    group_count += partition->GetGroupCount();
+  }
+  return group_count;
+}
+
 bool HashAggregator::Finalize() {
-  for (auto entry : aggregates_map) {
-    // Construct a container for the first tuple
-    expression::ContainerTuple<std::vector<Value>> first_tuple(
-        &entry.second->first_tuple_values);
-    if (Helper(node, entry.second->aggregates, output_table, &first_tuple,
-               this->executor_context) == false) {
-      return false;
+  std::vector<Value> delegate_values;
+  expression::ContainerTuple<std::vector<Value>> delegate_tuple(
+      &delegate_values);
+  std::vector<Agg *> aggregates(node->GetUniqueAggTerms().size());
+
+  for (auto &partition : partitions_) {
+    for (oid_t group_id = 0; group_id < partition->GetGroupCount();
+         group_id++) {
+      partition->GetDelegateTupleValues(group_id, delegate_values);
+      for (oid_t aggno = 0; aggno < aggregates.size(); aggno++) {
+        aggregates[aggno] = partition->GetAggregate(group_id, aggno);
+      }
+
+      if (Helper(node, aggregates.data(), output_table, &delegate_tuple,
+                 this->executor_context) == false) {
+        return false;
+      }
     }
   }
 
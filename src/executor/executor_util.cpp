@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// executor_util.cpp
+//
+// Identification: src/executor/executor_util.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <vector>
+
+#include "common/thread_pool.h"
+#include "executor/executor_util.h"
+
+namespace peloton {
+namespace executor {
+
+// Pool shared by all the parallel executors
+static ThreadPool &GetExecutorThreadPool() {
+  static ThreadPool executor_thread_pool;
+  return executor_thread_pool;
+}
+
+void RunTasks(size_t thread_count, size_t task_count,
+              const std::function<void(size_t)> &task) {
+  size_t worker_count = std::min(thread_count, task_count);
+  if (worker_count <= 1) {
+    for (size_t task_itr = 0; task_itr < task_count; task_itr++) {
+      task(task_itr);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next_task(0);
+  auto worker = [&next_task, &task, task_count] {
+    for (size_t task_itr = next_task++; task_itr < task_count;
+         task_itr = next_task++) {
+      task(task_itr);
+    }
+  };
+
+  auto &thread_pool = GetExecutorThreadPool();
+  std::vector<std::future<void>> workers;
+  for (size_t worker_itr = 1; worker_itr < worker_count; worker_itr++) {
+    workers.push_back(thread_pool.Enqueue(worker));
+  }
+
+  // The calling thread works too, and waits for the others even if it fails
+  std::exception_ptr worker_exception;
+  try {
+    worker();
+  } catch (...) {
+    worker_exception = std::current_exception();
+  }
+
+  for (auto &pool_worker : workers) {
+    pool_worker.wait();
+  }
+
+  if (worker_exception != nullptr) {
+    std::rethrow_exception(worker_exception);
+  }
+  for (auto &pool_worker : workers) {
+    pool_worker.get();
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gather_executor.cpp
+//
+// Identification: src/executor/gather_executor.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "executor/gather_executor.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/logger.h"
+#include "common/thread_pool.h"
+#include "concurrency/transaction_manager.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "planner/gather_plan.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace executor {
+
+// Pool shared by all the parallel scans
+static ThreadPool &GetScanThreadPool() {
+  static ThreadPool scan_thread_pool;
+  return scan_thread_pool;
+}
+
+/**
+ * @brief Constructor
+ * @param node  GatherPlan plan node corresponding to this executor
+ */
+GatherExecutor::GatherExecutor(const planner::AbstractPlan *node,
+                               ExecutorContext *executor_context)
+    : AbstractExecutor(node, executor_context),
+      next_tile_group_offset_(START_OID),
+      is_stopped_(false) {}
+
+/**
+ * @brief Workers still running when the consumer stops early, e.g. under a
+ *        limit, are told to give up and waited for.
+ */
+GatherExecutor::~GatherExecutor() { StopWorkers(); }
+
+/**
+ * @brief Do some basic checks and initialize executor state.
+ * @return true on success, false otherwise.
+ */
+bool GatherExecutor::DInit() {
+  PL_ASSERT(children_.size() == 1);
+
+  // Re-initialization, wind down the previous run first
+  StopWorkers();
+
+  const planner::GatherPlan &node = GetPlanNode<planner::GatherPlan>();
+  parallelism_ = std::max<size_t>(node.GetParallelism(), 1);
+  morsel_size_ = std::max<size_t>(node.GetMorselSize(), 1);
+  max_pending_results_ = 2 * parallelism_;
+
+  // Only a table scan can be split up, everything else is passed through
+  scan_executor_ = dynamic_cast<SeqScanExecutor *>(children_[0]);
+  if (scan_executor_ != nullptr && scan_executor_->IsTableScan() == false) {
+    scan_executor_ = nullptr;
+  }
+
+  tile_group_count_ =
+      (scan_executor_ != nullptr) ? scan_executor_->GetTileGroupCount() : 0;
+  next_tile_group_offset_ = START_OID;
+  is_started_ = false;
+  is_stopped_ = false;
+  worker_exception_ = nullptr;
+
+  return true;
+}
+
+/**
+ * @brief Returns the next logical tile produced by any of the workers.
+ * @return true on success, false otherwise.
+ */
+bool GatherExecutor::DExecute() {
+  if (scan_executor_ == nullptr) {
+    if (children_[0]->Execute() == false) return false;
+    SetOutput(children_[0]->GetOutput());
+    return true;
+  }
+
+  if (is_started_ == false) {
+    StartWorkers();
+  }
+
+  ScanResult result;
+  {
+    std::unique_lock<std::mutex> lock(result_mutex_);
+    result_ready_cv_.wait(lock, [this] {
+      return results_.empty() == false || active_workers_ == 0 ||
+             worker_exception_ != nullptr;
+    });
+
+    if (worker_exception_ != nullptr) {
+      auto worker_exception = worker_exception_;
+      lock.unlock();
+      StopWorkers();
+      std::rethrow_exception(worker_exception);
+    }
+
+    // All the workers are done
+    if (results_.empty()) return false;
+
+    result = std::move(results_.front());
+    results_.pop_front();
+  }
+  result_taken_cv_.notify_one();
+
+  auto logical_tile = scan_executor_->ProduceTile(
+      result.tile_group, std::move(result.position_list));
+  if (logical_tile == nullptr) {
+    StopWorkers();
+    return false;
+  }
+
+  SetOutput(logical_tile);
+  return true;
+}
+
+void GatherExecutor::StartWorkers() {
+  auto txn = concurrency::current_txn;
+  size_t morsel_count = (tile_group_count_ + morsel_size_ - 1) / morsel_size_;
+  size_t worker_count = std::min(parallelism_, morsel_count);
+
+  LOG_TRACE("Gather executor :: %lu workers for %u tile groups", worker_count,
+            tile_group_count_);
+
+  active_workers_ = worker_count;
+  is_started_ = true;
+
+  auto &thread_pool = GetScanThreadPool();
+  for (size_t worker_itr = 0; worker_itr < worker_count; worker_itr++) {
+    workers_.push_back(
+        thread_pool.Enqueue(&GatherExecutor::ScanMorsels, this, txn));
+  }
+}
+
+void GatherExecutor::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> lock(result_mutex_);
+    is_stopped_ = true;
+  }
+  result_taken_cv_.notify_all();
+
+  for (auto &worker : workers_) {
+    worker.wait();
+  }
+
+  workers_.clear();
+  results_.clear();
+  active_workers_ = 0;
+}
+
+/**
+ * @brief Body of a worker. Claims morsels until the table is exhausted or
+ *        the scan is stopped.
+ */
+void GatherExecutor::ScanMorsels(concurrency::Transaction *txn) {
+  // Visibility is checked against the transaction of the current thread
+  concurrency::current_txn = txn;
+
+  try {
+    while (is_stopped_ == false) {
+      oid_t begin = next_tile_group_offset_.fetch_add(morsel_size_);
+      if (begin >= tile_group_count_) break;
+      oid_t end = std::min<oid_t>(begin + morsel_size_, tile_group_count_);
+
+      for (oid_t offset = begin; offset < end; offset++) {
+        ScanResult result;
+        result.tile_group = scan_executor_->GetTileGroup(offset);
+        result.position_list =
+            scan_executor_->ScanTileGroup(result.tile_group.get());
+
+        // Don't return empty tiles
+        if (result.position_list.empty()) continue;
+
+        if (PushResult(std::move(result)) == false) break;
+      }
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(result_mutex_);
+    if (worker_exception_ == nullptr) {
+      worker_exception_ = std::current_exception();
+    }
+    is_stopped_ = true;
+  }
+
+  concurrency::current_txn = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lock(result_mutex_);
+    active_workers_--;
+  }
+  result_ready_cv_.notify_all();
+  result_taken_cv_.notify_all();
+}
+
+/**
+ * @brief Queue a result for the consumer, waiting while the queue is full.
+ * @return false if the scan was stopped in the meantime.
+ */
+bool GatherExecutor::PushResult(ScanResult &&result) {
+  {
+    std::unique_lock<std::mutex> lock(result_mutex_);
+    result_taken_cv_.wait(lock, [this] {
+      return is_stopped_ || results_.size() < max_pending_results_;
+    });
+
+    if (is_stopped_) return false;
+
+    results_.push_back(std::move(result));
+  }
+  result_ready_cv_.notify_one();
+  return true;
+}
+
+}  // namespace executor
+}  // namespace peloton
@@ -78,18 +78,36 @@ bool HashExecutor::DExecute() {
       column_ids_.push_back(tuple_value->GetColumnId());
     }
 
-    // Construct the hash table by going over each child logical tile and
-    // hashing
-    for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
-         child_tile_itr++) {
-      auto tile = child_tiles_[child_tile_itr].get();
-
-      // Go over all tuples in the logical tile
-      for (oid_t tuple_id : *tile) {
-        // Key : container tuple with a subset of tuple attributes
-        // Value : < child_tile offset, tuple offset >
-        hash_table_[HashMapType::key_type(tile, tuple_id, &column_ids_)].insert(
-            std::make_pair(child_tile_itr, tuple_id));
+    if (peloton_hash_join_thread_count > 0) {
+      // Drop the empty tiles up front, they are never returned
+      std::vector<std::unique_ptr<LogicalTile>> child_tiles;
+      std::vector<LogicalTile *> tiles;
+      for (auto &child_tile : child_tiles_) {
+        if (child_tile->GetTupleCount() == 0) continue;
+        tiles.push_back(child_tile.get());
+        child_tiles.push_back(std::move(child_tile));
+      }
+      child_tiles_.swap(child_tiles);
+
+      // Partition the tuples on their hash keys and build a table per
+      // partition
+      radix_hash_table_.reset(
+          new RadixHashTable(column_ids_, peloton_hash_join_thread_count));
+      radix_hash_table_->Build(tiles);
+    } else {
+      // Construct the hash table by going over each child logical tile and
+      // hashing
+      for (size_t child_tile_itr = 0; child_tile_itr < child_tiles_.size();
+           child_tile_itr++) {
+        auto tile = child_tiles_[child_tile_itr].get();
+
+        // Go over all tuples in the logical tile
+        for (oid_t tuple_id : *tile) {
+          // Key : container tuple with a subset of tuple attributes
+          // Value : < child_tile offset, tuple offset >
+          hash_table_[HashMapType::key_type(tile, tuple_id, &column_ids_)]
+              .insert(std::make_pair(child_tile_itr, tuple_id));
+        }
       }
     }
 
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
 #include <vector>
 
 #include "common/types.h"
@@ -80,6 +81,15 @@ bool HashJoinExecutor::DExecute() {
       right_child_done_ = true;
     }
 
+    // A radix hash join partitions the left side as well, a batch at a time
+    auto radix_hash_table = hash_executor_->GetRadixHashTable();
+    if (radix_hash_table != nullptr) {
+      if (BuildRadixJoinOutput(radix_hash_table) == false) {
+        left_child_done_ = true;
+      }
+      continue;
+    }
+
     // Get next tile from LEFT child
     if (children_[0]->Execute() == false) {
       LOG_TRACE("Did not get left tile \n");
@@ -178,5 +188,76 @@ bool HashJoinExecutor::DExecute() {
   }
 }
 
+bool HashJoinExecutor::BuildRadixJoinOutput(
+    const RadixHashTable *radix_hash_table) {
+  // Get the next batch of tiles from LEFT child
+  size_t first_tile_itr = left_result_tiles_.size();
+  size_t batch_tuple_count = 0;
+  bool more_left_tiles = true;
+  while (batch_tuple_count < RADIX_PROBE_BATCH_SIZE) {
+    if (children_[0]->Execute() == false) {
+      more_left_tiles = false;
+      break;
+    }
+    BufferLeftTile(children_[0]->GetOutput());
+    batch_tuple_count += left_result_tiles_.back()->GetTupleCount();
+  }
+
+  std::vector<LogicalTile *> left_tiles;
+  for (size_t tile_itr = first_tile_itr; tile_itr < left_result_tiles_.size();
+       tile_itr++) {
+    left_tiles.push_back(left_result_tiles_[tile_itr].get());
+  }
+  if (left_tiles.empty() == true) {
+    return more_left_tiles;
+  }
+
+  std::vector<RadixHashTable::Match> matches;
+  radix_hash_table->Probe(left_tiles, matches);
+
+  // An output tile joins one left tile with one right tile
+  std::sort(matches.begin(), matches.end(),
+            [](const RadixHashTable::Match &lhs,
+               const RadixHashTable::Match &rhs) {
+              if (lhs.left_tile_itr != rhs.left_tile_itr)
+                return lhs.left_tile_itr < rhs.left_tile_itr;
+              if (lhs.right_tile_itr != rhs.right_tile_itr)
+                return lhs.right_tile_itr < rhs.right_tile_itr;
+              return lhs.left_tuple_id < rhs.left_tuple_id;
+            });
+
+  LOG_TRACE("Radix hash join :: %lu matches", matches.size());
+
+  for (size_t match_itr = 0; match_itr < matches.size();) {
+    auto batch_tile_itr = matches[match_itr].left_tile_itr;
+    auto left_tile_itr = first_tile_itr + batch_tile_itr;
+    auto right_tile_itr = matches[match_itr].right_tile_itr;
+    LogicalTile *left_tile = left_result_tiles_[left_tile_itr].get();
+    LogicalTile *right_tile = right_result_tiles_[right_tile_itr].get();
+
+    // Build output logical tile
+    std::unique_ptr<LogicalTile> output_tile =
+        BuildOutputLogicalTile(left_tile, right_tile);
+    LogicalTile::PositionListsBuilder pos_lists_builder(left_tile, right_tile);
+    pos_lists_builder.SetRightSource(&right_tile->GetPositionLists());
+
+    for (; match_itr < matches.size() &&
+               matches[match_itr].left_tile_itr == batch_tile_itr &&
+               matches[match_itr].right_tile_itr == right_tile_itr;
+         match_itr++) {
+      auto &match = matches[match_itr];
+      pos_lists_builder.AddRow(match.left_tuple_id, match.right_tuple_id);
+
+      RecordMatchedLeftRow(left_tile_itr, match.left_tuple_id);
+      RecordMatchedRightRow(right_tile_itr, match.right_tuple_id);
+    }
+
+    output_tile->SetPositionListsAndVisibility(pos_lists_builder.Release());
+    buffered_output_tiles.push_back(output_tile.release());
+  }
+
+  return more_left_tiles;
+}
+
 }  // namespace executor
 }  // namespace peloton
@@ -29,12 +29,14 @@
 #include "executor/executor_context.h"
 #include "expression/abstract_expression.h"
 #include "expression/container_tuple.h"
+#include "expression/expression_batch.h"
 #include "planner/hybrid_scan_plan.h"
 #include "executor/hybrid_scan_executor.h"
 #include "storage/data_table.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "gc/gc_manager.h"
 #include "common/logger.h"
 
 namespace peloton {
@@ -188,7 +190,11 @@ bool HybridScanExecutor::SeqScanUtil() {
     auto tile_group = table_->GetTileGroup(current_tile_group_offset_++);
     auto tile_group_header = tile_group->GetHeader();
 
-    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+    // Check transaction visibility for the whole tile group
+    concurrency::VisibilityBitmap visibility;
+    oid_t active_tuple_count = transaction_manager.ComputeVisibility(
+        tile_group_header, concurrency::current_txn->GetBeginCommitId(),
+        concurrency::current_txn->GetTransactionId(), visibility);
 
     // Construct position list by looping through tile group
     // and applying the predicate.
@@ -198,7 +204,10 @@ bool HybridScanExecutor::SeqScanUtil() {
       upper_bound_block = reverse_iter->block;
     }
 
+    // Tuples visible to the transaction, and the ones that are not yet
+    // visible and have to be registered as reads if they qualify.
     std::vector<oid_t> position_list;
+    std::vector<oid_t> invisible_list;
     for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
       ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
       if (type_ == HYBRID_SCAN_TYPE_HYBRID && item_pointers_.size() > 0 &&
@@ -208,34 +217,33 @@ bool HybridScanExecutor::SeqScanUtil() {
         }
       }
 
-      // Check transaction visibility
-      if (transaction_manager.IsVisible(tile_group_header, tuple_id)) {
-        // If the tuple is visible, then perform predicate evaluation.
-        if (predicate_ == nullptr) {
-          position_list.push_back(tuple_id);
-        }
-        else {
-          expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                               tuple_id);
-          auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-          if (eval == true) {
-            position_list.push_back(tuple_id);
-          }
-        }
+      if (visibility[tuple_id / 64] & (uint64_t(1) << (tuple_id % 64))) {
+        position_list.push_back(tuple_id);
+      } else if (predicate_ != nullptr) {
+        invisible_list.push_back(tuple_id);
       }
-      else {
-        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
-                                                             tuple_id);
-        auto eval =
-            predicate_->Evaluate(&tuple, nullptr, executor_context_).IsTrue();
-        if (eval == true) {
-          position_list.push_back(tuple_id);
+    }
+
+    // Apply the predicate to the whole tile group at once.
+    if (predicate_ != nullptr) {
+      expression::BatchSource source(tile_group.get());
+      predicate_->EvaluateBatch(source, position_list, executor_context_);
+
+      if (invisible_list.empty() == false) {
+        predicate_->EvaluateBatch(source, invisible_list, executor_context_);
+
+        for (auto tuple_id : invisible_list) {
+          ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
           auto res = transaction_manager.PerformRead(location);
           if (!res) {
             transaction_manager.SetTransactionResult(RESULT_FAILURE);
             return res;
           }
         }
+
+        std::vector<oid_t> visible_list(std::move(position_list));
+        expression::MergeSelections(visible_list, invisible_list,
+                                    position_list);
       }
     }
 
@@ -365,6 +373,7 @@ bool HybridScanExecutor::ExecPrimaryIndexLookup() {
   }
 
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
+  gc::GCBuffer garbage_tuples(table_->GetOid());
 
   // for every tuple that is found in the index.
   for (auto tuple_location_ptr : tuple_location_ptrs) {
@@ -414,6 +423,7 @@ bool HybridScanExecutor::ExecPrimaryIndexLookup() {
               old_item.offset, INVALID_TXN_ID) == true) {
             // atomically swap item pointer held in the index bucket.
             AtomicUpdateItemPointer(tuple_location_ptr, tuple_location);
+            garbage_tuples.AddGarbage(old_item);
           }
         }
 
@@ -163,7 +163,7 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
       concurrency::TransactionManagerFactory::GetInstance();
 
   std::map<oid_t, std::vector<oid_t>> visible_tuples;
-  std::vector<ItemPointer> garbage_tuples;
+  gc::GCBuffer garbage_tuples(table_->GetOid());
   // for every tuple that is found in the index.
   for (auto tuple_location_ptr : tuple_location_ptrs) {
     ItemPointer tuple_location = *tuple_location_ptr;
@@ -246,10 +246,7 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
             AtomicUpdateItemPointer(tuple_location_ptr, tuple_location);
 
             // currently, let's assume only primary index exists.
-            // gc::GCManagerFactory::GetInstance().RecycleTupleSlot(
-            //     table_->GetOid(), old_item.block, old_item.offset,
-            //     transaction_manager.GetNextCommitId());
-            garbage_tuples.push_back(old_item);
+            garbage_tuples.AddGarbage(old_item);
 
             tile_group = manager.GetTileGroup(tuple_location.block);
             tile_group_header = tile_group.get()->GetHeader();
@@ -269,15 +266,6 @@ bool IndexScanExecutor::ExecPrimaryIndexLookup() {
     }
   }
 
-// Add all garbage tuples to GC manager
-//  if (garbage_tuples.size() != 0) {
-//    cid_t garbage_timestamp = transaction_manager.GetNextCommitId();
-//    for (auto garbage : garbage_tuples) {
-//      gc::GCManagerFactory::GetInstance().RecycleTupleSlot(
-//          table_->GetOid(), garbage.block, garbage.offset, garbage_timestamp);
-//    }
-//  }
-
   // Construct a logical tile for each block
   for (auto tuples : visible_tuples) {
     auto &manager = catalog::Manager::GetInstance();
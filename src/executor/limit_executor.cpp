@@ -11,12 +11,15 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <limits>
+
 #include "executor/limit_executor.h"
 
 #include "planner/limit_plan.h"
 #include "common/logger.h"
 #include "common/types.h"
 #include "executor/logical_tile.h"
+#include "executor/order_by_executor.h"
 
 namespace peloton {
 namespace executor {
@@ -39,6 +42,14 @@ bool LimitExecutor::DInit() {
   num_skipped_ = 0;
   num_returned_ = 0;
 
+  // An order by below only has to sort the tuples we might return
+  auto order_by_executor = dynamic_cast<OrderByExecutor *>(children_[0]);
+  const planner::LimitPlan &node = GetPlanNode<planner::LimitPlan>();
+  auto max_limit = std::numeric_limits<size_t>::max() - node.GetOffset();
+  if (order_by_executor != nullptr && node.GetLimit() <= max_limit) {
+    order_by_executor->SetLimit(node.GetLimit() + node.GetOffset());
+  }
+
   return true;
 }
 
@@ -11,8 +11,14 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
+#include <cmath>
+
+#include "common/exception.h"
 #include "common/logger.h"
 #include "common/pool.h"
+#include "common/serializer.h"
+#include "common/value_peeker.h"
 #include "executor/logical_tile.h"
 #include "executor/logical_tile_factory.h"
 #include "executor/order_by_executor.h"
@@ -24,6 +30,128 @@
 namespace peloton {
 namespace executor {
 
+//===--------------------------------------------------------------------===//
+// Normalized Sort Keys
+//===--------------------------------------------------------------------===//
+
+static void AppendBigEndian(uint64_t bits, size_t byte_count,
+                            std::string &key) {
+  for (size_t byte_itr = byte_count; byte_itr > 0; byte_itr--) {
+    key.push_back(static_cast<char>(bits >> (8 * (byte_itr - 1))));
+  }
+}
+
+/**
+ * @brief Append the normalized form of a sort key value to the key, so that
+ * memcmp of two keys orders them like Value::Compare. Nulls come first, a
+ * varchar orders on its length before its bytes (as CompareStringValue
+ * does), and a descending value has all its bytes flipped.
+ */
+static void AppendSortKey(const Value &value, bool descend, std::string &key) {
+  size_t key_begin = key.size();
+
+  if (value.IsNull()) {
+    key.push_back(0);
+  } else {
+    key.push_back(1);
+
+    switch (value.GetValueType()) {
+      case VALUE_TYPE_TINYINT:
+      case VALUE_TYPE_SMALLINT:
+      case VALUE_TYPE_INTEGER:
+      case VALUE_TYPE_BIGINT:
+      case VALUE_TYPE_DATE:
+      case VALUE_TYPE_TIMESTAMP: {
+        // Flip the sign bit, so negative numbers come first
+        auto bits = static_cast<uint64_t>(ValuePeeker::PeekAsBigInt(value));
+        AppendBigEndian(bits ^ (1ULL << 63), 8, key);
+      } break;
+
+      case VALUE_TYPE_REAL:
+      case VALUE_TYPE_DOUBLE: {
+        double number = ValuePeeker::PeekDouble(
+            value.GetValueType() == VALUE_TYPE_DOUBLE
+                ? value
+                : value.CastAs(VALUE_TYPE_DOUBLE));
+        // NaN is smaller than everything, and -0.0 equals 0.0
+        uint64_t bits = 0;
+        if (std::isnan(number) == false) {
+          if (number == 0) number = 0;
+          PL_MEMCPY(&bits, &number, sizeof(bits));
+          bits = (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+        }
+        AppendBigEndian(bits, 8, key);
+      } break;
+
+      case VALUE_TYPE_DECIMAL: {
+        auto decimal = ValuePeeker::PeekDecimal(value);
+        AppendBigEndian(static_cast<uint64_t>(decimal.table[1]) ^ (1ULL << 63),
+                        8, key);
+        AppendBigEndian(static_cast<uint64_t>(decimal.table[0]), 8, key);
+      } break;
+
+      case VALUE_TYPE_BOOLEAN:
+        key.push_back(ValuePeeker::PeekBoolean(value) ? 1 : 0);
+        break;
+
+      case VALUE_TYPE_VARCHAR: {
+        auto length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+        AppendBigEndian(static_cast<uint32_t>(length), 4, key);
+        key.append(static_cast<const char *>(
+                       ValuePeeker::PeekObjectValueWithoutNull(value)),
+                   length);
+      } break;
+
+      case VALUE_TYPE_VARBINARY: {
+        // Bytes in memcmp order, with 0x00 escaped so the end marker is
+        // smaller than any byte of a longer value
+        auto length = ValuePeeker::PeekObjectLengthWithoutNull(value);
+        auto bytes = static_cast<const char *>(
+            ValuePeeker::PeekObjectValueWithoutNull(value));
+        for (int32_t byte_itr = 0; byte_itr < length; byte_itr++) {
+          key.push_back(bytes[byte_itr]);
+          if (bytes[byte_itr] == 0) key.push_back(static_cast<char>(0xFF));
+        }
+        key.push_back(0);
+        key.push_back(0);
+      } break;
+
+      default:
+        throw Exception("Order by does not support sort keys of type " +
+                        ValueTypeToString(value.GetValueType()));
+    }
+  }
+
+  if (descend) {
+    for (size_t byte_itr = key_begin; byte_itr < key.size(); byte_itr++) {
+      key[byte_itr] = ~key[byte_itr];
+    }
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Sorted Runs
+//===--------------------------------------------------------------------===//
+
+static void WriteRunField(FILE *file, const char *data, uint32_t length) {
+  if (fwrite(&length, sizeof(length), 1, file) != 1 ||
+      fwrite(data, 1, length, file) != length) {
+    throw Exception("Could not write a sorted run of an order by");
+  }
+}
+
+static bool ReadRunField(FILE *file, std::string &field) {
+  uint32_t length;
+  if (fread(&length, sizeof(length), 1, file) != 1) {
+    return false;
+  }
+  field.resize(length);
+  if (length > 0 && fread(&field[0], 1, length, file) != length) {
+    throw Exception("Could not read a sorted run of an order by");
+  }
+  return true;
+}
+
 /**
  * @brief Constructor
  * @param node  OrderByNode plan node corresponding to this executor
@@ -32,11 +160,12 @@ OrderByExecutor::OrderByExecutor(const planner::AbstractPlan *node,
                                  ExecutorContext *executor_context)
     : AbstractExecutor(node, executor_context) {}
 
-OrderByExecutor::~OrderByExecutor() {}
+OrderByExecutor::~OrderByExecutor() { ClearSortState(); }
 
 bool OrderByExecutor::DInit() {
   PL_ASSERT(children_.size() == 1);
 
+  ClearSortState();
   sort_done_ = false;
   num_tuples_returned_ = 0;
 
@@ -48,24 +177,29 @@ bool OrderByExecutor::DExecute() {
 
   if (!sort_done_) DoSort();
 
-  if (!(num_tuples_returned_ < sort_buffer_.size())) {
+  if (!(num_tuples_returned_ < num_tuples_sorted_)) {
     return false;
   }
 
   PL_ASSERT(sort_done_);
   PL_ASSERT(input_schema_.get());
-  PL_ASSERT(input_tiles_.size() > 0);
 
   // Returned tiles must be newly created physical tiles,
   // which have the same physical schema as input tiles.
   size_t tile_size = std::min(size_t(DEFAULT_TUPLES_PER_TILEGROUP),
-                              sort_buffer_.size() - num_tuples_returned_);
+                              num_tuples_sorted_ - num_tuples_returned_);
 
   std::shared_ptr<storage::Tile> ptile(storage::TileFactory::GetTile(
       BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
       nullptr, *input_schema_, nullptr, tile_size));
 
   for (size_t id = 0; id < tile_size; id++) {
+    // Merge the spilled runs
+    if (sort_runs_.empty() == false) {
+      MergeTuple(ptile.get(), id);
+      continue;
+    }
+
     oid_t source_tile_id =
         sort_buffer_[num_tuples_returned_ + id].item_pointer.block;
     oid_t source_tuple_id =
@@ -87,7 +221,7 @@ bool OrderByExecutor::DExecute() {
 
   num_tuples_returned_ += tile_size;
 
-  PL_ASSERT(num_tuples_returned_ <= sort_buffer_.size());
+  PL_ASSERT(num_tuples_returned_ <= num_tuples_sorted_);
 
   return true;
 }
@@ -98,97 +232,219 @@ bool OrderByExecutor::DoSort() {
   PL_ASSERT(!sort_done_);
   PL_ASSERT(executor_context_ != nullptr);
 
-  // Extract all data from child
+  // Grab data from plan node
+  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
+  const std::vector<oid_t> &sort_keys = node.GetSortKeys();
+  descend_flags_ = node.GetDescendFlags();
+
+  size_t memory_budget =
+      (peloton_sort_memory_budget > 0) ? peloton_sort_memory_budget : 0;
+
+  // Extract all data from child, and buffer the valid tuples
   while (children_[0]->Execute()) {
     input_tiles_.emplace_back(children_[0]->GetOutput());
-  }
+    input_tile_entry_counts_.push_back(0);
 
-  /** Number of valid tuples to be sorted. */
-  size_t count = 0;
-  for (auto &tile : input_tiles_) {
-    count += tile->GetTupleCount();
-  }
-
-  if (count == 0) return true;
+    auto input_tile = input_tiles_.back().get();
+    if (input_schema_ == nullptr) {
+      input_schema_.reset(input_tile->GetPhysicalSchema());
+    }
 
-  // Grab data from plan node
-  const planner::OrderByPlan &node = GetPlanNode<planner::OrderByPlan>();
-  descend_flags_ = node.GetDescendFlags();
+    for (oid_t tuple_id : *input_tile) {
+      std::string key;
+      for (oid_t id = 0; id < sort_keys.size(); id++) {
+        AppendSortKey(input_tile->GetValue(tuple_id, sort_keys[id]),
+                      descend_flags_[id], key);
+      }
+      BufferTuple(std::move(key), tuple_id);
+    }
 
-  // Extract the schema for sort keys.
-  input_schema_.reset(input_tiles_[0]->GetPhysicalSchema());
-  std::vector<catalog::Column> sort_key_columns;
-  for (auto id : node.GetSortKeys()) {
-    sort_key_columns.push_back(input_schema_->GetColumn(id));
-  }
-  sort_key_tuple_schema_.reset(new catalog::Schema(sort_key_columns));
-  auto executor_pool = executor_context_->GetExecutorContextPool();
-
-  // Extract all valid tuples into a single std::vector (the sort buffer)
-  sort_buffer_.reserve(count);
-  for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
-    for (oid_t tuple_id : *input_tiles_[tile_id]) {
-      // Extract the sort key tuple
-      std::unique_ptr<storage::Tuple> tuple(
-          new storage::Tuple(sort_key_tuple_schema_.get(), true));
-      for (oid_t id = 0; id < node.GetSortKeys().size(); id++) {
-        tuple->SetValue(id, input_tiles_[tile_id]->GetValue(
-                                tuple_id, node.GetSortKeys()[id]),
-                        executor_pool);
+    // Release the tiles with no tuple left in the top-n heap
+    if (has_limit_) {
+      for (oid_t tile_id = 0; tile_id < input_tiles_.size(); tile_id++) {
+        if (input_tile_entry_counts_[tile_id] == 0) {
+          input_tiles_[tile_id].reset();
+        }
       }
-      // Inert the sort key tuple into sort buffer
-      sort_buffer_.emplace_back(sort_buffer_entry_t(
-          ItemPointer(tile_id, tuple_id), std::move(tuple)));
+    }
+
+    if (memory_budget > 0 && sort_buffer_size_ > memory_budget) {
+      SpillRun();
     }
   }
 
-  PL_ASSERT(count == sort_buffer_.size());
-
-  // Prepare the compare function
-  // Note: This is a less-than comparer, NOT an equality comparer.
-  struct TupleComparer {
-    TupleComparer(std::vector<bool> &_descend_flags)
-        : descend_flags(_descend_flags) {}
-
-    bool operator()(const storage::Tuple *ta, const storage::Tuple *tb) {
-      for (oid_t id = 0; id < descend_flags.size(); id++) {
-        if (!descend_flags[id]) {
-          if (ta->GetValue(id).OpLessThan(tb->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (ta->GetValue(id)
-                         .OpGreaterThan(tb->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        } else {
-          if (tb->GetValue(id).OpLessThan(ta->GetValue(id)).IsTrue()) {
-            return true;
-          } else if (tb->GetValue(id)
-                         .OpGreaterThan(ta->GetValue(id))
-                         .IsTrue()) {
-            return false;
-          }
-        }
+  if (sort_runs_.empty()) {
+    // Finally ... sort it !
+    if (has_limit_) {
+      std::sort_heap(sort_buffer_.begin(), sort_buffer_.end());
+    } else {
+      std::sort(sort_buffer_.begin(), sort_buffer_.end());
+    }
+    num_tuples_sorted_ = sort_buffer_.size();
+  } else {
+    if (sort_buffer_.empty() == false) {
+      SpillRun();
+    }
+
+    // Start the merge from the first tuple of every run
+    for (size_t run_itr = 0; run_itr < sort_runs_.size(); run_itr++) {
+      if (ReadRun(run_itr)) {
+        merge_heap_.push_back(run_itr);
       }
-      return false;  // Will return false if all keys equal
     }
+    std::make_heap(merge_heap_.begin(), merge_heap_.end(),
+                   [this](size_t lhs, size_t rhs) {
+                     return sort_runs_[rhs].key < sort_runs_[lhs].key;
+                   });
+
+    if (has_limit_) {
+      num_tuples_sorted_ = std::min(num_tuples_sorted_, limit_);
+    }
+
+    LOG_TRACE("Order by :: merging %lu runs of %lu tuples", sort_runs_.size(),
+              num_tuples_sorted_);
+  }
+
+  sort_done_ = true;
+
+  return true;
+}
 
-    std::vector<bool> descend_flags;
+void OrderByExecutor::BufferTuple(std::string &&key, oid_t tuple_id) {
+  oid_t tile_id = input_tiles_.size() - 1;
+  SortEntry entry{std::move(key), ItemPointer(tile_id, tuple_id)};
+
+  // The key, and roughly the tuple it keeps in memory
+  auto entry_size = [this](const SortEntry &sort_entry) {
+    return sizeof(SortEntry) + sort_entry.key.size() +
+           input_schema_->GetLength();
   };
 
-  TupleComparer comp(descend_flags_);
+  if (has_limit_ == false) {
+    sort_buffer_size_ += entry_size(entry);
+    input_tile_entry_counts_[tile_id]++;
+    sort_buffer_.push_back(std::move(entry));
+    return;
+  }
+
+  // Top-n: replace the largest tuple of the heap if this one is smaller
+  if (sort_buffer_.size() >= limit_) {
+    if (limit_ == 0 || !(entry < sort_buffer_.front())) {
+      return;
+    }
 
-  // Finally ... sort it !
-  std::sort(
-      sort_buffer_.begin(), sort_buffer_.end(),
-      [&comp](const sort_buffer_entry_t &a, const sort_buffer_entry_t &b) {
-        return comp(a.tuple.get(), b.tuple.get());
-      });
+    std::pop_heap(sort_buffer_.begin(), sort_buffer_.end());
+    auto &evicted = sort_buffer_.back();
+    sort_buffer_size_ -= entry_size(evicted);
+    input_tile_entry_counts_[evicted.item_pointer.block]--;
+    sort_buffer_.pop_back();
+  }
 
-  sort_done_ = true;
+  sort_buffer_size_ += entry_size(entry);
+  input_tile_entry_counts_[tile_id]++;
+  sort_buffer_.push_back(std::move(entry));
+  std::push_heap(sort_buffer_.begin(), sort_buffer_.end());
+}
+
+void OrderByExecutor::SpillRun() {
+  if (has_limit_) {
+    std::sort_heap(sort_buffer_.begin(), sort_buffer_.end());
+  } else {
+    std::sort(sort_buffer_.begin(), sort_buffer_.end());
+  }
 
+  // The temporary file is removed when it is closed
+  FILE *file = std::tmpfile();
+  if (file == nullptr) {
+    throw Exception("Could not create a sorted run of an order by");
+  }
+  sort_runs_.push_back(SortRun{file, std::string(), std::string()});
+
+  // Every tuple is its key followed by its serialized values
+  CopySerializeOutput output;
+  for (auto &entry : sort_buffer_) {
+    auto &input_tile = input_tiles_[entry.item_pointer.block];
+    output.Reset();
+    for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
+      input_tile->GetValue(entry.item_pointer.offset, col).SerializeTo(output);
+    }
+
+    WriteRunField(file, entry.key.data(), entry.key.size());
+    WriteRunField(file, output.Data(), output.Size());
+  }
+
+  if (fflush(file) != 0) {
+    throw Exception("Could not write a sorted run of an order by");
+  }
+  rewind(file);
+
+  LOG_TRACE("Order by :: spilled run %lu of %lu tuples", sort_runs_.size(),
+            sort_buffer_.size());
+
+  num_tuples_sorted_ += sort_buffer_.size();
+
+  sort_buffer_.clear();
+  sort_buffer_size_ = 0;
+  input_tiles_.clear();
+  input_tile_entry_counts_.clear();
+}
+
+bool OrderByExecutor::ReadRun(size_t run_itr) {
+  auto &sort_run = sort_runs_[run_itr];
+  if (ReadRunField(sort_run.file, sort_run.key) == false) {
+    return false;
+  }
+  if (ReadRunField(sort_run.file, sort_run.tuple) == false) {
+    throw Exception("Could not read a sorted run of an order by");
+  }
   return true;
 }
 
+void OrderByExecutor::MergeTuple(storage::Tile *tile, oid_t tuple_id) {
+  auto run_greater = [this](size_t lhs, size_t rhs) {
+    return sort_runs_[rhs].key < sort_runs_[lhs].key;
+  };
+
+  PL_ASSERT(merge_heap_.empty() == false);
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), run_greater);
+  size_t run_itr = merge_heap_.back();
+  auto &sort_run = sort_runs_[run_itr];
+
+  // Straight into the tile, its pool holds the only copy of the varlens.
+  // A copy in the executor pool would keep every merged varlen until the
+  // query ends.
+  ReferenceSerializeInputBE input(sort_run.tuple.data(),
+                                  sort_run.tuple.size());
+  char *tuple_location = tile->GetTupleLocation(tuple_id);
+  for (oid_t col = 0; col < input_schema_->GetColumnCount(); col++) {
+    Value::DeserializeFrom(input, tile->GetPool(),
+                           tuple_location + input_schema_->GetOffset(col),
+                           input_schema_->GetType(col),
+                           input_schema_->IsInlined(col),
+                           input_schema_->GetAppropriateLength(col), false);
+  }
+
+  if (ReadRun(run_itr)) {
+    std::push_heap(merge_heap_.begin(), merge_heap_.end(), run_greater);
+  } else {
+    merge_heap_.pop_back();
+  }
+}
+
+void OrderByExecutor::ClearSortState() {
+  for (auto &sort_run : sort_runs_) {
+    fclose(sort_run.file);
+  }
+  sort_runs_.clear();
+  merge_heap_.clear();
+
+  sort_buffer_.clear();
+  sort_buffer_size_ = 0;
+  input_tiles_.clear();
+  input_tile_entry_counts_.clear();
+  input_schema_.reset();
+  num_tuples_sorted_ = 0;
+}
+
 } /* namespace executor */
 } /* namespace peloton */
@@ -18,6 +18,7 @@
 #include "executor/executors.h"
 #include "executor/executor_context.h"
 #include "executor/plan_executor.h"
+#include "logging/replication_manager.h"
 #include "storage/tuple_iterator.h"
 
 namespace peloton {
@@ -35,6 +36,8 @@ executor::AbstractExecutor *BuildExecutorTree(
 
 void CleanExecutorTree(executor::AbstractExecutor *root);
 
+bool IsReadOnlyPlan(const planner::AbstractPlan *plan);
+
 /**
  * @brief Build a executor tree and execute it.
  * Use std::vector<Value> as params to make it more elegant for networking
@@ -44,10 +47,29 @@ void CleanExecutorTree(executor::AbstractExecutor *root);
  */
 peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
                                          const std::vector<Value> &params) {
+  return ExecutePlan(plan, params, nullptr);
+}
+
+/**
+ * @brief Build a executor tree and execute it, and hand the result tiles to
+ * the consumer before the txn commits.
+ * @return status of execution.
+ */
+peloton_status PlanExecutor::ExecutePlan(
+    const planner::AbstractPlan *plan, const std::vector<Value> &params,
+    const std::function<void(executor::LogicalTile *)> &result_consumer) {
   peloton_status p_status;
 
   if (plan == nullptr) return p_status;
 
+  // A standby only changes through the log of the primary
+  if (logging::ReplicationManager::GetInstance().IsStandby() &&
+      IsReadOnlyPlan(plan) == false) {
+    LOG_ERROR("A standby only runs read-only plans");
+    p_status.m_result = Result::RESULT_FAILURE;
+    return p_status;
+  }
+
   LOG_INFO("PlanExecutor Start ");
 
   bool status;
@@ -106,6 +128,9 @@ peloton_status PlanExecutor::ExecutePlan(const planner::AbstractPlan *plan,
     }
 
     // Go over the logical tile
+    if (result_consumer) {
+      result_consumer(logical_tile.get());
+    }
   }
 
   // Set the result
@@ -154,6 +179,13 @@ int PlanExecutor::ExecutePlan(
     std::vector<std::unique_ptr<executor::LogicalTile>> &logical_tile_list) {
   if (plan == nullptr) return -1;
 
+  // A standby only changes through the log of the primary
+  if (logging::ReplicationManager::GetInstance().IsStandby() &&
+      IsReadOnlyPlan(plan) == false) {
+    LOG_ERROR("A standby only runs read-only plans");
+    return -1;
+  }
+
   LOG_TRACE("PlanExecutor Start ");
 
   bool status;
@@ -322,6 +354,10 @@ executor::AbstractExecutor *BuildExecutorTree(
       child_executor = new executor::LimitExecutor(plan, executor_context);
       break;
 
+    case PLAN_NODE_TYPE_GATHER:
+      child_executor = new executor::GatherExecutor(plan, executor_context);
+      break;
+
     case PLAN_NODE_TYPE_NESTLOOP:
       child_executor =
           new executor::NestedLoopJoinExecutor(plan, executor_context);
@@ -402,5 +438,30 @@ void CleanExecutorTree(executor::AbstractExecutor *root) {
   }
 }
 
+/**
+ * @brief Whether the plan or one of its children writes.
+ * @param The current plan
+ * @return false if the plan writes.
+ */
+bool IsReadOnlyPlan(const planner::AbstractPlan *plan) {
+  switch (plan->GetPlanNodeType()) {
+    case PLAN_NODE_TYPE_UPDATE:
+    case PLAN_NODE_TYPE_INSERT:
+    case PLAN_NODE_TYPE_DELETE:
+    case PLAN_NODE_TYPE_DROP:
+    case PLAN_NODE_TYPE_CREATE:
+      return false;
+    default:
+      break;
+  }
+
+  // Recurse
+  for (auto &child : plan->GetChildren()) {
+    if (IsReadOnlyPlan(child.get()) == false) return false;
+  }
+
+  return true;
+}
+
 }  // namespace bridge
 }  // namespace peloton
@@ -0,0 +1,239 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_hash_table.cpp
+//
+// Identification: src/executor/radix_hash_table.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+
+#include "common/logger.h"
+#include "common/value.h"
+#include "executor/executor_util.h"
+#include "executor/logical_tile.h"
+#include "executor/radix_hash_table.h"
+
+namespace peloton {
+namespace executor {
+
+static uint64_t HashTuple(LogicalTile *tile, oid_t tuple_id,
+                          const std::vector<oid_t> &column_ids) {
+  size_t seed = 0;
+  for (auto column_id : column_ids) {
+    tile->GetValue(tuple_id, column_id).HashCombine(seed);
+  }
+  // The upper bits pick the partition, so spread the combined hash
+  return MixHash(seed);
+}
+
+static bool KeysEqual(LogicalTile *left_tile, oid_t left_tuple_id,
+                      LogicalTile *right_tile, oid_t right_tuple_id,
+                      const std::vector<oid_t> &column_ids) {
+  for (auto column_id : column_ids) {
+    const Value lhs = left_tile->GetValue(left_tuple_id, column_id);
+    const Value rhs = right_tile->GetValue(right_tuple_id, column_id);
+    if (lhs.OpNotEquals(rhs).IsTrue()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+RadixHashTable::RadixHashTable(const std::vector<oid_t> &column_ids,
+                               size_t thread_count)
+    : column_ids_(column_ids),
+      thread_count_(std::max<size_t>(thread_count, 1)) {}
+
+void RadixHashTable::Build(const std::vector<LogicalTile *> &tiles) {
+  tiles_ = tiles;
+
+  size_t tuple_count = 0;
+  for (auto tile : tiles) {
+    tuple_count += tile->GetTupleCount();
+  }
+
+  partition_bits_ = 0;
+  while ((tuple_count >> partition_bits_) > RADIX_PARTITION_SIZE &&
+         partition_bits_ < RADIX_MAX_PARTITION_BITS) {
+    partition_bits_++;
+  }
+
+  PartitionTuples(tiles, entries_, partition_offsets_);
+
+  // The slots of a partition are kept at most half full
+  size_t partition_count = GetPartitionCount();
+  size_t slot_count = 0;
+  slot_offsets_.assign(partition_count + 1, 0);
+  for (size_t partition = 0; partition < partition_count; partition++) {
+    slot_offsets_[partition] = slot_count;
+
+    size_t entry_count =
+        partition_offsets_[partition + 1] - partition_offsets_[partition];
+    if (entry_count == 0) continue;
+
+    size_t partition_slot_count = 1;
+    while (partition_slot_count < 2 * entry_count) {
+      partition_slot_count <<= 1;
+    }
+    slot_count += partition_slot_count;
+  }
+  slot_offsets_[partition_count] = slot_count;
+  slots_.assign(slot_count, Slot{0, 0});
+
+  RunTasks(thread_count_, partition_count,
+           [this](size_t partition) { BuildPartition(partition); });
+
+  LOG_TRACE("Radix hash table :: %lu tuples in %lu partitions", tuple_count,
+            partition_count);
+}
+
+void RadixHashTable::Probe(const std::vector<LogicalTile *> &probe_tiles,
+                           std::vector<Match> &matches) const {
+  std::vector<Entry> probe_entries;
+  std::vector<size_t> probe_offsets;
+  PartitionTuples(probe_tiles, probe_entries, probe_offsets);
+
+  size_t partition_count = GetPartitionCount();
+  std::vector<std::vector<Match>> partition_matches(partition_count);
+  RunTasks(thread_count_, partition_count, [&](size_t partition) {
+    ProbePartition(partition, probe_tiles, probe_entries, probe_offsets,
+                   partition_matches[partition]);
+  });
+
+  for (auto &partition_match : partition_matches) {
+    matches.insert(matches.end(), partition_match.begin(),
+                   partition_match.end());
+  }
+}
+
+/**
+ * @brief Radix partition the tuples of the tiles on the hash of their keys.
+ * Every thread hashes a contiguous range of tiles and counts its tuples per
+ * partition, then scatters them to its own part of every partition. So
+ * the tuples of a partition stay in tile order.
+ */
+void RadixHashTable::PartitionTuples(
+    const std::vector<LogicalTile *> &tiles, std::vector<Entry> &entries,
+    std::vector<size_t> &partition_offsets) const {
+  size_t partition_count = GetPartitionCount();
+  size_t chunk_count =
+      std::max<size_t>(std::min(thread_count_, tiles.size()), 1);
+
+  // 1) Hash the tuples
+  std::vector<std::vector<Entry>> chunk_entries(chunk_count);
+  std::vector<std::vector<size_t>> histograms(
+      chunk_count, std::vector<size_t>(partition_count, 0));
+
+  RunTasks(thread_count_, chunk_count, [&](size_t chunk_itr) {
+    size_t tile_begin = tiles.size() * chunk_itr / chunk_count;
+    size_t tile_end = tiles.size() * (chunk_itr + 1) / chunk_count;
+
+    for (size_t tile_itr = tile_begin; tile_itr < tile_end; tile_itr++) {
+      auto tile = tiles[tile_itr];
+      for (oid_t tuple_id : *tile) {
+        auto hash = HashTuple(tile, tuple_id, column_ids_);
+        chunk_entries[chunk_itr].push_back(
+            Entry{hash, static_cast<oid_t>(tile_itr), tuple_id});
+        histograms[chunk_itr][GetPartition(hash)]++;
+      }
+    }
+  });
+
+  // 2) Lay out the partitions, and the part of every chunk in them
+  std::vector<std::vector<size_t>> cursors(
+      chunk_count, std::vector<size_t>(partition_count, 0));
+  partition_offsets.assign(partition_count + 1, 0);
+
+  size_t entry_count = 0;
+  for (size_t partition = 0; partition < partition_count; partition++) {
+    partition_offsets[partition] = entry_count;
+    for (size_t chunk_itr = 0; chunk_itr < chunk_count; chunk_itr++) {
+      cursors[chunk_itr][partition] = entry_count;
+      entry_count += histograms[chunk_itr][partition];
+    }
+  }
+  partition_offsets[partition_count] = entry_count;
+
+  // 3) Scatter
+  entries.resize(entry_count);
+  RunTasks(thread_count_, chunk_count, [&](size_t chunk_itr) {
+    auto &cursor = cursors[chunk_itr];
+    for (auto &entry : chunk_entries[chunk_itr]) {
+      entries[cursor[GetPartition(entry.hash)]++] = entry;
+    }
+    std::vector<Entry>().swap(chunk_entries[chunk_itr]);
+  });
+}
+
+void RadixHashTable::BuildPartition(size_t partition) {
+  size_t slot_count = slot_offsets_[partition + 1] - slot_offsets_[partition];
+  if (slot_count == 0) return;
+
+  auto slots = &slots_[slot_offsets_[partition]];
+  size_t slot_mask = slot_count - 1;
+
+  for (size_t entry_offset = partition_offsets_[partition];
+       entry_offset < partition_offsets_[partition + 1]; entry_offset++) {
+    auto hash = entries_[entry_offset].hash;
+
+    size_t slot_itr = hash & slot_mask;
+    while (slots[slot_itr].entry_offset != 0) {
+      slot_itr = (slot_itr + 1) & slot_mask;
+    }
+    slots[slot_itr] =
+        Slot{GetHashTag(hash), static_cast<uint32_t>(entry_offset + 1)};
+  }
+}
+
+void RadixHashTable::ProbePartition(
+    size_t partition, const std::vector<LogicalTile *> &probe_tiles,
+    const std::vector<Entry> &probe_entries,
+    const std::vector<size_t> &probe_offsets,
+    std::vector<Match> &matches) const {
+  size_t slot_count = slot_offsets_[partition + 1] - slot_offsets_[partition];
+  if (slot_count == 0) return;
+
+  auto slots = &slots_[slot_offsets_[partition]];
+  size_t slot_mask = slot_count - 1;
+
+  size_t probe_end = probe_offsets[partition + 1];
+  for (size_t probe_itr = probe_offsets[partition]; probe_itr < probe_end;
+       probe_itr++) {
+    // Prefetch the first slot of a tuple further down the partition
+    if (probe_itr + RADIX_PREFETCH_DISTANCE < probe_end) {
+      __builtin_prefetch(
+          &slots[probe_entries[probe_itr + RADIX_PREFETCH_DISTANCE].hash &
+                 slot_mask]);
+    }
+
+    auto &probe_entry = probe_entries[probe_itr];
+    auto hash_tag = GetHashTag(probe_entry.hash);
+
+    // Every build tuple with the key is in the run of slots that follows
+    for (size_t slot_itr = probe_entry.hash & slot_mask;
+         slots[slot_itr].entry_offset != 0;
+         slot_itr = (slot_itr + 1) & slot_mask) {
+      if (slots[slot_itr].hash_tag != hash_tag) continue;
+
+      auto &entry = entries_[slots[slot_itr].entry_offset - 1];
+      if (entry.hash != probe_entry.hash ||
+          KeysEqual(probe_tiles[probe_entry.tile_itr], probe_entry.tuple_id,
+                    tiles_[entry.tile_itr], entry.tuple_id,
+                    column_ids_) == false) {
+        continue;
+      }
+
+      matches.push_back(Match{probe_entry.tile_itr, probe_entry.tuple_id,
+                              entry.tile_itr, entry.tuple_id});
+    }
+  }
+}
+
+}  // namespace executor
+}  // namespace peloton
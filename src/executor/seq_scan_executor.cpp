@@ -23,6 +23,7 @@
 #include "executor/executor_context.h"
 #include "expression/abstract_expression.h"
 #include "expression/container_tuple.h"
+#include "expression/expression_batch.h"
 #include "storage/data_table.h"
 #include "storage/tile_group_header.h"
 #include "storage/tile.h"
@@ -87,10 +88,15 @@ bool SeqScanExecutor::DExecute() {
 
       if (predicate_ != nullptr) {
         // Invalidate tuples that don't satisfy the predicate.
+        expression::SelectionVector selection(tile->begin(), tile->end());
+        expression::BatchSource source(tile.get());
+        predicate_->EvaluateBatch(source, selection, executor_context_);
+
+        auto selected_itr = selection.begin();
         for (oid_t tuple_id : *tile) {
-          expression::ContainerTuple<LogicalTile> tuple(tile.get(), tuple_id);
-          if (predicate_->Evaluate(&tuple, nullptr, executor_context_)
-                  .IsFalse()) {
+          if (selected_itr != selection.end() && *selected_itr == tuple_id) {
+            selected_itr++;
+          } else {
             tile->RemoveVisibility(tuple_id);
           }
         }
@@ -114,65 +120,22 @@ bool SeqScanExecutor::DExecute() {
     PL_ASSERT(target_table_ != nullptr);
     PL_ASSERT(column_ids_.size() > 0);
 
-    // Force to use occ txn manager if dirty read is forbidden
-    concurrency::TransactionManager &transaction_manager =
-        concurrency::TransactionManagerFactory::GetInstance();
-
-    // LOG_TRACE("Number of tuples: %f",
-    // target_table_->GetIndex(0)->GetNumberOfTuples());
-
     // Retrieve next tile group.
     while (current_tile_group_offset_ < table_tile_group_count_) {
-      auto tile_group =
-          target_table_->GetTileGroup(current_tile_group_offset_++);
-      auto tile_group_header = tile_group->GetHeader();
-
-      oid_t active_tuple_count = tile_group->GetNextTupleSlot();
-
-      // Construct position list by looping through tile group
-      // and applying the predicate.
-      std::vector<oid_t> position_list;
-      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
-        ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
-
-        // check transaction visibility
-        if (transaction_manager.IsVisible(tile_group_header, tuple_id)) {
-          // if the tuple is visible, then perform predicate evaluation.
-          if (predicate_ == nullptr) {
-            position_list.push_back(tuple_id);
-            auto res = transaction_manager.PerformRead(location);
-            if (!res) {
-              transaction_manager.SetTransactionResult(RESULT_FAILURE);
-              return res;
-            }
-          } else {
-            expression::ContainerTuple<storage::TileGroup> tuple(
-                tile_group.get(), tuple_id);
-            auto eval = predicate_->Evaluate(&tuple, nullptr, executor_context_)
-                            .IsTrue();
-            if (eval == true) {
-              position_list.push_back(tuple_id);
-              auto res = transaction_manager.PerformRead(location);
-              if (!res) {
-                transaction_manager.SetTransactionResult(RESULT_FAILURE);
-                return res;
-              }
-            }
-          }
-        }
-      }
+      auto tile_group = GetTileGroup(current_tile_group_offset_++);
+      auto position_list = ScanTileGroup(tile_group.get());
 
       // Don't return empty tiles
       if (position_list.size() == 0) {
         continue;
       }
 
-      // Construct logical tile.
-      std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
-      logical_tile->AddColumns(tile_group, column_ids_);
-      logical_tile->AddPositionList(std::move(position_list));
+      auto logical_tile = ProduceTile(tile_group, std::move(position_list));
+      if (logical_tile == nullptr) {
+        return false;
+      }
 
-      SetOutput(logical_tile.release());
+      SetOutput(logical_tile);
       return true;
     }
   }
@@ -180,5 +143,72 @@ bool SeqScanExecutor::DExecute() {
   return false;
 }
 
+std::shared_ptr<storage::TileGroup> SeqScanExecutor::GetTileGroup(
+    oid_t tile_group_offset) const {
+  return target_table_->GetTileGroup(tile_group_offset);
+}
+
+/**
+ * @brief Finds the visible tuples of a tile group that satisfy the predicate.
+ * @param tile_group Tile group to scan.
+ * @return Offsets of the qualifying tuples, in ascending order.
+ *
+ * Visibility is checked against concurrency::current_txn without touching
+ * the transaction, so morsels of a parallel scan may call this concurrently
+ * once each worker thread has set current_txn to the scan's transaction.
+ */
+std::vector<oid_t> SeqScanExecutor::ScanTileGroup(
+    storage::TileGroup *tile_group) const {
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  auto txn = concurrency::current_txn;
+
+  // Construct position list from the visibility of the whole tile group.
+  concurrency::VisibilityBitmap visibility;
+  transaction_manager.ComputeVisibility(tile_group->GetHeader(),
+                                        txn->GetBeginCommitId(),
+                                        txn->GetTransactionId(), visibility);
+
+  std::vector<oid_t> position_list;
+  concurrency::GetPositionList(visibility, position_list);
+
+  // Then apply the predicate to all the visible tuples at once.
+  if (predicate_ != nullptr && position_list.empty() == false) {
+    expression::BatchSource source(tile_group);
+    predicate_->EvaluateBatch(source, position_list, executor_context_);
+  }
+
+  return position_list;
+}
+
+/**
+ * @brief Registers the reads with the transaction and wraps the tuples
+ *        into a logical tile. Must run on the thread owning the transaction.
+ * @return Logical tile, or nullptr if a read failed.
+ */
+LogicalTile *SeqScanExecutor::ProduceTile(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    std::vector<oid_t> &&position_list) {
+  concurrency::TransactionManager &transaction_manager =
+      concurrency::TransactionManagerFactory::GetInstance();
+
+  for (auto tuple_id : position_list) {
+    ItemPointer location(tile_group->GetTileGroupId(), tuple_id);
+    auto res = transaction_manager.PerformRead(location);
+    if (!res) {
+      transaction_manager.SetTransactionResult(RESULT_FAILURE);
+      return nullptr;
+    }
+  }
+
+  // Construct logical tile.
+  std::unique_ptr<LogicalTile> logical_tile(LogicalTileFactory::GetTile());
+  logical_tile->AddColumns(tile_group, column_ids_);
+  logical_tile->AddPositionList(std::move(position_list));
+
+  return logical_tile.release();
+}
+
 }  // namespace executor
 }  // namespace peloton
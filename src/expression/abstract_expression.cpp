@@ -48,6 +48,18 @@ AbstractExpression::~AbstractExpression() {
   }
 }
 
+void AbstractExpression::EvaluateBatch(const BatchSource &source,
+                                       SelectionVector &selection,
+                                       executor::ExecutorContext *context) const {
+  size_t selected = 0;
+  for (auto tuple_id : selection) {
+    if (source.Evaluate(this, tuple_id, context).IsTrue()) {
+      selection[selected++] = tuple_id;
+    }
+  }
+  selection.resize(selected);
+}
+
 bool AbstractExpression::HasParameter() const {
   if (m_left && m_left->HasParameter()) return true;
   return (m_right && m_right->HasParameter());
@@ -0,0 +1,231 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// expression_batch.cpp
+//
+// Identification: src/expression/expression_batch.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "expression/expression_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "catalog/schema.h"
+#include "common/value_peeker.h"
+#include "executor/logical_tile.h"
+#include "expression/abstract_expression.h"
+#include "expression/container_tuple.h"
+#include "storage/compressed_tile.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+
+namespace peloton {
+namespace expression {
+
+//===--------------------------------------------------------------------===//
+// Numeric Batch
+//===--------------------------------------------------------------------===//
+
+bool NumericBatch::Broadcast(const Value &value, size_t count) {
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+      is_integer = true;
+      int_values.assign(count, ValuePeeker::PeekAsBigInt(value));
+      return true;
+
+    case VALUE_TYPE_DOUBLE:
+      is_integer = false;
+      double_values.assign(
+          count, value.IsNull() ? DOUBLE_NULL : ValuePeeker::PeekDouble(value));
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void NumericBatch::PromoteToDouble() {
+  if (is_integer == false) return;
+
+  size_t count = int_values.size();
+  double_values.resize(count);
+  for (size_t itr = 0; itr < count; itr++) {
+    double_values[itr] = IsNullNumeric(int_values[itr])
+                             ? DOUBLE_NULL
+                             : static_cast<double>(int_values[itr]);
+  }
+
+  int_values.clear();
+  is_integer = false;
+}
+
+//===--------------------------------------------------------------------===//
+// Batch Source
+//===--------------------------------------------------------------------===//
+
+/*
+ * Copy out a column of type T, "base" points at its value in the first tuple
+ * and tuples are "stride" bytes apart. "positions" maps the selected rows to
+ * tuple slots of the base tile, it is null if they coincide. NULL_OID slots
+ * are the padding of outer joins and read as NULL.
+ */
+template <typename T, typename Out>
+static void GatherValues(const char *base, size_t stride,
+                         const oid_t *positions,
+                         const SelectionVector &selection, const T null_value,
+                         const Out null_out, std::vector<Out> &out) {
+  size_t count = selection.size();
+  out.resize(count);
+
+  for (size_t itr = 0; itr < count; itr++) {
+    oid_t slot = (positions == nullptr) ? selection[itr]
+                                        : positions[selection[itr]];
+    if (slot == NULL_OID) {
+      out[itr] = null_out;
+      continue;
+    }
+    T value;
+    std::memcpy(&value, base + slot * stride, sizeof(T));
+    out[itr] = (value == null_value) ? null_out : static_cast<Out>(value);
+  }
+}
+
+/*
+ * Decode the selected tuples of a compressed tile straight into the batch,
+ * without going through a Value per tuple. Outer join padding is left to the
+ * tuple at a time path.
+ */
+static bool GatherCompressedValues(const storage::CompressedTile *tile,
+                                   oid_t column_id, const oid_t *positions,
+                                   const SelectionVector &selection,
+                                   NumericBatch &batch) {
+  size_t count = selection.size();
+  const oid_t *slots = selection.data();
+
+  std::vector<oid_t> position_slots;
+  if (positions != nullptr) {
+    position_slots.resize(count);
+    for (size_t itr = 0; itr < count; itr++) {
+      position_slots[itr] = positions[selection[itr]];
+      if (position_slots[itr] == NULL_OID) return false;
+    }
+    slots = position_slots.data();
+  }
+
+  switch (tile->GetSchema()->GetType(column_id)) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+      batch.is_integer = true;
+      batch.int_values.resize(count);
+      return tile->GatherIntegers(column_id, slots, count,
+                                  batch.int_values.data());
+
+    case VALUE_TYPE_DOUBLE:
+      batch.is_integer = false;
+      batch.double_values.resize(count);
+      return tile->GatherDoubles(column_id, slots, count,
+                                 batch.double_values.data());
+
+    default:
+      return false;
+  }
+}
+
+bool BatchSource::GatherColumn(oid_t column_id,
+                               const SelectionVector &selection,
+                               NumericBatch &batch) const {
+  storage::Tile *tile = nullptr;
+  oid_t tile_column_id = INVALID_OID;
+  const oid_t *positions = nullptr;
+
+  if (tile_group_ != nullptr) {
+    oid_t tile_offset = INVALID_OID;
+    tile_group_->LocateTileAndColumn(column_id, tile_offset, tile_column_id);
+    tile = tile_group_->GetTile(tile_offset);
+  } else {
+    auto &column_info = logical_tile_->GetColumnInfo(column_id);
+    tile = column_info.base_tile.get();
+    tile_column_id = column_info.origin_column_id;
+    positions = logical_tile_->GetPositionList(column_id).data();
+  }
+
+  if (tile->IsCompressed()) {
+    return GatherCompressedValues(static_cast<storage::CompressedTile *>(tile),
+                                  tile_column_id, positions, selection, batch);
+  }
+
+  auto schema = tile->GetSchema();
+  if (schema->IsInlined(tile_column_id) == false) return false;
+
+  const char *base =
+      tile->GetTupleLocation(0) + schema->GetOffset(tile_column_id);
+  size_t stride = schema->GetLength();
+
+  switch (schema->GetType(tile_column_id)) {
+    case VALUE_TYPE_TINYINT:
+      batch.is_integer = true;
+      GatherValues<int8_t, int64_t>(base, stride, positions, selection,
+                                    INT8_NULL, INT64_NULL, batch.int_values);
+      return true;
+
+    case VALUE_TYPE_SMALLINT:
+      batch.is_integer = true;
+      GatherValues<int16_t, int64_t>(base, stride, positions, selection,
+                                     INT16_NULL, INT64_NULL, batch.int_values);
+      return true;
+
+    case VALUE_TYPE_INTEGER:
+      batch.is_integer = true;
+      GatherValues<int32_t, int64_t>(base, stride, positions, selection,
+                                     INT32_NULL, INT64_NULL, batch.int_values);
+      return true;
+
+    case VALUE_TYPE_BIGINT:
+      batch.is_integer = true;
+      GatherValues<int64_t, int64_t>(base, stride, positions, selection,
+                                     INT64_NULL, INT64_NULL, batch.int_values);
+      return true;
+
+    case VALUE_TYPE_DOUBLE:
+      // NULL is any value at or below DOUBLE_NULL, which the kernels test
+      batch.is_integer = false;
+      GatherValues<double, double>(base, stride, positions, selection,
+                                   DOUBLE_NULL, DOUBLE_NULL,
+                                   batch.double_values);
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+Value BatchSource::Evaluate(const AbstractExpression *expr, oid_t tuple_id,
+                            executor::ExecutorContext *context) const {
+  if (tile_group_ != nullptr) {
+    ContainerTuple<storage::TileGroup> tuple(tile_group_, tuple_id);
+    return expr->Evaluate(&tuple, nullptr, context);
+  } else {
+    ContainerTuple<executor::LogicalTile> tuple(logical_tile_, tuple_id);
+    return expr->Evaluate(&tuple, nullptr, context);
+  }
+}
+
+void MergeSelections(const SelectionVector &lhs, const SelectionVector &rhs,
+                     SelectionVector &result) {
+  result.resize(lhs.size() + rhs.size());
+  std::merge(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), result.begin());
+}
+
+}  // End expression namespace
+}  // End peloton namespace
@@ -42,5 +42,12 @@ Value ParameterValueExpression::Evaluate(
   return params[value_idx_];
 }
 
+bool ParameterValueExpression::EvaluateNumericBatch(
+    UNUSED_ATTRIBUTE const BatchSource &source,
+    const SelectionVector &selection, executor::ExecutorContext *context,
+    NumericBatch &batch) const {
+  return batch.Broadcast(Evaluate(nullptr, nullptr, context), selection.size());
+}
+
 }  // namespace expression
 }  // namespace peloton
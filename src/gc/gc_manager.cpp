@@ -15,7 +15,13 @@
 #include "gc/gc_manager.h"
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
+#include "catalog/manager.h"
+#include "concurrency/epoch_manager.h"
 #include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
 
 #include <list>
 
@@ -23,17 +29,17 @@ namespace peloton {
 namespace gc {
 
 GCBuffer::~GCBuffer() {
-//  auto &transaction_manager =
-//      concurrency::TransactionManagerFactory::GetInstance();
   // Add all garbage tuples to GC manager
-//  LOG_TRACE("Register garbage");
-//  if (garbage_tuples.size() != 0) {
-//    cid_t garbage_timestamp = transaction_manager.GetNextCommitId();
-//    for (auto garbage : garbage_tuples) {
-//      gc::GCManagerFactory::GetInstance().RecycleTupleSlot(
-//          table_id, garbage.block, garbage.offset, garbage_timestamp);
-//    }
-//  }
+  if (garbage_tuples.size() != 0 &&
+      GCManagerFactory::GetGCType() != GC_TYPE_OFF) {
+    // Txns that began before now may still reach the garbage, so the
+    // slots are reused only once every txn up to this timestamp is dead.
+    auto &transaction_manager =
+        concurrency::TransactionManagerFactory::GetInstance();
+    cid_t garbage_timestamp = transaction_manager.GetCurrentCommitId();
+    GCManagerFactory::GetInstance().RecycleTupleSlots(table_id, garbage_tuples,
+                                                      garbage_timestamp);
+  }
 }
 
 void GCManager::StartGC() {
@@ -42,7 +48,10 @@ void GCManager::StartGC() {
     return;
   }
   this->is_running_ = true;
-  gc_thread_.reset(new std::thread(&GCManager::Running, this));
+  for (int thread_itr = 0; thread_itr < gc_thread_count_; thread_itr++) {
+    gc_threads_.emplace_back(
+        new std::thread(&GCManager::Running, this, thread_itr));
+  }
 }
 
 void GCManager::StopGC() {
@@ -51,7 +60,10 @@ void GCManager::StopGC() {
     return;
   }
   this->is_running_ = false;
-  this->gc_thread_->join();
+  for (auto &gc_thread : gc_threads_) {
+    gc_thread->join();
+  }
+  gc_threads_.clear();
   ClearGarbage();
 }
 
@@ -76,6 +88,8 @@ bool GCManager::ResetTuple(const TupleMetadata &tuple_metadata) {
   // From now on, the tile group shared pointer is held by us
   // It's safe to set headers from now on.
 
+  DeleteFromIndexes(tile_group, tuple_metadata.tuple_slot_id);
+
   auto tile_group_header = tile_group->GetHeader();
 
   // Reset the header
@@ -97,6 +111,41 @@ bool GCManager::ResetTuple(const TupleMetadata &tuple_metadata) {
   return true;
 }
 
+void GCManager::DeleteFromIndexes(
+    const std::shared_ptr<storage::TileGroup> &tile_group,
+    const oid_t &tuple_slot_id) {
+  auto table =
+      dynamic_cast<storage::DataTable *>(tile_group->GetAbstractTable());
+  if (table == nullptr) return;
+
+  // The primary index was already switched to a newer version when the
+  // version was unlinked, but the secondary indexes got an entry for every
+  // version and still point here
+  std::unique_ptr<storage::Tuple> tuple;
+  ItemPointer location(tile_group->GetTileGroupId(), tuple_slot_id);
+
+  oid_t index_count = table->GetIndexCount();
+  for (oid_t index_itr = 0; index_itr < index_count; index_itr++) {
+    auto index = table->GetIndex(index_itr);
+    if (index == nullptr ||
+        index->GetIndexType() == INDEX_CONSTRAINT_TYPE_PRIMARY_KEY) {
+      continue;
+    }
+
+    if (tuple == nullptr) {
+      tuple.reset(new storage::Tuple(table->GetSchema(), true));
+      tile_group->CopyTuple(tuple_slot_id, tuple.get());
+    }
+
+    auto index_schema = index->GetKeySchema();
+    auto indexed_columns = index_schema->GetIndexedColumns();
+    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
+    key->SetFromTuple(tuple.get(), indexed_columns, index->GetPool());
+
+    index->DeleteEntry(key.get(), location);
+  }
+}
+
 void GCManager::AddToRecycleMap(TupleMetadata tuple_metadata) {
   // If the tuple being reset no longer exists, just skip it
   if (ResetTuple(tuple_metadata) == false) return;
@@ -106,40 +155,51 @@ void GCManager::AddToRecycleMap(TupleMetadata tuple_metadata) {
   // if the entry for table_id exists.
   if (recycle_queue_map_.find(tuple_metadata.table_id, recycle_queue) == true) {
     // if the entry for tuple_metadata.table_id exists.
-    recycle_queue->Dequeue(tuple_metadata);
+    recycle_queue->Enqueue(tuple_metadata);
   } else {
     // if the entry for tuple_metadata.table_id does not exist.
     recycle_queue.reset(new Queue<TupleMetadata>(MAX_QUEUE_LENGTH));
     bool ret =
         recycle_queue_map_.insert(tuple_metadata.table_id, recycle_queue);
     if (ret == true) {
-      recycle_queue->Dequeue(tuple_metadata);
+      recycle_queue->Enqueue(tuple_metadata);
     } else {
       recycle_queue_map_.find(tuple_metadata.table_id, recycle_queue);
-      recycle_queue->Dequeue(tuple_metadata);
+      recycle_queue->Enqueue(tuple_metadata);
     }
   }
+
+  recycled_count_++;
 }
 
-void GCManager::Running() {
+void GCManager::Running(const int &thread_id) {
   // Check if we can move anything from the possibly free list to the free list.
 
   // We use a local buffer to store all possible garbage handled by this gc
   // worker
   std::list<TupleMetadata> local_reclaim_queue;
+  auto &reclaim_queue = *reclaim_queues_[thread_id];
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  cid_t last_max_cid = 0;
+  bool backlogged = false;
 
   while (true) {
-    std::this_thread::sleep_for(
-        std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+    // Keep going without a break while the reclaim queue is backlogged
+    if (backlogged == false) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+    }
 
-    LOG_TRACE("reclaim tuple thread...");
+    LOG_TRACE("reclaim tuple thread %d...", thread_id);
 
     // First load every possible garbage into the list
-    // This step move all garbage from the global reclaim queue to the worker's
-    // local queue
-    for (size_t i = 0; i < MAX_ATTEMPT_COUNT; ++i) {
+    // This step move all garbage from the worker's reclaim queue to the
+    // worker's local queue
+    size_t collected_count = 0;
+    for (; collected_count < MAX_ATTEMPT_COUNT; ++collected_count) {
       TupleMetadata tuple_metadata;
-      if (reclaim_queue_.Dequeue(tuple_metadata) == false) {
+      if (reclaim_queue.Dequeue(tuple_metadata) == false) {
         break;
       }
       LOG_TRACE("Collect tuple (%u, %u) of table %u into local list",
@@ -147,38 +207,55 @@ void GCManager::Running() {
                 tuple_metadata.table_id);
       local_reclaim_queue.push_back(tuple_metadata);
     }
+    backlogged = (collected_count == MAX_ATTEMPT_COUNT);
 
-    // Then we go through to recycle garbage
-    auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
-    auto max_cid = txn_manager.GetMaxCommittedCid();
+    // Then we go through to recycle garbage. A slot is only reset once
+    // every txn that could still hold a reference to it has exited.
+    // One epoch check covers the whole batch, and a batch is skipped if
+    // neither the batch nor the epoch moved since the last pass.
+    auto max_cid = epoch_manager.GetMaxDeadTxnCid();
 
     assert(max_cid != MAX_CID);
 
     int tuple_counter = 0;
-    int attempt = 0;
-    auto queue_itr = local_reclaim_queue.begin();
-
-    while (queue_itr != local_reclaim_queue.end() &&
-           attempt < MAX_ATTEMPT_COUNT) {
-      if (queue_itr->tuple_end_cid <= max_cid) {
-        // add the tuple to recycle map
-        LOG_TRACE("Add tuple(%u, %u) in table %u to recycle map",
-                  queue_itr->tile_group_id, queue_itr->tuple_slot_id,
-                  queue_itr->table_id);
-        AddToRecycleMap(*queue_itr);
-        queue_itr = local_reclaim_queue.erase(queue_itr);
-        tuple_counter++;
-      } else {
-        queue_itr++;
+    if (collected_count != 0 || max_cid != last_max_cid ||
+        is_running_ == false) {
+      last_max_cid = max_cid;
+
+      int attempt = 0;
+      cid_t oldest_cid = MAX_CID;
+      auto queue_itr = local_reclaim_queue.begin();
+
+      while (queue_itr != local_reclaim_queue.end() &&
+             attempt < MAX_ATTEMPT_COUNT) {
+        if (queue_itr->tuple_end_cid <= max_cid) {
+          // add the tuple to recycle map
+          LOG_TRACE("Add tuple(%u, %u) in table %u to recycle map",
+                    queue_itr->tile_group_id, queue_itr->tuple_slot_id,
+                    queue_itr->table_id);
+          AddToRecycleMap(*queue_itr);
+          queue_itr = local_reclaim_queue.erase(queue_itr);
+          tuple_counter++;
+        } else {
+          oldest_cid = std::min(oldest_cid, queue_itr->tuple_end_cid);
+          queue_itr++;
+        }
+        attempt++;
+      }
+
+      // The tail that was not visited this pass may hold older garbage
+      if (queue_itr != local_reclaim_queue.end()) {
+        oldest_cid = std::min(oldest_cid, queue_itr->tuple_end_cid);
       }
-      attempt++;
+      oldest_unreclaimed_cids_[thread_id] = oldest_cid;
+      unreclaimed_count_ -= tuple_counter;
     }
 
     LOG_TRACE("Marked %d tuples as garbage", tuple_counter);
     if (is_running_ == false) {
       // Clear all pending garbage
       tuple_counter = 0;
-      queue_itr = local_reclaim_queue.begin();
+      auto queue_itr = local_reclaim_queue.begin();
 
       while (queue_itr != local_reclaim_queue.end()) {
         // In this case, we assume that no transaction is running
@@ -187,6 +264,8 @@ void GCManager::Running() {
         queue_itr = local_reclaim_queue.erase(queue_itr);
         tuple_counter++;
       }
+      oldest_unreclaimed_cids_[thread_id] = MAX_CID;
+      unreclaimed_count_ -= tuple_counter;
 
       LOG_TRACE("GCThread recycle last %d tuples before exits", tuple_counter);
       return;
@@ -209,13 +288,46 @@ void GCManager::RecycleTupleSlot(const oid_t &table_id,
   tuple_metadata.tuple_slot_id = tuple_id;
   tuple_metadata.tuple_end_cid = tuple_end_cid;
 
-  reclaim_queue_.Enqueue(tuple_metadata);
+  unreclaimed_count_++;
+  GetReclaimQueue(table_id).Enqueue(tuple_metadata);
 
   LOG_TRACE("Marked tuple(%u, %u) in table %u as possible garbage",
             tuple_metadata.tile_group_id, tuple_metadata.tuple_slot_id,
             tuple_metadata.table_id);
 }
 
+void GCManager::RecycleTupleSlots(const oid_t &table_id,
+                                  const std::vector<ItemPointer> &tuple_slots,
+                                  const cid_t &tuple_end_cid) {
+  if (this->gc_type_ == GC_TYPE_OFF) {
+    return;
+  }
+
+  auto &reclaim_queue = GetReclaimQueue(table_id);
+  unreclaimed_count_ += tuple_slots.size();
+
+  TupleMetadata tuple_metadata;
+  tuple_metadata.table_id = table_id;
+  tuple_metadata.tuple_end_cid = tuple_end_cid;
+  for (auto &tuple_slot : tuple_slots) {
+    tuple_metadata.tile_group_id = tuple_slot.block;
+    tuple_metadata.tuple_slot_id = tuple_slot.offset;
+    reclaim_queue.Enqueue(tuple_metadata);
+  }
+
+  LOG_TRACE("Marked %lu tuples in table %u as possible garbage",
+            tuple_slots.size(), table_id);
+}
+
+cid_t GCManager::GetOldestUnreclaimedCid() const {
+  cid_t oldest_cid = MAX_CID;
+  for (int thread_itr = 0; thread_itr < gc_thread_count_; thread_itr++) {
+    oldest_cid =
+        std::min(oldest_cid, oldest_unreclaimed_cids_[thread_itr].load());
+  }
+  return oldest_cid;
+}
+
 // this function returns a free tuple slot, if one exists
 // called by data_table.
 ItemPointer GCManager::ReturnFreeSlot(const oid_t &table_id) {
@@ -230,6 +342,7 @@ ItemPointer GCManager::ReturnFreeSlot(const oid_t &table_id) {
     if (recycle_queue->Dequeue(tuple_metadata) == true) {
       LOG_TRACE("Reuse tuple(%u, %u) in table %u", tuple_metadata.tile_group_id,
                 tuple_metadata.tuple_slot_id, table_id);
+      reused_count_++;
       return ItemPointer(tuple_metadata.tile_group_id,
                          tuple_metadata.tuple_slot_id);
     }
@@ -237,6 +350,59 @@ ItemPointer GCManager::ReturnFreeSlot(const oid_t &table_id) {
   return ItemPointer();
 }
 
+// this function refills the free slot cache of a thread
+// called by data_table.
+size_t GCManager::ReturnFreeSlots(const oid_t &table_id,
+                                  std::vector<ItemPointer> &free_slots,
+                                  const size_t &max_count) {
+  if (this->gc_type_ == GC_TYPE_OFF) {
+    return 0;
+  }
+
+  std::shared_ptr<Queue<TupleMetadata>> recycle_queue;
+  if (recycle_queue_map_.find(table_id, recycle_queue) == false) {
+    return 0;
+  }
+
+  size_t count = 0;
+  TupleMetadata tuple_metadata;
+  while (count < max_count && recycle_queue->Dequeue(tuple_metadata) == true) {
+    free_slots.emplace_back(tuple_metadata.tile_group_id,
+                            tuple_metadata.tuple_slot_id);
+    count++;
+  }
+
+  LOG_TRACE("Reuse %lu tuples in table %u", count, table_id);
+  reused_count_ += count;
+  return count;
+}
+
+// this function returns the free slot cache of an exiting thread
+// called by data_table.
+void GCManager::PutBackFreeSlots(const oid_t &table_id,
+                                 const std::vector<ItemPointer> &free_slots) {
+  if (this->gc_type_ == GC_TYPE_OFF || free_slots.empty() == true) {
+    return;
+  }
+
+  // The queue goes away with the table, then so do its slots
+  std::shared_ptr<Queue<TupleMetadata>> recycle_queue;
+  if (recycle_queue_map_.find(table_id, recycle_queue) == false) {
+    return;
+  }
+
+  TupleMetadata tuple_metadata;
+  tuple_metadata.table_id = table_id;
+  for (auto &free_slot : free_slots) {
+    tuple_metadata.tile_group_id = free_slot.block;
+    tuple_metadata.tuple_slot_id = free_slot.offset;
+    recycle_queue->Enqueue(tuple_metadata);
+  }
+
+  LOG_TRACE("Put back %lu tuples in table %u", free_slots.size(), table_id);
+  reused_count_ -= free_slots.size();
+}
+
 // this function can only be called after:
 //    1) All txns have exited
 //    2) The background gc thread has exited
@@ -245,12 +411,15 @@ void GCManager::ClearGarbage() {
   // world now.
   TupleMetadata tuple_metadata;
   int counter = 0;
-  while (reclaim_queue_.Dequeue(tuple_metadata) == true) {
-    // In such case, we assume it's the end of the world and every possible
-    // garbage is actually garbage
-    AddToRecycleMap(tuple_metadata);
-    counter++;
+  for (auto &reclaim_queue : reclaim_queues_) {
+    while (reclaim_queue->Dequeue(tuple_metadata) == true) {
+      // In such case, we assume it's the end of the world and every possible
+      // garbage is actually garbage
+      AddToRecycleMap(tuple_metadata);
+      counter++;
+    }
   }
+  unreclaimed_count_ -= counter;
 
   LOG_TRACE("GCManager finally recyle %d tuples", counter);
 }
@@ -18,5 +18,7 @@ namespace gc {
 
 GCType GCManagerFactory::gc_type_ = GC_TYPE_OFF;
 
+int GCManagerFactory::gc_thread_count_ = 1;
+
 }  // namespace gc
 }  // namespace peloton
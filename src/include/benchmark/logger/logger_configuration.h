@@ -67,6 +67,15 @@ class configuration {
   // frequency with which the logger flushes
   int wait_timeout;
 
+  // how long a commit group may wait for more commits (in us)
+  int commit_delay;
+
+  // max commits in a commit group (0 means no limit)
+  int group_commit_size;
+
+  // threads replaying the log in recovery (0 or 1 means no parallel replay)
+  int recovery_thread_count;
+
   // Benchmark type
   BenchmarkType benchmark_type;
 
@@ -81,6 +90,15 @@ class configuration {
 
   // asynchronous_mode
   AsynchronousType asynchronous_mode;
+
+  // ip:port of the replicas the log is shipped to
+  std::vector<std::string> replicas;
+
+  // port of the replication server (0 means no replication)
+  int replication_port;
+
+  // replay the log of a primary instead of running the workload
+  bool standby;
 };
 
 void Usage(FILE *out);
@@ -48,6 +48,12 @@ void ResetSystem(void);
 
 void DoRecovery();
 
+//===--------------------------------------------------------------------===//
+// STANDBY
+//===--------------------------------------------------------------------===//
+
+void RunStandby();
+
 //===--------------------------------------------------------------------===//
 // WRITING LOG RECORD
 //===--------------------------------------------------------------------===//
@@ -29,7 +29,10 @@ enum OperatorType {
   OPERATOR_TYPE_INVALID = 0, /* invalid */
 
   OPERATOR_TYPE_DIRECT = 1,
-  OPERATOR_TYPE_INSERT = 2
+  OPERATOR_TYPE_INSERT = 2,
+  OPERATOR_TYPE_PREDICATE = 3,
+  OPERATOR_TYPE_VISIBILITY = 4,
+  OPERATOR_TYPE_COMPRESSION = 5
 
 };
 
@@ -60,6 +63,9 @@ class configuration {
   // tile group layout
   LayoutType layout_mode;
 
+  // tuple header layout
+  HeaderLayoutType header_layout;
+
   double selectivity;
 
   double projectivity;
@@ -73,6 +79,9 @@ class configuration {
   // update ratio
   double write_ratio;
 
+  // # of threads for sequential scans
+  int parallelism;
+
   // # of times to run operator
   unsigned long transactions;
 
@@ -27,6 +27,12 @@ void RunDirectTest();
 
 void RunInsertTest();
 
+void RunPredicateTest();
+
+void RunVisibilityTest();
+
+void RunCompressionTest();
+
 void RunAdaptExperiment();
 
 }  // namespace sdbench
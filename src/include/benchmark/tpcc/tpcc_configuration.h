@@ -78,6 +78,21 @@ class configuration {
   // execution duration (ms)
   int duration;
 
+  // insert through one tile group per backend
+  bool per_thread_inserts;
+
+  // fuzzy checkpoint interval during the workload (ms, 0 means none)
+  int checkpoint_interval;
+
+  // threads of a fuzzy checkpoint
+  int checkpoint_thread_count;
+
+  // checkpoints taken during the workload
+  int checkpoint_count;
+
+  // average checkpoint duration (ms)
+  double checkpoint_latency;
+
   // throughput
   double throughput;
 
@@ -104,6 +119,8 @@ void ValidateBackendCount(const configuration &state);
 
 void ValidateDuration(const configuration &state);
 
+void ValidateCheckpointInterval(const configuration &state);
+
 void ParseArguments(int argc, char *argv[], configuration &state);
 
 }  // namespace tpcc
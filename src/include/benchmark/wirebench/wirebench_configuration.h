@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_configuration.h
+//
+// Identification: src/include/benchmark/wirebench/wirebench_configuration.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <string>
+#include <getopt.h>
+#include <vector>
+#include <sys/time.h>
+#include <iostream>
+
+#include "common/types.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+enum ConnectionModel {
+  CONNECTION_MODEL_INVALID = 0,
+
+  CONNECTION_MODEL_THREAD = 1,  // one thread per client connection
+  CONNECTION_MODEL_EVENT = 2    // epoll reactors + worker pool
+};
+
+class configuration {
+ public:
+  // server connection model
+  ConnectionModel connection_model;
+
+  // number of client connections
+  int connection_count;
+
+  // number of client threads driving the connections
+  int client_count;
+
+  // server port
+  int port;
+
+  // execution duration (in ms)
+  int duration;
+
+  // event server I/O threads
+  int io_thread_count;
+
+  // event server workers
+  int worker_count;
+
+  // event server admission limit
+  int max_in_flight;
+
+  // throughput (queries/s)
+  double throughput;
+
+  // latency percentiles (in us)
+  double latency_p50;
+  double latency_p99;
+};
+
+extern configuration state;
+
+void Usage(FILE *out);
+
+void ParseArguments(int argc, char *argv[], configuration &state);
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,32 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_workload.h
+//
+// Identification: src/include/benchmark/wirebench/wirebench_workload.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "benchmark/wirebench/wirebench_configuration.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+extern configuration state;
+
+void StartServer();
+
+void StopServer();
+
+void RunWorkload();
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
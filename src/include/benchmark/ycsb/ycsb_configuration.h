@@ -63,6 +63,45 @@ class configuration {
   // skew
   SkewFactor skew_factor;
 
+  // index type of the primary key
+  IndexType index;
+
+  // insert through one tile group per backend
+  bool per_thread_inserts;
+
+  // updates modify existing tuples instead of inserting new ones
+  bool update_existing;
+
+  // recycle the slots of garbage versions
+  bool gc_mode;
+
+  // number of GC threads
+  int gc_thread_count;
+
+  // maintain the optimizer stats on the write path
+  bool write_stats;
+
+  // epoch length (in ms)
+  int epoch_length;
+
+  // interval between throughput and memory snapshots (in ms), 0 disables
+  int snapshot_duration;
+
+  // throughput of each snapshot interval
+  std::vector<double> snapshot_throughputs;
+
+  // resident memory (in MB) at the end of each snapshot interval
+  std::vector<double> snapshot_memory;
+
+  // unreclaimed garbage tuples at the end of each snapshot interval
+  std::vector<size_t> snapshot_gc_queue_depths;
+
+  // tile groups of the user table at the end of the run
+  size_t tile_group_count;
+
+  // resident memory (in MB) at the end of the run
+  double memory;
+
   // latency average
   double latency;
 };
@@ -85,6 +124,14 @@ void ValidateDuration(const configuration &state);
 
 void ValidateSkewFactor(const configuration &state);
 
+void ValidateIndex(const configuration &state);
+
+void ValidateSnapshotDuration(const configuration &state);
+
+void ValidateGCThreadCount(const configuration &state);
+
+void ValidateEpochLength(const configuration &state);
+
 }  // namespace ycsb
 }  // namespace benchmark
 }  // namespace peloton
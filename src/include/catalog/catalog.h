@@ -86,6 +86,13 @@ public:
  // Get a new id for database, table, etc.
  oid_t GetNewID();
 
+ // Version of the catalog, bumped on every DDL change. Used to invalidate
+ // cached plans that were built against an older schema.
+ static uint64_t GetSchemaVersion();
+
+ // Invalidate all the plans built against the current schema
+ static void BumpSchemaVersion();
+
 private:
  // A vector of the database pointers in the catalog
  std::vector<storage::Database*> databases;
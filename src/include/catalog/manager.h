@@ -34,6 +34,10 @@ class TileGroup;
 namespace index {
 class Index;
 }
+namespace optimizer {
+class TableStats;
+class TableWriteStats;
+}
 
 namespace catalog {
 
@@ -98,6 +102,30 @@ class Manager {
   index::Index *GetIndexWithOid(const oid_t database_oid, const oid_t table_oid,
                                 const oid_t index_oid) const;
 
+  //===--------------------------------------------------------------------===//
+  // STATISTICS
+  //===--------------------------------------------------------------------===//
+
+  // The stats of the last ANALYZE of the table
+  void SetTableStats(const oid_t table_oid,
+                     std::shared_ptr<optimizer::TableStats> stats);
+
+  std::shared_ptr<optimizer::TableStats> GetTableStats(const oid_t table_oid);
+
+  void DropTableStats(const oid_t table_oid);
+
+  // The stats the writes to the table maintain, registered by the table
+  void AddTableWriteStats(const oid_t table_oid,
+                          std::shared_ptr<optimizer::TableWriteStats> stats);
+
+  std::shared_ptr<optimizer::TableWriteStats> GetTableWriteStats(
+      const oid_t table_oid);
+
+  // Only if they are still the registered ones, a newer table may reuse the
+  // oid
+  void DropTableWriteStats(const oid_t table_oid,
+                           const optimizer::TableWriteStats *stats);
+
   Manager(Manager const &) = delete;
 
  private:
@@ -114,6 +142,16 @@ class Manager {
   std::vector<storage::Database *> databases;
 
   std::mutex catalog_mutex;
+
+  // STATISTICS
+
+  std::unordered_map<oid_t, std::shared_ptr<optimizer::TableStats>>
+      table_stats;
+
+  std::unordered_map<oid_t, std::shared_ptr<optimizer::TableWriteStats>>
+      table_write_stats;
+
+  std::mutex stats_mutex;
 };
 
 }  // End catalog namespace
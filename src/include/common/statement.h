@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "common/types.h"
+#include "common/value.h"
 
 namespace peloton {
 namespace planner{
@@ -67,6 +68,10 @@ class Statement {
 
   const std::shared_ptr<planner::AbstractPlan>& GetPlanTree() const;
 
+  void SetParamValues(const std::vector<Value>& param_values);
+
+  const std::vector<Value>& GetParamValues() const;
+
  private:
 
   // logical name of statement
@@ -87,6 +92,9 @@ class Statement {
   // cached plan tree
   std::shared_ptr<planner::AbstractPlan> plan_tree;
 
+  // literals lifted out of the query string, bound to the plan's parameters
+  std::vector<Value> param_values;
+
 };
 
 }  // namespace peloton
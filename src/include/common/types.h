@@ -55,6 +55,7 @@ enum LoggerMappingStrategyType {
 enum CheckpointType {
   CHECKPOINT_TYPE_INVALID = 0,
   CHECKPOINT_TYPE_NORMAL = 1,
+  CHECKPOINT_TYPE_FUZZY = 2,
 };
 
 enum GCType {
@@ -413,6 +414,12 @@ enum BackendType {
   BACKEND_TYPE_HDD = 4       // on hdd
 };
 
+// Layout of the MVCC tuple headers of a tile group
+enum HeaderLayoutType {
+  HEADER_LAYOUT_ROW = 0,    // one record per tuple
+  HEADER_LAYOUT_COLUMN = 1  // one array per header field
+};
+
 //===--------------------------------------------------------------------===//
 // Index Types
 //===--------------------------------------------------------------------===//
@@ -511,6 +518,7 @@ enum PlanNodeType {
   PLAN_NODE_TYPE_SEND = 40,
   PLAN_NODE_TYPE_RECEIVE = 41,
   PLAN_NODE_TYPE_PRINT = 42,
+  PLAN_NODE_TYPE_GATHER = 43,
 
   // Algebra Nodes
   PLAN_NODE_TYPE_AGGREGATE = 50,
@@ -889,6 +897,13 @@ struct ItemPointerHasher {
   }
 };
 
+// Compares the locations two item pointers point to
+struct ItemPointerPtrEqualityChecker {
+  bool operator()(const ItemPointer *lhs, const ItemPointer *rhs) const {
+    return lhs->block == rhs->block && lhs->offset == rhs->offset;
+  }
+};
+
 //===--------------------------------------------------------------------===//
 // File Handle
 //===--------------------------------------------------------------------===//
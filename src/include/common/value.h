@@ -390,6 +390,7 @@ class Value {
   /**
    * @brief Do a deep copy of the given value.
    * Uninlined data will be allocated in the provided memory pool.
+   * Without a pool, a value inlined in a tuple still points into the tuple.
    */
   static Value Clone(const Value &src, VarlenPool *varlen_pool);
 
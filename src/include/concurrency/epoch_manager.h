@@ -13,8 +13,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <thread>
-#include <vector>
 
 #include "common/macros.h"
 #include "common/types.h"
@@ -23,205 +25,131 @@
 namespace peloton {
 namespace concurrency {
 
+// default epoch length (in ms)
 #define EPOCH_LENGTH 40
 
-struct Epoch {
-  std::atomic<int> txn_ref_count_;
-  cid_t max_cid_;
+// max number of live threads that can use the epoch manager, a thread holds
+// its slot until it exits
+#define MAX_EPOCH_THREAD_COUNT 1024
 
-  Epoch() : txn_ref_count_(0), max_cid_(0) {}
+//===--------------------------------------------------------------------===//
+// Epoch Slot
+//===--------------------------------------------------------------------===//
 
-  void Init() {
-    txn_ref_count_ = 0;
-    max_cid_ = 0;
-  }
-};
+// Every thread registers in its own slot, so entering and exiting an epoch
+// only writes to a cache line that no other worker writes to.
+struct CACHE_ALIGNED EpochSlot {
+  // epoch of the outermost registration, MAX_EPOCH if the thread is idle
+  std::atomic<size_t> epoch_;
 
-class EpochManager {
- public:
-  EpochManager()
-      : epoch_queue_(epoch_queue_size_),
-        queue_tail_(0),
-        current_epoch_(0),
-        queue_tail_gc(true),
-        max_cid(0),
-        finish_(false) {
-    // ts_thread_.reset(new std::thread(&EpochManager::Start, this));
-    // ts_thread_->detach();
-    ts_thread_ = std::thread(&EpochManager::Start, this);
-  }
+  // begin cid of the outermost txn, MAX_CID if there is none
+  std::atomic<cid_t> begin_cid_;
 
-  void Reset() {
-    finish_ = true;
-    ts_thread_.join();
+  // largest begin cid the thread ever registered
+  std::atomic<cid_t> max_cid_;
 
-    queue_tail_ = 0;
-    current_epoch_ = 0;
-    epoch_queue_[0].Init();
-    queue_tail_gc = true;
-    max_cid = 0;
+  // nesting depth of the registrations, only touched by the owner
+  size_t depth_;
 
-    finish_ = false;
-    ts_thread_ = std::thread(&EpochManager::Start, this);
-  }
+  // depth of the registration that set begin_cid_, only touched by the owner
+  size_t cid_depth_;
 
-  ~EpochManager() {
-    finish_ = true;
-    ts_thread_.join();
-  }
+  // whether a thread owns the slot
+  std::atomic<bool> in_use_;
 
-  //    static uint64_t GetEpoch() {
-  //
-  //      COMPILER_MEMORY_FENCE;
-  //
-  //      uint64_t ret_ts = curr_epoch_;
-  //
-  //      COMPILER_MEMORY_FENCE;
-  //
-  //      return ret_ts;
-  //    }
+  EpochSlot() : max_cid_(0), in_use_(false) { Init(); }
 
-  size_t EnterEpoch(cid_t begin_cid) {
-    auto epoch = current_epoch_.load();
+  // Clear the registration, max_cid_ outlives the owner
+  void Init() {
+    epoch_ = MAX_EPOCH;
+    begin_cid_ = MAX_CID;
+    depth_ = 0;
+    cid_depth_ = 0;
+  }
 
-    size_t epoch_idx = epoch % epoch_queue_size_;
-    epoch_queue_[epoch_idx].txn_ref_count_++;
+  static constexpr size_t MAX_EPOCH = std::numeric_limits<size_t>::max();
+};
 
-    // Set the max cid in the tuple
-    auto max_cid_ptr = &(epoch_queue_[epoch_idx].max_cid_);
-    AtomicMax(max_cid_ptr, begin_cid);
+//===--------------------------------------------------------------------===//
+// Epoch Manager
+//===--------------------------------------------------------------------===//
 
-    return epoch;
-  }
+// Workers only touch their own slot. A background thread advances the
+// epoch every epoch length and, in the same pass, derives the tail epoch
+// and the max dead txn cid from the slots.
+class EpochManager {
+ public:
+  EpochManager();
 
-  void ExitEpoch(size_t epoch) {
-    PL_ASSERT(epoch >= queue_tail_);
-    PL_ASSERT(epoch <= current_epoch_);
+  ~EpochManager();
 
-    auto epoch_idx = epoch % epoch_queue_size_;
+  void Reset();
 
-    epoch_queue_[epoch_idx].txn_ref_count_--;
-  }
-  // assume we store epoch_store max_store previously
-  cid_t GetMaxDeadTxnCid() {
-    // TODO:
-    // change to:
-    // increase tail
-    // return max
-    auto tail = queue_tail_.load();
-    auto head = current_epoch_.load();
-    if (head > 0) {
-      head--;
-    }
-    auto res = max_cid;
-
-    auto dead_num = 0;
-    while (tail < head) {
-      auto idx = tail % epoch_queue_size_;
-      // break when meeting running txn
-      if (epoch_queue_[idx].txn_ref_count_ > 0) {
-        break;
-      }
-
-      if (epoch_queue_[idx].max_cid_ > res) {
-        res = epoch_queue_[idx].max_cid_;
-      }
-      tail++;
-      dead_num++;
-    }
-    if (res > max_cid) {
-      AtomicMax(&max_cid, res);
-    }
-
-    if (dead_num > 32) {
-      IncreaseTail();
-    }
-    return max_cid;
-  }
+  // Register the calling thread in the current epoch. A begin_cid of 0
+  // registers a reader that is not a txn, it only holds the epoch back.
+  // Registrations of a thread nest, and are exited by the same thread.
+  // The begin cid is not checked against the max dead txn cid, txns take
+  // theirs with the overload below. Throws a TransactionException if the
+  // thread finds no free slot.
+  size_t EnterEpoch(cid_t begin_cid);
 
- private:
-  void Start() {
-    while (!finish_) {
-      // the epoch advances every 40 milliseconds.
-      std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
-
-      auto next_idx = (current_epoch_.load() + 1) % epoch_queue_size_;
-      auto tail_idx = queue_tail_.load() % epoch_queue_size_;
-      if (next_idx == tail_idx) {
-        // overflow
-        // in this case, just increase tail
-        IncreaseTail();
-        continue;
-      }
-
-      // we have to init it first, then increase current epoch
-      // otherwise may read dirty data
-      epoch_queue_[next_idx].Init();
-      current_epoch_++;
-
-      IncreaseTail();
-    }
-  }
+  // Register a txn in the current epoch. Its begin cid comes from
+  // next_begin_cid once the registration is visible, and is taken again if
+  // the max dead txn cid has already passed it, e.g. a cid from a stale
+  // block. Every txn up to the max dead txn cid exits without it.
+  size_t EnterEpoch(const std::function<cid_t()> &next_begin_cid,
+                    cid_t &begin_cid);
+
+  void ExitEpoch(size_t epoch);
 
-  void IncreaseTail() {
-    bool expect = true, desired = false;
-    if (!queue_tail_gc.compare_exchange_weak(expect, desired)) {
-      // someone now is increasing tail
-      return;
-    }
+  size_t GetCurrentEpoch() { return current_epoch_.load(); }
 
-    auto current = current_epoch_.load();
-    auto tail = queue_tail_.load();
+  // Every epoch before the tail has been exited by all its members
+  size_t GetTailEpoch() { return tail_epoch_.load(); }
 
-    while (true) {
-      if (tail + 1 == current) {
-        break;
-      }
+  // Every txn with a begin cid up to this one has exited
+  cid_t GetMaxDeadTxnCid() { return max_dead_cid_.load(); }
 
-      auto idx = tail % epoch_queue_size_;
+  void SetEpochLength(size_t epoch_length) { epoch_length_ = epoch_length; }
 
-      // inc tail until we find an epoch that has running txn
-      if (epoch_queue_[idx].txn_ref_count_ > 0) {
-        break;
-      }
+  size_t GetEpochLength() const { return epoch_length_.load(); }
 
-      // save max cid
-      auto max = epoch_queue_[idx].max_cid_;
-      AtomicMax(&max_cid, max);
-      tail++;
-    }
+ private:
+  void Start();
 
-    queue_tail_ = tail;
+  // Recompute the tail epoch and max dead txn cid from the slots
+  void UpdateTail();
 
-    expect = false;
-    desired = true;
+  // Wait for the end of an UpdateTail pass that is in progress
+  void WaitForTailUpdate();
 
-    queue_tail_gc.compare_exchange_weak(expect, desired);
-    return;
-  }
+  // Slot of the calling thread, claimed on first use. Throws a
+  // TransactionException if every slot is held by a live thread.
+  EpochSlot &GetThreadSlot();
 
-  void AtomicMax(cid_t* addr, cid_t max) {
-    while (true) {
-      auto old = *addr;
-      if (old > max) {
-        return;
-      } else if (__sync_bool_compare_and_swap(addr, old, max)) {
-        return;
-      }
-    }
+  void AtomicMax(std::atomic<cid_t> &value, cid_t max) {
+    auto old = value.load();
+    while (old < max && value.compare_exchange_weak(old, max) == false)
+      ;
   }
 
  private:
-  // queue size
-  static const size_t epoch_queue_size_ = 2048;
+  EpochSlot epoch_slots_[MAX_EPOCH_THREAD_COUNT];
+
+  // slots beyond this one were never used
+  std::atomic<size_t> epoch_slot_count_;
 
-  // Epoch vector
-  std::vector<Epoch> epoch_queue_;
-  std::atomic<size_t> queue_tail_;
   std::atomic<size_t> current_epoch_;
-  std::atomic<bool> queue_tail_gc;
-  cid_t max_cid;
-  bool finish_;
+  std::atomic<size_t> tail_epoch_;
+  std::atomic<cid_t> max_dead_cid_;
+
+  // UpdateTail passes begun and ended, odd while one is in progress
+  std::atomic<size_t> tail_update_count_;
+
+  // epoch length (in ms)
+  std::atomic<size_t> epoch_length_;
+
+  std::atomic<bool> finish_;
 
   std::thread ts_thread_;
 };
@@ -66,10 +66,12 @@ class OptimisticTxnManager : public TransactionManager {
 
   virtual Transaction *BeginTransaction() {
     txn_id_t txn_id = GetNextTransactionId();
-    cid_t begin_cid = GetNextCommitId();
+    // Only writers take a commit id, when they commit. The snapshot is taken
+    // once the txn holds back the GC.
+    cid_t begin_cid;
+    auto eid = EpochManagerFactory::GetInstance().EnterEpoch(
+        [this] { return GetSnapshotCommitId(); }, begin_cid);
     Transaction *txn = new Transaction(txn_id, begin_cid);
-
-    auto eid = EpochManagerFactory::GetInstance().EnterEpoch(begin_cid);
     txn->SetEpochId(eid);
 
     current_txn = txn;
@@ -17,6 +17,7 @@
 #include <unordered_map>
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "storage/tile_group_header.h"
 #include "concurrency/transaction.h"
@@ -42,17 +43,34 @@ extern thread_local Transaction *current_txn;
 
 #define RUNNING_TXN_BUCKET_NUM 10
 
+// Number of txn ids a thread takes from the shared counter at once
+#define TXN_ID_BLOCK_SIZE 64
+
+// Most commit ids a thread takes from the shared counter at once
+#define COMMIT_ID_BLOCK_SIZE 16
+
+// One bit per tuple slot of a tile group, set if the version is visible
+typedef std::vector<uint64_t> VisibilityBitmap;
+
+// Append the slots set in the bitmap to the position list, in order
+void GetPositionList(const VisibilityBitmap &bitmap,
+                     std::vector<oid_t> &position_list);
+
 class TransactionManager {
  public:
   TransactionManager() {
     next_txn_id_ = ATOMIC_VAR_INIT(START_TXN_ID);
+    block_generation_ = ATOMIC_VAR_INIT(0);
     next_cid_ = ATOMIC_VAR_INIT(START_CID);
+    max_published_cid_ = ATOMIC_VAR_INIT(0);
     maximum_grant_cid_ = ATOMIC_VAR_INIT(MAX_CID);
   }
 
   virtual ~TransactionManager() {}
 
-  txn_id_t GetNextTransactionId() { return next_txn_id_++; }
+  // Txn ids only have to be unique, so every thread hands them out from its
+  // own block and touches the shared counter once per TXN_ID_BLOCK_SIZE ids
+  txn_id_t GetNextTransactionId();
 
   cid_t GetNextCommitId() {
     cid_t temp_cid = next_cid_++;
@@ -62,6 +80,33 @@ class TransactionManager {
     return temp_cid;
   }
 
+  // A snapshot that sees every commit id handed out so far, without taking
+  // a commit id of its own. Only commits that follow it get a larger one.
+  cid_t GetSnapshotCommitId() {
+    cid_t snapshot_cid = next_cid_.load() - 1;
+    if (snapshot_cid < START_CID || snapshot_cid > maximum_grant_cid_.load()) {
+      return GetNextCommitId();
+    }
+    return snapshot_cid;
+  }
+
+  // Unique commit ids that every thread hands out from its own block. A
+  // block is dropped once a published commit id or the max dead txn cid
+  // reaches it, so a txn still sees every commit that finished before it
+  // began and never starts behind the GC. Dropped blocks shrink, under a
+  // write workload a begin takes about one id from the shared counter.
+  cid_t GetNextThreadCommitId();
+
+  // Make a commit id that came from a block visible to the txns that begin
+  // later. Has to happen before the commit installs its versions.
+  void PublishCommitId(const cid_t &commit_id) {
+    auto old_cid = max_published_cid_.load();
+    while (old_cid < commit_id &&
+           max_published_cid_.compare_exchange_weak(old_cid, commit_id) ==
+               false)
+      ;
+  }
+
   cid_t GetCurrentCommitId() { return next_cid_.load(); }
 
   bool IsOccupied(const ItemPointer &position);
@@ -70,6 +115,15 @@ class TransactionManager {
       const storage::TileGroupHeader *const tile_group_header,
       const oid_t &tuple_id) = 0;
 
+  // Visibility of every occupied slot of a tile group to the transaction
+  // "txn_id" that began at "begin_cid", in one pass over the tuple headers.
+  // Follows the rules of IsVisible(), and versions in the dirty range left
+  // by recovery are never visible. Returns the number of slots covered.
+  oid_t ComputeVisibility(
+      const storage::TileGroupHeader *const tile_group_header,
+      const cid_t &begin_cid, const txn_id_t &txn_id,
+      VisibilityBitmap &bitmap);
+
   virtual bool IsOwner(const storage::TileGroupHeader *const tile_group_header,
                        const oid_t &tuple_id) = 0;
 
@@ -106,7 +160,10 @@ class TransactionManager {
   }
 
   // for use by recovery
-  void SetNextCid(cid_t cid) { next_cid_ = cid; }
+  void SetNextCid(cid_t cid) {
+    next_cid_ = cid;
+    block_generation_++;
+  }
 
   void SetMaxGrantCid(cid_t cid) { maximum_grant_cid_ = cid; }
 
@@ -121,6 +178,9 @@ class TransactionManager {
   void ResetStates() {
     next_txn_id_ = START_TXN_ID;
     next_cid_ = START_CID;
+    max_published_cid_ = 0;
+    // drop the blocks threads still hold
+    block_generation_++;
   }
 
   // this function generates the maximum commit id of committed transactions.
@@ -145,7 +205,11 @@ class TransactionManager {
 
  private:
   std::atomic<txn_id_t> next_txn_id_;
+  // bumped whenever the counters are reset, blocks of an older generation
+  // are dropped
+  std::atomic<size_t> block_generation_;
   std::atomic<cid_t> next_cid_;
+  std::atomic<cid_t> max_published_cid_;
   std::atomic<cid_t> maximum_grant_cid_;
 };
 }  // End storage namespace
@@ -66,11 +66,14 @@ class TsOrderTxnManager : public TransactionManager {
 
   virtual Transaction *BeginTransaction() {
     txn_id_t txn_id = GetNextTransactionId();
-    cid_t begin_cid = GetNextCommitId();
+    // The begin cid is also the commit timestamp, it only has to be unique.
+    // It is taken once the txn holds back the GC, a cid of a stale block is
+    // replaced.
+    cid_t begin_cid;
+    auto eid = EpochManagerFactory::GetInstance().EnterEpoch(
+        [this] { return GetNextThreadCommitId(); }, begin_cid);
     Transaction *txn = new Transaction(txn_id, begin_cid);
     current_txn = txn;
-
-    auto eid = EpochManagerFactory::GetInstance().EnterEpoch(begin_cid);
     txn->SetEpochId(eid);
 
     return txn;
@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bw_tree_map.h
+//
+// Identification: src/include/container/bw_tree_map.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace peloton {
+
+// BW_TREE_MAP_TEMPLATE_ARGUMENTS
+#define BW_TREE_MAP_TEMPLATE_ARGUMENTS                                 \
+  template <typename KeyType, typename ValueType, typename KeyComparator, \
+            typename ValueEqualityChecker, typename ValueDeleter>
+
+// BW_TREE_MAP_TYPE
+#define BW_TREE_MAP_TYPE                                       \
+  BwTreeMap<KeyType, ValueType, KeyComparator, ValueEqualityChecker, \
+            ValueDeleter>
+
+/**
+ * Latch-free B+tree multimap (Bw-Tree).
+ *
+ * Nodes are reached through a mapping table from logical node ids to
+ * physical nodes, so a node is changed by a single compare-and-swap on its
+ * mapping table slot. Updates prepend immutable delta records to a node;
+ * once the delta chain gets long the node is consolidated into a new base
+ * node, and split if it grew too large. Every node carries its high key and
+ * right sibling, so readers that race with a split move right (B-link) until
+ * the separator has been posted to the parent.
+ *
+ * Every operation runs inside an epoch of the concurrency::EpochManager.
+ * Replaced chains are only freed once all the epochs that could still see
+ * them have ended.
+ *
+ * KeyComparator returns <0, 0 or >0. The map owns its values: values hidden
+ * by a delete and values still present when the map is destroyed are
+ * released with ValueDeleter.
+ */
+BW_TREE_MAP_TEMPLATE_ARGUMENTS
+class BwTreeMap {
+ public:
+  BwTreeMap(const BwTreeMap &) = delete;
+  BwTreeMap &operator=(const BwTreeMap &) = delete;
+
+  BwTreeMap();
+  ~BwTreeMap();
+
+  // Inserts a <key, value> pair, duplicates are allowed
+  void Insert(const KeyType &key, const ValueType &value);
+
+  // Inserts the pair unless the predicate holds for a value of the key.
+  // Returns false, and does not take the value, if it was not inserted.
+  bool ConditionalInsert(const KeyType &key, const ValueType &value,
+                         std::function<bool(const ValueType &)> predicate);
+
+  // Removes every pair of the key whose value equals "value".
+  // Returns false, and does not take the value, if there was none.
+  bool Delete(const KeyType &key, const ValueType &value);
+
+  // Values of the key
+  void Find(const KeyType &key, std::vector<ValueType> &values);
+
+  // Pairs with low_key <= key <= high_key in key order, a null bound is open
+  void Scan(const KeyType *low_key, const KeyType *high_key,
+            std::vector<std::pair<KeyType, ValueType>> &result);
+
+  // Like the above, but the visitor runs while the operation still holds its
+  // epoch, so whatever the values point to cannot be freed under it
+  void Find(const KeyType &key,
+            std::function<void(const ValueType &)> visitor);
+
+  void Scan(const KeyType *low_key, const KeyType *high_key,
+            std::function<void(const KeyType &, const ValueType &)> visitor);
+
+  // Frees the retired nodes no running operation can see anymore
+  void PerformGarbageCollection();
+
+  // Number of nodes in the mapping table
+  size_t GetNodeCount() const { return next_node_id_.load(); }
+
+ private:
+  typedef uint64_t NodeId;
+
+  enum NodeType {
+    NODE_TYPE_LEAF = 0,
+    NODE_TYPE_LEAF_INSERT = 1,
+    NODE_TYPE_LEAF_DELETE = 2,
+    NODE_TYPE_INNER = 3,
+    NODE_TYPE_INNER_INSERT = 4
+  };
+
+  struct BaseNode;
+
+  // Common part of base nodes and delta records
+  struct Node {
+    Node(NodeType type, const Node *next);
+
+    bool IsLeaf() const { return type <= NODE_TYPE_LEAF_DELETE; }
+
+    const NodeType type;
+
+    // Next record of the chain, nullptr for base nodes
+    const Node *const next;
+
+    // Base node at the end of the chain
+    const BaseNode *base;
+
+    // Number of delta records in front of the base node
+    const size_t chain_length;
+  };
+
+  // Base nodes cover [low key, high key) and link to their right sibling
+  struct BaseNode : public Node {
+    BaseNode(NodeType type) : Node(type, nullptr) {}
+
+    // Leaves are at level 0
+    size_t level = 0;
+
+    bool has_high_key = false;
+    KeyType high_key;
+    NodeId right_sibling = INVALID_NODE_ID;
+  };
+
+  struct LeafNode : public BaseNode {
+    LeafNode() : BaseNode(NODE_TYPE_LEAF) {}
+
+    // Sorted by key
+    std::vector<std::pair<KeyType, ValueType>> items;
+  };
+
+  // children[i] covers [children[i].first, children[i + 1].first). The key
+  // of the first child is the low key of the node and never compared.
+  struct InnerNode : public BaseNode {
+    InnerNode() : BaseNode(NODE_TYPE_INNER) {}
+
+    std::vector<std::pair<KeyType, NodeId>> children;
+  };
+
+  // Insert and delete records of a leaf. A delete hides every older pair of
+  // the key with an equal value.
+  struct LeafDelta : public Node {
+    LeafDelta(NodeType type, const Node *next, const KeyType &key,
+              const ValueType &value)
+        : Node(type, next), key(key), value(value) {}
+
+    KeyType key;
+    ValueType value;
+  };
+
+  // Separator posted to the parent after a split, routes
+  // [key, next_key) to the new child
+  struct InnerInsertDelta : public Node {
+    InnerInsertDelta(const Node *next) : Node(NODE_TYPE_INNER_INSERT, next) {}
+
+    KeyType key;
+    NodeId child = INVALID_NODE_ID;
+    bool has_next_key = false;
+    KeyType next_key;
+  };
+
+  // Replaced chain and dead values waiting for the epochs that could see
+  // them to end
+  struct GarbageNode {
+    size_t epoch;
+    const Node *chain;
+    std::vector<ValueType> values;
+    GarbageNode *next;
+  };
+
+  // Leaf contents after applying the deltas
+  struct LeafContents {
+    std::vector<std::pair<KeyType, ValueType>> items;
+
+    // Values removed by deletes and the values of the delete records
+    std::vector<ValueType> dead_values;
+  };
+
+  static const NodeId INVALID_NODE_ID = UINT64_MAX;
+
+  static const size_t MAPPING_CHUNK_SIZE = 1 << 12;
+  static const size_t MAPPING_CHUNK_COUNT = 1 << 12;
+
+  static const size_t LEAF_NODE_MAX_SIZE = 128;
+  static const size_t INNER_NODE_MAX_SIZE = 64;
+  static const size_t DELTA_CHAIN_MAX_LENGTH = 8;
+  static const size_t GARBAGE_COLLECTION_THRESHOLD = 256;
+
+  //===--------------------------------------------------------------------===//
+  // Mapping table
+  //===--------------------------------------------------------------------===//
+
+  std::atomic<const Node *> &GetSlot(NodeId node_id) const;
+
+  const Node *GetNode(NodeId node_id) const {
+    return GetSlot(node_id).load(std::memory_order_acquire);
+  }
+
+  bool InstallNode(NodeId node_id, const Node *expected, const Node *node) {
+    return GetSlot(node_id).compare_exchange_strong(expected, node);
+  }
+
+  NodeId AllocateNodeId();
+
+  //===--------------------------------------------------------------------===//
+  // Traversal
+  //===--------------------------------------------------------------------===//
+
+  int Compare(const KeyType &lhs, const KeyType &rhs) const {
+    return comparator_(lhs, rhs);
+  }
+
+  bool IsBeyondHighKey(const BaseNode *base, const KeyType &key) const {
+    return base->has_high_key && Compare(key, base->high_key) >= 0;
+  }
+
+  // Leaf whose range contains the key, or the leftmost leaf if key is null
+  NodeId FindLeaf(const KeyType *key, const Node *&head, NodeId &parent_id);
+
+  NodeId RouteInner(const Node *head, const KeyType *key) const;
+
+  // Node at the given level whose range contains the key
+  NodeId FindNodeAtLevel(const KeyType &key, size_t level);
+
+  bool IsDeleted(const std::vector<ValueType> &deleted_values,
+                 const ValueType &value) const;
+
+  // Values of the key in the leaf chain
+  void CollectValues(const Node *head, const KeyType &key,
+                     std::vector<ValueType> &values) const;
+
+  LeafContents CollectLeaf(const Node *head) const;
+
+  std::vector<std::pair<KeyType, NodeId>> CollectInner(const Node *head) const;
+
+  //===--------------------------------------------------------------------===//
+  // Structure modifications
+  //===--------------------------------------------------------------------===//
+
+  // Prepends a leaf delta, consolidating the leaf if the chain got long
+  bool InstallLeafDelta(NodeId node_id, NodeId parent_id, const Node *head,
+                        NodeType type, const KeyType &key,
+                        const ValueType &value);
+
+  // Replaces the chain by a new base node, splitting it if it is too large.
+  // A parent id of INVALID_NODE_ID means the parent is not known.
+  void Consolidate(NodeId node_id, NodeId parent_id, const Node *head);
+
+  // Position to split the sorted items at, 0 if they can't be split
+  size_t GetSplitPosition(
+      const std::vector<std::pair<KeyType, ValueType>> &items) const;
+
+  // Installs the consolidated node and, after a split, its right sibling
+  bool InstallConsolidation(NodeId node_id, NodeId parent_id, const Node *head,
+                            BaseNode *left, BaseNode *right);
+
+  // Makes the new right sibling reachable from the parent level
+  void CompleteSplit(NodeId node_id, NodeId parent_id, const KeyType &key,
+                     NodeId right_id, size_t level);
+
+  // Posts the separator of a split to the parent
+  void PostSeparator(NodeId parent_id, const KeyType &key, NodeId child_id);
+
+  //===--------------------------------------------------------------------===//
+  // Memory reclamation
+  //===--------------------------------------------------------------------===//
+
+  void Retire(const Node *chain, std::vector<ValueType> &&values);
+
+  static void FreeNode(const Node *node);
+
+  static void FreeChain(const Node *head);
+
+  //===--------------------------------------------------------------------===//
+  // Members
+  //===--------------------------------------------------------------------===//
+
+  KeyComparator comparator_;
+
+  ValueEqualityChecker value_equals_;
+
+  ValueDeleter value_deleter_;
+
+  std::atomic<std::atomic<const Node *> *> mapping_chunks_[MAPPING_CHUNK_COUNT];
+
+  std::atomic<NodeId> next_node_id_;
+
+  std::atomic<NodeId> root_id_;
+
+  // Retired nodes and values, most recent first
+  std::atomic<GarbageNode *> garbage_head_;
+
+  std::atomic<size_t> garbage_count_;
+
+  // Epoch of the last collection, garbage is collected once per epoch
+  std::atomic<size_t> garbage_collection_epoch_;
+
+  // Set while a thread is collecting garbage
+  std::atomic<bool> collecting_garbage_;
+};
+
+}  // namespace peloton
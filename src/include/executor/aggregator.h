@@ -13,8 +13,10 @@
 
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include "common/value_factory.h"
 #include "executor/abstract_executor.h"
@@ -25,6 +27,13 @@
 // Aggregate
 //===--------------------------------------------------------------------===//
 
+// Number of threads that build the partitions of a hash aggregation
+// (0 or 1 means it runs in the executor thread)
+extern int peloton_aggregate_thread_count;
+
+// Radix bits that pick the partition of a group in a parallel aggregation
+#define AGGREGATE_PARTITION_BITS 6
+
 namespace peloton {
 
 namespace storage {
@@ -235,6 +244,98 @@ class MinAgg : public Agg {
 /** brief Create an instance of an aggregator for the specified aggregate */
 Agg *GetAggInstance(ExpressionType agg_type);
 
+/**
+ * @brief Construct an aggregator for the specified aggregate in place.
+ * The storage has to hold AGG_STATE_SIZE bytes.
+ */
+Agg *GetAggInstance(ExpressionType agg_type, void *storage);
+
+/** @brief Size of the largest aggregator, rounded up to keep alignment */
+extern const size_t AGG_STATE_SIZE;
+
+class LogicalTile;
+
+//===--------------------------------------------------------------------===//
+// Aggregate Hash Table
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Groups of one partition of a hash aggregation.
+ *
+ * Open addressing with linear probing over a flat slot array. A slot holds
+ * the upper bits of the group hash and the group id, so most mismatches
+ * are rejected without touching the key. Keys, delegate tuples and the
+ * aggregate states of the groups are kept by group id in contiguous
+ * arrays, the states in chunks so they never move once constructed.
+ *
+ * Keys are either packed into key_width words, or, with a key width of 0,
+ * compared with the group-by columns of the delegate tuples.
+ */
+class AggregateHashTable {
+ public:
+  AggregateHashTable(const planner::AggregatePlan *node,
+                     size_t num_input_columns, size_t key_width);
+
+  ~AggregateHashTable();
+
+  /** @brief Group of a packed key, INVALID_OID if there is none */
+  oid_t FindGroup(uint64_t hash, const uint64_t *key) const;
+
+  /** @brief Group of a key that is not packed, INVALID_OID if none */
+  oid_t FindGroup(uint64_t hash, const std::vector<Value> &key_values) const;
+
+  /** @brief Start a group, the tuple becomes its delegate tuple */
+  oid_t AddGroup(uint64_t hash, const uint64_t *key,
+                 const AbstractTuple *tuple);
+
+  Agg *GetAggregate(oid_t group_id, oid_t aggno) {
+    auto chunk = state_chunks_[group_id / groups_per_chunk].get();
+    auto offset = (group_id % groups_per_chunk) * agg_count_ + aggno;
+    return reinterpret_cast<Agg *>(chunk + offset * AGG_STATE_SIZE);
+  }
+
+  /** @brief Copy of the delegate tuple of a group */
+  void GetDelegateTupleValues(oid_t group_id,
+                              std::vector<Value> &values) const;
+
+  size_t GetGroupCount() const { return group_count_; }
+
+  static const size_t groups_per_chunk = 1024;
+
+ private:
+  struct Slot {
+    uint32_t hash_tag;
+    oid_t group_id;
+  };
+
+  static uint32_t GetHashTag(uint64_t hash) { return hash >> 32; }
+
+  // Double the slot array, called before it gets half full
+  void Grow();
+
+  const planner::AggregatePlan *node_;
+
+  const size_t num_input_columns_;
+
+  const size_t key_width_;
+
+  const size_t agg_count_;
+
+  std::vector<Slot> slots_;
+
+  size_t slot_mask_ = 0;
+
+  size_t group_count_ = 0;
+
+  std::vector<uint64_t> group_hashes_;
+
+  std::vector<uint64_t> group_keys_;
+
+  std::vector<Value> delegate_values_;
+
+  std::vector<std::unique_ptr<char[]>> state_chunks_;
+};
+
 /*
  * Interface for an aggregator (not an an individual aggregate)
  *
@@ -268,6 +369,10 @@ class AbstractAggregator {
 /**
  * @brief Used when input is NOT sorted.
  * Will maintain an internal hash table.
+ *
+ * Group-by columns of integer types are packed into fixed-width keys, other
+ * keys are hashed and compared as values. Groups are radix partitioned on
+ * the upper hash bits when the input is aggregated in parallel.
  */
 class HashAggregator : public AbstractAggregator {
  public:
@@ -277,44 +382,56 @@ class HashAggregator : public AbstractAggregator {
 
   bool Advance(AbstractTuple *next_tuple) override;
 
+  /**
+   * @brief Aggregate whole logical tiles with a number of threads. The
+   * tuples are scattered into partitions first, then every partition is
+   * aggregated by one thread, so no group is shared between threads.
+   */
+  bool AdvanceParallel(const std::vector<LogicalTile *> &tiles,
+                       size_t thread_count);
+
   bool Finalize() override;
 
+  size_t GetGroupCount() const;
+
   ~HashAggregator();
 
  private:
+  // Decide from the first tuple whether the group-by columns can be packed
+  void InitKeyLayout(const AbstractTuple *tuple);
+
+  // Build the key of the tuple, into key if it is packed and key_values
+  // otherwise, and return its hash
+  uint64_t BuildKey(const AbstractTuple *tuple, uint64_t *key,
+                    std::vector<Value> &key_values) const;
+
+  size_t GetPartition(uint64_t hash) const {
+    return (partition_bits_ == 0) ? 0 : hash >> (64 - partition_bits_);
+  }
+
+  void AdvanceGroup(AggregateHashTable *partition, uint64_t hash,
+                    const uint64_t *key, const std::vector<Value> &key_values,
+                    const AbstractTuple *tuple);
+
   const size_t num_input_columns;
 
-  /** List of aggregates for a specific group. */
-  struct AggregateList {
-    // Keep a deep copy of the first tuple we met of this group
-    std::vector<Value> first_tuple_values;
+  bool key_layout_ready_ = false;
 
-    // The aggregates for each column for this group
-    Agg **aggregates;
-  };
+  /** @brief Words of a packed key, 0 if the keys are not packed */
+  size_t key_width_ = 0;
 
-  /** Hash function of internal hash table */
-  struct ValueVectorHasher
-      : std::unary_function<std::vector<Value>, std::size_t> {
-    // Generate a 64-bit number for the a vector of value
-    size_t operator()(const std::vector<Value> &values) const {
-      size_t seed = 0;
-      for (auto &v : values) {
-        v.HashCombine(seed);
-      }
-      return seed;
-    }
-  };
+  /** @brief Byte offset and size of every group-by column in a packed key */
+  std::vector<std::pair<size_t, size_t>> key_columns_;
 
-  // Default equal_to should works well
-  typedef std::unordered_map<std::vector<Value>, AggregateList *,
-                             ValueVectorHasher> HashAggregateMapType;
+  /** @brief Packed key of the tuple being advanced */
+  std::vector<uint64_t> probe_key_;
 
   /** @brief Group by key values used */
   std::vector<Value> group_by_key_values;
 
-  /** @brief Hash table */
-  HashAggregateMapType aggregates_map;
+  size_t partition_bits_ = 0;
+
+  std::vector<std::unique_ptr<AggregateHashTable>> partitions_;
 };
 
 /**
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// executor_util.h
+//
+// Identification: src/include/executor/executor_util.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <functional>
+
+#include "common/types.h"
+
+namespace peloton {
+namespace executor {
+
+// Spread the bits of a hash, so that its upper bits can pick a partition
+static inline uint64_t MixHash(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+// Run task(0) to task(task_count - 1) on up to thread_count threads of the
+// executor thread pool, the calling thread included. Rethrows the first
+// exception a task threw once all of them are done.
+void RunTasks(size_t thread_count, size_t task_count,
+              const std::function<void(size_t)> &task);
+
+}  // namespace executor
+}  // namespace peloton
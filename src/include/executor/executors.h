@@ -32,4 +32,5 @@
 #include "executor/order_by_executor.h"
 #include "executor/hash_set_op_executor.h"
 #include "executor/append_executor.h"
+#include "executor/gather_executor.h"
 #include "executor/projection_executor.h"
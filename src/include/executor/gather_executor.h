@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gather_executor.h
+//
+// Identification: src/include/executor/gather_executor.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "executor/abstract_executor.h"
+
+namespace peloton {
+
+namespace concurrency {
+class Transaction;
+}
+
+namespace storage {
+class TileGroup;
+}
+
+namespace executor {
+
+class SeqScanExecutor;
+
+/**
+ * Morsel-driven parallel scan. Worker threads of a shared pool claim tile
+ * groups of the child sequential scan a morsel at a time, check visibility
+ * against the scan's transaction and apply the predicate. The executor's own
+ * thread registers the reads with the transaction and builds the logical
+ * tiles, since the transaction's read set is not thread safe.
+ */
+class GatherExecutor : public AbstractExecutor {
+ public:
+  GatherExecutor(const GatherExecutor &) = delete;
+  GatherExecutor &operator=(const GatherExecutor &) = delete;
+  GatherExecutor(GatherExecutor &&) = delete;
+  GatherExecutor &operator=(GatherExecutor &&) = delete;
+
+  explicit GatherExecutor(const planner::AbstractPlan *node,
+                          ExecutorContext *executor_context);
+
+  ~GatherExecutor();
+
+ protected:
+  bool DInit();
+
+  bool DExecute();
+
+ private:
+  // Qualifying tuples of one tile group, produced by a worker
+  struct ScanResult {
+    std::shared_ptr<storage::TileGroup> tile_group;
+    std::vector<oid_t> position_list;
+  };
+
+  void StartWorkers();
+
+  void StopWorkers();
+
+  void ScanMorsels(concurrency::Transaction *txn);
+
+  bool PushResult(ScanResult &&result);
+
+  //===--------------------------------------------------------------------===//
+  // Executor State
+  //===--------------------------------------------------------------------===//
+
+  /** @brief Child scan, or nullptr if the child is passed through. */
+  SeqScanExecutor *scan_executor_ = nullptr;
+
+  size_t parallelism_ = 1;
+
+  size_t morsel_size_ = 1;
+
+  /** @brief Maximum number of results waiting to be consumed. */
+  size_t max_pending_results_ = 1;
+
+  oid_t tile_group_count_ = 0;
+
+  /** @brief Offset of the next tile group to hand out. */
+  std::atomic<oid_t> next_tile_group_offset_;
+
+  /** @brief Results of the workers, guarded by result_mutex_. */
+  std::deque<ScanResult> results_;
+
+  std::mutex result_mutex_;
+
+  /** @brief Signalled when a result is queued or a worker exits. */
+  std::condition_variable result_ready_cv_;
+
+  /** @brief Signalled when a result is consumed or the scan is stopped. */
+  std::condition_variable result_taken_cv_;
+
+  size_t active_workers_ = 0;
+
+  bool is_started_ = false;
+
+  /** @brief Set to make the workers give up, e.g. on early termination. */
+  std::atomic<bool> is_stopped_;
+
+  /** @brief First exception raised by a worker, rethrown by DExecute(). */
+  std::exception_ptr worker_exception_;
+
+  std::vector<std::future<void>> workers_;
+};
+
+}  // namespace executor
+}  // namespace peloton
@@ -19,6 +19,7 @@
 #include "common/types.h"
 #include "executor/abstract_executor.h"
 #include "executor/logical_tile.h"
+#include "executor/radix_hash_table.h"
 #include "expression/container_tuple.h"
 
 #include <boost/functional/hash.hpp>
@@ -50,6 +51,15 @@ class HashExecutor : public AbstractExecutor {
 
   inline HashMapType &GetHashTable() { return this->hash_table_; }
 
+  /**
+   * @brief Hash table of a radix hash join, nullptr when the tuples are
+   * hashed into the hash map. Its tile offsets count the non-empty tiles,
+   * in the order they are returned.
+   */
+  inline const RadixHashTable *GetRadixHashTable() const {
+    return this->radix_hash_table_.get();
+  }
+
   inline const std::vector<oid_t> &GetHashKeyIds() const {
     return this->column_ids_;
   }
@@ -63,6 +73,8 @@ class HashExecutor : public AbstractExecutor {
   /** @brief Hash table */
   HashMapType hash_table_;
 
+  std::unique_ptr<RadixHashTable> radix_hash_table_;
+
   /** @brief Input tiles from child node */
   std::vector<std::unique_ptr<LogicalTile>> child_tiles_;
 
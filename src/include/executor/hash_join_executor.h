@@ -37,6 +37,10 @@ class HashJoinExecutor : public AbstractJoinExecutor {
   bool DExecute();
 
  private:
+  // Join the next batch of left tiles with the radix hash table, returns
+  // false once the left child is done
+  bool BuildRadixJoinOutput(const RadixHashTable *radix_hash_table);
+
   HashExecutor *hash_executor_ = nullptr;
 
   bool hashed_ = false;
@@ -13,23 +13,37 @@
 
 #pragma once
 
+#include <cstdio>
+#include <string>
+
 #include "common/types.h"
 #include "executor/abstract_executor.h"
 #include "storage/tuple.h"
 
+// Bytes an order by buffers before it spills sorted runs (0 means no bound)
+extern int64_t peloton_sort_memory_budget;
+
 namespace peloton {
 
 class VarlenPool;
 
+namespace storage {
+class Tile;
+}
+
 namespace executor {
 
 /**
  * @warning This is a pipeline breaker and a materialization point.
  *
- * TODO Currently, we store all input tiles and sort result in memory
- * until this executor is destroyed, which is sometimes necessary.
- * But can we let it release the RAM earlier as long as the executor
- * is not needed any more (e.g., with a LIMIT sitting on top)?
+ * Every tuple gets a normalized sort key, a byte string that compares with
+ * memcmp in the order of the sort keys. Input tiles are kept until the
+ * tuples are returned, unless the buffered tuples outgrow the sort memory
+ * budget. Then they are sorted and spilled to a run in a temporary file,
+ * and the runs are merged when the input is done.
+ *
+ * With a LIMIT on top only the first limit tuples are kept, in a heap, and
+ * input tiles are released as soon as none of their tuples are in it.
  */
 class OrderByExecutor : public AbstractExecutor {
  public:
@@ -43,6 +57,15 @@ class OrderByExecutor : public AbstractExecutor {
 
   ~OrderByExecutor();
 
+  /** @brief Only the first limit tuples are needed (set by a LIMIT on top) */
+  void SetLimit(size_t limit) {
+    has_limit_ = true;
+    limit_ = limit;
+  }
+
+  /** @brief Number of sorted runs spilled to disk by the last sort */
+  size_t GetSpilledRunCount() const { return sort_runs_.size(); }
+
  protected:
   bool DInit();
 
@@ -51,48 +74,69 @@ class OrderByExecutor : public AbstractExecutor {
  private:
   bool DoSort();
 
-  bool sort_done_ = false;
+  /** @brief Add a tuple of the last input tile to the sort buffer */
+  void BufferTuple(std::string &&key, oid_t tuple_id);
 
-  /**
-   * IMPORTANT This type must be move-constructible and move-assignable
-   * in order to be correctly sorted by STL sort
-   */
-  struct sort_buffer_entry_t {
-    ItemPointer item_pointer;
-    std::unique_ptr<storage::Tuple> tuple;
+  /** @brief Sort the sort buffer, and write it to a new run */
+  void SpillRun();
+
+  /** @brief Read the next tuple of a run, false if the run is done */
+  bool ReadRun(size_t run_itr);
+
+  /** @brief Move the tuple of the run at the top of the merge heap to the
+   *  tile, and read the next tuple of that run */
+  void MergeTuple(storage::Tile *tile, oid_t tuple_id);
 
-    sort_buffer_entry_t(ItemPointer ipt, std::unique_ptr<storage::Tuple> &&tp)
-        : item_pointer(ipt), tuple(std::move(tp)) {}
+  void ClearSortState();
 
-    sort_buffer_entry_t(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-    }
+  bool sort_done_ = false;
 
-    sort_buffer_entry_t &operator=(sort_buffer_entry_t &&rhs) {
-      item_pointer = rhs.item_pointer;
-      tuple = std::move(rhs.tuple);
-      return *this;
-    }
+  /** A tuple to sort and its normalized sort key */
+  struct SortEntry {
+    std::string key;
+    ItemPointer item_pointer;
 
-    sort_buffer_entry_t(const sort_buffer_entry_t &) = delete;
-    sort_buffer_entry_t &operator=(const sort_buffer_entry_t &) = delete;
+    bool operator<(const SortEntry &rhs) const { return key < rhs.key; }
   };
 
-  /** All tiles returned by child. */
+  /** A sorted run in a temporary file, and its next tuple */
+  struct SortRun {
+    FILE *file;
+    std::string key;
+    std::string tuple;
+  };
+
+  /** All tiles returned by child and not yet released. */
   std::vector<std::unique_ptr<LogicalTile>> input_tiles_;
 
+  /** Number of entries of the sort buffer in every input tile */
+  std::vector<size_t> input_tile_entry_counts_;
+
   /** Physical (not logical) schema of input tiles */
   std::unique_ptr<catalog::Schema> input_schema_;
 
-  /** All valid tuples in sorted order */
-  std::vector<sort_buffer_entry_t> sort_buffer_;
+  /** Buffered tuples, in sorted order once the sort is done.
+   *  A max heap while a limit is set and the input is read. */
+  std::vector<SortEntry> sort_buffer_;
 
-  /** Tuples in sort_buffer only contains the sort keys */
-  std::unique_ptr<catalog::Schema> sort_key_tuple_schema_;
+  /** Approximate bytes held by the sort buffer and its tuples */
+  size_t sort_buffer_size_ = 0;
+
+  /** Sorted runs spilled to disk */
+  std::vector<SortRun> sort_runs_;
+
+  /** Min heap of the runs that are not done, on their next key */
+  std::vector<size_t> merge_heap_;
 
   std::vector<bool> descend_flags_;
 
+  bool has_limit_ = false;
+
+  size_t limit_ = 0;
+
+  /** How many tuples will be returned to parent */
+  size_t num_tuples_sorted_ = 0;
+
   /** How many tuples have been returned to parent */
   size_t num_tuples_returned_ = 0;
 };
@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "common/types.h"
 #include "executor/abstract_executor.h"
 
@@ -72,6 +74,15 @@ class PlanExecutor {
   static peloton_status ExecutePlan(const planner::AbstractPlan *plan,
                                     const std::vector<Value> &params);
 
+  /*
+   * @brief Same as above, but every result tile is handed to the consumer
+   *        while the txn is still running. So the consumer can read the
+   *        result straight from the base tiles, without materializing it.
+   */
+  static peloton_status ExecutePlan(
+      const planner::AbstractPlan *plan, const std::vector<Value> &params,
+      const std::function<void(executor::LogicalTile *)> &result_consumer);
+
   /*
    * @brief When a peloton node recvs a query plan, this function is invoked
    * @param plan and params
@@ -0,0 +1,133 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_hash_table.h
+//
+// Identification: src/include/executor/radix_hash_table.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <vector>
+
+#include "common/types.h"
+
+// Threads of a radix hash join (0 means the tuple at a time hash join)
+extern int peloton_hash_join_thread_count;
+
+namespace peloton {
+namespace executor {
+
+class LogicalTile;
+
+// A partition of the build side holds at most this many tuples, so that
+// its entries and slots stay in L2
+#define RADIX_PARTITION_SIZE 8192
+
+#define RADIX_MAX_PARTITION_BITS 12
+
+// Probes run this many tuples ahead of the slot they prefetch
+#define RADIX_PREFETCH_DISTANCE 8
+
+// The probe side is partitioned and joined in batches of about this many
+// tuples, so its entries and matches do not grow with the whole input
+#define RADIX_PROBE_BATCH_SIZE (1 << 20)
+
+/**
+ * @brief Build side of a radix hash join.
+ *
+ * The tuples are radix partitioned on the upper bits of the hash of their
+ * key columns, and every partition gets its own linear probing table. A
+ * slot holds the upper hash bits and the offset of an entry, and the
+ * entries of a partition are contiguous. The probe side is partitioned
+ * the same way, so a partition is joined without touching the others, and
+ * partitions are joined in parallel.
+ */
+class RadixHashTable {
+ public:
+  RadixHashTable(const RadixHashTable &) = delete;
+  RadixHashTable &operator=(const RadixHashTable &) = delete;
+
+  /** @brief A tuple of one side and the hash of its key columns */
+  struct Entry {
+    uint64_t hash;
+    oid_t tile_itr;
+    oid_t tuple_id;
+  };
+
+  /** @brief A probe tuple and a build tuple with the same key */
+  struct Match {
+    oid_t left_tile_itr;
+    oid_t left_tuple_id;
+    oid_t right_tile_itr;
+    oid_t right_tuple_id;
+  };
+
+  RadixHashTable(const std::vector<oid_t> &column_ids, size_t thread_count);
+
+  /** @brief Partition the tuples of the tiles and build the tables */
+  void Build(const std::vector<LogicalTile *> &tiles);
+
+  /**
+   * @brief Find the build tuples of every tuple of the probe tiles. The
+   * probe tuples are keyed by the same column ids.
+   */
+  void Probe(const std::vector<LogicalTile *> &probe_tiles,
+             std::vector<Match> &matches) const;
+
+  size_t GetPartitionCount() const { return 1UL << partition_bits_; }
+
+  size_t GetTupleCount() const { return entries_.size(); }
+
+ private:
+  struct Slot {
+    uint32_t hash_tag;
+    // offset of the entry + 1, 0 if the slot is empty
+    uint32_t entry_offset;
+  };
+
+  static uint32_t GetHashTag(uint64_t hash) { return hash >> 32; }
+
+  size_t GetPartition(uint64_t hash) const {
+    return (partition_bits_ == 0) ? 0 : hash >> (64 - partition_bits_);
+  }
+
+  // Scatter the tuples of the tiles into contiguous partitions
+  void PartitionTuples(const std::vector<LogicalTile *> &tiles,
+                       std::vector<Entry> &entries,
+                       std::vector<size_t> &partition_offsets) const;
+
+  void BuildPartition(size_t partition);
+
+  void ProbePartition(size_t partition,
+                      const std::vector<LogicalTile *> &probe_tiles,
+                      const std::vector<Entry> &probe_entries,
+                      const std::vector<size_t> &probe_offsets,
+                      std::vector<Match> &matches) const;
+
+  const std::vector<oid_t> column_ids_;
+
+  const size_t thread_count_;
+
+  size_t partition_bits_ = 0;
+
+  std::vector<LogicalTile *> tiles_;
+
+  std::vector<Entry> entries_;
+
+  // partition i holds entries [partition_offsets_[i], partition_offsets_[i+1])
+  std::vector<size_t> partition_offsets_;
+
+  std::vector<Slot> slots_;
+
+  // partition i has the slots [slot_offsets_[i], slot_offsets_[i+1])
+  std::vector<size_t> slot_offsets_;
+};
+
+}  // namespace executor
+}  // namespace peloton
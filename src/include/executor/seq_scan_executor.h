@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "planner/seq_scan_plan.h"
 #include "executor/abstract_scan_executor.h"
 
@@ -29,6 +32,29 @@ class SeqScanExecutor : public AbstractScanExecutor {
   explicit SeqScanExecutor(const planner::AbstractPlan *node,
                            ExecutorContext *executor_context);
 
+ //===--------------------------------------------------------------------===//
+  // Morsel Scan
+  //
+  // A table scan is split into one step per tile group so that a gather
+  // executor can hand the tile groups out to several threads. The steps
+  // below are only valid after Init() on a scan without children.
+  //===--------------------------------------------------------------------===//
+
+  /** @brief True if this executor scans a table rather than a child. */
+  bool IsTableScan() const {
+    return target_table_ != nullptr && children_.empty();
+  }
+
+  oid_t GetTileGroupCount() const { return table_tile_group_count_; }
+
+  std::shared_ptr<storage::TileGroup> GetTileGroup(
+      oid_t tile_group_offset) const;
+
+  std::vector<oid_t> ScanTileGroup(storage::TileGroup *tile_group) const;
+
+  LogicalTile *ProduceTile(const std::shared_ptr<storage::TileGroup> &tile_group,
+                           std::vector<oid_t> &&position_list);
+
  protected:
   bool DInit();
 
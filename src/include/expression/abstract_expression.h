@@ -19,6 +19,7 @@
 #include "common/macros.h"
 #include "common/abstract_tuple.h"
 #include "common/printable.h"
+#include "expression/expression_batch.h"
 
 namespace peloton {
 
@@ -51,6 +52,26 @@ class AbstractExpression : public Printable {
                          const AbstractTuple *tuple2,
                          executor::ExecutorContext *context) const = 0;
 
+  //===--------------------------------------------------------------------===//
+  // Batch Evaluation
+  //===--------------------------------------------------------------------===//
+
+  // Shrink "selection" to the tuples of "source" for which this predicate
+  // is true. The default evaluates tuple at a time.
+  virtual void EvaluateBatch(const BatchSource &source,
+                             SelectionVector &selection,
+                             executor::ExecutorContext *context) const;
+
+  // Compute this expression for every selected tuple, returns false if it
+  // has no typed kernel and the caller has to fall back to Evaluate().
+  virtual bool EvaluateNumericBatch(
+      UNUSED_ATTRIBUTE const BatchSource &source,
+      UNUSED_ATTRIBUTE const SelectionVector &selection,
+      UNUSED_ATTRIBUTE executor::ExecutorContext *context,
+      UNUSED_ATTRIBUTE NumericBatch &batch) const {
+    return false;
+  }
+
   /** return true if self or descendent should be substitute()'d */
   virtual bool HasParameter() const;
 
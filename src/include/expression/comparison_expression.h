@@ -40,6 +40,9 @@ namespace expression {
 //
 // "includes_equality" returns true if the comparison is true for (rows of)
 // equal values.
+//
+// "compare_numeric" is the typed kernel used by batch evaluation on non-null
+// int64_t or double operands, "has_numeric_kernel" tells whether it exists.
 //===----------------------------------------------------------------------===//
 
 class CmpEq {
@@ -58,6 +61,11 @@ class CmpEq {
   }
   inline static bool implies_null_for_row() { return false; }
   inline static bool includes_equality() { return true; }
+  static const bool has_numeric_kernel = true;
+  template <typename T>
+  inline static bool compare_numeric(const T l, const T r) {
+    return l == r;
+  }
 };
 
 class CmpNe {
@@ -76,6 +84,11 @@ class CmpNe {
   }
   inline static bool implies_null_for_row() { return false; }
   inline static bool includes_equality() { return false; }
+  static const bool has_numeric_kernel = true;
+  template <typename T>
+  inline static bool compare_numeric(const T l, const T r) {
+    return l != r;
+  }
 };
 
 class CmpLt {
@@ -93,6 +106,11 @@ class CmpLt {
   }
   inline static bool implies_null_for_row() { return true; }
   inline static bool includes_equality() { return false; }
+  static const bool has_numeric_kernel = true;
+  template <typename T>
+  inline static bool compare_numeric(const T l, const T r) {
+    return l < r;
+  }
 };
 
 class CmpGt {
@@ -110,6 +128,11 @@ class CmpGt {
   }
   inline static bool implies_null_for_row() { return true; }
   inline static bool includes_equality() { return false; }
+  static const bool has_numeric_kernel = true;
+  template <typename T>
+  inline static bool compare_numeric(const T l, const T r) {
+    return l > r;
+  }
 };
 
 class CmpLte {
@@ -127,6 +150,11 @@ class CmpLte {
   }
   inline static bool implies_null_for_row() { return true; }
   inline static bool includes_equality() { return true; }
+  static const bool has_numeric_kernel = true;
+  template <typename T>
+  inline static bool compare_numeric(const T l, const T r) {
+    return l <= r;
+  }
 };
 
 class CmpGte {
@@ -144,6 +172,11 @@ class CmpGte {
   }
   inline static bool implies_null_for_row() { return true; }
   inline static bool includes_equality() { return true; }
+  static const bool has_numeric_kernel = true;
+  template <typename T>
+  inline static bool compare_numeric(const T l, const T r) {
+    return l >= r;
+  }
 };
 
 // CmpLike and CmpIn are slightly special in that they can never be
@@ -155,6 +188,12 @@ class CmpLike {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.Like(r);
   }
+  static const bool has_numeric_kernel = false;
+  template <typename T>
+  inline static bool compare_numeric(UNUSED_ATTRIBUTE const T l,
+                                     UNUSED_ATTRIBUTE const T r) {
+    return false;
+  }
 };
 
 class CmpNotLike {
@@ -163,6 +202,12 @@ class CmpNotLike {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.NotLike(r);
   }
+  static const bool has_numeric_kernel = false;
+  template <typename T>
+  inline static bool compare_numeric(UNUSED_ATTRIBUTE const T l,
+                                     UNUSED_ATTRIBUTE const T r) {
+    return false;
+  }
 };
 
 class CmpIn {
@@ -171,6 +216,12 @@ class CmpIn {
   inline static Value compare_withoutNull(const Value &l, const Value &r) {
     return l.InList(r) ? Value::GetTrue() : Value::GetFalse();
   }
+  static const bool has_numeric_kernel = false;
+  template <typename T>
+  inline static bool compare_numeric(UNUSED_ATTRIBUTE const T l,
+                                     UNUSED_ATTRIBUTE const T r) {
+    return false;
+  }
 };
 
 template <typename OP>
@@ -213,6 +264,37 @@ class ComparisonExpression : public AbstractExpression {
     return OP::compare_withoutNull(lnv, rnv);
   }
 
+  void EvaluateBatch(const BatchSource &source, SelectionVector &selection,
+                     executor::ExecutorContext *context) const override {
+    NumericBatch lhs, rhs;
+    if (OP::has_numeric_kernel == false ||
+        m_left->EvaluateNumericBatch(source, selection, context, lhs) ==
+            false ||
+        m_right->EvaluateNumericBatch(source, selection, context, rhs) ==
+            false) {
+      AbstractExpression::EvaluateBatch(source, selection, context);
+      return;
+    }
+
+    // comparisons with NULL are never true
+    if (lhs.is_integer && rhs.is_integer) {
+      FilterSelection(selection, lhs.int_values.data(), rhs.int_values.data(),
+                      [](const int64_t l, const int64_t r) {
+                        return !IsNullNumeric(l) & !IsNullNumeric(r) &
+                               OP::compare_numeric(l, r);
+                      });
+    } else {
+      lhs.PromoteToDouble();
+      rhs.PromoteToDouble();
+      FilterSelection(selection, lhs.double_values.data(),
+                      rhs.double_values.data(),
+                      [](const double l, const double r) {
+                        return !IsNullNumeric(l) & !IsNullNumeric(r) &
+                               OP::compare_numeric(l, r);
+                      });
+    }
+  }
+
   inline const char *traceEval(const AbstractTuple *tuple1,
                                const AbstractTuple *tuple2,
                                executor::ExecutorContext *context) const {
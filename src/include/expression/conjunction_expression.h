@@ -17,6 +17,8 @@
 
 #include "expression/abstract_expression.h"
 
+#include <algorithm>
+#include <iterator>
 #include <string>
 
 namespace peloton {
@@ -35,6 +37,9 @@ class ConjunctionExpression : public AbstractExpression {
   Value Evaluate(const AbstractTuple *tuple1, const AbstractTuple *tuple2,
                  executor::ExecutorContext *context) const override;
 
+  void EvaluateBatch(const BatchSource &source, SelectionVector &selection,
+                     executor::ExecutorContext *context) const override;
+
   std::string DebugInfo(const std::string &spacer) const override {
     return (spacer + "ConjunctionExpression\n");
   }
@@ -93,5 +98,35 @@ inline Value ConjunctionExpression<ConjunctionOr>::Evaluate(
   return Value::GetNullValue(VALUE_TYPE_BOOLEAN);
 }
 
+// Only the tuples that pass the left side are checked on the right side
+template <>
+inline void ConjunctionExpression<ConjunctionAnd>::EvaluateBatch(
+    const BatchSource &source, SelectionVector &selection,
+    executor::ExecutorContext *context) const {
+  m_left->EvaluateBatch(source, selection, context);
+  if (selection.empty()) return;
+  m_right->EvaluateBatch(source, selection, context);
+}
+
+// Only the tuples that fail the left side are checked on the right side
+template <>
+inline void ConjunctionExpression<ConjunctionOr>::EvaluateBatch(
+    const BatchSource &source, SelectionVector &selection,
+    executor::ExecutorContext *context) const {
+  SelectionVector left_selection(selection);
+  m_left->EvaluateBatch(source, left_selection, context);
+
+  SelectionVector right_selection;
+  right_selection.reserve(selection.size() - left_selection.size());
+  std::set_difference(selection.begin(), selection.end(),
+                      left_selection.begin(), left_selection.end(),
+                      std::back_inserter(right_selection));
+  if (right_selection.empty() == false) {
+    m_right->EvaluateBatch(source, right_selection, context);
+  }
+
+  MergeSelections(left_selection, right_selection, selection);
+}
+
 }  // namespace expression
 }  // namespace peloton
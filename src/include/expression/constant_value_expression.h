@@ -44,6 +44,13 @@ class ConstantValueExpression : public AbstractExpression {
     return this->value;
   }
 
+  bool EvaluateNumericBatch(UNUSED_ATTRIBUTE const BatchSource &source,
+                            const SelectionVector &selection,
+                            UNUSED_ATTRIBUTE executor::ExecutorContext *context,
+                            NumericBatch &batch) const override {
+    return batch.Broadcast(value, selection.size());
+  }
+
   std::string DebugInfo(const std::string &spacer) const override {
     return spacer + "OptimizedConstantValueExpression:" + value.GetInfo() +
            "\n";
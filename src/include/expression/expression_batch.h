@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// expression_batch.h
+//
+// Identification: src/include/expression/expression_batch.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <vector>
+
+#include "common/types.h"
+#include "common/value.h"
+
+namespace peloton {
+
+namespace executor {
+class ExecutorContext;
+class LogicalTile;
+}
+
+namespace storage {
+class TileGroup;
+}
+
+namespace expression {
+
+class AbstractExpression;
+
+//===----------------------------------------------------------------------===//
+// Batch evaluation
+//
+// Predicates can be evaluated over all the candidate tuples of a tile group
+// or a logical tile at once. The candidates are kept in a selection vector
+// (ascending tuple offsets, like a LogicalTile::PositionList) that every
+// predicate shrinks in place. Fixed-width numeric columns are read straight
+// from the tiles into typed vectors, so that the kernels are tight loops
+// the compiler can vectorize. All other expressions fall back to Evaluate().
+//===----------------------------------------------------------------------===//
+
+// Offsets of the tuples that still qualify, in ascending order
+typedef std::vector<oid_t> SelectionVector;
+
+/*
+ * NumericBatch - Values of a numeric expression, one per selected tuple.
+ *    Integral types are widened to int64_t and floating point ones to double.
+ *    NULLs are kept in the storage encoding, i.e. INT64_NULL / DOUBLE_NULL.
+ */
+struct NumericBatch {
+  bool is_integer = true;
+
+  std::vector<int64_t> int_values;
+
+  std::vector<double> double_values;
+
+  // Fill the batch with "count" copies of a value, false if not numeric
+  bool Broadcast(const Value &value, size_t count);
+
+  // Switch an integer batch over to doubles
+  void PromoteToDouble();
+
+  inline size_t GetSize() const {
+    return is_integer ? int_values.size() : double_values.size();
+  }
+};
+
+/*
+ * BatchSource - The tile group or logical tile a batch reads its tuples from.
+ */
+class BatchSource {
+ public:
+  explicit BatchSource(storage::TileGroup *tile_group)
+      : tile_group_(tile_group), logical_tile_(nullptr) {}
+
+  explicit BatchSource(executor::LogicalTile *logical_tile)
+      : tile_group_(nullptr), logical_tile_(logical_tile) {}
+
+  // Read a fixed-width numeric column for the selected tuples,
+  // false if the column cannot be read that way
+  bool GatherColumn(oid_t column_id, const SelectionVector &selection,
+                    NumericBatch &batch) const;
+
+  // Scalar fallback on a single tuple
+  Value Evaluate(const AbstractExpression *expr, oid_t tuple_id,
+                 executor::ExecutorContext *context) const;
+
+ private:
+  storage::TileGroup *tile_group_;
+
+  executor::LogicalTile *logical_tile_;
+};
+
+//===----------------------------------------------------------------------===//
+// Kernels
+//===----------------------------------------------------------------------===//
+
+inline bool IsNullNumeric(const int64_t value) { return value == INT64_NULL; }
+
+inline bool IsNullNumeric(const double value) { return value <= DOUBLE_NULL; }
+
+/*
+ * Keep the selected tuples for which "pred(lhs[i], rhs[i])" holds.
+ * The selection is compacted without branching on the outcome.
+ */
+template <typename T, typename Predicate>
+inline void FilterSelection(SelectionVector &selection, const T *lhs,
+                            const T *rhs, Predicate pred) {
+  size_t count = selection.size();
+  size_t selected = 0;
+  oid_t *positions = selection.data();
+
+  for (size_t itr = 0; itr < count; itr++) {
+    positions[selected] = positions[itr];
+    selected += pred(lhs[itr], rhs[itr]);
+  }
+
+  selection.resize(selected);
+}
+
+inline void SetNullNumeric(int64_t &value) { value = INT64_NULL; }
+
+inline void SetNullNumeric(double &value) { value = DOUBLE_NULL; }
+
+/*
+ * Compute "op(lhs[i], rhs[i])" into lhs[i], NULL if either side is NULL.
+ * Returns false if "op" failed on any pair.
+ */
+template <typename T, typename Operator>
+inline bool ApplyNumeric(std::vector<T> &lhs, const std::vector<T> &rhs,
+                         Operator op) {
+  size_t count = lhs.size();
+  bool status = true;
+
+  for (size_t itr = 0; itr < count; itr++) {
+    const T l = lhs[itr];
+    const T r = rhs[itr];
+    if (IsNullNumeric(l) || IsNullNumeric(r)) {
+      SetNullNumeric(lhs[itr]);
+    } else {
+      status &= op(l, r, lhs[itr]);
+    }
+  }
+
+  return status;
+}
+
+// Union of two disjoint, ascending selection vectors
+void MergeSelections(const SelectionVector &lhs, const SelectionVector &rhs,
+                     SelectionVector &result);
+
+}  // End expression namespace
+}  // End peloton namespace
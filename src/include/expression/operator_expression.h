@@ -17,6 +17,7 @@
 
 #include "expression/abstract_expression.h"
 
+#include <cmath>
 #include <string>
 
 namespace peloton {
@@ -74,6 +75,30 @@ class OperatorIsNullExpression : public AbstractExpression {
     }
   }
 
+  void EvaluateBatch(const BatchSource &source, SelectionVector &selection,
+                     executor::ExecutorContext *context) const override {
+    NumericBatch operand;
+    if (GetLeft()->EvaluateNumericBatch(source, selection, context, operand) ==
+        false) {
+      AbstractExpression::EvaluateBatch(source, selection, context);
+      return;
+    }
+
+    if (operand.is_integer) {
+      FilterSelection(selection, operand.int_values.data(),
+                      operand.int_values.data(),
+                      [](const int64_t value, const int64_t) {
+                        return IsNullNumeric(value);
+                      });
+    } else {
+      FilterSelection(selection, operand.double_values.data(),
+                      operand.double_values.data(),
+                      [](const double value, const double) {
+                        return IsNullNumeric(value);
+                      });
+    }
+  }
+
   std::string DebugInfo(const std::string &spacer) const override {
     return (spacer + "OperatorIsNullExpression");
   }
@@ -128,11 +153,30 @@ class OperatorUnaryMinusExpression : public AbstractExpression {
 
 /*
  * Binary operators.
+ *
+ * "op_numeric" is the typed kernel used by batch evaluation on non-null
+ * int64_t or double operands. It returns false when the result cannot be
+ * represented (overflow, division by zero, NaN), in which case the batch
+ * falls back to "op" so that the error is raised the usual way.
  */
 
 class OpPlus {
  public:
   inline Value op(Value left, Value right) const { return left.OpAdd(right); }
+
+  static const bool has_numeric_kernel = true;
+  inline static bool op_numeric(const int64_t l, const int64_t r,
+                                int64_t &result) {
+    result = static_cast<int64_t>(static_cast<uint64_t>(l) +
+                                  static_cast<uint64_t>(r));
+    // overflow iff both operands have the sign the result lacks
+    return ((l ^ result) & (r ^ result)) >= 0;
+  }
+  inline static bool op_numeric(const double l, const double r,
+                                double &result) {
+    result = l + r;
+    return std::isfinite(result);
+  }
 };
 
 class OpMinus {
@@ -140,6 +184,20 @@ class OpMinus {
   inline Value op(Value left, Value right) const {
     return left.OpSubtract(right);
   }
+
+  static const bool has_numeric_kernel = true;
+  inline static bool op_numeric(const int64_t l, const int64_t r,
+                                int64_t &result) {
+    result = static_cast<int64_t>(static_cast<uint64_t>(l) -
+                                  static_cast<uint64_t>(r));
+    // overflow iff the operands differ in sign and the result took r's sign
+    return ((l ^ r) & (l ^ result)) >= 0;
+  }
+  inline static bool op_numeric(const double l, const double r,
+                                double &result) {
+    result = l - r;
+    return std::isfinite(result);
+  }
 };
 
 class OpMultiply {
@@ -147,6 +205,21 @@ class OpMultiply {
   inline Value op(Value left, Value right) const {
     return left.OpMultiply(right);
   }
+
+  static const bool has_numeric_kernel = true;
+  inline static bool op_numeric(const int64_t l, const int64_t r,
+                                int64_t &result) {
+    result = static_cast<int64_t>(static_cast<uint64_t>(l) *
+                                  static_cast<uint64_t>(r));
+    if (l == 0) return true;
+    if (l == -1) return r != INT64_MIN;
+    return result / l == r;
+  }
+  inline static bool op_numeric(const double l, const double r,
+                                double &result) {
+    result = l * r;
+    return std::isfinite(result);
+  }
 };
 
 class OpDivide {
@@ -154,11 +227,32 @@ class OpDivide {
   inline Value op(Value left, Value right) const {
     return left.OpDivide(right);
   }
+
+  static const bool has_numeric_kernel = true;
+  inline static bool op_numeric(const int64_t l, const int64_t r,
+                                int64_t &result) {
+    if (r == 0 || (l == INT64_MIN && r == -1)) return false;
+    result = l / r;
+    return true;
+  }
+  inline static bool op_numeric(const double l, const double r,
+                                double &result) {
+    result = l / r;
+    return std::isfinite(result);
+  }
 };
 
 class OpMod {
  public:
   inline Value op(Value left, Value right) const { return left.OpMod(right); }
+
+  static const bool has_numeric_kernel = false;
+  template <typename T>
+  inline static bool op_numeric(UNUSED_ATTRIBUTE const T l,
+                                UNUSED_ATTRIBUTE const T r,
+                                UNUSED_ATTRIBUTE T &result) {
+    return false;
+  }
 };
 
 /*
@@ -180,6 +274,35 @@ class OperatorExpression : public AbstractExpression {
                    m_right->Evaluate(tuple1, tuple2, context));
   }
 
+  bool EvaluateNumericBatch(const BatchSource &source,
+                            const SelectionVector &selection,
+                            executor::ExecutorContext *context,
+                            NumericBatch &batch) const override {
+    NumericBatch rhs;
+    if (OPER::has_numeric_kernel == false ||
+        m_left->EvaluateNumericBatch(source, selection, context, batch) ==
+            false ||
+        m_right->EvaluateNumericBatch(source, selection, context, rhs) ==
+            false) {
+      return false;
+    }
+
+    if (batch.is_integer && rhs.is_integer) {
+      return ApplyNumeric(batch.int_values, rhs.int_values,
+                          [](const int64_t l, const int64_t r,
+                             int64_t &result) {
+                            return OPER::op_numeric(l, r, result);
+                          });
+    }
+
+    batch.PromoteToDouble();
+    rhs.PromoteToDouble();
+    return ApplyNumeric(batch.double_values, rhs.double_values,
+                        [](const double l, const double r, double &result) {
+                          return OPER::op_numeric(l, r, result);
+                        });
+  }
+
   std::string DebugInfo(const std::string &spacer) const override {
     return (spacer + "OptimizedOperatorExpression");
   }
@@ -37,6 +37,11 @@ class ParameterValueExpression : public AbstractExpression {
   Value Evaluate(const AbstractTuple *tuple1, const AbstractTuple *tuple2,
                  executor::ExecutorContext *context) const override;
 
+  bool EvaluateNumericBatch(const BatchSource &source,
+                            const SelectionVector &selection,
+                            executor::ExecutorContext *context,
+                            NumericBatch &batch) const override;
+
   bool HasParameter() const {
     // this class represents a parameter.
     return true;
@@ -58,6 +58,15 @@ class TupleValueExpression : public AbstractExpression {
     }
   }
 
+  bool EvaluateNumericBatch(const BatchSource &source,
+                            const SelectionVector &selection,
+                            UNUSED_ATTRIBUTE executor::ExecutorContext *context,
+                            NumericBatch &batch) const override {
+    // batches only ever scan a single input
+    if (tuple_idx_ != 0) return false;
+    return source.GatherColumn(value_idx_, selection, batch);
+  }
+
   std::string DebugInfo(const std::string &spacer) const override {
     std::ostringstream buffer;
     buffer << spacer << "Optimized Column Reference[" << tuple_idx_ << ", "
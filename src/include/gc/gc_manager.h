@@ -13,6 +13,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <thread>
 #include <unordered_map>
 #include <map>
@@ -24,6 +26,11 @@
 #include "libcuckoo/cuckoohash_map.hh"
 
 namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
 namespace gc {
 
 //===--------------------------------------------------------------------===//
@@ -34,6 +41,13 @@ namespace gc {
 #define MAX_QUEUE_LENGTH 100000
 
 #define GC_PERIOD_MILLISECONDS 100
+
+// Max number of free slots a thread takes from the recycle queue at once
+#define FREE_SLOT_BATCH_SIZE 32
+
+// Garbage a worker thread collected while running a query. It is handed
+// to the GC manager in one batch, under one timestamp, when the buffer
+// goes out of scope.
 class GCBuffer {
  public:
   GCBuffer(oid_t tid) : table_id(tid), garbage_tuples() {}
@@ -47,6 +61,9 @@ class GCBuffer {
   std::vector<ItemPointer> garbage_tuples;
 };
 
+// Garbage is reclaimed by gc_thread_count GC threads. Each table is
+// assigned to one of them, table_id % gc_thread_count, so the garbage of
+// a table always goes through the same reclaim queue and GC thread.
 class GCManager {
  public:
   GCManager(const GCManager &) = delete;
@@ -54,8 +71,16 @@ class GCManager {
   GCManager(GCManager &&) = delete;
   GCManager &operator=(GCManager &&) = delete;
 
-  GCManager(const GCType type)
-      : is_running_(true), gc_type_(type), reclaim_queue_(MAX_QUEUE_LENGTH) {
+  GCManager(const GCType type, const int thread_count = 1)
+      : is_running_(true),
+        gc_type_(type),
+        gc_thread_count_(std::max(thread_count, 1)),
+        oldest_unreclaimed_cids_(new std::atomic<cid_t>[gc_thread_count_]) {
+    for (int thread_itr = 0; thread_itr < gc_thread_count_; thread_itr++) {
+      reclaim_queues_.emplace_back(
+          new Queue<TupleMetadata>(MAX_QUEUE_LENGTH));
+      oldest_unreclaimed_cids_[thread_itr] = MAX_CID;
+    }
     StartGC();
   }
 
@@ -71,10 +96,47 @@ class GCManager {
   void RecycleTupleSlot(const oid_t &table_id, const oid_t &tile_group_id,
                         const oid_t &tuple_id, const cid_t &tuple_end_cid);
 
+  // Add a batch of garbage tuples that all died before tuple_end_cid
+  void RecycleTupleSlots(const oid_t &table_id,
+                         const std::vector<ItemPointer> &tuple_slots,
+                         const cid_t &tuple_end_cid);
+
   ItemPointer ReturnFreeSlot(const oid_t &table_id);
 
+  // Move up to max_count free slots of the table into free_slots, returns
+  // the number of slots moved
+  size_t ReturnFreeSlots(const oid_t &table_id,
+                         std::vector<ItemPointer> &free_slots,
+                         const size_t &max_count);
+
+  // Put back free slots a thread took but did not use
+  void PutBackFreeSlots(const oid_t &table_id,
+                        const std::vector<ItemPointer> &free_slots);
+
+  GCType GetGCType() const { return gc_type_; }
+
+  int GetThreadCount() const { return gc_thread_count_; }
+
+  // Number of slots that became free
+  size_t GetRecycledCount() const { return recycled_count_.load(); }
+
+  // Number of free slots handed back to the tables
+  size_t GetReusedCount() const { return reused_count_.load(); }
+
+  //===--------------------------------------------------------------------===//
+  // Lag metrics
+  //===--------------------------------------------------------------------===//
+
+  // Number of garbage tuples that are not reclaimed yet
+  size_t GetReclaimQueueDepth() const { return unreclaimed_count_.load(); }
+
+  // Smallest end cid of the garbage the GC threads are waiting on, MAX_CID
+  // if they wait on nothing. Garbage still in the reclaim queues is not
+  // included until a GC thread picks it up.
+  cid_t GetOldestUnreclaimedCid() const;
+
  private:
-  void Running();
+  void Running(const int &thread_id);
 
   bool ResetTuple(const TupleMetadata &);
 
@@ -86,20 +148,39 @@ class GCManager {
 
   void AddToRecycleMap(TupleMetadata tuple_metadata);
 
+  // Remove the entries of a reclaimed version from the secondary indexes
+  void DeleteFromIndexes(const std::shared_ptr<storage::TileGroup> &tile_group,
+                         const oid_t &tuple_slot_id);
+
+  Queue<TupleMetadata> &GetReclaimQueue(const oid_t &table_id) {
+    return *reclaim_queues_[table_id % gc_thread_count_];
+  }
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
   volatile bool is_running_;
   GCType gc_type_;
 
-  std::unique_ptr<std::thread> gc_thread_;
+  int gc_thread_count_;
 
-  // TODO: use shared pointer to reduce memory copy
-  Queue<TupleMetadata> reclaim_queue_;
+  std::vector<std::unique_ptr<std::thread>> gc_threads_;
+
+  // one reclaim queue per GC thread
+  std::vector<std::unique_ptr<Queue<TupleMetadata>>> reclaim_queues_;
+
+  // oldest end cid in the local queue of each GC thread
+  std::unique_ptr<std::atomic<cid_t>[]> oldest_unreclaimed_cids_;
 
   // TODO: use shared pointer to reduce memory copy
   cuckoohash_map<oid_t, std::shared_ptr<Queue<TupleMetadata>>>
       recycle_queue_map_;
+
+  std::atomic<size_t> unreclaimed_count_ = ATOMIC_VAR_INIT(0);
+
+  std::atomic<size_t> recycled_count_ = ATOMIC_VAR_INIT(0);
+
+  std::atomic<size_t> reused_count_ = ATOMIC_VAR_INIT(0);
 };
 
 }  // namespace gc
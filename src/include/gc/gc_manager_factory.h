@@ -21,18 +21,29 @@ namespace gc {
 
 class GCManagerFactory {
  public:
+  // The GC manager takes the type configured before its first use
   static GCManager &GetInstance() {
-    static GCManager gc_manager(GC_TYPE_OFF);
+    static GCManager gc_manager(gc_type_, gc_thread_count_);
     return gc_manager;
   }
 
-  static void Configure(GCType gc_type) { gc_type_ = gc_type; }
+  // Only takes effect before the first use of the GC manager
+  static void Configure(GCType gc_type, int gc_thread_count = 1) {
+    gc_type_ = gc_type;
+    gc_thread_count_ = gc_thread_count;
+  }
+
+  // The type the GC manager runs with, not a later configured one
+  static GCType GetGCType() { return GetInstance().GetGCType(); }
 
-  static GCType GetGCType() { return gc_type_; }
+  static int GetGCThreadCount() { return GetInstance().GetThreadCount(); }
 
  private:
   // GC type
   static GCType gc_type_;
+
+  // number of GC threads
+  static int gc_thread_count_;
 };
 
 }  // namespace gc
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bwtree_index.h
+//
+// Identification: src/include/index/bwtree_index.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string>
+
+#include "catalog/manager.h"
+#include "common/types.h"
+#include "index/index.h"
+
+#include "container/bw_tree_map.h"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Latch-free Bw-Tree based index. Readers and writers never block each
+ * other, the tree is only changed through compare-and-swap.
+ *
+ * @see Index
+ * @see BwTreeMap
+ */
+template <typename KeyType, typename ValueType, class KeyComparator,
+          class KeyEqualityChecker>
+class BWTreeIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef BwTreeMap<KeyType, ValueType, KeyComparator,
+                    ItemPointerPtrEqualityChecker,
+                    std::default_delete<ItemPointer>> MapType;
+
+ public:
+  BWTreeIndex(IndexMetadata *metadata);
+
+  ~BWTreeIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
+                       std::function<bool(const ItemPointer &)> predicate);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer> &);
+
+  void ScanAllKeys(std::vector<ItemPointer> &);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer> &);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &exprs,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer *> &result);
+
+  void ScanAllKeys(std::vector<ItemPointer *> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer *> &result);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() {
+    container.PerformGarbageCollection();
+    return true;
+  }
+
+  size_t GetMemoryFootprint() { return 0; }
+
+  void ConstructIntervals(oid_t leading_column_id,
+                          const std::vector<Value> &values,
+                          const std::vector<oid_t> &key_column_ids,
+                          const std::vector<ExpressionType> &expr_types,
+                          std::vector<std::pair<Value, Value>> &intervals);
+
+  void FindMaxMinInColumns(
+      oid_t leading_column_id, const std::vector<Value> &values,
+      const std::vector<oid_t> &key_column_ids,
+      const std::vector<ExpressionType> &expr_types,
+      std::map<oid_t, std::pair<Value, Value>> &non_leading_columns);
+
+  // Get the indexed tile group offset
+  virtual int GetIndexedTileGroupOff() {
+    return indexed_tile_group_offset_.load();
+  }
+
+  virtual void IncreamentIndexedTileGroupOff() {
+    indexed_tile_group_offset_++;
+    return;
+  }
+
+ protected:
+  // Calls "emit" on the matching item pointers while the container still
+  // protects them from concurrent deletes
+  void ScanLocations(const std::vector<Value> &values,
+                     const std::vector<oid_t> &key_column_ids,
+                     const std::vector<ExpressionType> &expr_types,
+                     const ScanDirectionType &scan_direction,
+                     std::function<void(ItemPointer *)> emit);
+
+  MapType container;
+
+  // equality checker and comparator
+  KeyEqualityChecker equals;
+  KeyComparator comparator;
+
+  std::atomic<int> indexed_tile_group_offset_;
+};
+
+}  // End index namespace
+}  // End peloton namespace
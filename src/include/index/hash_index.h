@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.h
+//
+// Identification: src/include/index/hash_index.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include "catalog/manager.h"
+#include "common/types.h"
+#include "index/index.h"
+
+#include "libcuckoo/cuckoohash_map.hh"
+
+namespace peloton {
+namespace index {
+
+/**
+ * Hash index on the libcuckoo concurrent hash table.
+ *
+ * Every key maps to the list of its locations. Lookups that bind every key
+ * column with an equality predicate go straight to the key's bucket, any
+ * other predicate falls back to a scan of the whole table.
+ *
+ * @see Index
+ */
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+class HashIndex : public Index {
+  friend class IndexFactory;
+
+  // Define the container type
+  typedef cuckoohash_map<KeyType, std::vector<ValueType>, KeyHasher,
+                         KeyEqualityChecker> MapType;
+
+ public:
+  HashIndex(IndexMetadata *metadata);
+
+  ~HashIndex();
+
+  bool InsertEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool DeleteEntry(const storage::Tuple *key, const ItemPointer &location);
+
+  bool CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
+                       std::function<bool(const ItemPointer &)> predicate);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &expr_types,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer> &);
+
+  void ScanAllKeys(std::vector<ItemPointer> &);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer> &);
+
+  void Scan(const std::vector<Value> &values,
+            const std::vector<oid_t> &key_column_ids,
+            const std::vector<ExpressionType> &exprs,
+            const ScanDirectionType &scan_direction,
+            std::vector<ItemPointer *> &result);
+
+  void ScanAllKeys(std::vector<ItemPointer *> &result);
+
+  void ScanKey(const storage::Tuple *key, std::vector<ItemPointer *> &result);
+
+  std::string GetTypeName() const;
+
+  bool Cleanup() { return true; }
+
+  size_t GetMemoryFootprint() { return 0; }
+
+  // Get the indexed tile group offset
+  virtual int GetIndexedTileGroupOff() {
+    return indexed_tile_group_offset_.load();
+  }
+
+  virtual void IncreamentIndexedTileGroupOff() {
+    indexed_tile_group_offset_++;
+    return;
+  }
+
+ protected:
+  // Builds the key if the predicates fix every key column to one value
+  bool ConstructEqualityKey(const std::vector<Value> &values,
+                            const std::vector<oid_t> &key_column_ids,
+                            const std::vector<ExpressionType> &expr_types,
+                            storage::Tuple &key);
+
+  // Calls "emit" on the matching item pointers while the bucket locks still
+  // protect them from concurrent deletes
+  void ScanLocations(const std::vector<Value> &values,
+                     const std::vector<oid_t> &key_column_ids,
+                     const std::vector<ExpressionType> &expr_types,
+                     const ScanDirectionType &scan_direction,
+                     std::function<void(ItemPointer *)> emit);
+
+  MapType container;
+
+  // equality checker and comparator
+  KeyEqualityChecker equals;
+  KeyComparator comparator;
+
+  std::atomic<int> indexed_tile_group_offset_;
+};
+
+}  // End index namespace
+}  // End peloton namespace
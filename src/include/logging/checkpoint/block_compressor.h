@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// block_compressor.h
+//
+// Identification: src/include/logging/checkpoint/block_compressor.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <cstddef>
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Block Compressor
+//===--------------------------------------------------------------------===//
+
+// Compresses checkpoint blocks in the LZ4 block format, a greedy single pass
+// matcher that favors speed over ratio
+class BlockCompressor {
+ public:
+  // Upper bound of the compressed size of a block
+  static size_t GetMaxCompressedSize(size_t size) {
+    return size + size / 255 + 16;
+  }
+
+  // Upper bound of the size a compressed block restores to, a byte of the
+  // format expands to at most 255 bytes
+  static size_t GetMaxDecompressedSize(size_t compressed_size) {
+    return compressed_size * 255;
+  }
+
+  // Returns the compressed size, or 0 when dst holds less than
+  // GetMaxCompressedSize(src_size) bytes
+  static size_t Compress(const char *src, size_t src_size, char *dst,
+                         size_t dst_capacity);
+
+  // Returns false unless src decompresses to exactly dst_size bytes
+  static bool Decompress(const char *src, size_t src_size, char *dst,
+                         size_t dst_size);
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// fuzzy_checkpoint.h
+//
+// Identification: src/include/logging/checkpoint/fuzzy_checkpoint.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/serializer.h"
+#include "logging/checkpoint.h"
+
+extern int peloton_checkpoint_thread_count;
+
+namespace peloton {
+
+namespace storage {
+class TileGroup;
+}
+
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Fuzzy Checkpoint
+//===--------------------------------------------------------------------===//
+
+// Checkpoints the versions visible at a commit id while transactions keep
+// running. Scan threads write the visible tuples of each tile group as a
+// compressed columnar block into their own data file, and a manifest names
+// the data files of a checkpoint once all of them are durable.
+class FuzzyCheckpoint : public Checkpoint {
+ public:
+  FuzzyCheckpoint(const FuzzyCheckpoint &) = delete;
+  FuzzyCheckpoint &operator=(const FuzzyCheckpoint &) = delete;
+  FuzzyCheckpoint(FuzzyCheckpoint &&) = delete;
+  FuzzyCheckpoint &operator=(FuzzyCheckpoint &&) = delete;
+  FuzzyCheckpoint(bool disable_file_access);
+  ~FuzzyCheckpoint() {}
+
+  // Inherited functions
+  void DoCheckpoint();
+
+  // Returns INVALID_CID if a data file could not be recovered
+  cid_t DoRecovery();
+
+  // Tuples written by the most recent checkpoint
+  inline size_t GetCheckpointTupleCount() const { return tuple_count_; }
+
+ private:
+  // A tile group to scan
+  struct ScanItem {
+    oid_t database_oid;
+    storage::DataTable *table;
+    std::shared_ptr<storage::TileGroup> tile_group;
+  };
+
+  // Scan threads take items until none is left, returns false on a write
+  // failure
+  bool ScanTileGroups(const std::vector<ScanItem> &items,
+                      std::atomic<size_t> &next_item, int file_id,
+                      size_t &tuple_count);
+
+  // Returns the number of tuples written
+  static oid_t SerializeTileGroup(const ScanItem &item, cid_t start_cid,
+                                  std::vector<CopySerializeOutput> &columns,
+                                  CopySerializeOutput &block);
+
+  // Returns the largest tile group recovered, or INVALID_OID on a corrupt
+  // file
+  static oid_t RecoverDataFile(const std::string &file_name, cid_t commit_id);
+
+  static bool RecoverBlock(const char *data, size_t size, oid_t database_oid,
+                           oid_t table_oid, oid_t tile_group_id,
+                           oid_t tuple_count, VarlenPool *pool,
+                           cid_t commit_id);
+
+  bool WriteManifest(cid_t commit_id, int file_count);
+
+  bool ReadManifest(cid_t &commit_id, std::vector<std::string> &file_names);
+
+  void Cleanup();
+
+  void InitVersionNumber();
+
+  std::string GetManifestFileName(int version);
+
+  std::string GetDataFileName(int version, int file_id);
+
+  // commit id of current checkpoint
+  cid_t start_commit_id_ = 0;
+
+  // data files written by the current checkpoint
+  std::vector<std::string> data_files_;
+
+  size_t tuple_count_ = 0;
+
+  const std::string MANIFEST_SUFFIX = ".manifest";
+
+  const std::string DATA_SUFFIX = ".data";
+};
+
+}  // namespace logging
+}  // namespace peloton
@@ -76,6 +76,12 @@ class CheckpointManager {
 
   cid_t GetRecoveredCid();
 
+  // A checkpoint that could not be recovered leaves the database without
+  // the tuples before its cid
+  void SetRecoveryFailed(bool recovery_failed);
+
+  bool IsRecoveryFailed();
+
  private:
   CheckpointManager();
   ~CheckpointManager() {}
@@ -94,6 +100,8 @@ class CheckpointManager {
 
   cid_t recovered_cid_ = 0;
 
+  bool recovery_failed_ = false;
+
   // used for multiple checkpointer
   // std::atomic<unsigned int> status_change_count_;
 
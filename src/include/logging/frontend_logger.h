@@ -82,7 +82,7 @@ class FrontendLogger : public Logger {
   void UpdateGlobalMaxFlushId();
 
   // reset the frontend logger to its original state (for testing
-  void Reset() {
+  virtual void Reset() {
     backend_loggers_lock.Lock();
 
     for (auto backend_logger : backend_loggers) {
@@ -94,6 +94,7 @@ class FrontendLogger : public Logger {
     max_flushed_commit_id = 0;
     max_collected_commit_id = 0;
     max_seen_commit_id = 0;
+    shutting_down = false;
     global_queue.clear();
 
     backend_loggers.clear();
@@ -137,6 +138,10 @@ class FrontendLogger : public Logger {
   bool test_mode_ = false;
 
   bool is_distinguished_logger = false;
+
+  // set for the last flush before sleep mode, no commit should be left
+  // waiting for a group to fill up
+  bool shutting_down = false;
 };
 
 }  // namespace logging
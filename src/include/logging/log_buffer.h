@@ -65,6 +65,10 @@ class LogBuffer {
 
   inline cid_t GetMaxLogId() { return max_log_id; }
 
+  inline void IncrementCommitCount() { commit_count_++; }
+
+  inline size_t GetCommitCount() { return commit_count_; }
+
   inline BackendLogger *GetBackendLogger() { return backend_logger_; }
 
  private:
@@ -84,6 +88,9 @@ class LogBuffer {
 
   // maximum log id seen so far
   cid_t max_log_id = 0;
+
+  // number of commit records in the buffer
+  size_t commit_count_ = 0;
 };
 
 }  // namespace logging
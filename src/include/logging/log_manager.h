@@ -13,6 +13,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <mutex>
 #include <map>
 #include <vector>
@@ -56,7 +57,7 @@ class LogManager {
   // global singleton
   static LogManager &GetInstance(void);
 
-  // configuration
+  // configuration, LOGGING_TYPE_SSD_WAL writes direct I/O log segments
   void Configure(LoggingType logging_type, bool test_mode = false,
                  unsigned int num_frontend_loggers = 1,
                  LoggerMappingStrategyType logger_mapping_strategy =
@@ -72,6 +73,7 @@ class LogManager {
     for (auto &frontend_logger : frontend_loggers) {
       frontend_logger->Reset();
     }
+    persistent_flushed_cid = INVALID_CID;
   }
 
   // reset log status to invalid
@@ -287,8 +289,9 @@ class LogManager {
   // count of loggers who moved from the recovery to loggin state
   unsigned int recovery_to_logging_counter = 0;
 
-  // maximum flushed commit id
-  cid_t max_flushed_cid = 0;
+  // commits up to this id are durable on every frontend logger, committers
+  // wait on it instead of asking the frontend loggers
+  std::atomic<cid_t> persistent_flushed_cid{INVALID_CID};
 
   bool syncronization_commit =
       true;  // default should be true because it is safest
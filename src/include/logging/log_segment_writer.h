@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_segment_writer.h
+//
+// Identification: src/include/logging/log_segment_writer.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "common/types.h"
+
+namespace peloton {
+namespace logging {
+
+//===--------------------------------------------------------------------===//
+// Log Segment Writer
+//===--------------------------------------------------------------------===//
+
+// Writes WAL segments with O_DIRECT | O_DSYNC instead of a buffered FILE*.
+// Segments are preallocated, so a write never has to update the file size,
+// and a write is durable once Sync returns, without a separate fsync.
+//
+// Writes are block aligned. The tail of the last block is zero padded and
+// rewritten by the next Sync, so a frame of zeros ends the segment during
+// recovery.
+//
+// A recycled segment still holds the records it was written with before.
+// A torn multi-block write can leave them right after the new ones, so every
+// batch of records goes in a frame stamped with the generation of the segment
+// (its log number) and a checksum of the records. Recovery stops at the first
+// frame that does not match.
+class LogSegmentWriter {
+ public:
+  // max log id and max delimiter at the head of every segment
+  static constexpr size_t header_size = 2 * sizeof(cid_t);
+
+  // generation, length and checksum ahead of the records of a frame
+  static constexpr size_t frame_header_size = 3 * sizeof(uint32_t);
+
+  // alignment of O_DIRECT buffers, offsets and lengths
+  static constexpr size_t block_size = 4096;
+
+  // write latency histogram buckets, bucket i counts writes that took
+  // [2^(i-1), 2^i) us
+  static constexpr size_t latency_bucket_count = 24;
+
+  LogSegmentWriter(size_t segment_size);
+
+  ~LogSegmentWriter(void);
+
+  // Open a segment, reusing recycled_file_name if it is not empty. The
+  // segment starts with an empty header.
+  bool Open(const std::string &file_name,
+            const std::string &recycled_file_name, uint32_t generation);
+
+  // Stage data at the end of the segment
+  void Append(const char *data, size_t len);
+
+  // Stage records in a frame of the segment generation
+  void AppendFrame(const char *data, size_t len);
+
+  // Fill in the frame header of records written to a segment of generation
+  static void BuildFrameHeader(char *frame_header, uint32_t generation,
+                               const char *data, size_t len);
+
+  // Checksum of the records of a frame, seeded with its generation
+  static uint32_t GetFrameChecksum(uint32_t generation, const char *data,
+                                   size_t len);
+
+  // Write all staged data, durable on return
+  bool Sync(void);
+
+  // Overwrite the segment header
+  bool WriteHeader(cid_t max_log_id, cid_t max_delimiter);
+
+  void Close(void);
+
+  bool IsOpen(void) const { return fd_ != INVALID_FILE_DESCRIPTOR; }
+
+  int GetFD(void) const { return fd_; }
+
+  // bytes written to the segment so far, header included
+  size_t GetWriteOffset(void) const { return write_offset_; }
+
+  size_t GetSyncCount(void) const { return sync_count_; }
+
+  const std::array<size_t, latency_bucket_count> &GetLatencyHistogram(
+      void) const {
+    return latency_histogram_;
+  }
+
+  // Get a string representation of the write latency histogram
+  const std::string GetInfo(void) const;
+
+ private:
+  bool WriteStagedBlocks(void);
+
+  bool WriteBlocks(const char *data, size_t len, size_t offset);
+
+  bool ReserveBuffer(size_t len);
+
+  void RecordLatency(uint64_t micros);
+
+  //===--------------------------------------------------------------------===//
+  // Member Variables
+  //===--------------------------------------------------------------------===//
+
+  size_t segment_size_;
+
+  // log number of the open segment
+  uint32_t generation_ = 0;
+
+  int fd_ = INVALID_FILE_DESCRIPTOR;
+
+  // whether the segment was opened with O_DIRECT
+  bool direct_io_ = false;
+
+  // block aligned staging buffer, holds the segment from buffer_offset_ on
+  char *buffer_ = nullptr;
+
+  size_t buffer_capacity_ = 0;
+
+  // block aligned file offset of the first byte in the buffer
+  size_t buffer_offset_ = 0;
+
+  size_t write_offset_ = 0;
+
+  size_t synced_offset_ = 0;
+
+  size_t sync_count_ = 0;
+
+  std::array<size_t, latency_bucket_count> latency_histogram_{};
+};
+
+}  // namespace logging
+}  // namespace peloton
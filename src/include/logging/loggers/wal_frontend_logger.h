@@ -16,15 +16,23 @@
 #include "logging/frontend_logger.h"
 #include "logging/records/tuple_record.h"
 #include "logging/log_file.h"
+#include "logging/log_segment_writer.h"
 #include "executor/executors.h"
+#include "common/thread_pool.h"
 
 #include <dirent.h>
+#include <memory>
 #include <vector>
 #include <set>
 #include <chrono>
+#include <future>
 
 extern int peloton_flush_frequency_micros;
 
+extern int peloton_group_commit_size;
+
+extern int peloton_recovery_thread_count;
+
 namespace peloton {
 
 class VarlenPool;
@@ -33,6 +41,10 @@ namespace concurrency {
 class Transaction;
 }
 
+namespace index {
+class Index;
+}
+
 namespace logging {
 
 typedef std::chrono::high_resolution_clock Clock;
@@ -56,12 +68,38 @@ class WriteAheadFrontendLogger : public FrontendLogger {
 
   void FlushLogRecords(void);
 
+  // Group commit policy, a group is flushed with a single fsync once its
+  // first commit has waited commit_delay or once it holds group_commit_size
+  // commits (0 means no limit)
+  void SetGroupCommitPolicy(Micros commit_delay, size_t group_commit_size) {
+    this->commit_delay = commit_delay;
+    this->group_commit_size = group_commit_size;
+  }
+
+  size_t GetPendingCommitCount() const { return pending_commit_count; }
+
+  // Write segments with direct I/O instead of a buffered FILE*
+  void SetDirectIO(bool direct_io);
+
+  // nullptr unless the logger writes with direct I/O
+  LogSegmentWriter *GetSegmentWriter() { return segment_writer_.get(); }
+
+  void Reset() {
+    FrontendLogger::Reset();
+    pending_commit_count = 0;
+    group_open = false;
+  }
+
   //===--------------------------------------------------------------------===//
   // Recovery
   //===--------------------------------------------------------------------===//
 
   void DoRecovery(void);
 
+  // Replay a log buffer a standby received, returns false on a broken
+  // record. Snapshots that begin afterwards see the txns it committed.
+  bool ReplayLogBuffer(const char *data, size_t size);
+
   void RecoverIndex();
 
   void StartTransactionRecovery(cid_t commit_id);
@@ -92,7 +130,8 @@ class WriteAheadFrontendLogger : public FrontendLogger {
 
   std::string GetFileNameFromVersion(int);
 
-  std::pair<cid_t, cid_t> ExtractMaxLogIdAndMaxDelimFromLogFileRecords(FILE *);
+  std::pair<cid_t, cid_t> ExtractMaxLogIdAndMaxDelimFromLogFileRecords(
+      FILE *, uint32_t generation);
 
   void SetLoggerID(int);
 
@@ -109,11 +148,43 @@ class WriteAheadFrontendLogger : public FrontendLogger {
  private:
   std::string GetLogFileName(void);
 
+  bool GroupCommitCondIsTrue();
+
+  void WriteToLogFile(const char *data, size_t len);
+
+  std::string GetRecycledFileName();
+
   bool RecoverTableIndexHelper(storage::DataTable *target_table,
-                               cid_t start_cid);
+                               cid_t start_cid,
+                               const std::vector<index::Index *> &indexes);
+
+  //===--------------------------------------------------------------------===//
+  // Parallel Replay
+  //===--------------------------------------------------------------------===//
+
+  enum ReplayOpType {
+    REPLAY_OP_INSERT,
+    REPLAY_OP_DELETE,
+    // the new version of an update
+    REPLAY_OP_INSERT_VERSION,
+    // the old version of an update
+    REPLAY_OP_RETIRE_VERSION
+  };
+
+  // What a replay thread applies to a single tile group
+  struct ReplayOp {
+    TupleRecord *record;
+    ReplayOpType type;
+  };
+
+  void PartitionTupleRecords(std::vector<TupleRecord *> &tuple_records);
+
+  void DispatchReplayBatch();
 
-  void InsertIndexEntry(storage::Tuple *tuple, storage::DataTable *table,
-                        ItemPointer target_location);
+  void WaitForReplayBatch();
+
+  // Returns the largest tile group created
+  static oid_t ReplayTupleRecords(const std::vector<ReplayOp> &ops);
 
   //===--------------------------------------------------------------------===//
   // Member Variables
@@ -160,9 +231,61 @@ class WriteAheadFrontendLogger : public FrontendLogger {
 
   bool should_create_new_file = false;
 
-  TimePoint last_flush = Clock::now();
+  // Group commit state
+  Micros commit_delay{peloton_flush_frequency_micros};
+
+  size_t group_commit_size = peloton_group_commit_size;
+
+  // commits written since the last fsync
+  size_t pending_commit_count = 0;
+
+  // when the first commit of the open group was written
+  TimePoint group_start_time;
+
+  bool group_open = false;
+
+  // Direct I/O segments
+  std::unique_ptr<LogSegmentWriter> segment_writer_;
+
+  // truncated segments waiting to be reused
+  std::vector<std::string> recycled_files_;
+
+  int recycled_file_counter_ = 0;
+
+  std::string RECYCLED_FILE_PREFIX = "recycled_segment_";
+
+  static constexpr size_t max_recycled_files = 4;
+
+  // Recovery reads
+  std::unique_ptr<char[]> recovery_read_buffer_;
+
+  static constexpr size_t recovery_read_buffer_size = 4 * 1024 * 1024;
+
+  // log number of the file being recovered, its frames must carry it
+  uint32_t recovery_generation_ = 0;
+
+  // offset right after the records of the frame being recovered
+  size_t recovery_frame_end_ = 0;
+
+  // Replay threads, only during a recovery with more than one
+  std::unique_ptr<ThreadPool> replay_pool_;
+
+  // ops of the batch being filled, one list per tile group partition, each
+  // in commit order
+  std::vector<std::vector<ReplayOp>> replay_batch_;
+
+  std::vector<TupleRecord *> replay_batch_records_;
+
+  // the batch being replayed
+  std::vector<std::future<oid_t>> replay_futures_;
+
+  std::vector<TupleRecord *> replayed_records_;
+
+  static constexpr size_t replay_batch_size = 64 * 1024;
 
-  Micros flush_frequency{peloton_flush_frequency_micros};
+  // Log written since the last flush, shipped to the replicas once it is
+  // durable
+  std::string replication_buffer_;
 };
 
 }  // namespace logging
@@ -41,6 +41,9 @@ class LoggingUtil {
 
   static LogRecordType GetNextLogRecordType(FileHandle &file_handle);
 
+  static bool ReadSegmentFrame(FileHandle &file_handle, uint32_t generation,
+                               size_t &frame_end);
+
   static int ExtractNumberFromFileName(const char *name);
 
   static bool ReadTransactionRecordHeader(TransactionRecord &txn_record,
@@ -0,0 +1,209 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// replication_manager.h
+//
+// Identification: src/include/logging/replication_manager.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/types.h"
+
+namespace peloton {
+
+namespace networking {
+class RpcServer;
+class RpcChannel;
+class LoggingService;
+class PelotonLoggingService_Stub;
+}
+
+namespace logging {
+
+class WriteAheadFrontendLogger;
+
+//===--------------------------------------------------------------------===//
+// Replication Manager
+//===--------------------------------------------------------------------===//
+
+// Hot standby replication. The WAL frontend logger of the primary ships
+// every group of log buffers it flushed to the replicas, and a standby
+// replays them through the recovery path as they arrive while serving
+// read-only snapshots.
+//
+// Shipping is asynchronous, a commit is durable once the primary flushed it.
+// The acknowledgements of the replicas only measure how far behind they are.
+class ReplicationManager {
+ public:
+  ReplicationManager(const ReplicationManager &) = delete;
+  ReplicationManager &operator=(const ReplicationManager &) = delete;
+  ReplicationManager(ReplicationManager &&) = delete;
+  ReplicationManager &operator=(ReplicationManager &&) = delete;
+
+  // global singleton
+  static ReplicationManager &GetInstance(void);
+
+  // Serve the logging service on the port, in a thread of its own. The
+  // primary needs it too, the acknowledgements come back through it.
+  bool StartServer(int port);
+
+  void StopServer();
+
+  //===--------------------------------------------------------------------===//
+  // Primary
+  //===--------------------------------------------------------------------===//
+
+  // address is ip:port. A replica that misses a buffer is dropped, it has to
+  // be added again from a fresh copy of the primary.
+  void AddReplica(const std::string &address);
+
+  inline bool HasReplicas() const { return replica_count_.load() != 0; }
+
+  inline size_t GetReplicaCount() const { return replica_count_.load(); }
+
+  // Ship the log flushed up to the commit id, takes over the contents of log
+  void ShipLogBuffer(std::string &log, cid_t max_commit_id);
+
+  // The replica replayed the buffers up to the sequence number, or it could
+  // not replay the buffer with the sequence number
+  void AcknowledgeLogBuffer(oid_t replica_id, int64_t sequence_number,
+                            bool replayed);
+
+  // Wait until every replica replayed the buffers shipped so far, returns
+  // false on a timeout
+  bool WaitForReplicas(std::chrono::milliseconds timeout);
+
+  //===--------------------------------------------------------------------===//
+  // Standby
+  //===--------------------------------------------------------------------===//
+
+  // A standby rejects plans that write
+  void SetStandby(bool standby);
+
+  inline bool IsStandby() const { return standby_.load(); }
+
+  // Returns false on a broken log record
+  bool ReplayLogBuffer(const std::string &log);
+
+  // The commit id the snapshots of the standby see
+  cid_t GetReplayedCommitId();
+
+  //===--------------------------------------------------------------------===//
+  // Lag
+  //===--------------------------------------------------------------------===//
+
+  // Commits shipped but not replayed by every replica yet
+  cid_t GetCommitLag();
+
+  // Average time from shipping a buffer until every replica replayed it
+  double GetAverageLag();
+
+  double GetMaxLag();
+
+  std::string GetInfo();
+
+ private:
+  ReplicationManager();
+
+  ~ReplicationManager();
+
+  // Stop waiting for the replica, pending_mutex_ is held
+  void DropReplica(oid_t replica_id);
+
+  // Pop the buffers every replica replayed, pending_mutex_ is held
+  void PopReplayedBuffers();
+
+  typedef std::chrono::steady_clock Clock;
+
+  struct Replica {
+    oid_t id;
+    std::string address;
+    std::unique_ptr<networking::RpcChannel> channel;
+    std::unique_ptr<networking::PelotonLoggingService_Stub> stub;
+  };
+
+  // A shipped buffer some replica did not acknowledge yet
+  struct PendingBuffer {
+    int64_t sequence_number;
+    cid_t max_commit_id;
+    Clock::time_point ship_time;
+    size_t acks_remaining;
+  };
+
+  // Only the frontend logger ships. The acknowledgements arrive in the
+  // event thread, which holds the lock of the connection meanwhile, so they
+  // take only pending_mutex_ and never wait for a send.
+  std::mutex replica_mutex_;
+
+  std::vector<std::unique_ptr<Replica>> replicas_;
+
+  std::atomic<size_t> replica_count_;
+
+  oid_t next_replica_id_ = 0;
+
+  std::mutex pending_mutex_;
+
+  std::condition_variable pending_cv_;
+
+  std::deque<PendingBuffer> pending_buffers_;
+
+  // The last sequence number every live replica acknowledged, the frontend
+  // logger stops shipping to the replicas missing here
+  std::map<oid_t, int64_t> acked_sequence_numbers_;
+
+  int64_t next_sequence_number_ = 1;
+
+  // Lag, guarded by pending_mutex_
+  size_t shipped_count_ = 0;
+
+  size_t shipped_bytes_ = 0;
+
+  cid_t shipped_commit_id_ = 0;
+
+  size_t replayed_count_ = 0;
+
+  cid_t replayed_commit_id_ = 0;
+
+  // in microseconds
+  double total_lag_ = 0;
+
+  double max_lag_ = 0;
+
+  // Standby
+  std::atomic<bool> standby_;
+
+  std::mutex replay_mutex_;
+
+  std::unique_ptr<WriteAheadFrontendLogger> replayer_;
+
+  size_t replayed_buffer_count_ = 0;
+
+  size_t replayed_bytes_ = 0;
+
+  // Server
+  std::unique_ptr<networking::RpcServer> server_;
+
+  std::unique_ptr<networking::LoggingService> service_;
+
+  std::thread server_thread_;
+};
+
+}  // namespace logging
+}  // namespace peloton
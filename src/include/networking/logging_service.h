@@ -0,0 +1,36 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_service.h
+//
+// Identification: src/include/networking/logging_service.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include "peloton/proto/logging_service.pb.h"
+
+//===--------------------------------------------------------------------===//
+// Implements PelotonLoggingService
+//===--------------------------------------------------------------------===//
+
+namespace peloton {
+namespace networking {
+
+// A standby replays the log buffers shipped by the primary, and the primary
+// gets the acknowledgements back through the same method
+class LoggingService : public PelotonLoggingService {
+ public:
+  virtual void LogRecordReplay(::google::protobuf::RpcController* controller,
+                               const LogRecordReplayRequest* request,
+                               LogRecordReplayResponse* response,
+                               ::google::protobuf::Closure* done);
+};
+
+}  // namespace networking
+}  // namespace peloton
@@ -35,6 +35,9 @@ class RpcServer {
   // start
   void Start();
 
+  // stop, Start returns
+  void Stop();
+
   // register service
   bool RegisterService(google::protobuf::Service* service);
 
@@ -43,6 +43,9 @@ class Listener {
   // Begin listening
   void Run(void* arg);
 
+  // Stop listening, Run returns
+  void Stop();
+
  private:
   // AcceptConnCb is a callback invoked when a new connection is accepted
   static void AcceptConnCb(struct evconnlistener* listener, evutil_socket_t fd,
@@ -0,0 +1,51 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hyperloglog.h
+//
+// Identification: src/include/optimizer/hyperloglog.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace peloton {
+
+class Value;
+
+namespace optimizer {
+
+//===--------------------------------------------------------------------===//
+// HyperLogLog
+//===--------------------------------------------------------------------===//
+
+// Distinct count sketch. Each register keeps the longest run of leading
+// zeros seen among the hashes that map to it, the estimate is off by about
+// 1.04 / sqrt(register count). Threads may add to and estimate from the
+// same sketch concurrently.
+class HyperLogLog {
+ public:
+  HyperLogLog(int precision = 12);
+
+  void Add(const Value &value);
+
+  void AddHash(uint64_t hash);
+
+  // Both sketches need the same precision
+  void Merge(const HyperLogLog &other);
+
+  double Estimate() const;
+
+ private:
+  int precision;
+  std::vector<uint8_t> registers;
+};
+
+} /* namespace optimizer */
+} /* namespace peloton */
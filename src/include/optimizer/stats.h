@@ -10,23 +10,128 @@
 //
 //===----------------------------------------------------------------------===//
 
-
 #pragma once
 
-#include "optimizer/tuple_sample.h"
+#include "common/pool.h"
+#include "common/types.h"
+#include "common/value.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+extern int peloton_stats_sample_size;
 
 namespace peloton {
+
+namespace storage {
+class DataTable;
+}
+
 namespace optimizer {
 
+//===--------------------------------------------------------------------===//
+// Column Stats
+//===--------------------------------------------------------------------===//
+
+// Summary of a column built by ANALYZE. The most common values and an
+// equi-depth histogram over the remaining values come from a sample, the
+// distinct count from a sketch over every visible tuple.
+class ColumnStats {
+ public:
+  // tuple_count is the number of tuples the sample was drawn from
+  ColumnStats(std::vector<Value> sample_values, double distinct_count,
+              double tuple_count);
+
+  // Without a sample, the values are assumed to spread evenly between the
+  // bounds. Null bounds if they are not known.
+  ColumnStats(double null_fraction, double distinct_count,
+              const Value &min_value, const Value &max_value);
+
+  double GetNullFraction() const;
+
+  double GetDistinctCount() const;
+
+  // Fraction of the tuples for which "column <type> value" holds
+  double GetSelectivity(ExpressionType type, const Value &value) const;
+
+  // (value, fraction of the tuples) by decreasing fraction
+  const std::vector<std::pair<Value, double>> &GetMostCommonValues() const;
+
+  const std::vector<Value> &GetHistogramBounds() const;
+
+ private:
+  double GetEqualSelectivity(const Value &value) const;
+
+  double GetLessThanSelectivity(const Value &value, bool inclusive) const;
+
+  // Fraction of the histogram below the value
+  double GetHistogramFraction(const Value &value) const;
+
+  double null_fraction;
+  double distinct_count;
+
+  // owns the varlen data of the values below, the sampled ones point into
+  // the tiles of the table
+  std::unique_ptr<VarlenPool> pool;
+
+  std::vector<std::pair<Value, double>> most_common_values;
+
+  // bucket_count + 1 bounds, every bucket holds the same number of values
+  std::vector<Value> histogram_bounds;
+
+  // fraction of the tuples the histogram covers, neither null nor common
+  double histogram_fraction;
+};
+
+//===--------------------------------------------------------------------===//
+// Table Stats
+//===--------------------------------------------------------------------===//
+class TableStats {
+ public:
+  TableStats(double tuple_count);
+
+  // ANALYZE. Scans the table in a transaction of its own and stores the
+  // stats with the catalog, replacing the previous ones.
+  static std::shared_ptr<TableStats> Analyze(storage::DataTable *table);
+
+  // The stats of the last ANALYZE of the table, else the ones the writes to
+  // the table maintain. nullptr if there are neither.
+  static std::shared_ptr<TableStats> Lookup(oid_t table_oid);
+
+  double GetTupleCount() const;
+
+  std::shared_ptr<ColumnStats> GetColumnStats(oid_t column_id) const;
+
+  void AddColumnStats(std::shared_ptr<ColumnStats> stats);
+
+ private:
+  double tuple_count;
+  std::vector<std::shared_ptr<ColumnStats>> column_stats;
+};
+
 //===--------------------------------------------------------------------===//
 // Stats
 //===--------------------------------------------------------------------===//
+
+// Estimates of a group expression, derived from the stats of its children
+// when the expression is costed
 class Stats {
  public:
-  Stats(TupleSample *sample);
+  Stats(double cardinality);
 
- private:
-  TupleSample *sample;
+  // rows the operator outputs
+  double cardinality;
+
+  // fraction of the rows a predicate keeps
+  double selectivity;
+
+  // a variable of an analyzed table column
+  std::shared_ptr<ColumnStats> column_stats;
+
+  // a constant
+  bool has_constant;
+  Value constant;
 };
 
 } /* namespace optimizer */
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_write_stats.h
+//
+// Identification: src/include/optimizer/table_write_stats.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "common/types.h"
+#include "optimizer/hyperloglog.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace peloton {
+
+namespace catalog {
+class Schema;
+}
+
+namespace storage {
+class Tuple;
+}
+
+namespace optimizer {
+
+class TableStats;
+
+//===--------------------------------------------------------------------===//
+// Table Write Stats
+//===--------------------------------------------------------------------===//
+
+// Stats of a table that its inserts, updates and deletes keep up to date, so
+// the optimizer has fresh estimates without scanning the table. The writers
+// bump counters in the shard of their thread and add to shared sketches
+// without taking locks, the readers sum the shards.
+//
+// Writes are counted when they reach the table, aborted ones are not taken
+// back. The sketches, null counts and bounds cover every version written, a
+// deleted or overwritten value stays in them until the table is recreated.
+class TableWriteStats {
+ public:
+  TableWriteStats(const catalog::Schema *schema);
+
+  //===--------------------------------------------------------------------===//
+  // WRITE PATH
+  //===--------------------------------------------------------------------===//
+
+  // a new tuple
+  void AddTuple(const storage::Tuple *tuple);
+
+  // the new version of an updated tuple
+  void UpdateTuple(const storage::Tuple *tuple);
+
+  void DeleteTuple();
+
+  //===--------------------------------------------------------------------===//
+  // READ PATH
+  //===--------------------------------------------------------------------===//
+
+  // tuples inserted minus tuples deleted
+  double GetTupleCount() const;
+
+  double GetNullFraction(oid_t column_id) const;
+
+  double GetDistinctCount(oid_t column_id) const;
+
+  // false if the column is not numeric or it has no values yet
+  bool GetBounds(oid_t column_id, double &min_value, double &max_value) const;
+
+  // Merges the shards and sketches into stats the optimizer can use. The
+  // merge is cached until the next write.
+  std::shared_ptr<TableStats> GetTableStats();
+
+ private:
+  void AddValues(const storage::Tuple *tuple);
+
+  void UpdateBounds(oid_t column_id, double value);
+
+  std::atomic<int64_t> &GetCounter(size_t slot);
+
+  // Sum of the slot over all shards
+  int64_t SumCounter(size_t slot) const;
+
+  oid_t column_count;
+
+  std::vector<ValueType> column_types;
+
+  // counters of a shard, padded to whole cache lines
+  size_t shard_stride;
+
+  // shard_count * shard_stride counters
+  std::unique_ptr<std::atomic<int64_t>[]> counters;
+
+  // distinct count sketch of every column
+  std::vector<HyperLogLog> sketches;
+
+  // bounds of the numeric columns
+  std::unique_ptr<std::atomic<double>[]> min_values;
+  std::unique_ptr<std::atomic<double>[]> max_values;
+
+  // LAZY MERGE
+  std::mutex merge_mutex;
+
+  // writes counted by the cached merge
+  int64_t merged_write_count;
+
+  std::shared_ptr<TableStats> merged_stats;
+};
+
+} /* namespace optimizer */
+} /* namespace peloton */
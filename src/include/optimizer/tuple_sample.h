@@ -10,29 +10,42 @@
 //
 //===----------------------------------------------------------------------===//
 
-
 #pragma once
 
-#include "optimizer/column.h"
-#include "storage/tile_group.h"
-#include "optimizer/util.h"
+#include "common/types.h"
+#include "common/value.h"
 
+#include <random>
 #include <vector>
 
 namespace peloton {
 namespace optimizer {
 
 //===--------------------------------------------------------------------===//
-// TupleSample
+// Tuple Sample
 //===--------------------------------------------------------------------===//
+
+// Uniform sample of the tuples a scan offers (reservoir sampling), without
+// knowing the tuple count upfront. Keeps the locations, the values are read
+// from the tile groups when needed.
 class TupleSample {
  public:
-  TupleSample(std::vector<Column *> columns,
-              storage::TileGroup *sampled_tuples);
+  TupleSample(size_t sample_size);
+
+  void AddTuple(const ItemPointer &location);
+
+  // Tuples offered so far
+  size_t GetSeenCount() const;
+
+  const std::vector<ItemPointer> &GetTuples() const;
+
+  std::vector<Value> GetColumnValues(oid_t column_id) const;
 
  private:
-  std::vector<Column *> columns;
-  storage::TileGroup *sampled_tuples;
+  size_t sample_size;
+  size_t seen_count;
+  std::vector<ItemPointer> tuples;
+  std::mt19937_64 random;
 };
 
 } /* namespace optimizer */
@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gather_plan.h
+//
+// Identification: src/include/planner/gather_plan.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "abstract_plan.h"
+#include "common/types.h"
+
+namespace peloton {
+namespace planner {
+
+/**
+ * @brief	Gather plan node.
+ * Runs its sequential scan child on several worker threads, each of which
+ * scans morsels of "morsel_size" tile groups, and merges their logical tiles
+ * back into a single stream. The output order of the tiles is not defined.
+ * Any other child is passed through unchanged.
+ */
+class GatherPlan : public AbstractPlan {
+ public:
+  GatherPlan(const GatherPlan &) = delete;
+  GatherPlan &operator=(const GatherPlan &) = delete;
+  GatherPlan(GatherPlan &&) = delete;
+  GatherPlan &operator=(GatherPlan &&) = delete;
+
+  GatherPlan(size_t parallelism, size_t morsel_size = 1)
+      : parallelism_(parallelism), morsel_size_(morsel_size) {}
+
+  // Accessors
+  size_t GetParallelism() const { return parallelism_; }
+
+  size_t GetMorselSize() const { return morsel_size_; }
+
+  inline PlanNodeType GetPlanNodeType() const { return PLAN_NODE_TYPE_GATHER; }
+
+  const std::string GetInfo() const { return "Gather"; }
+
+  std::unique_ptr<AbstractPlan> Copy() const {
+    return std::unique_ptr<AbstractPlan>(
+        new GatherPlan(parallelism_, morsel_size_));
+  }
+
+ private:
+  const size_t parallelism_;  // number of worker threads
+  const size_t morsel_size_;  // tile groups handed out at a time
+};
+
+} /* namespace planner */
+} /* namespace peloton */
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile.h
+//
+// Identification: src/include/storage/compressed_tile.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "storage/tile.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile
+//===--------------------------------------------------------------------===//
+
+enum ColumnEncodingType {
+  // fixed-width fields as in a tile
+  COLUMN_ENCODING_TYPE_PLAIN = 0,
+
+  // integers as bit-packed offsets from the smallest one
+  COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE = 1,
+
+  // bit-packed codes into the distinct fields
+  COLUMN_ENCODING_TYPE_DICTIONARY = 2,
+
+  // one field per run of equal fields
+  COLUMN_ENCODING_TYPE_RUN_LENGTH = 3
+};
+
+/**
+ * Immutable copy of a tile, every column in the encoding that takes the
+ * least space.
+ *
+ * Fields that are not frame-of-reference encoded are kept in the tile
+ * storage format, so values read from them point into the compressed tile
+ * like values of a tile do. Uninlined fields point to varlens in the pool
+ * of the compressed tile, one per distinct field in a dictionary.
+ *
+ * A compressed tile has no tuple storage: GetTupleLocation() must not be
+ * used on it, and it can not be written. See TileGroup::CompressTiles().
+ */
+class CompressedTile : public Tile {
+  CompressedTile() = delete;
+  CompressedTile(CompressedTile const &) = delete;
+
+ public:
+  // Compress all the slots of the tile
+  explicit CompressedTile(Tile *tile);
+
+  Value GetValue(const oid_t tuple_offset, const oid_t column_id) override;
+
+  Value GetValueFast(const oid_t tuple_offset, const size_t column_offset,
+                     const ValueType column_type,
+                     const bool is_inlined) override;
+
+  bool IsCompressed() const override { return true; }
+
+  ColumnEncodingType GetColumnEncoding(const oid_t column_id) const {
+    return columns_[column_id].encoding;
+  }
+
+  /**
+   * Decode an integral column for the given slots, NULLs as INT64_NULL.
+   * Returns false if the column is not TINYINT to BIGINT.
+   */
+  bool GatherIntegers(const oid_t column_id, const oid_t *tuple_offsets,
+                      const size_t count, int64_t *values) const;
+
+  /**
+   * Decode a DOUBLE column for the given slots, NULLs as DOUBLE_NULL.
+   * Returns false if the column is not a DOUBLE one.
+   */
+  bool GatherDoubles(const oid_t column_id, const oid_t *tuple_offsets,
+                     const size_t count, double *values) const;
+
+  // Get a string representation for debugging
+  const std::string GetInfo() const override;
+
+ private:
+  struct CompressedColumn {
+    ColumnEncodingType encoding;
+
+    ValueType type;
+
+    bool is_inlined;
+
+    // bytes of a field
+    size_t width;
+
+    // smallest integer of a frame-of-reference column
+    int64_t base;
+
+    // bits of a packed offset or code
+    size_t bit_width;
+
+    // frame-of-reference offsets or dictionary codes
+    std::vector<uint64_t> packed;
+
+    // fields of a plain column, the dictionary, or the field of every run
+    std::string fields;
+
+    // slot after every run
+    std::vector<oid_t> run_ends;
+  };
+
+  void CompressColumn(Tile *tile, const oid_t column_id,
+                      CompressedColumn &column);
+
+  // Field of the slot in a column that is not frame-of-reference encoded
+  const char *GetField(const CompressedColumn &column,
+                       const oid_t tuple_offset) const;
+
+  int64_t GetInteger(const CompressedColumn &column,
+                     const oid_t tuple_offset) const;
+
+  std::vector<CompressedColumn> columns_;
+
+  // offset of every column within a tuple of the uncompressed tile
+  std::vector<size_t> column_offsets_;
+};
+
+}  // End storage namespace
+}  // End peloton namespace
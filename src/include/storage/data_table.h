@@ -46,6 +46,12 @@ extern int peloton_num_groups;
 // FSM or not ?
 extern bool peloton_fsm;
 
+// # of tile groups taking inserts per table (0 means only the last one)
+extern int peloton_active_tile_group_count;
+
+// Maintain the optimizer stats of new tables on their write path ?
+extern bool peloton_write_stats;
+
 extern std::vector<peloton::oid_t> hyadapt_column_ids;
 
 namespace peloton {
@@ -68,6 +74,10 @@ namespace logging {
 class LogManager;
 }
 
+namespace optimizer {
+class TableWriteStats;
+}
+
 namespace storage {
 
 class Tuple;
@@ -100,7 +110,8 @@ class DataTable : public AbstractTable {
   DataTable(catalog::Schema *schema, const std::string &table_name,
             const oid_t &database_oid, const oid_t &table_oid,
             const size_t &tuples_per_tilegroup, const bool own_schema,
-            const bool adapt_table);
+            const bool adapt_table,
+            const HeaderLayoutType header_layout = HEADER_LAYOUT_ROW);
 
   ~DataTable();
 
@@ -140,6 +151,9 @@ class DataTable : public AbstractTable {
   // Get a tile group with given layout
   TileGroup *GetTileGroupWithLayout(const column_map_type &partitioning);
 
+  // Layout of the tuple headers in the tile groups of this table
+  HeaderLayoutType GetHeaderLayout() const { return header_layout_; }
+
   //===--------------------------------------------------------------------===//
   // INDEX
   //===--------------------------------------------------------------------===//
@@ -185,6 +199,10 @@ class DataTable : public AbstractTable {
 
   float GetNumberOfTuples() const;
 
+  // Stats the inserts, updates and deletes maintain, nullptr if the table
+  // was created with peloton_write_stats off
+  optimizer::TableWriteStats *GetWriteStats() const;
+
   bool IsDirty() const;
 
   void ResetDirty();
@@ -235,9 +253,15 @@ class DataTable : public AbstractTable {
   ItemPointer GetEmptyTupleSlot(const storage::Tuple *tuple,
                                 bool check_constraint = true);
 
+  // Claim a tuple slot recycled by the GC, if there is one
+  ItemPointer GetRecycledTupleSlot(const storage::Tuple *tuple);
+
   // add a default unpartitioned tile group to table
   oid_t AddDefaultTileGroup();
 
+  // add a default tile group and make it take the inserts of the given slot
+  oid_t AddDefaultTileGroup(const size_t &active_tile_group_id);
+
   // get a partitioning with given layout type
   column_map_type GetTileGroupLayout(LayoutType layout_type);
 
@@ -275,6 +299,15 @@ class DataTable : public AbstractTable {
   // TODO: don't know why need this mutex --Yingjun
   std::mutex tile_group_mutex_;
 
+  // ACTIVE TILE GROUPS
+  // number of tile groups taking inserts at the same time, 0 means that
+  // all threads insert into the last tile group
+  size_t active_tile_group_count_ = 0;
+
+  // a thread always inserts through the same slot, so threads do not contend
+  // on one tile group header
+  std::vector<std::shared_ptr<storage::TileGroup>> active_tile_groups_;
+
   // INDEXES
   std::vector<index::Index *> indexes_;
 
@@ -293,12 +326,22 @@ class DataTable : public AbstractTable {
   // dirty flag
   bool dirty_ = false;
 
+  // stats maintained by the writes, shared with the catalog
+  std::shared_ptr<optimizer::TableWriteStats> write_stats_;
+
   // clustering mutex
   std::mutex clustering_mutex_;
 
   // adapt table
   bool adapt_table_ = true;
 
+  // tuple header layout of new tile groups
+  HeaderLayoutType header_layout_ = HEADER_LAYOUT_ROW;
+
+  // unique over the life of the process, unlike the table oid, so a free
+  // slot cache never outlives its table under a reused oid
+  size_t instance_id_;
+
   // default partition map for table
   column_map_type default_partition_;
 
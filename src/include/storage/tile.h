@@ -79,14 +79,16 @@ class Tile : public Printable {
   /**
    * Returns value present at slot
    */
-  Value GetValue(const oid_t tuple_offset, const oid_t column_id);
+  virtual Value GetValue(const oid_t tuple_offset, const oid_t column_id);
 
   /*
    * Faster way to get value
    * By amortizing schema lookups
    */
-  Value GetValueFast(const oid_t tuple_offset, const size_t column_offset,
-                     const ValueType column_type, const bool is_inlined);
+  virtual Value GetValueFast(const oid_t tuple_offset,
+                             const size_t column_offset,
+                             const ValueType column_type,
+                             const bool is_inlined);
 
   /**
    * Sets value at tuple slot.
@@ -169,7 +171,14 @@ class Tile : public Printable {
   // Sync the contents
   void Sync();
 
+  // Compressed tiles have no tuple storage, see CompressedTile
+  virtual bool IsCompressed() const { return false; }
+
  protected:
+  // Tile with the catalog ids, header, schema and slots of the given tile,
+  // but no tuple storage
+  explicit Tile(const Tile *tile);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -15,6 +15,7 @@
 
 #include <map>
 #include <atomic>
+#include <functional>
 #include <vector>
 #include <mutex>
 #include <memory>
@@ -170,7 +171,40 @@ class TileGroup : public Printable {
   // Sync the contents
   void Sync();
 
+  //===--------------------------------------------------------------------===//
+  // Compression
+  //===--------------------------------------------------------------------===//
+
+  /**
+   * Replace the tiles with compressed copies, unless a write to them is in
+   * flight or is_cold() is false. The replaced tiles are moved to
+   * retired_tiles, readers may still hold them.
+   */
+  bool CompressTiles(const std::function<bool()> &is_cold,
+                     std::vector<std::shared_ptr<Tile>> &retired_tiles);
+
+  bool IsCompressed() const { return tiles_compressed.load(); }
+
  protected:
+  //===--------------------------------------------------------------------===//
+  // In-place writes
+  //
+  // Compressed tiles are immutable. A write to them swaps plain tiles back
+  // in first. Writers announce themselves in tile_writer_count and the
+  // compressor sets tiles_frozen before it checks that count, so either the
+  // compressor sees the writer, or the writer sees the tiles frozen and
+  // waits on the tile group mutex.
+  //===--------------------------------------------------------------------===//
+
+  void BeginTileWrite();
+
+  void EndTileWrite() { tile_writer_count--; }
+
+  // Swap plain copies of the compressed tiles in, tile_group_mutex held
+  void DecompressTiles();
+
+  void SetTile(const oid_t tile_offset, const std::shared_ptr<Tile> &tile);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -203,6 +237,17 @@ class TileGroup : public Printable {
 
   std::mutex tile_group_mutex;
 
+  // tiles[i].get(), so that readers do not race with a tile being replaced
+  std::unique_ptr<std::atomic<Tile *>[]> tile_locations;
+
+  // set while the tiles are compressed or being compressed
+  std::atomic<bool> tiles_frozen;
+
+  std::atomic<bool> tiles_compressed;
+
+  // in-place writes in flight
+  std::atomic<size_t> tile_writer_count;
+
   // column to tile mapping :
   // <column offset> to <tile offset, tile column offset>
   column_map_type column_map;
@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compressor.h
+//
+// Identification: src/include/storage/tile_group_compressor.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/types.h"
+
+// Period of the cold tile group compressor (in ms, 0 means no compressor)
+extern int peloton_compression_period;
+
+namespace peloton {
+namespace storage {
+
+class DataTable;
+class Tile;
+class TileGroup;
+
+//===--------------------------------------------------------------------===//
+// Tile Group Compressor
+//===--------------------------------------------------------------------===//
+
+/**
+ * Rewrites cold tile groups into compressed tiles, see CompressedTile.
+ *
+ * A tile group is cold once all its slots hold live tuples that no txn
+ * owns, and that were committed before every running txn began. Tiles
+ * replaced in a tile group are retired, and only released once every
+ * epoch they could still be read in has been exited.
+ */
+class TileGroupCompressor {
+ public:
+  TileGroupCompressor(const TileGroupCompressor &) = delete;
+  TileGroupCompressor &operator=(const TileGroupCompressor &) = delete;
+
+  static TileGroupCompressor &GetInstance();
+
+  ~TileGroupCompressor();
+
+  // Compress the tables of all the databases every period (in ms)
+  void StartCompressor(const int period);
+
+  void StopCompressor();
+
+  // Compress the cold tile groups of the table, returns how many
+  size_t CompressTable(DataTable *table);
+
+  static bool IsCold(TileGroup *tile_group);
+
+  // Hand over tiles that were replaced in a tile group
+  void RetireTiles(std::vector<std::shared_ptr<Tile>> &tiles);
+
+  // Release the retired tiles that can not be read anymore
+  void ReleaseRetiredTiles();
+
+  // Number of tile groups compressed so far
+  size_t GetCompressedCount() const { return compressed_count_.load(); }
+
+ private:
+  TileGroupCompressor() : is_running_(false) {}
+
+  void Running(const int period);
+
+  std::atomic<bool> is_running_;
+
+  std::unique_ptr<std::thread> compressor_thread_;
+
+  std::mutex retired_tiles_mutex_;
+
+  // retired tiles with the epoch they were retired in, oldest first
+  std::deque<std::pair<size_t, std::shared_ptr<Tile>>> retired_tiles_;
+
+  std::atomic<size_t> compressed_count_ = ATOMIC_VAR_INIT(0);
+};
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -19,6 +19,7 @@
 #include <vector>
 #include <cstring>
 
+#include "common/platform.h"
 #include "common/printable.h"
 #include "common/types.h"
 #include "common/macros.h"
@@ -45,31 +46,24 @@ class TileGroup;
  *bytes) |
  *  | ReservedField (24 bytes) | InsertCommit (1 byte) | DeleteCommit (1 byte)
  *  -----------------------------------------------------------------------------
+ *
+ * This is the row layout (HEADER_LAYOUT_ROW). With the column layout
+ * (HEADER_LAYOUT_COLUMN) each field instead lives in an array of its own,
+ * starting on a cache line, so that visibility checks over a tile group only
+ * stream through the TxnID and TimeStamp arrays, 24 bytes per tuple.
  */
 
-#define TUPLE_HEADER_LOCATION data + (tuple_slot_id * header_entry_size)
+#define TUPLE_HEADER_FIELD(field) \
+  (field.location + (tuple_slot_id * field.stride))
 
 class TileGroupHeader : public Printable {
   TileGroupHeader() = delete;
 
  public:
-  TileGroupHeader(const BackendType &backend_type, const int &tuple_count);
-
-  TileGroupHeader &operator=(const peloton::storage::TileGroupHeader &other) {
-    // check for self-assignment
-    if (&other == this) return *this;
-
-    header_size = other.header_size;
+  TileGroupHeader(const BackendType &backend_type, const int &tuple_count,
+                  const HeaderLayoutType &header_layout = HEADER_LAYOUT_ROW);
 
-    // copy over all the data
-    PL_MEMCPY(data, other.data, header_size);
-
-    num_tuple_slots = other.num_tuple_slots;
-    oid_t val = other.next_tuple_slot;
-    next_tuple_slot = val;
-
-    return *this;
-  }
+  TileGroupHeader &operator=(const peloton::storage::TileGroupHeader &other);
 
   ~TileGroupHeader();
 
@@ -126,43 +120,43 @@ class TileGroupHeader : public Printable {
   // but the current transaction reads the txn_id.
   // the returned value seems to be uncertain.
   inline txn_id_t GetTransactionId(const oid_t &tuple_slot_id) const {
-    // txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
+    // txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_FIELD(txn_id_field));
     // return __atomic_load_n(txn_id_ptr, __ATOMIC_RELAXED);
-    return *((txn_id_t *)(TUPLE_HEADER_LOCATION));
+    return *((txn_id_t *)(TUPLE_HEADER_FIELD(txn_id_field)));
   }
 
   inline cid_t GetBeginCommitId(const oid_t &tuple_slot_id) const {
-    return *((cid_t *)(TUPLE_HEADER_LOCATION + begin_cid_offset));
+    return *((cid_t *)(TUPLE_HEADER_FIELD(begin_cid_field)));
   }
 
   inline cid_t GetEndCommitId(const oid_t &tuple_slot_id) const {
-    return *((cid_t *)(TUPLE_HEADER_LOCATION + end_cid_offset));
+    return *((cid_t *)(TUPLE_HEADER_FIELD(end_cid_field)));
   }
 
   inline ItemPointer GetNextItemPointer(const oid_t &tuple_slot_id) const {
-    return *((ItemPointer *)(TUPLE_HEADER_LOCATION + next_pointer_offset));
+    return *((ItemPointer *)(TUPLE_HEADER_FIELD(next_pointer_field)));
   }
 
   inline ItemPointer GetPrevItemPointer(const oid_t &tuple_slot_id) const {
-    return *((ItemPointer *)(TUPLE_HEADER_LOCATION + prev_pointer_offset));
+    return *((ItemPointer *)(TUPLE_HEADER_FIELD(prev_pointer_field)));
   }
 
   // constraint: at most 24 bytes.
   inline char *GetReservedFieldRef(const oid_t &tuple_slot_id) const {
-    return (char *)(TUPLE_HEADER_LOCATION + reserved_field_offset);
+    return (char *)(TUPLE_HEADER_FIELD(reserved_field));
   }
 
   inline bool GetInsertCommit(const oid_t &tuple_slot_id) const {
-    return *((bool *)(TUPLE_HEADER_LOCATION + insert_commit_offset));
+    return *((bool *)(TUPLE_HEADER_FIELD(insert_commit_field)));
   }
 
   inline bool GetDeleteCommit(const oid_t &tuple_slot_id) const {
-    return *((bool *)(TUPLE_HEADER_LOCATION + delete_commit_offset));
+    return *((bool *)(TUPLE_HEADER_FIELD(delete_commit_field)));
   }
 
   // used only by occ_rb_txn_manager
   inline char *GetPrevItempointerField(const oid_t &tuple_slot_id) const {
-    return (char *)(TUPLE_HEADER_LOCATION + prev_pointer_offset);
+    return (char *)(TUPLE_HEADER_FIELD(prev_pointer_field));
   }
 
   // Setters
@@ -172,58 +166,74 @@ class TileGroupHeader : public Printable {
   }
   inline void SetTransactionId(const oid_t &tuple_slot_id,
                                const txn_id_t &transaction_id) {
-    *((txn_id_t *)(TUPLE_HEADER_LOCATION)) = transaction_id;
+    *((txn_id_t *)(TUPLE_HEADER_FIELD(txn_id_field))) = transaction_id;
   }
 
   inline void SetBeginCommitId(const oid_t &tuple_slot_id,
                                const cid_t &begin_cid) {
-    *((cid_t *)(TUPLE_HEADER_LOCATION + begin_cid_offset)) = begin_cid;
+    *((cid_t *)(TUPLE_HEADER_FIELD(begin_cid_field))) = begin_cid;
   }
 
   inline void SetEndCommitId(const oid_t &tuple_slot_id,
                              const cid_t &end_cid) const {
-    *((cid_t *)(TUPLE_HEADER_LOCATION + end_cid_offset)) = end_cid;
+    *((cid_t *)(TUPLE_HEADER_FIELD(end_cid_field))) = end_cid;
   }
 
   inline void SetNextItemPointer(const oid_t &tuple_slot_id,
                                  const ItemPointer &item) const {
-    *((ItemPointer *)(TUPLE_HEADER_LOCATION + next_pointer_offset)) = item;
+    *((ItemPointer *)(TUPLE_HEADER_FIELD(next_pointer_field))) = item;
   }
 
   inline void SetPrevItemPointer(const oid_t &tuple_slot_id,
                                  const ItemPointer &item) const {
-    *((ItemPointer *)(TUPLE_HEADER_LOCATION + prev_pointer_offset)) = item;
+    *((ItemPointer *)(TUPLE_HEADER_FIELD(prev_pointer_field))) = item;
   }
 
   inline void SetInsertCommit(const oid_t &tuple_slot_id,
                               const bool commit) const {
-    *((bool *)(TUPLE_HEADER_LOCATION + insert_commit_offset)) = commit;
+    *((bool *)(TUPLE_HEADER_FIELD(insert_commit_field))) = commit;
   }
 
   inline void SetDeleteCommit(const oid_t &tuple_slot_id,
                               const bool commit) const {
-    *((bool *)(TUPLE_HEADER_LOCATION + delete_commit_offset)) = commit;
+    *((bool *)(TUPLE_HEADER_FIELD(delete_commit_field))) = commit;
   }
 
   // Getters for addresses
   inline txn_id_t *GetTransactionIdLocation(const oid_t &tuple_slot_id) const {
-    return ((txn_id_t *)(TUPLE_HEADER_LOCATION));
+    return ((txn_id_t *)(TUPLE_HEADER_FIELD(txn_id_field)));
   }
 
   inline txn_id_t SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                          const txn_id_t &old_txn_id,
                                          const txn_id_t &new_txn_id) const {
-    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
+    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_FIELD(txn_id_field));
     return __sync_val_compare_and_swap(txn_id_ptr, old_txn_id, new_txn_id);
   }
 
   inline bool SetAtomicTransactionId(const oid_t &tuple_slot_id,
                                      const txn_id_t &transaction_id) const {
-    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_LOCATION);
+    txn_id_t *txn_id_ptr = (txn_id_t *)(TUPLE_HEADER_FIELD(txn_id_field));
     return __sync_bool_compare_and_swap(txn_id_ptr, INITIAL_TXN_ID,
                                         transaction_id);
   }
 
+  // Contiguous arrays of the visibility fields, indexed by tuple slot.
+  // Only available with the column layout, nullptr otherwise.
+  inline const txn_id_t *GetTransactionIdArray() const {
+    return (const txn_id_t *)GetFieldArray(txn_id_field);
+  }
+
+  inline const cid_t *GetBeginCommitIdArray() const {
+    return (const cid_t *)GetFieldArray(begin_cid_field);
+  }
+
+  inline const cid_t *GetEndCommitIdArray() const {
+    return (const cid_t *)GetFieldArray(end_cid_field);
+  }
+
+  HeaderLayoutType GetHeaderLayout() const { return header_layout; }
+
   void PrintVisibility(txn_id_t txn_id, cid_t at_cid);
 
   // Getter for spin lock
@@ -270,6 +280,20 @@ class TileGroupHeader : public Printable {
       insert_commit_offset + sizeof(bool);
 
  private:
+  // Where a field is found for tuple slot 0, and how far apart the slots are
+  struct HeaderField {
+    char *location = nullptr;
+    size_t stride = 0;
+  };
+
+  inline const char *GetFieldArray(const HeaderField &field) const {
+    return (header_layout == HEADER_LAYOUT_COLUMN) ? field.location : nullptr;
+  }
+
+  // Place the fields according to the layout, returns the space needed.
+  // Without a base only the space is computed.
+  size_t SetFieldLocations(char *base);
+
   //===--------------------------------------------------------------------===//
   // Data members
   //===--------------------------------------------------------------------===//
@@ -277,6 +301,8 @@ class TileGroupHeader : public Printable {
   // Backend
   BackendType backend_type;
 
+  HeaderLayoutType header_layout;
+
   // Associated tile_group
   TileGroup *tile_group;
 
@@ -285,6 +311,15 @@ class TileGroupHeader : public Printable {
   // set of fixed-length tuple slots
   char *data;
 
+  HeaderField txn_id_field;
+  HeaderField begin_cid_field;
+  HeaderField end_cid_field;
+  HeaderField next_pointer_field;
+  HeaderField prev_pointer_field;
+  HeaderField reserved_field;
+  HeaderField insert_commit_field;
+  HeaderField delete_commit_field;
+
   // number of tuple slots allocated
   oid_t num_tuple_slots;
 
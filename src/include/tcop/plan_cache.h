@@ -0,0 +1,119 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.h
+//
+// Identification: src/include/tcop/plan_cache.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/cache.h"
+#include "common/value.h"
+
+#define PLAN_CACHE_SHARD_COUNT 16
+#define PLAN_CACHE_SHARD_SIZE 256
+
+namespace peloton {
+
+namespace planner {
+class AbstractPlan;
+}
+
+namespace tcop {
+
+// A plan along with the catalog version it was built against
+struct CachedPlan {
+  std::shared_ptr<planner::AbstractPlan> plan;
+  uint64_t schema_version;
+
+  CachedPlan(std::shared_ptr<planner::AbstractPlan> plan,
+             uint64_t schema_version)
+      : plan(plan), schema_version(schema_version) {}
+};
+
+//===--------------------------------------------------------------------===//
+// PLAN CACHE
+//===--------------------------------------------------------------------===//
+
+/*
+ * Process-wide cache of plans shared by all the sessions. Keys are query
+ * strings with their literals lifted out into parameters ($1, $2, ...), so
+ * "WHERE id = 5" and "WHERE id = 7" share a plan. The key space is split
+ * into shards, each an LRU cache guarded by its own mutex. Entries built
+ * against an older catalog version are dropped when they are looked up.
+ */
+class PlanCache {
+  PlanCache(PlanCache const &) = delete;
+
+ public:
+  // global singleton
+  static PlanCache &GetInstance(void);
+
+  explicit PlanCache(size_t shard_size = PLAN_CACHE_SHARD_SIZE);
+
+  // Returns the cached plan for the normalized query, nullptr on a miss
+  std::shared_ptr<planner::AbstractPlan> Find(
+      const std::string &normalized_query);
+
+  // Cache a plan built for the normalized query
+  void Insert(const std::string &normalized_query,
+              const std::shared_ptr<planner::AbstractPlan> &plan);
+
+  // Drop all the cached plans
+  void Clear();
+
+  size_t GetSize();
+
+  uint64_t GetHitCount() const { return hit_count_.load(); }
+
+  uint64_t GetMissCount() const { return miss_count_.load(); }
+
+  uint64_t GetEvictionCount() const { return eviction_count_.load(); }
+
+  uint64_t GetInvalidationCount() const { return invalidation_count_.load(); }
+
+  /*
+   * Replace the numeric and string literals of a query with parameters.
+   * The lifted literals are appended to "param_values" in order.
+   * Returns false if the query should not be cached (DDL, utility
+   * statements or queries that already carry parameters).
+   */
+  static bool NormalizeQuery(const std::string &query,
+                             std::string &normalized_query,
+                             std::vector<Value> &param_values);
+
+ private:
+  struct Shard {
+    std::mutex shard_mutex;
+    Cache<std::string, CachedPlan> cache;
+
+    explicit Shard(size_t shard_size) : cache(shard_size, 1) {}
+  };
+
+  Shard &GetShard(const std::string &normalized_query);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  std::atomic<uint64_t> hit_count_;
+
+  std::atomic<uint64_t> miss_count_;
+
+  std::atomic<uint64_t> eviction_count_;
+
+  std::atomic<uint64_t> invalidation_count_;
+};
+
+}  // End tcop namespace
+}  // End peloton namespace
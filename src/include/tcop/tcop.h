@@ -15,6 +15,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <functional>
 #include <mutex>
 #include <vector>
 
@@ -23,8 +24,16 @@
 #include "common/types.h"
 
 namespace peloton {
+
+namespace executor {
+class LogicalTile;
+}
+
 namespace tcop {
 
+// Gets every result tile of a statement while its txn is still running
+typedef std::function<void(executor::LogicalTile *)> ResultConsumer;
+
 //===--------------------------------------------------------------------===//
 // TRAFFIC COP
 //===--------------------------------------------------------------------===//
@@ -43,7 +52,7 @@ class TrafficCop {
 
   // PortalExec - Execute query string
   Result ExecuteStatement(const std::string& query,
-                          std::vector<ResultType> &result,
+                          const ResultConsumer &result_consumer,
                           std::vector<FieldInfoType> &tuple_descriptor,
                           int &rows_changed,
                           std::string &error_message);
@@ -51,7 +60,7 @@ class TrafficCop {
   // ExecPrepStmt - Execute a statement from a prepared and bound statement
   Result ExecuteStatement(const std::shared_ptr<Statement>& statement,
                           const bool unnamed,
-                          std::vector<ResultType> &result,
+                          const ResultConsumer &result_consumer,
                           int &rows_change,
                           std::string &error_message);
 
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// event_server.h
+//
+// Identification: src/include/wire/event_server.h
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "wire/socket_base.h"
+#include "wire/wire.h"
+
+DECLARE_uint64(io_threads);
+DECLARE_uint64(worker_threads);
+DECLARE_uint64(max_in_flight);
+
+namespace peloton {
+namespace wire {
+
+/*
+ * EventConnection - State of a client connection owned by the event server.
+ *    Each connection is registered with EPOLLONESHOT, so at any point in time
+ *    it is touched either by its reactor or by exactly one worker.
+ */
+struct EventConnection {
+  int sock_fd;                  // client socket
+  int epoll_fd;                 // epoll instance of the owning reactor
+  SocketManager<PktBuf> sock;   // buffered writer for the responses
+  PacketManager manager;        // protocol state of this session
+
+  PktBuf rbuf;                  // bytes received but not yet parsed
+  size_t rbuf_ptr;              // parse cursor into rbuf
+
+  // complete packets waiting to be executed by a worker
+  std::deque<std::unique_ptr<Packet>> packets;
+
+  bool startup_parsed;          // reactor has seen the startup packet
+  bool startup_processed;       // worker has processed the startup packet
+  bool closed;                  // peer hung up or the socket failed
+
+  inline EventConnection(int sock_fd, int epoll_fd)
+      : sock_fd(sock_fd),
+        epoll_fd(epoll_fd),
+        sock(sock_fd),
+        manager(&sock),
+        rbuf_ptr(0),
+        startup_parsed(false),
+        startup_processed(false),
+        closed(false) {}
+};
+
+/*
+ * EventServer - Multi-reactor front end for the wire protocol.
+ *    A fixed set of I/O threads read from non-blocking sockets with epoll and
+ *    cut the byte stream into packets. Connections with complete packets are
+ *    handed to a bounded pool of worker threads that execute the queries.
+ *    At most "max_in_flight" connections are queued or executing at once,
+ *    further readable connections are parked without blocking the reactors.
+ */
+class EventServer {
+ public:
+  EventServer(const EventServer &) = delete;
+  EventServer &operator=(const EventServer &) = delete;
+
+  EventServer(Server *server, size_t io_thread_count,
+              size_t worker_thread_count, size_t max_in_flight);
+
+  ~EventServer();
+
+  // Server's accept loop, returns once Stop() is invoked
+  void Run();
+
+  // Signal all the threads to wind down
+  void Stop();
+
+  size_t GetConnectionCount() const { return connection_count_.load(); }
+
+  size_t GetInFlightCount() const { return in_flight_.load(); }
+
+ private:
+  void ReactorLoop(size_t reactor_id);
+
+  void WorkerLoop();
+
+  // Register a freshly accepted socket with one of the reactors
+  void AddConnection(int sock_fd);
+
+  // Drain the socket and parse all complete packets, returns false on EOF
+  // or on a malformed packet
+  bool ReadConnection(EventConnection *conn);
+
+  // Execute the pending packets of a connection on a worker
+  void ProcessConnection(EventConnection *conn);
+
+  // Re-arm the one-shot readiness notification of a connection
+  void ArmConnection(EventConnection *conn);
+
+  void CloseConnection(EventConnection *conn);
+
+  // Admission control on the worker pool
+  void SubmitConnection(EventConnection *conn);
+
+  Server *server_;
+
+  size_t io_thread_count_;
+
+  size_t worker_thread_count_;
+
+  size_t max_in_flight_;
+
+  std::atomic<bool> is_running_;
+
+  // one epoll instance per reactor
+  std::vector<int> epoll_fds_;
+
+  std::vector<std::thread> reactor_threads_;
+
+  std::vector<std::thread> worker_threads_;
+
+  // round robin cursor for assigning connections to reactors
+  size_t next_reactor_;
+
+  // connections waiting for a worker
+  std::deque<EventConnection *> ready_queue_;
+
+  std::mutex ready_queue_mutex_;
+
+  std::condition_variable ready_queue_cv_;
+
+  // connections with packets, waiting for an in flight slot
+  std::deque<EventConnection *> parked_queue_;
+
+  // connections queued or being executed
+  std::atomic<size_t> in_flight_;
+
+  // all live connections, needed to clean up at shutdown
+  std::unordered_set<EventConnection *> connections_;
+
+  std::mutex connections_mutex_;
+
+  std::atomic<size_t> connection_count_;
+};
+
+}  // End wire namespace
+}  // End peloton namespace
@@ -20,7 +20,15 @@
 #include "wire/wire.h"
 #include "common/logger.h"
 
+// largest packet a client may send, the length field included
+#define MAX_PACKET_SIZE (1 << 30)
+
 namespace peloton {
+
+namespace executor {
+class LogicalTile;
+}
+
 namespace wire {
 
 typedef unsigned char uchar;
@@ -47,6 +55,15 @@ extern void PacketPutCbytes(std::unique_ptr<Packet> &pkt, const uchar *b,
 extern void PacketPutBytes(std::unique_ptr<Packet> &pkt,
                            const std::vector<uchar> &data);
 
+/*
+ * packet_put_data_rows - used to write a DataRow packet for every visible
+ * 		tuple of a result tile. The fields are encoded as text straight from
+ * 		the base tiles, without materializing the tile. Returns the number
+ * 		of rows written.
+ */
+extern size_t PacketPutDataRows(executor::LogicalTile *result_tile,
+                                ResponseBuffer &responses);
+
 /*
  * Unmarshallers
  */
@@ -84,5 +101,20 @@ extern bool WritePackets(std::vector<std::unique_ptr<Packet>> &packets,
 /* Read a single packet from the socket read buffer */
 extern bool ReadPacket(Packet *pkt, bool has_type_field, Client *client);
 
+enum ParseResult {
+  PARSE_RESULT_COMPLETE,
+  PARSE_RESULT_PARTIAL,
+  // the length field is out of range, the connection must be closed
+  PARSE_RESULT_MALFORMED
+};
+
+/*
+ * Non-blocking unmarshaller used by the event server. Extracts one complete
+ * packet starting at "rbuf_ptr" of "rbuf", advancing the cursor past it.
+ * Leaves the cursor untouched unless the packet is complete.
+ */
+extern ParseResult ParsePacket(const PktBuf &rbuf, size_t &rbuf_ptr,
+                               Packet *pkt, bool has_type_field);
+
 }  // End wire namespace
 }  // End peloton namespace
@@ -33,6 +33,8 @@
 #define SOCKET_BUFFER_SIZE 8192
 #define MAX_CONNECTIONS 64
 #define DEFAULT_PORT 5432
+// how long (ms) a full socket may block a flush before the client is dropped
+#define SOCKET_WRITE_TIMEOUT 30000
 
 DECLARE_uint64(port);
 DECLARE_uint64(max_connections);
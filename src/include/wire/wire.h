@@ -77,6 +77,12 @@ class PacketManager {
   // gloabl txn state
   uchar txn_state;
 
+  // Prepared statements of this session
+  Cache<std::string, Statement> statement_cache_;
+
+  // Query portals of this session
+  std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
+
   // state to mang skipped queries
   bool skipped_stmt_ = false;
   std::string skipped_query_string_;
@@ -100,8 +106,9 @@ class PacketManager {
   void PutTupleDescriptor(const std::vector<FieldInfoType>& tuple_descriptor,
                           ResponseBuffer& responses);
 
-  // Send each row, one packet at a time, used by SELECT queries
-  void SendDataRows(std::vector<ResultType>& results, int colcount,
+  // Send the DataRow packets encoded from the result tiles, used by SELECT
+  // queries
+  void SendDataRows(ResponseBuffer& data_rows, size_t row_count,
                     int& rows_affected, ResponseBuffer& responses);
 
   // Used to send a packet that indicates the completion of a query. Also has
@@ -157,6 +164,10 @@ class PacketManager {
   /* Protocol manager */
   void ManagePackets();
 
+  /* Process a single packet handed over by the event server and write back
+   * its responses. Returns false if the session needs to be closed */
+  bool HandlePacket(Packet* pkt, bool is_startup);
+
 };
 
 }  // End wire namespace
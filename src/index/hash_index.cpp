@@ -0,0 +1,339 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_index.cpp
+//
+// Identification: src/index/hash_index.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "index/hash_index.h"
+#include "index/index_key.h"
+#include "common/logger.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace index {
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+          KeyEqualityChecker>::HashIndex(IndexMetadata *metadata)
+    : Index(metadata),
+      container(),
+      equals(),
+      comparator(),
+      indexed_tile_group_offset_(-1) {}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+          KeyEqualityChecker>::~HashIndex() {
+  // we should not rely on shared_ptr to reclaim memory.
+  // memory allocated should be managed carefully by programmers.
+  auto locked_table = container.lock_table();
+  for (auto &entry : locked_table) {
+    for (auto location : entry.second) {
+      delete location;
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::InsertEntry(const storage::Tuple *key,
+                                                const ItemPointer &location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  ItemPointer *location_ptr = new ItemPointer(location);
+
+  // Append to the locations of the key, or add the key
+  container.upsert(index_key,
+                   [location_ptr](std::vector<ValueType> &locations) {
+                     locations.push_back(location_ptr);
+                   },
+                   std::vector<ValueType>(1, location_ptr));
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::DeleteEntry(const storage::Tuple *key,
+                                                const ItemPointer &location) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // Delete the < key, location > pairs, and the key with its last location.
+  // Both happen under the bucket locks, so an insert of the same key either
+  // comes before and keeps the key, or after and adds it again. Scans only
+  // dereference the item pointers under the same locks.
+  container.erase_fn(index_key, [&location](std::vector<ValueType> &locations) {
+    size_t kept_count = 0;
+    for (auto location_ptr : locations) {
+      if ((location_ptr->block == location.block) &&
+          (location_ptr->offset == location.offset)) {
+        delete location_ptr;
+      } else {
+        locations[kept_count++] = location_ptr;
+      }
+    }
+    locations.resize(kept_count);
+    return locations.empty();
+  });
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::
+    CondInsertEntry(const storage::Tuple *key, const ItemPointer &location,
+                    std::function<bool(const ItemPointer &)> predicate) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  ItemPointer *location_ptr = new ItemPointer(location);
+  bool inserted = true;
+
+  // The check and the append happen under the bucket locks
+  container.upsert(index_key,
+                   [&](std::vector<ValueType> &locations) {
+                     for (auto existing_location : locations) {
+                       if (predicate(*existing_location)) {
+                         // this key is already visible or dirty in the index
+                         inserted = false;
+                         return;
+                       }
+                     }
+                     inserted = true;
+                     locations.push_back(location_ptr);
+                   },
+                   std::vector<ValueType>(1, location_ptr));
+
+  if (inserted == false) {
+    delete location_ptr;
+  }
+
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+bool HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::
+    ConstructEqualityKey(const std::vector<Value> &values,
+                         const std::vector<oid_t> &key_column_ids,
+                         const std::vector<ExpressionType> &expr_types,
+                         storage::Tuple &key) {
+  auto key_column_count = metadata->GetKeySchema()->GetColumnCount();
+  std::vector<bool> bound_columns(key_column_count, false);
+
+  for (size_t column_itr = 0; column_itr < key_column_ids.size();
+       column_itr++) {
+    auto key_column_id = key_column_ids[column_itr];
+
+    if (expr_types[column_itr] == EXPRESSION_TYPE_COMPARE_EQUAL &&
+        key_column_id < key_column_count) {
+      key.SetValue(key_column_id, values[column_itr], GetPool());
+      bound_columns[key_column_id] = true;
+    }
+  }
+
+  for (auto bound_column : bound_columns) {
+    if (bound_column == false) return false;
+  }
+
+  return true;
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::Scan(const std::vector<Value> &values,
+                                         const std::vector<oid_t> &
+                                             key_column_ids,
+                                         const std::vector<ExpressionType> &
+                                             expr_types,
+                                         const ScanDirectionType &
+                                             scan_direction,
+                                         std::vector<ItemPointer> &result) {
+  // copied while the bucket locks keep deletes from freeing them
+  ScanLocations(values, key_column_ids, expr_types, scan_direction,
+                [&result](ItemPointer *location) {
+                  result.push_back(*location);
+                });
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::ScanAllKeys(std::vector<ItemPointer> &
+                                                    result) {
+  auto locked_table = container.lock_table();
+  for (auto &entry : locked_table) {
+    for (auto location : entry.second) {
+      result.push_back(*location);
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::ScanKey(const storage::Tuple *key,
+                                            std::vector<ItemPointer> &result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container.update_fn(index_key, [&result](std::vector<ValueType> &locations) {
+    for (auto location : locations) {
+      result.push_back(*location);
+    }
+  });
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::Scan(const std::vector<Value> &values,
+                                         const std::vector<oid_t> &
+                                             key_column_ids,
+                                         const std::vector<ExpressionType> &
+                                             expr_types,
+                                         const ScanDirectionType &
+                                             scan_direction,
+                                         std::vector<ItemPointer *> &result) {
+  ScanLocations(values, key_column_ids, expr_types, scan_direction,
+                [&result](ItemPointer *location) {
+                  result.push_back(location);
+                });
+
+  LOG_TRACE("Scan matched tuple count : %lu", result.size());
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::
+    ScanLocations(const std::vector<Value> &values,
+                  const std::vector<oid_t> &key_column_ids,
+                  const std::vector<ExpressionType> &expr_types,
+                  const ScanDirectionType &scan_direction,
+                  std::function<void(ItemPointer *)> emit) {
+  switch (scan_direction) {
+    case SCAN_DIRECTION_TYPE_FORWARD:
+    case SCAN_DIRECTION_TYPE_BACKWARD:
+      break;
+
+    case SCAN_DIRECTION_TYPE_INVALID:
+    default:
+      throw Exception("Invalid scan direction ");
+      break;
+  }
+
+  // Point lookup when the predicates fix the whole key, the remaining
+  // predicates on the key columns are still checked below
+  std::unique_ptr<storage::Tuple> equality_key(
+      new storage::Tuple(metadata->GetKeySchema(), true));
+  if (ConstructEqualityKey(values, key_column_ids, expr_types,
+                           *equality_key) == true) {
+    LOG_TRACE("Point lookup : %s", equality_key->GetInfo().c_str());
+
+    KeyType index_key;
+    index_key.SetFromKey(equality_key.get());
+
+    if (Compare(*equality_key, key_column_ids, expr_types, values) == false) {
+      return;
+    }
+
+    container.update_fn(index_key,
+                        [&emit](std::vector<ValueType> &key_locations) {
+                          for (auto location : key_locations) {
+                            emit(location);
+                          }
+                        });
+
+    return;
+  }
+
+  // Otherwise go over every key
+  auto locked_table = container.lock_table();
+  for (auto &entry : locked_table) {
+    KeyType index_key = entry.first;
+    auto tuple = index_key.GetTupleForComparison(metadata->GetKeySchema());
+
+    // Compare the current key in the scan with "values" based on
+    // "expression types"
+    // For instance, "5" EXPR_GREATER_THAN "2" is true
+    if (Compare(tuple, key_column_ids, expr_types, values) == true) {
+      for (auto location : entry.second) {
+        emit(location);
+      }
+    }
+  }
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::ScanAllKeys(std::vector<ItemPointer *> &
+                                                    result) {
+  // scan all entries
+  auto locked_table = container.lock_table();
+  for (auto &entry : locked_table) {
+    result.insert(result.end(), entry.second.begin(), entry.second.end());
+  }
+}
+
+/**
+ * @brief Return all locations related to this key.
+ */
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+void HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+               KeyEqualityChecker>::ScanKey(const storage::Tuple *key,
+                                            std::vector<ItemPointer *> &
+                                                result) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  // find the <key, location> pairs
+  container.update_fn(index_key, [&result](std::vector<ValueType> &locations) {
+    result.insert(result.end(), locations.begin(), locations.end());
+  });
+}
+
+template <typename KeyType, typename ValueType, class KeyHasher,
+          class KeyComparator, class KeyEqualityChecker>
+std::string HashIndex<KeyType, ValueType, KeyHasher, KeyComparator,
+                      KeyEqualityChecker>::GetTypeName() const {
+  return "Hash";
+}
+
+// Explicit template instantiation
+
+template class HashIndex<GenericKey<4>, ItemPointer *, GenericHasher<4>,
+                         GenericComparator<4>, GenericEqualityChecker<4>>;
+template class HashIndex<GenericKey<8>, ItemPointer *, GenericHasher<8>,
+                         GenericComparator<8>, GenericEqualityChecker<8>>;
+template class HashIndex<GenericKey<16>, ItemPointer *, GenericHasher<16>,
+                         GenericComparator<16>, GenericEqualityChecker<16>>;
+template class HashIndex<GenericKey<64>, ItemPointer *, GenericHasher<64>,
+                         GenericComparator<64>, GenericEqualityChecker<64>>;
+template class HashIndex<GenericKey<256>, ItemPointer *, GenericHasher<256>,
+                         GenericComparator<256>, GenericEqualityChecker<256>>;
+
+template class HashIndex<TupleKey, ItemPointer *, TupleKeyHasher,
+                         TupleKeyComparator, TupleKeyEqualityChecker>;
+
+}  // End index namespace
+}  // End peloton namespace
@@ -20,6 +20,8 @@
 #include "index/index_key.h"
 #include "index/btree_index.h"
 #include "index/skip_list_index.h"
+#include "index/bwtree_index.h"
+#include "index/hash_index.h"
 
 namespace peloton {
 namespace index {
@@ -85,6 +87,63 @@ Index *IndexFactory::GetInstance(IndexMetadata *metadata) {
     }
   }
 
+  if (index_type == INDEX_TYPE_BWTREE) {
+
+    if (key_size <= 4) {
+      return new BWTreeIndex<GenericKey<4>, ItemPointer *,
+                             GenericComparatorRaw<4>,
+                             GenericEqualityChecker<4>>(metadata);
+    } else if (key_size <= 8) {
+      return new BWTreeIndex<GenericKey<8>, ItemPointer *,
+                             GenericComparatorRaw<8>,
+                             GenericEqualityChecker<8>>(metadata);
+    } else if (key_size <= 16) {
+      return new BWTreeIndex<GenericKey<16>, ItemPointer *,
+                             GenericComparatorRaw<16>,
+                             GenericEqualityChecker<16>>(metadata);
+    } else if (key_size <= 64) {
+      return new BWTreeIndex<GenericKey<64>, ItemPointer *,
+                             GenericComparatorRaw<64>,
+                             GenericEqualityChecker<64>>(metadata);
+    } else if (key_size <= 256) {
+      return new BWTreeIndex<GenericKey<256>, ItemPointer *,
+                             GenericComparatorRaw<256>,
+                             GenericEqualityChecker<256>>(metadata);
+    } else {
+      return new BWTreeIndex<TupleKey, ItemPointer *, TupleKeyComparatorRaw,
+                             TupleKeyEqualityChecker>(metadata);
+    }
+  }
+
+  if (index_type == INDEX_TYPE_HASH) {
+
+    if (key_size <= 4) {
+      return new HashIndex<GenericKey<4>, ItemPointer *, GenericHasher<4>,
+                           GenericComparator<4>, GenericEqualityChecker<4>>(
+          metadata);
+    } else if (key_size <= 8) {
+      return new HashIndex<GenericKey<8>, ItemPointer *, GenericHasher<8>,
+                           GenericComparator<8>, GenericEqualityChecker<8>>(
+          metadata);
+    } else if (key_size <= 16) {
+      return new HashIndex<GenericKey<16>, ItemPointer *, GenericHasher<16>,
+                           GenericComparator<16>, GenericEqualityChecker<16>>(
+          metadata);
+    } else if (key_size <= 64) {
+      return new HashIndex<GenericKey<64>, ItemPointer *, GenericHasher<64>,
+                           GenericComparator<64>, GenericEqualityChecker<64>>(
+          metadata);
+    } else if (key_size <= 256) {
+      return new HashIndex<GenericKey<256>, ItemPointer *, GenericHasher<256>,
+                           GenericComparator<256>,
+                           GenericEqualityChecker<256>>(metadata);
+    } else {
+      return new HashIndex<TupleKey, ItemPointer *, TupleKeyHasher,
+                           TupleKeyComparator, TupleKeyEqualityChecker>(
+          metadata);
+    }
+  }
+
 
   throw IndexException("Unsupported index scheme.");
   return NULL;
@@ -117,6 +117,11 @@ void BackendLogger::Log(LogRecord *record) {
     }
   }
 
+  // the frontend logger sizes its commit groups by these
+  if (record->GetType() == LOGRECORD_TYPE_TRANSACTION_COMMIT) {
+    log_buffer_->IncrementCommitCount();
+  }
+
   this->log_buffer_lock.Unlock();
 }
 
@@ -15,9 +15,11 @@
 #include "logging/checkpoint.h"
 #include "logging/logging_util.h"
 #include "logging/checkpoint/simple_checkpoint.h"
+#include "logging/checkpoint/fuzzy_checkpoint.h"
 #include "logging/log_manager.h"
 #include "logging/checkpoint_manager.h"
 #include "logging/backend_logger.h"
+#include "optimizer/table_write_stats.h"
 #include "storage/tile.h"
 #include "storage/database.h"
 #include "storage/tile_group.h"
@@ -102,9 +104,13 @@ std::unique_ptr<Checkpoint> Checkpoint::GetCheckpoint(
   if (checkpoint_type == CHECKPOINT_TYPE_NORMAL) {
     std::unique_ptr<Checkpoint> checkpoint(
         new SimpleCheckpoint(disable_file_access));
-    return std::move(checkpoint);
+    return checkpoint;
+  } else if (checkpoint_type == CHECKPOINT_TYPE_FUZZY) {
+    std::unique_ptr<Checkpoint> checkpoint(
+        new FuzzyCheckpoint(disable_file_access));
+    return checkpoint;
   }
-  return std::move(std::unique_ptr<Checkpoint>(nullptr));
+  return std::unique_ptr<Checkpoint>(nullptr);
 }
 
 void Checkpoint::RecoverTuple(storage::Tuple *tuple, storage::DataTable *table,
@@ -133,6 +139,9 @@ void Checkpoint::RecoverTuple(storage::Tuple *tuple, storage::DataTable *table,
   } else {
     // TODO this is not thread safe
     table->SetNumberOfTuples(table->GetNumberOfTuples() + 1);
+    if (table->GetWriteStats() != nullptr) {
+      table->GetWriteStats()->AddTuple(tuple);
+    }
   }
 }
 
@@ -0,0 +1,194 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// block_compressor.cpp
+//
+// Identification: src/logging/checkpoint/block_compressor.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <cstdint>
+#include <cstring>
+
+#include "logging/checkpoint/block_compressor.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+const int hash_bits = 12;
+
+const size_t min_match = 4;
+
+// the format ends every block with literals, and no match may start within
+// the last 12 bytes
+const size_t last_literals = 5;
+
+const size_t match_start_limit = 12;
+
+const size_t max_offset = 65535;
+
+// token nibbles saturate at 15, longer lengths continue in extra bytes
+const size_t run_mask = 15;
+
+inline uint32_t Read32(const char *ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) {
+  return (sequence * 2654435761U) >> (32 - hash_bits);
+}
+
+inline char *WriteLength(char *op, size_t length) {
+  while (length >= 255) {
+    *op++ = static_cast<char>(255);
+    length -= 255;
+  }
+  *op++ = static_cast<char>(length);
+  return op;
+}
+
+// Returns false when the length runs past the end of the input
+inline bool ReadLength(const unsigned char *src, size_t src_size, size_t &ip,
+                       size_t &length) {
+  unsigned char byte;
+  do {
+    if (ip >= src_size) return false;
+    byte = src[ip++];
+    length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+char *WriteSequence(char *op, const char *literals, size_t literal_length) {
+  if (literal_length >= run_mask) {
+    *op++ = static_cast<char>(run_mask << 4);
+    op = WriteLength(op, literal_length - run_mask);
+  } else {
+    *op++ = static_cast<char>(literal_length << 4);
+  }
+  memcpy(op, literals, literal_length);
+  return op + literal_length;
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Block Compressor
+//===--------------------------------------------------------------------===//
+
+size_t BlockCompressor::Compress(const char *src, size_t src_size, char *dst,
+                                 size_t dst_capacity) {
+  if (dst_capacity < GetMaxCompressedSize(src_size)) return 0;
+
+  char *op = dst;
+  size_t anchor = 0;
+
+  if (src_size > match_start_limit) {
+    // positions of the last sequence seen with each hash
+    int32_t table[1 << hash_bits];
+    memset(table, -1, sizeof(table));
+
+    size_t match_end_limit = src_size - last_literals;
+    size_t ip = 0;
+    while (ip + match_start_limit <= src_size) {
+      uint32_t sequence = Read32(src + ip);
+      auto &entry = table[Hash(sequence)];
+      int32_t ref = entry;
+      entry = static_cast<int32_t>(ip);
+
+      if (ref < 0 || ip - ref > max_offset || Read32(src + ref) != sequence) {
+        ip++;
+        continue;
+      }
+
+      size_t match_length = min_match;
+      while (ip + match_length < match_end_limit &&
+             src[ref + match_length] == src[ip + match_length]) {
+        match_length++;
+      }
+
+      // the token is written with the literals, patch in the match length
+      char *token = op;
+      op = WriteSequence(op, src + anchor, ip - anchor);
+
+      size_t offset = ip - ref;
+      *op++ = static_cast<char>(offset & 0xFF);
+      *op++ = static_cast<char>(offset >> 8);
+
+      size_t extra_length = match_length - min_match;
+      if (extra_length >= run_mask) {
+        *token |= static_cast<char>(run_mask);
+        op = WriteLength(op, extra_length - run_mask);
+      } else {
+        *token |= static_cast<char>(extra_length);
+      }
+
+      ip += match_length;
+      anchor = ip;
+    }
+  }
+
+  // the block ends with a literal only sequence
+  op = WriteSequence(op, src + anchor, src_size - anchor);
+  return op - dst;
+}
+
+bool BlockCompressor::Decompress(const char *src, size_t src_size, char *dst,
+                                 size_t dst_size) {
+  auto input = reinterpret_cast<const unsigned char *>(src);
+  size_t ip = 0;
+  size_t op = 0;
+
+  while (true) {
+    if (ip >= src_size) return false;
+    unsigned char token = input[ip++];
+
+    size_t literal_length = token >> 4;
+    if (literal_length == run_mask &&
+        ReadLength(input, src_size, ip, literal_length) == false) {
+      return false;
+    }
+    if (literal_length > src_size - ip || literal_length > dst_size - op) {
+      return false;
+    }
+    memcpy(dst + op, src + ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+
+    // the last sequence has no match
+    if (ip == src_size) break;
+
+    if (src_size - ip < 2) return false;
+    size_t offset = input[ip] | (input[ip + 1] << 8);
+    ip += 2;
+    if (offset == 0 || offset > op) return false;
+
+    size_t match_length = token & run_mask;
+    if (match_length == run_mask &&
+        ReadLength(input, src_size, ip, match_length) == false) {
+      return false;
+    }
+    match_length += min_match;
+    if (match_length > dst_size - op) return false;
+
+    // matches may overlap their own output
+    const char *match = dst + op - offset;
+    for (size_t itr = 0; itr < match_length; itr++) {
+      dst[op + itr] = match[itr];
+    }
+    op += match_length;
+  }
+
+  return op == dst_size;
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -0,0 +1,551 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// fuzzy_checkpoint.cpp
+//
+// Identification: src/logging/checkpoint/fuzzy_checkpoint.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <dirent.h>
+#include <stdio.h>
+#include <cstring>
+
+#include "logging/checkpoint/fuzzy_checkpoint.h"
+#include "logging/checkpoint/block_compressor.h"
+#include "logging/checkpoint_tile_scanner.h"
+#include "logging/checkpoint_manager.h"
+#include "logging/log_manager.h"
+#include "logging/logging_util.h"
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "common/thread_pool.h"
+#include "concurrency/epoch_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "optimizer/table_write_stats.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace logging {
+
+namespace {
+
+// database oid, table oid, tile group id, tuple count, raw size and
+// compressed size
+const size_t block_header_size = 6 * sizeof(int32_t);
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Fuzzy Checkpoint
+//===--------------------------------------------------------------------===//
+
+FuzzyCheckpoint::FuzzyCheckpoint(bool disable_file_access)
+    : Checkpoint(disable_file_access) {
+  InitDirectory();
+  InitVersionNumber();
+}
+
+void FuzzyCheckpoint::DoCheckpoint() {
+  // Hold an epoch as a reader of the snapshot so that neither the GC nor
+  // the compressor reclaims a version the scan may still read. Every txn up
+  // to the max dead txn cid has installed its versions.
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto epoch = epoch_manager.EnterEpoch(
+      [&txn_manager] { return txn_manager.GetMaxCommittedCid(); },
+      start_commit_id_);
+
+  LOG_TRACE("DoCheckpoint cid = %lu", start_commit_id_);
+
+  // Collect the tile groups that exist at the snapshot, later ones only
+  // hold newer versions
+  std::vector<ScanItem> items;
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  auto database_count = catalog_manager.GetDatabaseCount();
+  for (oid_t database_idx = 0; database_idx < database_count; database_idx++) {
+    auto database = catalog_manager.GetDatabase(database_idx);
+    auto table_count = database->GetTableCount();
+    for (oid_t table_idx = 0; table_idx < table_count; table_idx++) {
+      storage::DataTable *target_table = database->GetTable(table_idx);
+      PL_ASSERT(target_table);
+      auto tile_group_count = target_table->GetTileGroupCount();
+      for (oid_t tile_group_offset = START_OID;
+           tile_group_offset < tile_group_count; tile_group_offset++) {
+        auto tile_group = target_table->GetTileGroup(tile_group_offset);
+        if (tile_group == nullptr) continue;
+        items.push_back({database->GetOid(), target_table, tile_group});
+      }
+    }
+  }
+
+  checkpoint_version++;
+  data_files_.clear();
+  tuple_count_ = 0;
+
+  std::atomic<size_t> next_item(0);
+  int file_count = std::max(peloton_checkpoint_thread_count, 1);
+  bool success = true;
+  if (file_count == 1) {
+    success = ScanTileGroups(items, next_item, 0, tuple_count_);
+  } else {
+    ThreadPool scan_pool(file_count);
+    std::vector<size_t> tuple_counts(file_count, 0);
+    std::vector<std::future<bool>> futures;
+    for (int file_id = 0; file_id < file_count; file_id++) {
+      futures.push_back(scan_pool.Enqueue(
+          &FuzzyCheckpoint::ScanTileGroups, this, std::cref(items),
+          std::ref(next_item), file_id, std::ref(tuple_counts[file_id])));
+    }
+    for (int file_id = 0; file_id < file_count; file_id++) {
+      success &= futures[file_id].get();
+      tuple_count_ += tuple_counts[file_id];
+    }
+  }
+
+  items.clear();
+  epoch_manager.ExitEpoch(epoch);
+
+  for (int file_id = 0; file_id < file_count; file_id++) {
+    data_files_.push_back(GetDataFileName(checkpoint_version, file_id));
+  }
+
+  // A checkpoint counts once its manifest is in place
+  if (success == false || WriteManifest(start_commit_id_, file_count) == false) {
+    LOG_ERROR("Fuzzy checkpoint %d failed", checkpoint_version);
+    if (!disable_file_access) {
+      for (auto &file_name : data_files_) {
+        remove((checkpoint_dir + "/" + file_name).c_str());
+      }
+    }
+    checkpoint_version--;
+    return;
+  }
+
+  Cleanup();
+  most_recent_checkpoint_cid = start_commit_id_;
+}
+
+bool FuzzyCheckpoint::ScanTileGroups(const std::vector<ScanItem> &items,
+                                     std::atomic<size_t> &next_item,
+                                     int file_id, size_t &tuple_count) {
+  FileHandle file_handle;
+  if (!disable_file_access) {
+    auto file_name =
+        checkpoint_dir + "/" + GetDataFileName(checkpoint_version, file_id);
+    if (!LoggingUtil::InitFileHandle(file_name.c_str(), file_handle, "wb")) {
+      return false;
+    }
+  }
+
+  // reused across tile groups
+  std::vector<CopySerializeOutput> columns;
+  CopySerializeOutput block;
+  CopySerializeOutput header;
+  std::vector<char> compressed;
+
+  bool success = true;
+  while (true) {
+    auto item_itr = next_item.fetch_add(1);
+    if (item_itr >= items.size()) break;
+
+    auto &item = items[item_itr];
+    auto block_tuple_count =
+        SerializeTileGroup(item, start_commit_id_, columns, block);
+    if (block_tuple_count == 0) continue;
+    tuple_count += block_tuple_count;
+
+    if (disable_file_access) continue;
+
+    compressed.resize(BlockCompressor::GetMaxCompressedSize(block.Size()));
+    auto compressed_size = BlockCompressor::Compress(
+        block.Data(), block.Size(), compressed.data(), compressed.size());
+
+    header.Reset();
+    header.WriteInt(item.database_oid);
+    header.WriteInt(item.table->GetOid());
+    header.WriteInt(item.tile_group->GetTileGroupId());
+    header.WriteInt(block_tuple_count);
+    header.WriteInt(block.Size());
+    header.WriteInt(compressed_size);
+
+    if (fwrite(header.Data(), 1, header.Size(), file_handle.file) !=
+            header.Size() ||
+        fwrite(compressed.data(), 1, compressed_size, file_handle.file) !=
+            compressed_size) {
+      LOG_ERROR("Failed to write checkpoint block: %s", strerror(errno));
+      success = false;
+      break;
+    }
+  }
+
+  if (!disable_file_access) {
+    LoggingUtil::FFlushFsync(file_handle);
+    fclose(file_handle.file);
+  }
+  return success;
+}
+
+oid_t FuzzyCheckpoint::SerializeTileGroup(
+    const ScanItem &item, cid_t start_cid,
+    std::vector<CopySerializeOutput> &columns, CopySerializeOutput &block) {
+  auto tile_group = item.tile_group.get();
+  auto tile_group_header = tile_group->GetHeader();
+  auto column_count = item.table->GetSchema()->GetColumnCount();
+
+  if (columns.size() < column_count) {
+    columns = std::vector<CopySerializeOutput>(column_count);
+  }
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    columns[column_itr].Reset();
+  }
+  block.Reset();
+
+  // Slots go straight into the block, values into their column
+  CheckpointTileScanner scanner;
+  oid_t tuple_count = 0;
+  auto active_tuple_count = tile_group_header->GetCurrentNextTupleSlot();
+  for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+    if (!scanner.IsVisible(tile_group_header, tuple_id, start_cid)) continue;
+
+    block.WriteInt(tuple_id);
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      tile_group->GetValue(tuple_id, column_itr)
+          .SerializeTo(columns[column_itr]);
+    }
+    tuple_count++;
+  }
+
+  if (tuple_count == 0) return 0;
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    block.WriteInt(columns[column_itr].Size());
+  }
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    block.WriteBytes(columns[column_itr].Data(), columns[column_itr].Size());
+  }
+  return tuple_count;
+}
+
+cid_t FuzzyCheckpoint::DoRecovery() {
+  // No checkpoint to recover from
+  if (checkpoint_version < 0) {
+    return 0;
+  }
+
+  cid_t commit_id;
+  std::vector<std::string> file_names;
+  if (ReadManifest(commit_id, file_names) == false) {
+    LOG_ERROR("Failed to read checkpoint manifest %d", checkpoint_version);
+    return 0;
+  }
+
+  // Files hold disjoint tile groups, load one per thread
+  std::vector<oid_t> max_oids;
+  if (peloton_checkpoint_thread_count <= 1) {
+    for (auto &file_name : file_names) {
+      max_oids.push_back(RecoverDataFile(file_name, commit_id));
+    }
+  } else {
+    ThreadPool recovery_pool(peloton_checkpoint_thread_count);
+    std::vector<std::future<oid_t>> futures;
+    for (auto &file_name : file_names) {
+      futures.push_back(recovery_pool.Enqueue(&FuzzyCheckpoint::RecoverDataFile,
+                                              file_name, commit_id));
+    }
+    for (auto &future : futures) {
+      max_oids.push_back(future.get());
+    }
+  }
+
+  oid_t max_oid = 0;
+  bool success = true;
+  for (auto oid : max_oids) {
+    if (oid == INVALID_OID) {
+      success = false;
+      continue;
+    }
+    max_oid = std::max(max_oid, oid);
+  }
+
+  // After finishing recovery, set the next oid with maximum oid
+  // observed during the recovery
+  auto &manager = catalog::Manager::GetInstance();
+  if (max_oid > manager.GetNextOid()) {
+    manager.SetNextOid(max_oid);
+  }
+
+  // The log before the checkpoint is truncated, the tuples of a corrupt file
+  // are gone. Neither the cids nor the log replay may take it as recovered.
+  if (success == false) {
+    LOG_ERROR("Corrupt data file in checkpoint %d, it cannot be recovered",
+              checkpoint_version);
+    CheckpointManager::GetInstance().SetRecoveryFailed(true);
+    return INVALID_CID;
+  }
+
+  // The log is replayed after the checkpoint cid only
+  concurrency::TransactionManagerFactory::GetInstance().SetNextCid(commit_id);
+  CheckpointManager::GetInstance().SetRecoveredCid(commit_id);
+  most_recent_checkpoint_cid = commit_id;
+  return commit_id;
+}
+
+oid_t FuzzyCheckpoint::RecoverDataFile(const std::string &file_name,
+                                       cid_t commit_id) {
+  FileHandle file_handle;
+  if (!LoggingUtil::InitFileHandle(file_name.c_str(), file_handle, "rb")) {
+    return INVALID_OID;
+  }
+
+  // Data files are read whole, a block at a time would not save much
+  size_t file_size = LoggingUtil::GetLogFileSize(file_handle);
+  std::unique_ptr<char[]> file_data(new char[file_size]);
+  size_t read_size = fread(file_data.get(), 1, file_size, file_handle.file);
+  fclose(file_handle.file);
+  if (read_size != file_size) {
+    return INVALID_OID;
+  }
+
+  oid_t max_oid = 0;
+  std::vector<char> block;
+  size_t position = 0;
+  while (position < file_size) {
+    if (file_size - position < block_header_size) return INVALID_OID;
+
+    ReferenceSerializeInputBE header(file_data.get() + position,
+                                     block_header_size);
+    oid_t database_oid = header.ReadInt();
+    oid_t table_oid = header.ReadInt();
+    oid_t tile_group_id = header.ReadInt();
+    oid_t tuple_count = header.ReadInt();
+    size_t raw_size = header.ReadInt();
+    size_t compressed_size = header.ReadInt();
+    position += block_header_size;
+
+    // A corrupt header must not turn into a huge allocation
+    if (file_size - position < compressed_size ||
+        raw_size > BlockCompressor::GetMaxDecompressedSize(compressed_size) ||
+        static_cast<size_t>(tuple_count) * sizeof(int32_t) > raw_size) {
+      return INVALID_OID;
+    }
+    block.resize(raw_size);
+    if (!BlockCompressor::Decompress(file_data.get() + position,
+                                     compressed_size, block.data(),
+                                     raw_size)) {
+      return INVALID_OID;
+    }
+    position += compressed_size;
+
+    // A fresh pool per block bounds the memory of the copied varlens
+    VarlenPool pool(BACKEND_TYPE_MM);
+    if (!RecoverBlock(block.data(), raw_size, database_oid, table_oid,
+                      tile_group_id, tuple_count, &pool, commit_id)) {
+      return INVALID_OID;
+    }
+    max_oid = std::max(max_oid, tile_group_id);
+  }
+
+  return max_oid;
+}
+
+bool FuzzyCheckpoint::RecoverBlock(const char *data, size_t size,
+                                   oid_t database_oid, oid_t table_oid,
+                                   oid_t tile_group_id, oid_t tuple_count,
+                                   VarlenPool *pool, cid_t commit_id) {
+  auto &manager = catalog::Manager::GetInstance();
+  auto database = manager.GetDatabaseWithOid(database_oid);
+  if (database == nullptr) return true;
+  auto table = database->GetTableWithOid(table_oid);
+  if (table == nullptr) {
+    // the table was dropped
+    return true;
+  }
+
+  auto schema = table->GetSchema();
+  oid_t column_count = schema->GetColumnCount();
+  size_t slots_size = tuple_count * sizeof(int32_t);
+  size_t offset = slots_size + column_count * sizeof(int32_t);
+  if (offset > size) return false;
+
+  ReferenceSerializeInputBE slots(data, slots_size);
+  ReferenceSerializeInputBE column_sizes(data + slots_size,
+                                         column_count * sizeof(int32_t));
+  std::vector<std::unique_ptr<ReferenceSerializeInputBE>> columns;
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    size_t column_size = column_sizes.ReadInt();
+    if (column_size > size - offset) return false;
+    columns.emplace_back(
+        new ReferenceSerializeInputBE(data + offset, column_size));
+    offset += column_size;
+  }
+
+  auto tile_group = manager.GetTileGroup(tile_group_id);
+  if (tile_group == nullptr) {
+    table->AddTileGroupWithOidForRecovery(tile_group_id);
+    tile_group = manager.GetTileGroup(tile_group_id);
+  }
+
+  // One tuple holds each row on its way into the tile group
+  storage::Tuple tuple(schema, true);
+  oid_t inserted_count = 0;
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    oid_t tuple_slot = slots.ReadInt();
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      const bool is_inlined = schema->IsInlined(column_itr);
+      int32_t column_length = is_inlined
+                                  ? schema->GetLength(column_itr)
+                                  : schema->GetVariableLength(column_itr);
+      Value::DeserializeFrom(*columns[column_itr], pool,
+                             tuple.GetData() + schema->GetOffset(column_itr),
+                             schema->GetType(column_itr), is_inlined,
+                             column_length, false);
+    }
+
+    if (tile_group->InsertTupleFromCheckpoint(tuple_slot, &tuple,
+                                              commit_id) != INVALID_OID) {
+      inserted_count++;
+      if (table->GetWriteStats() != nullptr) {
+        table->GetWriteStats()->AddTuple(&tuple);
+      }
+    }
+  }
+
+  table->GetTileGroupLock().WriteLock();
+  table->IncreaseNumberOfTuplesBy(inserted_count);
+  table->GetTileGroupLock().Unlock();
+  return true;
+}
+
+bool FuzzyCheckpoint::WriteManifest(cid_t commit_id, int file_count) {
+  if (disable_file_access) return true;
+
+  // Written aside and renamed, so a crash leaves the previous manifest
+  auto file_name = checkpoint_dir + "/" + GetManifestFileName(checkpoint_version);
+  auto temp_file_name = file_name + ".tmp";
+  FileHandle file_handle;
+  if (!LoggingUtil::InitFileHandle(temp_file_name.c_str(), file_handle, "w")) {
+    return false;
+  }
+
+  fprintf(file_handle.file, "%lu\n%d\n", (unsigned long)commit_id, file_count);
+  for (auto &data_file : data_files_) {
+    fprintf(file_handle.file, "%s\n", data_file.c_str());
+  }
+  LoggingUtil::FFlushFsync(file_handle);
+  fclose(file_handle.file);
+
+  if (rename(temp_file_name.c_str(), file_name.c_str()) != 0) {
+    LOG_ERROR("Failed to rename %s: %s", temp_file_name.c_str(),
+              strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+bool FuzzyCheckpoint::ReadManifest(cid_t &commit_id,
+                                   std::vector<std::string> &file_names) {
+  auto file_name = checkpoint_dir + "/" + GetManifestFileName(checkpoint_version);
+  FileHandle file_handle;
+  if (!LoggingUtil::InitFileHandle(file_name.c_str(), file_handle, "r")) {
+    return false;
+  }
+
+  unsigned long manifest_cid;
+  int file_count;
+  bool success = (fscanf(file_handle.file, "%lu %d", &manifest_cid,
+                         &file_count) == 2);
+  char data_file[256];
+  for (int file_itr = 0; success && file_itr < file_count; file_itr++) {
+    success = (fscanf(file_handle.file, "%255s", data_file) == 1);
+    file_names.push_back(checkpoint_dir + "/" + data_file);
+  }
+  fclose(file_handle.file);
+
+  commit_id = manifest_cid;
+  return success;
+}
+
+void FuzzyCheckpoint::Cleanup() {
+  if (!disable_file_access) {
+    // Remove the files of previous versions
+    auto dirp = opendir(checkpoint_dir.c_str());
+    if (dirp != nullptr) {
+      struct dirent *file;
+      while ((file = readdir(dirp)) != NULL) {
+        if (strncmp(file->d_name, FILE_PREFIX.c_str(), FILE_PREFIX.length()) !=
+            0) {
+          continue;
+        }
+        std::string name(file->d_name);
+        bool is_manifest =
+            name.size() > MANIFEST_SUFFIX.size() &&
+            name.compare(name.size() - MANIFEST_SUFFIX.size(),
+                         MANIFEST_SUFFIX.size(), MANIFEST_SUFFIX) == 0;
+        bool is_data = name.size() > DATA_SUFFIX.size() &&
+                       name.compare(name.size() - DATA_SUFFIX.size(),
+                                    DATA_SUFFIX.size(), DATA_SUFFIX) == 0;
+        if ((is_manifest || is_data) &&
+            LoggingUtil::ExtractNumberFromFileName(file->d_name) <
+                checkpoint_version) {
+          auto previous_version = checkpoint_dir + "/" + name;
+          if (remove(previous_version.c_str()) != 0) {
+            LOG_TRACE("Failed to remove file %s", previous_version.c_str());
+          }
+        }
+      }
+      closedir(dirp);
+    }
+  }
+
+  // Truncate logs
+  LogManager::GetInstance().TruncateLogs(start_commit_id_);
+}
+
+void FuzzyCheckpoint::InitVersionNumber() {
+  // A version counts only with its manifest
+  struct dirent *file;
+  auto dirp = opendir(checkpoint_dir.c_str());
+  if (dirp == nullptr) {
+    LOG_TRACE("Opendir failed: Errno: %d, error: %s", errno, strerror(errno));
+    return;
+  }
+
+  while ((file = readdir(dirp)) != NULL) {
+    std::string name(file->d_name);
+    if (strncmp(file->d_name, FILE_PREFIX.c_str(), FILE_PREFIX.length()) ==
+            0 &&
+        name.size() > MANIFEST_SUFFIX.size() &&
+        name.compare(name.size() - MANIFEST_SUFFIX.size(),
+                     MANIFEST_SUFFIX.size(), MANIFEST_SUFFIX) == 0) {
+      LOG_TRACE("Found a checkpoint manifest with name %s", file->d_name);
+      int version = LoggingUtil::ExtractNumberFromFileName(file->d_name);
+      if (version > checkpoint_version) {
+        checkpoint_version = version;
+      }
+    }
+  }
+  closedir(dirp);
+  LOG_TRACE("set checkpoint version to: %d", checkpoint_version);
+}
+
+std::string FuzzyCheckpoint::GetManifestFileName(int version) {
+  return FILE_PREFIX + std::to_string(version) + MANIFEST_SUFFIX;
+}
+
+std::string FuzzyCheckpoint::GetDataFileName(int version, int file_id) {
+  return FILE_PREFIX + std::to_string(version) + "_" +
+         std::to_string(file_id) + DATA_SUFFIX;
+}
+
+}  // namespace logging
+}  // namespace peloton
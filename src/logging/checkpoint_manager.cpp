@@ -104,5 +104,11 @@ void CheckpointManager::SetRecoveredCid(cid_t recovered_cid) {
 
 cid_t CheckpointManager::GetRecoveredCid() { return recovered_cid_; }
 
+void CheckpointManager::SetRecoveryFailed(bool recovery_failed) {
+  this->recovery_failed_ = recovery_failed;
+}
+
+bool CheckpointManager::IsRecoveryFailed() { return recovery_failed_; }
+
 }  // logging
 }  // peloton
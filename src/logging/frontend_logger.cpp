@@ -54,7 +54,14 @@ FrontendLogger *FrontendLogger::GetFrontendLogger(LoggingType logging_type,
 
   LOG_TRACE("Logging_type is %d", (int)logging_type);
   if (IsBasedOnWriteAheadLogging(logging_type) == true) {
-    frontend_logger = new WriteAheadFrontendLogger(test_mode);
+    auto wal_frontend_logger = new WriteAheadFrontendLogger(test_mode);
+
+    // SSD logs bypass the page cache with preallocated segments
+    if (logging_type == LOGGING_TYPE_SSD_WAL) {
+      wal_frontend_logger->SetDirectIO(true);
+    }
+
+    frontend_logger = wal_frontend_logger;
   } else if (IsBasedOnWriteBehindLogging(logging_type) == true) {
     frontend_logger = new WriteBehindFrontendLogger();
   } else {
@@ -137,6 +144,8 @@ void FrontendLogger::MainLoop(void) {
   // LOGGING MODE
   /////////////////////////////////////////////////////////////////////
 
+  shutting_down = false;
+
   // Periodically, wake up and do logging
   while (log_manager.GetLoggingStatus() == LOGGING_STATUS_TYPE_LOGGING) {
     // Collect LogRecords from all backend loggers
@@ -156,6 +165,7 @@ void FrontendLogger::MainLoop(void) {
   /////////////////////////////////////////////////////////////////////
 
   // flush any remaining log records
+  shutting_down = true;
   CollectLogRecordsFromBackendLoggers();
   FlushLogRecords();
 
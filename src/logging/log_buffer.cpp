@@ -35,7 +35,10 @@ bool LogBuffer::WriteRecord(LogRecord *record) {
   return success;
 }
 
-void LogBuffer::ResetData() { size_ = 0; }
+void LogBuffer::ResetData() {
+  size_ = 0;
+  commit_count_ = 0;
+}
 
 // Internal Methods
 bool LogBuffer::WriteData(char *data, size_t len) {
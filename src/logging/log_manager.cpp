@@ -459,6 +459,15 @@ cid_t LogManager::GetPersistentFlushedCommitId() {
 }
 
 void LogManager::FrontendLoggerFlushed() {
+  // Advance the watermark, it never moves back
+  cid_t flushed_cid = GetPersistentFlushedCommitId();
+  cid_t current_cid = persistent_flushed_cid.load();
+  while (flushed_cid > current_cid &&
+         !persistent_flushed_cid.compare_exchange_weak(current_cid,
+                                                       flushed_cid)) {
+  }
+
+  // One wake up for the whole group
   {
     std::unique_lock<std::mutex> wait_lock(flush_notify_mutex);
     flush_notify_cv.notify_all();
@@ -467,18 +476,22 @@ void LogManager::FrontendLoggerFlushed() {
 
 void LogManager::WaitForFlush(cid_t cid) {
   LOG_TRACE("Waiting for flush with %d", (int)cid);
+
+  // The group holding this commit may already be durable
+  if (persistent_flushed_cid.load() >= cid) return;
+
   {
     std::unique_lock<std::mutex> wait_lock(flush_notify_mutex);
 
-    while (this->GetPersistentFlushedCommitId() < cid) {
+    while (persistent_flushed_cid.load() < cid) {
       LOG_TRACE(
           "Logs up to %lu cid is flushed. %lu cid is not flushed yet. Wait...",
-          this->GetPersistentFlushedCommitId(), cid);
+          persistent_flushed_cid.load(), cid);
       flush_notify_cv.wait(wait_lock);
     }
     LOG_TRACE(
         "Flushes done! Can return! Got persistent flushed commit id as %d",
-        (int)this->GetPersistentFlushedCommitId());
+        (int)persistent_flushed_cid.load());
   }
 }
 
@@ -0,0 +1,314 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_segment_writer.cpp
+//
+// Identification: src/logging/log_segment_writer.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <fcntl.h>
+#include <libgen.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include "logging/log_segment_writer.h"
+#include "common/logger.h"
+#include "common/macros.h"
+#include "murmur3/MurmurHash3.h"
+
+namespace peloton {
+namespace logging {
+
+constexpr size_t LogSegmentWriter::header_size;
+constexpr size_t LogSegmentWriter::frame_header_size;
+constexpr size_t LogSegmentWriter::block_size;
+constexpr size_t LogSegmentWriter::latency_bucket_count;
+
+static size_t AlignDown(size_t value) {
+  return value - value % LogSegmentWriter::block_size;
+}
+
+static size_t AlignUp(size_t value) {
+  return AlignDown(value + LogSegmentWriter::block_size - 1);
+}
+
+/**
+ * @brief Make a created or renamed segment survive a crash
+ */
+static void SyncParentDirectory(const std::string &file_name) {
+  std::string path = file_name;
+  int dir_fd = open(dirname(&path[0]), O_RDONLY);
+  if (dir_fd == INVALID_FILE_DESCRIPTOR) {
+    LOG_ERROR("Could not open the log directory: %s", strerror(errno));
+    return;
+  }
+
+  if (fsync(dir_fd) != 0) {
+    LOG_ERROR("Error occured in fsync of the log directory: %s",
+              strerror(errno));
+  }
+  close(dir_fd);
+}
+
+LogSegmentWriter::LogSegmentWriter(size_t segment_size)
+    : segment_size_(segment_size) {
+  ReserveBuffer(block_size);
+}
+
+LogSegmentWriter::~LogSegmentWriter(void) {
+  Close();
+  free(buffer_);
+}
+
+/**
+ * @brief Open a preallocated segment with an empty header
+ * @param file_name name of the segment
+ * @param recycled_file_name a truncated segment to reuse, or empty
+ * @param generation stamped into every frame of the segment
+ */
+bool LogSegmentWriter::Open(const std::string &file_name,
+                            const std::string &recycled_file_name,
+                            uint32_t generation) {
+  Close();
+  generation_ = generation;
+
+  // Reuse the blocks of a truncated segment
+  if (recycled_file_name.empty() == false) {
+    if (rename(recycled_file_name.c_str(), file_name.c_str()) != 0) {
+      LOG_ERROR("Could not recycle log segment %s: %s",
+                recycled_file_name.c_str(), strerror(errno));
+    } else {
+      LOG_TRACE("Recycled log segment %s as %s", recycled_file_name.c_str(),
+                file_name.c_str());
+    }
+  }
+
+  // Not every file system supports direct I/O (e.g. tmpfs)
+  direct_io_ = true;
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT | O_DSYNC | O_DIRECT, 0600);
+  if (fd_ == INVALID_FILE_DESCRIPTOR && errno == EINVAL) {
+    LOG_TRACE("O_DIRECT is not supported for %s", file_name.c_str());
+    direct_io_ = false;
+    fd_ = open(file_name.c_str(), O_RDWR | O_CREAT | O_DSYNC, 0600);
+  }
+
+  if (fd_ == INVALID_FILE_DESCRIPTOR) {
+    LOG_ERROR("Could not open log segment %s: %s", file_name.c_str(),
+              strerror(errno));
+    return false;
+  }
+
+  // Preallocate the segment, a no-op for a recycled one
+  if (fallocate(fd_, 0, 0, segment_size_) != 0) {
+    int ret = posix_fallocate(fd_, 0, segment_size_);
+    if (ret != 0) {
+      LOG_ERROR("Could not preallocate log segment %s: %s", file_name.c_str(),
+                strerror(ret));
+    }
+  }
+
+  SyncParentDirectory(file_name);
+
+  buffer_offset_ = 0;
+  write_offset_ = 0;
+  synced_offset_ = 0;
+
+  // Clear the header, a recycled segment still holds the old one
+  char header[header_size] = {0};
+  Append(header, header_size);
+
+  return Sync();
+}
+
+void LogSegmentWriter::Append(const char *data, size_t len) {
+  PL_ASSERT(IsOpen());
+
+  size_t staged_size = write_offset_ - buffer_offset_;
+
+  // Leave room for the zero padding of the last block
+  if (ReserveBuffer(staged_size + len + block_size) == false) return;
+
+  memcpy(buffer_ + staged_size, data, len);
+  write_offset_ += len;
+}
+
+void LogSegmentWriter::AppendFrame(const char *data, size_t len) {
+  char frame_header[frame_header_size];
+  BuildFrameHeader(frame_header, generation_, data, len);
+
+  Append(frame_header, frame_header_size);
+  Append(data, len);
+}
+
+void LogSegmentWriter::BuildFrameHeader(char *frame_header,
+                                        uint32_t generation, const char *data,
+                                        size_t len) {
+  PL_ASSERT(len > 0 && len <= UINT32_MAX);
+
+  uint32_t length = len;
+  uint32_t checksum = GetFrameChecksum(generation, data, len);
+  memcpy(frame_header, &generation, sizeof(generation));
+  memcpy(frame_header + sizeof(generation), &length, sizeof(length));
+  memcpy(frame_header + sizeof(generation) + sizeof(length), &checksum,
+         sizeof(checksum));
+}
+
+uint32_t LogSegmentWriter::GetFrameChecksum(uint32_t generation,
+                                            const char *data, size_t len) {
+  return MurmurHash3_x64_128(data, len, generation);
+}
+
+bool LogSegmentWriter::Sync(void) {
+  if (write_offset_ == synced_offset_) return true;
+
+  return WriteStagedBlocks();
+}
+
+bool LogSegmentWriter::WriteHeader(cid_t max_log_id, cid_t max_delimiter) {
+  PL_ASSERT(IsOpen());
+
+  char header[header_size];
+  memcpy(header, &max_log_id, sizeof(max_log_id));
+  memcpy(header + sizeof(max_log_id), &max_delimiter, sizeof(max_delimiter));
+
+  // The first block is still staged, so the header goes with it
+  if (buffer_offset_ == 0) {
+    memcpy(buffer_, header, header_size);
+    return WriteStagedBlocks();
+  }
+
+  // Otherwise read back the first block and patch it
+  char *block = nullptr;
+  if (posix_memalign((void **)&block, block_size, block_size) != 0) {
+    LOG_ERROR("Could not allocate an aligned block");
+    return false;
+  }
+
+  bool status = false;
+  if (pread(fd_, block, block_size, 0) != (ssize_t)block_size) {
+    LOG_ERROR("Could not read log segment header: %s", strerror(errno));
+  } else {
+    memcpy(block, header, header_size);
+    status = WriteBlocks(block, block_size, 0);
+  }
+
+  free(block);
+  return status;
+}
+
+void LogSegmentWriter::Close(void) {
+  if (IsOpen() == false) return;
+
+  Sync();
+
+  if (close(fd_) != 0) {
+    LOG_ERROR("Error occured while closing log segment: %s", strerror(errno));
+  }
+  fd_ = INVALID_FILE_DESCRIPTOR;
+}
+
+const std::string LogSegmentWriter::GetInfo(void) const {
+  std::ostringstream os;
+
+  os << "Segment writer [direct I/O: " << direct_io_
+     << ", syncs: " << sync_count_ << "]\n";
+
+  for (size_t bucket = 0; bucket < latency_bucket_count; bucket++) {
+    if (latency_histogram_[bucket] == 0) continue;
+
+    size_t lower = (bucket == 0) ? 0 : (1UL << (bucket - 1));
+    os << "  [" << lower << ", " << (1UL << bucket)
+       << ") us : " << latency_histogram_[bucket] << "\n";
+  }
+
+  return os.str();
+}
+
+/**
+ * @brief Write the staged blocks, zero padding the last one
+ */
+bool LogSegmentWriter::WriteStagedBlocks(void) {
+  size_t staged_size = write_offset_ - buffer_offset_;
+
+  // Pad with at least one zero byte, it ends the segment for recovery
+  size_t write_size = AlignUp(staged_size + 1);
+  memset(buffer_ + staged_size, 0, write_size - staged_size);
+
+  if (WriteBlocks(buffer_, write_size, buffer_offset_) == false) {
+    return false;
+  }
+  synced_offset_ = write_offset_;
+
+  // Keep the last partial block, the next write starts there
+  size_t kept_from = AlignDown(staged_size);
+  memmove(buffer_, buffer_ + kept_from, staged_size - kept_from);
+  buffer_offset_ += kept_from;
+
+  return true;
+}
+
+bool LogSegmentWriter::WriteBlocks(const char *data, size_t len,
+                                   size_t offset) {
+  auto start = std::chrono::high_resolution_clock::now();
+
+  size_t written = 0;
+  while (written < len) {
+    ssize_t ret = pwrite(fd_, data + written, len - written, offset + written);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Error occured in pwrite: %s", strerror(errno));
+      return false;
+    }
+    written += ret;
+  }
+
+  auto end = std::chrono::high_resolution_clock::now();
+  RecordLatency(std::chrono::duration_cast<std::chrono::microseconds>(
+                    end - start).count());
+
+  sync_count_++;
+  return true;
+}
+
+bool LogSegmentWriter::ReserveBuffer(size_t len) {
+  if (len <= buffer_capacity_) return true;
+
+  size_t new_capacity = std::max(AlignUp(len), 2 * buffer_capacity_);
+  char *new_buffer = nullptr;
+  if (posix_memalign((void **)&new_buffer, block_size, new_capacity) != 0) {
+    LOG_ERROR("Could not allocate a staging buffer of %lu bytes",
+              new_capacity);
+    return false;
+  }
+
+  if (buffer_ != nullptr) {
+    memcpy(new_buffer, buffer_, write_offset_ - buffer_offset_);
+    free(buffer_);
+  }
+
+  buffer_ = new_buffer;
+  buffer_capacity_ = new_capacity;
+  return true;
+}
+
+void LogSegmentWriter::RecordLatency(uint64_t micros) {
+  size_t bucket = 0;
+  if (micros != 0) {
+    bucket = 64 - __builtin_clzll(micros);
+  }
+
+  if (bucket >= latency_bucket_count) bucket = latency_bucket_count - 1;
+  latency_histogram_[bucket]++;
+}
+
+}  // namespace logging
+}  // namespace peloton
@@ -16,6 +16,8 @@
 #include <sys/mman.h>
 #include <algorithm>
 #include <dirent.h>
+#include <fcntl.h>
+#include <numeric>
 
 #include "catalog/manager.h"
 #include "catalog/schema.h"
@@ -32,6 +34,9 @@
 #include "logging/checkpoint_tile_scanner.h"
 #include "logging/logging_util.h"
 #include "logging/checkpoint_manager.h"
+#include "logging/replication_manager.h"
+
+#include "optimizer/table_write_stats.h"
 
 #include "storage/database.h"
 #include "storage/data_table.h"
@@ -134,19 +139,27 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
     }
   }
 
+  auto &replication_manager = ReplicationManager::GetInstance();
+  bool replicate = replication_manager.HasReplicas();
+
   // First, write all the record in the queue
   for (oid_t global_queue_itr = 0; global_queue_itr < global_queue_size;
        global_queue_itr++) {
     auto &log_buffer = global_queue[global_queue_itr];
 
     if (!test_mode_) {
-      fwrite(log_buffer->GetData(), sizeof(char), log_buffer->GetSize(),
-             cur_file_handle.file);
+      WriteToLogFile(log_buffer->GetData(), log_buffer->GetSize());
+    }
+
+    if (replicate) {
+      replication_buffer_.append(log_buffer->GetData(), log_buffer->GetSize());
     }
 
     LOG_TRACE("Log buffer get max log id returned %d",
               (int)log_buffer->GetMaxLogId());
 
+    pending_commit_count += log_buffer->GetCommitCount();
+
     if (log_buffer->GetMaxLogId() > this->max_log_id_file) {
       this->max_log_id_file = log_buffer->GetMaxLogId();
       LOG_TRACE("Max log id file so far is %d", (int)this->max_log_id_file);
@@ -158,8 +171,15 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
     backend_logger->GrantEmptyBuffer(std::move(log_buffer));
   }
 
+  // Open a group with the first commit that is not durable yet
+  bool has_pending_commits = (max_collected_commit_id != max_flushed_commit_id);
+  if (has_pending_commits && group_open == false) {
+    group_start_time = Clock::now();
+    group_open = true;
+  }
+
   bool flushed = false;
-  if (max_collected_commit_id != max_flushed_commit_id) {
+  if (has_pending_commits && GroupCommitCondIsTrue()) {
     TransactionRecord delimiter_rec(LOGRECORD_TYPE_ITERATION_DELIMITER,
                                     this->max_collected_commit_id);
     delimiter_rec.Serialize(output_buffer);
@@ -167,25 +187,20 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
     if (!test_mode_) {
       PL_ASSERT(cur_file_handle.fd != -1);
       if (cur_file_handle.fd != -1) {
-        fwrite(delimiter_rec.GetMessage(), sizeof(char),
-               delimiter_rec.GetMessageLength(), cur_file_handle.file);
+        WriteToLogFile(delimiter_rec.GetMessage(),
+                       delimiter_rec.GetMessageLength());
 
         LOG_TRACE("Wrote delimiter to log file with commit_id %ld",
                   this->max_collected_commit_id);
 
         // by moving the fflush and sync here, we ensure that this file will
         // have at least 1 delimiter
-        if (Clock::now() > last_flush + flush_frequency) {
+        if (segment_writer_) {
+          segment_writer_->Sync();
+        } else {
           LoggingUtil::FFlushFsync(cur_file_handle);
-
-          last_flush = Clock::now();
-          if (this->max_collected_commit_id > max_flushed_commit_id) {
-            max_flushed_commit_id = this->max_collected_commit_id;
-          }
-
-          fsync_count++;
-          flushed = true;
         }
+        fsync_count++;
 
         if (this->max_collected_commit_id > max_delimiter_file) {
           max_delimiter_file = this->max_collected_commit_id;
@@ -194,19 +209,29 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
 
         if (FileSwitchCondIsTrue()) should_create_new_file = true;
       }
-    } else {
-      if (Clock::now() > last_flush + flush_frequency) {
-        last_flush = Clock::now();
-        if (this->max_collected_commit_id > max_flushed_commit_id) {
-          max_flushed_commit_id = this->max_collected_commit_id;
-        }
+    }
 
-        flushed = true;
-      }
+    LOG_TRACE("Flushed group of %lu commits up to commit id %lu",
+              pending_commit_count, this->max_collected_commit_id);
+
+    // The replicas get the same bytes as the log file, once they are durable
+    if (replicate) {
+      replication_buffer_.append(delimiter_rec.GetMessage(),
+                                 delimiter_rec.GetMessageLength());
+      replication_manager.ShipLogBuffer(replication_buffer_,
+                                        this->max_collected_commit_id);
+      replication_buffer_.clear();
     }
+
+    if (this->max_collected_commit_id > max_flushed_commit_id) {
+      max_flushed_commit_id = this->max_collected_commit_id;
+    }
+
+    pending_commit_count = 0;
+    group_open = false;
+    flushed = true;
   }
 
-  /* For now, fflush after every iteration of collecting buffers */
   // Clean up the frontend logger's queue
   global_queue.clear();
 
@@ -216,6 +241,57 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
   }
 }
 
+/**
+ * @brief Append to the current log file, buffered or direct
+ */
+void WriteAheadFrontendLogger::WriteToLogFile(const char *data, size_t len) {
+  if (len == 0) return;
+
+  if (segment_writer_) {
+    segment_writer_->AppendFrame(data, len);
+  } else {
+    // Buffered files are framed the same way, recovery reads both
+    char frame_header[LogSegmentWriter::frame_header_size];
+    LogSegmentWriter::BuildFrameHeader(
+        frame_header, log_files_.back()->GetLogNumber(), data, len);
+    fwrite(frame_header, sizeof(char), sizeof(frame_header),
+           cur_file_handle.file);
+    fwrite(data, sizeof(char), len, cur_file_handle.file);
+  }
+}
+
+/**
+ * @brief Write preallocated segments with O_DIRECT and O_DSYNC
+ * Must be set before the first log file is created
+ */
+void WriteAheadFrontendLogger::SetDirectIO(bool direct_io) {
+  PL_ASSERT(cur_file_handle.fd == -1);
+
+  if (direct_io) {
+    // the size limit is in KB
+    size_t segment_size =
+        LogManager::GetInstance().GetLogFileSizeLimit() * UINT64_C(1024);
+    segment_writer_.reset(new LogSegmentWriter(segment_size));
+  } else {
+    segment_writer_.reset();
+  }
+}
+
+/**
+ * @brief Whether the open commit group should be flushed now
+ */
+bool WriteAheadFrontendLogger::GroupCommitCondIsTrue() {
+  // Drain everything before going to sleep
+  if (shutting_down) return true;
+
+  // The group is full
+  if (group_commit_size != 0 && pending_commit_count >= group_commit_size)
+    return true;
+
+  // The first commit of the group has waited long enough
+  return (Clock::now() >= group_start_time + commit_delay);
+}
+
 //===--------------------------------------------------------------------===//
 // Recovery
 //===--------------------------------------------------------------------===//
@@ -226,9 +302,18 @@ void WriteAheadFrontendLogger::FlushLogRecords(void) {
 void WriteAheadFrontendLogger::DoRecovery() {
   // FIXME GetNextCommitId() increments next_cid!!!
   cid_t start_commit_id = CheckpointManager::GetInstance().GetRecoveredCid();
+
+  // The log was truncated at the checkpoint, replaying it without the
+  // checkpoint would pass off a partial database as recovered
+  if (CheckpointManager::GetInstance().IsRecoveryFailed()) {
+    LOG_ERROR("The checkpoint could not be recovered, not replaying the log");
+    cur_file_handle = INVALID_FILE_HANDLE;
+    return;
+  }
   auto &log_manager = logging::LogManager::GetInstance();
   int num_inserts = 0;
   cid_t global_max_flushed_id_for_recovery;
+  bool torn_log = false;
   log_file_cursor_ = 0;
 
   global_max_flushed_id_for_recovery =
@@ -236,6 +321,13 @@ void WriteAheadFrontendLogger::DoRecovery() {
   LOG_TRACE("Got start_commit_id as %d, global max flushed as %d",
             (int)start_commit_id, (int)global_max_flushed_id_for_recovery);
 
+  // Committed txns are replayed by the recovery threads, partitioned by the
+  // tile groups they write, while this thread reads on
+  if (peloton_recovery_thread_count > 1) {
+    replay_pool_.reset(new ThreadPool(peloton_recovery_thread_count));
+    replay_batch_.resize(peloton_recovery_thread_count);
+  }
+
   // open first file
   OpenNextLogFile();
 
@@ -258,8 +350,9 @@ void WriteAheadFrontendLogger::DoRecovery() {
         TransactionRecord txn_rec(record_type);
         if (LoggingUtil::ReadTransactionRecordHeader(
                 txn_rec, cur_file_handle) == false) {
-          cur_file_handle = INVALID_FILE_HANDLE;
-          return;
+          torn_log = true;
+          reached_end_of_log = true;
+          break;
         }
         log_id = txn_rec.GetTransactionId();
         if (log_id <= start_commit_id ||
@@ -276,8 +369,10 @@ void WriteAheadFrontendLogger::DoRecovery() {
         if (LoggingUtil::ReadTupleRecordHeader(*tuple_record,
                                                cur_file_handle) == false) {
           LOG_ERROR("Could not read tuple record header.");
-          cur_file_handle = INVALID_FILE_HANDLE;
-          return;
+          delete tuple_record;
+          torn_log = true;
+          reached_end_of_log = true;
+          break;
         }
 
         log_id = tuple_record->GetTransactionId();
@@ -294,8 +389,10 @@ void WriteAheadFrontendLogger::DoRecovery() {
         if (recovery_txn_table.find(log_id) == recovery_txn_table.end()) {
           LOG_ERROR("Insert txd id %d not found in recovery txn table",
                     (int)log_id);
-          cur_file_handle = INVALID_FILE_HANDLE;
-          return;
+          delete tuple_record;
+          torn_log = true;
+          reached_end_of_log = true;
+          break;
         }
 
         // Read off the tuple record body from the log
@@ -309,8 +406,10 @@ void WriteAheadFrontendLogger::DoRecovery() {
         // Check for torn log write
         if (LoggingUtil::ReadTupleRecordHeader(*tuple_record,
                                                cur_file_handle) == false) {
-          cur_file_handle = INVALID_FILE_HANDLE;
-          return;
+          delete tuple_record;
+          torn_log = true;
+          reached_end_of_log = true;
+          break;
         }
 
         log_id = tuple_record->GetTransactionId();
@@ -322,8 +421,10 @@ void WriteAheadFrontendLogger::DoRecovery() {
         if (recovery_txn_table.find(log_id) == recovery_txn_table.end()) {
           LOG_TRACE("Delete txd id %d not found in recovery txn table",
                     (int)log_id);
-          cur_file_handle = INVALID_FILE_HANDLE;
-          return;
+          delete tuple_record;
+          torn_log = true;
+          reached_end_of_log = true;
+          break;
         }
         break;
       }
@@ -369,6 +470,19 @@ void WriteAheadFrontendLogger::DoRecovery() {
     }
   }
 
+  // Wait for the committed txns still being replayed
+  if (replay_pool_ != nullptr) {
+    DispatchReplayBatch();
+    WaitForReplayBatch();
+    replay_pool_.reset();
+    replay_batch_.clear();
+  }
+
+  if (torn_log == true) {
+    cur_file_handle = INVALID_FILE_HANDLE;
+    return;
+  }
+
   // Finally, abort ACTIVE transactions in recovery_txn_table
   AbortActiveTransactions();
 
@@ -380,6 +494,127 @@ void WriteAheadFrontendLogger::DoRecovery() {
   cur_file_handle = INVALID_FILE_HANDLE;
 }
 
+/**
+ * @brief Replay a log buffer shipped by the primary through the recovery
+ * path. A txn may span buffers, its records wait in the recovery txn table
+ * until its commit record arrives. Snapshots begin at the commit id before
+ * the next one, so they see the txns of a buffer once all of them are
+ * applied.
+ */
+bool WriteAheadFrontendLogger::ReplayLogBuffer(const char *data, size_t size) {
+  if (size == 0) return true;
+
+  FILE *file = fmemopen(const_cast<char *>(data), size, "rb");
+  if (file == nullptr) {
+    LOG_ERROR("Could not open a log buffer for replay");
+    return false;
+  }
+  FileHandle file_handle(file, INVALID_FILE_DESCRIPTOR, size);
+
+  // Committed txns are replayed by the recovery threads too
+  if (peloton_recovery_thread_count > 1 && replay_pool_ == nullptr) {
+    replay_pool_.reset(new ThreadPool(peloton_recovery_thread_count));
+    replay_batch_.resize(peloton_recovery_thread_count);
+  }
+
+  bool replayed = true;
+  bool reached_end_of_buffer = false;
+
+  while (reached_end_of_buffer == false) {
+    // A buffer holds whole records
+    if (LoggingUtil::IsFileTruncated(file_handle, 1)) break;
+
+    auto record_type = LoggingUtil::GetNextLogRecordType(file_handle);
+
+    switch (record_type) {
+      case LOGRECORD_TYPE_TRANSACTION_BEGIN:
+      case LOGRECORD_TYPE_TRANSACTION_COMMIT:
+      case LOGRECORD_TYPE_ITERATION_DELIMITER: {
+        TransactionRecord txn_rec(record_type);
+        if (LoggingUtil::ReadTransactionRecordHeader(txn_rec, file_handle) ==
+            false) {
+          replayed = false;
+          reached_end_of_buffer = true;
+          break;
+        }
+
+        if (record_type == LOGRECORD_TYPE_TRANSACTION_BEGIN) {
+          StartTransactionRecovery(txn_rec.GetTransactionId());
+        } else if (record_type == LOGRECORD_TYPE_TRANSACTION_COMMIT) {
+          CommitTransactionRecovery(txn_rec.GetTransactionId());
+        }
+        break;
+      }
+      case LOGRECORD_TYPE_WAL_TUPLE_INSERT:
+      case LOGRECORD_TYPE_WAL_TUPLE_UPDATE:
+      case LOGRECORD_TYPE_WAL_TUPLE_DELETE: {
+        TupleRecord *tuple_record = new TupleRecord(record_type);
+        if (LoggingUtil::ReadTupleRecordHeader(*tuple_record, file_handle) ==
+            false) {
+          delete tuple_record;
+          replayed = false;
+          reached_end_of_buffer = true;
+          break;
+        }
+
+        // Deletes have no body
+        if (record_type != LOGRECORD_TYPE_WAL_TUPLE_DELETE) {
+          auto table = LoggingUtil::GetTable(*tuple_record);
+          if (table == nullptr) {
+            LoggingUtil::SkipTupleRecordBody(file_handle);
+            delete tuple_record;
+            break;
+          }
+
+          auto tuple = LoggingUtil::ReadTupleRecordBody(
+              table->GetSchema(), recovery_pool, file_handle);
+          if (tuple == nullptr) {
+            delete tuple_record;
+            replayed = false;
+            reached_end_of_buffer = true;
+            break;
+          }
+          tuple_record->SetTuple(tuple);
+        }
+
+        auto recovery_txn =
+            recovery_txn_table.find(tuple_record->GetTransactionId());
+        if (recovery_txn == recovery_txn_table.end()) {
+          LOG_ERROR("Txn %d of a replayed tuple has not begun",
+                    (int)tuple_record->GetTransactionId());
+          delete tuple_record;
+          replayed = false;
+          reached_end_of_buffer = true;
+          break;
+        }
+        recovery_txn->second.push_back(tuple_record);
+        break;
+      }
+      default:
+        LOG_ERROR("Invalid log record type %d in a replayed log buffer",
+                  (int)record_type);
+        replayed = false;
+        reached_end_of_buffer = true;
+        break;
+    }
+  }
+
+  fclose(file);
+
+  if (replay_pool_ != nullptr) {
+    DispatchReplayBatch();
+    WaitForReplayBatch();
+  }
+
+  // Commit ids only grow
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  if (max_cid > txn_manager.GetCurrentCommitId()) {
+    txn_manager.SetNextCid(max_cid);
+  }
+
+  return replayed;
+}
+
 void WriteAheadFrontendLogger::RecoverIndex() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
   LOG_TRACE("Recovering the indexes");
@@ -389,6 +624,13 @@ void WriteAheadFrontendLogger::RecoverIndex() {
   auto &catalog_manager = catalog::Manager::GetInstance();
   auto database_count = catalog_manager.GetDatabaseCount();
 
+  // With recovery threads every index is rebuilt by its own scan
+  std::unique_ptr<ThreadPool> index_pool;
+  std::vector<std::future<bool>> index_futures;
+  if (peloton_recovery_thread_count > 1) {
+    index_pool.reset(new ThreadPool(peloton_recovery_thread_count));
+  }
+
   // loop all databases
   for (oid_t database_idx = 0; database_idx < database_count; database_idx++) {
     auto database = catalog_manager.GetDatabase(database_idx);
@@ -402,15 +644,38 @@ void WriteAheadFrontendLogger::RecoverIndex() {
       LOG_TRACE("SeqScan: database oid %u table oid %u: %s", database_idx,
                 table_idx, target_table->GetName().c_str());
 
-      if (!RecoverTableIndexHelper(target_table, cid)) {
-        break;
+      std::vector<index::Index *> indexes;
+      auto index_count = target_table->GetIndexCount();
+      for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
+        indexes.push_back(target_table->GetIndex(index_itr));
+      }
+
+      if (index_pool == nullptr) {
+        RecoverTableIndexHelper(target_table, cid, indexes);
+        continue;
+      }
+
+      for (auto index : indexes) {
+        std::vector<index::Index *> target_index = {index};
+        index_futures.push_back(index_pool->Enqueue(
+            &WriteAheadFrontendLogger::RecoverTableIndexHelper, this,
+            target_table, cid, target_index));
       }
     }
   }
+
+  for (auto &index_future : index_futures) {
+    index_future.get();
+  }
 }
 
+/**
+ * @brief insert the tuples of the table visible at start_cid into the
+ * indexes, may run for different indexes at the same time
+ */
 bool WriteAheadFrontendLogger::RecoverTableIndexHelper(
-    storage::DataTable *target_table, cid_t start_cid) {
+    storage::DataTable *target_table, cid_t start_cid,
+    const std::vector<index::Index *> &indexes) {
   auto schema = target_table->GetSchema();
   PL_ASSERT(schema);
   std::vector<oid_t> column_ids;
@@ -421,6 +686,13 @@ bool WriteAheadFrontendLogger::RecoverTableIndexHelper(
   auto table_tile_group_count = target_table->GetTileGroupCount();
   CheckpointTileScanner scanner;
 
+  if (indexes.empty()) return true;
+
+  std::vector<std::vector<oid_t>> indexed_columns;
+  for (auto index : indexes) {
+    indexed_columns.push_back(index->GetKeySchema()->GetIndexedColumns());
+  }
+
   while (current_tile_group_offset < table_tile_group_count) {
     // Retrieve a tile group
     auto tile_group = target_table->GetTileGroup(current_tile_group_offset);
@@ -444,18 +716,22 @@ bool WriteAheadFrontendLogger::RecoverTableIndexHelper(
     for (oid_t tuple_id : *logical_tile) {
       expression::ContainerTuple<executor::LogicalTile> cur_tuple(
           logical_tile.get(), tuple_id);
-
-      // Index update
-      {
-        // construct a physical tuple from the logical tuple
-        std::unique_ptr<storage::Tuple> tuple(new storage::Tuple(schema, true));
-        for (auto column_id : column_ids) {
-          tuple->SetValue(column_id, cur_tuple.GetValue(column_id),
-                          recovery_pool);
+      ItemPointer location(tile_group_id, tuple_id);
+
+      // Index update, the keys are built straight from the logical tuple
+      for (size_t index_itr = 0; index_itr < indexes.size(); index_itr++) {
+        auto index = indexes[index_itr];
+        std::unique_ptr<storage::Tuple> key(
+            new storage::Tuple(index->GetKeySchema(), true));
+        oid_t key_column_itr = 0;
+        for (auto column_id : indexed_columns[index_itr]) {
+          key->SetValue(key_column_itr++, cur_tuple.GetValue(column_id),
+                        index->GetPool());
         }
 
-        ItemPointer location(tile_group_id, tuple_id);
-        InsertIndexEntry(tuple.get(), target_table, location);
+        index->InsertEntry(key.get(), location);
+        // Increase the indexes' number of tuples by 1 as well
+        index->IncreaseNumberOfTuplesBy(1);
       }
     }
     current_tile_group_offset++;
@@ -463,28 +739,6 @@ bool WriteAheadFrontendLogger::RecoverTableIndexHelper(
   return true;
 }
 
-void WriteAheadFrontendLogger::InsertIndexEntry(storage::Tuple *tuple,
-                                                storage::DataTable *table,
-                                                ItemPointer target_location) {
-  PL_ASSERT(tuple);
-  PL_ASSERT(table);
-  auto index_count = table->GetIndexCount();
-  LOG_TRACE("Insert tuple (%u, %u) into %u indexes", target_location.block,
-            target_location.offset, index_count);
-
-  for (int index_itr = index_count - 1; index_itr >= 0; --index_itr) {
-    auto index = table->GetIndex(index_itr);
-    auto index_schema = index->GetKeySchema();
-    auto indexed_columns = index_schema->GetIndexedColumns();
-    std::unique_ptr<storage::Tuple> key(new storage::Tuple(index_schema, true));
-    key->SetFromTuple(tuple, indexed_columns, index->GetPool());
-
-    index->InsertEntry(key.get(), target_location);
-    // Increase the indexes' number of tuples by 1 as well
-    index->IncreaseNumberOfTuplesBy(1);
-  }
-}
-
 /**
  * @brief Add new txn to recovery table
  */
@@ -514,6 +768,13 @@ void WriteAheadFrontendLogger::StartTransactionRecovery(cid_t commit_id) {
  */
 void WriteAheadFrontendLogger::CommitTransactionRecovery(cid_t commit_id) {
   std::vector<TupleRecord *> &tuple_records = recovery_txn_table[commit_id];
+  if (replay_pool_ != nullptr) {
+    PartitionTupleRecords(tuple_records);
+    max_cid = commit_id + 1;
+    recovery_txn_table.erase(commit_id);
+    return;
+  }
+
   for (auto it = tuple_records.begin(); it != tuple_records.end(); it++) {
     TupleRecord *curr = *it;
     switch (curr->GetType()) {
@@ -570,6 +831,15 @@ void InsertTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
     table->IncreaseNumberOfTuplesBy(1);
     table->GetTileGroupLock().Unlock();
   }
+
+  auto write_stats = table->GetWriteStats();
+  if (write_stats != nullptr) {
+    if (should_increase_tuple_count) {
+      write_stats->AddTuple(tuple);
+    } else {
+      write_stats->UpdateTuple(tuple);
+    }
+  }
   delete tuple;
 }
 
@@ -597,22 +867,24 @@ void DeleteTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
     }
   }
   // FIXME we always decrease the number of tuples by one
+  table->GetTileGroupLock().WriteLock();
   table->DecreaseNumberOfTuplesBy(1);
-  // table->GetTileGroupLock().Unlock();
+  table->GetTileGroupLock().Unlock();
+  if (table->GetWriteStats() != nullptr) table->GetWriteStats()->DeleteTuple();
 
   tile_group->DeleteTupleFromRecovery(commit_id, delete_loc.offset);
 }
 
-void UpdateTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
-                       oid_t table_id, const ItemPointer &remove_loc,
-                       const ItemPointer &insert_loc, storage::Tuple *tuple) {
+// Point the old version of an update to the new one
+void RetireVersionHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
+                         oid_t table_id, const ItemPointer &remove_loc,
+                         const ItemPointer &insert_loc) {
   auto &manager = catalog::Manager::GetInstance();
   storage::Database *db = manager.GetDatabaseWithOid(db_id);
   PL_ASSERT(db);
 
   auto table = db->GetTableWithOid(table_id);
   if (!table) {
-    delete tuple;
     return;
   }
   PL_ASSERT(table);
@@ -628,12 +900,19 @@ void UpdateTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
     }
   }
   // table->GetTileGroupLock().Unlock();
-  InsertTupleHelper(max_tg, commit_id, db_id, table_id, insert_loc, tuple,
-                    false);
 
   tile_group->UpdateTupleFromRecovery(commit_id, remove_loc.offset, insert_loc);
 }
 
+void UpdateTupleHelper(oid_t &max_tg, cid_t commit_id, oid_t db_id,
+                       oid_t table_id, const ItemPointer &remove_loc,
+                       const ItemPointer &insert_loc, storage::Tuple *tuple) {
+  InsertTupleHelper(max_tg, commit_id, db_id, table_id, insert_loc, tuple,
+                    false);
+  RetireVersionHelper(max_tg, commit_id, db_id, table_id, remove_loc,
+                      insert_loc);
+}
+
 /**
  * @brief read tuple record from log file and add them tuples to recovery txn
  * @param recovery txn
@@ -666,6 +945,115 @@ void WriteAheadFrontendLogger::UpdateTuple(TupleRecord *record) {
                     record->GetTuple());
 }
 
+//===--------------------------------------------------------------------===//
+// Parallel Replay
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief hand the records of a committed txn to the partitions of the tile
+ * groups they write. Records of a tile group, hence the versions of a
+ * tuple, are replayed by one thread in commit order.
+ */
+void WriteAheadFrontendLogger::PartitionTupleRecords(
+    std::vector<TupleRecord *> &tuple_records) {
+  auto partition_count = replay_batch_.size();
+
+  for (auto record : tuple_records) {
+    auto insert_partition = record->GetInsertLocation().block % partition_count;
+    auto delete_partition = record->GetDeleteLocation().block % partition_count;
+
+    switch (record->GetType()) {
+      case LOGRECORD_TYPE_WAL_TUPLE_INSERT:
+        replay_batch_[insert_partition].push_back({record, REPLAY_OP_INSERT});
+        break;
+      case LOGRECORD_TYPE_WAL_TUPLE_UPDATE:
+        replay_batch_[insert_partition].push_back(
+            {record, REPLAY_OP_INSERT_VERSION});
+        replay_batch_[delete_partition].push_back(
+            {record, REPLAY_OP_RETIRE_VERSION});
+        break;
+      case LOGRECORD_TYPE_WAL_TUPLE_DELETE:
+        replay_batch_[delete_partition].push_back({record, REPLAY_OP_DELETE});
+        break;
+      default:
+        delete record;
+        continue;
+    }
+    replay_batch_records_.push_back(record);
+  }
+
+  if (replay_batch_records_.size() >= replay_batch_size) {
+    DispatchReplayBatch();
+  }
+}
+
+/**
+ * @brief start replaying the filled batch once the previous one is done,
+ * as both may write the same tile groups
+ */
+void WriteAheadFrontendLogger::DispatchReplayBatch() {
+  WaitForReplayBatch();
+
+  for (auto &ops : replay_batch_) {
+    if (ops.empty()) continue;
+    replay_futures_.push_back(replay_pool_->Enqueue(
+        &WriteAheadFrontendLogger::ReplayTupleRecords, std::move(ops)));
+    ops.clear();
+  }
+
+  replayed_records_.swap(replay_batch_records_);
+}
+
+void WriteAheadFrontendLogger::WaitForReplayBatch() {
+  for (auto &replay_future : replay_futures_) {
+    auto max_tile_group = replay_future.get();
+    if (max_oid < max_tile_group) {
+      max_oid = max_tile_group;
+    }
+  }
+  replay_futures_.clear();
+
+  for (auto record : replayed_records_) {
+    delete record;
+  }
+  replayed_records_.clear();
+}
+
+oid_t WriteAheadFrontendLogger::ReplayTupleRecords(
+    const std::vector<ReplayOp> &ops) {
+  oid_t max_tile_group = 0;
+
+  for (auto &op : ops) {
+    auto record = op.record;
+    switch (op.type) {
+      case REPLAY_OP_INSERT:
+        InsertTupleHelper(max_tile_group, record->GetTransactionId(),
+                          record->GetDatabaseOid(), record->GetTableId(),
+                          record->GetInsertLocation(), record->GetTuple());
+        break;
+      case REPLAY_OP_INSERT_VERSION:
+        InsertTupleHelper(max_tile_group, record->GetTransactionId(),
+                          record->GetDatabaseOid(), record->GetTableId(),
+                          record->GetInsertLocation(), record->GetTuple(),
+                          false);
+        break;
+      case REPLAY_OP_RETIRE_VERSION:
+        RetireVersionHelper(max_tile_group, record->GetTransactionId(),
+                            record->GetDatabaseOid(), record->GetTableId(),
+                            record->GetDeleteLocation(),
+                            record->GetInsertLocation());
+        break;
+      case REPLAY_OP_DELETE:
+        DeleteTupleHelper(max_tile_group, record->GetTransactionId(),
+                          record->GetDatabaseOid(), record->GetTableId(),
+                          record->GetDeleteLocation());
+        break;
+    }
+  }
+
+  return max_tile_group;
+}
+
 //===--------------------------------------------------------------------===//
 // Utility functions
 //===--------------------------------------------------------------------===//
@@ -688,6 +1076,16 @@ LogRecordType WriteAheadFrontendLogger::GetNextLogRecordTypeForRecovery() {
     is_truncated = true;
   }
 
+  // Records are read a frame at a time, the records of a file end at the
+  // first frame that is zero padding, torn or stale
+  if (!is_truncated &&
+      (size_t)ftell(cur_file_handle.file) >= recovery_frame_end_ &&
+      LoggingUtil::ReadSegmentFrame(cur_file_handle, recovery_generation_,
+                                    recovery_frame_end_) == false) {
+    LOG_TRACE("Reached the end of the records of the log file");
+    is_truncated = true;
+  }
+
   // Otherwise, read the log record type
   if (!is_truncated) {
     ret = fread((void *)&buffer, 1, sizeof(char), cur_file_handle.file);
@@ -702,8 +1100,9 @@ LogRecordType WriteAheadFrontendLogger::GetNextLogRecordTypeForRecovery() {
 
     LOG_TRACE("Open succeeded. log_file_fd is %d", (int)cur_file_handle.fd);
 
-    if (LoggingUtil::IsFileTruncated(cur_file_handle, 1)) {
-      LOG_ERROR("Log file is truncated");
+    if (LoggingUtil::ReadSegmentFrame(cur_file_handle, recovery_generation_,
+                                      recovery_frame_end_) == false) {
+      LOG_TRACE("Log file has no records");
       return LOGRECORD_TYPE_INVALID;
     }
 
@@ -746,6 +1145,8 @@ void WriteAheadFrontendLogger::InitLogFilesList() {
   // TODO need a better regular expression to match file name
   std::string base_name = "peloton_log_";
 
+  std::string recycled_base_name = RECYCLED_FILE_PREFIX;
+
   LOG_TRACE("Trying to read log directory");
 
   dirp = opendir(this->peloton_log_directory.c_str());
@@ -755,6 +1156,17 @@ void WriteAheadFrontendLogger::InitLogFilesList() {
 
   // XXX readdir is not thread safe???
   while ((file = readdir(dirp)) != NULL) {
+    // truncated segments can be reused by the next log files
+    if (strncmp(file->d_name, recycled_base_name.c_str(),
+                recycled_base_name.length()) == 0) {
+      recycled_files_.push_back(peloton_log_directory + "/" + file->d_name);
+
+      int recycled_number = LoggingUtil::ExtractNumberFromFileName(file->d_name);
+      if (recycled_number >= recycled_file_counter_)
+        recycled_file_counter_ = recycled_number + 1;
+      continue;
+    }
+
     if (strncmp(file->d_name, base_name.c_str(), base_name.length()) == 0) {
       // found a log file!
       LOG_TRACE("Found a log file with name %s", file->d_name);
@@ -789,7 +1201,8 @@ void WriteAheadFrontendLogger::InitLogFilesList() {
 
       if (temp_max_log_id_file == 0 || temp_max_log_id_file == UINT64_MAX ||
           temp_max_delimiter_file == 0) {
-        extracted_values = ExtractMaxLogIdAndMaxDelimFromLogFileRecords(fp);
+        extracted_values =
+            ExtractMaxLogIdAndMaxDelimFromLogFileRecords(fp, version_number);
 
         temp_max_log_id_file = extracted_values.first;
         temp_max_delimiter_file = extracted_values.second;
@@ -877,7 +1290,20 @@ void WriteAheadFrontendLogger::CreateNewLogFile(bool close_old_file) {
     int file_list_size = log_files_.size();
     LogFile *cur_log_file_object = log_files_[file_list_size - 1];
 
-    if (file_list_size != 0) {
+    if (file_list_size != 0 && segment_writer_) {
+      segment_writer_->WriteHeader(max_log_id_file, max_delimiter_file);
+
+      cur_log_file_object->SetMaxLogId(max_log_id_file);
+      cur_log_file_object->SetMaxDelimiter(max_delimiter_file);
+      cur_log_file_object->SetLogFileSize(segment_writer_->GetWriteOffset());
+
+      max_log_id_file = 0;     // reset
+      max_delimiter_file = 0;  // reset
+
+      segment_writer_->Close();
+
+      cur_log_file_object->SetLogFileFD(-1);  // invalidate
+    } else if (file_list_size != 0) {
       // TODO check return values of all these operations!
       fseek(cur_file_handle.file, 0, SEEK_SET);
 
@@ -919,27 +1345,40 @@ void WriteAheadFrontendLogger::CreateNewLogFile(bool close_old_file) {
 
   new_file_name = this->GetFileNameFromVersion(new_file_num);
 
-  FILE *new_log_file = fopen(new_file_name.c_str(), "wb");
+  if (segment_writer_) {
+    // the writer leaves room for the max log id and max delimiter
+    if (segment_writer_->Open(new_file_name, GetRecycledFileName(),
+                              new_file_num) == false) {
+      LOG_ERROR("Could not open log segment %s", new_file_name.c_str());
+      return;
+    }
 
-  if (new_log_file == NULL) {
-    LOG_ERROR("new_log_file is NULL");
-    return;
-  }
+    cur_file_handle.file = nullptr;
+    cur_file_handle.fd = segment_writer_->GetFD();
+    cur_file_handle.size = 0;
+  } else {
+    FILE *new_log_file = fopen(new_file_name.c_str(), "wb");
+
+    if (new_log_file == NULL) {
+      LOG_ERROR("new_log_file is NULL");
+      return;
+    }
 
-  // now set the first 8 bytes to 0 - this is for the max_log id in this file
-  fwrite((void *)&default_commit_id, sizeof(default_commit_id), 1,
-         new_log_file);
+    // now set the first 8 bytes to 0 - this is for the max_log id in this file
+    fwrite((void *)&default_commit_id, sizeof(default_commit_id), 1,
+           new_log_file);
 
-  // now set the next 8 bytes to 0 - this is for the max delimiter in this file
-  fwrite((void *)&default_delimiter, sizeof(default_delimiter), 1,
-         new_log_file);
+    // now set the next 8 bytes to 0 - for the max delimiter in this file
+    fwrite((void *)&default_delimiter, sizeof(default_delimiter), 1,
+           new_log_file);
 
-  cur_file_handle.file = new_log_file;
-  cur_file_handle.fd = fileno(cur_file_handle.file);
-  cur_file_handle.size = 0;
+    cur_file_handle.file = new_log_file;
+    cur_file_handle.fd = fileno(cur_file_handle.file);
+    cur_file_handle.size = 0;
 
-  if (cur_file_handle.fd == -1) {
-    LOG_ERROR("cur_file_handle.fd is -1");
+    if (cur_file_handle.fd == -1) {
+      LOG_ERROR("cur_file_handle.fd is -1");
+    }
   }
 
   LOG_TRACE("FD of newly created file is %d", cur_file_handle.fd);
@@ -958,8 +1397,13 @@ bool WriteAheadFrontendLogger::FileSwitchCondIsTrue() {
   struct stat stat_buf;
   if (cur_file_handle.fd == -1) return false;
 
-  fstat(cur_file_handle.fd, &stat_buf);
-  cur_file_handle.size = stat_buf.st_size;
+  // a preallocated segment is always full size on disk
+  if (segment_writer_) {
+    cur_file_handle.size = segment_writer_->GetWriteOffset();
+  } else {
+    fstat(cur_file_handle.fd, &stat_buf);
+    cur_file_handle.size = stat_buf.st_size;
+  }
 
   return cur_file_handle.size >
          LogManager::GetInstance().GetLogFileSizeLimit() * 1024;
@@ -1005,6 +1449,19 @@ void WriteAheadFrontendLogger::OpenNextLogFile() {
 
   LOG_TRACE("FD of opened file is %d", (int)cur_file_handle.fd);
 
+  // The first frame starts after the header
+  recovery_generation_ = log_files_[log_file_cursor_]->GetLogNumber();
+  recovery_frame_end_ = 0;
+
+  // Records are read a few bytes at a time, so have the stream fill a large
+  // buffer with every read and the kernel read ahead
+  if (recovery_read_buffer_ == nullptr) {
+    recovery_read_buffer_.reset(new char[recovery_read_buffer_size]);
+  }
+  setvbuf(cur_file_handle.file, recovery_read_buffer_.get(), _IOFBF,
+          recovery_read_buffer_size);
+  posix_fadvise(cur_file_handle.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
   // Skip first 8 bytes of max commit id
   size_t read_size =
       fread((void *)&temp_max_log_id_file, sizeof(temp_max_log_id_file), 1,
@@ -1046,11 +1503,27 @@ void WriteAheadFrontendLogger::TruncateLog(cid_t truncate_log_id) {
   // delete stale log files except the one currently being used
   for (int i = 0; i < (int)log_files_.size() - 1; i++) {
     if (truncate_log_id >= log_files_[i]->GetMaxLogId()) {
-      // XXX Do we need directory prefix before log file name?
-      return_val = remove(log_files_[i]->GetLogFileName().c_str());
-      if (return_val != 0) {
-        LOG_ERROR("Couldn't delete log file: %s error: %s",
-                  log_files_[i]->GetLogFileName().c_str(), strerror(errno));
+      // keep a few truncated segments around instead of creating new ones
+      if (segment_writer_ && recycled_files_.size() < max_recycled_files) {
+        std::string recycled_file_name =
+            peloton_log_directory + "/" + RECYCLED_FILE_PREFIX +
+            std::to_string(recycled_file_counter_++) + LOG_FILE_SUFFIX;
+
+        return_val = rename(log_files_[i]->GetLogFileName().c_str(),
+                            recycled_file_name.c_str());
+        if (return_val == 0) {
+          recycled_files_.push_back(recycled_file_name);
+        } else {
+          LOG_ERROR("Couldn't recycle log file: %s error: %s",
+                    log_files_[i]->GetLogFileName().c_str(), strerror(errno));
+        }
+      } else {
+        // XXX Do we need directory prefix before log file name?
+        return_val = remove(log_files_[i]->GetLogFileName().c_str());
+        if (return_val != 0) {
+          LOG_ERROR("Couldn't delete log file: %s error: %s",
+                    log_files_[i]->GetLogFileName().c_str(), strerror(errno));
+        }
       }
       // remove entry from list anyway
       delete log_files_[i];
@@ -1075,6 +1548,14 @@ void WriteAheadFrontendLogger::InitLogDirectory() {
   }
 }
 
+std::string WriteAheadFrontendLogger::GetRecycledFileName() {
+  if (recycled_files_.empty()) return "";
+
+  std::string recycled_file_name = recycled_files_.back();
+  recycled_files_.pop_back();
+  return recycled_file_name;
+}
+
 std::string WriteAheadFrontendLogger::GetFileNameFromVersion(int version) {
   return std::string(peloton_log_directory.c_str()) + "/" + LOG_FILE_PREFIX +
          std::to_string(version) + LOG_FILE_SUFFIX;
@@ -1082,7 +1563,7 @@ std::string WriteAheadFrontendLogger::GetFileNameFromVersion(int version) {
 
 std::pair<cid_t, cid_t>
 WriteAheadFrontendLogger::ExtractMaxLogIdAndMaxDelimFromLogFileRecords(
-    FILE *log_file) {
+    FILE *log_file, uint32_t generation) {
   bool reached_end_of_file = false;
   struct stat log_stats;
   cid_t max_log_id_so_far = 0, max_delim_so_far = 0;
@@ -1094,7 +1575,16 @@ WriteAheadFrontendLogger::ExtractMaxLogIdAndMaxDelimFromLogFileRecords(
   fstat(file_handle.fd, &log_stats);
   file_handle.size = log_stats.st_size;
 
+  size_t frame_end = 0;
+
   while (reached_end_of_file == false) {
+    // The records end at the first frame that is zero padding, torn or stale
+    if ((size_t)ftell(file_handle.file) >= frame_end &&
+        LoggingUtil::ReadSegmentFrame(file_handle, generation, frame_end) ==
+            false) {
+      break;
+    }
+
     // Read the first byte to identify log record type
     // If that is not possible, then wrap up recovery
     auto record_type = LoggingUtil::GetNextLogRecordType(file_handle);
@@ -14,8 +14,10 @@
 #include <sys/stat.h>
 #include <dirent.h>
 #include <cstring>
+#include <memory>
 
 #include "catalog/manager.h"
+#include "logging/log_segment_writer.h"
 #include "logging/logging_util.h"
 #include "storage/database.h"
 
@@ -139,6 +141,67 @@ LogRecordType LoggingUtil::GetNextLogRecordType(FileHandle &file_handle) {
   return log_record_type;
 }
 
+/**
+ * @brief Enter the next frame of records in a log file
+ * @param generation log number of the file
+ * @param frame_end set to the offset right after the records of the frame
+ * @return false at the end of the log: zero padding, a torn write, or a
+ * frame a recycled segment was written with before
+ */
+bool LoggingUtil::ReadSegmentFrame(FileHandle &file_handle,
+                                   uint32_t generation, size_t &frame_end) {
+  char frame_header[LogSegmentWriter::frame_header_size];
+  if (IsFileTruncated(file_handle, sizeof(frame_header))) {
+    return false;
+  }
+
+  size_t ret = fread(frame_header, 1, sizeof(frame_header), file_handle.file);
+  if (ret != sizeof(frame_header)) {
+    LOG_ERROR("Could not read a log frame header");
+    return false;
+  }
+
+  uint32_t frame_generation, length, checksum;
+  memcpy(&frame_generation, frame_header, sizeof(frame_generation));
+  memcpy(&length, frame_header + sizeof(frame_generation), sizeof(length));
+  memcpy(&checksum, frame_header + sizeof(frame_generation) + sizeof(length),
+         sizeof(checksum));
+
+  if (length == 0) {
+    LOG_TRACE("Reached the zero padding of a log file");
+    return false;
+  }
+
+  if (frame_generation != generation) {
+    LOG_ERROR("Log frame of generation %u in a log file of generation %u",
+              frame_generation, generation);
+    return false;
+  }
+
+  if (IsFileTruncated(file_handle, length)) {
+    LOG_ERROR("Log frame is truncated");
+    return false;
+  }
+
+  // Check the records, then go back to the first one
+  std::unique_ptr<char[]> records(new char[length]);
+  ret = fread(records.get(), 1, length, file_handle.file);
+  if (ret != length ||
+      LogSegmentWriter::GetFrameChecksum(generation, records.get(), length) !=
+          checksum) {
+    LOG_ERROR("Log frame checksum does not match, the write was torn");
+    return false;
+  }
+
+  if (fseek(file_handle.file, -(long)length, SEEK_CUR) != 0) {
+    LOG_ERROR("Error occured in fseek ");
+    return false;
+  }
+
+  frame_end = ftell(file_handle.file) + length;
+  return true;
+}
+
 int LoggingUtil::ExtractNumberFromFileName(const char *name) {
   std::string str(name);
   size_t start_index = str.find_first_of("0123456789");
@@ -0,0 +1,319 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// replication_manager.cpp
+//
+// Identification: src/logging/replication_manager.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <sstream>
+
+#include "common/logger.h"
+#include "common/macros.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "logging/replication_manager.h"
+#include "logging/loggers/wal_frontend_logger.h"
+#include "networking/logging_service.h"
+#include "networking/rpc_channel.h"
+#include "networking/rpc_controller.h"
+#include "networking/rpc_server.h"
+
+namespace peloton {
+namespace logging {
+
+ReplicationManager &ReplicationManager::GetInstance() {
+  static ReplicationManager replication_manager;
+  return replication_manager;
+}
+
+ReplicationManager::ReplicationManager() {
+  replica_count_ = ATOMIC_VAR_INIT(0);
+  standby_ = ATOMIC_VAR_INIT(false);
+}
+
+ReplicationManager::~ReplicationManager() { StopServer(); }
+
+/**
+ * @brief Start the logging service. There is one rpc server per process.
+ */
+bool ReplicationManager::StartServer(int port) {
+  if (server_ != nullptr) {
+    LOG_ERROR("The replication server is running already");
+    return false;
+  }
+
+  server_.reset(new networking::RpcServer(port));
+  service_.reset(new networking::LoggingService());
+  server_->RegisterService(service_.get());
+
+  server_thread_ = std::thread(&networking::RpcServer::Start, server_.get());
+
+  LOG_INFO("Replication server listening on port %d", port);
+  return true;
+}
+
+void ReplicationManager::StopServer() {
+  if (server_thread_.joinable() == false) return;
+
+  server_->Stop();
+  server_thread_.join();
+}
+
+//===--------------------------------------------------------------------===//
+// Primary
+//===--------------------------------------------------------------------===//
+
+/**
+ * @brief Ship the following buffers to the replica too. A replica added
+ * after the first buffer was shipped has to start from a copy of the primary.
+ */
+void ReplicationManager::AddReplica(const std::string &address) {
+  PL_ASSERT(server_ != nullptr);
+
+  std::unique_ptr<Replica> replica(new Replica());
+  replica->address = address;
+  replica->channel.reset(new networking::RpcChannel(address));
+  replica->stub.reset(
+      new networking::PelotonLoggingService_Stub(replica->channel.get()));
+
+  std::lock_guard<std::mutex> lock(replica_mutex_);
+  replica->id = next_replica_id_++;
+  {
+    std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+    acked_sequence_numbers_[replica->id] = next_sequence_number_ - 1;
+    replica_count_ = acked_sequence_numbers_.size();
+  }
+  replicas_.push_back(std::move(replica));
+
+  LOG_INFO("Shipping the log to replica %s", address.c_str());
+}
+
+void ReplicationManager::ShipLogBuffer(std::string &log, cid_t max_commit_id) {
+  if (log.empty()) return;
+
+  std::lock_guard<std::mutex> lock(replica_mutex_);
+
+  networking::LogRecordReplayRequest request;
+  request.mutable_log()->swap(log);
+  request.set_sync_type(networking::ASYNC);
+
+  // The buffer is pending before any replica can acknowledge it
+  {
+    std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+
+    // A replica that missed a buffer gets no further ones
+    replicas_.erase(
+        std::remove_if(replicas_.begin(), replicas_.end(),
+                       [this](const std::unique_ptr<Replica> &replica) {
+                         return acked_sequence_numbers_.count(replica->id) ==
+                                0;
+                       }),
+        replicas_.end());
+
+    request.set_sequence_number(next_sequence_number_++);
+    pending_buffers_.push_back({request.sequence_number(), max_commit_id,
+                                Clock::now(), replicas_.size()});
+
+    shipped_count_++;
+    shipped_bytes_ += request.log().size();
+    shipped_commit_id_ = std::max(shipped_commit_id_, max_commit_id);
+
+    // the last replica was dropped
+    PopReplayedBuffers();
+  }
+
+  // The response arrives through the logging service of this process
+  networking::LogRecordReplayResponse response;
+  for (auto &replica : replicas_) {
+    networking::RpcController controller;
+    request.set_replica_id(replica->id);
+    replica->stub->LogRecordReplay(&controller, &request, &response, nullptr);
+
+    if (controller.Failed()) {
+      LOG_ERROR("Could not ship a log buffer to replica %s : %s",
+                replica->address.c_str(), controller.ErrorText().c_str());
+
+      std::lock_guard<std::mutex> pending_lock(pending_mutex_);
+      DropReplica(replica->id);
+    }
+  }
+}
+
+/**
+ * @brief Every replica acknowledges every buffer, in the order they were
+ * shipped. A buffer is replayed once all of them did. A replica that could
+ * not replay a buffer is dropped, since it misses the following ones.
+ */
+void ReplicationManager::AcknowledgeLogBuffer(oid_t replica_id,
+                                              int64_t sequence_number,
+                                              bool replayed) {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+
+  auto acked_itr = acked_sequence_numbers_.find(replica_id);
+  // late acknowledgement of a dropped replica
+  if (acked_itr == acked_sequence_numbers_.end()) return;
+
+  if (replayed == false) {
+    LOG_ERROR("Replica %u could not replay log buffer %ld", replica_id,
+              sequence_number);
+    DropReplica(replica_id);
+    return;
+  }
+
+  // An acknowledgement covers the buffers before it too
+  for (auto &pending_buffer : pending_buffers_) {
+    if (pending_buffer.sequence_number > sequence_number) break;
+    if (pending_buffer.sequence_number > acked_itr->second &&
+        pending_buffer.acks_remaining != 0) {
+      pending_buffer.acks_remaining--;
+    }
+  }
+  acked_itr->second = std::max(acked_itr->second, sequence_number);
+
+  PopReplayedBuffers();
+}
+
+/**
+ * @brief The buffers the replica did not acknowledge yet no longer wait for
+ * it. It is removed from the replicas before the next buffer is shipped.
+ */
+void ReplicationManager::DropReplica(oid_t replica_id) {
+  auto acked_itr = acked_sequence_numbers_.find(replica_id);
+  if (acked_itr == acked_sequence_numbers_.end()) return;
+
+  for (auto &pending_buffer : pending_buffers_) {
+    if (pending_buffer.sequence_number > acked_itr->second &&
+        pending_buffer.acks_remaining != 0) {
+      pending_buffer.acks_remaining--;
+    }
+  }
+
+  acked_sequence_numbers_.erase(acked_itr);
+  replica_count_ = acked_sequence_numbers_.size();
+
+  LOG_ERROR("Dropped replica %u, it has to start over from a copy of the "
+            "primary", replica_id);
+
+  PopReplayedBuffers();
+}
+
+void ReplicationManager::PopReplayedBuffers() {
+  // Every replica replayed the buffers at the front
+  auto now = Clock::now();
+  while (pending_buffers_.empty() == false &&
+         pending_buffers_.front().acks_remaining == 0) {
+    auto &pending_buffer = pending_buffers_.front();
+    double lag = std::chrono::duration_cast<std::chrono::microseconds>(
+                     now - pending_buffer.ship_time).count();
+
+    replayed_count_++;
+    replayed_commit_id_ =
+        std::max(replayed_commit_id_, pending_buffer.max_commit_id);
+    total_lag_ += lag;
+    max_lag_ = std::max(max_lag_, lag);
+
+    pending_buffers_.pop_front();
+  }
+
+  pending_cv_.notify_all();
+}
+
+bool ReplicationManager::WaitForReplicas(std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(pending_mutex_);
+  return pending_cv_.wait_for(lock, timeout,
+                              [this] { return pending_buffers_.empty(); });
+}
+
+//===--------------------------------------------------------------------===//
+// Standby
+//===--------------------------------------------------------------------===//
+
+void ReplicationManager::SetStandby(bool standby) {
+  std::lock_guard<std::mutex> lock(replay_mutex_);
+
+  if (standby && replayer_ == nullptr) {
+    // replays into memory, it has no log files of its own
+    replayer_.reset(new WriteAheadFrontendLogger(true));
+  }
+
+  standby_ = standby;
+}
+
+/**
+ * @brief Buffers arrive in the event thread, one at a time and in the order
+ * the primary flushed them
+ */
+bool ReplicationManager::ReplayLogBuffer(const std::string &log) {
+  std::lock_guard<std::mutex> lock(replay_mutex_);
+
+  if (replayer_ == nullptr) {
+    LOG_ERROR("Received a log buffer, but this is not a standby");
+    return false;
+  }
+
+  if (replayer_->ReplayLogBuffer(log.data(), log.size()) == false) {
+    return false;
+  }
+
+  replayed_buffer_count_++;
+  replayed_bytes_ += log.size();
+  return true;
+}
+
+cid_t ReplicationManager::GetReplayedCommitId() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  return txn_manager.GetCurrentCommitId() - 1;
+}
+
+//===--------------------------------------------------------------------===//
+// Lag
+//===--------------------------------------------------------------------===//
+
+cid_t ReplicationManager::GetCommitLag() {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  return shipped_commit_id_ - replayed_commit_id_;
+}
+
+double ReplicationManager::GetAverageLag() {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  if (replayed_count_ == 0) return 0;
+  return total_lag_ / replayed_count_;
+}
+
+double ReplicationManager::GetMaxLag() {
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  return max_lag_;
+}
+
+std::string ReplicationManager::GetInfo() {
+  std::ostringstream os;
+
+  if (IsStandby()) {
+    std::lock_guard<std::mutex> lock(replay_mutex_);
+    os << "Standby :: replayed buffers : " << replayed_buffer_count_
+       << " bytes : " << replayed_bytes_
+       << " commit id : " << GetReplayedCommitId();
+    return os.str();
+  }
+
+  std::lock_guard<std::mutex> lock(pending_mutex_);
+  os << "Primary :: replicas : " << GetReplicaCount()
+     << " shipped buffers : " << shipped_count_
+     << " bytes : " << shipped_bytes_
+     << " replayed buffers : " << replayed_count_
+     << " pending : " << pending_buffers_.size()
+     << " commit lag : " << (shipped_commit_id_ - replayed_commit_id_)
+     << " avg lag (us) : "
+     << (replayed_count_ == 0 ? 0 : total_lag_ / replayed_count_)
+     << " max lag (us) : " << max_lag_;
+  return os.str();
+}
+
+}  // namespace logging
+}  // namespace peloton
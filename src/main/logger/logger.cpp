@@ -26,6 +26,12 @@ extern size_t peloton_data_file_size;
 
 extern int64_t peloton_wait_timeout;
 
+extern int peloton_flush_frequency_micros;
+
+extern int peloton_group_commit_size;
+
+extern int peloton_recovery_thread_count;
+
 namespace peloton {
 namespace benchmark {
 
@@ -47,6 +53,15 @@ void RunBenchmark() {
   peloton_logging_mode = state.logging_type;
   peloton_data_file_size = state.data_file_size;
   peloton_wait_timeout = state.wait_timeout;
+  peloton_flush_frequency_micros = state.commit_delay;
+  peloton_group_commit_size = state.group_commit_size;
+  peloton_recovery_thread_count = state.recovery_thread_count;
+
+  // A standby replays the log of the primary
+  if (state.standby) {
+    RunStandby();
+    return;
+  }
 
   //===--------------------------------------------------------------------===//
   // WAL
@@ -32,25 +32,37 @@ void Usage(FILE* out) {
           "   -a --asynchronous-mode :  Asynchronous mode \n"
           "   -e --experiment-type   :  Experiment Type \n"
           "   -f --data-file-size    :  Data file size (MB) \n"
+          "   -g --group-commit-size :  Max commits in a commit group \n"
           "   -l --logging-type      :  Logging type \n"
+          "   -m --commit-delay      :  Group commit delay (us) \n"
           "   -n --nvm-latency       :  NVM latency \n"
+          "   -o --replication-port  :  Replication server port \n"
           "   -p --pcommit-latency   :  pcommit latency \n"
+          "   -r --recovery-threads  :  Threads replaying the log \n"
           "   -v --flush-mode        :  Flush mode \n"
           "   -w --commit-interval   :  Group commit interval \n"
-          "   -y --benchmark-type    :  Benchmark type \n");
+          "   -x --replicas          :  Replicas (ip:port,ip:port) \n"
+          "   -y --benchmark-type    :  Benchmark type \n"
+          "   -z --standby           :  Run as a standby \n");
 }
 
 static struct option opts[] = {
     {"asynchronous_mode", optional_argument, NULL, 'a'},
     {"experiment-type", optional_argument, NULL, 'e'},
     {"data-file-size", optional_argument, NULL, 'f'},
+    {"group-commit-size", optional_argument, NULL, 'g'},
     {"logging-type", optional_argument, NULL, 'l'},
+    {"commit-delay", optional_argument, NULL, 'm'},
     {"nvm-latency", optional_argument, NULL, 'n'},
+    {"replication-port", optional_argument, NULL, 'o'},
     {"pcommit-latency", optional_argument, NULL, 'p'},
+    {"recovery-threads", optional_argument, NULL, 'r'},
     {"skew", optional_argument, NULL, 's'},
     {"flush-mode", optional_argument, NULL, 'v'},
     {"commit-interval", optional_argument, NULL, 'w'},
+    {"replicas", optional_argument, NULL, 'x'},
     {"benchmark-type", optional_argument, NULL, 'y'},
+    {"standby", optional_argument, NULL, 'z'},
     {NULL, 0, NULL, 0}};
 
 static void ValidateLoggingType(const configuration& state) {
@@ -160,6 +172,34 @@ static void ValidateWaitTimeout(const configuration& state) {
   LOG_INFO("wait_timeout :: %d", state.wait_timeout);
 }
 
+static void ValidateCommitDelay(const configuration& state) {
+  if (state.commit_delay < 0) {
+    LOG_ERROR("Invalid commit_delay :: %d", state.commit_delay);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("commit_delay :: %d", state.commit_delay);
+}
+
+static void ValidateGroupCommitSize(const configuration& state) {
+  if (state.group_commit_size < 0) {
+    LOG_ERROR("Invalid group_commit_size :: %d", state.group_commit_size);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("group_commit_size :: %d", state.group_commit_size);
+}
+
+static void ValidateRecoveryThreadCount(const configuration& state) {
+  if (state.recovery_thread_count < 0) {
+    LOG_ERROR("Invalid recovery_thread_count :: %d",
+              state.recovery_thread_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("recovery_thread_count :: %d", state.recovery_thread_count);
+}
+
 static void ValidateFlushMode(const configuration& state) {
   if (state.flush_mode <= 0 || state.flush_mode >= 3) {
     LOG_ERROR("Invalid flush_mode :: %d", state.flush_mode);
@@ -198,6 +238,44 @@ static void ValidatePCOMMITLatency(const configuration& state) {
   LOG_INFO("pcommit_latency :: %d", state.pcommit_latency);
 }
 
+static void ValidateReplication(const configuration& state) {
+  if (state.replication_port < 0 || state.replication_port >= 65535) {
+    LOG_ERROR("Invalid replication_port :: %d", state.replication_port);
+    exit(EXIT_FAILURE);
+  }
+
+  // The acknowledgements of the replicas come back through the server
+  if ((state.standby || state.replicas.empty() == false) &&
+      state.replication_port == 0) {
+    LOG_ERROR("Replication needs a replication_port");
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.standby && state.replicas.empty() == false) {
+    LOG_ERROR("A standby does not ship the log to replicas");
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("replication_port :: %d", state.replication_port);
+  for (auto& replica : state.replicas) {
+    LOG_INFO("replica :: %s", replica.c_str());
+  }
+  LOG_INFO("standby :: %d", state.standby);
+}
+
+// Splits a comma separated list of ip:port
+static void ParseReplicas(const char* arg, std::vector<std::string>& replicas) {
+  std::string list(arg);
+  size_t start = 0;
+
+  while (start < list.size()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) end = list.size();
+    if (end > start) replicas.push_back(list.substr(start, end - start));
+    start = end + 1;
+  }
+}
+
 static void ValidateLogFileDir(configuration& state) {
   struct stat data_stat;
 
@@ -253,11 +331,16 @@ void ParseArguments(int argc, char* argv[], configuration& state) {
 
   state.experiment_type = EXPERIMENT_TYPE_THROUGHPUT;
   state.wait_timeout = 200;
+  state.commit_delay = 0;
+  state.group_commit_size = 0;
+  state.recovery_thread_count = 0;
   state.benchmark_type = BENCHMARK_TYPE_YCSB;
   state.flush_mode = 2;
   state.nvm_latency = 0;
   state.pcommit_latency = 0;
   state.asynchronous_mode = ASYNCHRONOUS_TYPE_SYNC;
+  state.replication_port = 0;
+  state.standby = false;
 
   // Default YCSB Values
   ycsb::state.scale_factor = 1;
@@ -275,11 +358,12 @@ void ParseArguments(int argc, char* argv[], configuration& state) {
   // Parse args
   while (1) {
     int idx = 0;
-    // logger - a:e:f:hl:n:p:v:w:y:
+    // logger - a:e:f:g:hl:m:n:o:p:r:v:w:x:y:z:
     // ycsb   - b:c:d:k:s:u:
     // tpcc   - b:d:k:
-    int c =
-        getopt_long(argc, argv, "a:e:f:hl:n:p:v:w:y:b:c:d:k:s:u:", opts, &idx);
+    int c = getopt_long(argc, argv,
+                        "a:e:f:g:hl:m:n:o:p:r:v:w:x:y:z:b:c:d:k:s:u:", opts,
+                        &idx);
 
     if (c == -1) break;
 
@@ -293,24 +377,42 @@ void ParseArguments(int argc, char* argv[], configuration& state) {
       case 'f':
         state.data_file_size = atoi(optarg);
         break;
+      case 'g':
+        state.group_commit_size = atoi(optarg);
+        break;
       case 'l':
         state.logging_type = (LoggingType)atoi(optarg);
         break;
+      case 'm':
+        state.commit_delay = atoi(optarg);
+        break;
       case 'n':
         state.nvm_latency = atoi(optarg);
         break;
+      case 'o':
+        state.replication_port = atoi(optarg);
+        break;
       case 'p':
         state.pcommit_latency = atoi(optarg);
         break;
+      case 'r':
+        state.recovery_thread_count = atoi(optarg);
+        break;
       case 'v':
         state.flush_mode = atoi(optarg);
         break;
       case 'w':
         state.wait_timeout = atoi(optarg);
         break;
+      case 'x':
+        ParseReplicas(optarg, state.replicas);
+        break;
       case 'y':
         state.benchmark_type = (BenchmarkType)atoi(optarg);
         break;
+      case 'z':
+        state.standby = atoi(optarg);
+        break;
 
       // YCSB
       case 'b':
@@ -357,9 +459,13 @@ void ParseArguments(int argc, char* argv[], configuration& state) {
   ValidateDataFileSize(state);
   ValidateLogFileDir(state);
   ValidateWaitTimeout(state);
+  ValidateCommitDelay(state);
+  ValidateGroupCommitSize(state);
+  ValidateRecoveryThreadCount(state);
   ValidateFlushMode(state);
   ValidateNVMLatency(state);
   ValidatePCOMMITLatency(state);
+  ValidateReplication(state);
 
   // Print YCSB configuration
   if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
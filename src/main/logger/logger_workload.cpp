@@ -24,6 +24,7 @@
 #include "common/logger.h"
 #include "common/timer.h"
 #include "logging/log_manager.h"
+#include "logging/replication_manager.h"
 
 #include "benchmark/logger/logger_workload.h"
 
@@ -66,14 +67,19 @@ std::ofstream out("outputfile.summary");
 
 size_t GetLogFileSize();
 
-static void WriteOutput(double value) {
+static void WriteOutput(double value, size_t fsync_count = 0) {
+  // Replication lag (in us)
+  double replication_lag =
+      logging::ReplicationManager::GetInstance().GetAverageLag();
+
   LOG_INFO("----------------------------------------------------------");
-  LOG_INFO("%d %d %lf %d %d %d %d %d %d %d %d :: %lf", state.benchmark_type,
-           state.logging_type, ycsb::state.update_ratio,
+  LOG_INFO("%d %d %lf %d %d %d %d %d %d %d %d %d %d :: %lf %lu %lu %lf",
+           state.benchmark_type, state.logging_type, ycsb::state.update_ratio,
            ycsb::state.backend_count, ycsb::state.scale_factor,
            ycsb::state.skew_factor, ycsb::state.duration, state.nvm_latency,
            state.pcommit_latency, state.flush_mode, state.asynchronous_mode,
-           value);
+           state.commit_delay, state.group_commit_size, value, fsync_count,
+           state.replicas.size(), replication_lag);
 
   out << state.benchmark_type << " ";
   out << state.logging_type << " ";
@@ -86,10 +92,43 @@ static void WriteOutput(double value) {
   out << state.pcommit_latency << " ";
   out << state.flush_mode << " ";
   out << state.asynchronous_mode << " ";
-  out << value << "\n";
+  out << state.commit_delay << " ";
+  out << state.group_commit_size << " ";
+  out << value << " ";
+  out << fsync_count << " ";
+  out << state.replicas.size() << " ";
+  out << replication_lag << "\n";
   out.flush();
 }
 
+// Total fsyncs issued by the frontend loggers
+static size_t GetFsyncCount() {
+  auto& log_manager = logging::LogManager::GetInstance();
+  size_t fsync_count = 0;
+
+  for (auto& frontend_logger : log_manager.GetFrontendLoggersList()) {
+    fsync_count += frontend_logger->GetFsyncCount();
+  }
+
+  return fsync_count;
+}
+
+// Write latencies of the direct I/O log segments
+static void PrintSegmentWriterInfo() {
+  auto& log_manager = logging::LogManager::GetInstance();
+
+  for (auto& frontend_logger : log_manager.GetFrontendLoggersList()) {
+    auto wal_frontend_logger =
+        dynamic_cast<logging::WriteAheadFrontendLogger*>(frontend_logger.get());
+    if (wal_frontend_logger == nullptr) continue;
+
+    auto segment_writer = wal_frontend_logger->GetSegmentWriter();
+    if (segment_writer == nullptr) continue;
+
+    LOG_INFO("%s", segment_writer->GetInfo().c_str());
+  }
+}
+
 std::string GetFilePath(std::string directory_path, std::string file_name) {
   std::string file_path = directory_path;
 
@@ -248,6 +287,15 @@ bool PrepareLogFile() {
                       std::to_string(state.asynchronous_mode));
   }
 
+  // Ship the log to the replicas
+  auto& replication_manager = logging::ReplicationManager::GetInstance();
+  if (state.replicas.empty() == false) {
+    replication_manager.StartServer(state.replication_port);
+    for (auto& replica : state.replicas) {
+      replication_manager.AddReplica(replica);
+    }
+  }
+
   Timer<> timer;
   std::thread thread;
 
@@ -272,19 +320,41 @@ bool PrepareLogFile() {
   // Pick metrics based on benchmark type
   double throughput = 0;
   double latency = 0;
+  int duration = 0;
   if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
     throughput = ycsb::state.throughput;
     latency = ycsb::state.latency;
+    duration = ycsb::state.duration;
   } else if (state.benchmark_type == BENCHMARK_TYPE_TPCC) {
     throughput = tpcc::state.throughput;
     latency = tpcc::state.latency;
+    duration = tpcc::state.duration;
+  }
+
+  // How well the commits were grouped
+  auto fsync_count = GetFsyncCount();
+  if (fsync_count != 0) {
+    LOG_INFO("commits/s : %.0lf fsyncs : %lu commits/fsync : %.2lf",
+             throughput, fsync_count,
+             throughput * duration / 1000 / fsync_count);
+  }
+
+  PrintSegmentWriterInfo();
+
+  // How far behind the replicas were
+  if (replication_manager.HasReplicas()) {
+    if (replication_manager.WaitForReplicas(std::chrono::seconds(10)) ==
+        false) {
+      LOG_ERROR("The replicas did not replay the whole log");
+    }
+    LOG_INFO("%s", replication_manager.GetInfo().c_str());
   }
 
   // Log the build log time
   if (state.experiment_type == EXPERIMENT_TYPE_THROUGHPUT) {
-    WriteOutput(throughput);
+    WriteOutput(throughput, fsync_count);
   } else if (state.experiment_type == EXPERIMENT_TYPE_LATENCY) {
-    WriteOutput(latency);
+    WriteOutput(latency, fsync_count);
   }
 
   return true;
@@ -342,6 +412,79 @@ void DoRecovery() {
   }
 }
 
+//===--------------------------------------------------------------------===//
+// STANDBY
+//===--------------------------------------------------------------------===//
+
+// Tuples of the table visible to the current txn
+static size_t CountVisibleTuples(storage::DataTable* table) {
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = concurrency::current_txn;
+  size_t tuple_count = 0;
+
+  concurrency::VisibilityBitmap visibility;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+    if (tile_group == nullptr) continue;
+
+    txn_manager.ComputeVisibility(tile_group->GetHeader(),
+                                  txn->GetBeginCommitId(),
+                                  txn->GetTransactionId(), visibility);
+    for (auto word : visibility) {
+      tuple_count += __builtin_popcountll(word);
+    }
+  }
+
+  return tuple_count;
+}
+
+/**
+ * @brief replay the log of the primary while serving snapshot reads
+ */
+void RunStandby() {
+  // Same tables as the primary, their tuples come through the log
+  storage::DataTable* table = nullptr;
+  int duration = 0;
+  if (state.benchmark_type == BENCHMARK_TYPE_YCSB) {
+    ycsb::CreateYCSBDatabase();
+    table = ycsb::user_table;
+    duration = ycsb::state.duration;
+  } else if (state.benchmark_type == BENCHMARK_TYPE_TPCC) {
+    tpcc::CreateTPCCDatabase();
+    table = tpcc::stock_table;
+    duration = tpcc::state.duration;
+  }
+
+  auto& replication_manager = logging::ReplicationManager::GetInstance();
+  replication_manager.SetStandby(true);
+  replication_manager.StartServer(state.replication_port);
+
+  // Serve until the primary is done, with time for it to load and for the
+  // standby to catch up
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto end_time = std::chrono::steady_clock::now() +
+                  std::chrono::milliseconds(2 * duration + 10000);
+  size_t read_count = 0;
+  size_t tuple_count = 0;
+
+  while (std::chrono::steady_clock::now() < end_time) {
+    txn_manager.BeginTransaction();
+    tuple_count = CountVisibleTuples(table);
+    txn_manager.CommitTransaction();
+    read_count++;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+
+  LOG_INFO("%s", replication_manager.GetInfo().c_str());
+  LOG_INFO("Snapshot reads : %lu visible tuples : %lu", read_count,
+           tuple_count);
+
+  replication_manager.StopServer();
+}
+
 //===--------------------------------------------------------------------===//
 // WRITING LOG RECORD
 //===--------------------------------------------------------------------===//
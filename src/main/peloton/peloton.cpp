@@ -16,11 +16,13 @@
 
 #include "wire/socket_base.h"
 #include "wire/wire.h"
+#include "wire/event_server.h"
 #include "common/stack_trace.h"
 #include "common/init.h"
 
 DECLARE_bool(help);
 DECLARE_bool(h);
+DECLARE_string(connection_model);
 
 // Peloton process begins execution here.
 int main(int argc, char *argv[]) {
@@ -41,9 +43,17 @@ int main(int argc, char *argv[]) {
   // Launch server
   peloton::wire::Server server;
   peloton::wire::StartServer(&server);
-  peloton::wire::HandleConnections<peloton::wire::PacketManager,
-                                   peloton::wire::PktBuf>(&server);
 
+  if (FLAGS_connection_model == "thread") {
+    // one thread per client connection
+    peloton::wire::HandleConnections<peloton::wire::PacketManager,
+                                     peloton::wire::PktBuf>(&server);
+  } else {
+    peloton::wire::EventServer event_server(&server, FLAGS_io_threads,
+                                            FLAGS_worker_threads,
+                                            FLAGS_max_in_flight);
+    event_server.Run();
+  }
 
 
   // Teardown
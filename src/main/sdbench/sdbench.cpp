@@ -49,6 +49,18 @@ void RunBenchmark() {
         RunInsertTest();
         break;
 
+      case OPERATOR_TYPE_PREDICATE:
+        RunPredicateTest();
+        break;
+
+      case OPERATOR_TYPE_VISIBILITY:
+        RunVisibilityTest();
+        break;
+
+      case OPERATOR_TYPE_COMPRESSION:
+        RunCompressionTest();
+        break;
+
       default:
         LOG_ERROR("Unsupported test type : %d", state.operator_type);
         break;
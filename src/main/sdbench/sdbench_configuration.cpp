@@ -30,6 +30,7 @@ void Usage() {
       "   -s --selectivity       :  Selectivity\n"
       "   -p --projectivity      :  Projectivity\n"
       "   -l --layout            :  Layout\n"
+      "   -j --header_layout     :  Tuple header layout\n"
       "   -t --transactions      :  # of transactions\n"
       "   -e --experiment_type   :  Experiment Type\n"
       "   -c --column_count      :  # of columns\n"
@@ -37,6 +38,7 @@ void Usage() {
       "   -g --tuples_per_tg     :  # of tuples per tilegroup\n"
       "   -y --hybrid_scan_type  :  hybrid scan type\n"
       "   -i --index_count       :  # of indexes\n"
+      "   -d --parallelism       :  # of threads for sequential scans\n"
   );
   exit(EXIT_FAILURE);
 }
@@ -47,6 +49,7 @@ static struct option opts[] = {
     {"selectivity", optional_argument, NULL, 's'},
     {"projectivity", optional_argument, NULL, 'p'},
     {"layout", optional_argument, NULL, 'l'},
+    {"header_layout", optional_argument, NULL, 'j'},
     {"transactions", optional_argument, NULL, 't'},
     {"experiment-type", optional_argument, NULL, 'e'},
     {"column_count", optional_argument, NULL, 'c'},
@@ -54,6 +57,7 @@ static struct option opts[] = {
     {"tuples_per_tg", optional_argument, NULL, 'g'},
     {"hybrid_scan_type", optional_argument, NULL, 'y'},
     {"index_count", optional_argument, NULL, 'i'},
+    {"parallelism", optional_argument, NULL, 'd'},
     {NULL, 0, NULL, 0}
 };
 
@@ -69,7 +73,7 @@ void GenerateSequence(oid_t column_count) {
 }
 
 static void ValidateOperator(const configuration &state) {
-  if (state.operator_type < 1 || state.operator_type > 4) {
+  if (state.operator_type < 1 || state.operator_type > 5) {
     LOG_ERROR("Invalid operator type :: %d", state.operator_type);
     exit(EXIT_FAILURE);
   } else {
@@ -80,6 +84,15 @@ static void ValidateOperator(const configuration &state) {
       case OPERATOR_TYPE_INSERT:
         LOG_INFO("%s : INSERT", "operator_type ");
         break;
+      case OPERATOR_TYPE_PREDICATE:
+        LOG_INFO("%s : PREDICATE", "operator_type ");
+        break;
+      case OPERATOR_TYPE_VISIBILITY:
+        LOG_INFO("%s : VISIBILITY", "operator_type ");
+        break;
+      case OPERATOR_TYPE_COMPRESSION:
+        LOG_INFO("%s : COMPRESSION", "operator_type ");
+        break;
       default:
         break;
     }
@@ -137,6 +150,24 @@ static void ValidateLayout(const configuration &state) {
   }
 }
 
+static void ValidateHeaderLayout(const configuration &state) {
+  if (state.header_layout < 0 || state.header_layout > 1) {
+    LOG_ERROR("Invalid header_layout :: %d", state.header_layout);
+    exit(EXIT_FAILURE);
+  } else {
+    switch (state.header_layout) {
+      case HEADER_LAYOUT_ROW:
+        LOG_INFO("%s : ROW", "header_layout ");
+        break;
+      case HEADER_LAYOUT_COLUMN:
+        LOG_INFO("%s : COLUMN", "header_layout ");
+        break;
+      default:
+        break;
+    }
+  }
+}
+
 static void ValidateProjectivity(const configuration &state) {
   if (state.projectivity < 0 || state.projectivity > 1) {
     LOG_ERROR("Invalid projectivity :: %.1lf", state.projectivity);
@@ -182,6 +213,15 @@ static void ValidateIndexCount(const configuration &state) {
   LOG_INFO("%s : %d", "index_count", state.index_count);
 }
 
+static void ValidateParallelism(const configuration &state) {
+  if (state.parallelism <= 0) {
+    LOG_ERROR("Invalid parallelism :: %d", state.parallelism);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", "parallelism", state.parallelism);
+}
+
 static void ValidateWriteRatio(const configuration &state) {
   if (state.write_ratio < 0 || state.write_ratio > 1) {
     LOG_ERROR("Invalid write_ratio :: %.1lf", state.write_ratio);
@@ -215,19 +255,21 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   state.projectivity = 1.0;
 
   state.layout_mode = LAYOUT_ROW;
+  state.header_layout = HEADER_LAYOUT_ROW;
 
   state.experiment_type = EXPERIMENT_TYPE_INVALID;
 
   state.column_count = 10;
   state.write_ratio = 0.0;
   state.index_count = 1;
+  state.parallelism = 1;
 
   state.adapt = false;
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "aho:k:s:p:l:t:e:c:w:g:y:i:", opts, &idx);
+    int c = getopt_long(argc, argv, "aho:k:s:p:l:j:t:e:c:w:g:y:i:d:", opts, &idx);
 
     if (c == -1) break;
 
@@ -247,6 +289,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'l':
         state.layout_mode = (LayoutType)atoi(optarg);
         break;
+      case 'j':
+        state.header_layout = (HeaderLayoutType)atoi(optarg);
+        break;
       case 't':
         state.transactions = atoi(optarg);
         break;
@@ -268,6 +313,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'i':
         state.index_count = atoi(optarg);
         break;
+      case 'd':
+        state.parallelism = atoi(optarg);
+        break;
 
       case 'h':
         Usage();
@@ -284,6 +332,7 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
     ValidateHybridScanType(state);
     ValidateOperator(state);
     ValidateLayout(state);
+    ValidateHeaderLayout(state);
     ValidateSelectivity(state);
     ValidateProjectivity(state);
     ValidateScaleFactor(state);
@@ -291,6 +340,7 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
     ValidateIndexCount(state);
     ValidateWriteRatio(state);
     ValidateTuplesPerTileGroup(state);
+    ValidateParallelism(state);
 
     LOG_INFO("%s : %lu", "transactions", state.transactions);
   } else {
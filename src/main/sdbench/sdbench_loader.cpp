@@ -69,7 +69,8 @@ void CreateTable() {
   bool adapt_table = true;
   sdbench_table.reset(storage::TableFactory::GetDataTable(
       INVALID_OID, INVALID_OID, table_schema, table_name,
-      state.tuples_per_tilegroup, own_schema, adapt_table));
+      state.tuples_per_tilegroup, own_schema, adapt_table,
+      state.header_layout));
 
   // PRIMARY INDEXES
   for(int index_itr = 0; index_itr < state.index_count; index_itr++) {
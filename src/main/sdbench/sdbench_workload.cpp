@@ -19,6 +19,7 @@
 #include <ctime>
 #include <thread>
 #include <algorithm>
+#include <numeric>
 
 #include "expression/expression_util.h"
 #include "brain/clusterer.h"
@@ -34,6 +35,7 @@
 #include "common/logger.h"
 #include "common/timer.h"
 #include "common/macros.h"
+#include "concurrency/epoch_manager.h"
 #include "concurrency/transaction.h"
 #include "concurrency/transaction_manager_factory.h"
 
@@ -49,12 +51,15 @@
 #include "executor/update_executor.h"
 #include "executor/nested_loop_join_executor.h"
 #include "executor/hybrid_scan_executor.h"
+#include "executor/gather_executor.h"
 
 #include "expression/abstract_expression.h"
 #include "expression/constant_value_expression.h"
 #include "expression/tuple_value_expression.h"
 #include "expression/comparison_expression.h"
 #include "expression/conjunction_expression.h"
+#include "expression/container_tuple.h"
+#include "expression/expression_batch.h"
 
 #include "index/index_factory.h"
 
@@ -67,10 +72,12 @@
 #include "planner/projection_plan.h"
 #include "planner/nested_loop_join_plan.h"
 #include "planner/hybrid_scan_plan.h"
+#include "planner/gather_plan.h"
 
 #include "storage/tile.h"
 #include "storage/tile_group.h"
 #include "storage/tile_group_header.h"
+#include "storage/tile_group_compressor.h"
 #include "storage/data_table.h"
 #include "storage/table_factory.h"
 
@@ -173,6 +180,85 @@ static void WriteOutput(double duration) {
   out.flush();
 }
 
+static void WritePredicateOutput(double scalar_duration,
+                                 double batch_duration) {
+  // Convert to ms
+  scalar_duration *= 1000;
+  batch_duration *= 1000;
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%d %.2lf %d %d :: scalar %.2lf ms batch %.2lf ms",
+           state.layout_mode,
+           state.selectivity,
+           state.scale_factor,
+           state.tuples_per_tilegroup,
+           scalar_duration,
+           batch_duration);
+
+  out << state.layout_mode << " ";
+  out << state.operator_type << " ";
+  out << state.selectivity << " ";
+  out << state.column_count << " ";
+  out << state.tuples_per_tilegroup << " ";
+  out << state.scale_factor << " ";
+  out << scalar_duration << " ";
+  out << batch_duration << "\n";
+  out.flush();
+}
+
+static void WriteVisibilityOutput(double duration, size_t tuple_count) {
+  // Convert to ms
+  duration *= 1000;
+  double throughput = (duration > 0) ? tuple_count / duration / 1000 : 0;
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%d %d %d :: %.2lf ms %.1lf M tuples/s",
+           state.header_layout,
+           state.scale_factor,
+           state.tuples_per_tilegroup,
+           duration,
+           throughput);
+
+  out << state.header_layout << " ";
+  out << state.operator_type << " ";
+  out << state.tuples_per_tilegroup << " ";
+  out << state.scale_factor << " ";
+  out << duration << " ";
+  out << throughput << "\n";
+  out.flush();
+}
+
+static void WriteCompressionOutput(size_t plain_size, size_t compressed_size,
+                                   double plain_duration,
+                                   double compressed_duration) {
+  // Convert to ms
+  plain_duration *= 1000;
+  compressed_duration *= 1000;
+
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%d %.2lf %d %d :: plain %lu bytes %.2lf ms compressed %lu bytes "
+           "%.2lf ms",
+           state.layout_mode,
+           state.selectivity,
+           state.scale_factor,
+           state.tuples_per_tilegroup,
+           plain_size,
+           plain_duration,
+           compressed_size,
+           compressed_duration);
+
+  out << state.layout_mode << " ";
+  out << state.operator_type << " ";
+  out << state.selectivity << " ";
+  out << state.tuples_per_tilegroup << " ";
+  out << state.scale_factor << " ";
+  out << plain_size << " ";
+  out << plain_duration << " ";
+  out << compressed_size << " ";
+  out << compressed_duration << "\n";
+  out.flush();
+}
+
 static int GetLowerBound() {
   int tuple_count = state.scale_factor * state.tuples_per_tilegroup;
   int predicate_offset = 0.1 * tuple_count;
@@ -288,6 +374,19 @@ void RunDirectTest() {
   executor::HybridScanExecutor hybrid_scan_executor(&hybrid_scan_node,
                                                     context.get());
 
+  // Sequential scans can instead be split up over several threads
+  bool is_parallel = (state.parallelism > 1 &&
+                      state.hybrid_scan_type == HYBRID_SCAN_TYPE_SEQUENTIAL);
+
+  planner::SeqScanPlan seq_scan_node(sdbench_table.get(),
+                                     CreatePredicate(lower_bound, upper_bound),
+                                     column_ids);
+  executor::SeqScanExecutor seq_scan_executor(&seq_scan_node, context.get());
+
+  planner::GatherPlan gather_node(state.parallelism);
+  executor::GatherExecutor gather_executor(&gather_node, context.get());
+  gather_executor.AddChild(&seq_scan_executor);
+
   /////////////////////////////////////////////////////////
   // MATERIALIZE
   /////////////////////////////////////////////////////////
@@ -316,7 +415,11 @@ void RunDirectTest() {
                                         physify_flag);
 
   executor::MaterializationExecutor mat_executor(&mat_node, nullptr);
-  mat_executor.AddChild(&hybrid_scan_executor);
+  if (is_parallel) {
+    mat_executor.AddChild(&gather_executor);
+  } else {
+    mat_executor.AddChild(&hybrid_scan_executor);
+  }
 
   /////////////////////////////////////////////////////////
   // INSERT
@@ -357,6 +460,211 @@ void RunDirectTest() {
   txn_manager.CommitTransaction();
 }
 
+/*
+ * Evaluate the scan predicate over the whole table, first tuple at a time
+ * and then with batch evaluation, without the rest of the scan around it.
+ */
+void RunPredicateTest() {
+  const int lower_bound = GetLowerBound();
+  const int upper_bound = GetUpperBound();
+
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      CreatePredicate(lower_bound, upper_bound));
+
+  auto tile_group_count = sdbench_table->GetTileGroupCount();
+  auto txn_count = state.transactions;
+  size_t scalar_tuple_count = 0;
+  size_t batch_tuple_count = 0;
+
+  Timer<> scalar_timer;
+  Timer<> batch_timer;
+
+  for (oid_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    // Increment query counter
+    query_itr++;
+
+    scalar_timer.Start();
+    for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+         tile_group_itr++) {
+      auto tile_group = sdbench_table->GetTileGroup(tile_group_itr);
+      oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+      for (oid_t tuple_id = 0; tuple_id < active_tuple_count; tuple_id++) {
+        expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                             tuple_id);
+        if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+          scalar_tuple_count++;
+        }
+      }
+    }
+    scalar_timer.Stop();
+
+    batch_timer.Start();
+    for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+         tile_group_itr++) {
+      auto tile_group = sdbench_table->GetTileGroup(tile_group_itr);
+      oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+      expression::SelectionVector selection(active_tuple_count);
+      std::iota(selection.begin(), selection.end(), 0);
+
+      expression::BatchSource source(tile_group.get());
+      predicate->EvaluateBatch(source, selection, nullptr);
+      batch_tuple_count += selection.size();
+    }
+    batch_timer.Stop();
+  }
+
+  if (scalar_tuple_count != batch_tuple_count) {
+    LOG_ERROR("Predicate mismatch :: scalar %lu batch %lu", scalar_tuple_count,
+              batch_tuple_count);
+  }
+
+  WritePredicateOutput(scalar_timer.GetDuration() / txn_count,
+                       batch_timer.GetDuration() / txn_count);
+}
+
+/*
+ * Check the visibility of every tuple in the table, which only reads the
+ * tuple headers, to compare the header layouts.
+ */
+void RunVisibilityTest() {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto tile_group_count = sdbench_table->GetTileGroupCount();
+  auto txn_count = state.transactions;
+  size_t tuple_count = 0;
+  size_t visible_tuple_count = 0;
+
+  Timer<> timer;
+  concurrency::VisibilityBitmap visibility;
+
+  for (oid_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    // Increment query counter
+    query_itr++;
+
+    auto txn = txn_manager.BeginTransaction();
+
+    // Same visibility check as the scans, a tile group at a time
+    timer.Start();
+    for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+         tile_group_itr++) {
+      auto tile_group = sdbench_table->GetTileGroup(tile_group_itr);
+      tuple_count += txn_manager.ComputeVisibility(
+          tile_group->GetHeader(), txn->GetBeginCommitId(),
+          txn->GetTransactionId(), visibility);
+
+      for (auto word : visibility) {
+        visible_tuple_count += __builtin_popcountll(word);
+      }
+    }
+    timer.Stop();
+
+    txn_manager.CommitTransaction();
+  }
+
+  LOG_TRACE("Visible tuples : %lu", visible_tuple_count);
+
+  WriteVisibilityOutput(timer.GetDuration() / txn_count,
+                        tuple_count / txn_count);
+}
+
+// Bytes taken by the tiles of the table
+static size_t GetTableTileSize() {
+  size_t table_tile_size = 0;
+
+  auto tile_group_count = sdbench_table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = sdbench_table->GetTileGroup(tile_group_itr);
+    for (oid_t tile_itr = 0; tile_itr < tile_group->GetTileCount();
+         tile_itr++) {
+      table_tile_size += tile_group->GetTileReference(tile_itr)->GetSize();
+    }
+  }
+
+  return table_tile_size;
+}
+
+// Evaluate the predicate over the whole table with batch evaluation
+static size_t ScanTable(const expression::AbstractExpression *predicate) {
+  size_t tuple_count = 0;
+
+  auto tile_group_count = sdbench_table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = sdbench_table->GetTileGroup(tile_group_itr);
+    oid_t active_tuple_count = tile_group->GetNextTupleSlot();
+
+    expression::SelectionVector selection(active_tuple_count);
+    std::iota(selection.begin(), selection.end(), 0);
+
+    expression::BatchSource source(tile_group.get());
+    predicate->EvaluateBatch(source, selection, nullptr);
+    tuple_count += selection.size();
+  }
+
+  return tuple_count;
+}
+
+/*
+ * Compress the cold tile groups of the table, and compare the memory taken
+ * by its tiles and the predicate scan over it before and after.
+ */
+void RunCompressionTest() {
+  const int lower_bound = GetLowerBound();
+  const int upper_bound = GetUpperBound();
+
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      CreatePredicate(lower_bound, upper_bound));
+
+  auto txn_count = state.transactions;
+  size_t plain_tuple_count = 0;
+  size_t compressed_tuple_count = 0;
+
+  Timer<> plain_timer;
+  Timer<> compressed_timer;
+
+  size_t plain_size = GetTableTileSize();
+
+  for (oid_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    query_itr++;
+
+    plain_timer.Start();
+    plain_tuple_count += ScanTable(predicate.get());
+    plain_timer.Stop();
+  }
+
+  // The loaded tuples turn cold once the epoch manager has seen the txns
+  // that inserted them exit
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(4 * EPOCH_LENGTH));
+
+  auto &compressor = storage::TileGroupCompressor::GetInstance();
+  auto compressed_count = compressor.CompressTable(sdbench_table.get());
+  LOG_INFO("Compressed %lu of %lu tile groups", compressed_count,
+           sdbench_table->GetTileGroupCount());
+
+  size_t compressed_size = GetTableTileSize();
+
+  for (oid_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    query_itr++;
+
+    compressed_timer.Start();
+    compressed_tuple_count += ScanTable(predicate.get());
+    compressed_timer.Stop();
+  }
+
+  if (plain_tuple_count != compressed_tuple_count) {
+    LOG_ERROR("Predicate mismatch :: plain %lu compressed %lu",
+              plain_tuple_count, compressed_tuple_count);
+  }
+
+  WriteCompressionOutput(plain_size, compressed_size,
+                         plain_timer.GetDuration() / txn_count,
+                         compressed_timer.GetDuration() / txn_count);
+}
+
 void RunInsertTest() {
   auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
 
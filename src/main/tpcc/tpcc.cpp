@@ -21,6 +21,8 @@
 
 #include "common/logger.h"
 
+extern int peloton_active_tile_group_count;
+
 namespace peloton {
 namespace benchmark {
 namespace tpcc {
@@ -31,17 +33,31 @@ std::ofstream out("outputfile.summary");
 
 static void WriteOutput(double stat) {
   LOG_INFO("----------------------------------------------------------");
-  LOG_INFO("%d %d :: %lf", state.scale_factor, state.backend_count, stat);
+  LOG_INFO("%d %d %d %d :: %lf", state.scale_factor, state.backend_count,
+           state.per_thread_inserts, state.checkpoint_interval, stat);
+  if (state.checkpoint_interval > 0) {
+    LOG_INFO("checkpoints :: %d, average duration :: %lf ms",
+             state.checkpoint_count, state.checkpoint_latency);
+  }
 
   out << state.scale_factor << " ";
   out << state.backend_count << " ";
-  out << stat << "\n";
+  out << state.per_thread_inserts << " ";
+  out << state.checkpoint_interval << " ";
+  out << stat << " ";
+  out << state.checkpoint_count << " ";
+  out << state.checkpoint_latency << "\n";
   out.flush();
   out.close();
 }
 
 // Main Entry Point
 void RunBenchmark() {
+  // Every backend inserts through its own tile group
+  if (state.per_thread_inserts) {
+    peloton_active_tile_group_count = state.backend_count;
+  }
+
   // Create the database
   CreateTPCCDatabase();
 
@@ -27,12 +27,21 @@ void Usage(FILE *out) {
           "   -h --help              :  Print help message \n"
           "   -b --backend_count     :  # of backends \n"
           "   -d --duration          :  execution duration \n"
-          "   -k --scale_factor      :  scale factor \n");
+          "   -k --scale_factor      :  scale factor \n"
+          "   -p --per_thread_inserts:  One insert tile group per backend \n"
+          "   -c --checkpoint_interval: Fuzzy checkpoint interval (ms) \n"
+          "   -t --checkpoint_threads:  # of fuzzy checkpoint threads \n");
 }
 
 static struct option opts[] = {{"backend_count", optional_argument, NULL, 'b'},
                                {"duration", optional_argument, NULL, 'd'},
                                {"scale_factor", optional_argument, NULL, 'k'},
+                               {"per_thread_inserts", optional_argument, NULL,
+                                'p'},
+                               {"checkpoint_interval", optional_argument, NULL,
+                                'c'},
+                               {"checkpoint_threads", optional_argument, NULL,
+                                't'},
                                {NULL, 0, NULL, 0}};
 
 void ValidateScaleFactor(const configuration &state) {
@@ -62,16 +71,37 @@ void ValidateBackendCount(const configuration &state) {
   LOG_INFO("%s : %d", "backend_count", state.backend_count);
 }
 
+void ValidateCheckpointInterval(const configuration &state) {
+  if (state.checkpoint_interval < 0) {
+    LOG_ERROR("Invalid checkpoint_interval :: %d", state.checkpoint_interval);
+    exit(EXIT_FAILURE);
+  }
+
+  if (state.checkpoint_thread_count <= 0) {
+    LOG_ERROR("Invalid checkpoint_threads :: %d",
+              state.checkpoint_thread_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", "checkpoint_interval", state.checkpoint_interval);
+  LOG_INFO("%s : %d", "checkpoint_threads", state.checkpoint_thread_count);
+}
+
 void ParseArguments(int argc, char *argv[], configuration &state) {
   // Default Values
   state.scale_factor = 1;
   state.duration = 1000;
   state.backend_count = 2;
+  state.per_thread_inserts = false;
+  state.checkpoint_interval = 0;
+  state.checkpoint_thread_count = 1;
+  state.checkpoint_count = 0;
+  state.checkpoint_latency = 0;
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "ah:b:d:k:", opts, &idx);
+    int c = getopt_long(argc, argv, "ah:b:d:k:p:c:t:", opts, &idx);
 
     if (c == -1) break;
 
@@ -85,6 +115,15 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'k':
         state.scale_factor = atoi(optarg);
         break;
+      case 'p':
+        state.per_thread_inserts = atoi(optarg);
+        break;
+      case 'c':
+        state.checkpoint_interval = atoi(optarg);
+        break;
+      case 't':
+        state.checkpoint_thread_count = atoi(optarg);
+        break;
 
       case 'h':
         Usage(stderr);
@@ -109,6 +148,9 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateBackendCount(state);
   ValidateScaleFactor(state);
   ValidateDuration(state);
+  ValidateCheckpointInterval(state);
+
+  LOG_INFO("%s : %d", "per_thread_inserts", state.per_thread_inserts);
 }
 
 }  // namespace tpcc
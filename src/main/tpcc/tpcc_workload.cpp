@@ -59,6 +59,7 @@
 #include "index/index_factory.h"
 
 #include "logging/log_manager.h"
+#include "logging/checkpoint/fuzzy_checkpoint.h"
 
 #include "planner/abstract_plan.h"
 #include "planner/materialization_plan.h"
@@ -120,6 +121,35 @@ void RunBackend(oid_t thread_id) {
   transaction_counts[thread_id] = committed_transaction_count;
 }
 
+// Takes fuzzy checkpoints while the backends run
+void RunCheckpointer() {
+  logging::FuzzyCheckpoint checkpoint(false);
+  Timer<std::milli> timer;
+
+  auto interval = std::chrono::milliseconds(state.checkpoint_interval);
+  auto next_checkpoint = std::chrono::steady_clock::now() + interval;
+  while (run_backends == true) {
+    if (std::chrono::steady_clock::now() < next_checkpoint) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      continue;
+    }
+
+    timer.Start();
+    checkpoint.DoCheckpoint();
+    timer.Stop();
+    state.checkpoint_count++;
+
+    LOG_INFO("Checkpoint at cid %lu :: %lu tuples",
+             checkpoint.GetMostRecentCheckpointCid(),
+             checkpoint.GetCheckpointTupleCount());
+    next_checkpoint = std::chrono::steady_clock::now() + interval;
+  }
+
+  if (state.checkpoint_count > 0) {
+    state.checkpoint_latency = timer.GetDuration() / state.checkpoint_count;
+  }
+}
+
 void RunWorkload() {
   // Execute the workload to build the log
   std::vector<std::thread> thread_group;
@@ -131,6 +161,13 @@ void RunWorkload() {
     thread_group.push_back(std::move(std::thread(RunBackend, thread_itr)));
   }
 
+  // Checkpoint alongside the backends, so the throughput includes its cost
+  std::thread checkpoint_thread;
+  if (state.checkpoint_interval > 0) {
+    peloton_checkpoint_thread_count = state.checkpoint_thread_count;
+    checkpoint_thread = std::thread(RunCheckpointer);
+  }
+
   // Sleep for duration specified by user and then stop the backends
   auto sleep_period = std::chrono::milliseconds(state.duration);
   std::this_thread::sleep_for(sleep_period);
@@ -141,6 +178,10 @@ void RunWorkload() {
     thread_group[thread_itr].join();
   }
 
+  if (checkpoint_thread.joinable()) {
+    checkpoint_thread.join();
+  }
+
   // Compute total committed transactions
   auto sum_transaction_count = 0;
   for (auto transaction_count : transaction_counts) {
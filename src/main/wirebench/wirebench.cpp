@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench.cpp
+//
+// Identification: src/main/wirebench/wirebench.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#undef NDEBUG
+
+#include <iostream>
+#include <fstream>
+
+#include "common/logger.h"
+#include "benchmark/wirebench/wirebench_configuration.h"
+#include "benchmark/wirebench/wirebench_workload.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+configuration state;
+
+std::ofstream out("outputfile.summary");
+
+static void WriteOutput() {
+  LOG_INFO("----------------------------------------------------------");
+  LOG_INFO("%d %d %d :: %lf %lf %lf", state.connection_model,
+           state.connection_count, state.client_count, state.throughput,
+           state.latency_p50, state.latency_p99);
+
+  out << state.connection_model << " ";
+  out << state.connection_count << " ";
+  out << state.client_count << " ";
+  out << state.throughput << " ";
+  out << state.latency_p50 << " ";
+  out << state.latency_p99 << "\n";
+  out.flush();
+}
+
+// Main Entry Point
+void RunBenchmark() {
+  StartServer();
+
+  // Run the workload
+  RunWorkload();
+
+  StopServer();
+
+  // Emit throughput and latency
+  WriteOutput();
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
+
+int main(int argc, char **argv) {
+  peloton::benchmark::wirebench::ParseArguments(
+      argc, argv, peloton::benchmark::wirebench::state);
+
+  peloton::benchmark::wirebench::RunBenchmark();
+
+  return 0;
+}
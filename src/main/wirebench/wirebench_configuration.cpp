@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_configuration.cpp
+//
+// Identification: src/main/wirebench/wirebench_configuration.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <iomanip>
+#include <algorithm>
+
+#include "benchmark/wirebench/wirebench_configuration.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+void Usage(FILE *out) {
+  fprintf(out,
+          "Command line options : wirebench <options> \n"
+          "   -h --help              :  Print help message \n"
+          "   -m --model             :  Connection model (1: thread, 2: event) \n"
+          "   -c --connection-count  :  # of client connections \n"
+          "   -b --client-count      :  # of client threads \n"
+          "   -p --port              :  Server port \n"
+          "   -d --duration          :  execution duration \n"
+          "   -i --io-threads        :  # of event server I/O threads \n"
+          "   -w --worker-count      :  # of event server workers \n"
+          "   -f --max-in-flight     :  event server admission limit \n");
+}
+
+static struct option opts[] = {
+    {"model", optional_argument, NULL, 'm'},
+    {"connection-count", optional_argument, NULL, 'c'},
+    {"client-count", optional_argument, NULL, 'b'},
+    {"port", optional_argument, NULL, 'p'},
+    {"duration", optional_argument, NULL, 'd'},
+    {"io-threads", optional_argument, NULL, 'i'},
+    {"worker-count", optional_argument, NULL, 'w'},
+    {"max-in-flight", optional_argument, NULL, 'f'},
+    {NULL, 0, NULL, 0}};
+
+static void ValidateConnectionModel(const configuration &state) {
+  if (state.connection_model != CONNECTION_MODEL_THREAD &&
+      state.connection_model != CONNECTION_MODEL_EVENT) {
+    LOG_ERROR("Invalid connection_model :: %d", state.connection_model);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %s", "connection_model",
+           state.connection_model == CONNECTION_MODEL_THREAD ? "thread"
+                                                              : "event");
+}
+
+static void ValidatePositive(const char *name, int value) {
+  if (value <= 0) {
+    LOG_ERROR("Invalid %s :: %d", name, value);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", name, value);
+}
+
+void ParseArguments(int argc, char *argv[], configuration &state) {
+  // Default Values
+  state.connection_model = CONNECTION_MODEL_EVENT;
+  state.connection_count = 100;
+  state.client_count = 4;
+  state.port = 15721;
+  state.duration = 10000;
+  state.io_thread_count = 2;
+  state.worker_count = 16;
+  state.max_in_flight = 256;
+
+  // Parse args
+  while (1) {
+    int idx = 0;
+    int c = getopt_long(argc, argv, "hm:c:b:p:d:i:w:f:", opts, &idx);
+
+    if (c == -1) break;
+
+    switch (c) {
+      case 'm':
+        state.connection_model = (ConnectionModel)atoi(optarg);
+        break;
+      case 'c':
+        state.connection_count = atoi(optarg);
+        break;
+      case 'b':
+        state.client_count = atoi(optarg);
+        break;
+      case 'p':
+        state.port = atoi(optarg);
+        break;
+      case 'd':
+        state.duration = atoi(optarg);
+        break;
+      case 'i':
+        state.io_thread_count = atoi(optarg);
+        break;
+      case 'w':
+        state.worker_count = atoi(optarg);
+        break;
+      case 'f':
+        state.max_in_flight = atoi(optarg);
+        break;
+
+      case 'h':
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+
+      default:
+        fprintf(stderr, "\nUnknown option: -%c-\n", c);
+        Usage(stderr);
+        exit(EXIT_FAILURE);
+        break;
+    }
+  }
+
+  // Print configuration
+  ValidateConnectionModel(state);
+  ValidatePositive("connection_count", state.connection_count);
+  ValidatePositive("client_count", state.client_count);
+  ValidatePositive("port", state.port);
+  ValidatePositive("duration", state.duration);
+  ValidatePositive("io_thread_count", state.io_thread_count);
+  ValidatePositive("worker_count", state.worker_count);
+  ValidatePositive("max_in_flight", state.max_in_flight);
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -0,0 +1,292 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// wirebench_workload.cpp
+//
+// Identification: src/main/wirebench/wirebench_workload.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "benchmark/wirebench/wirebench_workload.h"
+#include "benchmark/wirebench/wirebench_configuration.h"
+
+#include "common/logger.h"
+#include "common/macros.h"
+
+#include "wire/event_server.h"
+#include "wire/socket_base.h"
+#include "wire/wire.h"
+
+namespace peloton {
+namespace benchmark {
+namespace wirebench {
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static wire::Server *server = nullptr;
+
+static wire::EventServer *event_server = nullptr;
+
+static std::thread server_thread;
+
+/*
+ * Client side of one connection. The query sent is the empty statement ";",
+ * which the server answers with EmptyQueryResponse + ReadyForQuery without
+ * touching the engine, so we measure the front end alone.
+ */
+struct ClientConnection {
+  int sock_fd;
+  std::vector<unsigned char> rbuf;
+  Clock::time_point send_time;
+};
+
+static void RaiseFileLimit() {
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+void StartServer() {
+  RaiseFileLimit();
+
+  FLAGS_port = state.port;
+  FLAGS_max_connections = state.connection_count;
+
+  server = new wire::Server();
+  wire::StartServer(server);
+
+  if (state.connection_model == CONNECTION_MODEL_THREAD) {
+    // the accept loop never returns, it dies with the process
+    server_thread = std::thread(
+        wire::HandleConnections<wire::PacketManager, wire::PktBuf>, server);
+    server_thread.detach();
+  } else {
+    event_server =
+        new wire::EventServer(server, state.io_thread_count,
+                              state.worker_count, state.max_in_flight);
+    server_thread = std::thread(&wire::EventServer::Run, event_server);
+  }
+}
+
+void StopServer() {
+  if (event_server != nullptr) {
+    event_server->Stop();
+    server_thread.join();
+    delete event_server;
+    event_server = nullptr;
+  }
+}
+
+static bool SendAll(int sock_fd, const std::vector<unsigned char> &buf) {
+  size_t sent = 0;
+  while (sent < buf.size()) {
+    ssize_t ret = write(sock_fd, buf.data() + sent, buf.size() - sent);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    sent += ret;
+  }
+  return true;
+}
+
+static void PutInt(std::vector<unsigned char> &buf, uint32_t n) {
+  n = htonl(n);
+  auto bytes = reinterpret_cast<unsigned char *>(&n);
+  buf.insert(buf.end(), bytes, bytes + sizeof(n));
+}
+
+static std::vector<unsigned char> MakeStartupPacket() {
+  std::vector<unsigned char> body;
+  PutInt(body, 3 << 16);
+  const char options[] = "user\0postgres\0database\0postgres\0";
+  body.insert(body.end(), options, options + sizeof(options));
+
+  std::vector<unsigned char> pkt;
+  PutInt(pkt, body.size() + sizeof(uint32_t));
+  pkt.insert(pkt.end(), body.begin(), body.end());
+  return pkt;
+}
+
+static std::vector<unsigned char> MakeQueryPacket() {
+  std::string query(";\0", 2);
+  std::vector<unsigned char> pkt;
+  pkt.push_back('Q');
+  PutInt(pkt, query.size() + sizeof(uint32_t));
+  pkt.insert(pkt.end(), query.begin(), query.end());
+  return pkt;
+}
+
+/*
+ * Consume all complete messages in the connection's buffer, returns true if
+ * a ReadyForQuery was among them.
+ */
+static bool ConsumeResponses(ClientConnection &conn) {
+  bool ready = false;
+  size_t ptr = 0;
+
+  while (conn.rbuf.size() - ptr >= 1 + sizeof(uint32_t)) {
+    uint32_t len;
+    memcpy(&len, conn.rbuf.data() + ptr + 1, sizeof(len));
+    len = ntohl(len);
+    if (conn.rbuf.size() - ptr < 1 + len) break;
+
+    if (conn.rbuf[ptr] == 'Z') ready = true;
+    ptr += 1 + len;
+  }
+
+  conn.rbuf.erase(conn.rbuf.begin(), conn.rbuf.begin() + ptr);
+  return ready;
+}
+
+static bool ReadResponses(ClientConnection &conn) {
+  unsigned char chunk[SOCKET_BUFFER_SIZE];
+  ssize_t ret = read(conn.sock_fd, chunk, sizeof(chunk));
+  if (ret <= 0) return false;
+  conn.rbuf.insert(conn.rbuf.end(), chunk, chunk + ret);
+  return true;
+}
+
+static int Connect() {
+  int sock_fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (sock_fd < 0) return -1;
+
+  struct sockaddr_in serv_addr;
+  memset(&serv_addr, 0, sizeof(serv_addr));
+  serv_addr.sin_family = AF_INET;
+  serv_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  serv_addr.sin_port = htons(state.port);
+
+  if (connect(sock_fd, (struct sockaddr *)&serv_addr, sizeof(serv_addr)) < 0) {
+    close(sock_fd);
+    return -1;
+  }
+
+  int yes = 1;
+  setsockopt(sock_fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+  return sock_fd;
+}
+
+/*
+ * Each client thread drives its share of the connections in a closed loop:
+ * one outstanding query per connection, re-issued as soon as it completes.
+ */
+static void RunClient(int connection_count, std::vector<double> &latencies,
+                      std::atomic<bool> &is_running) {
+  std::vector<ClientConnection> conns(connection_count);
+  auto startup_pkt = MakeStartupPacket();
+  auto query_pkt = MakeQueryPacket();
+
+  for (auto &conn : conns) {
+    conn.sock_fd = Connect();
+    if (conn.sock_fd < 0 || !SendAll(conn.sock_fd, startup_pkt)) {
+      LOG_ERROR("Client error: could not connect to server");
+      exit(EXIT_FAILURE);
+    }
+    do {
+      if (!ReadResponses(conn)) {
+        LOG_ERROR("Client error: startup failed");
+        exit(EXIT_FAILURE);
+      }
+    } while (!ConsumeResponses(conn));
+  }
+
+  std::vector<struct pollfd> pfds(connection_count);
+  for (int conn_itr = 0; conn_itr < connection_count; conn_itr++) {
+    pfds[conn_itr].fd = conns[conn_itr].sock_fd;
+    pfds[conn_itr].events = POLLIN;
+    conns[conn_itr].send_time = Clock::now();
+    SendAll(conns[conn_itr].sock_fd, query_pkt);
+  }
+
+  while (is_running) {
+    if (poll(pfds.data(), pfds.size(), 100) <= 0) continue;
+
+    for (int conn_itr = 0; conn_itr < connection_count; conn_itr++) {
+      if (!(pfds[conn_itr].revents & POLLIN)) continue;
+
+      auto &conn = conns[conn_itr];
+      if (!ReadResponses(conn)) {
+        LOG_ERROR("Client error: connection closed by server");
+        exit(EXIT_FAILURE);
+      }
+      if (!ConsumeResponses(conn)) continue;
+
+      auto now = Clock::now();
+      latencies.push_back(
+          std::chrono::duration<double, std::micro>(now - conn.send_time)
+              .count());
+
+      conn.send_time = now;
+      SendAll(conn.sock_fd, query_pkt);
+    }
+  }
+
+  for (auto &conn : conns) {
+    close(conn.sock_fd);
+  }
+}
+
+void RunWorkload() {
+  std::atomic<bool> is_running(true);
+  std::vector<std::vector<double>> latencies(state.client_count);
+  std::vector<std::thread> client_threads;
+
+  int client_count = std::min(state.client_count, state.connection_count);
+  for (int client_itr = 0; client_itr < client_count; client_itr++) {
+    // spread the connections evenly over the client threads
+    int connection_count = state.connection_count / client_count +
+                           (client_itr < state.connection_count % client_count);
+    client_threads.push_back(std::thread(RunClient, connection_count,
+                                         std::ref(latencies[client_itr]),
+                                         std::ref(is_running)));
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(state.duration));
+  is_running = false;
+
+  for (auto &client_thread : client_threads) {
+    client_thread.join();
+  }
+
+  std::vector<double> all_latencies;
+  for (auto &client_latencies : latencies) {
+    all_latencies.insert(all_latencies.end(), client_latencies.begin(),
+                         client_latencies.end());
+  }
+
+  state.throughput = all_latencies.size() * 1000.0 / state.duration;
+  state.latency_p50 = 0;
+  state.latency_p99 = 0;
+
+  if (!all_latencies.empty()) {
+    std::sort(all_latencies.begin(), all_latencies.end());
+    state.latency_p50 = all_latencies[all_latencies.size() * 50 / 100];
+    state.latency_p99 = all_latencies[all_latencies.size() * 99 / 100];
+  }
+}
+
+}  // namespace wirebench
+}  // namespace benchmark
+}  // namespace peloton
@@ -20,6 +20,12 @@
 #include "benchmark/ycsb/ycsb_configuration.h"
 #include "benchmark/ycsb/ycsb_loader.h"
 #include "benchmark/ycsb/ycsb_workload.h"
+#include "concurrency/epoch_manager.h"
+#include "gc/gc_manager_factory.h"
+
+extern int peloton_active_tile_group_count;
+
+extern bool peloton_write_stats;
 
 namespace peloton {
 namespace benchmark {
@@ -31,20 +37,61 @@ std::ofstream out("outputfile.summary");
 
 static void WriteOutput(double stat) {
   LOG_INFO("----------------------------------------------------------");
-  LOG_INFO("%lf %d %d %d %d :: %lf", state.update_ratio, state.scale_factor,
-           state.backend_count, state.skew_factor, state.column_count, stat);
+  LOG_INFO("%lf %d %d %d %d %d %d %d %d %d :: %lf %lu %lf",
+           state.update_ratio, state.scale_factor, state.backend_count,
+           state.skew_factor, state.column_count, state.per_thread_inserts,
+           state.update_existing, state.gc_mode, state.epoch_length,
+           state.write_stats, stat, state.tile_group_count, state.memory);
 
   out << state.update_ratio << " ";
   out << state.scale_factor << " ";
   out << state.backend_count << " ";
   out << state.skew_factor << " ";
   out << state.column_count << " ";
-  out << stat << "\n";
+  out << state.per_thread_inserts << " ";
+  out << state.update_existing << " ";
+  out << state.gc_mode << " ";
+  out << state.epoch_length << " ";
+  out << state.write_stats << " ";
+  out << stat << " ";
+  out << state.tile_group_count << " ";
+  out << state.memory << "\n";
   out.flush();
 }
 
+static void WriteSnapshots() {
+  if (state.snapshot_throughputs.empty()) return;
+
+  std::ofstream snapshot_out("outputfile.snapshots");
+  for (size_t snapshot_itr = 0; snapshot_itr < state.snapshot_throughputs.size();
+       snapshot_itr++) {
+    snapshot_out << (snapshot_itr + 1) * state.snapshot_duration << " ";
+    snapshot_out << state.snapshot_throughputs[snapshot_itr] << " ";
+    snapshot_out << state.snapshot_memory[snapshot_itr] << " ";
+    snapshot_out << state.snapshot_gc_queue_depths[snapshot_itr] << "\n";
+  }
+}
+
 // Main Entry Point
 void RunBenchmark() {
+  // Every backend inserts through its own tile group
+  if (state.per_thread_inserts) {
+    peloton_active_tile_group_count = state.backend_count;
+  }
+
+  // Compare the insert throughput with and without to measure what keeping
+  // the stats costs
+  peloton_write_stats = state.write_stats;
+
+  concurrency::EpochManagerFactory::GetInstance().SetEpochLength(
+      state.epoch_length);
+
+  // Recycle the slots of garbage versions
+  if (state.gc_mode) {
+    gc::GCManagerFactory::Configure(GC_TYPE_COOPERATIVE,
+                                    state.gc_thread_count);
+  }
+
   // Create and load the user table
   CreateYCSBDatabase();
 
@@ -55,6 +102,8 @@ void RunBenchmark() {
 
   // Emit throughput
   WriteOutput(state.throughput);
+
+  WriteSnapshots();
 }
 
 }  // namespace ycsb
@@ -16,6 +16,7 @@
 
 #include "benchmark/ycsb/ycsb_configuration.h"
 #include "common/logger.h"
+#include "concurrency/epoch_manager.h"
 
 namespace peloton {
 namespace benchmark {
@@ -25,19 +26,41 @@ void Usage(FILE *out) {
   fprintf(out,
           "Command line options : ycsb <options> \n"
           "   -h --help              :  Print help message \n"
+          "   -a --write-stats       :  Maintain stats on the write path \n"
           "   -b --backend-count     :  # of backends \n"
           "   -c --column-count      :  # of columns \n"
           "   -d --duration          :  execution duration \n"
+          "   -e --update-existing   :  Updates modify existing tuples \n"
+          "   -g --gc-mode           :  Recycle garbage tuple slots \n"
+          "   -i --index             :  index type (1 = btree, 2 = bwtree, "
+          "4 = hash) \n"
           "   -k --scale-factor      :  # of tuples \n"
+          "   -l --epoch-length      :  Epoch length (ms) \n"
+          "   -n --snapshot-duration :  Throughput and memory snapshot "
+          "interval (ms) \n"
+          "   -p --per-thread-inserts:  One insert tile group per backend \n"
           "   -s --skew              :  Skew factor \n"
+          "   -t --gc-thread-count   :  # of GC threads \n"
           "   -u --update-ratio      :  Fraction of updates \n");
 }
 
-static struct option opts[] = {{"backend-count", optional_argument, NULL, 'b'},
+static struct option opts[] = {{"write-stats", optional_argument, NULL, 'a'},
+                               {"backend-count", optional_argument, NULL, 'b'},
                                {"column-count", optional_argument, NULL, 'c'},
                                {"duration", optional_argument, NULL, 'd'},
+                               {"update-existing", optional_argument, NULL,
+                                'e'},
+                               {"gc-mode", optional_argument, NULL, 'g'},
+                               {"index", optional_argument, NULL, 'i'},
                                {"scale-factor", optional_argument, NULL, 'k'},
+                               {"epoch-length", optional_argument, NULL, 'l'},
+                               {"snapshot-duration", optional_argument, NULL,
+                                'n'},
+                               {"per-thread-inserts", optional_argument, NULL,
+                                'p'},
                                {"skew", optional_argument, NULL, 's'},
+                               {"gc-thread-count", optional_argument, NULL,
+                                't'},
                                {"update-ratio", optional_argument, NULL, 'u'},
                                {NULL, 0, NULL, 0}};
 
@@ -95,6 +118,43 @@ void ValidateSkewFactor(const configuration &state) {
   LOG_INFO("%s : %d", "skew_factor", state.skew_factor);
 }
 
+void ValidateIndex(const configuration &state) {
+  if (state.index != INDEX_TYPE_BTREE && state.index != INDEX_TYPE_BWTREE &&
+      state.index != INDEX_TYPE_HASH) {
+    LOG_ERROR("Invalid index :: %d", state.index);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %s", "index", IndexTypeToString(state.index).c_str());
+}
+
+void ValidateSnapshotDuration(const configuration &state) {
+  if (state.snapshot_duration < 0) {
+    LOG_ERROR("Invalid snapshot_duration :: %d", state.snapshot_duration);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", "snapshot_duration", state.snapshot_duration);
+}
+
+void ValidateGCThreadCount(const configuration &state) {
+  if (state.gc_thread_count <= 0) {
+    LOG_ERROR("Invalid gc_thread_count :: %d", state.gc_thread_count);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", "gc_thread_count", state.gc_thread_count);
+}
+
+void ValidateEpochLength(const configuration &state) {
+  if (state.epoch_length <= 0) {
+    LOG_ERROR("Invalid epoch_length :: %d", state.epoch_length);
+    exit(EXIT_FAILURE);
+  }
+
+  LOG_INFO("%s : %d", "epoch_length", state.epoch_length);
+}
+
 void ParseArguments(int argc, char *argv[], configuration &state) {
   // Default Values
   state.scale_factor = 1;
@@ -103,15 +163,26 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   state.update_ratio = 1;
   state.backend_count = 2;
   state.skew_factor = SKEW_FACTOR_LOW;
+  state.index = INDEX_TYPE_BTREE;
+  state.per_thread_inserts = false;
+  state.update_existing = false;
+  state.gc_mode = false;
+  state.gc_thread_count = 1;
+  state.write_stats = true;
+  state.epoch_length = EPOCH_LENGTH;
+  state.snapshot_duration = 0;
 
   // Parse args
   while (1) {
     int idx = 0;
-    int c = getopt_long(argc, argv, "hb:c:d:k:s:u:", opts, &idx);
+    int c = getopt_long(argc, argv, "ha:b:c:d:e:g:i:k:l:n:p:s:t:u:", opts, &idx);
 
     if (c == -1) break;
 
     switch (c) {
+      case 'a':
+        state.write_stats = atoi(optarg);
+        break;
       case 'b':
         state.backend_count = atoi(optarg);
         break;
@@ -121,12 +192,33 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
       case 'd':
         state.duration = atoi(optarg);
         break;
+      case 'e':
+        state.update_existing = atoi(optarg);
+        break;
+      case 'g':
+        state.gc_mode = atoi(optarg);
+        break;
+      case 'i':
+        state.index = (IndexType)atoi(optarg);
+        break;
       case 'k':
         state.scale_factor = atoi(optarg);
         break;
+      case 'l':
+        state.epoch_length = atoi(optarg);
+        break;
+      case 'n':
+        state.snapshot_duration = atoi(optarg);
+        break;
+      case 'p':
+        state.per_thread_inserts = atoi(optarg);
+        break;
       case 's':
         state.skew_factor = (SkewFactor)atoi(optarg);
         break;
+      case 't':
+        state.gc_thread_count = atoi(optarg);
+        break;
       case 'u':
         state.update_ratio = atof(optarg);
         break;
@@ -151,6 +243,15 @@ void ParseArguments(int argc, char *argv[], configuration &state) {
   ValidateUpdateRatio(state);
   ValidateDuration(state);
   ValidateSkewFactor(state);
+  ValidateIndex(state);
+  ValidateSnapshotDuration(state);
+  ValidateGCThreadCount(state);
+  ValidateEpochLength(state);
+
+  LOG_INFO("%s : %d", "per_thread_inserts", state.per_thread_inserts);
+  LOG_INFO("%s : %d", "update_existing", state.update_existing);
+  LOG_INFO("%s : %d", "gc_mode", state.gc_mode);
+  LOG_INFO("%s : %d", "write_stats", state.write_stats);
 }
 
 }  // namespace ycsb
@@ -104,7 +104,7 @@ void CreateYCSBDatabase() {
   unique = true;
 
   index_metadata = new index::IndexMetadata(
-      "primary_index", user_table_pkey_index_oid, INDEX_TYPE_BTREE,
+      "primary_index", user_table_pkey_index_oid, state.index,
       INDEX_CONSTRAINT_TYPE_PRIMARY_KEY, tuple_schema, key_schema, unique);
 
   index::Index *pkey_index = index::IndexFactory::GetInstance(index_metadata);
@@ -23,6 +23,9 @@
 #include <random>
 #include <cstddef>
 #include <limits>
+#include <atomic>
+#include <fstream>
+#include <unistd.h>
 
 #include "benchmark/ycsb/ycsb_workload.h"
 #include "benchmark/ycsb/ycsb_configuration.h"
@@ -49,6 +52,7 @@
 #include "executor/materialization_executor.h"
 #include "executor/update_executor.h"
 #include "executor/index_scan_executor.h"
+#include "executor/insert_executor.h"
 
 #include "expression/abstract_expression.h"
 #include "expression/constant_value_expression.h"
@@ -58,6 +62,8 @@
 
 #include "index/index_factory.h"
 
+#include "gc/gc_manager_factory.h"
+
 #include "logging/log_manager.h"
 
 #include "planner/abstract_plan.h"
@@ -180,6 +186,8 @@ bool RunRead(ZipfDistribution &zipf);
 
 bool RunInsert(ZipfDistribution &zipf, oid_t next_insert_key);
 
+bool RunUpdate(ZipfDistribution &zipf);
+
 /////////////////////////////////////////////////////////
 // WORKLOAD
 /////////////////////////////////////////////////////////
@@ -190,6 +198,18 @@ volatile bool run_backends = true;
 // Committed transaction counts
 std::vector<double> transaction_counts;
 
+// Committed transaction counts so far, read by the snapshots
+std::unique_ptr<std::atomic<size_t>[]> running_transaction_counts;
+
+// Resident memory of the process (in MB)
+static double GetResidentMemory() {
+  std::ifstream statm("/proc/self/statm");
+  size_t total_pages = 0, resident_pages = 0;
+  statm >> total_pages >> resident_pages;
+
+  return (double)resident_pages * sysconf(_SC_PAGESIZE) / (1024 * 1024);
+}
+
 void RunBackend(oid_t thread_id) {
   auto update_ratio = state.update_ratio;
 
@@ -220,8 +240,12 @@ void RunBackend(oid_t thread_id) {
 
     // Run transaction
     if (rng_val < update_ratio) {
-      next_insert_key += state.backend_count;
-      transaction_status = RunInsert(zipf, next_insert_key);
+      if (state.update_existing) {
+        transaction_status = RunUpdate(zipf);
+      } else {
+        next_insert_key += state.backend_count;
+        transaction_status = RunInsert(zipf, next_insert_key);
+      }
     } else {
       transaction_status = RunRead(zipf);
     }
@@ -229,6 +253,8 @@ void RunBackend(oid_t thread_id) {
     // Update transaction count if it committed
     if (transaction_status == true) {
       committed_transaction_count++;
+      running_transaction_counts[thread_id].store(committed_transaction_count,
+                                                  std::memory_order_relaxed);
     }
   }
 
@@ -241,15 +267,60 @@ void RunWorkload() {
   std::vector<std::thread> thread_group;
   oid_t num_threads = state.backend_count;
   transaction_counts.resize(num_threads);
+  running_transaction_counts.reset(new std::atomic<size_t>[num_threads]);
+  for (oid_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
+    running_transaction_counts[thread_itr] = 0;
+  }
 
   // Launch a group of threads
   for (oid_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
     thread_group.push_back(std::move(std::thread(RunBackend, thread_itr)));
   }
 
-  // Sleep for duration specified by user and then stop the backends
-  auto sleep_period = std::chrono::milliseconds(state.duration);
-  std::this_thread::sleep_for(sleep_period);
+  // Sleep for duration specified by user and then stop the backends.
+  // Long runs take a snapshot of the throughput and memory every interval.
+  int elapsed_duration = 0;
+  size_t last_transaction_count = 0;
+  while (elapsed_duration < state.duration) {
+    int sleep_duration = state.duration - elapsed_duration;
+    if (state.snapshot_duration != 0) {
+      sleep_duration = std::min(sleep_duration, state.snapshot_duration);
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleep_duration));
+    elapsed_duration += sleep_duration;
+
+    if (state.snapshot_duration == 0) continue;
+
+    size_t transaction_count = 0;
+    for (oid_t thread_itr = 0; thread_itr < num_threads; ++thread_itr) {
+      transaction_count +=
+          running_transaction_counts[thread_itr].load(std::memory_order_relaxed);
+    }
+
+    double throughput = (transaction_count - last_transaction_count) * 1000.0 /
+                        sleep_duration;
+    double memory = GetResidentMemory();
+    last_transaction_count = transaction_count;
+
+    // GC lag
+    size_t gc_queue_depth = 0;
+    cid_t oldest_unreclaimed_cid = MAX_CID;
+    if (state.gc_mode) {
+      auto &gc_manager = gc::GCManagerFactory::GetInstance();
+      gc_queue_depth = gc_manager.GetReclaimQueueDepth();
+      oldest_unreclaimed_cid = gc_manager.GetOldestUnreclaimedCid();
+    }
+
+    state.snapshot_throughputs.push_back(throughput);
+    state.snapshot_memory.push_back(memory);
+    state.snapshot_gc_queue_depths.push_back(gc_queue_depth);
+    LOG_INFO("snapshot %d ms :: throughput %lf memory %lf MB tile groups %lu",
+             elapsed_duration, throughput, memory,
+             user_table->GetTileGroupCount());
+    LOG_INFO("gc queue depth %lu oldest unreclaimed cid %lu", gc_queue_depth,
+             oldest_unreclaimed_cid);
+  }
   run_backends = false;
 
   // Join the threads with the main thread
@@ -266,6 +337,16 @@ void RunWorkload() {
   // Compute average throughput and latency
   state.throughput = (sum_transaction_count * 1000) / state.duration;
   state.latency = state.backend_count / state.throughput;
+
+  // Compute the memory footprint
+  state.tile_group_count = user_table->GetTileGroupCount();
+  state.memory = GetResidentMemory();
+
+  if (state.gc_mode) {
+    auto &gc_manager = gc::GCManagerFactory::GetInstance();
+    LOG_INFO("recycled slots :: %lu reused slots :: %lu",
+             gc_manager.GetRecycledCount(), gc_manager.GetReusedCount());
+  }
 }
 
 /////////////////////////////////////////////////////////
@@ -439,6 +520,92 @@ bool RunInsert(UNUSED_ATTRIBUTE ZipfDistribution &zipf, oid_t next_insert_key) {
   return txn_status;
 }
 
+bool RunUpdate(ZipfDistribution &zipf) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  /////////////////////////////////////////////////////////
+  // INDEX SCAN + PREDICATE
+  /////////////////////////////////////////////////////////
+
+  // Column ids to be added to logical tile after scan.
+  std::vector<oid_t> column_ids;
+  oid_t column_count = state.column_count + 1;
+
+  for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+    column_ids.push_back(col_itr);
+  }
+
+  std::vector<oid_t> key_column_ids;
+  std::vector<ExpressionType> expr_types;
+  std::vector<Value> values;
+  std::vector<expression::AbstractExpression *> runtime_keys;
+
+  auto lookup_key = zipf.GetNextNumber();
+
+  key_column_ids.push_back(0);
+  expr_types.push_back(ExpressionType::EXPRESSION_TYPE_COMPARE_EQUAL);
+  values.push_back(ValueFactory::GetIntegerValue(lookup_key));
+
+  auto ycsb_pkey_index = user_table->GetIndexWithOid(user_table_pkey_index_oid);
+
+  planner::IndexScanPlan::IndexScanDesc index_scan_desc(
+      ycsb_pkey_index, key_column_ids, expr_types, values, runtime_keys);
+
+  // Create plan node.
+  auto predicate = nullptr;
+
+  planner::IndexScanPlan index_scan_node(user_table, predicate, column_ids,
+                                         index_scan_desc);
+
+  // Run the executor
+  executor::IndexScanExecutor index_scan_executor(&index_scan_node,
+                                                  context.get());
+
+  /////////////////////////////////////////////////////////
+  // UPDATE
+  /////////////////////////////////////////////////////////
+
+  TargetList target_list;
+  DirectMapList direct_map_list;
+
+  // Update the first field, keep the key and the other fields
+  for (oid_t col_itr = 0; col_itr < column_count; col_itr++) {
+    if (col_itr != 1) {
+      direct_map_list.emplace_back(col_itr,
+                                   std::pair<oid_t, oid_t>(0, col_itr));
+    }
+  }
+
+  std::string update_raw_value(ycsb_field_length - 1, 'u');
+  Value update_val = ValueFactory::GetStringValue(update_raw_value);
+  target_list.emplace_back(
+      1, expression::ExpressionUtil::ConstantValueFactory(update_val));
+
+  std::unique_ptr<const planner::ProjectInfo> project_info(
+      new planner::ProjectInfo(std::move(target_list),
+                               std::move(direct_map_list)));
+  planner::UpdatePlan update_node(user_table, std::move(project_info));
+
+  executor::UpdateExecutor update_executor(&update_node, context.get());
+  update_executor.AddChild(&index_scan_executor);
+
+  /////////////////////////////////////////////////////////
+  // EXECUTE
+  /////////////////////////////////////////////////////////
+
+  std::vector<executor::AbstractExecutor *> executors;
+  executors.push_back(&update_executor);
+
+  ExecuteTest(executors);
+
+  auto txn_status = EndTransaction(txn);
+  return txn_status;
+}
+
 }  // namespace ycsb
 }  // namespace benchmark
 }  // namespace peloton
@@ -92,6 +92,7 @@ Connection* ConnectionManager::GetConn(NetworkAddress& addr) {
 
     if (base == NULL) {
       LOG_ERROR("No event base when creating a connection");
+      mutex_.UnLock();
       return NULL;
     }
 
@@ -111,6 +112,7 @@ Connection* ConnectionManager::GetConn(NetworkAddress& addr) {
     if (conn->Connect(addr) == false) {
       LOG_TRACE("Connect Error ---> ");
       delete conn;
+      mutex_.UnLock();
       return NULL;
     }
 
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// logging_service.cpp
+//
+// Identification: src/networking/logging_service.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "networking/logging_service.h"
+#include "logging/replication_manager.h"
+#include "common/logger.h"
+
+namespace peloton {
+namespace networking {
+
+void LoggingService::LogRecordReplay(
+    ::google::protobuf::RpcController* controller,
+    const LogRecordReplayRequest* request, LogRecordReplayResponse* response,
+    ::google::protobuf::Closure* done) {
+  if (controller->Failed()) {
+    std::string error = controller->ErrorText();
+    LOG_TRACE("LoggingService with controller failed:%s ", error.c_str());
+  }
+
+  auto& replication_manager = logging::ReplicationManager::GetInstance();
+
+  // If request is not null, this is a rpc call, the standby replays the log
+  if (request != NULL) {
+    LOG_TRACE("Received log buffer %ld of %lu bytes",
+              request->sequence_number(), request->log().size());
+
+    response->set_sequence_number(request->sequence_number());
+    response->set_replica_id(request->replica_id());
+    if (replication_manager.ReplayLogBuffer(request->log()) == true) {
+      response->set_status(REPLAY_COMPLETE);
+    } else {
+      // the primary stops shipping to this replica
+      controller->SetFailed("Could not replay the log buffer");
+      response->set_status(REPLAY_ERROR);
+    }
+
+    // if callback exist, run it
+    if (done) {
+      done->Run();
+    }
+  }
+  // Here is the primary getting the acknowledgement
+  else {
+    replication_manager.AcknowledgeLogBuffer(
+        response->replica_id(), response->sequence_number(),
+        response->status() == REPLAY_COMPLETE);
+  }
+}
+
+}  // namespace networking
+}  // namespace peloton
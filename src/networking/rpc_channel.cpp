@@ -24,6 +24,7 @@
 
 #include <iostream>
 #include <functional>
+#include <memory>
 #include "../include/common/thread_pool.h"
 
 namespace peloton {
@@ -73,9 +74,10 @@ void RpcChannel::CallMethod(
   uint32_t msg_len = request->ByteSize() + OPCODELEN + TYPELEN;
 
   /* total length of the message: header length (4bytes) + message length
-   * (8bytes + ...) */
+   * (8bytes + ...). On the heap, a shipped log buffer runs to megabytes */
   PL_ASSERT(HEADERLEN == sizeof(msg_len));
-  char buf[HEADERLEN + msg_len];
+  std::unique_ptr<char[]> send_buf(new char[HEADERLEN + msg_len]);
+  char* buf = send_buf.get();
 
   /* copy the header into the buf */
   PL_MEMCPY(buf, &msg_len, sizeof(msg_len));
@@ -98,9 +100,9 @@ void RpcChannel::CallMethod(
    * it will be returned. If not, a new connection will be created and connect
    * to server
    */
-  Connection* conn = ConnectionManager::GetInstance().CreateConn(
-      addr_);  // CreateConn is used for self connect
-  // Connection* conn = ConnectionManager::GetInstance().GetConn(addr_);
+  // The pooled connection is dropped when it closes, so the next call
+  // connects again
+  Connection* conn = ConnectionManager::GetInstance().GetConn(addr_);
 
   /* Connect to server with given address */
   if (conn == NULL) {
@@ -116,6 +118,8 @@ void RpcChannel::CallMethod(
    */
   if (conn->AddToWriteBuffer(buf, HEADERLEN + msg_len) == false) {
     LOG_TRACE("Write data Error");
+
+    controller->SetFailed("Write Error");
     return;
   }
 }
@@ -84,6 +84,8 @@ bool RpcServer::RegisterService(google::protobuf::Service *service) {
 
 void RpcServer::Start() { listener_.Run(this); }
 
+void RpcServer::Stop() { listener_.Stop(); }
+
 void RpcServer::RemoveService() {
   for (RpcMethodMap::iterator iter = rpc_method_map_.begin();
        iter != rpc_method_map_.end(); iter++) {
@@ -12,6 +12,7 @@
 
 
 #include <iostream>
+#include <memory>
 #include <mutex>
 
 #include <pthread.h>
@@ -138,9 +139,10 @@ void *Connection::ProcessMessage(void *connection) {
     /*
      * Get a message.
      * Note: we only get one message each time. so the buf is msg_len +
-     * HEADERLEN
+     * HEADERLEN. On the heap, a shipped log buffer runs to megabytes
      */
-    char buf[msg_len + HEADERLEN];
+    std::unique_ptr<char[]> recv_buf(new char[msg_len + HEADERLEN]);
+    char *buf = recv_buf.get();
 
     // Get the data
     conn->GetReadData(buf, msg_len + HEADERLEN);
@@ -220,7 +222,8 @@ void *Connection::ProcessMessage(void *connection) {
         google::protobuf::Message *message = rpc_method->response_->New();
 
         // Deserialize the receiving message
-        message->ParseFromString(buf + HEADERLEN + TYPELEN + OPCODELEN);
+        message->ParseFromArray(buf + HEADERLEN + TYPELEN + OPCODELEN,
+                                msg_len - TYPELEN - OPCODELEN);
 
         // Invoke rpc call. request is null
         rpc_method->service_->CallMethod(method, &controller, NULL, message,
@@ -282,20 +285,11 @@ void Connection::ReadCb(UNUSED_ATTRIBUTE struct bufferevent *bev, void *ctx) {
 
   /*
    * Process the message will invoke rpc call.
-   * Note: this might take a long time. So we put this in a thread
-   */
-
-  /* prepaere workers_thread to send and recv data */
-  std::function<void()> worker_conn =
-      std::bind(&Connection::ProcessMessage, conn);
-
-  /*
-   * Add workers to thread pool to send and recv data
-   * Note: after AddTask, ReadCb will return and another
-   * request on this connection can be processed while
-   * the former is still being processed
+   * Note: the messages of a connection are processed in the order they
+   *       arrive, which the log replay of a standby relies on. So this
+   *       happens in the event thread rather than in a thread pool.
    */
-  //PthreadThreadPool::GetInstance().AddTask(worker_conn);
+  Connection::ProcessMessage(conn);
 }
 
 /*
@@ -322,10 +316,7 @@ void Connection::EventCb(UNUSED_ATTRIBUTE struct bufferevent *bev, short events,
 
     /* Since the connection is closed, we should delete it from conn_pool */
     ConnectionManager::GetInstance().DeleteConn(conn);
-  }
-
-  /* The other side explicitly closes the connection */
-  if (events & (BEV_EVENT_EOF | BEV_EVENT_ERROR)) {
+  } else if (events & BEV_EVENT_EOF) {
     /* This means server explicitly closes the connection */
     LOG_TRACE("ClientEventCb: %s",
               evutil_socket_error_to_string(
@@ -29,9 +29,13 @@ namespace peloton {
 namespace networking {
 
 Listener::Listener(int port)
-    : port_(port), listen_base_(event_base_new()), listener_(NULL) {
-  // make libevent support multiple threads (pthread)
-  // TODO: put evthread_use_pthreads before event_base_new()?
+    : port_(port), listen_base_(NULL), listener_(NULL) {
+  // make libevent support multiple threads (pthread), this must happen
+  // before the event base is created. Other threads write to the
+  // connections of the base while it dispatches.
+  evthread_use_pthreads();
+
+  listen_base_ = event_base_new();
 
   PL_ASSERT(listen_base_ != NULL);
   PL_ASSERT(port_ > 0 && port_ < 65535);
@@ -67,10 +71,6 @@ void Listener::Run(void *arg) {
   /* Listen on the given port. */
   sin.sin_port = htons(port_);
 
-  // TODO: Fix cmake to link in "-levent_pthreads"
-  /* We must specify this function if we use multiple threads*/
-  // evthread_use_pthreads();
-
   // TODO: LEV_OPT_THREADSAFE is necessary here?
   listener_ = evconnlistener_new_bind(
       listen_base_, AcceptConnCb, arg,
@@ -86,14 +86,22 @@ void Listener::Run(void *arg) {
 
   event_base_dispatch(listen_base_);
 
-  /* These are called after dispatch execution. */
-  evconnlistener_free(listener_);
-  event_base_free(listen_base_);
+  /* The listener and the base are freed by the destructor, the connections
+   * of the base may still be alive. */
 
   LOG_TRACE("Serving is done");
   return;
 }
 
+/*
+ * @brief Stop makes Run return. It can be invoked by any thread
+ */
+void Listener::Stop() {
+  if (listen_base_ != NULL) {
+    event_base_loopexit(listen_base_, NULL);
+  }
+}
+
 /*
  * @breif AcceptConnCb processes the new connection.
  *        First it new a connection with the passing by socket and ctx
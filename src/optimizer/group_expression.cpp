@@ -13,15 +13,136 @@
 
 #include "optimizer/group_expression.h"
 #include "optimizer/group.h"
+#include "optimizer/operators.h"
+#include "optimizer/table_write_stats.h"
+
+#include "storage/data_table.h"
+
+#include <algorithm>
 
 namespace peloton {
 namespace optimizer {
 
+namespace {
+
+// Costs are in units of passing one tuple on to the parent
+const double tuple_cost = 1.0;
+
+// evaluating a predicate or an expression on a tuple
+const double operator_cost = 0.25;
+
+const double hash_build_cost = 2.0;
+
+const double hash_probe_cost = 1.0;
+
+// Guesses for tables and columns without stats
+const double default_tuple_count = 1000;
+
+const double default_equal_selectivity = 0.005;
+
+const double default_range_selectivity = 1.0 / 3;
+
+double EstimateTupleCount(storage::DataTable *table) {
+  // Fresher than ANALYZE, unless the table was filled around its write path
+  auto write_stats = table->GetWriteStats();
+  if (write_stats != nullptr && write_stats->GetTupleCount() > 0) {
+    return write_stats->GetTupleCount();
+  }
+
+  auto table_stats = TableStats::Lookup(table->GetOid());
+  if (table_stats != nullptr) return table_stats->GetTupleCount();
+
+  if (table->GetNumberOfTuples() > 0) return table->GetNumberOfTuples();
+  return default_tuple_count;
+}
+
+std::shared_ptr<ColumnStats> LookupColumnStats(const Column *column) {
+  auto table_column = dynamic_cast<const TableColumn *>(column);
+  if (table_column == nullptr) return nullptr;
+
+  auto table_stats = TableStats::Lookup(table_column->BaseTableOid());
+  if (table_stats == nullptr) return nullptr;
+  return table_stats->GetColumnStats(table_column->ColumnIndexOid());
+}
+
+// "a < b" is "b > a"
+ExpressionType CommuteCompare(ExpressionType type) {
+  switch (type) {
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHAN;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return EXPRESSION_TYPE_COMPARE_LESSTHAN;
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO;
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO;
+    default:
+      return type;
+  }
+}
+
+double CompareSelectivity(ExpressionType type, const Stats &left,
+                          const Stats &right) {
+  // column <op> constant
+  if (left.column_stats != nullptr && right.has_constant) {
+    return left.column_stats->GetSelectivity(type, right.constant);
+  }
+  if (right.column_stats != nullptr && left.has_constant) {
+    return right.column_stats->GetSelectivity(CommuteCompare(type),
+                                              left.constant);
+  }
+
+  switch (type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL: {
+      // column = column, every value of the column with fewer distinct
+      // values finds its match in the other
+      double distinct_count = 0;
+      double non_null_fraction = 1;
+      for (auto column_stats : {left.column_stats, right.column_stats}) {
+        if (column_stats == nullptr) continue;
+        distinct_count =
+            std::max(distinct_count, column_stats->GetDistinctCount());
+        non_null_fraction *= 1 - column_stats->GetNullFraction();
+      }
+      if (distinct_count < 1) return default_equal_selectivity;
+      return non_null_fraction / distinct_count;
+    }
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return 1 - default_equal_selectivity;
+    default:
+      return default_range_selectivity;
+  }
+}
+
+double JoinCardinality(OpType type, double left_cardinality,
+                       double right_cardinality, double selectivity) {
+  double cardinality = left_cardinality * right_cardinality * selectivity;
+  switch (type) {
+    case OpType::LeftNLJoin:
+    case OpType::LeftHashJoin:
+      return std::max(cardinality, left_cardinality);
+    case OpType::RightNLJoin:
+    case OpType::RightHashJoin:
+      return std::max(cardinality, right_cardinality);
+    case OpType::OuterNLJoin:
+    case OpType::OuterHashJoin:
+      return std::max(cardinality,
+                      std::max(left_cardinality, right_cardinality));
+    default:
+      return cardinality;
+  }
+}
+
+}  // namespace
+
 //===--------------------------------------------------------------------===//
 // Group Expression
 //===--------------------------------------------------------------------===//
 GroupExpression::GroupExpression(Operator op, std::vector<GroupID> child_groups)
-    : group_id(UNDEFINED_GROUP), op(op), child_groups(child_groups) {}
+    : group_id(UNDEFINED_GROUP),
+      op(op),
+      child_groups(child_groups),
+      cost(0) {}
 
 GroupID GroupExpression::GetGroupID() const { return group_id; }
 
@@ -37,11 +158,114 @@ std::shared_ptr<Stats> GroupExpression::GetStats() const { return stats; }
 
 double GroupExpression::GetCost() const { return cost; }
 
+/**
+ * @brief Operators derive their cardinality from the cardinalities of their
+ * inputs and the selectivities of their predicates. Expressions derive
+ * selectivities bottom up, from the stats of the columns they compare.
+ */
 void GroupExpression::DeriveStatsAndCost(
     std::vector<std::shared_ptr<Stats>> child_stats,
     std::vector<double> child_costs) {
-  (void)child_stats;
-  (void)child_costs;
+  double input_cost = 0;
+  for (double child_cost : child_costs) input_cost += child_cost;
+
+  // Children that were not costed count as a single row
+  std::vector<Stats> inputs;
+  for (auto &child : child_stats) {
+    inputs.push_back(child != nullptr ? *child : Stats(1));
+  }
+
+  switch (op.type()) {
+    case OpType::Scan: {
+      const PhysicalScan *scan = op.as<PhysicalScan>();
+      stats = std::make_shared<Stats>(EstimateTupleCount(scan->table));
+      cost = stats->cardinality * tuple_cost;
+    } break;
+    case OpType::Filter: {
+      PL_ASSERT(inputs.size() == 2);
+      stats = std::make_shared<Stats>(inputs[0].cardinality *
+                                      inputs[1].selectivity);
+      cost = input_cost + inputs[0].cardinality * operator_cost +
+             stats->cardinality * tuple_cost;
+    } break;
+    case OpType::ComputeExprs: {
+      PL_ASSERT(inputs.size() == 2);
+      stats = std::make_shared<Stats>(inputs[0].cardinality);
+      cost = input_cost + stats->cardinality * (operator_cost + tuple_cost);
+    } break;
+    case OpType::InnerNLJoin:
+    case OpType::LeftNLJoin:
+    case OpType::RightNLJoin:
+    case OpType::OuterNLJoin: {
+      PL_ASSERT(inputs.size() == 3);
+      double left = inputs[0].cardinality;
+      double right = inputs[1].cardinality;
+      stats = std::make_shared<Stats>(
+          JoinCardinality(op.type(), left, right, inputs[2].selectivity));
+      // the predicate is evaluated on every pair
+      cost = input_cost + left * right * operator_cost +
+             stats->cardinality * tuple_cost;
+    } break;
+    case OpType::InnerHashJoin:
+    case OpType::LeftHashJoin:
+    case OpType::RightHashJoin:
+    case OpType::OuterHashJoin: {
+      PL_ASSERT(inputs.size() == 3);
+      double left = inputs[0].cardinality;
+      double right = inputs[1].cardinality;
+      stats = std::make_shared<Stats>(
+          JoinCardinality(op.type(), left, right, inputs[2].selectivity));
+      // the hash table is built on the right input
+      cost = input_cost + right * hash_build_cost + left * hash_probe_cost +
+             stats->cardinality * tuple_cost;
+    } break;
+    case OpType::Variable: {
+      stats = std::make_shared<Stats>(1);
+      stats->column_stats = LookupColumnStats(op.as<ExprVariable>()->column);
+      cost = 0;
+    } break;
+    case OpType::Constant: {
+      stats = std::make_shared<Stats>(1);
+      stats->has_constant = true;
+      stats->constant = op.as<ExprConstant>()->value;
+      // a constant predicate
+      if (stats->constant.GetValueType() == VALUE_TYPE_BOOLEAN &&
+          stats->constant.IsNull() == false) {
+        stats->selectivity = stats->constant.IsTrue() ? 1 : 0;
+      }
+      cost = 0;
+    } break;
+    case OpType::Compare: {
+      PL_ASSERT(inputs.size() == 2);
+      stats = std::make_shared<Stats>(1);
+      stats->selectivity = CompareSelectivity(
+          op.as<ExprCompare>()->expr_type, inputs[0], inputs[1]);
+      cost = 0;
+    } break;
+    case OpType::BoolOp: {
+      stats = std::make_shared<Stats>(1);
+      switch (op.as<ExprBoolOp>()->bool_type) {
+        case BoolOpType::Not:
+          PL_ASSERT(inputs.size() == 1);
+          stats->selectivity = 1 - inputs[0].selectivity;
+          break;
+        case BoolOpType::And:
+          // the conjuncts are independent
+          for (auto &input : inputs) stats->selectivity *= input.selectivity;
+          break;
+        case BoolOpType::Or: {
+          double none = 1;
+          for (auto &input : inputs) none *= 1 - input.selectivity;
+          stats->selectivity = 1 - none;
+        } break;
+      }
+      cost = 0;
+    } break;
+    default: {
+      stats = std::make_shared<Stats>(1);
+      cost = input_cost;
+    } break;
+  }
 }
 
 hash_t GroupExpression::Hash() const {
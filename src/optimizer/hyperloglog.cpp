@@ -0,0 +1,102 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hyperloglog.cpp
+//
+// Identification: src/optimizer/hyperloglog.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/hyperloglog.h"
+
+#include "common/macros.h"
+#include "common/value.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// Value hashes are weak for integers (often the integer itself), spread
+// them over all 64 bits first
+inline uint64_t Mix(uint64_t hash) {
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdULL;
+  hash ^= hash >> 33;
+  hash *= 0xc4ceb9fe1a85ec53ULL;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// HyperLogLog
+//===--------------------------------------------------------------------===//
+HyperLogLog::HyperLogLog(int precision)
+    : precision(precision), registers(1 << precision, 0) {
+  PL_ASSERT(precision >= 4 && precision <= 16);
+}
+
+void HyperLogLog::Add(const Value &value) {
+  std::size_t hash = 0;
+  value.HashCombine(hash);
+  AddHash(Mix(hash));
+}
+
+void HyperLogLog::AddHash(uint64_t hash) {
+  size_t index = hash >> (64 - precision);
+
+  // position of the first one bit in the rest of the hash, the guard bit
+  // bounds it when the rest is all zeros
+  uint64_t rest = (hash << precision) | (1ULL << (precision - 1));
+  uint8_t rank = static_cast<uint8_t>(__builtin_clzll(rest) + 1);
+
+  // Registers only grow, a racing writer that lost keeps the larger rank.
+  // Once the sketch warmed up most hashes do not raise their register and
+  // only read it.
+  uint8_t current = __atomic_load_n(&registers[index], __ATOMIC_RELAXED);
+  while (current < rank &&
+         !__atomic_compare_exchange_n(&registers[index], &current, rank, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+  }
+}
+
+void HyperLogLog::Merge(const HyperLogLog &other) {
+  PL_ASSERT(precision == other.precision);
+  for (size_t itr = 0; itr < registers.size(); itr++) {
+    uint8_t rank = __atomic_load_n(&other.registers[itr], __ATOMIC_RELAXED);
+    registers[itr] = std::max(registers[itr], rank);
+  }
+}
+
+double HyperLogLog::Estimate() const {
+  double register_count = registers.size();
+  double alpha = 0.7213 / (1 + 1.079 / register_count);
+
+  double sum = 0;
+  size_t zero_count = 0;
+  for (auto &reg : registers) {
+    uint8_t rank = __atomic_load_n(&reg, __ATOMIC_RELAXED);
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) zero_count++;
+  }
+
+  double estimate = alpha * register_count * register_count / sum;
+
+  // Linear counting is more accurate while many registers are still empty
+  if (estimate <= 2.5 * register_count && zero_count != 0) {
+    estimate = register_count * std::log(register_count / zero_count);
+  }
+
+  return estimate;
+}
+
+} /* namespace optimizer */
+} /* namespace peloton */
@@ -40,7 +40,7 @@ Optimizer::Optimizer() {
   rules.emplace_back(new LeftJoinToLeftNLJoin());
   rules.emplace_back(new RightJoinToRightNLJoin());
   rules.emplace_back(new OuterJoinToOuterNLJoin());
-  // rules.emplace_back(new InnerJoinToInnerHashJoin());
+  rules.emplace_back(new InnerJoinToInnerHashJoin());
 }
 
 Optimizer &Optimizer::GetInstance() {
@@ -76,7 +76,8 @@ std::shared_ptr<GroupExpression> Optimizer::InsertQueryTree(
   std::shared_ptr<OpExpression> initial =
       ConvertQueryToOpExpression(column_manager, tree);
   std::shared_ptr<GroupExpression> gexpr;
-  assert(RecordTransformedExpression(initial, gexpr));
+  UNUSED_ATTRIBUTE bool inserted = RecordTransformedExpression(initial, gexpr);
+  assert(inserted);
   return gexpr;
 }
 
@@ -307,7 +307,12 @@ InnerJoinToInnerHashJoin::InnerJoinToInnerHashJoin() {
   // Make three node types for pattern matching
   std::shared_ptr<Pattern> left_child(std::make_shared<Pattern>(OpType::Leaf));
   std::shared_ptr<Pattern> right_child(std::make_shared<Pattern>(OpType::Leaf));
-  std::shared_ptr<Pattern> predicate(std::make_shared<Pattern>(OpType::Leaf));
+
+  // Only a comparison of two columns can be hashed
+  std::shared_ptr<Pattern> predicate(
+      std::make_shared<Pattern>(OpType::Compare));
+  predicate->AddChild(std::make_shared<Pattern>(OpType::Variable));
+  predicate->AddChild(std::make_shared<Pattern>(OpType::Variable));
 
   // Initialize a pattern for optimizer to match
   match_pattern = std::make_shared<Pattern>(OpType::InnerJoin);
@@ -321,9 +326,12 @@ InnerJoinToInnerHashJoin::InnerJoinToInnerHashJoin() {
 }
 
 bool InnerJoinToInnerHashJoin::Check(std::shared_ptr<OpExpression> plan) const {
-  (void)plan;
-  // TODO(abpoms): Figure out how to determine if the join condition is hashable
-  return false;
+  std::vector<std::shared_ptr<OpExpression>> children = plan->Children();
+  assert(children.size() == 3);
+
+  // and only if they are equal
+  const ExprCompare *predicate = children[2]->Op().as<ExprCompare>();
+  return predicate->expr_type == EXPRESSION_TYPE_COMPARE_EQUAL;
 }
 
 void InnerJoinToInnerHashJoin::Transform(
@@ -10,15 +10,368 @@
 //
 //===----------------------------------------------------------------------===//
 
-
 #include "optimizer/stats.h"
+#include "optimizer/hyperloglog.h"
+#include "optimizer/table_write_stats.h"
+#include "optimizer/tuple_sample.h"
+
+#include "catalog/manager.h"
+#include "common/value_peeker.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace peloton {
 namespace optimizer {
 
+namespace {
+
+const size_t default_sample_size = 30000;
+
+const size_t max_most_common_values = 100;
+
+const size_t max_bucket_count = 100;
+
+// Fraction of the values a range keeps when the bounds are not known
+const double unknown_range_fraction = 1.0 / 3;
+
+// IsNumeric() throws on some types
+inline bool CanInterpolate(ValueType type) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_DECIMAL:
+    case VALUE_TYPE_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline double ToDouble(const Value &value) {
+  return ValuePeeker::PeekDouble(value.CastAs(VALUE_TYPE_DOUBLE));
+}
+
+inline double Clamp(double fraction) {
+  return std::min(1.0, std::max(0.0, fraction));
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Column Stats
+//===--------------------------------------------------------------------===//
+ColumnStats::ColumnStats(std::vector<Value> sample_values,
+                         double distinct_count, double tuple_count)
+    : null_fraction(0),
+      distinct_count(0),
+      pool(new VarlenPool(BACKEND_TYPE_MM)),
+      histogram_fraction(0) {
+  if (sample_values.empty()) return;
+  double sample_count = sample_values.size();
+
+  auto nulls =
+      std::partition(sample_values.begin(), sample_values.end(),
+                     [](const Value &value) { return !value.IsNull(); });
+  sample_values.erase(nulls, sample_values.end());
+  null_fraction = 1 - sample_values.size() / sample_count;
+  if (sample_values.empty()) return;
+
+  std::sort(sample_values.begin(), sample_values.end(),
+            [](const Value &left, const Value &right) {
+              return left.Compare(right) < 0;
+            });
+
+  // Runs of equal values, (offset of the run, length)
+  std::vector<std::pair<size_t, size_t>> runs;
+  for (size_t itr = 0; itr < sample_values.size(); itr++) {
+    if (runs.empty() ||
+        sample_values[runs.back().first].Compare(sample_values[itr]) != 0) {
+      runs.emplace_back(itr, 0);
+    }
+    runs.back().second++;
+  }
+
+  // The sample holds every tuple, its distinct count is exact
+  if (sample_count >= tuple_count) {
+    this->distinct_count = runs.size();
+  } else {
+    this->distinct_count = std::max<double>(distinct_count, runs.size());
+    this->distinct_count = std::min(this->distinct_count,
+                                    tuple_count * (1 - null_fraction));
+  }
+
+  // A value is common if it is more frequent than the average value. If the
+  // sample saw all values and they fit, all of them are common.
+  std::vector<std::pair<size_t, size_t>> common_runs;
+  bool all_common = runs.size() <= max_most_common_values &&
+                    this->distinct_count <= runs.size();
+  double average_run = sample_values.size() / this->distinct_count;
+  for (auto &run : runs) {
+    if (all_common || (run.second > 1 && run.second > 1.25 * average_run)) {
+      common_runs.push_back(run);
+    }
+  }
+  std::stable_sort(common_runs.begin(), common_runs.end(),
+                   [](const std::pair<size_t, size_t> &left,
+                      const std::pair<size_t, size_t> &right) {
+                     return left.second > right.second;
+                   });
+  if (common_runs.size() > max_most_common_values) {
+    common_runs.resize(max_most_common_values);
+  }
+
+  double common_count = 0;
+  for (auto &run : common_runs) {
+    most_common_values.emplace_back(
+        Value::Clone(sample_values[run.first], pool.get()),
+        run.second / sample_count);
+    common_count += run.second;
+  }
+  std::sort(common_runs.begin(), common_runs.end());
+
+  // The histogram covers the values that are not common
+  std::vector<Value> rest;
+  rest.reserve(sample_values.size() - common_count);
+  size_t common_itr = 0;
+  for (auto &run : runs) {
+    if (common_itr < common_runs.size() &&
+        common_runs[common_itr].first == run.first) {
+      common_itr++;
+      continue;
+    }
+    for (size_t itr = 0; itr < run.second; itr++) {
+      rest.push_back(sample_values[run.first + itr]);
+    }
+  }
+
+  histogram_fraction = rest.size() / sample_count;
+  if (rest.empty()) return;
+
+  size_t bucket_count = std::min(max_bucket_count, rest.size());
+  for (size_t bucket = 0; bucket <= bucket_count; bucket++) {
+    size_t offset = bucket * (rest.size() - 1) / bucket_count;
+    histogram_bounds.push_back(Value::Clone(rest[offset], pool.get()));
+  }
+}
+
+ColumnStats::ColumnStats(double null_fraction, double distinct_count,
+                         const Value &min_value, const Value &max_value)
+    : null_fraction(Clamp(null_fraction)),
+      distinct_count(distinct_count),
+      pool(new VarlenPool(BACKEND_TYPE_MM)),
+      histogram_fraction(1 - this->null_fraction) {
+  if (min_value.IsNull() || max_value.IsNull()) return;
+
+  // One bucket
+  histogram_bounds.push_back(Value::Clone(min_value, pool.get()));
+  histogram_bounds.push_back(Value::Clone(max_value, pool.get()));
+}
+
+double ColumnStats::GetNullFraction() const { return null_fraction; }
+
+double ColumnStats::GetDistinctCount() const { return distinct_count; }
+
+const std::vector<std::pair<Value, double>> &ColumnStats::GetMostCommonValues()
+    const {
+  return most_common_values;
+}
+
+const std::vector<Value> &ColumnStats::GetHistogramBounds() const {
+  return histogram_bounds;
+}
+
+double ColumnStats::GetSelectivity(ExpressionType type,
+                                   const Value &value) const {
+  // Comparisons with null never hold
+  if (value.IsNull()) return 0;
+
+  double non_null_fraction = 1 - null_fraction;
+  switch (type) {
+    case EXPRESSION_TYPE_COMPARE_EQUAL:
+      return GetEqualSelectivity(value);
+    case EXPRESSION_TYPE_COMPARE_NOTEQUAL:
+      return Clamp(non_null_fraction - GetEqualSelectivity(value));
+    case EXPRESSION_TYPE_COMPARE_LESSTHAN:
+      return GetLessThanSelectivity(value, false);
+    case EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO:
+      return GetLessThanSelectivity(value, true);
+    case EXPRESSION_TYPE_COMPARE_GREATERTHAN:
+      return Clamp(non_null_fraction - GetLessThanSelectivity(value, true));
+    case EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO:
+      return Clamp(non_null_fraction - GetLessThanSelectivity(value, false));
+    default:
+      // LIKE, IN
+      return Clamp(non_null_fraction / 3);
+  }
+}
+
+double ColumnStats::GetEqualSelectivity(const Value &value) const {
+  for (auto &common_value : most_common_values) {
+    if (common_value.first.Compare(value) == 0) return common_value.second;
+  }
+
+  // The values that are not common share the histogram evenly
+  double rest_count = distinct_count - most_common_values.size();
+  if (rest_count < 1) return 0;
+  if (histogram_bounds.empty() == false &&
+      (value.Compare(histogram_bounds.front()) < 0 ||
+       value.Compare(histogram_bounds.back()) > 0)) {
+    return 0;
+  }
+  return Clamp(histogram_fraction / rest_count);
+}
+
+double ColumnStats::GetLessThanSelectivity(const Value &value,
+                                           bool inclusive) const {
+  double selectivity = 0;
+  for (auto &common_value : most_common_values) {
+    int compare = common_value.first.Compare(value);
+    if (compare < 0 || (inclusive && compare == 0)) {
+      selectivity += common_value.second;
+    }
+  }
+
+  selectivity += histogram_fraction * GetHistogramFraction(value);
+  if (inclusive) {
+    // the bucket interpolation leaves out the value itself
+    double rest_count = distinct_count - most_common_values.size();
+    if (rest_count >= 1 && histogram_bounds.empty() == false &&
+        value.Compare(histogram_bounds.front()) >= 0 &&
+        value.Compare(histogram_bounds.back()) < 0) {
+      selectivity += histogram_fraction / rest_count;
+    }
+  }
+
+  return Clamp(selectivity);
+}
+
+double ColumnStats::GetHistogramFraction(const Value &value) const {
+  if (histogram_bounds.empty()) return unknown_range_fraction;
+  if (value.Compare(histogram_bounds.front()) <= 0) return 0;
+  if (value.Compare(histogram_bounds.back()) > 0) return 1;
+
+  // First bound that is not below the value, the value is in the bucket
+  // that ends there
+  auto bound = std::lower_bound(histogram_bounds.begin(),
+                                histogram_bounds.end(), value,
+                                [](const Value &left, const Value &right) {
+                                  return left.Compare(right) < 0;
+                                });
+  size_t bucket = bound - histogram_bounds.begin() - 1;
+  double bucket_count = histogram_bounds.size() - 1;
+
+  // Assume the values are spread evenly within the bucket
+  double within = 0.5;
+  const Value &low = histogram_bounds[bucket];
+  const Value &high = histogram_bounds[bucket + 1];
+  if (CanInterpolate(value.GetValueType()) &&
+      CanInterpolate(low.GetValueType())) {
+    double low_value = ToDouble(low);
+    double high_value = ToDouble(high);
+    if (high_value > low_value) {
+      within = (ToDouble(value) - low_value) / (high_value - low_value);
+    }
+  }
+
+  return Clamp((bucket + Clamp(within)) / bucket_count);
+}
+
+//===--------------------------------------------------------------------===//
+// Table Stats
+//===--------------------------------------------------------------------===//
+TableStats::TableStats(double tuple_count) : tuple_count(tuple_count) {}
+
+/**
+ * @brief One pass over the visible tuples feeds the sample and the distinct
+ * count sketches of all columns.
+ */
+std::shared_ptr<TableStats> TableStats::Analyze(storage::DataTable *table) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  auto txn = concurrency::current_txn;
+
+  size_t sample_size = default_sample_size;
+  if (peloton_stats_sample_size > 0) sample_size = peloton_stats_sample_size;
+  TupleSample sample(sample_size);
+
+  oid_t column_count = table->GetSchema()->GetColumnCount();
+  std::vector<HyperLogLog> sketches(column_count);
+
+  concurrency::VisibilityBitmap visibility;
+  std::vector<oid_t> position_list;
+  auto tile_group_count = table->GetTileGroupCount();
+  for (oid_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+    if (tile_group == nullptr) continue;
+    oid_t tile_group_id = tile_group->GetTileGroupId();
+
+    txn_manager.ComputeVisibility(tile_group->GetHeader(),
+                                  txn->GetBeginCommitId(),
+                                  txn->GetTransactionId(), visibility);
+    position_list.clear();
+    concurrency::GetPositionList(visibility, position_list);
+
+    for (auto tuple_id : position_list) {
+      sample.AddTuple(ItemPointer(tile_group_id, tuple_id));
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        sketches[column_itr].Add(tile_group->GetValue(tuple_id, column_itr));
+      }
+    }
+  }
+
+  double tuple_count = sample.GetSeenCount();
+  std::shared_ptr<TableStats> stats(new TableStats(tuple_count));
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    double distinct_count = std::round(sketches[column_itr].Estimate());
+    stats->AddColumnStats(std::make_shared<ColumnStats>(
+        sample.GetColumnValues(column_itr), distinct_count, tuple_count));
+  }
+
+  txn_manager.CommitTransaction();
+
+  catalog::Manager::GetInstance().SetTableStats(table->GetOid(), stats);
+
+  LOG_DEBUG("Analyzed table %u : %.0f tuples, sampled %lu", table->GetOid(),
+            tuple_count, sample.GetTuples().size());
+  return stats;
+}
+
+std::shared_ptr<TableStats> TableStats::Lookup(oid_t table_oid) {
+  auto &manager = catalog::Manager::GetInstance();
+  auto stats = manager.GetTableStats(table_oid);
+  if (stats != nullptr) return stats;
+
+  auto write_stats = manager.GetTableWriteStats(table_oid);
+  if (write_stats == nullptr) return nullptr;
+  return write_stats->GetTableStats();
+}
+
+double TableStats::GetTupleCount() const { return tuple_count; }
+
+std::shared_ptr<ColumnStats> TableStats::GetColumnStats(
+    oid_t column_id) const {
+  if (column_id >= column_stats.size()) return nullptr;
+  return column_stats[column_id];
+}
+
+void TableStats::AddColumnStats(std::shared_ptr<ColumnStats> stats) {
+  column_stats.push_back(stats);
+}
+
 //===--------------------------------------------------------------------===//
 // Stats
 //===--------------------------------------------------------------------===//
+Stats::Stats(double cardinality)
+    : cardinality(cardinality),
+      selectivity(1),
+      has_constant(false) {}
 
 } /* namespace optimizer */
 } /* namespace peloton */
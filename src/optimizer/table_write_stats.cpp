@@ -0,0 +1,228 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_write_stats.cpp
+//
+// Identification: src/optimizer/table_write_stats.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "optimizer/table_write_stats.h"
+#include "optimizer/stats.h"
+
+#include "catalog/schema.h"
+#include "common/value_factory.h"
+#include "common/value_peeker.h"
+#include "storage/tuple.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace peloton {
+namespace optimizer {
+
+namespace {
+
+// More shards than cores that write at the same time keeps them apart
+const size_t shard_count = 16;
+
+const size_t counters_per_cache_line = 64 / sizeof(std::atomic<int64_t>);
+
+// Fewer registers than ANALYZE uses, every table column carries a sketch
+const int sketch_precision = 10;
+
+// Slots of a shard, the null counts of the columns follow
+enum CounterSlot {
+  COUNTER_SLOT_INSERTED = 0,
+  COUNTER_SLOT_UPDATED = 1,
+  COUNTER_SLOT_DELETED = 2,
+  COUNTER_SLOT_NULLS = 3
+};
+
+// A thread always counts in the same shard
+std::atomic<size_t> write_stats_thread_count(0);
+
+thread_local size_t write_stats_shard =
+    write_stats_thread_count++ % shard_count;
+
+inline bool HasBounds(ValueType type) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline double PeekNumeric(const Value &value) {
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_TINYINT:
+      return ValuePeeker::PeekTinyInt(value);
+    case VALUE_TYPE_SMALLINT:
+      return ValuePeeker::PeekSmallInt(value);
+    case VALUE_TYPE_INTEGER:
+      return ValuePeeker::PeekInteger(value);
+    case VALUE_TYPE_BIGINT:
+      return ValuePeeker::PeekBigInt(value);
+    default:
+      return ValuePeeker::PeekDouble(value);
+  }
+}
+
+}  // namespace
+
+//===--------------------------------------------------------------------===//
+// Table Write Stats
+//===--------------------------------------------------------------------===//
+TableWriteStats::TableWriteStats(const catalog::Schema *schema)
+    : column_count(schema->GetColumnCount()),
+      sketches(column_count, HyperLogLog(sketch_precision)),
+      min_values(new std::atomic<double>[column_count]),
+      max_values(new std::atomic<double>[column_count]),
+      merged_write_count(0) {
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    column_types.push_back(schema->GetType(column_itr));
+    min_values[column_itr] = std::numeric_limits<double>::infinity();
+    max_values[column_itr] = -std::numeric_limits<double>::infinity();
+  }
+
+  size_t slot_count = COUNTER_SLOT_NULLS + column_count;
+  shard_stride = (slot_count + counters_per_cache_line - 1) /
+                 counters_per_cache_line * counters_per_cache_line;
+  counters.reset(new std::atomic<int64_t>[shard_count * shard_stride]);
+  for (size_t itr = 0; itr < shard_count * shard_stride; itr++) {
+    counters[itr] = 0;
+  }
+}
+
+void TableWriteStats::AddTuple(const storage::Tuple *tuple) {
+  GetCounter(COUNTER_SLOT_INSERTED).fetch_add(1, std::memory_order_relaxed);
+  AddValues(tuple);
+}
+
+void TableWriteStats::UpdateTuple(const storage::Tuple *tuple) {
+  GetCounter(COUNTER_SLOT_UPDATED).fetch_add(1, std::memory_order_relaxed);
+  AddValues(tuple);
+}
+
+void TableWriteStats::DeleteTuple() {
+  GetCounter(COUNTER_SLOT_DELETED).fetch_add(1, std::memory_order_relaxed);
+}
+
+void TableWriteStats::AddValues(const storage::Tuple *tuple) {
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    Value value = tuple->GetValue(column_itr);
+    if (value.IsNull()) {
+      GetCounter(COUNTER_SLOT_NULLS + column_itr)
+          .fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    sketches[column_itr].Add(value);
+    if (HasBounds(column_types[column_itr])) {
+      UpdateBounds(column_itr, PeekNumeric(value));
+    }
+  }
+}
+
+void TableWriteStats::UpdateBounds(oid_t column_id, double value) {
+  // Like the sketch registers, the bounds only widen and rarely change
+  auto &min_value = min_values[column_id];
+  double current = min_value.load(std::memory_order_relaxed);
+  while (value < current &&
+         !min_value.compare_exchange_weak(current, value,
+                                          std::memory_order_relaxed)) {
+  }
+
+  auto &max_value = max_values[column_id];
+  current = max_value.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max_value.compare_exchange_weak(current, value,
+                                          std::memory_order_relaxed)) {
+  }
+}
+
+std::atomic<int64_t> &TableWriteStats::GetCounter(size_t slot) {
+  return counters[write_stats_shard * shard_stride + slot];
+}
+
+int64_t TableWriteStats::SumCounter(size_t slot) const {
+  int64_t sum = 0;
+  for (size_t shard = 0; shard < shard_count; shard++) {
+    sum += counters[shard * shard_stride + slot].load(
+        std::memory_order_relaxed);
+  }
+  return sum;
+}
+
+double TableWriteStats::GetTupleCount() const {
+  int64_t tuple_count = SumCounter(COUNTER_SLOT_INSERTED) -
+                        SumCounter(COUNTER_SLOT_DELETED);
+  return std::max<int64_t>(tuple_count, 0);
+}
+
+double TableWriteStats::GetNullFraction(oid_t column_id) const {
+  double written_count =
+      SumCounter(COUNTER_SLOT_INSERTED) + SumCounter(COUNTER_SLOT_UPDATED);
+  if (written_count == 0) return 0;
+
+  double null_count = SumCounter(COUNTER_SLOT_NULLS + column_id);
+  return std::min(1.0, null_count / written_count);
+}
+
+double TableWriteStats::GetDistinctCount(oid_t column_id) const {
+  // The sketch still counts the values of deleted tuples
+  double non_null_count = GetTupleCount() * (1 - GetNullFraction(column_id));
+  return std::min(std::round(sketches[column_id].Estimate()),
+                  std::round(non_null_count));
+}
+
+bool TableWriteStats::GetBounds(oid_t column_id, double &min_value,
+                                double &max_value) const {
+  min_value = min_values[column_id].load(std::memory_order_relaxed);
+  max_value = max_values[column_id].load(std::memory_order_relaxed);
+  return min_value <= max_value;
+}
+
+std::shared_ptr<TableStats> TableWriteStats::GetTableStats() {
+  // Counted before merging, writes that race with the merge are picked up
+  // by the next one
+  int64_t write_count = SumCounter(COUNTER_SLOT_INSERTED) +
+                        SumCounter(COUNTER_SLOT_UPDATED) +
+                        SumCounter(COUNTER_SLOT_DELETED);
+
+  std::lock_guard<std::mutex> lock(merge_mutex);
+  if (merged_stats != nullptr && merged_write_count == write_count) {
+    return merged_stats;
+  }
+
+  std::shared_ptr<TableStats> stats(new TableStats(GetTupleCount()));
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    Value min_value = ValueFactory::GetNullValue();
+    Value max_value = ValueFactory::GetNullValue();
+    double min_bound, max_bound;
+    if (GetBounds(column_itr, min_bound, max_bound)) {
+      min_value = ValueFactory::GetDoubleValue(min_bound);
+      max_value = ValueFactory::GetDoubleValue(max_bound);
+    }
+
+    stats->AddColumnStats(std::make_shared<ColumnStats>(
+        GetNullFraction(column_itr), GetDistinctCount(column_itr), min_value,
+        max_value));
+  }
+
+  merged_write_count = write_count;
+  merged_stats = stats;
+  return stats;
+}
+
+} /* namespace optimizer */
+} /* namespace peloton */
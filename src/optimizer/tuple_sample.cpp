@@ -10,18 +10,61 @@
 //
 //===----------------------------------------------------------------------===//
 
-
 #include "optimizer/tuple_sample.h"
 
+#include "catalog/manager.h"
+#include "storage/tile_group.h"
+
 namespace peloton {
 namespace optimizer {
 
-//===--------------------------------------------------------------------===//
-// TupleSample
-//===--------------------------------------------------------------------===//
-TupleSample::TupleSample(std::vector<Column *> columns,
-                         storage::TileGroup *sampled_tuples)
-    : columns(columns), sampled_tuples(sampled_tuples) {}
+TupleSample::TupleSample(size_t sample_size)
+    : sample_size(sample_size), seen_count(0) {
+  tuples.reserve(sample_size);
+}
+
+void TupleSample::AddTuple(const ItemPointer &location) {
+  seen_count++;
+
+  if (tuples.size() < sample_size) {
+    tuples.push_back(location);
+    return;
+  }
+
+  // The i-th tuple replaces a sampled one with probability sample_size / i
+  std::uniform_int_distribution<size_t> distribution(0, seen_count - 1);
+  size_t slot = distribution(random);
+  if (slot < sample_size) {
+    tuples[slot] = location;
+  }
+}
+
+size_t TupleSample::GetSeenCount() const { return seen_count; }
+
+const std::vector<ItemPointer> &TupleSample::GetTuples() const {
+  return tuples;
+}
+
+std::vector<Value> TupleSample::GetColumnValues(oid_t column_id) const {
+  auto &manager = catalog::Manager::GetInstance();
+
+  std::vector<Value> values;
+  values.reserve(tuples.size());
+
+  std::shared_ptr<storage::TileGroup> tile_group;
+  for (auto &location : tuples) {
+    if (tile_group == nullptr ||
+        tile_group->GetTileGroupId() != location.block) {
+      tile_group = manager.GetTileGroup(location.block);
+    }
+    // dropped since it was sampled
+    if (tile_group == nullptr) continue;
+
+    values.push_back(tile_group->GetValue(location.offset, column_id));
+  }
+
+  return values;
+}
 
 } /* namespace optimizer */
 } /* namespace peloton */
@@ -0,0 +1,462 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile.cpp
+//
+// Identification: src/storage/compressed_tile.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "storage/compressed_tile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+
+#include "common/logger.h"
+#include "common/value_peeker.h"
+
+namespace peloton {
+namespace storage {
+
+//===--------------------------------------------------------------------===//
+// Bit packing
+//===--------------------------------------------------------------------===//
+
+static inline size_t GetBitWidth(uint64_t value) {
+  return (value == 0) ? 0 : 64 - __builtin_clzll(value);
+}
+
+// One extra word, so that a value is always read from two words
+static inline size_t GetPackedWordCount(size_t count, size_t bit_width) {
+  return (count * bit_width + 63) / 64 + 1;
+}
+
+static inline void Pack(std::vector<uint64_t> &packed, size_t bit_width,
+                        size_t index, uint64_t value) {
+  if (bit_width == 0) return;
+
+  size_t bit = index * bit_width;
+  size_t word = bit / 64;
+  size_t shift = bit % 64;
+
+  packed[word] |= value << shift;
+  if (shift + bit_width > 64) {
+    packed[word + 1] |= value >> (64 - shift);
+  }
+}
+
+static inline uint64_t Unpack(const uint64_t *packed, size_t bit_width,
+                              size_t index) {
+  if (bit_width == 0) return 0;
+
+  size_t bit = index * bit_width;
+  size_t word = bit / 64;
+  size_t shift = bit % 64;
+
+  uint64_t value = packed[word] >> shift;
+  if (shift + bit_width > 64) {
+    value |= packed[word + 1] << (64 - shift);
+  }
+
+  return (bit_width == 64) ? value : value & ((1ULL << bit_width) - 1);
+}
+
+//===--------------------------------------------------------------------===//
+// Integer fields
+//===--------------------------------------------------------------------===//
+
+static bool IsFrameOfReferenceType(ValueType type) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+    case VALUE_TYPE_TIMESTAMP:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static inline int64_t LoadInteger(const char *field, size_t width) {
+  switch (width) {
+    case 1: {
+      int8_t value;
+      std::memcpy(&value, field, sizeof(value));
+      return value;
+    }
+    case 2: {
+      int16_t value;
+      std::memcpy(&value, field, sizeof(value));
+      return value;
+    }
+    case 4: {
+      int32_t value;
+      std::memcpy(&value, field, sizeof(value));
+      return value;
+    }
+    default: {
+      int64_t value;
+      std::memcpy(&value, field, sizeof(value));
+      return value;
+    }
+  }
+}
+
+static inline void StoreInteger(int64_t value, size_t width, char *field) {
+  switch (width) {
+    case 1: {
+      int8_t narrow = static_cast<int8_t>(value);
+      std::memcpy(field, &narrow, sizeof(narrow));
+    } break;
+    case 2: {
+      int16_t narrow = static_cast<int16_t>(value);
+      std::memcpy(field, &narrow, sizeof(narrow));
+    } break;
+    case 4: {
+      int32_t narrow = static_cast<int32_t>(value);
+      std::memcpy(field, &narrow, sizeof(narrow));
+    } break;
+    default:
+      std::memcpy(field, &value, sizeof(value));
+      break;
+  }
+}
+
+// Storage encoding of NULL of an integral type
+static int64_t GetIntegerNull(ValueType type) {
+  switch (type) {
+    case VALUE_TYPE_TINYINT:
+      return INT8_NULL;
+    case VALUE_TYPE_SMALLINT:
+      return INT16_NULL;
+    case VALUE_TYPE_INTEGER:
+      return INT32_NULL;
+    default:
+      return INT64_NULL;
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile
+//===--------------------------------------------------------------------===//
+
+CompressedTile::CompressedTile(Tile *tile) : Tile(tile) {
+  columns_.resize(column_count);
+
+  for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+    column_offsets_.push_back(schema.GetOffset(column_itr));
+
+    auto &column = columns_[column_itr];
+    CompressColumn(tile, column_itr, column);
+
+    tile_size += column.fields.size() +
+                 column.packed.size() * sizeof(uint64_t) +
+                 column.run_ends.size() * sizeof(oid_t);
+  }
+
+  LOG_TRACE("Compressed tile %u :: %u bytes from %u bytes", tile_id,
+            GetInlinedSize(), tile->GetInlinedSize());
+}
+
+/**
+ * Pick the encoding of the column that takes the least space. Fields are
+ * compared as stored, except for uninlined ones which are compared by the
+ * value they point to.
+ */
+void CompressedTile::CompressColumn(Tile *tile, const oid_t column_id,
+                                    CompressedColumn &column) {
+  const size_t tuple_count = num_tuple_slots;
+  const size_t column_offset = schema.GetOffset(column_id);
+  const size_t column_length = schema.GetAppropriateLength(column_id);
+
+  column.type = schema.GetType(column_id);
+  column.is_inlined = schema.IsInlined(column_id);
+  column.width = schema.GetLength(column_id);
+  column.base = 0;
+  column.bit_width = 0;
+
+  // 1) Key every field, and find the distinct keys and the runs
+  std::vector<std::string> keys(tuple_count);
+  std::unordered_map<std::string, oid_t> codes;
+  std::vector<oid_t> distinct_slots;
+  std::vector<oid_t> codes_of_slots(tuple_count);
+  size_t run_count = 0;
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto &key = keys[tuple_itr];
+    if (column.is_inlined) {
+      key.assign(tile->GetTupleLocation(tuple_itr) + column_offset,
+                 column.width);
+    } else {
+      Value value = tile->GetValue(tuple_itr, column_id);
+      if (value.IsNull() == false) {
+        key.assign(1, 'v');
+        key.append(static_cast<const char *>(
+                       ValuePeeker::PeekObjectValueWithoutNull(value)),
+                   ValuePeeker::PeekObjectLengthWithoutNull(value));
+      }
+    }
+
+    auto code = codes.emplace(key, distinct_slots.size());
+    if (code.second == true) {
+      distinct_slots.push_back(tuple_itr);
+    }
+    codes_of_slots[tuple_itr] = code.first->second;
+
+    if (tuple_itr == 0 || key != keys[tuple_itr - 1]) {
+      run_count++;
+    }
+  }
+
+  // 2) Size of every encoding
+  size_t distinct_count = distinct_slots.size();
+  size_t code_width = GetBitWidth(distinct_count - 1);
+
+  size_t plain_size = tuple_count * column.width;
+  size_t dictionary_size =
+      distinct_count * column.width +
+      GetPackedWordCount(tuple_count, code_width) * sizeof(uint64_t);
+  size_t run_length_size = run_count * (column.width + sizeof(oid_t));
+
+  size_t best_size = plain_size;
+  column.encoding = COLUMN_ENCODING_TYPE_PLAIN;
+
+  if (IsFrameOfReferenceType(column.type)) {
+    int64_t min = INT64_MAX;
+    int64_t max = INT64_MIN;
+    for (auto tuple_itr : distinct_slots) {
+      int64_t value = LoadInteger(keys[tuple_itr].data(), column.width);
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+
+    column.base = min;
+    column.bit_width =
+        GetBitWidth(static_cast<uint64_t>(max) - static_cast<uint64_t>(min));
+    size_t frame_of_reference_size =
+        GetPackedWordCount(tuple_count, column.bit_width) * sizeof(uint64_t);
+
+    if (frame_of_reference_size < best_size) {
+      best_size = frame_of_reference_size;
+      column.encoding = COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE;
+    }
+  }
+
+  if (dictionary_size < best_size) {
+    best_size = dictionary_size;
+    column.encoding = COLUMN_ENCODING_TYPE_DICTIONARY;
+    column.bit_width = code_width;
+  }
+
+  if (run_length_size < best_size) {
+    best_size = run_length_size;
+    column.encoding = COLUMN_ENCODING_TYPE_RUN_LENGTH;
+  }
+
+  // 3) Encode
+  auto append_field = [this, tile, &column, column_id, column_offset,
+                       column_length](oid_t tuple_itr) {
+    if (column.is_inlined) {
+      column.fields.append(tile->GetTupleLocation(tuple_itr) + column_offset,
+                           column.width);
+    } else {
+      // Deep copy, the varlen must outlive the pool of the tile
+      char field[sizeof(uintptr_t)];
+      tile->GetValue(tuple_itr, column_id)
+          .SerializeToTupleStorageAllocateForObjects(field, false,
+                                                     column_length, false,
+                                                     pool);
+      column.fields.append(field, sizeof(field));
+    }
+  };
+
+  switch (column.encoding) {
+    case COLUMN_ENCODING_TYPE_PLAIN:
+      column.fields.reserve(plain_size);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        append_field(tuple_itr);
+      }
+      break;
+
+    case COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE:
+      column.packed.assign(GetPackedWordCount(tuple_count, column.bit_width),
+                           0);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        int64_t value = LoadInteger(keys[tuple_itr].data(), column.width);
+        Pack(column.packed, column.bit_width, tuple_itr,
+             static_cast<uint64_t>(value) - static_cast<uint64_t>(column.base));
+      }
+      break;
+
+    case COLUMN_ENCODING_TYPE_DICTIONARY:
+      column.fields.reserve(distinct_count * column.width);
+      for (auto tuple_itr : distinct_slots) {
+        append_field(tuple_itr);
+      }
+      column.packed.assign(GetPackedWordCount(tuple_count, column.bit_width),
+                           0);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        Pack(column.packed, column.bit_width, tuple_itr,
+             codes_of_slots[tuple_itr]);
+      }
+      break;
+
+    case COLUMN_ENCODING_TYPE_RUN_LENGTH:
+      column.fields.reserve(run_count * column.width);
+      for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+        if (tuple_itr == 0 || keys[tuple_itr] != keys[tuple_itr - 1]) {
+          if (tuple_itr != 0) column.run_ends.push_back(tuple_itr);
+          append_field(tuple_itr);
+        }
+      }
+      column.run_ends.push_back(tuple_count);
+      break;
+  }
+}
+
+const char *CompressedTile::GetField(const CompressedColumn &column,
+                                     const oid_t tuple_offset) const {
+  switch (column.encoding) {
+    case COLUMN_ENCODING_TYPE_DICTIONARY: {
+      auto code = Unpack(column.packed.data(), column.bit_width, tuple_offset);
+      return column.fields.data() + code * column.width;
+    }
+
+    case COLUMN_ENCODING_TYPE_RUN_LENGTH: {
+      auto run = std::upper_bound(column.run_ends.begin(),
+                                  column.run_ends.end(), tuple_offset) -
+                 column.run_ends.begin();
+      return column.fields.data() + run * column.width;
+    }
+
+    default:
+      PL_ASSERT(column.encoding == COLUMN_ENCODING_TYPE_PLAIN);
+      return column.fields.data() + tuple_offset * column.width;
+  }
+}
+
+int64_t CompressedTile::GetInteger(const CompressedColumn &column,
+                                   const oid_t tuple_offset) const {
+  if (column.encoding == COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE) {
+    return static_cast<int64_t>(
+        static_cast<uint64_t>(column.base) +
+        Unpack(column.packed.data(), column.bit_width, tuple_offset));
+  }
+
+  return LoadInteger(GetField(column, tuple_offset), column.width);
+}
+
+Value CompressedTile::GetValue(const oid_t tuple_offset,
+                               const oid_t column_id) {
+  PL_ASSERT(tuple_offset < GetAllocatedTupleCount());
+  PL_ASSERT(column_id < column_count);
+
+  auto &column = columns_[column_id];
+  if (column.encoding == COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE) {
+    char field[sizeof(int64_t)];
+    StoreInteger(GetInteger(column, tuple_offset), column.width, field);
+    return Value::InitFromTupleStorage(field, column.type, true);
+  }
+
+  return Value::InitFromTupleStorage(GetField(column, tuple_offset),
+                                     column.type, column.is_inlined);
+}
+
+Value CompressedTile::GetValueFast(const oid_t tuple_offset,
+                                   const size_t column_offset,
+                                   UNUSED_ATTRIBUTE const ValueType column_type,
+                                   UNUSED_ATTRIBUTE const bool is_inlined) {
+  auto column_id = std::lower_bound(column_offsets_.begin(),
+                                    column_offsets_.end(), column_offset) -
+                   column_offsets_.begin();
+  PL_ASSERT(column_offsets_[column_id] == column_offset);
+
+  return GetValue(tuple_offset, column_id);
+}
+
+bool CompressedTile::GatherIntegers(const oid_t column_id,
+                                    const oid_t *tuple_offsets,
+                                    const size_t count,
+                                    int64_t *values) const {
+  auto &column = columns_[column_id];
+  switch (column.type) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+      break;
+    default:
+      return false;
+  }
+
+  const int64_t null_value = GetIntegerNull(column.type);
+
+  if (column.encoding == COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE) {
+    // Unpack straight into the batch
+    const uint64_t base = static_cast<uint64_t>(column.base);
+    const uint64_t *packed = column.packed.data();
+    const size_t bit_width = column.bit_width;
+
+    for (size_t itr = 0; itr < count; itr++) {
+      int64_t value = static_cast<int64_t>(
+          base + Unpack(packed, bit_width, tuple_offsets[itr]));
+      values[itr] = (value == null_value) ? INT64_NULL : value;
+    }
+    return true;
+  }
+
+  for (size_t itr = 0; itr < count; itr++) {
+    int64_t value = GetInteger(column, tuple_offsets[itr]);
+    values[itr] = (value == null_value) ? INT64_NULL : value;
+  }
+  return true;
+}
+
+bool CompressedTile::GatherDoubles(const oid_t column_id,
+                                   const oid_t *tuple_offsets,
+                                   const size_t count, double *values) const {
+  auto &column = columns_[column_id];
+  if (column.type != VALUE_TYPE_DOUBLE) return false;
+
+  // NULL is any value at or below DOUBLE_NULL, as in a tile
+  for (size_t itr = 0; itr < count; itr++) {
+    std::memcpy(&values[itr], GetField(column, tuple_offsets[itr]),
+                sizeof(double));
+  }
+  return true;
+}
+
+//===--------------------------------------------------------------------===//
+// Utilities
+//===--------------------------------------------------------------------===//
+
+const std::string CompressedTile::GetInfo() const {
+  std::ostringstream os;
+
+  os << "\t-----------------------------------------------------------\n";
+
+  os << "\tCOMPRESSED TILE\n";
+  os << "\tCatalog ::"
+     << " DB: " << database_id << " Table: " << table_id
+     << " Tile Group:  " << tile_group_id << " Tile:  " << tile_id << "\n";
+
+  os << "\tEncodings ::";
+  for (auto &column : columns_) {
+    os << " " << column.encoding;
+  }
+  os << " Size: " << tile_size << "\n";
+
+  os << "\t-----------------------------------------------------------\n";
+
+  return os.str();
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -12,6 +12,7 @@
 
 
 #include <mutex>
+#include <unordered_map>
 #include <utility>
 
 #include "brain/clusterer.h"
@@ -24,6 +25,7 @@
 #include "gc/gc_manager_factory.h"
 #include "index/index.h"
 #include "logging/log_manager.h"
+#include "optimizer/table_write_stats.h"
 #include "storage/tile_group.h"
 #include "storage/tuple.h"
 #include "storage/tile.h"
@@ -45,27 +47,92 @@ int peloton_num_groups;
 
 bool peloton_fsm;
 
+int peloton_active_tile_group_count;
+
+bool peloton_write_stats = true;
+
 namespace peloton {
 namespace storage {
 
+// Threads are spread over the active tile groups by their id
+static std::atomic<size_t> active_tile_group_thread_count(0);
+
+thread_local static size_t active_tile_group_thread_id =
+    active_tile_group_thread_count++;
+
+static std::atomic<size_t> table_instance_count(0);
+
+// Free slots a thread took from the GC, per table instance. Refilled in
+// batches so that inserting threads rarely touch the shared recycle queues.
+struct FreeSlotCache {
+  oid_t table_oid = INVALID_OID;
+  std::vector<ItemPointer> free_slots;
+};
+
+// The slots a thread did not use go back to the GC when it exits
+class FreeSlotCaches {
+ public:
+  ~FreeSlotCaches() {
+    for (auto &entry : caches) {
+      auto &cache = entry.second;
+      if (cache.free_slots.empty() == true) continue;
+      gc::GCManagerFactory::GetInstance().PutBackFreeSlots(cache.table_oid,
+                                                           cache.free_slots);
+    }
+  }
+
+  std::unordered_map<size_t, FreeSlotCache> caches;
+};
+
+thread_local static FreeSlotCaches free_slot_caches;
+
 DataTable::DataTable(catalog::Schema *schema, const std::string &table_name,
                      const oid_t &database_oid, const oid_t &table_oid,
                      const size_t &tuples_per_tilegroup, const bool own_schema,
-                     const bool adapt_table)
+                     const bool adapt_table,
+                     const HeaderLayoutType header_layout)
     : AbstractTable(database_oid, table_oid, table_name, schema, own_schema),
       tuples_per_tilegroup_(tuples_per_tilegroup),
-      adapt_table_(adapt_table) {
+      adapt_table_(adapt_table),
+      header_layout_(header_layout),
+      instance_id_(table_instance_count++) {
   // Init default partition
   auto col_count = schema->GetColumnCount();
   for (oid_t col_itr = 0; col_itr < col_count; col_itr++) {
     default_partition_[col_itr] = std::make_pair(0, col_itr);
   }
 
+  // The optimizer finds the stats through the catalog
+  if (peloton_write_stats) {
+    write_stats_.reset(new optimizer::TableWriteStats(schema));
+    catalog::Manager::GetInstance().AddTableWriteStats(table_oid,
+                                                       write_stats_);
+  }
+
   // Create a tile group.
-  AddDefaultTileGroup();
+  if (peloton_active_tile_group_count <= 0) {
+    AddDefaultTileGroup();
+    return;
+  }
+
+  // Or one for every slot, before any thread needs it
+  active_tile_group_count_ = peloton_active_tile_group_count;
+  active_tile_groups_.resize(active_tile_group_count_);
+  for (size_t active_tile_group_id = 0;
+       active_tile_group_id < active_tile_group_count_;
+       active_tile_group_id++) {
+    AddDefaultTileGroup(active_tile_group_id);
+  }
 }
 
 DataTable::~DataTable() {
+  // Caches of other threads are dropped when those threads exit
+  free_slot_caches.caches.erase(instance_id_);
+
+  if (write_stats_ != nullptr) {
+    catalog::Manager::GetInstance().DropTableWriteStats(table_oid,
+                                                        write_stats_.get());
+  }
 
   // clean up tile groups by dropping the references in the catalog
   oid_t tile_group_count = GetTileGroupCount();
@@ -144,23 +211,44 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple,
 
   //=============== garbage collection==================
   // check if there are recycled tuple slots
-  /*
-  auto &gc_manager = gc::GCManagerFactory::GetInstance();
-  auto free_item_pointer = gc_manager.ReturnFreeSlot(this->table_oid);
-  if (free_item_pointer.IsNull() == false) {
-    return free_item_pointer;
+  if (gc::GCManagerFactory::GetGCType() != GC_TYPE_OFF) {
+    auto free_item_pointer = GetRecycledTupleSlot(tuple);
+    if (free_item_pointer.IsNull() == false) {
+      return free_item_pointer;
+    }
   }
-  */
   //====================================================
 
   std::shared_ptr<storage::TileGroup> tile_group;
   oid_t tuple_slot = INVALID_OID;
   oid_t tile_group_id = INVALID_OID;
 
+  // threads with the same slot share its active tile group
+  size_t active_tile_group_id = INVALID_OID;
+  if (active_tile_group_count_ != 0) {
+    active_tile_group_id =
+        active_tile_group_thread_id % active_tile_group_count_;
+  }
+
   // get valid tuple.
   while (true) {
-    // get the last tile group.
-    tile_group = GetTileGroup(tile_group_count_ - 1);
+    if (active_tile_group_id == INVALID_OID) {
+      // get the last tile group.
+      tile_group = GetTileGroup(tile_group_count_ - 1);
+    } else {
+      // get the active tile group of this thread.
+      tile_group = std::atomic_load(&active_tile_groups_[active_tile_group_id]);
+
+      // the tile groups were dropped by recovery
+      if (tile_group == nullptr) {
+        std::lock_guard<std::mutex> lock(tile_group_mutex_);
+        if (std::atomic_load(&active_tile_groups_[active_tile_group_id]) ==
+            nullptr) {
+          AddDefaultTileGroup(active_tile_group_id);
+        }
+        continue;
+      }
+    }
 
     tuple_slot = tile_group->InsertTuple(tuple);
 
@@ -174,7 +262,11 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple,
   // if this is the last tuple slot we can get
   // then create a new tile group
   if (tuple_slot == tile_group->GetAllocatedTupleCount() - 1) {
-    AddDefaultTileGroup();
+    if (active_tile_group_id == INVALID_OID) {
+      AddDefaultTileGroup();
+    } else {
+      AddDefaultTileGroup(active_tile_group_id);
+    }
   }
 
   LOG_TRACE("tile group count: %lu, tile group id: %u, address: %p",
@@ -187,6 +279,38 @@ ItemPointer DataTable::GetEmptyTupleSlot(const storage::Tuple *tuple,
   return location;
 }
 
+ItemPointer DataTable::GetRecycledTupleSlot(const storage::Tuple *tuple) {
+  auto &cache = free_slot_caches.caches[instance_id_];
+  cache.table_oid = table_oid;
+  auto &free_slots = cache.free_slots;
+
+  if (free_slots.empty() == true) {
+    auto &gc_manager = gc::GCManagerFactory::GetInstance();
+    gc_manager.ReturnFreeSlots(table_oid, free_slots, FREE_SLOT_BATCH_SIZE);
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  while (free_slots.empty() == false) {
+    ItemPointer location = free_slots.back();
+    free_slots.pop_back();
+
+    // Slots put back by an exited thread may be of a dropped table whose
+    // oid was reused
+    auto tile_group = manager.GetTileGroup(location.block);
+    if (tile_group == nullptr || tile_group->GetTableId() != table_oid) {
+      continue;
+    }
+
+    // The GC already reset the header, so only the data is overwritten
+    tile_group->CopyTuple(tuple, location.offset);
+
+    LOG_TRACE("Recycled tuple slot (%u, %u)", location.block, location.offset);
+    return location;
+  }
+
+  return INVALID_ITEMPOINTER;
+}
+
 //===--------------------------------------------------------------------===//
 // INSERT
 //===--------------------------------------------------------------------===//
@@ -207,6 +331,7 @@ ItemPointer DataTable::InsertEmptyVersion(const storage::Tuple *tuple) {
   LOG_TRACE("Location: %u, %u", location.block, location.offset);
 
   IncreaseNumberOfTuplesBy(1);
+  if (write_stats_ != nullptr) write_stats_->DeleteTuple();
   return location;
 }
 
@@ -227,6 +352,7 @@ ItemPointer DataTable::InsertVersion(const storage::Tuple *tuple) {
   LOG_TRACE("Location: %u, %u", location.block, location.offset);
 
   IncreaseNumberOfTuplesBy(1);
+  if (write_stats_ != nullptr) write_stats_->UpdateTuple(tuple);
   return location;
 }
 
@@ -250,6 +376,7 @@ ItemPointer DataTable::InsertTuple(const storage::Tuple *tuple) {
   IncreaseNumberOfTuplesBy(1);
   // Increase the indexes' number of tuples by 1 as well
   for (auto index : indexes_) index->IncreaseNumberOfTuplesBy(1);
+  if (write_stats_ != nullptr) write_stats_->AddTuple(tuple);
   return location;
 }
 
@@ -421,6 +548,10 @@ void DataTable::SetNumberOfTuples(const float &num_tuples) {
  */
 float DataTable::GetNumberOfTuples() const { return number_of_tuples_; }
 
+optimizer::TableWriteStats *DataTable::GetWriteStats() const {
+  return write_stats_.get();
+}
+
 /**
  * @brief return dirty flag
  * @return dirty flag
@@ -461,7 +592,7 @@ TileGroup *DataTable::GetTileGroupWithLayout(
 
   TileGroup *tile_group = TileGroupFactory::GetTileGroup(
       database_oid, table_oid, tile_group_id, this, schemas, partitioning,
-      tuples_per_tilegroup_);
+      tuples_per_tilegroup_, header_layout_);
 
   return tile_group;
 }
@@ -537,6 +668,21 @@ oid_t DataTable::AddDefaultTileGroup() {
   return tile_group_id;
 }
 
+oid_t DataTable::AddDefaultTileGroup(const size_t &active_tile_group_id) {
+  PL_ASSERT(active_tile_group_id < active_tile_group_count_);
+
+  oid_t tile_group_id = AddDefaultTileGroup();
+
+  // threads waiting on the full tile group move on to this one
+  std::atomic_store(&active_tile_groups_[active_tile_group_id],
+                    GetTileGroupById(tile_group_id));
+
+  LOG_TRACE("Tile group %u takes inserts for slot %lu", tile_group_id,
+            active_tile_group_id);
+
+  return tile_group_id;
+}
+
 void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
   PL_ASSERT(tile_group_id);
 
@@ -552,7 +698,7 @@ void DataTable::AddTileGroupWithOidForRecovery(const oid_t &tile_group_id) {
 
   std::shared_ptr<TileGroup> tile_group(TileGroupFactory::GetTileGroup(
       database_oid, table_oid, tile_group_id, this, schemas, column_map,
-      tuples_per_tilegroup_));
+      tuples_per_tilegroup_, header_layout_));
 
   tile_group_lock_.WriteLock();
   if (std::find(tile_groups_.begin(), tile_groups_.end(),
@@ -615,6 +761,9 @@ std::shared_ptr<storage::TileGroup> DataTable::GetTileGroupById(
 
 void DataTable::DropTileGroups() {
   tile_group_count_ = 0;
+  for (auto &active_tile_group : active_tile_groups_) {
+    std::atomic_store(&active_tile_group, std::shared_ptr<TileGroup>());
+  }
   auto &catalog_manager = catalog::Manager::GetInstance();
   for (auto tile_group_id : tile_groups_) {
     // add tile group in catalog
@@ -846,7 +995,8 @@ storage::TileGroup *DataTable::TransformTileGroup(
           tile_group->GetDatabaseId(), tile_group->GetTableId(),
           tile_group->GetTileGroupId(), tile_group->GetAbstractTable(),
           new_schema, default_partition_,
-          tile_group->GetAllocatedTupleCount()));
+          tile_group->GetAllocatedTupleCount(),
+          tile_group->GetHeader()->GetHeaderLayout()));
 
   // Set the transformed tile group column-at-a-time
   SetTransformedTileGroup(tile_group.get(), new_tile_group.get());
@@ -14,6 +14,7 @@
 #include <sstream>
 
 #include "catalog/foreign_key.h"
+#include "catalog/manager.h"
 #include "storage/database.h"
 #include "storage/table_factory.h"
 #include "common/logger.h"
@@ -71,6 +72,8 @@ void Database::DropTableWithOid(const oid_t table_oid) {
     // Drop the table
     tables.erase(tables.begin() + table_offset);
   }
+
+  catalog::Manager::GetInstance().DropTableStats(table_oid);
 }
 
 storage::DataTable *Database::GetTable(const oid_t table_offset) const {
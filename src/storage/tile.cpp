@@ -69,6 +69,30 @@ Tile::Tile(BackendType backend_type, TileGroupHeader *tile_header,
   }
 }
 
+Tile::Tile(const Tile *tile)
+    : database_id(tile->database_id),
+      table_id(tile->table_id),
+      tile_group_id(tile->tile_group_id),
+      tile_id(tile->tile_id),
+      backend_type(tile->backend_type),
+      schema(tile->schema),
+      data(NULL),
+      tile_group(tile->tile_group),
+      pool(NULL),
+      num_tuple_slots(tile->num_tuple_slots),
+      column_count(tile->column_count),
+      tuple_length(tile->tuple_length),
+      tile_size(0),
+      uninlined_data_size(0),
+      column_header(NULL),
+      column_header_size(INVALID_OID),
+      tile_group_header(tile->tile_group_header) {
+  // allocate pool for blob storage if schema not inlined
+  if (schema.IsInlined() == false) {
+    pool = new VarlenPool(backend_type);
+  }
+}
+
 Tile::~Tile() {
   // reclaim the tile memory (INLINED data)
   auto &storage_manager = storage::StorageManager::GetInstance();
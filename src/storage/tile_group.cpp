@@ -20,10 +20,12 @@
 #include "common/logger.h"
 #include "common/types.h"
 #include "storage/abstract_table.h"
+#include "storage/compressed_tile.h"
 #include "storage/tile.h"
 #include "storage/tuple.h"
 #include "storage/tile_group_header.h"
 #include "storage/rollback_segment.h"
+#include "storage/tile_group_compressor.h"
 
 namespace peloton {
 namespace storage {
@@ -40,8 +42,12 @@ TileGroup::TileGroup(BackendType backend_type,
       tile_group_header(tile_group_header),
       table(table),
       num_tuple_slots(tuple_count),
+      tiles_frozen(false),
+      tiles_compressed(false),
+      tile_writer_count(0),
       column_map(column_map) {
   tile_count = tile_schemas.size();
+  tile_locations.reset(new std::atomic<Tile *>[tile_count]);
 
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     auto &manager = catalog::Manager::GetInstance();
@@ -53,6 +59,7 @@ TileGroup::TileGroup(BackendType backend_type,
 
     // Add a reference to the tile in the tile group
     tiles.push_back(tile);
+    tile_locations[tile_itr] = tile.get();
   }
 }
 
@@ -64,8 +71,8 @@ TileGroup::~TileGroup() {
 }
 
 oid_t TileGroup::GetTileId(const oid_t tile_id) const {
-  PL_ASSERT(tiles[tile_id]);
-  return tiles[tile_id]->GetTileId();
+  PL_ASSERT(GetTile(tile_id));
+  return GetTile(tile_id)->GetTileId();
 }
 
 peloton::VarlenPool *TileGroup::GetTilePool(const oid_t tile_id) const {
@@ -100,6 +107,8 @@ void TileGroup::ApplyRollbackSegment(char *rb_seg, const oid_t &tuple_slot_id) {
   auto seg_col_count = storage::RollbackSegmentPool::GetColCount(rb_seg);
   auto table_schema = GetAbstractTable()->GetSchema();
 
+  BeginTileWrite();
+
   for (size_t idx = 0; idx < seg_col_count; ++idx) {
     auto col_id =
         storage::RollbackSegmentPool::GetIdOffsetPair(rb_seg, idx)->col_id;
@@ -124,6 +133,8 @@ void TileGroup::ApplyRollbackSegment(char *rb_seg, const oid_t &tuple_slot_id) {
     auto tile_col_idx = GetTileColumnId(col_id);
     tile_tuple.SetValue(tile_col_idx, col_value, tile->GetPool());
   }
+
+  EndTileWrite();
 }
 
 /**
@@ -138,6 +149,8 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
   oid_t tile_column_count;
   oid_t column_itr = 0;
 
+  BeginTileWrite();
+
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     const catalog::Schema &schema = tile_schemas[tile_itr];
     tile_column_count = schema.GetColumnCount();
@@ -157,6 +170,8 @@ void TileGroup::CopyTuple(const Tuple *tuple, const oid_t &tuple_slot_id) {
       column_itr++;
     }
   }
+
+  EndTileWrite();
 }
 
 // This is commented out before merge
@@ -189,6 +204,8 @@ oid_t TileGroup::InsertTuple(const Tuple *tuple) {
     return INVALID_OID;
   }
 
+  // A tile group is only compressed once all its slots are committed, so
+  // the new slot keeps the tiles plain
   oid_t tile_column_count;
   oid_t column_itr = 0;
 
@@ -247,6 +264,8 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
   oid_t tile_column_count;
   oid_t column_itr = 0;
 
+  BeginTileWrite();
+
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     const catalog::Schema &schema = tile_schemas[tile_itr];
     tile_column_count = schema.GetColumnCount();
@@ -267,6 +286,8 @@ oid_t TileGroup::InsertTupleFromRecovery(cid_t commit_id, oid_t tuple_slot_id,
     }
   }
 
+  EndTileWrite();
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
   tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
@@ -353,6 +374,8 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
   oid_t tile_column_count;
   oid_t column_itr = 0;
 
+  BeginTileWrite();
+
   for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
     const catalog::Schema &schema = tile_schemas[tile_itr];
     tile_column_count = schema.GetColumnCount();
@@ -373,6 +396,8 @@ oid_t TileGroup::InsertTupleFromCheckpoint(oid_t tuple_slot_id,
     }
   }
 
+  EndTileWrite();
+
   // Set MVCC info
   tile_group_header->SetTransactionId(tuple_slot_id, INITIAL_TXN_ID);
   tile_group_header->SetBeginCommitId(tuple_slot_id, commit_id);
@@ -417,14 +442,14 @@ Value TileGroup::GetValue(oid_t tuple_id, oid_t column_id) {
 
 Tile *TileGroup::GetTile(const oid_t tile_offset) const {
   PL_ASSERT(tile_offset < tile_count);
-  Tile *tile = tiles[tile_offset].get();
+  Tile *tile = tile_locations[tile_offset].load();
   return tile;
 }
 
 std::shared_ptr<Tile> TileGroup::GetTileReference(
     const oid_t tile_offset) const {
   PL_ASSERT(tile_offset < tile_count);
-  return tiles[tile_offset];
+  return std::atomic_load(&tiles[tile_offset]);
 }
 
 double TileGroup::GetSchemaDifference(
@@ -449,9 +474,90 @@ double TileGroup::GetSchemaDifference(
 
 void TileGroup::Sync() {
   // Sync the tile group data by syncing all the underlying tiles
-  for (auto tile : tiles) {
-    tile->Sync();
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    GetTileReference(tile_itr)->Sync();
+  }
+}
+
+//===--------------------------------------------------------------------===//
+// Compression
+//===--------------------------------------------------------------------===//
+
+bool TileGroup::CompressTiles(
+    const std::function<bool()> &is_cold,
+    std::vector<std::shared_ptr<Tile>> &retired_tiles) {
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+
+  if (tiles_compressed.load() == true) return false;
+
+  // From here on writers wait on the mutex
+  tiles_frozen = true;
+  if (tile_writer_count.load() != 0 || is_cold() == false) {
+    tiles_frozen = false;
+    return false;
+  }
+
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto tile = GetTileReference(tile_itr);
+    std::shared_ptr<Tile> compressed_tile(new CompressedTile(tile.get()));
+    SetTile(tile_itr, compressed_tile);
+    retired_tiles.push_back(tile);
+  }
+
+  tiles_compressed = true;
+  return true;
+}
+
+void TileGroup::BeginTileWrite() {
+  tile_writer_count++;
+  if (tiles_frozen.load() == false) return;
+
+  // The tiles are compressed, or about to be
+  tile_writer_count--;
+  std::lock_guard<std::mutex> lock(tile_group_mutex);
+  DecompressTiles();
+  tile_writer_count++;
+}
+
+void TileGroup::DecompressTiles() {
+  if (tiles_compressed.load() == false) {
+    tiles_frozen = false;
+    return;
   }
+
+  std::vector<std::shared_ptr<Tile>> retired_tiles;
+  for (oid_t tile_itr = 0; tile_itr < tile_count; tile_itr++) {
+    auto compressed_tile = GetTileReference(tile_itr);
+    auto &schema = tile_schemas[tile_itr];
+
+    std::shared_ptr<Tile> tile(storage::TileFactory::GetTile(
+        backend_type, database_id, table_id, tile_group_id,
+        compressed_tile->GetTileId(), tile_group_header, schema, this,
+        num_tuple_slots));
+
+    oid_t column_count = schema.GetColumnCount();
+    for (oid_t tuple_itr = 0; tuple_itr < num_tuple_slots; tuple_itr++) {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        tile->SetValue(compressed_tile->GetValue(tuple_itr, column_itr),
+                       tuple_itr, column_itr);
+      }
+    }
+
+    SetTile(tile_itr, tile);
+    retired_tiles.push_back(compressed_tile);
+  }
+
+  tiles_compressed = false;
+  tiles_frozen = false;
+
+  TileGroupCompressor::GetInstance().RetireTiles(retired_tiles);
+  LOG_TRACE("Decompressed tile group %u", tile_group_id);
+}
+
+void TileGroup::SetTile(const oid_t tile_offset,
+                        const std::shared_ptr<Tile> &tile) {
+  std::atomic_store(&tiles[tile_offset], tile);
+  tile_locations[tile_offset] = tile.get();
 }
 
 //===--------------------------------------------------------------------===//
@@ -0,0 +1,154 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_compressor.cpp
+//
+// Identification: src/storage/tile_group_compressor.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "storage/tile_group_compressor.h"
+
+#include <chrono>
+
+#include "catalog/manager.h"
+#include "common/logger.h"
+#include "concurrency/epoch_manager.h"
+#include "storage/data_table.h"
+#include "storage/database.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace storage {
+
+TileGroupCompressor &TileGroupCompressor::GetInstance() {
+  static TileGroupCompressor tile_group_compressor;
+  return tile_group_compressor;
+}
+
+TileGroupCompressor::~TileGroupCompressor() { StopCompressor(); }
+
+void TileGroupCompressor::StartCompressor(const int period) {
+  LOG_TRACE("Starting tile group compressor");
+  if (is_running_.exchange(true) == true) {
+    return;
+  }
+  compressor_thread_.reset(
+      new std::thread(&TileGroupCompressor::Running, this, period));
+}
+
+void TileGroupCompressor::StopCompressor() {
+  LOG_TRACE("Stopping tile group compressor");
+  if (is_running_.exchange(false) == false) {
+    return;
+  }
+  compressor_thread_->join();
+  compressor_thread_.reset();
+}
+
+void TileGroupCompressor::Running(const int period) {
+  auto &manager = catalog::Manager::GetInstance();
+
+  while (is_running_.load() == true) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(period));
+
+    size_t compressed_count = 0;
+    oid_t database_count = manager.GetDatabaseCount();
+    for (oid_t database_itr = 0; database_itr < database_count;
+         database_itr++) {
+      auto database = manager.GetDatabase(database_itr);
+      oid_t table_count = database->GetTableCount();
+      for (oid_t table_itr = 0; table_itr < table_count; table_itr++) {
+        compressed_count += CompressTable(database->GetTable(table_itr));
+      }
+    }
+
+    ReleaseRetiredTiles();
+
+    LOG_TRACE("Compressed %lu tile groups", compressed_count);
+  }
+}
+
+size_t TileGroupCompressor::CompressTable(DataTable *table) {
+  size_t compressed_count = 0;
+  std::vector<std::shared_ptr<Tile>> retired_tiles;
+
+  size_t tile_group_count = table->GetTileGroupCount();
+  for (size_t tile_group_itr = 0; tile_group_itr < tile_group_count;
+       tile_group_itr++) {
+    auto tile_group = table->GetTileGroup(tile_group_itr);
+    if (tile_group == nullptr || tile_group->IsCompressed() == true) {
+      continue;
+    }
+
+    // Checked once more once writers are held off
+    if (IsCold(tile_group.get()) == false) continue;
+
+    auto is_cold = [&tile_group] { return IsCold(tile_group.get()); };
+    if (tile_group->CompressTiles(is_cold, retired_tiles) == true) {
+      compressed_count++;
+    }
+  }
+
+  RetireTiles(retired_tiles);
+  compressed_count_ += compressed_count;
+
+  return compressed_count;
+}
+
+bool TileGroupCompressor::IsCold(TileGroup *tile_group) {
+  auto tile_group_header = tile_group->GetHeader();
+  oid_t tuple_count = tile_group->GetAllocatedTupleCount();
+
+  // Slots still to be handed out become new tuples
+  if (tile_group_header->GetCurrentNextTupleSlot() < tuple_count) {
+    return false;
+  }
+
+  cid_t max_dead_cid =
+      concurrency::EpochManagerFactory::GetInstance().GetMaxDeadTxnCid();
+
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    if (tile_group_header->GetTransactionId(tuple_itr) != INITIAL_TXN_ID ||
+        tile_group_header->GetBeginCommitId(tuple_itr) > max_dead_cid ||
+        tile_group_header->GetEndCommitId(tuple_itr) != MAX_CID) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void TileGroupCompressor::RetireTiles(
+    std::vector<std::shared_ptr<Tile>> &tiles) {
+  if (tiles.empty()) return;
+
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  auto epoch = epoch_manager.GetCurrentEpoch();
+
+  std::lock_guard<std::mutex> lock(retired_tiles_mutex_);
+  for (auto &tile : tiles) {
+    retired_tiles_.emplace_back(epoch, std::move(tile));
+  }
+  tiles.clear();
+}
+
+void TileGroupCompressor::ReleaseRetiredTiles() {
+  auto tail_epoch =
+      concurrency::EpochManagerFactory::GetInstance().GetTailEpoch();
+
+  std::lock_guard<std::mutex> lock(retired_tiles_mutex_);
+  while (retired_tiles_.empty() == false &&
+         retired_tiles_.front().first < tail_epoch) {
+    retired_tiles_.pop_front();
+  }
+}
+
+}  // End storage namespace
+}  // End peloton namespace
@@ -30,13 +30,20 @@ namespace peloton {
 namespace storage {
 
 TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
-                                 const int &tuple_count)
+                                 const int &tuple_count,
+                                 const HeaderLayoutType &header_layout)
     : backend_type(backend_type),
+      header_layout(header_layout),
       data(nullptr),
       num_tuple_slots(tuple_count),
       next_tuple_slot(0),
       tile_header_lock() {
-  header_size = num_tuple_slots * header_entry_size;
+  header_size = SetFieldLocations(nullptr);
+
+  // the arrays of the column layout start on a cache line
+  if (header_layout == HEADER_LAYOUT_COLUMN) {
+    header_size += CACHELINE_SIZE;
+  }
 
   // allocate storage space for header
   auto &storage_manager = storage::StorageManager::GetInstance();
@@ -47,6 +54,13 @@ TileGroupHeader::TileGroupHeader(const BackendType &backend_type,
   // zero out the data
   PL_MEMSET(data, 0, header_size);
 
+  char *base = data;
+  if (header_layout == HEADER_LAYOUT_COLUMN) {
+    auto address = reinterpret_cast<uintptr_t>(data);
+    base += (CACHELINE_SIZE - address % CACHELINE_SIZE) % CACHELINE_SIZE;
+  }
+  SetFieldLocations(base);
+
   // Set MVCC Initial Value
   for (oid_t tuple_slot_id = START_OID; tuple_slot_id < num_tuple_slots;
        tuple_slot_id++) {
@@ -69,6 +83,81 @@ TileGroupHeader::~TileGroupHeader() {
   data = nullptr;
 }
 
+size_t TileGroupHeader::SetFieldLocations(char *base) {
+  HeaderField *fields[] = {&txn_id_field,        &begin_cid_field,
+                           &end_cid_field,       &next_pointer_field,
+                           &prev_pointer_field,  &reserved_field,
+                           &insert_commit_field, &delete_commit_field};
+  const size_t field_sizes[] = {sizeof(txn_id_t),    sizeof(cid_t),
+                                sizeof(cid_t),       sizeof(ItemPointer),
+                                sizeof(ItemPointer), reserverd_size,
+                                sizeof(bool),        sizeof(bool)};
+  const size_t field_count = sizeof(field_sizes) / sizeof(field_sizes[0]);
+
+  size_t offset = 0;
+  for (size_t field_itr = 0; field_itr < field_count; field_itr++) {
+    auto field = fields[field_itr];
+
+    if (header_layout == HEADER_LAYOUT_COLUMN) {
+      offset = (offset + CACHELINE_SIZE - 1) / CACHELINE_SIZE * CACHELINE_SIZE;
+    }
+
+    if (base != nullptr) {
+      field->location = base + offset;
+      field->stride = (header_layout == HEADER_LAYOUT_ROW)
+                          ? header_entry_size
+                          : field_sizes[field_itr];
+    }
+
+    if (header_layout == HEADER_LAYOUT_ROW) {
+      offset += field_sizes[field_itr];
+    } else {
+      offset += field_sizes[field_itr] * num_tuple_slots;
+    }
+  }
+
+  if (header_layout == HEADER_LAYOUT_ROW) {
+    return header_entry_size * num_tuple_slots;
+  }
+  return offset;
+}
+
+TileGroupHeader &TileGroupHeader::operator=(
+    const peloton::storage::TileGroupHeader &other) {
+  // check for self-assignment
+  if (&other == this) return *this;
+
+  PL_ASSERT(num_tuple_slots >= other.num_tuple_slots);
+
+  if (header_layout == HEADER_LAYOUT_ROW &&
+      other.header_layout == HEADER_LAYOUT_ROW) {
+    // copy over all the data
+    PL_MEMCPY(data, other.data, other.header_size);
+  } else {
+    // the fields are laid out differently, copy them one at a time
+    for (oid_t tuple_slot_id = START_OID;
+         tuple_slot_id < other.num_tuple_slots; tuple_slot_id++) {
+      SetTransactionId(tuple_slot_id, other.GetTransactionId(tuple_slot_id));
+      SetBeginCommitId(tuple_slot_id, other.GetBeginCommitId(tuple_slot_id));
+      SetEndCommitId(tuple_slot_id, other.GetEndCommitId(tuple_slot_id));
+      SetNextItemPointer(tuple_slot_id,
+                         other.GetNextItemPointer(tuple_slot_id));
+      SetPrevItemPointer(tuple_slot_id,
+                         other.GetPrevItemPointer(tuple_slot_id));
+      PL_MEMCPY(GetReservedFieldRef(tuple_slot_id),
+                other.GetReservedFieldRef(tuple_slot_id), reserverd_size);
+      SetInsertCommit(tuple_slot_id, other.GetInsertCommit(tuple_slot_id));
+      SetDeleteCommit(tuple_slot_id, other.GetDeleteCommit(tuple_slot_id));
+    }
+  }
+
+  num_tuple_slots = other.num_tuple_slots;
+  oid_t val = other.next_tuple_slot;
+  next_tuple_slot = val;
+
+  return *this;
+}
+
 //===--------------------------------------------------------------------===//
 // Tile Group Header
 //===--------------------------------------------------------------------===//
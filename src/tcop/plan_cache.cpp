@@ -0,0 +1,305 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache.cpp
+//
+// Identification: src/tcop/plan_cache.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "tcop/plan_cache.h"
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <unordered_set>
+
+#include "catalog/catalog.h"
+#include "common/logger.h"
+#include "common/value_factory.h"
+#include "planner/abstract_plan.h"
+
+namespace peloton {
+namespace tcop {
+
+// global singleton
+PlanCache &PlanCache::GetInstance(void) {
+  static PlanCache plan_cache;
+  return plan_cache;
+}
+
+PlanCache::PlanCache(size_t shard_size)
+    : hit_count_(0),
+      miss_count_(0),
+      eviction_count_(0),
+      invalidation_count_(0) {
+  for (size_t shard_itr = 0; shard_itr < PLAN_CACHE_SHARD_COUNT; shard_itr++) {
+    shards_.emplace_back(new Shard(shard_size));
+  }
+}
+
+PlanCache::Shard &PlanCache::GetShard(const std::string &normalized_query) {
+  auto hash = std::hash<std::string>()(normalized_query);
+  return *shards_[hash % PLAN_CACHE_SHARD_COUNT];
+}
+
+std::shared_ptr<planner::AbstractPlan> PlanCache::Find(
+    const std::string &normalized_query) {
+  auto &shard = GetShard(normalized_query);
+  std::shared_ptr<CachedPlan> entry;
+
+  {
+    std::lock_guard<std::mutex> lock(shard.shard_mutex);
+    auto cache_itr = shard.cache.find(normalized_query);
+    if (cache_itr != shard.cache.end()) {
+      entry = *cache_itr;
+    }
+  }
+
+  if (entry.get() == nullptr) {
+    miss_count_++;
+    return nullptr;
+  }
+
+  // Built against an older schema, the caller re-plans and overwrites it
+  if (entry->schema_version != catalog::Catalog::GetSchemaVersion()) {
+    invalidation_count_++;
+    miss_count_++;
+    return nullptr;
+  }
+
+  hit_count_++;
+  return entry->plan;
+}
+
+void PlanCache::Insert(const std::string &normalized_query,
+                       const std::shared_ptr<planner::AbstractPlan> &plan) {
+  auto &shard = GetShard(normalized_query);
+  std::shared_ptr<CachedPlan> entry(
+      new CachedPlan(plan, catalog::Catalog::GetSchemaVersion()));
+
+  std::lock_guard<std::mutex> lock(shard.shard_mutex);
+  bool is_new = (shard.cache.find(normalized_query) == shard.cache.end());
+  auto size_before = shard.cache.size();
+
+  shard.cache.insert(std::make_pair(normalized_query, entry));
+
+  // a new key that did not grow the cache pushed out the LRU entry
+  if (is_new && shard.cache.size() == size_before) {
+    eviction_count_++;
+  }
+}
+
+void PlanCache::Clear() {
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->shard_mutex);
+    shard->cache.clear();
+  }
+}
+
+size_t PlanCache::GetSize() {
+  size_t size = 0;
+  for (auto &shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->shard_mutex);
+    size += shard->cache.size();
+  }
+  return size;
+}
+
+//===--------------------------------------------------------------------===//
+// Query Normalization
+//===--------------------------------------------------------------------===//
+
+static inline bool IsIdentifierChar(char c) {
+  return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+static std::string ToUpper(const std::string &word) {
+  std::string upper(word);
+  for (auto &c : upper) c = std::toupper(static_cast<unsigned char>(c));
+  return upper;
+}
+
+// Statements whose plans can be shared
+static const std::unordered_set<std::string> cacheable_statements = {
+    "SELECT", "INSERT", "UPDATE", "DELETE"};
+
+// Type names whose modifiers, e.g. VARCHAR(32), must stay literal
+static const std::unordered_set<std::string> type_names = {
+    "CHAR",  "CHARACTER", "VARCHAR", "NUMERIC",   "DECIMAL", "BIT",
+    "FLOAT", "VARBINARY", "TIME",    "TIMESTAMP", "INTERVAL"};
+
+// Keywords that end an ORDER BY / GROUP BY list
+static const std::unordered_set<std::string> by_list_terminators = {
+    "LIMIT", "OFFSET", "HAVING", "UNION", "INTERSECT", "EXCEPT",
+    "FOR",   "WINDOW", "WHERE",  "FROM"};
+
+static Value GetNumericValue(const std::string &token, bool is_integer) {
+  if (is_integer) {
+    errno = 0;
+    auto value = std::strtoll(token.c_str(), nullptr, 10);
+    if (errno == 0) {
+      if (value >= INT32_MIN && value <= INT32_MAX) {
+        return ValueFactory::GetIntegerValue(static_cast<int32_t>(value));
+      }
+      return ValueFactory::GetBigIntValue(static_cast<int64_t>(value));
+    }
+    return ValueFactory::GetDecimalValueFromString(token);
+  }
+
+  return ValueFactory::GetDoubleValue(std::strtod(token.c_str(), nullptr));
+}
+
+bool PlanCache::NormalizeQuery(const std::string &query,
+                               std::string &normalized_query,
+                               std::vector<Value> &param_values) {
+  normalized_query.clear();
+  param_values.clear();
+
+  std::vector<std::string> paren_words;
+  std::string last_word;
+  bool in_by_list = false;
+  bool first_word = true;
+  size_t pos = 0;
+  size_t len = query.size();
+
+  // append a token, collapsing all the white space to a single blank
+  auto emit_space = [&normalized_query]() {
+    if (!normalized_query.empty() && normalized_query.back() != ' ')
+      normalized_query.push_back(' ');
+  };
+
+  auto emit_param = [&normalized_query, &param_values](Value value) {
+    param_values.push_back(value);
+    normalized_query += "$" + std::to_string(param_values.size());
+  };
+
+  while (pos < len) {
+    char c = query[pos];
+
+    // white space
+    if (std::isspace(static_cast<unsigned char>(c))) {
+      emit_space();
+      pos++;
+    }
+    // line comment
+    else if (c == '-' && pos + 1 < len && query[pos + 1] == '-') {
+      while (pos < len && query[pos] != '\n') pos++;
+      emit_space();
+    }
+    // string literal, '' escapes a quote
+    else if (c == '\'') {
+      std::string literal;
+      pos++;
+      for (;;) {
+        // unterminated literal, let the parser complain
+        if (pos >= len) return false;
+        if (query[pos] == '\'') {
+          if (pos + 1 < len && query[pos + 1] == '\'') {
+            literal.push_back('\'');
+            pos += 2;
+            continue;
+          }
+          pos++;
+          break;
+        }
+        literal.push_back(query[pos++]);
+      }
+      emit_param(ValueFactory::GetStringValue(literal));
+    }
+    // quoted identifier, copied verbatim
+    else if (c == '"') {
+      size_t end = query.find('"', pos + 1);
+      if (end == std::string::npos) return false;
+      normalized_query.append(query, pos, end - pos + 1);
+      pos = end + 1;
+    }
+    // numeric literal
+    else if (std::isdigit(static_cast<unsigned char>(c)) ||
+             (c == '.' && pos + 1 < len &&
+              std::isdigit(static_cast<unsigned char>(query[pos + 1])))) {
+      size_t start = pos;
+      bool is_integer = true;
+      while (pos < len && std::isdigit(static_cast<unsigned char>(query[pos])))
+        pos++;
+      if (pos < len && query[pos] == '.') {
+        is_integer = false;
+        pos++;
+        while (pos < len &&
+               std::isdigit(static_cast<unsigned char>(query[pos])))
+          pos++;
+      }
+      if (pos < len && (query[pos] == 'e' || query[pos] == 'E')) {
+        size_t exp = pos + 1;
+        if (exp < len && (query[exp] == '+' || query[exp] == '-')) exp++;
+        if (exp < len && std::isdigit(static_cast<unsigned char>(query[exp]))) {
+          is_integer = false;
+          pos = exp;
+          while (pos < len &&
+                 std::isdigit(static_cast<unsigned char>(query[pos])))
+            pos++;
+        }
+      }
+
+      std::string token = query.substr(start, pos - start);
+
+      // positional references and type modifiers keep their meaning
+      bool in_type_modifier =
+          !paren_words.empty() && type_names.count(paren_words.back()) != 0;
+      if (in_by_list || in_type_modifier) {
+        normalized_query += token;
+      } else {
+        emit_param(GetNumericValue(token, is_integer));
+      }
+    }
+    // keyword or identifier
+    else if (IsIdentifierChar(c)) {
+      size_t start = pos;
+      while (pos < len && IsIdentifierChar(query[pos])) pos++;
+      std::string word = query.substr(start, pos - start);
+      last_word = ToUpper(word);
+
+      if (first_word) {
+        if (cacheable_statements.count(last_word) == 0) return false;
+        first_word = false;
+      }
+
+      // already carries bind parameters
+      if (word[0] == '$') return false;
+
+      if (last_word == "BY") {
+        in_by_list = true;
+      } else if (by_list_terminators.count(last_word) != 0) {
+        in_by_list = false;
+      }
+
+      normalized_query += word;
+    }
+    // punctuation
+    else {
+      if (c == '(') {
+        paren_words.push_back(last_word);
+      } else if (c == ')') {
+        if (!paren_words.empty()) paren_words.pop_back();
+      }
+      // trailing terminator does not change the plan
+      if (c != ';') normalized_query.push_back(c);
+      last_word.clear();
+      pos++;
+    }
+  }
+
+  // trim the trailing blank
+  if (!normalized_query.empty() && normalized_query.back() == ' ')
+    normalized_query.pop_back();
+
+  return !first_word;
+}
+
+}  // End tcop namespace
+}  // End peloton namespace
@@ -12,6 +12,7 @@
 
 
 #include "tcop/tcop.h"
+#include "tcop/plan_cache.h"
 
 #include "common/macros.h"
 #include "common/portal.h"
@@ -40,7 +41,7 @@ TrafficCop::~TrafficCop() {
 }
 
 Result TrafficCop::ExecuteStatement(const std::string& query,
-                                    std::vector<ResultType> &result,
+                                    const ResultConsumer &result_consumer,
                                     std::vector<FieldInfoType> &tuple_descriptor,
                                     int &rows_changed,
                                     std::string &error_message){
@@ -57,7 +58,7 @@ Result TrafficCop::ExecuteStatement(const std::string& query,
   // Then, execute the statement
   bool unnamed = true;
   auto status = ExecuteStatement(statement, unnamed,
-                                 result, rows_changed, error_message);
+                                 result_consumer, rows_changed, error_message);
 
   if(status == Result::RESULT_SUCCESS) {
 	  LOG_INFO("Execution succeeded!");
@@ -72,14 +73,15 @@ Result TrafficCop::ExecuteStatement(const std::string& query,
 
 Result TrafficCop::ExecuteStatement(UNUSED_ATTRIBUTE const std::shared_ptr<Statement>& statement,
                                     UNUSED_ATTRIBUTE const bool unnamed,
-                                    UNUSED_ATTRIBUTE std::vector<ResultType> &result,
+                                    const ResultConsumer &result_consumer,
                                     UNUSED_ATTRIBUTE int &rows_changed,
                                     UNUSED_ATTRIBUTE std::string &error_message){
 
   LOG_INFO("Execute Statement %s", statement->GetStatementName().c_str());
-  std::vector<Value> params;
+  auto &params = statement->GetParamValues();
   bridge::PlanExecutor::PrintPlan(statement->GetPlanTree().get(), "Shit");
-  bridge::peloton_status status = bridge::PlanExecutor::ExecutePlan(statement->GetPlanTree().get(), params);
+  bridge::peloton_status status = bridge::PlanExecutor::ExecutePlan(
+      statement->GetPlanTree().get(), params, result_consumer);
   LOG_INFO("Statement executed. Result: %d", status.m_result);
   return status.m_result;
 
@@ -94,10 +96,38 @@ std::shared_ptr<Statement> TrafficCop::PrepareStatement(const std::string& state
 
   statement.reset(new Statement(statement_name, query_string));
 
+  // Lift the literals out so that the plan can be shared by all the
+  // sessions running the same query shape
+  std::string normalized_query;
+  std::vector<Value> param_values;
+  auto &plan_cache = PlanCache::GetInstance();
+  bool cacheable = PlanCache::NormalizeQuery(query_string, normalized_query,
+                                             param_values);
+
+  if (cacheable) {
+    auto plan_tree = plan_cache.Find(normalized_query);
+    if (plan_tree.get() != nullptr) {
+      LOG_INFO("Plan cache hit : %s", normalized_query.c_str());
+      statement->SetPlanTree(plan_tree);
+      statement->SetParamValues(param_values);
+      return statement;
+    }
+  }
+
   auto& postgres_parser = parser::PostgresParser::GetInstance();
-  auto parse_tree = postgres_parser.BuildParseTree(query_string);
 
-  statement->SetPlanTree(optimizer::SimpleOptimizer::BuildPlanTree(parse_tree));
+  if (cacheable) {
+    auto parse_tree = postgres_parser.BuildParseTree(normalized_query);
+    auto plan_tree = optimizer::SimpleOptimizer::BuildPlanTree(parse_tree);
+    if (plan_tree.get() != nullptr) {
+      plan_cache.Insert(normalized_query, plan_tree);
+    }
+    statement->SetPlanTree(plan_tree);
+    statement->SetParamValues(param_values);
+  } else {
+    auto parse_tree = postgres_parser.BuildParseTree(query_string);
+    statement->SetPlanTree(optimizer::SimpleOptimizer::BuildPlanTree(parse_tree));
+  }
 
   return statement;
 }
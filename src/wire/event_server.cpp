@@ -0,0 +1,316 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// event_server.cpp
+//
+// Identification: src/wire/event_server.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "wire/event_server.h"
+#include "wire/marshal.h"
+#include "common/macros.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <netinet/tcp.h>
+
+namespace peloton {
+namespace wire {
+
+// max events fetched per epoll_wait call
+#define EVENT_BATCH_SIZE 256
+
+// how often (ms) blocked threads check whether the server is stopping
+#define EVENT_POLL_TIMEOUT 100
+
+static bool SetNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0) return false;
+  return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+EventServer::EventServer(Server *server, size_t io_thread_count,
+                         size_t worker_thread_count, size_t max_in_flight)
+    : server_(server),
+      io_thread_count_(std::max<size_t>(io_thread_count, 1)),
+      worker_thread_count_(std::max<size_t>(worker_thread_count, 1)),
+      max_in_flight_(std::max<size_t>(max_in_flight, 1)),
+      is_running_(false),
+      next_reactor_(0),
+      in_flight_(0),
+      connection_count_(0) {}
+
+EventServer::~EventServer() {
+  Stop();
+
+  for (auto conn : connections_) {
+    conn->sock.CloseSocket();
+    delete conn;
+  }
+  connections_.clear();
+
+  for (auto epoll_fd : epoll_fds_) {
+    close(epoll_fd);
+  }
+}
+
+void EventServer::Stop() {
+  is_running_ = false;
+
+  ready_queue_cv_.notify_all();
+}
+
+/*
+ * Run - Starts the reactors and the workers, then accepts connections on
+ * the listening socket till the server is stopped.
+ */
+void EventServer::Run() {
+  is_running_ = true;
+
+  for (size_t reactor_itr = 0; reactor_itr < io_thread_count_; reactor_itr++) {
+    int epoll_fd = epoll_create1(0);
+    if (epoll_fd < 0) {
+      LOG_ERROR("Server error: could not create epoll instance");
+      exit(EXIT_FAILURE);
+    }
+    epoll_fds_.push_back(epoll_fd);
+  }
+
+  for (size_t reactor_itr = 0; reactor_itr < io_thread_count_; reactor_itr++) {
+    reactor_threads_.push_back(
+        std::thread(&EventServer::ReactorLoop, this, reactor_itr));
+  }
+
+  for (size_t worker_itr = 0; worker_itr < worker_thread_count_;
+       worker_itr++) {
+    worker_threads_.push_back(std::thread(&EventServer::WorkerLoop, this));
+  }
+
+  LOG_INFO("Event server : %lu io threads, %lu workers, %lu max in flight",
+           io_thread_count_, worker_thread_count_, max_in_flight_);
+
+  struct pollfd listen_pfd;
+  listen_pfd.fd = server_->server_fd;
+  listen_pfd.events = POLLIN;
+
+  while (is_running_) {
+    listen_pfd.revents = 0;
+    int ret = poll(&listen_pfd, 1, EVENT_POLL_TIMEOUT);
+    if (ret <= 0) continue;
+
+    int connfd = accept(server_->server_fd, NULL, NULL);
+    if (connfd < 0) {
+      if (errno == EINTR || errno == EAGAIN || errno == ECONNABORTED) continue;
+      LOG_ERROR("Server error: Connection not established");
+      continue;
+    }
+
+    AddConnection(connfd);
+  }
+
+  for (auto &reactor_thread : reactor_threads_) reactor_thread.join();
+  for (auto &worker_thread : worker_threads_) worker_thread.join();
+  reactor_threads_.clear();
+  worker_threads_.clear();
+}
+
+void EventServer::AddConnection(int sock_fd) {
+  if (!SetNonBlocking(sock_fd)) {
+    LOG_ERROR("Server error: could not make socket non-blocking");
+    close(sock_fd);
+    return;
+  }
+
+  // responses are batched by the socket manager, no need for Nagle
+  int yes = 1;
+  setsockopt(sock_fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+  int epoll_fd = epoll_fds_[next_reactor_];
+  next_reactor_ = (next_reactor_ + 1) % io_thread_count_;
+
+  auto conn = new EventConnection(sock_fd, epoll_fd);
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    connections_.insert(conn);
+  }
+  connection_count_++;
+
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = conn;
+  if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock_fd, &event) < 0) {
+    LOG_ERROR("Server error: could not register client fd %d", sock_fd);
+    CloseConnection(conn);
+  }
+}
+
+void EventServer::ArmConnection(EventConnection *conn) {
+  struct epoll_event event;
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = conn;
+  if (epoll_ctl(conn->epoll_fd, EPOLL_CTL_MOD, conn->sock_fd, &event) < 0) {
+    LOG_ERROR("Server error: could not re-arm client fd %d", conn->sock_fd);
+    CloseConnection(conn);
+  }
+}
+
+void EventServer::CloseConnection(EventConnection *conn) {
+  epoll_ctl(conn->epoll_fd, EPOLL_CTL_DEL, conn->sock_fd, NULL);
+  conn->sock.CloseSocket();
+
+  {
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    connections_.erase(conn);
+  }
+  connection_count_--;
+
+  delete conn;
+}
+
+bool EventServer::ReadConnection(EventConnection *conn) {
+  uchar chunk[SOCKET_BUFFER_SIZE];
+  bool alive = true;
+
+  for (;;) {
+    ssize_t bytes_read = read(conn->sock_fd, chunk, SOCKET_BUFFER_SIZE);
+    if (bytes_read > 0) {
+      conn->rbuf.insert(std::end(conn->rbuf), chunk, chunk + bytes_read);
+      continue;
+    }
+
+    if (bytes_read < 0) {
+      // interrupts are OK
+      if (errno == EINTR) continue;
+      // drained the socket
+      if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+      LOG_ERROR("Socket error: could not receive data from client");
+    }
+
+    // EOF or fatal error
+    alive = false;
+    break;
+  }
+
+  // cut the stream into packets
+  for (;;) {
+    std::unique_ptr<Packet> pkt(new Packet());
+    auto result = ParsePacket(conn->rbuf, conn->rbuf_ptr, pkt.get(),
+                              conn->startup_parsed);
+    if (result == PARSE_RESULT_MALFORMED) {
+      // the stream cannot be resynchronized, close after the parsed packets
+      alive = false;
+      break;
+    }
+    if (result == PARSE_RESULT_PARTIAL) break;
+    conn->startup_parsed = true;
+    conn->packets.push_back(std::move(pkt));
+  }
+
+  // drop the consumed prefix of the read buffer
+  conn->rbuf.erase(std::begin(conn->rbuf),
+                   std::begin(conn->rbuf) + conn->rbuf_ptr);
+  conn->rbuf_ptr = 0;
+
+  return alive;
+}
+
+void EventServer::SubmitConnection(EventConnection *conn) {
+  std::lock_guard<std::mutex> lock(ready_queue_mutex_);
+
+  // the workers are saturated, park the connection instead of stalling the
+  // reactor. It is not re-armed, so it reads nothing more till it is admitted.
+  if (in_flight_.load() >= max_in_flight_) {
+    parked_queue_.push_back(conn);
+    return;
+  }
+
+  in_flight_++;
+  ready_queue_.push_back(conn);
+  ready_queue_cv_.notify_one();
+}
+
+void EventServer::ReactorLoop(size_t reactor_id) {
+  int epoll_fd = epoll_fds_[reactor_id];
+  struct epoll_event events[EVENT_BATCH_SIZE];
+
+  while (is_running_) {
+    int event_count =
+        epoll_wait(epoll_fd, events, EVENT_BATCH_SIZE, EVENT_POLL_TIMEOUT);
+    if (event_count < 0) {
+      if (errno == EINTR) continue;
+      LOG_ERROR("Server error: epoll_wait failed on reactor %lu", reactor_id);
+      break;
+    }
+
+    for (int event_itr = 0; event_itr < event_count; event_itr++) {
+      auto conn =
+          static_cast<EventConnection *>(events[event_itr].data.ptr);
+
+      if (!ReadConnection(conn)) conn->closed = true;
+
+      if (!conn->packets.empty()) {
+        SubmitConnection(conn);
+      } else if (conn->closed) {
+        CloseConnection(conn);
+      } else {
+        // partial packet, wait for more bytes
+        ArmConnection(conn);
+      }
+    }
+  }
+}
+
+void EventServer::ProcessConnection(EventConnection *conn) {
+  bool status = true;
+
+  while (status && !conn->packets.empty()) {
+    std::unique_ptr<Packet> pkt = std::move(conn->packets.front());
+    conn->packets.pop_front();
+
+    status = conn->manager.HandlePacket(pkt.get(), !conn->startup_processed);
+    conn->startup_processed = true;
+  }
+
+  if (!status || conn->closed) {
+    CloseConnection(conn);
+  } else {
+    ArmConnection(conn);
+  }
+}
+
+void EventServer::WorkerLoop() {
+  for (;;) {
+    EventConnection *conn = nullptr;
+
+    {
+      std::unique_lock<std::mutex> lock(ready_queue_mutex_);
+      ready_queue_cv_.wait(
+          lock, [this] { return !is_running_ || !ready_queue_.empty(); });
+      if (ready_queue_.empty()) return;
+      conn = ready_queue_.front();
+      ready_queue_.pop_front();
+    }
+
+    ProcessConnection(conn);
+
+    {
+      std::lock_guard<std::mutex> lock(ready_queue_mutex_);
+      // hand the slot over to a parked connection
+      if (parked_queue_.empty()) {
+        in_flight_--;
+      } else {
+        ready_queue_.push_back(parked_queue_.front());
+        parked_queue_.pop_front();
+      }
+    }
+  }
+}
+
+}  // End wire namespace
+}  // End peloton namespace
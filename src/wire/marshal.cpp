@@ -17,6 +17,12 @@
 
 #include "wire/marshal.h"
 
+#include "catalog/schema.h"
+#include "common/value.h"
+#include "common/value_peeker.h"
+#include "executor/logical_tile.h"
+#include "storage/tile.h"
+
 #include <netinet/in.h>
 
 namespace peloton {
@@ -156,6 +162,159 @@ void PacketPutCbytes(std::unique_ptr<Packet> &pkt, const uchar *b, int len) {
   pkt->len += len;
 }
 
+/* Write a field, its length first. A null field has length -1 */
+static void PacketPutField(std::unique_ptr<Packet> &pkt, const char *data,
+                           int len) {
+  PacketPutInt(pkt, len, 4);
+  if (len > 0) {
+    PacketPutCbytes(pkt, reinterpret_cast<const uchar *>(data), len);
+  }
+}
+
+/* Write the text of an integer, the same text Value::CastAsString gives */
+static void PacketPutIntegerField(std::unique_ptr<Packet> &pkt, int64_t n,
+                                  bool is_null) {
+  if (is_null) {
+    PacketPutField(pkt, nullptr, -1);
+    return;
+  }
+
+  // Digits are written back to front
+  char text[24];
+  char *text_end = text + sizeof(text);
+  char *text_begin = text_end;
+  uint64_t magnitude = (n < 0) ? 0 - static_cast<uint64_t>(n) : n;
+  do {
+    *--text_begin = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+  if (n < 0) {
+    *--text_begin = '-';
+  }
+
+  PacketPutField(pkt, text_begin, text_end - text_begin);
+}
+
+/* Write a value as text */
+static void PacketPutValueField(std::unique_ptr<Packet> &pkt,
+                                const Value &value) {
+  if (value.IsNull()) {
+    PacketPutField(pkt, nullptr, -1);
+    return;
+  }
+
+  switch (value.GetValueType()) {
+    case VALUE_TYPE_TINYINT:
+    case VALUE_TYPE_SMALLINT:
+    case VALUE_TYPE_INTEGER:
+    case VALUE_TYPE_BIGINT:
+      PacketPutIntegerField(pkt, ValuePeeker::PeekAsBigInt(value), false);
+      break;
+
+    case VALUE_TYPE_VARCHAR:
+    case VALUE_TYPE_VARBINARY:
+      PacketPutField(pkt, static_cast<const char *>(
+                              ValuePeeker::PeekObjectValueWithoutNull(value)),
+                     ValuePeeker::PeekObjectLengthWithoutNull(value));
+      break;
+
+    default: {
+      // The other types are formatted by the value itself
+      auto text = value.CastAs(VALUE_TYPE_VARCHAR);
+      PacketPutField(pkt, static_cast<const char *>(
+                              ValuePeeker::PeekObjectValueWithoutNull(text)),
+                     ValuePeeker::PeekObjectLengthWithoutNull(text));
+    } break;
+  }
+}
+
+/* Write a field of a base tile tuple as text */
+static void PacketPutTileField(std::unique_ptr<Packet> &pkt,
+                               storage::Tile *base_tile, oid_t base_tuple_id,
+                               oid_t column_id) {
+  // Outer joins pad with null tuples
+  if (base_tuple_id == NULL_OID) {
+    PacketPutField(pkt, nullptr, -1);
+    return;
+  }
+
+  // Compressed tiles have no fields to read in place
+  if (base_tile->IsCompressed()) {
+    PacketPutValueField(pkt, base_tile->GetValue(base_tuple_id, column_id));
+    return;
+  }
+
+  auto schema = base_tile->GetSchema();
+  auto column_type = schema->GetType(column_id);
+  const char *field_location = base_tile->GetTupleLocation(base_tuple_id) +
+                               schema->GetOffset(column_id);
+
+  switch (column_type) {
+    case VALUE_TYPE_TINYINT: {
+      auto n = *reinterpret_cast<const int8_t *>(field_location);
+      PacketPutIntegerField(pkt, n, n == INT8_NULL);
+    } break;
+
+    case VALUE_TYPE_SMALLINT: {
+      auto n = *reinterpret_cast<const int16_t *>(field_location);
+      PacketPutIntegerField(pkt, n, n == INT16_NULL);
+    } break;
+
+    case VALUE_TYPE_INTEGER: {
+      auto n = *reinterpret_cast<const int32_t *>(field_location);
+      PacketPutIntegerField(pkt, n, n == INT32_NULL);
+    } break;
+
+    case VALUE_TYPE_BIGINT: {
+      auto n = *reinterpret_cast<const int64_t *>(field_location);
+      PacketPutIntegerField(pkt, n, n == INT64_NULL);
+    } break;
+
+    default:
+      // The value only points to the bytes in the tile
+      PacketPutValueField(
+          pkt, Value::InitFromTupleStorage(field_location, column_type,
+                                           schema->IsInlined(column_id)));
+      break;
+  }
+}
+
+size_t PacketPutDataRows(executor::LogicalTile *result_tile,
+                         ResponseBuffer &responses) {
+  auto column_count = result_tile->GetColumnCount();
+  auto &position_lists = result_tile->GetPositionLists();
+
+  size_t row_count = 0;
+  for (oid_t tuple_id : *result_tile) {
+    std::unique_ptr<Packet> pkt(new Packet());
+    pkt->msg_type = 'D';
+    PacketPutInt(pkt, column_count, 2);
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto &column_info = result_tile->GetColumnInfo(column_itr);
+      PacketPutTileField(
+          pkt, column_info.base_tile.get(),
+          position_lists[column_info.position_list_idx][tuple_id],
+          column_info.origin_column_id);
+    }
+    responses.push_back(std::move(pkt));
+    row_count++;
+  }
+
+  return row_count;
+}
+
+/*
+ * A length below the size of the length field itself would underflow into
+ * a huge read
+ */
+static bool IsValidPacketSize(uint32_t pkt_size) {
+  if (pkt_size < sizeof(int32_t) || pkt_size > MAX_PACKET_SIZE) {
+    LOG_ERROR("Protocol error: invalid packet length %u", pkt_size);
+    return false;
+  }
+  return true;
+}
+
 /*
  * read_packet - Tries to read a single packet, returns true on success,
  * 		false on failure. Accepts pointer to an empty packet, and if the
@@ -196,7 +355,9 @@ bool ReadPacket(Packet *pkt, bool has_type_field, Client *client) {
   }
 
   // packet size includes initial bytes read as well
-  pkt_size = ntohl(pkt_size) - sizeof(int32_t);
+  pkt_size = ntohl(pkt_size);
+  if (!IsValidPacketSize(pkt_size)) return false;
+  pkt_size -= sizeof(int32_t);
 
   if (!client->sock->ReadBytes(pkt->buf, static_cast<size_t>(pkt_size))) {
     // nothing more to read
@@ -208,6 +369,44 @@ bool ReadPacket(Packet *pkt, bool has_type_field, Client *client) {
   return true;
 }
 
+ParseResult ParsePacket(const PktBuf &rbuf, size_t &rbuf_ptr, Packet *pkt,
+                        bool has_type_field) {
+  uint32_t pkt_size = 0;
+  size_t initial_read_size = sizeof(int32_t);
+
+  if (has_type_field)
+    // need to read type character as well
+    initial_read_size++;
+
+  // header not fully received yet
+  if (rbuf.size() - rbuf_ptr < initial_read_size) return PARSE_RESULT_PARTIAL;
+
+  auto header = std::begin(rbuf) + rbuf_ptr;
+  if (has_type_field) header++;
+
+  std::copy(header, header + sizeof(int32_t),
+            reinterpret_cast<uchar *>(&pkt_size));
+
+  // packet size includes the size field as well
+  pkt_size = ntohl(pkt_size);
+  if (!IsValidPacketSize(pkt_size)) return PARSE_RESULT_MALFORMED;
+  pkt_size -= sizeof(int32_t);
+
+  // body not fully received yet
+  if (rbuf.size() - rbuf_ptr - initial_read_size < pkt_size) {
+    return PARSE_RESULT_PARTIAL;
+  }
+
+  if (has_type_field) pkt->msg_type = rbuf[rbuf_ptr];
+
+  auto body = std::begin(rbuf) + rbuf_ptr + initial_read_size;
+  pkt->buf.insert(std::end(pkt->buf), body, body + pkt_size);
+  pkt->len = pkt_size;
+
+  rbuf_ptr += initial_read_size + pkt_size;
+  return PARSE_RESULT_COMPLETE;
+}
+
 bool WritePackets(std::vector<std::unique_ptr<Packet>> &packets,
                   Client *client) {
   // iterate through all the packets
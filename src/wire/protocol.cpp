@@ -12,6 +12,7 @@
 
 
 #include <cstdio>
+#include <iterator>
 #include <unordered_map>
 
 #include "common/cache.h"
@@ -29,12 +30,6 @@
 namespace peloton {
 namespace wire {
 
-// Prepares statment cache
-thread_local peloton::Cache<std::string, Statement> statement_cache_;
-
-// Query portal handler
-thread_local std::unordered_map<std::string, std::shared_ptr<Portal>> portals_;
-
 // Hardcoded authentication strings used during session startup. To be removed
 const std::unordered_map<std::string, std::string>
     PacketManager::parameter_status_map =
@@ -145,28 +140,16 @@ void PacketManager::PutTupleDescriptor(
   responses.push_back(std::move(pkt));
 }
 
-void PacketManager::SendDataRows(std::vector<ResultType> &results, int colcount,
+void PacketManager::SendDataRows(ResponseBuffer &data_rows, size_t row_count,
                                  int &rows_affected,
                                  ResponseBuffer &responses) {
-  if (!results.size() || !colcount) return;
-
-  LOG_INFO("Flatten result size: %lu", results.size());
-  size_t numrows = results.size() / colcount;
-
-  // 1 packet per row
-  for (size_t i = 0; i < numrows; i++) {
-    std::unique_ptr<Packet> pkt(new Packet());
-    pkt->msg_type = 'D';
-    PacketPutInt(pkt, colcount, 2);
-    for (int j = 0; j < colcount; j++) {
-      // length of the row attribute
-      PacketPutInt(pkt, results[i * colcount + j].second.size(), 4);
-      // contents of the row attribute
-      PacketPutBytes(pkt, results[i * colcount + j].second);
-    }
-    responses.push_back(std::move(pkt));
-  }
-  rows_affected = numrows;
+  if (data_rows.empty()) return;
+
+  LOG_INFO("Result rows: %lu", row_count);
+  std::move(data_rows.begin(), data_rows.end(), std::back_inserter(responses));
+  data_rows.clear();
+
+  rows_affected = row_count;
   LOG_INFO("Rows affected: %d", rows_affected);
 }
 
@@ -251,14 +234,22 @@ void PacketManager::ExecQueryMessage(Packet *pkt, ResponseBuffer &responses) {
       return;
     }
 
-    std::vector<ResultType> result;
     std::vector<FieldInfoType> tuple_descriptor;
     std::string error_message;
-    int rows_affected;
+    int rows_affected = 0;
 
-    // execute the query in Sqlite
-    auto status = tcop.ExecuteStatement(query, result, tuple_descriptor,
-                                        rows_affected, error_message);
+    // encode the result rows while the query runs
+    ResponseBuffer data_rows;
+    size_t row_count = 0;
+    auto result_consumer = [&data_rows, &row_count](
+        executor::LogicalTile *result_tile) {
+      row_count += PacketPutDataRows(result_tile, data_rows);
+    };
+
+    // execute the query
+    auto status = tcop.ExecuteStatement(query, result_consumer,
+                                        tuple_descriptor, rows_affected,
+                                        error_message);
 
     // check status
     if (status == Result::RESULT_FAILURE) {
@@ -271,7 +262,7 @@ void PacketManager::ExecQueryMessage(Packet *pkt, ResponseBuffer &responses) {
     PutTupleDescriptor(tuple_descriptor, responses);
 
     // send the result rows
-    SendDataRows(result, tuple_descriptor.size(), rows_affected, responses);
+    SendDataRows(data_rows, row_count, rows_affected, responses);
 
     // TODO: should change to query_type
     CompleteCommand(query, rows_affected, responses);
@@ -540,7 +531,6 @@ void PacketManager::ExecDescribeMessage(Packet *pkt,
 void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
   // EXECUTE message
   LOG_INFO("EXECUTE message");
-  std::vector<ResultType> results;
   std::string error_message, portal_name;
   int rows_affected = 0;
   GetStringToken(pkt, portal_name);
@@ -585,7 +575,13 @@ void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
   }
 
   auto &tcop = tcop::TrafficCop::GetInstance();
-  auto status = tcop.ExecuteStatement(statement, unnamed, results,
+  ResponseBuffer data_rows;
+  size_t row_count = 0;
+  auto result_consumer = [&data_rows, &row_count](
+      executor::LogicalTile *result_tile) {
+    row_count += PacketPutDataRows(result_tile, data_rows);
+  };
+  auto status = tcop.ExecuteStatement(statement, unnamed, result_consumer,
                                       rows_affected, error_message);
 
   if (status == Result::RESULT_FAILURE) {
@@ -600,8 +596,7 @@ void PacketManager::ExecExecuteMessage(Packet *pkt, ResponseBuffer &responses) {
   }
 
   // put_row_desc(portal->rowdesc, responses);
-  auto tuple_descriptor = statement->GetTupleDescriptor();
-  SendDataRows(results, tuple_descriptor.size(), rows_affected, responses);
+  SendDataRows(data_rows, row_count, rows_affected, responses);
   CompleteCommand(query_type, rows_affected, responses);
 }
 
@@ -708,5 +703,19 @@ void PacketManager::ManagePackets() {
   }
 }
 
+bool PacketManager::HandlePacket(Packet *pkt, bool is_startup) {
+  ResponseBuffer responses;
+  bool status;
+
+  if (is_startup) {
+    status = ProcessStartupPacket(pkt, responses);
+  } else {
+    status = ProcessPacket(pkt, responses);
+  }
+
+  // close client on write failure or status failure
+  return WritePackets(responses, &client) && status;
+}
+
 }  // End wire namespace
 }  // End peloton namespace
@@ -15,6 +15,7 @@
 #include "common/exception.h"
 
 #include <sys/un.h>
+#include <poll.h>
 #include <string>
 
 DECLARE_string(socket_family);
@@ -159,12 +160,28 @@ bool SocketManager<B>::FlushWriteBuffer() {
   ssize_t written_bytes = 0;
   wbuf.buf_ptr = 0;
   // still outstanding bytes
-  while (wbuf.buf_size - written_bytes > 0) {
+  while (wbuf.buf_size > 0) {
     written_bytes = write(sock_fd, &wbuf.buf[wbuf.buf_ptr], wbuf.buf_size);
     if (written_bytes < 0) {
       if (errno == EINTR) {
         // interrupts are ok, try again
         continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        // non-blocking socket (event server) is full, wait till it drains.
+        // A client that stops reading must not pin the worker forever.
+        struct pollfd pfd;
+        pfd.fd = sock_fd;
+        pfd.events = POLLOUT;
+        pfd.revents = 0;
+        int ready = poll(&pfd, 1, SOCKET_WRITE_TIMEOUT);
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0 || (pfd.revents & (POLLERR | POLLHUP | POLLNVAL))) {
+          LOG_ERROR("Socket error: client did not drain its socket");
+          // the owner closes the fd once the failed write reaches it
+          shutdown(sock_fd, SHUT_RDWR);
+          return false;
+        }
+        continue;
       } else {
         // fatal errors
         return false;
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// epoch_manager_test.cpp
+//
+// Identification: test/concurrency/epoch_manager_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/harness.h"
+#include "concurrency/epoch_manager.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Epoch Manager Tests
+//===--------------------------------------------------------------------===//
+
+class EpochManagerTest : public PelotonTest {};
+
+static void WaitForEpochs(concurrency::EpochManager &epoch_manager) {
+  std::this_thread::sleep_for(
+      std::chrono::milliseconds(4 * epoch_manager.GetEpochLength()));
+}
+
+TEST_F(EpochManagerTest, RunningTxnHoldsTailTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.SetEpochLength(5);
+  epoch_manager.Reset();
+
+  // A running txn keeps its epoch and every later begin cid alive
+  auto epoch = epoch_manager.EnterEpoch(10);
+
+  // Nested registrations of the same thread do not move the outer one
+  auto nested_epoch = epoch_manager.EnterEpoch(0);
+  WaitForEpochs(epoch_manager);
+  epoch_manager.ExitEpoch(nested_epoch);
+
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < 4; thread_itr++) {
+    threads.emplace_back([&epoch_manager, thread_itr] {
+      for (cid_t txn_itr = 0; txn_itr < 1000; txn_itr++) {
+        auto txn_epoch =
+            epoch_manager.EnterEpoch(100 + thread_itr * 1000 + txn_itr);
+        epoch_manager.ExitEpoch(txn_epoch);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  WaitForEpochs(epoch_manager);
+  EXPECT_LT(epoch, epoch_manager.GetCurrentEpoch());
+  EXPECT_EQ(epoch, epoch_manager.GetTailEpoch());
+  EXPECT_EQ(9, (int)epoch_manager.GetMaxDeadTxnCid());
+
+  // Once it exits, everything up to the largest begin cid is dead
+  epoch_manager.ExitEpoch(epoch);
+  WaitForEpochs(epoch_manager);
+  EXPECT_LT(epoch, epoch_manager.GetTailEpoch());
+  EXPECT_EQ(4099, (int)epoch_manager.GetMaxDeadTxnCid());
+
+  epoch_manager.SetEpochLength(EPOCH_LENGTH);
+}
+
+TEST_F(EpochManagerTest, StaleBeginCidTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+  epoch_manager.SetEpochLength(5);
+  epoch_manager.Reset();
+
+  auto epoch = epoch_manager.EnterEpoch(1000);
+  epoch_manager.ExitEpoch(epoch);
+  WaitForEpochs(epoch_manager);
+  EXPECT_EQ(1000, (int)epoch_manager.GetMaxDeadTxnCid());
+
+  // A begin cid the max dead txn cid has passed is replaced
+  std::vector<cid_t> begin_cids = {500, 2000};
+  size_t cid_itr = 0;
+  cid_t begin_cid;
+  epoch = epoch_manager.EnterEpoch([&] { return begin_cids[cid_itr++]; },
+                                   begin_cid);
+  EXPECT_EQ(2, (int)cid_itr);
+  EXPECT_EQ(2000, (int)begin_cid);
+
+  // Which then holds back the max dead txn cid
+  WaitForEpochs(epoch_manager);
+  EXPECT_EQ(1999, (int)epoch_manager.GetMaxDeadTxnCid());
+  epoch_manager.ExitEpoch(epoch);
+  WaitForEpochs(epoch_manager);
+  EXPECT_EQ(2000, (int)epoch_manager.GetMaxDeadTxnCid());
+
+  epoch_manager.SetEpochLength(EPOCH_LENGTH);
+}
+
+TEST_F(EpochManagerTest, SlotExhaustionTest) {
+  auto &epoch_manager = concurrency::EpochManagerFactory::GetInstance();
+
+  // Every thread holds its slot until it exits, one thread too many fails
+  // instead of waiting forever
+  const int thread_count = MAX_EPOCH_THREAD_COUNT + 1;
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  int registered_count = 0, failed_count = 0;
+
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.emplace_back([&] {
+      bool registered = true;
+      try {
+        epoch_manager.ExitEpoch(epoch_manager.EnterEpoch(0));
+      } catch (TransactionException &) {
+        registered = false;
+      }
+
+      std::unique_lock<std::mutex> lock(mutex);
+      registered ? registered_count++ : failed_count++;
+      cv.notify_all();
+      cv.wait(lock, [&] { return done; });
+    });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock,
+            [&] { return registered_count + failed_count == thread_count; });
+    done = true;
+    cv.notify_all();
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_GE(MAX_EPOCH_THREAD_COUNT, registered_count);
+  EXPECT_LE(1, failed_count);
+
+  // The slots are free again once the threads exit
+  std::thread([&] {
+    EXPECT_NO_THROW(epoch_manager.ExitEpoch(epoch_manager.EnterEpoch(0)));
+  }).join();
+}
+
+}  // End test namespace
+}  // End peloton namespace
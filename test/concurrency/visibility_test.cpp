@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// visibility_test.cpp
+//
+// Identification: test/concurrency/visibility_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "common/harness.h"
+
+#include "concurrency/transaction_manager_factory.h"
+#include "storage/tile_group_header.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Visibility Tests
+//===--------------------------------------------------------------------===//
+
+class VisibilityTests : public PelotonTest {};
+
+namespace {
+
+// Spans several bitmap words and ends in the middle of one
+const int tuple_count = 150;
+
+const int case_count = 8;
+
+bool IsSet(const concurrency::VisibilityBitmap &bitmap, oid_t tuple_id) {
+  return (bitmap[tuple_id / 64] & (uint64_t(1) << (tuple_id % 64))) != 0;
+}
+
+// Cycle through the kinds of versions a transaction may run into
+void FillHeader(storage::TileGroupHeader &header,
+                concurrency::Transaction *txn) {
+  cid_t begin_cid = txn->GetBeginCommitId();
+  txn_id_t txn_id = txn->GetTransactionId();
+
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    header.GetNextEmptyTupleSlot();
+
+    txn_id_t tuple_txn_id = INITIAL_TXN_ID;
+    cid_t tuple_begin_cid = begin_cid - 1;
+    cid_t tuple_end_cid = MAX_CID;
+
+    switch (tuple_slot_id % case_count) {
+      case 0:
+        // empty slot
+        tuple_txn_id = INVALID_TXN_ID;
+        break;
+      case 1:
+        // committed before the transaction began
+        break;
+      case 2:
+        // committed after the transaction began
+        tuple_begin_cid = begin_cid + 1;
+        break;
+      case 3:
+        // deleted before the transaction began
+        tuple_begin_cid = begin_cid - 2;
+        tuple_end_cid = begin_cid;
+        break;
+      case 4:
+        // inserted by the transaction itself
+        tuple_txn_id = txn_id;
+        tuple_begin_cid = MAX_CID;
+        break;
+      case 5:
+        // old version updated by the transaction itself
+        tuple_txn_id = txn_id;
+        break;
+      case 6:
+        // inserted by another running transaction
+        tuple_txn_id = txn_id + 1;
+        tuple_begin_cid = MAX_CID;
+        break;
+      case 7:
+        // old version being updated by another running transaction
+        tuple_txn_id = txn_id + 1;
+        break;
+    }
+
+    header.SetTransactionId(tuple_slot_id, tuple_txn_id);
+    header.SetBeginCommitId(tuple_slot_id, tuple_begin_cid);
+    header.SetEndCommitId(tuple_slot_id, tuple_end_cid);
+  }
+}
+
+}  // namespace
+
+// The bitmap agrees with IsVisible() slot by slot in both header layouts
+TEST_F(VisibilityTests, BitmapMatchesIsVisibleTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  // Leave room for versions committed before the transactions begin
+  txn_manager.SetNextCid(100);
+
+  for (auto header_layout : {HEADER_LAYOUT_ROW, HEADER_LAYOUT_COLUMN}) {
+    storage::TileGroupHeader header(BACKEND_TYPE_MM, tuple_count,
+                                    header_layout);
+    auto txn = txn_manager.BeginTransaction();
+    FillHeader(header, txn);
+
+    concurrency::VisibilityBitmap bitmap;
+    EXPECT_EQ(tuple_count,
+              txn_manager.ComputeVisibility(&header, txn->GetBeginCommitId(),
+                                            txn->GetTransactionId(), bitmap));
+    EXPECT_EQ((tuple_count + 63) / 64, bitmap.size());
+
+    size_t visible_count = 0;
+    for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count;
+         tuple_slot_id++) {
+      bool visible = txn_manager.IsVisible(&header, tuple_slot_id);
+      EXPECT_EQ(visible, IsSet(bitmap, tuple_slot_id));
+      visible_count += visible;
+
+      // Only cases 1, 4 and 7 are visible
+      oid_t visible_case = tuple_slot_id % case_count;
+      EXPECT_EQ(visible_case == 1 || visible_case == 4 || visible_case == 7,
+                visible);
+    }
+
+    std::vector<oid_t> position_list;
+    concurrency::GetPositionList(bitmap, position_list);
+    EXPECT_EQ(visible_count, position_list.size());
+    for (auto tuple_slot_id : position_list) {
+      EXPECT_TRUE(txn_manager.IsVisible(&header, tuple_slot_id));
+    }
+
+    txn_manager.CommitTransaction();
+  }
+}
+
+// Versions committed in the dirty range left by recovery are never visible
+TEST_F(VisibilityTests, DirtyRangeTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  // Leave room for versions committed before the transactions begin
+  txn_manager.SetNextCid(100);
+
+  storage::TileGroupHeader header(BACKEND_TYPE_MM, tuple_count,
+                                  HEADER_LAYOUT_COLUMN);
+  auto txn = txn_manager.BeginTransaction();
+  FillHeader(header, txn);
+
+  cid_t begin_cid = txn->GetBeginCommitId();
+  txn_manager.SetDirtyRange(std::make_pair(begin_cid - 2, begin_cid - 1));
+
+  concurrency::VisibilityBitmap bitmap;
+  txn_manager.ComputeVisibility(&header, begin_cid, txn->GetTransactionId(),
+                                bitmap);
+
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    // Only the transaction's own insert is left
+    EXPECT_EQ(tuple_slot_id % case_count == 4, IsSet(bitmap, tuple_slot_id));
+  }
+
+  txn_manager.SetDirtyRange(std::make_pair(INVALID_CID, INVALID_CID));
+  txn_manager.CommitTransaction();
+}
+
+}  // End test namespace
+}  // End peloton namespace
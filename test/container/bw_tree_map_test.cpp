@@ -0,0 +1,188 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// bw_tree_map_test.cpp
+//
+// Identification: test/container/bw_tree_map_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "container/bw_tree_map.h"
+
+#include "common/harness.h"
+#include "common/logger.h"
+#include "common/types.h"
+#include "index/index_key.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// BwTree Map Test
+//===--------------------------------------------------------------------===//
+
+class BwTreeMapTest : public PelotonTest {};
+
+typedef index::GenericKey<4> key_type;
+typedef ItemPointer *value_type;
+typedef index::GenericComparatorRaw<4> key_comparator;
+
+typedef BwTreeMap<key_type, value_type, key_comparator,
+                  ItemPointerPtrEqualityChecker,
+                  std::default_delete<ItemPointer>> map_type;
+
+namespace {
+
+catalog::Schema *BuildKeySchema() {
+  std::vector<catalog::Column> columns;
+  catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                          "A", true);
+  columns.push_back(column1);
+  return new catalog::Schema(columns);
+}
+
+key_type BuildKey(catalog::Schema *schema, int key_value) {
+  storage::Tuple tuple(schema, true);
+  tuple.SetValue(0, ValueFactory::GetIntegerValue(key_value), nullptr);
+
+  key_type key;
+  key.SetFromKey(&tuple);
+  return key;
+}
+
+int GetKeyValue(catalog::Schema *schema, key_type key) {
+  return ValuePeeker::PeekInteger(
+      key.GetTupleForComparison(schema).GetValue(0));
+}
+
+void InsertHelper(map_type *map, catalog::Schema *schema, int key_count,
+                  uint64_t thread_itr) {
+  // Threads insert interleaved keys so that they split the same leaves
+  for (int key_itr = 0; key_itr < key_count; key_itr++) {
+    int key_value = key_itr * 64 + thread_itr;
+    map->Insert(BuildKey(schema, key_value), new ItemPointer(key_value, 0));
+  }
+}
+
+}  // namespace
+
+// Test basic functionality
+TEST_F(BwTreeMapTest, BasicTest) {
+  std::unique_ptr<catalog::Schema> schema(BuildKeySchema());
+  map_type map;
+
+  auto key1 = BuildKey(schema.get(), 1);
+  auto key2 = BuildKey(schema.get(), 2);
+
+  // Duplicates are kept
+  map.Insert(key1, new ItemPointer(1, 1));
+  map.Insert(key1, new ItemPointer(1, 2));
+  map.Insert(key2, new ItemPointer(2, 1));
+
+  std::vector<value_type> values;
+  map.Find(key1, values);
+  EXPECT_EQ(2, values.size());
+  values.clear();
+
+  // Only a value that is not there yet goes in
+  auto same_block = [](const value_type &value) { return value->block == 2; };
+  std::unique_ptr<ItemPointer> rejected(new ItemPointer(3, 1));
+  EXPECT_FALSE(map.ConditionalInsert(key2, rejected.get(), same_block));
+  EXPECT_TRUE(map.ConditionalInsert(key2, new ItemPointer(3, 1),
+                                    [](const value_type &) { return false; }));
+
+  // Delete takes every equal value of the key
+  std::unique_ptr<ItemPointer> probe(new ItemPointer(1, 1));
+  EXPECT_TRUE(map.Delete(key1, probe.release()));
+  std::unique_ptr<ItemPointer> missing(new ItemPointer(1, 1));
+  EXPECT_FALSE(map.Delete(key1, missing.get()));
+
+  map.Find(key1, values);
+  EXPECT_EQ(1, values.size());
+  EXPECT_EQ(2, values[0]->offset);
+  values.clear();
+
+  map.Find(key2, values);
+  EXPECT_EQ(2, values.size());
+  values.clear();
+}
+
+// Splits keep every pair reachable and in order
+TEST_F(BwTreeMapTest, SplitTest) {
+  std::unique_ptr<catalog::Schema> schema(BuildKeySchema());
+  map_type map;
+
+  const int key_count = 10000;
+  for (int key_itr = 0; key_itr < key_count; key_itr++) {
+    // Spread the inserts over the whole key range
+    int key_value = (key_itr * 7919) % key_count;
+    map.Insert(BuildKey(schema.get(), key_value),
+               new ItemPointer(key_value, 0));
+  }
+  EXPECT_GT(map.GetNodeCount(), 1);
+
+  std::vector<std::pair<key_type, value_type>> entries;
+  map.Scan(nullptr, nullptr, entries);
+  EXPECT_EQ(key_count, entries.size());
+  for (int key_itr = 0; key_itr < (int)entries.size(); key_itr++) {
+    EXPECT_EQ(key_itr, GetKeyValue(schema.get(), entries[key_itr].first));
+  }
+  entries.clear();
+
+  // Remove the odd keys
+  for (int key_value = 1; key_value < key_count; key_value += 2) {
+    std::unique_ptr<ItemPointer> probe(new ItemPointer(key_value, 0));
+    EXPECT_TRUE(map.Delete(BuildKey(schema.get(), key_value), probe.get()));
+    probe.release();
+  }
+
+  auto low_key = BuildKey(schema.get(), 100);
+  auto high_key = BuildKey(schema.get(), 5000);
+  map.Scan(&low_key, &high_key, entries);
+  EXPECT_EQ(2451, entries.size());
+  for (auto &entry : entries) {
+    EXPECT_EQ(0, GetKeyValue(schema.get(), entry.first) % 2);
+  }
+  entries.clear();
+
+  std::vector<value_type> values;
+  map.Find(BuildKey(schema.get(), 4242), values);
+  EXPECT_EQ(1, values.size());
+  EXPECT_EQ(4242, values[0]->block);
+  values.clear();
+
+  map.Find(BuildKey(schema.get(), 4243), values);
+  EXPECT_EQ(0, values.size());
+
+  map.PerformGarbageCollection();
+}
+
+TEST_F(BwTreeMapTest, MultiThreadedInsertTest) {
+  std::unique_ptr<catalog::Schema> schema(BuildKeySchema());
+  map_type map;
+
+  size_t num_threads = 8;
+  int key_count = 5000;
+  LaunchParallelTest(num_threads, InsertHelper, &map, schema.get(), key_count);
+
+  std::vector<std::pair<key_type, value_type>> entries;
+  map.Scan(nullptr, nullptr, entries);
+  EXPECT_EQ(num_threads * key_count, entries.size());
+
+  // Every key once, in order
+  int previous_key_value = -1;
+  for (auto &entry : entries) {
+    int key_value = GetKeyValue(schema.get(), entry.first);
+    EXPECT_LT(previous_key_value, key_value);
+    EXPECT_EQ(key_value, entry.second->block);
+    previous_key_value = key_value;
+  }
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -23,6 +23,7 @@
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/aggregate_executor.h"
+#include "executor/aggregator.h"
 #include "executor/logical_tile_factory.h"
 #include "expression/expression_util.h"
 #include "planner/abstract_plan.h"
@@ -634,6 +635,118 @@ TEST_F(AggregateTests, HashCountDistinctGroupByTest) {
                   .IsTrue());
 }
 
+TEST_F(AggregateTests, HashParallelSumGroupByTest) {
+  /*
+   * SELECT a, SUM(b) from table GROUP BY a;
+   * with the partitions built by several threads
+   */
+  const int tuple_count = TESTS_TUPLES_PER_TILEGROUP;
+
+  // Create a table and wrap it in logical tiles
+  auto& txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuple_count, false));
+  ExecutorTestsUtil::PopulateTable(data_table.get(), 2 * tuple_count, false,
+                                   false, true);
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  // (1-5) Setup plan node
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm sumB(
+      EXPRESSION_TYPE_AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 1));
+  agg_terms.push_back(sumB);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto data_table_schema = data_table.get()->GetSchema();
+  std::vector<oid_t> set = {0, 1};
+  std::vector<catalog::Column> columns;
+  for (auto column_index : set) {
+    columns.push_back(data_table_schema->GetColumn(column_index));
+  }
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  // OK) Create the plan node
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AGGREGATE_TYPE_HASH);
+
+  // Create and set up executor
+  auto txn2 = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn2));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  peloton_aggregate_thread_count = 4;
+
+  EXPECT_TRUE(executor.Init());
+
+  EXPECT_TRUE(executor.Execute());
+
+  peloton_aggregate_thread_count = 0;
+
+  txn_manager.CommitTransaction();
+
+  /* Verify result */
+  std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+  EXPECT_TRUE(result_tile.get() != nullptr);
+  EXPECT_EQ(2, result_tile->GetTupleCount());
+
+  // Rows [0, tuple_count) have a = 0, the others a = 10, and b = 10 * row + 1
+  int first_group_sum = 0, second_group_sum = 0;
+  for (int row_itr = 0; row_itr < tuple_count; row_itr++) {
+    first_group_sum += 10 * row_itr + 1;
+    second_group_sum += 10 * (row_itr + tuple_count) + 1;
+  }
+
+  for (oid_t tuple_id : *result_tile) {
+    auto group_sum = result_tile->GetValue(tuple_id, 0)
+                             .OpEquals(ValueFactory::GetIntegerValue(0))
+                             .IsTrue()
+                         ? first_group_sum
+                         : second_group_sum;
+    EXPECT_TRUE(result_tile->GetValue(tuple_id, 1)
+                    .OpEquals(ValueFactory::GetIntegerValue(group_sum))
+                    .IsTrue());
+  }
+}
+
 TEST_F(AggregateTests, PlainSumCountDistinctTest) {
   /*
    * SELECT SUM(a), COUNT(b), COUNT(DISTINCT b) from table
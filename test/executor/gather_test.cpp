@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// gather_test.cpp
+//
+// Identification: test/executor/gather_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/types.h"
+#include "common/value_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/gather_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "expression/expression_util.h"
+#include "planner/gather_plan.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+class GatherTests : public PelotonTest {};
+
+namespace {
+
+const int tile_group_count = 20;
+
+const int row_count = TESTS_TUPLES_PER_TILEGROUP * tile_group_count;
+
+storage::DataTable *CreateTable() {
+  std::unique_ptr<storage::DataTable> table(
+      ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP, false));
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(table.get(), row_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  return table.release();
+}
+
+// Matches the first half of the rows
+expression::AbstractExpression *CreatePredicate() {
+  auto tuple_value_expr =
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 1);
+  auto constant_value_expr = expression::ExpressionUtil::ConstantValueFactory(
+      ValueFactory::GetIntegerValue(
+          ExecutorTestsUtil::PopulatedValue(row_count / 2, 1)));
+
+  return expression::ExpressionUtil::ComparisonFactory(
+      EXPRESSION_TYPE_COMPARE_LESSTHAN, tuple_value_expr, constant_value_expr);
+}
+
+// Values of the first column of all the tuples produced, sorted
+std::vector<int> ScanFirstColumn(executor::AbstractExecutor &executor) {
+  std::vector<int> values;
+
+  EXPECT_TRUE(executor.Init());
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      values.push_back(
+          result_tile->GetValue(tuple_id, 0).GetIntegerForTestsOnly());
+    }
+  }
+
+  std::sort(values.begin(), values.end());
+  return values;
+}
+
+}  // namespace
+
+// The parallel scan produces the same tuples as the serial one
+TEST_F(GatherTests, ParallelScanTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  std::vector<oid_t> column_ids({0, 1, 3});
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::SeqScanPlan serial_node(table.get(), CreatePredicate(), column_ids);
+  executor::SeqScanExecutor serial_executor(&serial_node, context.get());
+  auto expected_values = ScanFirstColumn(serial_executor);
+  EXPECT_EQ(row_count / 2, expected_values.size());
+
+  for (size_t morsel_size : {1, 3, 100}) {
+    planner::SeqScanPlan scan_node(table.get(), CreatePredicate(), column_ids);
+    planner::GatherPlan gather_node(4, morsel_size);
+
+    executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+    executor::GatherExecutor gather_executor(&gather_node, context.get());
+    gather_executor.AddChild(&scan_executor);
+
+    EXPECT_EQ(expected_values, ScanFirstColumn(gather_executor));
+
+    // Rescanning after Init() starts over
+    EXPECT_EQ(expected_values, ScanFirstColumn(gather_executor));
+  }
+
+  txn_manager.CommitTransaction();
+}
+
+// The consumer may walk away before the workers are done
+TEST_F(GatherTests, EarlyTerminationTest) {
+  std::unique_ptr<storage::DataTable> table(CreateTable());
+  std::vector<oid_t> column_ids({0});
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::SeqScanPlan scan_node(table.get(), nullptr, column_ids);
+  planner::GatherPlan gather_node(2);
+
+  executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+  std::unique_ptr<executor::GatherExecutor> gather_executor(
+      new executor::GatherExecutor(&gather_node, context.get()));
+  gather_executor->AddChild(&scan_executor);
+
+  EXPECT_TRUE(gather_executor->Init());
+  EXPECT_TRUE(gather_executor->Execute());
+  std::unique_ptr<executor::LogicalTile> result_tile(
+      gather_executor->GetOutput());
+  EXPECT_EQ(TESTS_TUPLES_PER_TILEGROUP, result_tile->GetTupleCount());
+
+  gather_executor.reset();
+
+  txn_manager.CommitTransaction();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -199,6 +199,29 @@ TEST_F(JoinTests, JoinPredicateTest) {
   }
 }
 
+TEST_F(JoinTests, RadixHashJoinTest) {
+  std::vector<oid_t> join_test_types = {BASIC_TEST, BOTH_TABLES_EMPTY,
+                                        COMPLICATED_TEST, LEFT_TABLE_EMPTY,
+                                        RIGHT_TABLE_EMPTY};
+
+  // Go over the radix hash join with one and more threads
+  for (int thread_count : {1, 4}) {
+    peloton_hash_join_thread_count = thread_count;
+    LOG_INFO("RADIX HASH JOIN THREADS :: %d", thread_count);
+
+    for (auto join_test_type : join_test_types) {
+      // Go over all join types
+      for (auto join_type : join_types) {
+        LOG_INFO("JOIN TYPE :: %d", join_type);
+        // Execute the join test
+        ExecuteJoinTest(PLAN_NODE_TYPE_HASHJOIN, join_type, join_test_type);
+      }
+    }
+  }
+
+  peloton_hash_join_thread_count = 0;
+}
+
 TEST_F(JoinTests, SpeedTest) {
   ExecuteJoinTest(PLAN_NODE_TYPE_HASHJOIN, JOIN_TYPE_OUTER, SPEED_TEST);
 
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <string>
@@ -21,6 +22,7 @@
 #include "planner/order_by_plan.h"
 #include "common/types.h"
 #include "common/value.h"
+#include "common/value_peeker.h"
 #include "executor/executor_context.h"
 #include "executor/logical_tile.h"
 #include "executor/order_by_executor.h"
@@ -300,6 +302,138 @@ TEST_F(OrderByTests, StringDescIntAscTest) {
 
   RunTest(executor, tile_size * 2, sort_keys, descend_flags);
 }
+
+// (int column, varchar column) of a tuple
+typedef std::pair<int32_t, std::string> SortedRow;
+
+/**
+ * Sort the int column of two random tiles, with the given sort memory budget
+ * and limit, and return the sorted values. The rows, along with their
+ * varchar column, are collected too if asked for.
+ */
+std::vector<int32_t> SortIntColumn(
+    int64_t memory_budget, bool has_limit, size_t limit,
+    size_t *spilled_run_count, std::vector<int32_t> *input_values,
+    std::vector<SortedRow> *input_rows = nullptr,
+    std::vector<SortedRow> *sorted_rows = nullptr) {
+  std::vector<oid_t> sort_keys({1});
+  std::vector<bool> descend_flags({false});
+  std::vector<oid_t> output_columns({0, 1, 2, 3});
+  planner::OrderByPlan node(sort_keys, descend_flags, output_columns);
+
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(nullptr));
+
+  executor::OrderByExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+
+  EXPECT_CALL(child_executor, DExecute())
+      .WillOnce(Return(true))
+      .WillOnce(Return(true))
+      .WillOnce(Return(false));
+
+  size_t tile_size = 20;
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tile_size));
+  bool random = true;
+  ExecutorTestsUtil::PopulateTable(data_table.get(), tile_size * 2, false,
+                                   random, false);
+  txn_manager.CommitTransaction();
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile1(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(0)));
+
+  std::unique_ptr<executor::LogicalTile> source_logical_tile2(
+      executor::LogicalTileFactory::WrapTileGroup(data_table->GetTileGroup(1)));
+
+  for (auto source_logical_tile :
+       {source_logical_tile1.get(), source_logical_tile2.get()}) {
+    for (oid_t tuple_id : *source_logical_tile) {
+      input_values->push_back(ValuePeeker::PeekInteger(
+          source_logical_tile->GetValue(tuple_id, 1)));
+      if (input_rows != nullptr) {
+        input_rows->emplace_back(
+            input_values->back(),
+            ValuePeeker::PeekStringCopyWithoutNull(
+                source_logical_tile->GetValue(tuple_id, 3)));
+      }
+    }
+  }
+
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillOnce(Return(source_logical_tile1.release()))
+      .WillOnce(Return(source_logical_tile2.release()));
+
+  peloton_sort_memory_budget = memory_budget;
+
+  EXPECT_TRUE(executor.Init());
+  if (has_limit) {
+    executor.SetLimit(limit);
+  }
+
+  std::vector<int32_t> sorted_values;
+  while (executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    for (oid_t tuple_id : *result_tile) {
+      sorted_values.push_back(
+          ValuePeeker::PeekInteger(result_tile->GetValue(tuple_id, 1)));
+      if (sorted_rows != nullptr) {
+        sorted_rows->emplace_back(
+            sorted_values.back(), ValuePeeker::PeekStringCopyWithoutNull(
+                                      result_tile->GetValue(tuple_id, 3)));
+      }
+    }
+  }
+
+  *spilled_run_count = executor.GetSpilledRunCount();
+  peloton_sort_memory_budget = 0;
+
+  return sorted_values;
+}
+
+TEST_F(OrderByTests, SpillTest) {
+  // Every input tile is more than the budget, so it is spilled to a run
+  size_t spilled_run_count = 0;
+  std::vector<int32_t> input_values;
+  std::vector<SortedRow> input_rows, sorted_rows;
+  auto sorted_values = SortIntColumn(1, false, 0, &spilled_run_count,
+                                     &input_values, &input_rows, &sorted_rows);
+
+  EXPECT_EQ(2, spilled_run_count);
+
+  std::sort(input_values.begin(), input_values.end());
+  EXPECT_EQ(input_values, sorted_values);
+
+  // The varchars made it through the runs with their tuples
+  std::sort(input_rows.begin(), input_rows.end());
+  std::sort(sorted_rows.begin(), sorted_rows.end());
+  EXPECT_EQ(input_rows, sorted_rows);
+}
+
+TEST_F(OrderByTests, TopNTest) {
+  for (int64_t memory_budget : {0, 1}) {
+    size_t spilled_run_count = 0;
+    std::vector<int32_t> input_values;
+    auto sorted_values = SortIntColumn(memory_budget, true, 5,
+                                       &spilled_run_count, &input_values);
+
+    std::sort(input_values.begin(), input_values.end());
+    input_values.resize(5);
+    EXPECT_EQ(input_values, sorted_values);
+  }
+
+  // A limit of zero returns nothing
+  size_t spilled_run_count = 0;
+  std::vector<int32_t> input_values;
+  auto sorted_values =
+      SortIntColumn(0, true, 0, &spilled_run_count, &input_values);
+  EXPECT_EQ(0, sorted_values.size());
+}
 }
 
 }  // namespace test
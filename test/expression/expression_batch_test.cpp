@@ -0,0 +1,349 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// expression_batch_test.cpp
+//
+// Identification: test/expression/expression_batch_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "common/value_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "expression/abstract_expression.h"
+#include "expression/container_tuple.h"
+#include "expression/expression_batch.h"
+#include "expression/expression_util.h"
+#include "storage/tile_group.h"
+#include "storage/tuple.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Batch Expression Evaluation Tests
+//===--------------------------------------------------------------------===//
+
+class ExpressionBatchTests : public PelotonTest {};
+
+const int tuple_count = 100;
+
+// Tile group with the ExecutorTestsUtil layout and one row of NULLs at the end
+static std::shared_ptr<storage::TileGroup> CreateTileGroup() {
+  auto tile_group = ExecutorTestsUtil::CreateTileGroup(tuple_count + 1);
+  ExecutorTestsUtil::PopulateTiles(tile_group, tuple_count);
+
+  std::unique_ptr<catalog::Schema> schema(
+      catalog::Schema::AppendSchemaList(tile_group->GetTileSchemas()));
+  storage::Tuple tuple(schema.get(), true);
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  tuple.SetValue(0, Value::GetNullValue(VALUE_TYPE_INTEGER), testing_pool);
+  tuple.SetValue(1, ValueFactory::GetIntegerValue(1), testing_pool);
+  tuple.SetValue(2, Value::GetNullValue(VALUE_TYPE_DOUBLE), testing_pool);
+  tuple.SetValue(3, ValueFactory::GetStringValue("null"), testing_pool);
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  oid_t tuple_slot_id = tile_group->InsertTuple(&tuple);
+  txn_manager.PerformInsert(
+      ItemPointer(tile_group->GetTileGroupId(), tuple_slot_id));
+  txn_manager.CommitTransaction();
+
+  return tile_group;
+}
+
+static expression::AbstractExpression *Column(ValueType type, int column_id) {
+  return expression::ExpressionUtil::TupleValueFactory(type, 0, column_id);
+}
+
+static expression::AbstractExpression *Constant(const Value &value) {
+  return expression::ExpressionUtil::ConstantValueFactory(value);
+}
+
+static expression::AbstractExpression *Compare(
+    ExpressionType type, expression::AbstractExpression *left,
+    expression::AbstractExpression *right) {
+  return expression::ExpressionUtil::ComparisonFactory(type, left, right);
+}
+
+// Tuples for which the tuple at a time path returns true
+static expression::SelectionVector EvaluateScalar(
+    storage::TileGroup *tile_group,
+    const expression::AbstractExpression *predicate) {
+  expression::SelectionVector selection;
+  for (oid_t tuple_id = 0; tuple_id < tile_group->GetNextTupleSlot();
+       tuple_id++) {
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group, tuple_id);
+    if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+      selection.push_back(tuple_id);
+    }
+  }
+  return selection;
+}
+
+static expression::SelectionVector EvaluateBatch(
+    storage::TileGroup *tile_group,
+    const expression::AbstractExpression *predicate) {
+  expression::SelectionVector selection(tile_group->GetNextTupleSlot());
+  std::iota(selection.begin(), selection.end(), 0);
+
+  expression::BatchSource source(tile_group);
+  predicate->EvaluateBatch(source, selection, nullptr);
+  return selection;
+}
+
+static void CheckPredicate(storage::TileGroup *tile_group,
+                           expression::AbstractExpression *predicate,
+                           size_t expected_count) {
+  std::unique_ptr<expression::AbstractExpression> predicate_ptr(predicate);
+
+  auto expected = EvaluateScalar(tile_group, predicate);
+  auto selection = EvaluateBatch(tile_group, predicate);
+
+  EXPECT_EQ(expected_count, expected.size());
+  EXPECT_EQ(expected, selection);
+}
+
+TEST_F(ExpressionBatchTests, ComparisonTest) {
+  auto tile_group = CreateTileGroup();
+
+  // ATTR0 >= 200 (integer, values 0, 10, ..., 990)
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                         Column(VALUE_TYPE_INTEGER, 0),
+                         Constant(ValueFactory::GetIntegerValue(200))),
+                 80);
+
+  // ATTR2 < 302.5 (double, values 2, 12, ..., 992)
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                         Column(VALUE_TYPE_DOUBLE, 2),
+                         Constant(ValueFactory::GetDoubleValue(302.5))),
+                 31);
+
+  // 501 = ATTR1, integer column against a bigint constant
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_EQUAL,
+                         Constant(ValueFactory::GetBigIntValue(501)),
+                         Column(VALUE_TYPE_INTEGER, 1)),
+                 1);
+
+  // ATTR0 <> ATTR1 is true everywhere but on the row of NULLs
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_NOTEQUAL,
+                         Column(VALUE_TYPE_INTEGER, 0),
+                         Column(VALUE_TYPE_INTEGER, 1)),
+                 tuple_count);
+
+  // ATTR0 < ATTR2 mixes integer and double columns
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                         Column(VALUE_TYPE_INTEGER, 0),
+                         Column(VALUE_TYPE_DOUBLE, 2)),
+                 tuple_count);
+
+  // ATTR3 = '133' has no typed kernel and takes the scalar path
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_EQUAL,
+                         Column(VALUE_TYPE_VARCHAR, 3),
+                         Constant(ValueFactory::GetStringValue("133"))),
+                 1);
+}
+
+TEST_F(ExpressionBatchTests, ConjunctionTest) {
+  auto tile_group = CreateTileGroup();
+
+  // ATTR0 >= 100 AND ATTR1 < 501
+  CheckPredicate(tile_group.get(),
+                 expression::ExpressionUtil::ConjunctionFactory(
+                     EXPRESSION_TYPE_CONJUNCTION_AND,
+                     Compare(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                             Column(VALUE_TYPE_INTEGER, 0),
+                             Constant(ValueFactory::GetIntegerValue(100))),
+                     Compare(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                             Column(VALUE_TYPE_INTEGER, 1),
+                             Constant(ValueFactory::GetIntegerValue(501)))),
+                 40);
+
+  // ATTR0 < 50 OR ATTR2 > 900 OR ATTR3 = '503'
+  CheckPredicate(
+      tile_group.get(),
+      expression::ExpressionUtil::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_OR,
+          expression::ExpressionUtil::ConjunctionFactory(
+              EXPRESSION_TYPE_CONJUNCTION_OR,
+              Compare(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                      Column(VALUE_TYPE_INTEGER, 0),
+                      Constant(ValueFactory::GetIntegerValue(50))),
+              Compare(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                      Column(VALUE_TYPE_DOUBLE, 2),
+                      Constant(ValueFactory::GetDoubleValue(900)))),
+          Compare(EXPRESSION_TYPE_COMPARE_EQUAL, Column(VALUE_TYPE_VARCHAR, 3),
+                  Constant(ValueFactory::GetStringValue("503")))),
+      16);
+}
+
+TEST_F(ExpressionBatchTests, ArithmeticTest) {
+  auto tile_group = CreateTileGroup();
+
+  // ATTR0 + ATTR1 > 301
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                         expression::ExpressionUtil::OperatorFactory(
+                             EXPRESSION_TYPE_OPERATOR_PLUS, VALUE_TYPE_BIGINT,
+                             Column(VALUE_TYPE_INTEGER, 0),
+                             Column(VALUE_TYPE_INTEGER, 1)),
+                         Constant(ValueFactory::GetIntegerValue(301))),
+                 84);
+
+  // ATTR2 / 2 - ATTR0 <= 1
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                         expression::ExpressionUtil::OperatorFactory(
+                             EXPRESSION_TYPE_OPERATOR_MINUS, VALUE_TYPE_DOUBLE,
+                             expression::ExpressionUtil::OperatorFactory(
+                                 EXPRESSION_TYPE_OPERATOR_DIVIDE,
+                                 VALUE_TYPE_DOUBLE,
+                                 Column(VALUE_TYPE_DOUBLE, 2),
+                                 Constant(ValueFactory::GetIntegerValue(2))),
+                             Column(VALUE_TYPE_INTEGER, 0)),
+                         Constant(ValueFactory::GetIntegerValue(1))),
+                 tuple_count);
+
+  // ATTR1 * 3 = 93
+  CheckPredicate(tile_group.get(),
+                 Compare(EXPRESSION_TYPE_COMPARE_EQUAL,
+                         expression::ExpressionUtil::OperatorFactory(
+                             EXPRESSION_TYPE_OPERATOR_MULTIPLY,
+                             VALUE_TYPE_BIGINT, Column(VALUE_TYPE_INTEGER, 1),
+                             Constant(ValueFactory::GetIntegerValue(3))),
+                         Constant(ValueFactory::GetIntegerValue(93))),
+                 1);
+}
+
+TEST_F(ExpressionBatchTests, IsNullTest) {
+  auto tile_group = CreateTileGroup();
+
+  CheckPredicate(tile_group.get(),
+                 expression::ExpressionUtil::OperatorFactory(
+                     EXPRESSION_TYPE_OPERATOR_IS_NULL, VALUE_TYPE_BOOLEAN,
+                     Column(VALUE_TYPE_INTEGER, 0), nullptr),
+                 1);
+
+  CheckPredicate(tile_group.get(),
+                 expression::ExpressionUtil::OperatorFactory(
+                     EXPRESSION_TYPE_OPERATOR_IS_NULL, VALUE_TYPE_BOOLEAN,
+                     Column(VALUE_TYPE_DOUBLE, 2), nullptr),
+                 1);
+
+  CheckPredicate(tile_group.get(),
+                 expression::ExpressionUtil::OperatorFactory(
+                     EXPRESSION_TYPE_OPERATOR_IS_NULL, VALUE_TYPE_BOOLEAN,
+                     Column(VALUE_TYPE_INTEGER, 1), nullptr),
+                 0);
+}
+
+TEST_F(ExpressionBatchTests, LogicalTileTest) {
+  auto tile_group = CreateTileGroup();
+  std::unique_ptr<executor::LogicalTile> logical_tile(
+      executor::LogicalTileFactory::WrapTileGroup(tile_group));
+
+  // Only look at every other row of the logical tile
+  expression::SelectionVector selection;
+  for (oid_t tuple_id : *logical_tile) {
+    if (tuple_id % 2 == 0) selection.push_back(tuple_id);
+  }
+
+  // ATTR0 < 300 AND ATTR2 >= 102
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_AND,
+          Compare(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                  Column(VALUE_TYPE_INTEGER, 0),
+                  Constant(ValueFactory::GetIntegerValue(300))),
+          Compare(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                  Column(VALUE_TYPE_DOUBLE, 2),
+                  Constant(ValueFactory::GetDoubleValue(102)))));
+
+  expression::BatchSource source(logical_tile.get());
+  predicate->EvaluateBatch(source, selection, nullptr);
+
+  // rows 10, 12, ..., 28
+  EXPECT_EQ(10, selection.size());
+  for (auto tuple_id : selection) {
+    expression::ContainerTuple<executor::LogicalTile> tuple(logical_tile.get(),
+                                                            tuple_id);
+    EXPECT_TRUE(predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue());
+  }
+}
+
+TEST_F(ExpressionBatchTests, OuterJoinPaddingTest) {
+  auto tile_group = CreateTileGroup();
+
+  // Like the output of a left join, every third row has no match on the
+  // right side and is padded with NULLs
+  executor::LogicalTile::PositionList left_positions, right_positions;
+  for (oid_t tuple_id = 0; tuple_id < tuple_count; tuple_id++) {
+    left_positions.push_back(tuple_id);
+    right_positions.push_back(tuple_id % 3 == 0 ? NULL_OID : tuple_id);
+  }
+
+  std::unique_ptr<executor::LogicalTile> logical_tile(
+      executor::LogicalTileFactory::GetTile());
+  logical_tile->AddPositionList(std::move(left_positions));
+  logical_tile->AddPositionList(std::move(right_positions));
+  oid_t tile_offset, tile_column_id;
+  tile_group->LocateTileAndColumn(0, tile_offset, tile_column_id);
+  logical_tile->AddColumn(tile_group->GetTileReference(tile_offset),
+                          tile_column_id, 0);
+  tile_group->LocateTileAndColumn(1, tile_offset, tile_column_id);
+  logical_tile->AddColumn(tile_group->GetTileReference(tile_offset),
+                          tile_column_id, 1);
+
+  // ATTR0 < 300 AND ATTR1 >= 1 on the padded right side, the padding
+  // never qualifies
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_AND,
+          Compare(EXPRESSION_TYPE_COMPARE_LESSTHAN,
+                  Column(VALUE_TYPE_INTEGER, 0),
+                  Constant(ValueFactory::GetIntegerValue(300))),
+          Compare(EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                  Column(VALUE_TYPE_INTEGER, 1),
+                  Constant(ValueFactory::GetIntegerValue(1)))));
+
+  expression::SelectionVector expected;
+  for (oid_t tuple_id : *logical_tile) {
+    expression::ContainerTuple<executor::LogicalTile> tuple(logical_tile.get(),
+                                                            tuple_id);
+    if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+      expected.push_back(tuple_id);
+    }
+  }
+
+  expression::SelectionVector selection;
+  for (oid_t tuple_id : *logical_tile) selection.push_back(tuple_id);
+  expression::BatchSource source(logical_tile.get());
+  predicate->EvaluateBatch(source, selection, nullptr);
+
+  // rows 1, 2, 4, 5, ..., 29
+  EXPECT_EQ(20, expected.size());
+  EXPECT_EQ(expected, selection);
+}
+
+}  // End test namespace
+}  // End peloton namespace
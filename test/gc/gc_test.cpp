@@ -16,6 +16,9 @@
 #include "gc/gc_manager.h"
 #include "gc/gc_manager_factory.h"
 #include "concurrency/epoch_manager.h"
+#include "storage/data_table.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
 
 namespace peloton {
 namespace test {
@@ -208,5 +211,125 @@ each time
 
 */
 
+TEST_F(GCTest, SlotRecyclingTest) {
+  gc::GCManagerFactory::Configure(GC_TYPE_COOPERATIVE, 2);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+
+  const int num_key = 1;
+  std::unique_ptr<storage::DataTable> table(TransactionTestsUtil::CreateTable(
+      num_key, "TEST_TABLE", INVALID_OID, 1235, 1234, true));
+
+  // Retire the only version, no txn can see it any more
+  auto tile_group = table->GetTileGroup(0);
+  ItemPointer garbage(tile_group->GetTileGroupId(), 0);
+  tile_group->GetHeader()->SetTransactionId(garbage.offset, INVALID_TXN_ID);
+  gc_manager.RecycleTupleSlot(table->GetOid(), garbage.block, garbage.offset,
+                              0);
+
+  // sleep a while for gc to reset the slot
+  std::this_thread::sleep_for(
+      10 * std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+  EXPECT_EQ(1, (int)gc_manager.GetRecycledCount());
+  EXPECT_EQ(0, (int)gc_manager.GetReclaimQueueDepth());
+  EXPECT_EQ(MAX_CID, gc_manager.GetOldestUnreclaimedCid());
+
+  // The next insert reuses the slot instead of claiming a new one
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(table->GetSchema(), true));
+  tuple->SetValue(0, ValueFactory::GetIntegerValue(num_key), nullptr);
+  tuple->SetValue(1, ValueFactory::GetIntegerValue(0), nullptr);
+  auto location = table->InsertTuple(tuple.get());
+
+  EXPECT_EQ(garbage.block, location.block);
+  EXPECT_EQ(garbage.offset, location.offset);
+  EXPECT_EQ(1, (int)gc_manager.GetReusedCount());
+
+  // Without free slots the table grows again
+  location = table->InsertTuple(tuple.get());
+  EXPECT_EQ(garbage.block, location.block);
+  EXPECT_EQ(num_key, (int)location.offset);
+}
+
+TEST_F(GCTest, FreeSlotCacheTest) {
+  gc::GCManagerFactory::Configure(GC_TYPE_COOPERATIVE, 2);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+
+  const int num_key = 2;
+  std::unique_ptr<storage::DataTable> table(TransactionTestsUtil::CreateTable(
+      num_key, "TEST_TABLE", INVALID_OID, 1238, 1239, false));
+
+  // Retire both versions, no txn can see them any more
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_id = tile_group->GetTileGroupId();
+  for (oid_t tuple_id = 0; tuple_id < num_key; tuple_id++) {
+    tile_group->GetHeader()->SetTransactionId(tuple_id, INVALID_TXN_ID);
+    gc_manager.RecycleTupleSlot(table->GetOid(), tile_group_id, tuple_id, 0);
+  }
+
+  // sleep a while for gc to reset the slots
+  std::this_thread::sleep_for(
+      10 * std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+  size_t reused_count = gc_manager.GetReusedCount();
+
+  std::unique_ptr<storage::Tuple> tuple(
+      new storage::Tuple(table->GetSchema(), true));
+  tuple->SetValue(0, ValueFactory::GetIntegerValue(num_key), nullptr);
+  tuple->SetValue(1, ValueFactory::GetIntegerValue(0), nullptr);
+
+  // A thread takes both slots into its cache, but only uses one
+  ItemPointer thread_location;
+  std::thread insert_thread(
+      [&] { thread_location = table->InsertTuple(tuple.get()); });
+  insert_thread.join();
+  EXPECT_EQ(tile_group_id, thread_location.block);
+  EXPECT_GT(num_key, (int)thread_location.offset);
+
+  // The other one went back to the GC when the thread exited
+  EXPECT_EQ(reused_count + 1, gc_manager.GetReusedCount());
+  auto location = table->InsertTuple(tuple.get());
+  EXPECT_EQ(tile_group_id, location.block);
+  EXPECT_GT(num_key, (int)location.offset);
+  EXPECT_NE(thread_location.offset, location.offset);
+}
+
+TEST_F(GCTest, SecondaryIndexCleanupTest) {
+  gc::GCManagerFactory::Configure(GC_TYPE_COOPERATIVE, 2);
+  auto &gc_manager = gc::GCManagerFactory::GetInstance();
+  EXPECT_EQ(2, gc_manager.GetThreadCount());
+
+  // The index of this table is a secondary one
+  const int num_key = 2;
+  std::unique_ptr<storage::DataTable> table(TransactionTestsUtil::CreateTable(
+      num_key, "TEST_TABLE", INVALID_OID, 1236, 1237, false));
+  auto index = table->GetIndex(0);
+
+  std::vector<ItemPointer> locations;
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(num_key, (int)locations.size());
+
+  // Retire both versions, but the second one may still be seen by some txn
+  auto tile_group = table->GetTileGroup(0);
+  auto tile_group_id = tile_group->GetTileGroupId();
+  for (oid_t tuple_id = 0; tuple_id < num_key; tuple_id++) {
+    tile_group->GetHeader()->SetTransactionId(tuple_id, INVALID_TXN_ID);
+  }
+  gc_manager.RecycleTupleSlot(table->GetOid(), tile_group_id, 0, 0);
+  gc_manager.RecycleTupleSlot(table->GetOid(), tile_group_id, 1, MAX_CID - 1);
+
+  // sleep a while for gc to reclaim the first one
+  std::this_thread::sleep_for(
+      10 * std::chrono::milliseconds(GC_PERIOD_MILLISECONDS));
+  EXPECT_EQ(1, (int)gc_manager.GetReclaimQueueDepth());
+  EXPECT_EQ(MAX_CID - 1, gc_manager.GetOldestUnreclaimedCid());
+
+  // Only the entry of the reclaimed version is gone
+  locations.clear();
+  index->ScanAllKeys(locations);
+  EXPECT_EQ(1, (int)locations.size());
+  if (locations.size() == 1) {
+    EXPECT_EQ(1, (int)locations[0].offset);
+  }
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -104,38 +104,102 @@ void InsertTest(index::Index *index, size_t scale_factor, uint64_t thread_itr) {
 
 }
 
-static void TestIndexPerformance(const IndexType& index_type) {
+// LOOKUP HELPER FUNCTION
+void LookupTest(index::Index *index, size_t scale_factor, uint64_t thread_itr) {
+
+  size_t base = thread_itr * base_scale * max_scale_factor;
+  size_t tuple_count = scale_factor * base_scale;
+
+  std::unique_ptr<storage::Tuple> key(new storage::Tuple(key_schema, true));
+  std::vector<ItemPointer *> locations;
+
+  for (size_t tuple_itr = 1; tuple_itr <= tuple_count; tuple_itr++) {
+    oid_t tuple_offset = base + tuple_itr;
+    auto key_value =  ValueFactory::GetIntegerValue(tuple_offset);
+
+    key->SetValue(0, key_value, nullptr);
+    key->SetValue(1, key_value, nullptr);
+
+    // Primary key lookup as issued by the index scan executor
+    index->Scan({key_value, key_value}, {0, 1},
+                {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(1, locations.size());
+    locations.clear();
+  }
+
+}
+
+static void TestIndexPerformance(const IndexType& index_type,
+                                 const size_t num_threads) {
   std::vector<ItemPointer> locations;
 
   // INDEX
   std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
 
   // Parallel Test
-  size_t num_threads = 4;
   size_t scale_factor = 10;
   Timer<> timer;
 
-  std::vector<std::thread> thread_group;
-
   timer.Start();
 
   LaunchParallelTest(num_threads, InsertTest, index.get(), scale_factor);
 
+  timer.Stop();
+
   index->ScanAllKeys(locations);
   EXPECT_EQ(locations.size(), num_threads * scale_factor * base_scale);
   locations.clear();
 
+  double duration = timer.GetDuration();
+  LOG_INFO("%s : %lu threads : Duration : %.2lf : Throughput : %.0lf inserts/s",
+           index->GetTypeName().c_str(), num_threads, duration,
+           num_threads * scale_factor * base_scale / duration);
+
+  delete tuple_schema;
+}
+
+static void TestLookupPerformance(const IndexType& index_type) {
+  // INDEX
+  std::unique_ptr<index::Index> index(BuildIndex(true, index_type));
+
+  size_t num_threads = 4;
+  size_t scale_factor = 10;
+  LaunchParallelTest(num_threads, InsertTest, index.get(), scale_factor);
+
+  Timer<std::micro> timer;
+
+  timer.Start();
+
+  LaunchParallelTest(num_threads, LookupTest, index.get(), scale_factor);
+
   timer.Stop();
-  LOG_INFO("Duration : %.2lf", timer.GetDuration());
+
+  LOG_INFO("%s : Lookup latency : %.3lf us", index->GetTypeName().c_str(),
+           timer.GetDuration() / (num_threads * scale_factor * base_scale));
 
   delete tuple_schema;
 }
 
 TEST_F(IndexPerformanceTests, MultiThreadedTest) {
-  std::vector<IndexType> index_types = {INDEX_TYPE_BTREE, INDEX_TYPE_SKIPLIST};
+  std::vector<IndexType> index_types = {INDEX_TYPE_BTREE, INDEX_TYPE_SKIPLIST,
+                                        INDEX_TYPE_BWTREE, INDEX_TYPE_HASH};
+  std::vector<size_t> thread_counts = {1, 2, 4, 8, 16, 32};
+
+  for (auto index_type : index_types) {
+    for (auto num_threads : thread_counts) {
+      TestIndexPerformance(index_type, num_threads);
+    }
+  }
+
+}
+
+TEST_F(IndexPerformanceTests, LookupTest) {
+  std::vector<IndexType> index_types = {INDEX_TYPE_BTREE, INDEX_TYPE_BWTREE,
+                                        INDEX_TYPE_HASH};
 
-  for(auto index_type : index_types) {
-    TestIndexPerformance(index_type);
+  for (auto index_type : index_types) {
+    TestLookupPerformance(index_type);
   }
 
 }
@@ -37,14 +37,15 @@ ItemPointer item0(120, 5);
 ItemPointer item1(120, 7);
 ItemPointer item2(123, 19);
 
-index::Index *BuildIndex(const bool unique_keys) {
+// Every test runs against each of these
+std::vector<IndexType> index_types = {INDEX_TYPE_BTREE, INDEX_TYPE_BWTREE,
+                                      INDEX_TYPE_HASH};
+
+index::Index *BuildIndex(const bool unique_keys, const IndexType index_type) {
   // Build tuple and key schema
   std::vector<std::vector<std::string>> column_names;
   std::vector<catalog::Column> columns;
   std::vector<catalog::Schema *> schemas;
-  IndexType index_type = INDEX_TYPE_BTREE;
-  // FIXME: Try to use BWTREE
-  // index_type = INDEX_TYPE_BWTREE;
 
   catalog::Column column1(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
                           "A", true);
@@ -80,34 +81,36 @@ index::Index *BuildIndex(const bool unique_keys) {
 }
 
 TEST_F(IndexTests, BasicTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
 
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
 
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
 
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
 
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
 
-  // INSERT
-  index->InsertEntry(key0.get(), item0);
+    // INSERT
+    index->InsertEntry(key0.get(), item0);
 
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 1);
-  EXPECT_EQ(locations[0].block, item0.block);
-  locations.clear();
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].block, item0.block);
+    locations.clear();
 
-  // DELETE
-  index->DeleteEntry(key0.get(), item0);
+    // DELETE
+    index->DeleteEntry(key0.get(), item0);
 
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
 
-  delete tuple_schema;
+    delete tuple_schema;
+  }
 }
 
 // INSERT HELPER FUNCTION
@@ -253,231 +256,244 @@ void DeleteTest(index::Index *index, VarlenPool *pool, size_t scale_factor,
 }
 
 TEST_F(IndexTests, MultiMapInsertTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
-
-  // Single threaded test
-  size_t scale_factor = 1;
-  LaunchParallelTest(1, InsertTest, index.get(), pool, scale_factor);
-
-  // Checks
-  index->ScanAllKeys(locations);
-  EXPECT_EQ(locations.size(), 9);
-  locations.clear();
-
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> keynonce(
-      new storage::Tuple(key_schema, true));
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
-  keynonce->SetValue(0, ValueFactory::GetIntegerValue(1000), pool);
-  keynonce->SetValue(1, ValueFactory::GetStringValue("f"), pool);
-
-  index->ScanKey(keynonce.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 1);
-  EXPECT_EQ(locations[0].block, item0.block);
-  locations.clear();
-
-  delete tuple_schema;
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+    // Single threaded test
+    size_t scale_factor = 1;
+    LaunchParallelTest(1, InsertTest, index.get(), pool, scale_factor);
+
+    // Checks
+    index->ScanAllKeys(locations);
+    EXPECT_EQ(locations.size(), 9);
+    locations.clear();
+
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> keynonce(
+        new storage::Tuple(key_schema, true));
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    keynonce->SetValue(0, ValueFactory::GetIntegerValue(1000), pool);
+    keynonce->SetValue(1, ValueFactory::GetStringValue("f"), pool);
+
+    index->ScanKey(keynonce.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].block, item0.block);
+    locations.clear();
+
+    delete tuple_schema;
+  }
 }
 
 #ifdef ALLOW_UNIQUE_KEY
 TEST_F(IndexTests, UniqueKeyDeleteTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(true));
-
-  // Single threaded test
-  size_t scale_factor = 1;
-  LaunchParallelTest(1, InsertTest, index.get(), pool, scale_factor);
-  LaunchParallelTest(1, DeleteTest, index.get(), pool, scale_factor);
-
-  // Checks
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
-
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
-  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
-  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
-
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key1.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key2.get(), locations);
-  EXPECT_EQ(locations.size(), 1);
-  EXPECT_EQ(locations[0].block, item1.block);
-  locations.clear();
-
-  delete tuple_schema;
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(true, index_type));
+
+    // Single threaded test
+    size_t scale_factor = 1;
+    LaunchParallelTest(1, InsertTest, index.get(), pool, scale_factor);
+    LaunchParallelTest(1, DeleteTest, index.get(), pool, scale_factor);
+
+    // Checks
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key1.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key2.get(), locations);
+    EXPECT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].block, item1.block);
+    locations.clear();
+
+    delete tuple_schema;
+  }
 }
 #endif
 
 TEST_F(IndexTests, NonUniqueKeyDeleteTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
-
-  // Single threaded test
-  size_t scale_factor = 1;
-  LaunchParallelTest(1, InsertTest, index.get(), pool, scale_factor);
-  LaunchParallelTest(1, DeleteTest, index.get(), pool, scale_factor);
-
-  // Checks
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
-
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
-  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
-  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
-
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key1.get(), locations);
-  EXPECT_EQ(locations.size(), 2);
-  locations.clear();
-
-  index->ScanKey(key2.get(), locations);
-  EXPECT_EQ(locations.size(), 1);
-  EXPECT_EQ(locations[0].block, item1.block);
-  locations.clear();
-
-  delete tuple_schema;
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+    // Single threaded test
+    size_t scale_factor = 1;
+    LaunchParallelTest(1, InsertTest, index.get(), pool, scale_factor);
+    LaunchParallelTest(1, DeleteTest, index.get(), pool, scale_factor);
+
+    // Checks
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key1.get(), locations);
+    EXPECT_EQ(locations.size(), 2);
+    locations.clear();
+
+    index->ScanKey(key2.get(), locations);
+    EXPECT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].block, item1.block);
+    locations.clear();
+
+    delete tuple_schema;
+  }
 }
 
 TEST_F(IndexTests, MultiThreadedInsertTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
 
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
 
-  // Parallel Test
-  size_t num_threads = 4;
-  size_t scale_factor = 1;
-  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
+    // Parallel Test
+    size_t num_threads = 4;
+    size_t scale_factor = 1;
+    LaunchParallelTest(num_threads, InsertTest, index.get(), pool,
+                       scale_factor);
 
-  index->ScanAllKeys(locations);
-  EXPECT_EQ(locations.size(), 9 * num_threads);
-  locations.clear();
+    index->ScanAllKeys(locations);
+    EXPECT_EQ(locations.size(), 9 * num_threads);
+    locations.clear();
 
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> keynonce(
-      new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> keynonce(
+        new storage::Tuple(key_schema, true));
 
-  keynonce->SetValue(0, ValueFactory::GetIntegerValue(1000), pool);
-  keynonce->SetValue(1, ValueFactory::GetStringValue("f"), pool);
+    keynonce->SetValue(0, ValueFactory::GetIntegerValue(1000), pool);
+    keynonce->SetValue(1, ValueFactory::GetStringValue("f"), pool);
 
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
 
-  index->ScanKey(keynonce.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
+    index->ScanKey(keynonce.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
 
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), num_threads);
-  EXPECT_EQ(locations[0].block, item0.block);
-  locations.clear();
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), num_threads);
+    EXPECT_EQ(locations[0].block, item0.block);
+    locations.clear();
 
-  delete tuple_schema;
+    delete tuple_schema;
+  }
 }
 
 #ifdef ALLOW_UNIQUE_KEY
 TEST_F(IndexTests, UniqueKeyMultiThreadedTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(true));
-
-  // Parallel Test
-  size_t num_threads = 4;
-  size_t scale_factor = 1;
-  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
-  LaunchParallelTest(num_threads, DeleteTest, index.get(), pool, scale_factor);
-
-  // Checks
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
-
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
-  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
-  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
-
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key1.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key2.get(), locations);
-  EXPECT_EQ(locations.size(), 1);
-  EXPECT_EQ(locations[0].block, item1.block);
-  locations.clear();
-
-  index->ScanAllKeys(locations);
-  EXPECT_EQ(locations.size(), 1);
-  locations.clear();
-
-  // FORWARD SCAN
-  index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
-              SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-              {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
-              SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->Scan(
-      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
-      SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->Scan(
-      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-      {EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_EQUAL},
-      SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  delete tuple_schema;
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(true, index_type));
+
+    // Parallel Test
+    size_t num_threads = 4;
+    size_t scale_factor = 1;
+    LaunchParallelTest(num_threads, InsertTest, index.get(), pool,
+                       scale_factor);
+    LaunchParallelTest(num_threads, DeleteTest, index.get(), pool,
+                       scale_factor);
+
+    // Checks
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key1.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key2.get(), locations);
+    EXPECT_EQ(locations.size(), 1);
+    EXPECT_EQ(locations[0].block, item1.block);
+    locations.clear();
+
+    index->ScanAllKeys(locations);
+    EXPECT_EQ(locations.size(), 1);
+    locations.clear();
+
+    // FORWARD SCAN
+    index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+                {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->Scan(
+        {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+        {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
+        SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->Scan(
+        {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+        {EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_EQUAL},
+        SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    delete tuple_schema;
+  }
 }
 #endif
 
@@ -499,268 +515,282 @@ TEST_F(IndexTests, UniqueKeyMultiThreadedTest) {
 // no key4
 
 TEST_F(IndexTests, NonUniqueKeyMultiThreadedTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
-
-  // Parallel Test
-  size_t num_threads = 4;
-  size_t scale_factor = 1;
-  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
-  LaunchParallelTest(num_threads, DeleteTest, index.get(), pool, scale_factor);
-
-  // Checks
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key4(new storage::Tuple(key_schema, true));
-
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
-  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
-  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
-  key4->SetValue(0, ValueFactory::GetIntegerValue(500), pool);
-  key4->SetValue(1, ValueFactory::GetStringValue(
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
-                        "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"),
-                 pool);
-
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key1.get(), locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->ScanKey(key2.get(), locations);
-  EXPECT_EQ(locations.size(), 1 * num_threads);
-  EXPECT_EQ(locations[0].block, item1.block);
-  locations.clear();
-
-  index->ScanAllKeys(locations);
-  EXPECT_EQ(locations.size(), 3 * num_threads);
-  locations.clear();
-
-  // FORWARD SCAN
-  index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
-              SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 3 * num_threads);
-  locations.clear();
-
-  index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-              {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
-              SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->Scan(
-      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
-      SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 1 * num_threads);
-  locations.clear();
-
-  index->Scan(
-      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-      {EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_EQUAL},
-      SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->Scan({key2->GetValue(0), key2->GetValue(1)}, {0, 1},
-              {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_LESSTHAN},
-              SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->Scan(
-      {key0->GetValue(0), key0->GetValue(1), key2->GetValue(0),
-       key2->GetValue(1)},
-      {0, 1, 0, 1},
-      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN,
-       EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_LESSTHAN},
-      SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->Scan({key0->GetValue(0), key0->GetValue(1), key4->GetValue(0),
-               key4->GetValue(1)},
-              {0, 1, 0, 1}, {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
-                             EXPRESSION_TYPE_COMPARE_GREATERTHAN,
-                             EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
-                             EXPRESSION_TYPE_COMPARE_LESSTHAN},
-              SCAN_DIRECTION_TYPE_FORWARD, locations);
-  EXPECT_EQ(locations.size(), 3 * num_threads);
-  locations.clear();
-
-  // REVERSE SCAN
-  index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
-              SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 3 * num_threads);
-  locations.clear();
-
-  index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-              {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
-              SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->Scan(
-      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
-      SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 1 * num_threads);
-  locations.clear();
-
-  index->Scan(
-      {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
-      {EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_EQUAL},
-      SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->Scan({key2->GetValue(0), key2->GetValue(1)}, {0, 1},
-              {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_LESSTHAN},
-              SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->Scan(
-      {key0->GetValue(0), key0->GetValue(1), key2->GetValue(0),
-       key2->GetValue(1)},
-      {0, 1, 0, 1},
-      {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN,
-       EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_LESSTHAN},
-      SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->Scan({key0->GetValue(0), key0->GetValue(1), key4->GetValue(0),
-               key4->GetValue(1)},
-              {0, 1, 0, 1}, {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
-                             EXPRESSION_TYPE_COMPARE_GREATERTHAN,
-                             EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
-                             EXPRESSION_TYPE_COMPARE_LESSTHAN},
-              SCAN_DIRECTION_TYPE_BACKWARD, locations);
-  EXPECT_EQ(locations.size(), 3 * num_threads);
-  locations.clear();
-
-  delete tuple_schema;
-}
-
-TEST_F(IndexTests, NonUniqueKeyMultiThreadedStressTest) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
-
-  // Parallel Test
-  size_t num_threads = 4;
-  size_t scale_factor = 100;
-  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
-  LaunchParallelTest(num_threads, DeleteTest, index.get(), pool, scale_factor);
-
-  // Checks
-  std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
-
-  key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
-  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
-  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
-
-  index->ScanKey(key0.get(), locations);
-  EXPECT_EQ(locations.size(), 0);
-  locations.clear();
-
-  index->ScanKey(key1.get(), locations);
-  EXPECT_EQ(locations.size(), 2 * num_threads);
-  locations.clear();
-
-  index->ScanKey(key2.get(), locations);
-  EXPECT_EQ(locations.size(), 1 * num_threads);
-  EXPECT_EQ(locations[0].block, item1.block);
-  locations.clear();
-
-  index->ScanAllKeys(locations);
-  EXPECT_EQ(locations.size(), 3 * num_threads * scale_factor);
-  locations.clear();
-
-  delete tuple_schema;
-}
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+    // Parallel Test
+    size_t num_threads = 4;
+    size_t scale_factor = 1;
+    LaunchParallelTest(num_threads, InsertTest, index.get(), pool,
+                       scale_factor);
+    LaunchParallelTest(num_threads, DeleteTest, index.get(), pool,
+                       scale_factor);
+
+    // Checks
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key4(new storage::Tuple(key_schema, true));
 
-TEST_F(IndexTests, NonUniqueKeyMultiThreadedStressTest2) {
-  auto pool = TestingHarness::GetInstance().GetTestingPool();
-  std::vector<ItemPointer> locations;
-
-  // INDEX
-  std::unique_ptr<index::Index> index(BuildIndex(false));
-
-  // Parallel Test
-  size_t num_threads = 15;
-  size_t scale_factor = 30;
-  LaunchParallelTest(num_threads, InsertTest, index.get(), pool, scale_factor);
-  LaunchParallelTest(num_threads, DeleteTest, index.get(), pool, scale_factor);
-
-  index->ScanAllKeys(locations);
-  if (index->HasUniqueKeys())
-    EXPECT_EQ(locations.size(), scale_factor);
-  else
-    EXPECT_EQ(locations.size(), 3 * num_threads * scale_factor);
-  locations.clear();
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+    key4->SetValue(0, ValueFactory::GetIntegerValue(500), pool);
+    key4->SetValue(1, ValueFactory::GetStringValue(
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"
+                          "eeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeeee"),
+                   pool);
 
-  std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
-  std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
 
-  key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
-  key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
-  key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+    index->ScanKey(key1.get(), locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->ScanKey(key2.get(), locations);
+    EXPECT_EQ(locations.size(), 1 * num_threads);
+    EXPECT_EQ(locations[0].block, item1.block);
+    locations.clear();
+
+    index->ScanAllKeys(locations);
+    EXPECT_EQ(locations.size(), 3 * num_threads);
+    locations.clear();
+
+    // FORWARD SCAN
+    index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 3 * num_threads);
+    locations.clear();
+
+    index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+                {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->Scan(
+        {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+        {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
+        SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 1 * num_threads);
+    locations.clear();
+
+    index->Scan(
+        {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+        {EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_EQUAL},
+        SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
 
-  index->ScanKey(key1.get(), locations);
-  if (index->HasUniqueKeys()) {
+    index->Scan({key2->GetValue(0), key2->GetValue(1)}, {0, 1},
+                {EXPRESSION_TYPE_COMPARE_EQUAL,
+                 EXPRESSION_TYPE_COMPARE_LESSTHAN},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->Scan(
+        {key0->GetValue(0), key0->GetValue(1), key2->GetValue(0),
+         key2->GetValue(1)},
+        {0, 1, 0, 1},
+        {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+         EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_LESSTHAN},
+        SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->Scan({key0->GetValue(0), key0->GetValue(1), key4->GetValue(0),
+                 key4->GetValue(1)},
+                {0, 1, 0, 1}, {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                               EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                               EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                               EXPRESSION_TYPE_COMPARE_LESSTHAN},
+                SCAN_DIRECTION_TYPE_FORWARD, locations);
+    EXPECT_EQ(locations.size(), 3 * num_threads);
+    locations.clear();
+
+    // REVERSE SCAN
+    index->Scan({key1->GetValue(0)}, {0}, {EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_BACKWARD, locations);
+    EXPECT_EQ(locations.size(), 3 * num_threads);
+    locations.clear();
+
+    index->Scan({key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+                {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_EQUAL},
+                SCAN_DIRECTION_TYPE_BACKWARD, locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->Scan(
+        {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+        {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN},
+        SCAN_DIRECTION_TYPE_BACKWARD, locations);
+    EXPECT_EQ(locations.size(), 1 * num_threads);
+    locations.clear();
+
+    index->Scan(
+        {key1->GetValue(0), key1->GetValue(1)}, {0, 1},
+        {EXPRESSION_TYPE_COMPARE_GREATERTHAN, EXPRESSION_TYPE_COMPARE_EQUAL},
+        SCAN_DIRECTION_TYPE_BACKWARD, locations);
     EXPECT_EQ(locations.size(), 0);
-  } else {
+    locations.clear();
+
+    index->Scan({key2->GetValue(0), key2->GetValue(1)}, {0, 1},
+                {EXPRESSION_TYPE_COMPARE_EQUAL,
+                 EXPRESSION_TYPE_COMPARE_LESSTHAN},
+                SCAN_DIRECTION_TYPE_BACKWARD, locations);
     EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->Scan(
+        {key0->GetValue(0), key0->GetValue(1), key2->GetValue(0),
+         key2->GetValue(1)},
+        {0, 1, 0, 1},
+        {EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+         EXPRESSION_TYPE_COMPARE_EQUAL, EXPRESSION_TYPE_COMPARE_LESSTHAN},
+        SCAN_DIRECTION_TYPE_BACKWARD, locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->Scan({key0->GetValue(0), key0->GetValue(1), key4->GetValue(0),
+                 key4->GetValue(1)},
+                {0, 1, 0, 1}, {EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+                               EXPRESSION_TYPE_COMPARE_GREATERTHAN,
+                               EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO,
+                               EXPRESSION_TYPE_COMPARE_LESSTHAN},
+                SCAN_DIRECTION_TYPE_BACKWARD, locations);
+    EXPECT_EQ(locations.size(), 3 * num_threads);
+    locations.clear();
+
+    delete tuple_schema;
   }
-  locations.clear();
+}
 
-  index->ScanKey(key2.get(), locations);
-  if (index->HasUniqueKeys()) {
-    EXPECT_EQ(locations.size(), num_threads);
-  } else {
-    EXPECT_EQ(locations.size(), num_threads);
+TEST_F(IndexTests, NonUniqueKeyMultiThreadedStressTest) {
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+    // Parallel Test
+    size_t num_threads = 4;
+    size_t scale_factor = 100;
+    LaunchParallelTest(num_threads, InsertTest, index.get(), pool,
+                       scale_factor);
+    LaunchParallelTest(num_threads, DeleteTest, index.get(), pool,
+                       scale_factor);
+
+    // Checks
+    std::unique_ptr<storage::Tuple> key0(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
+
+    key0->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key0->SetValue(1, ValueFactory::GetStringValue("a"), pool);
+    key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+    index->ScanKey(key0.get(), locations);
+    EXPECT_EQ(locations.size(), 0);
+    locations.clear();
+
+    index->ScanKey(key1.get(), locations);
+    EXPECT_EQ(locations.size(), 2 * num_threads);
+    locations.clear();
+
+    index->ScanKey(key2.get(), locations);
+    EXPECT_EQ(locations.size(), 1 * num_threads);
+    EXPECT_EQ(locations[0].block, item1.block);
+    locations.clear();
+
+    index->ScanAllKeys(locations);
+    EXPECT_EQ(locations.size(), 3 * num_threads * scale_factor);
+    locations.clear();
+
+    delete tuple_schema;
   }
-  locations.clear();
+}
+
+TEST_F(IndexTests, NonUniqueKeyMultiThreadedStressTest2) {
+  for (auto index_type : index_types) {
+    auto pool = TestingHarness::GetInstance().GetTestingPool();
+    std::vector<ItemPointer> locations;
+
+    // INDEX
+    std::unique_ptr<index::Index> index(BuildIndex(false, index_type));
+
+    // Parallel Test
+    size_t num_threads = 15;
+    size_t scale_factor = 30;
+    LaunchParallelTest(num_threads, InsertTest, index.get(), pool,
+                       scale_factor);
+    LaunchParallelTest(num_threads, DeleteTest, index.get(), pool,
+                       scale_factor);
+
+    index->ScanAllKeys(locations);
+    if (index->HasUniqueKeys())
+      EXPECT_EQ(locations.size(), scale_factor);
+    else
+      EXPECT_EQ(locations.size(), 3 * num_threads * scale_factor);
+    locations.clear();
+
+    std::unique_ptr<storage::Tuple> key1(new storage::Tuple(key_schema, true));
+    std::unique_ptr<storage::Tuple> key2(new storage::Tuple(key_schema, true));
 
-  delete tuple_schema;
+    key1->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key1->SetValue(1, ValueFactory::GetStringValue("b"), pool);
+    key2->SetValue(0, ValueFactory::GetIntegerValue(100), pool);
+    key2->SetValue(1, ValueFactory::GetStringValue("c"), pool);
+
+    index->ScanKey(key1.get(), locations);
+    if (index->HasUniqueKeys()) {
+      EXPECT_EQ(locations.size(), 0);
+    } else {
+      EXPECT_EQ(locations.size(), 2 * num_threads);
+    }
+    locations.clear();
+
+    index->ScanKey(key2.get(), locations);
+    if (index->HasUniqueKeys()) {
+      EXPECT_EQ(locations.size(), num_threads);
+    } else {
+      EXPECT_EQ(locations.size(), num_threads);
+    }
+    locations.clear();
+
+    delete tuple_schema;
+  }
 }
 
 }  // End test namespace
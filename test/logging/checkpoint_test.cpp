@@ -11,14 +11,25 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <random>
+#include <set>
+
 #include "common/harness.h"
 #include "logging/checkpoint.h"
 #include "logging/logging_util.h"
 #include "logging/loggers/wal_backend_logger.h"
 #include "logging/checkpoint/simple_checkpoint.h"
+#include "logging/checkpoint/fuzzy_checkpoint.h"
+#include "logging/checkpoint/block_compressor.h"
 #include "logging/checkpoint_manager.h"
 #include "storage/database.h"
 
+#include "common/value_factory.h"
+#include "common/value_peeker.h"
+#include "concurrency/epoch_manager.h"
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/logical_tile_factory.h"
 #include "index/index.h"
@@ -243,5 +254,172 @@ TEST_F(CheckpointTests, CheckpointModeTransitionTest) {
   thread.join();
 }
 
+TEST_F(CheckpointTests, BlockCompressorTest) {
+  std::string text;
+  for (int itr = 0; itr < 1000; itr++) {
+    text += "tuple " + std::to_string(itr % 50) + ";";
+  }
+
+  std::vector<char> compressed(
+      logging::BlockCompressor::GetMaxCompressedSize(text.size()));
+  auto compressed_size = logging::BlockCompressor::Compress(
+      text.data(), text.size(), compressed.data(), compressed.size());
+  EXPECT_GT(compressed_size, 0);
+  EXPECT_LT(compressed_size, text.size() / 4);
+
+  std::string restored(text.size(), '\0');
+  EXPECT_TRUE(logging::BlockCompressor::Decompress(
+      compressed.data(), compressed_size, &restored[0], restored.size()));
+  EXPECT_EQ(text, restored);
+
+  // Truncated blocks and wrong sizes are rejected
+  EXPECT_FALSE(logging::BlockCompressor::Decompress(
+      compressed.data(), compressed_size - 1, &restored[0], restored.size()));
+  EXPECT_FALSE(logging::BlockCompressor::Decompress(
+      compressed.data(), compressed_size, &restored[0], restored.size() - 1));
+
+  // Incompressible data survives as literals
+  std::mt19937 generator(7);
+  std::vector<char> random_data(10000);
+  for (auto &byte : random_data) {
+    byte = static_cast<char>(generator());
+  }
+  compressed.resize(
+      logging::BlockCompressor::GetMaxCompressedSize(random_data.size()));
+  compressed_size = logging::BlockCompressor::Compress(
+      random_data.data(), random_data.size(), compressed.data(),
+      compressed.size());
+  std::vector<char> restored_data(random_data.size());
+  EXPECT_TRUE(logging::BlockCompressor::Decompress(
+      compressed.data(), compressed_size, restored_data.data(),
+      restored_data.size()));
+  EXPECT_EQ(random_data, restored_data);
+}
+
+namespace {
+
+// Sets the raw size in the first block header of a data file to the largest
+// value, the header holds six ints after which the block follows
+void CorruptFirstBlockHeader(const std::string &checkpoint_dir) {
+  auto dirp = opendir(checkpoint_dir.c_str());
+  ASSERT_TRUE(dirp != nullptr);
+  std::string data_file;
+  struct dirent *file;
+  while ((file = readdir(dirp)) != NULL) {
+    std::string name(file->d_name);
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".data") == 0) {
+      auto file_name = checkpoint_dir + "/" + name;
+      struct stat file_stat;
+      if (stat(file_name.c_str(), &file_stat) == 0 && file_stat.st_size > 0) {
+        data_file = file_name;
+        break;
+      }
+    }
+  }
+  closedir(dirp);
+  ASSERT_FALSE(data_file.empty());
+
+  FILE *fp = fopen(data_file.c_str(), "r+b");
+  ASSERT_TRUE(fp != nullptr);
+  unsigned char raw_size[4] = {0x7f, 0xff, 0xff, 0xff};
+  fseek(fp, 4 * sizeof(int32_t), SEEK_SET);
+  fwrite(raw_size, 1, sizeof(raw_size), fp);
+  fclose(fp);
+}
+
+}  // namespace
+
+TEST_F(CheckpointTests, FuzzyCheckpointTest) {
+  logging::LoggingUtil::RemoveDirectory("pl_checkpoint", false);
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+
+  size_t tile_group_size = TESTS_TUPLES_PER_TILEGROUP;
+  size_t table_tile_group_count = 3;
+  size_t tuple_count = tile_group_size * table_tile_group_count;
+
+  oid_t default_table_oid = 14;
+  storage::DataTable *target_table =
+      ExecutorTestsUtil::CreateTable(tile_group_size, true, default_table_oid);
+  ExecutorTestsUtil::PopulateTable(target_table, tuple_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  auto &catalog_manager = catalog::Manager::GetInstance();
+  storage::Database *db(new storage::Database(DEFAULT_DB_ID));
+  db->AddTable(target_table);
+  catalog_manager.AddDatabase(db);
+
+  // The snapshot holds the load once its txn is dead
+  peloton_checkpoint_thread_count = 4;
+  logging::FuzzyCheckpoint checkpoint(false);
+  for (int attempt = 0; attempt < 100; attempt++) {
+    txn_manager.BeginTransaction();
+    txn_manager.CommitTransaction();
+    checkpoint.DoCheckpoint();
+    if (checkpoint.GetCheckpointTupleCount() == tuple_count) break;
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
+  }
+  EXPECT_EQ(tuple_count, checkpoint.GetCheckpointTupleCount());
+  auto checkpoint_cid = checkpoint.GetMostRecentCheckpointCid();
+  EXPECT_NE(INVALID_CID, checkpoint_cid);
+
+  // Restart with an empty table and recover from the newest manifest
+  catalog_manager.DropDatabaseWithOid(DEFAULT_DB_ID);
+  target_table =
+      ExecutorTestsUtil::CreateTable(tile_group_size, true, default_table_oid);
+  db = new storage::Database(DEFAULT_DB_ID);
+  db->AddTable(target_table);
+  catalog_manager.AddDatabase(db);
+
+  logging::FuzzyCheckpoint recovery_checkpoint(false);
+  EXPECT_EQ(checkpoint_cid, recovery_checkpoint.DoRecovery());
+
+  // along with the default tile group of the new table
+  EXPECT_EQ(tuple_count, target_table->GetNumberOfTuples());
+  EXPECT_EQ(table_tile_group_count + 1, target_table->GetTileGroupCount());
+
+  // Every tuple is back in its slot
+  std::set<int> recovered_rows;
+  for (oid_t tile_group_offset = 0;
+       tile_group_offset < target_table->GetTileGroupCount();
+       tile_group_offset++) {
+    auto tile_group = target_table->GetTileGroup(tile_group_offset);
+    auto slot_count = tile_group->GetHeader()->GetCurrentNextTupleSlot();
+    for (oid_t tuple_id = 0; tuple_id < slot_count; tuple_id++) {
+      int row = ValuePeeker::PeekInteger(tile_group->GetValue(tuple_id, 0)) /
+                10;
+      EXPECT_TRUE(tile_group->GetValue(tuple_id, 3)
+                      .OpEquals(ValueFactory::GetStringValue(std::to_string(
+                          ExecutorTestsUtil::PopulatedValue(row, 3))))
+                      .IsTrue());
+      recovered_rows.insert(row);
+    }
+  }
+  EXPECT_EQ(tuple_count, recovered_rows.size());
+
+  // A corrupt raw size in a block header fails the recovery, the cids stay
+  auto &checkpoint_manager = logging::CheckpointManager::GetInstance();
+  checkpoint_manager.SetRecoveredCid(INVALID_CID);
+  CorruptFirstBlockHeader("pl_checkpoint");
+
+  catalog_manager.DropDatabaseWithOid(DEFAULT_DB_ID);
+  target_table =
+      ExecutorTestsUtil::CreateTable(tile_group_size, true, default_table_oid);
+  db = new storage::Database(DEFAULT_DB_ID);
+  db->AddTable(target_table);
+  catalog_manager.AddDatabase(db);
+
+  logging::FuzzyCheckpoint corrupt_checkpoint(false);
+  EXPECT_EQ(INVALID_CID, corrupt_checkpoint.DoRecovery());
+  EXPECT_TRUE(checkpoint_manager.IsRecoveryFailed());
+  EXPECT_EQ(INVALID_CID, checkpoint_manager.GetRecoveredCid());
+  checkpoint_manager.SetRecoveryFailed(false);
+
+  peloton_checkpoint_thread_count = 0;
+  catalog_manager.DropDatabaseWithOid(db->GetOid());
+  logging::LoggingUtil::RemoveDirectory("pl_checkpoint", false);
+}
+
 }  // End test namespace
 }  // End peloton namespace
@@ -0,0 +1,175 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// log_segment_writer_test.cpp
+//
+// Identification: test/logging/log_segment_writer_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <sys/stat.h>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "logging/log_segment_writer.h"
+#include "logging/logging_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Log Segment Writer Tests
+//===--------------------------------------------------------------------===//
+
+class LogSegmentWriterTests : public PelotonTest {};
+
+static std::string ReadFile(const std::string &file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST_F(LogSegmentWriterTests, BasicSegmentWriterTest) {
+  const size_t segment_size = 16 * logging::LogSegmentWriter::block_size;
+  std::string dir_name = "segment_writer_test_dir";
+  std::string file_name = dir_name + "/segment_0.log";
+  std::string recycled_file_name = dir_name + "/segment_1.log";
+
+  auto status = logging::LoggingUtil::CreateDirectory(dir_name.c_str(), 0700);
+  EXPECT_TRUE(status);
+
+  logging::LogSegmentWriter writer(segment_size);
+  EXPECT_TRUE(writer.Open(file_name, "", 0));
+
+  // The segment is preallocated
+  struct stat file_stats;
+  stat(file_name.c_str(), &file_stats);
+  EXPECT_EQ(segment_size, (size_t)file_stats.st_size);
+  EXPECT_EQ(logging::LogSegmentWriter::header_size, writer.GetWriteOffset());
+
+  // Records span block boundaries, the last block is rewritten by every sync
+  std::string records;
+  for (int record_itr = 0; record_itr < 1000; record_itr++) {
+    std::string record = "record_" + std::to_string(record_itr);
+    records += record;
+    writer.Append(record.c_str(), record.size());
+
+    if (record_itr % 100 == 0) {
+      EXPECT_TRUE(writer.Sync());
+    }
+  }
+  EXPECT_TRUE(writer.Sync());
+  EXPECT_TRUE(writer.WriteHeader(42, 41));
+  writer.Close();
+
+  auto contents = ReadFile(file_name);
+  cid_t max_log_id, max_delimiter;
+  memcpy(&max_log_id, contents.data(), sizeof(max_log_id));
+  memcpy(&max_delimiter, contents.data() + sizeof(max_log_id),
+         sizeof(max_delimiter));
+  EXPECT_EQ(42, (int)max_log_id);
+  EXPECT_EQ(41, (int)max_delimiter);
+
+  // The records are followed by zero padding
+  auto header_size = logging::LogSegmentWriter::header_size;
+  EXPECT_EQ(records, contents.substr(header_size, records.size()));
+  EXPECT_EQ('\0', contents[header_size + records.size()]);
+
+  // A recycled segment starts over with an empty header
+  EXPECT_EQ(0, rename(file_name.c_str(), recycled_file_name.c_str()));
+  EXPECT_TRUE(writer.Open(file_name, recycled_file_name, 1));
+  std::string record = "fresh";
+  writer.Append(record.c_str(), record.size());
+  writer.Close();
+
+  contents = ReadFile(file_name);
+  EXPECT_EQ(std::string(header_size, '\0'), contents.substr(0, header_size));
+  EXPECT_EQ(record, contents.substr(header_size, record.size()));
+  EXPECT_EQ('\0', contents[header_size + record.size()]);
+
+  EXPECT_LT(0, (int)writer.GetSyncCount());
+
+  status = logging::LoggingUtil::RemoveDirectory(dir_name.c_str(), false);
+  EXPECT_TRUE(status);
+}
+
+// Lengths of the frames of a segment, up to the first one that is rejected
+static std::vector<uint32_t> ReadFrames(const std::string &file_name,
+                                        uint32_t generation) {
+  FILE *file = fopen(file_name.c_str(), "rb");
+  struct stat file_stats;
+  fstat(fileno(file), &file_stats);
+  FileHandle file_handle(file, fileno(file), file_stats.st_size);
+  fseek(file, logging::LogSegmentWriter::header_size, SEEK_SET);
+
+  std::vector<uint32_t> frame_lengths;
+  size_t frame_end = 0;
+  while (logging::LoggingUtil::ReadSegmentFrame(file_handle, generation,
+                                                frame_end)) {
+    frame_lengths.push_back(frame_end - ftell(file));
+    fseek(file, frame_end, SEEK_SET);
+  }
+
+  fclose(file);
+  return frame_lengths;
+}
+
+TEST_F(LogSegmentWriterTests, RecycledSegmentTest) {
+  const size_t segment_size = 16 * logging::LogSegmentWriter::block_size;
+  std::string dir_name = "segment_writer_test_dir";
+  std::string file_name = dir_name + "/segment_0.log";
+  std::string recycled_file_name = dir_name + "/segment_1.log";
+
+  auto status = logging::LoggingUtil::CreateDirectory(dir_name.c_str(), 0700);
+  EXPECT_TRUE(status);
+
+  // Generation 0 fills a few blocks with frames of the same size
+  std::string records(1000, 'a');
+  logging::LogSegmentWriter writer(segment_size);
+  EXPECT_TRUE(writer.Open(file_name, "", 0));
+  for (int frame_itr = 0; frame_itr < 10; frame_itr++) {
+    writer.AppendFrame(records.c_str(), records.size());
+  }
+  writer.Close();
+  EXPECT_EQ(10, (int)ReadFrames(file_name, 0).size());
+  auto old_contents = ReadFile(file_name);
+
+  // Generation 1 ends at the zero padding after its only frame
+  EXPECT_EQ(0, rename(file_name.c_str(), recycled_file_name.c_str()));
+  EXPECT_TRUE(writer.Open(file_name, recycled_file_name, 1));
+  std::string fresh_records(1000, 'b');
+  writer.AppendFrame(fresh_records.c_str(), fresh_records.size());
+  writer.Close();
+  EXPECT_EQ(std::vector<uint32_t>{1000}, ReadFrames(file_name, 1));
+
+  // A torn write leaves the frames of generation 0 right after it
+  size_t frame_end = logging::LogSegmentWriter::header_size +
+                     logging::LogSegmentWriter::frame_header_size + 1000;
+  FILE *file = fopen(file_name.c_str(), "rb+");
+  fseek(file, frame_end, SEEK_SET);
+  fwrite(old_contents.data() + frame_end, 1, old_contents.size() - frame_end,
+         file);
+  fclose(file);
+  EXPECT_EQ(std::vector<uint32_t>{1000}, ReadFrames(file_name, 1));
+
+  // So does a torn frame, its checksum does not match
+  file = fopen(file_name.c_str(), "rb+");
+  fseek(file, frame_end - 10, SEEK_SET);
+  fwrite(old_contents.data() + frame_end - 10, 1, 10, file);
+  fclose(file);
+  EXPECT_TRUE(ReadFrames(file_name, 1).empty());
+
+  status = logging::LoggingUtil::RemoveDirectory(dir_name.c_str(), false);
+  EXPECT_TRUE(status);
+}
+
+}  // End test namespace
+}  // End peloton namespace
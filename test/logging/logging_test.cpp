@@ -319,6 +319,57 @@ TEST_F(LoggingTests, InsertUpdateDeleteTest) {
   scheduler.Cleanup();
 }
 
+TEST_F(LoggingTests, GroupCommitTest) {
+  auto &log_manager = logging::LogManager::GetInstance();
+  log_manager.Configure(LOGGING_TYPE_NVM_WAL, true);
+  log_manager.SetLoggingStatus(LOGGING_STATUS_TYPE_LOGGING);
+  log_manager.InitFrontendLoggers();
+
+  auto frontend_logger = reinterpret_cast<logging::WriteAheadFrontendLogger *>(
+      log_manager.GetFrontendLogger(0));
+
+  // Groups of four commits, the delay alone never closes a group
+  frontend_logger->SetGroupCommitPolicy(std::chrono::hours(1), 4);
+
+  // The backend logger is thread local, keep it off the main thread
+  std::thread backend_thread([&] {
+    auto backend_logger = log_manager.GetBackendLogger();
+
+    for (cid_t commit_id = 1; commit_id <= 4; commit_id++) {
+      logging::TransactionRecord record(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                        commit_id);
+      backend_logger->Log(&record);
+      frontend_logger->CollectLogRecordsFromBackendLoggers();
+      frontend_logger->FlushLogRecords();
+
+      if (commit_id < 4) {
+        EXPECT_EQ(0, frontend_logger->GetMaxFlushedCommitId());
+        EXPECT_EQ(commit_id, frontend_logger->GetPendingCommitCount());
+      }
+    }
+
+    // The whole group is flushed at once
+    EXPECT_EQ(4, frontend_logger->GetMaxFlushedCommitId());
+    EXPECT_EQ(0, frontend_logger->GetPendingCommitCount());
+
+    // Committers of the group are past the watermark
+    log_manager.WaitForFlush(4);
+
+    // Without a delay every commit is a group
+    frontend_logger->SetGroupCommitPolicy(logging::Micros(0), 0);
+    logging::TransactionRecord record(LOGRECORD_TYPE_TRANSACTION_COMMIT, 5);
+    backend_logger->Log(&record);
+    frontend_logger->CollectLogRecordsFromBackendLoggers();
+    frontend_logger->FlushLogRecords();
+    EXPECT_EQ(5, frontend_logger->GetMaxFlushedCommitId());
+
+    log_manager.WaitForFlush(5);
+  });
+  backend_thread.join();
+
+  log_manager.ResetFrontendLoggers();
+}
+
 TEST_F(LoggingTests, BasicLogManagerTest) {
   peloton_logging_mode = LOGGING_TYPE_INVALID;
   auto &log_manager = logging::LogManager::GetInstance();
@@ -17,6 +17,7 @@
 #include <dirent.h>
 
 #include "common/harness.h"
+#include "common/timer.h"
 
 #include "concurrency/transaction_manager_factory.h"
 #include "executor/logical_tile_factory.h"
@@ -36,6 +37,10 @@
 
 #define DEFAULT_RECOVERY_CID 15
 
+// Txns of the parallel recovery test, every txn logs about 1 KB (raise it
+// to a few million to replay a multi-GB log)
+#define PARALLEL_RECOVERY_TXN_COUNT 2000
+
 using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::InSequence;
@@ -98,6 +103,24 @@ std::vector<storage::Tuple *> BuildLoggingTuples(storage::DataTable *table,
   return tuples;
 }
 
+// Log files hold frames of records, stamped with the log number of the file
+static void WriteLogFrame(FILE *fp, const char *data, size_t len,
+                          uint32_t generation) {
+  char frame_header[logging::LogSegmentWriter::frame_header_size];
+  logging::LogSegmentWriter::BuildFrameHeader(frame_header, generation, data,
+                                              len);
+  fwrite(frame_header, sizeof(char), sizeof(frame_header), fp);
+  fwrite(data, sizeof(char), len, fp);
+}
+
+static void WriteLogRecord(FILE *fp, logging::LogRecord &record,
+                           uint32_t generation = 0) {
+  CopySerializeOutput output_buffer;
+  record.Serialize(output_buffer);
+  WriteLogFrame(fp, record.GetMessage(), record.GetMessageLength(),
+                generation);
+}
+
 TEST_F(RecoveryTests, RestartTest) {
   auto recovery_table = ExecutorTestsUtil::CreateTable(1024);
   auto &manager = catalog::Manager::GetInstance();
@@ -151,8 +174,8 @@ TEST_F(RecoveryTests, RestartTest) {
                                             i + 2);
     record_begin.Serialize(output_buffer_begin);
 
-    fwrite(record_begin.GetMessage(), sizeof(char),
-           record_begin.GetMessageLength(), fp);
+    WriteLogFrame(fp, record_begin.GetMessage(),
+                  record_begin.GetMessageLength(), i);
 
     // Now write 5 insert tuple records into this file
     for (int j = 0; j < (int)tile_group_size; j++) {
@@ -160,8 +183,8 @@ TEST_F(RecoveryTests, RestartTest) {
       CopySerializeOutput output_buffer;
       records[num_record].Serialize(output_buffer);
 
-      fwrite(records[num_record].GetMessage(), sizeof(char),
-             records[num_record].GetMessageLength(), fp);
+      WriteLogFrame(fp, records[num_record].GetMessage(),
+                    records[num_record].GetMessageLength(), i);
     }
 
     // Now write 1 extra out of range tuple, only in file 0, which
@@ -170,8 +193,9 @@ TEST_F(RecoveryTests, RestartTest) {
       CopySerializeOutput output_buffer_extra;
       records[num_files * tile_group_size].Serialize(output_buffer_extra);
 
-      fwrite(records[num_files * tile_group_size].GetMessage(), sizeof(char),
-             records[num_files * tile_group_size].GetMessageLength(), fp);
+      WriteLogFrame(fp, records[num_files * tile_group_size].GetMessage(),
+                    records[num_files * tile_group_size].GetMessageLength(),
+                    i);
     }
 
     // Now write 1 extra delete tuple, only in the last file, which
@@ -180,9 +204,9 @@ TEST_F(RecoveryTests, RestartTest) {
       CopySerializeOutput output_buffer_delete;
       records[num_files * tile_group_size + 1].Serialize(output_buffer_delete);
 
-      fwrite(records[num_files * tile_group_size + 1].GetMessage(),
-             sizeof(char),
-             records[num_files * tile_group_size + 1].GetMessageLength(), fp);
+      WriteLogFrame(
+          fp, records[num_files * tile_group_size + 1].GetMessage(),
+          records[num_files * tile_group_size + 1].GetMessageLength(), i);
     }
 
     // Now write commit
@@ -192,8 +216,8 @@ TEST_F(RecoveryTests, RestartTest) {
     CopySerializeOutput output_buffer_commit;
     record_commit.Serialize(output_buffer_commit);
 
-    fwrite(record_commit.GetMessage(), sizeof(char),
-           record_commit.GetMessageLength(), fp);
+    WriteLogFrame(fp, record_commit.GetMessage(),
+                  record_commit.GetMessageLength(), i);
 
     // Now write delimiter
     CopySerializeOutput output_buffer_delim;
@@ -202,8 +226,8 @@ TEST_F(RecoveryTests, RestartTest) {
 
     record_delim.Serialize(output_buffer_delim);
 
-    fwrite(record_delim.GetMessage(), sizeof(char),
-           record_delim.GetMessageLength(), fp);
+    WriteLogFrame(fp, record_delim.GetMessage(),
+                  record_delim.GetMessageLength(), i);
 
     fclose(fp);
   }
@@ -421,5 +445,230 @@ TEST_F(RecoveryTests, OutOfOrderCommitTest) {
   EXPECT_EQ(recovery_table->GetTileGroupCount(), 2);
 }
 
+TEST_F(RecoveryTests, ParallelRecoveryTest) {
+  size_t tile_group_size = 100;
+  auto recovery_table = ExecutorTestsUtil::CreateTable(tile_group_size);
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database db(DEFAULT_DB_ID);
+  manager.AddDatabase(&db);
+  db.AddTable(recovery_table);
+
+  // Every txn inserts, then updates or deletes, txn_size tuples
+  size_t txn_size = 10;
+  size_t txn_count = PARALLEL_RECOVERY_TXN_COUNT;
+  size_t tuple_count = txn_count * txn_size;
+  size_t update_count = tuple_count / 2;
+  size_t delete_count = tuple_count / 4;
+  oid_t first_block = 1000;
+  auto table_oid = recovery_table->GetOid();
+
+  auto tuples =
+      LoggingTestsUtil::BuildTuples(recovery_table, tuple_count, false, false);
+  auto location = [=](size_t tuple_itr) {
+    return ItemPointer(first_block + tuple_itr / tile_group_size,
+                       tuple_itr % tile_group_size);
+  };
+
+  std::string dir_name = logging::WriteAheadFrontendLogger::wal_directory_path;
+  logging::LoggingUtil::RemoveDirectory(dir_name.c_str(), false);
+  auto status = logging::LoggingUtil::CreateDirectory(dir_name.c_str(), 0700);
+  EXPECT_EQ(status, true);
+  logging::LogManager::GetInstance().SetLogDirectoryName("./");
+
+  std::string file_name = dir_name + "/peloton_log_0.log";
+  FILE *fp = fopen(file_name.c_str(), "wb");
+  cid_t default_commit_id = INVALID_CID;
+  cid_t default_delimiter = INVALID_CID;
+  fwrite((void *)&default_commit_id, sizeof(default_commit_id), 1, fp);
+  fwrite((void *)&default_delimiter, sizeof(default_delimiter), 1, fp);
+
+  // Inserts first, then updates of the first half of the tuples into new
+  // slots, then deletes of the next quarter
+  cid_t commit_id = 2;
+  std::vector<cid_t> update_cids(update_count), delete_cids(delete_count);
+  for (size_t txn_itr = 0; txn_itr < 3 * txn_count; txn_itr++, commit_id++) {
+    logging::TransactionRecord begin_record(LOGRECORD_TYPE_TRANSACTION_BEGIN,
+                                            commit_id);
+    WriteLogRecord(fp, begin_record);
+
+    for (size_t op_itr = 0; op_itr < txn_size; op_itr++) {
+      size_t tuple_itr = (txn_itr % txn_count) * txn_size + op_itr;
+      if (txn_itr < txn_count) {
+        logging::TupleRecord record(LOGRECORD_TYPE_WAL_TUPLE_INSERT,
+                                    commit_id, table_oid, location(tuple_itr),
+                                    INVALID_ITEMPOINTER,
+                                    tuples[tuple_itr].get(), DEFAULT_DB_ID);
+        WriteLogRecord(fp, record);
+      } else if (txn_itr < 2 * txn_count && tuple_itr < update_count) {
+        logging::TupleRecord record(
+            LOGRECORD_TYPE_WAL_TUPLE_UPDATE, commit_id, table_oid,
+            location(tuple_count + tuple_itr), location(tuple_itr),
+            tuples[tuple_itr].get(), DEFAULT_DB_ID);
+        WriteLogRecord(fp, record);
+        update_cids[tuple_itr] = commit_id;
+      } else if (txn_itr >= 2 * txn_count && tuple_itr >= update_count &&
+                 tuple_itr < update_count + delete_count) {
+        logging::TupleRecord record(LOGRECORD_TYPE_WAL_TUPLE_DELETE,
+                                    commit_id, table_oid, INVALID_ITEMPOINTER,
+                                    location(tuple_itr), nullptr,
+                                    DEFAULT_DB_ID);
+        WriteLogRecord(fp, record);
+        delete_cids[tuple_itr - update_count] = commit_id;
+      }
+    }
+
+    logging::TransactionRecord commit_record(
+        LOGRECORD_TYPE_TRANSACTION_COMMIT, commit_id);
+    WriteLogRecord(fp, commit_record);
+  }
+  cid_t last_commit_id = commit_id - 1;
+  logging::TransactionRecord delimiter_record(
+      LOGRECORD_TYPE_ITERATION_DELIMITER, last_commit_id);
+  WriteLogRecord(fp, delimiter_record);
+  LOG_INFO("Wrote %ld bytes of log", ftell(fp));
+  fclose(fp);
+
+  peloton_recovery_thread_count = 4;
+  logging::WriteAheadFrontendLogger wal_fel;
+  logging::LogManager::GetInstance().SetGlobalMaxFlushedIdForRecovery(
+      last_commit_id);
+
+  Timer<std::milli> timer;
+  timer.Start();
+  wal_fel.DoRecovery();
+  timer.Stop();
+  LOG_INFO("Replayed the log in %.2lf ms", timer.GetDuration());
+
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(), tuple_count - delete_count);
+
+  for (size_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto old_location = location(tuple_itr);
+    auto tile_group = manager.GetTileGroup(old_location.block);
+    ASSERT_TRUE(tile_group != nullptr);
+    auto header = tile_group->GetHeader();
+
+    if (tuple_itr < update_count) {
+      auto new_location = location(tuple_count + tuple_itr);
+      EXPECT_EQ(update_cids[tuple_itr],
+                header->GetEndCommitId(old_location.offset));
+      EXPECT_EQ(new_location.block,
+                header->GetNextItemPointer(old_location.offset).block);
+
+      auto new_tile_group = manager.GetTileGroup(new_location.block);
+      ASSERT_TRUE(new_tile_group != nullptr);
+      EXPECT_EQ(update_cids[tuple_itr],
+                new_tile_group->GetHeader()->GetBeginCommitId(
+                    new_location.offset));
+      EXPECT_TRUE(tuples[tuple_itr]->GetValue(0).Compare(
+                      new_tile_group->GetValue(new_location.offset, 0)) == 0);
+    } else if (tuple_itr < update_count + delete_count) {
+      EXPECT_EQ(delete_cids[tuple_itr - update_count],
+                header->GetEndCommitId(old_location.offset));
+    } else {
+      EXPECT_EQ(MAX_CID, header->GetEndCommitId(old_location.offset));
+      EXPECT_TRUE(tuples[tuple_itr]->GetValue(3).Compare(
+                      tile_group->GetValue(old_location.offset, 3)) == 0);
+    }
+  }
+
+  // Every index is rebuilt by a recovery thread of its own
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.SetNextCid(last_commit_id + 1);
+  timer.Reset();
+  timer.Start();
+  wal_fel.RecoverIndex();
+  timer.Stop();
+  LOG_INFO("Rebuilt the indexes in %.2lf ms", timer.GetDuration());
+
+  for (oid_t index_itr = 0; index_itr < recovery_table->GetIndexCount();
+       index_itr++) {
+    auto index = recovery_table->GetIndex(index_itr);
+    EXPECT_EQ(index->GetNumberOfTuples(), tuple_count - delete_count);
+  }
+
+  peloton_recovery_thread_count = 0;
+  status = logging::LoggingUtil::RemoveDirectory(dir_name.c_str(), false);
+  EXPECT_EQ(status, true);
+}
+
+static void AppendLogRecord(std::string &log, logging::LogRecord &record) {
+  CopySerializeOutput output_buffer;
+  record.Serialize(output_buffer);
+  log.append(record.GetMessage(), record.GetMessageLength());
+}
+
+TEST_F(RecoveryTests, StandbyReplayTest) {
+  auto recovery_table = ExecutorTestsUtil::CreateTable(1024);
+  auto &manager = catalog::Manager::GetInstance();
+  storage::Database db(DEFAULT_DB_ID);
+  manager.AddDatabase(&db);
+  db.AddTable(recovery_table);
+
+  auto tuples = BuildLoggingTuples(recovery_table, 3, false, false);
+  auto table_oid = recovery_table->GetOid();
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.ResetStates();
+
+  logging::WriteAheadFrontendLogger fel(true);
+
+  // Txn 2 spans both buffers
+  std::string first_buffer;
+  logging::TransactionRecord begin_record(LOGRECORD_TYPE_TRANSACTION_BEGIN, 2);
+  AppendLogRecord(first_buffer, begin_record);
+  for (oid_t tuple_itr = 0; tuple_itr < 2; tuple_itr++) {
+    logging::TupleRecord record(LOGRECORD_TYPE_WAL_TUPLE_INSERT, 2, table_oid,
+                                ItemPointer(100, tuple_itr),
+                                INVALID_ITEMPOINTER, tuples[tuple_itr],
+                                DEFAULT_DB_ID);
+    AppendLogRecord(first_buffer, record);
+  }
+
+  EXPECT_TRUE(fel.ReplayLogBuffer(first_buffer.data(), first_buffer.size()));
+
+  // Nothing committed yet
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(), 0);
+  EXPECT_EQ(txn_manager.GetCurrentCommitId(), START_CID);
+
+  std::string second_buffer;
+  logging::TransactionRecord commit_record(LOGRECORD_TYPE_TRANSACTION_COMMIT,
+                                           2);
+  AppendLogRecord(second_buffer, commit_record);
+  logging::TransactionRecord next_begin_record(
+      LOGRECORD_TYPE_TRANSACTION_BEGIN, 3);
+  AppendLogRecord(second_buffer, next_begin_record);
+  logging::TupleRecord record(LOGRECORD_TYPE_WAL_TUPLE_UPDATE, 3, table_oid,
+                              ItemPointer(100, 2), ItemPointer(100, 0),
+                              tuples[2], DEFAULT_DB_ID);
+  AppendLogRecord(second_buffer, record);
+  logging::TransactionRecord next_commit_record(
+      LOGRECORD_TYPE_TRANSACTION_COMMIT, 3);
+  AppendLogRecord(second_buffer, next_commit_record);
+  logging::TransactionRecord delimiter_record(
+      LOGRECORD_TYPE_ITERATION_DELIMITER, 3);
+  AppendLogRecord(second_buffer, delimiter_record);
+
+  EXPECT_TRUE(
+      fel.ReplayLogBuffer(second_buffer.data(), second_buffer.size()));
+
+  EXPECT_EQ(recovery_table->GetNumberOfTuples(), 2);
+  auto tg_header = recovery_table->GetTileGroupById(100)->GetHeader();
+  EXPECT_EQ(tg_header->GetBeginCommitId(1), 2);
+  EXPECT_EQ(tg_header->GetEndCommitId(0), 3);
+  EXPECT_EQ(tg_header->GetBeginCommitId(2), 3);
+
+  // Snapshots see both txns
+  EXPECT_EQ(txn_manager.GetCurrentCommitId(), 4);
+  auto txn = txn_manager.BeginTransaction();
+  EXPECT_EQ(txn->GetBeginCommitId(), 3);
+  txn_manager.CommitTransaction();
+
+  // A buffer cut within a record
+  std::string broken_buffer = second_buffer.substr(0, 10);
+  EXPECT_FALSE(
+      fel.ReplayLogBuffer(broken_buffer.data(), broken_buffer.size()));
+
+  for (auto tuple : tuples) delete tuple;
+}
+
 }  // End test namespace
 }  // End peloton namespace
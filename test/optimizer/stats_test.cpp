@@ -0,0 +1,346 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// stats_test.cpp
+//
+// Identification: test/optimizer/stats_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/value_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_tests_util.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+
+#define private public
+
+#include "optimizer/optimizer.h"
+#include "optimizer/hyperloglog.h"
+#include "optimizer/op_expression.h"
+#include "optimizer/operators.h"
+#include "optimizer/stats.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Stats Tests
+//===--------------------------------------------------------------------===//
+
+using namespace optimizer;
+
+class StatsTests : public PelotonTest {};
+
+namespace {
+
+storage::DataTable *CreateAndPopulateTable(oid_t table_oid, int tuple_count,
+                                           bool group_by = false) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  auto table = ExecutorTestsUtil::CreateTable(TESTS_TUPLES_PER_TILEGROUP,
+                                              false, table_oid);
+  ExecutorTestsUtil::PopulateTable(table, tuple_count, false, false, group_by);
+  txn_manager.CommitTransaction();
+  return table;
+}
+
+std::shared_ptr<OpExpression> MakeGet(Optimizer &optimizer,
+                                      storage::DataTable *table) {
+  std::vector<Column *> columns;
+  auto schema = table->GetSchema();
+  for (oid_t col_id = 0; col_id < schema->GetColumnCount(); col_id++) {
+    auto schema_col = schema->GetColumn(col_id);
+    columns.push_back(optimizer.column_manager.AddBaseColumn(
+        schema_col.GetType(), schema_col.GetLength(), schema_col.GetName(),
+        schema_col.IsInlined(), table->GetOid(), col_id));
+  }
+  return std::make_shared<OpExpression>(LogicalGet::make(table, columns));
+}
+
+std::shared_ptr<OpExpression> MakeVariable(Optimizer &optimizer,
+                                           storage::DataTable *table,
+                                           oid_t col_id) {
+  Column *column = optimizer.column_manager.LookupColumn(table->GetOid(),
+                                                         col_id);
+  EXPECT_TRUE(column != nullptr);
+  return std::make_shared<OpExpression>(ExprVariable::make(column));
+}
+
+std::shared_ptr<OpExpression> MakeCompare(ExpressionType type,
+                                          std::shared_ptr<OpExpression> left,
+                                          std::shared_ptr<OpExpression> right) {
+  auto compare = std::make_shared<OpExpression>(ExprCompare::make(type));
+  compare->PushChild(left);
+  compare->PushChild(right);
+  return compare;
+}
+
+std::shared_ptr<OpExpression> MakeJoin(std::shared_ptr<OpExpression> left,
+                                       std::shared_ptr<OpExpression> right,
+                                       std::shared_ptr<OpExpression> pred) {
+  auto join = std::make_shared<OpExpression>(LogicalInnerJoin::make());
+  join->PushChild(left);
+  join->PushChild(right);
+  join->PushChild(pred);
+  return join;
+}
+
+// Returns the root group
+GroupID Optimize(Optimizer &optimizer, std::shared_ptr<OpExpression> plan) {
+  std::shared_ptr<GroupExpression> gexpr;
+  EXPECT_TRUE(optimizer.RecordTransformedExpression(plan, gexpr));
+  optimizer.OptimizeExpression(gexpr, PropertySet());
+  return gexpr->GetGroupID();
+}
+
+}  // namespace
+
+TEST_F(StatsTests, HyperLogLogTest) {
+  HyperLogLog left;
+  HyperLogLog right;
+  for (int value = 0; value < 50000; value++) {
+    left.Add(ValueFactory::GetIntegerValue(value));
+    // duplicates do not count
+    left.Add(ValueFactory::GetIntegerValue(value));
+    right.Add(ValueFactory::GetIntegerValue(value + 25000));
+  }
+
+  EXPECT_NEAR(50000, left.Estimate(), 50000 * 0.05);
+
+  left.Merge(right);
+  EXPECT_NEAR(75000, left.Estimate(), 75000 * 0.05);
+}
+
+TEST_F(StatsTests, ColumnStatsTest) {
+  // 0 to 999 ten times each, and a common value above them in half the
+  // tuples
+  std::vector<Value> values;
+  for (int itr = 0; itr < 10000; itr++) {
+    values.push_back(ValueFactory::GetIntegerValue(itr % 1000));
+    values.push_back(ValueFactory::GetIntegerValue(2000));
+  }
+  for (int itr = 0; itr < 1000; itr++) {
+    values.push_back(Value::GetNullValue(VALUE_TYPE_INTEGER));
+  }
+
+  ColumnStats stats(values, 1001, values.size());
+
+  EXPECT_NEAR(1000.0 / 21000, stats.GetNullFraction(), 0.001);
+  EXPECT_EQ(1001, stats.GetDistinctCount());
+
+  auto &common_values = stats.GetMostCommonValues();
+  EXPECT_EQ(1, common_values.size());
+  EXPECT_EQ(0, common_values[0].first.Compare(
+                   ValueFactory::GetIntegerValue(2000)));
+
+  auto Selectivity = [&stats](ExpressionType type, int value) {
+    return stats.GetSelectivity(type, ValueFactory::GetIntegerValue(value));
+  };
+
+  EXPECT_NEAR(10000.0 / 21000,
+              Selectivity(EXPRESSION_TYPE_COMPARE_EQUAL, 2000), 0.001);
+  EXPECT_NEAR(10.0 / 21000, Selectivity(EXPRESSION_TYPE_COMPARE_EQUAL, 5),
+              0.0001);
+  EXPECT_EQ(0, Selectivity(EXPRESSION_TYPE_COMPARE_EQUAL, 1500));
+  EXPECT_NEAR(5000.0 / 21000,
+              Selectivity(EXPRESSION_TYPE_COMPARE_LESSTHAN, 500), 0.01);
+  EXPECT_NEAR(10000.0 / 21000,
+              Selectivity(EXPRESSION_TYPE_COMPARE_GREATERTHAN, 1500), 0.01);
+  EXPECT_NEAR(20000.0 / 21000,
+              Selectivity(EXPRESSION_TYPE_COMPARE_LESSTHANOREQUALTO, 2000),
+              0.01);
+
+  // Comparisons with null never hold
+  EXPECT_EQ(0, stats.GetSelectivity(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                    Value::GetNullValue(VALUE_TYPE_INTEGER)));
+}
+
+TEST_F(StatsTests, InlinedValueTest) {
+  std::vector<catalog::Column> columns;
+  columns.emplace_back(VALUE_TYPE_VARCHAR, 16, "name", true);
+  catalog::Schema schema(columns);
+  auto pool = TestingHarness::GetInstance().GetTestingPool();
+
+  // A common value in half the tuples, distinct ones in the rest. The
+  // sampled values point into the storage of the tuples.
+  std::unique_ptr<ColumnStats> stats;
+  {
+    std::vector<std::unique_ptr<storage::Tuple>> tuples;
+    std::vector<Value> values;
+    for (int itr = 0; itr < 300; itr++) {
+      std::string name =
+          (itr % 2 == 0) ? "common" : "value" + std::to_string(itr);
+      tuples.emplace_back(new storage::Tuple(&schema, true));
+      tuples.back()->SetValue(0, ValueFactory::GetStringValue(name), pool);
+      values.push_back(tuples.back()->GetValue(0));
+    }
+    EXPECT_TRUE(values[0].GetSourceInlined());
+
+    stats.reset(new ColumnStats(values, 151, values.size()));
+
+    for (auto &tuple : tuples) {
+      tuple->SetValue(0, ValueFactory::GetStringValue("overwritten"), pool);
+    }
+  }
+
+  // The stats kept copies
+  auto &common_values = stats->GetMostCommonValues();
+  EXPECT_EQ(1, common_values.size());
+  EXPECT_EQ(0, common_values[0].first.Compare(
+                   ValueFactory::GetStringValue("common")));
+  EXPECT_EQ(0.5, common_values[0].second);
+
+  // Strings compare by length first
+  auto &histogram_bounds = stats->GetHistogramBounds();
+  EXPECT_FALSE(histogram_bounds.empty());
+  EXPECT_EQ(0, histogram_bounds.front().Compare(
+                   ValueFactory::GetStringValue("value1")));
+  EXPECT_EQ(0, histogram_bounds.back().Compare(
+                   ValueFactory::GetStringValue("value299")));
+}
+
+TEST_F(StatsTests, AnalyzeTest) {
+  const int tuple_count = 1000;
+  std::unique_ptr<storage::DataTable> table(
+      CreateAndPopulateTable(5001, tuple_count));
+  std::unique_ptr<storage::DataTable> group_by_table(
+      CreateAndPopulateTable(5002, tuple_count, true));
+
+  // The sample is smaller than the table
+  int sample_size = peloton_stats_sample_size;
+  peloton_stats_sample_size = 100;
+  TableStats::Analyze(table.get());
+  TableStats::Analyze(group_by_table.get());
+  peloton_stats_sample_size = sample_size;
+
+  auto stats = TableStats::Lookup(table->GetOid());
+  EXPECT_TRUE(stats != nullptr);
+  EXPECT_EQ(tuple_count, stats->GetTupleCount());
+
+  // Unique column, its distinct count comes from the sketch
+  auto column_stats = stats->GetColumnStats(0);
+  EXPECT_NEAR(tuple_count, column_stats->GetDistinctCount(),
+              tuple_count * 0.05);
+  EXPECT_TRUE(column_stats->GetMostCommonValues().empty());
+
+  // The first half of the column, give or take the sampling error
+  double selectivity = column_stats->GetSelectivity(
+      EXPRESSION_TYPE_COMPARE_LESSTHAN,
+      ValueFactory::GetIntegerValue(ExecutorTestsUtil::PopulatedValue(500, 0)));
+  EXPECT_NEAR(0.5, selectivity, 0.2);
+
+  // Two values in half of the tuples each
+  stats = TableStats::Lookup(group_by_table->GetOid());
+  column_stats = stats->GetColumnStats(0);
+  EXPECT_EQ(2, column_stats->GetDistinctCount());
+  EXPECT_EQ(2, column_stats->GetMostCommonValues().size());
+  EXPECT_NEAR(0.5, column_stats->GetSelectivity(
+                       EXPRESSION_TYPE_COMPARE_EQUAL,
+                       ValueFactory::GetIntegerValue(
+                           ExecutorTestsUtil::PopulatedValue(1, 0))),
+              0.2);
+
+  auto &manager = catalog::Manager::GetInstance();
+  manager.DropTableStats(table->GetOid());
+  manager.DropTableStats(group_by_table->GetOid());
+}
+
+TEST_F(StatsTests, MultiJoinTest) {
+  // The first column is the join key, all keys of a smaller table are in
+  // the larger ones
+  std::unique_ptr<storage::DataTable> large_table(
+      CreateAndPopulateTable(5011, 1000));
+  std::unique_ptr<storage::DataTable> medium_table(
+      CreateAndPopulateTable(5012, 100));
+  std::unique_ptr<storage::DataTable> small_table(
+      CreateAndPopulateTable(5013, 10));
+
+  TableStats::Analyze(large_table.get());
+  TableStats::Analyze(medium_table.get());
+  TableStats::Analyze(small_table.get());
+
+  // (large JOIN medium) JOIN small, written with the larger table on the
+  // right of each join
+  Optimizer optimizer;
+  auto large = MakeGet(optimizer, large_table.get());
+  auto medium = MakeGet(optimizer, medium_table.get());
+  auto small = MakeGet(optimizer, small_table.get());
+
+  auto inner_join = MakeJoin(
+      medium, large,
+      MakeCompare(EXPRESSION_TYPE_COMPARE_EQUAL,
+                  MakeVariable(optimizer, medium_table.get(), 0),
+                  MakeVariable(optimizer, large_table.get(), 0)));
+  auto outer_join = MakeJoin(
+      small, inner_join,
+      MakeCompare(EXPRESSION_TYPE_COMPARE_EQUAL,
+                  MakeVariable(optimizer, small_table.get(), 0),
+                  MakeVariable(optimizer, medium_table.get(), 0)));
+
+  GroupID root = Optimize(optimizer, outer_join);
+  auto best_plan = optimizer.ChooseBestPlan(root, PropertySet());
+
+  // Hash joins that build on the smaller input
+  EXPECT_EQ(OpType::InnerHashJoin, best_plan->Op().type());
+  auto build = best_plan->Children()[1];
+  EXPECT_EQ(OpType::Scan, build->Op().type());
+  EXPECT_EQ(small_table.get(), build->Op().as<PhysicalScan>()->table);
+
+  auto probe = best_plan->Children()[0];
+  EXPECT_EQ(OpType::InnerHashJoin, probe->Op().type());
+  build = probe->Children()[1];
+  EXPECT_EQ(OpType::Scan, build->Op().type());
+  EXPECT_EQ(medium_table.get(), build->Op().as<PhysicalScan>()->table);
+
+  // Every key of the small table joins one tuple of each other table
+  auto best_expression =
+      optimizer.memo.GetGroupByID(root)->GetBestExpression(PropertySet());
+  EXPECT_NEAR(10, best_expression->GetStats()->cardinality, 1);
+
+  // The plan with nested loops costs more
+  for (auto &gexpr : optimizer.memo.GetGroupByID(root)->GetExpressions()) {
+    if (gexpr->Op().type() != OpType::InnerNLJoin) continue;
+    EXPECT_GT(gexpr->GetCost(), best_expression->GetCost());
+  }
+
+  auto &manager = catalog::Manager::GetInstance();
+  manager.DropTableStats(large_table->GetOid());
+  manager.DropTableStats(medium_table->GetOid());
+  manager.DropTableStats(small_table->GetOid());
+}
+
+TEST_F(StatsTests, FilterSelectivityTest) {
+  std::unique_ptr<storage::DataTable> table(CreateAndPopulateTable(5021, 1000));
+  TableStats::Analyze(table.get());
+
+  // The second column is 10 * i + 1, the predicate keeps i < 250
+  Optimizer optimizer;
+  auto get = MakeGet(optimizer, table.get());
+  auto predicate = MakeCompare(
+      EXPRESSION_TYPE_COMPARE_LESSTHAN, MakeVariable(optimizer, table.get(), 1),
+      std::make_shared<OpExpression>(ExprConstant::make(
+          ValueFactory::GetIntegerValue(ExecutorTestsUtil::PopulatedValue(
+              250, 1)))));
+  auto select = std::make_shared<OpExpression>(LogicalSelect::make());
+  select->PushChild(get);
+  select->PushChild(predicate);
+
+  GroupID root = Optimize(optimizer, select);
+  auto best_expression =
+      optimizer.memo.GetGroupByID(root)->GetBestExpression(PropertySet());
+  EXPECT_EQ(OpType::Filter, best_expression->Op().type());
+  EXPECT_NEAR(250, best_expression->GetStats()->cardinality, 10);
+
+  catalog::Manager::GetInstance().DropTableStats(table->GetOid());
+}
+
+}  // namespace test
+}  // namespace peloton
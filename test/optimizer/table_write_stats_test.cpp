@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// table_write_stats_test.cpp
+//
+// Identification: test/optimizer/table_write_stats_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/harness.h"
+
+#include "catalog/manager.h"
+#include "catalog/schema.h"
+#include "common/value_factory.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_tests_util.h"
+#include "optimizer/stats.h"
+#include "optimizer/table_write_stats.h"
+#include "storage/data_table.h"
+#include "storage/tuple.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Table Write Stats Tests
+//===--------------------------------------------------------------------===//
+
+using namespace optimizer;
+
+class TableWriteStatsTests : public PelotonTest {};
+
+namespace {
+
+catalog::Schema *CreateIntegerSchema() {
+  std::vector<catalog::Column> columns;
+  for (auto name : {"a", "b"}) {
+    columns.emplace_back(VALUE_TYPE_INTEGER,
+                         GetTypeSize(VALUE_TYPE_INTEGER), name, true);
+  }
+  return new catalog::Schema(columns);
+}
+
+// Every thread writes its own range of values, the odd ones with a null in
+// the second column
+void InsertTuples(TableWriteStats *stats, const catalog::Schema *schema,
+                  int tuple_count, uint64_t thread_itr) {
+  storage::Tuple tuple(schema, true);
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    int value = thread_itr * tuple_count + tuple_itr;
+    tuple.SetValue(0, ValueFactory::GetIntegerValue(value), nullptr);
+    if (value % 2 == 0) {
+      tuple.SetValue(1, ValueFactory::GetIntegerValue(value), nullptr);
+    } else {
+      tuple.SetValue(1, ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER),
+                     nullptr);
+    }
+    stats->AddTuple(&tuple);
+  }
+}
+
+}  // namespace
+
+TEST_F(TableWriteStatsTests, WritePathTest) {
+  const int tuple_count = 1000;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> table(ExecutorTestsUtil::CreateTable(
+      TESTS_TUPLES_PER_TILEGROUP, false, 5101));
+  ExecutorTestsUtil::PopulateTable(table.get(), tuple_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  // InsertTuple kept the stats up to date
+  auto write_stats = table->GetWriteStats();
+  EXPECT_TRUE(write_stats != nullptr);
+  EXPECT_EQ(tuple_count, write_stats->GetTupleCount());
+  EXPECT_EQ(0, write_stats->GetNullFraction(0));
+  EXPECT_NEAR(tuple_count, write_stats->GetDistinctCount(0),
+              tuple_count * 0.1);
+
+  double min_value, max_value;
+  EXPECT_TRUE(write_stats->GetBounds(0, min_value, max_value));
+  EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(0, 0), min_value);
+  EXPECT_EQ(ExecutorTestsUtil::PopulatedValue(tuple_count - 1, 0), max_value);
+
+  // No bounds for strings
+  EXPECT_FALSE(write_stats->GetBounds(3, min_value, max_value));
+
+  // Without ANALYZE the optimizer gets the merged write stats, until the
+  // next write
+  auto stats = TableStats::Lookup(table->GetOid());
+  EXPECT_TRUE(stats != nullptr);
+  EXPECT_EQ(tuple_count, stats->GetTupleCount());
+  EXPECT_EQ(stats, TableStats::Lookup(table->GetOid()));
+
+  auto column_stats = stats->GetColumnStats(0);
+  Value middle = ValueFactory::GetIntegerValue(
+      ExecutorTestsUtil::PopulatedValue(tuple_count / 2, 0));
+  EXPECT_NEAR(0.5, column_stats->GetSelectivity(
+                       EXPRESSION_TYPE_COMPARE_LESSTHAN, middle),
+              0.01);
+  EXPECT_NEAR(1.0 / tuple_count,
+              column_stats->GetSelectivity(EXPRESSION_TYPE_COMPARE_EQUAL,
+                                           middle),
+              0.1 / tuple_count);
+
+  // An update keeps the count, a delete lowers it
+  auto tuple = ExecutorTestsUtil::GetTuple(
+      table.get(), tuple_count,
+      TestingHarness::GetInstance().GetTestingPool());
+  tuple->SetValue(1, ValueFactory::GetNullValueByType(VALUE_TYPE_INTEGER),
+                  nullptr);
+  write_stats->UpdateTuple(tuple.get());
+  write_stats->DeleteTuple();
+  EXPECT_EQ(tuple_count - 1, write_stats->GetTupleCount());
+  EXPECT_DOUBLE_EQ(1.0 / (tuple_count + 1), write_stats->GetNullFraction(1));
+
+  auto fresh_stats = TableStats::Lookup(table->GetOid());
+  EXPECT_NE(stats, fresh_stats);
+  EXPECT_EQ(tuple_count - 1, fresh_stats->GetTupleCount());
+
+  // ANALYZE takes over
+  TableStats::Analyze(table.get());
+  EXPECT_NE(fresh_stats, TableStats::Lookup(table->GetOid()));
+  catalog::Manager::GetInstance().DropTableStats(table->GetOid());
+
+  // Dropping the table drops its write stats
+  table.reset();
+  EXPECT_TRUE(TableStats::Lookup(5101) == nullptr);
+}
+
+TEST_F(TableWriteStatsTests, ParallelWriteTest) {
+  const int thread_count = 4;
+  const int tuple_count = 2000;
+
+  std::unique_ptr<catalog::Schema> schema(CreateIntegerSchema());
+  TableWriteStats stats(schema.get());
+
+  LaunchParallelTest(thread_count, InsertTuples, &stats, schema.get(),
+                     tuple_count);
+
+  const int total_count = thread_count * tuple_count;
+  EXPECT_EQ(total_count, stats.GetTupleCount());
+  EXPECT_EQ(0, stats.GetNullFraction(0));
+  EXPECT_EQ(0.5, stats.GetNullFraction(1));
+
+  // The sketch is off by about 3% with 1024 registers
+  EXPECT_NEAR(total_count, stats.GetDistinctCount(0), total_count * 0.1);
+  EXPECT_NEAR(total_count / 2, stats.GetDistinctCount(1), total_count * 0.05);
+
+  double min_value, max_value;
+  EXPECT_TRUE(stats.GetBounds(0, min_value, max_value));
+  EXPECT_EQ(0, min_value);
+  EXPECT_EQ(total_count - 1, max_value);
+  EXPECT_TRUE(stats.GetBounds(1, min_value, max_value));
+  EXPECT_EQ(0, min_value);
+  EXPECT_EQ(total_count - 2, max_value);
+}
+
+}  // End test namespace
+}  // End peloton namespace
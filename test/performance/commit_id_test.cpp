@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// commit_id_test.cpp
+//
+// Identification: test/performance/commit_id_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <algorithm>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Commit Id Tests
+//===--------------------------------------------------------------------===//
+
+class CommitIdTests : public PelotonTest {};
+
+//===------------------------------===//
+// Utility
+//===------------------------------===//
+
+// Every write_interval-th txn publishes its cid like a committing writer
+// does, none if it is 0
+void BeginCommitTransactions(oid_t txn_count, oid_t write_interval,
+                             std::vector<std::vector<txn_id_t>> *txn_ids,
+                             std::vector<std::vector<cid_t>> *begin_cids,
+                             uint64_t thread_itr) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  for (oid_t txn_itr = 0; txn_itr < txn_count; txn_itr++) {
+    auto txn = txn_manager.BeginTransaction();
+    (*txn_ids)[thread_itr].push_back(txn->GetTransactionId());
+    (*begin_cids)[thread_itr].push_back(txn->GetBeginCommitId());
+    if (write_interval != 0 && txn_itr % write_interval == 0) {
+      txn_manager.PublishCommitId(txn->GetBeginCommitId());
+    }
+    txn_manager.CommitTransaction();
+  }
+}
+
+void RunBeginCommitThroughput(oid_t write_interval) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  oid_t txn_count = 100000;
+
+  for (uint64_t thread_count = 1; thread_count <= 8; thread_count *= 2) {
+    std::vector<std::vector<txn_id_t>> txn_ids(thread_count);
+    std::vector<std::vector<cid_t>> begin_cids(thread_count);
+
+    Timer<> timer;
+    timer.Start();
+
+    LaunchParallelTest(thread_count, BeginCommitTransactions, txn_count,
+                       write_interval, &txn_ids, &begin_cids);
+
+    timer.Stop();
+    auto duration = timer.GetDuration();
+
+    // Ids handed out from per-thread blocks are still unique
+    std::set<txn_id_t> unique_txn_ids;
+    std::set<cid_t> unique_begin_cids;
+    for (uint64_t thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+      unique_txn_ids.insert(txn_ids[thread_itr].begin(),
+                            txn_ids[thread_itr].end());
+      unique_begin_cids.insert(begin_cids[thread_itr].begin(),
+                               begin_cids[thread_itr].end());
+
+      // and increase within a thread
+      EXPECT_TRUE(std::is_sorted(begin_cids[thread_itr].begin(),
+                                 begin_cids[thread_itr].end()));
+    }
+    EXPECT_EQ(thread_count * txn_count, unique_txn_ids.size());
+    EXPECT_EQ(thread_count * txn_count, unique_begin_cids.size());
+
+    // Commit ids of dropped blocks go to waste
+    double cids_per_txn =
+        double(*unique_begin_cids.rbegin() - *unique_begin_cids.begin() + 1) /
+        (thread_count * txn_count);
+
+    LOG_INFO("%s Threads: %lu Duration: %.2lf Throughput: %.0lf txn/s "
+             "Cids per txn: %.2lf",
+             write_interval == 0 ? "Read only" : "Read write", thread_count,
+             duration, thread_count * txn_count / duration, cids_per_txn);
+  }
+
+  txn_manager.ResetStates();
+}
+
+TEST_F(CommitIdTests, BeginCommitThroughputTest) {
+  // Read-only txns, and one writer in four
+  RunBeginCommitThroughput(0);
+  RunBeginCommitThroughput(4);
+}
+
+TEST_F(CommitIdTests, PublishedCommitTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // A txn that begins after a commit was published comes after it, even if
+  // the thread still holds ids from before
+  auto txn = txn_manager.BeginTransaction();
+  cid_t early_cid = txn->GetBeginCommitId();
+  txn_manager.CommitTransaction();
+
+  cid_t published_cid = 0;
+  std::thread writer([&txn_manager, &published_cid] {
+    auto writer_txn = txn_manager.BeginTransaction();
+    published_cid = writer_txn->GetBeginCommitId();
+    txn_manager.PublishCommitId(published_cid);
+    txn_manager.CommitTransaction();
+  });
+  writer.join();
+
+  EXPECT_LT(early_cid, published_cid);
+
+  txn = txn_manager.BeginTransaction();
+  EXPECT_LT(published_cid, txn->GetBeginCommitId());
+  txn_manager.CommitTransaction();
+
+  txn_manager.ResetStates();
+}
+
+TEST_F(CommitIdTests, StaleBlockTest) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // Begin past the txns of the earlier tests, then drop the blocks without
+  // moving the counter back
+  txn_manager.BeginTransaction();
+  txn_manager.CommitTransaction();
+  txn_manager.SetNextCid(txn_manager.GetCurrentCommitId());
+
+  // Every begin finds its block passed by the commit of another thread, the
+  // ids it skips shrink with the block
+  std::vector<cid_t> skipped_cids;
+  cid_t last_cid = INVALID_CID;
+  for (int txn_itr = 0; txn_itr < 7; txn_itr++) {
+    auto txn = txn_manager.BeginTransaction();
+    cid_t begin_cid = txn->GetBeginCommitId();
+    txn_manager.CommitTransaction();
+    if (last_cid != INVALID_CID) {
+      skipped_cids.push_back(begin_cid - last_cid - 1);
+    }
+    last_cid = begin_cid;
+
+    txn_manager.PublishCommitId(txn_manager.GetCurrentCommitId() - 1);
+  }
+
+  std::vector<cid_t> expected_skipped_cids({15, 7, 3, 1, 0, 0});
+  EXPECT_EQ(expected_skipped_cids, skipped_cids);
+
+  txn_manager.ResetStates();
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// data_row_test.cpp
+//
+// Identification: test/performance/data_row_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/statement.h"
+#include "common/timer.h"
+#include "common/value_peeker.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "storage/data_table.h"
+#include "storage/tile.h"
+#include "wire/marshal.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Data Row Tests
+//===--------------------------------------------------------------------===//
+
+class DataRowTests : public PelotonTest {};
+
+//===------------------------------===//
+// Utility
+//===------------------------------===//
+
+/*
+ * Wrap every tile group of the table, with each column repeated
+ * repeat_count times to get wide rows
+ */
+std::vector<std::unique_ptr<executor::LogicalTile>> WrapWideTiles(
+    storage::DataTable *table, size_t repeat_count) {
+  std::vector<std::unique_ptr<executor::LogicalTile>> result_tiles;
+
+  for (oid_t tile_group_itr = 0; tile_group_itr < table->GetTileGroupCount();
+       tile_group_itr++) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        executor::LogicalTileFactory::WrapTileGroup(
+            table->GetTileGroup(tile_group_itr)));
+
+    auto column_count = result_tile->GetColumnCount();
+    for (size_t repeat_itr = 1; repeat_itr < repeat_count; repeat_itr++) {
+      for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+        auto column_info = result_tile->GetColumnInfo(column_itr);
+        result_tile->AddColumn(column_info.base_tile,
+                               column_info.origin_column_id,
+                               column_info.position_list_idx);
+      }
+    }
+
+    result_tiles.push_back(std::move(result_tile));
+  }
+
+  return result_tiles;
+}
+
+/*
+ * The DataRow packets of a result tile the way they were built before:
+ * materialize the tile, copy every value to a result field and then to
+ * the packet
+ */
+size_t PutMaterializedDataRows(executor::LogicalTile *result_tile,
+                               wire::ResponseBuffer &responses) {
+  std::unique_ptr<storage::Tile> physical_tile(result_tile->Materialize());
+  auto column_count = result_tile->GetColumnCount();
+  auto row_count = result_tile->GetTupleCount();
+
+  std::vector<ResultType> results;
+  for (oid_t tuple_id = 0; tuple_id < row_count; tuple_id++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto text = physical_tile->GetValue(tuple_id, column_itr)
+                      .CastAs(VALUE_TYPE_VARCHAR);
+      auto data = static_cast<const unsigned char *>(
+          ValuePeeker::PeekObjectValueWithoutNull(text));
+      auto length = ValuePeeker::PeekObjectLengthWithoutNull(text);
+      results.emplace_back(std::vector<unsigned char>(),
+                           std::vector<unsigned char>(data, data + length));
+    }
+  }
+
+  for (oid_t tuple_id = 0; tuple_id < row_count; tuple_id++) {
+    std::unique_ptr<wire::Packet> pkt(new wire::Packet());
+    pkt->msg_type = 'D';
+    wire::PacketPutInt(pkt, column_count, 2);
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      auto &field = results[tuple_id * column_count + column_itr].second;
+      wire::PacketPutInt(pkt, field.size(), 4);
+      wire::PacketPutBytes(pkt, field);
+    }
+    responses.push_back(std::move(pkt));
+  }
+
+  return row_count;
+}
+
+TEST_F(DataRowTests, WideRowThroughputTest) {
+  // 100K rows of 4 columns, each sent 16 times as a 64 column row
+  const size_t tuple_count = 100 * 1000;
+  const size_t repeat_count = 16;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(DEFAULT_TUPLES_PER_TILEGROUP, false));
+  ExecutorTestsUtil::PopulateTable(data_table.get(), tuple_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  auto result_tiles = WrapWideTiles(data_table.get(), repeat_count);
+
+  wire::ResponseBuffer materialized_rows;
+  size_t materialized_row_count = 0;
+  Timer<> timer;
+  timer.Start();
+  for (auto &result_tile : result_tiles) {
+    materialized_row_count +=
+        PutMaterializedDataRows(result_tile.get(), materialized_rows);
+  }
+  timer.Stop();
+  LOG_INFO("Materialized :: Rows: %lu Duration: %.2lf", materialized_row_count,
+           timer.GetDuration());
+
+  wire::ResponseBuffer streamed_rows;
+  size_t streamed_row_count = 0;
+  timer.Reset();
+  timer.Start();
+  for (auto &result_tile : result_tiles) {
+    streamed_row_count +=
+        wire::PacketPutDataRows(result_tile.get(), streamed_rows);
+  }
+  timer.Stop();
+  LOG_INFO("Streamed :: Rows: %lu Duration: %.2lf", streamed_row_count,
+           timer.GetDuration());
+
+  // Both give the same packets
+  EXPECT_EQ(tuple_count, streamed_row_count);
+  EXPECT_EQ(materialized_row_count, streamed_row_count);
+  ASSERT_EQ(materialized_rows.size(), streamed_rows.size());
+  for (size_t row_itr = 0; row_itr < streamed_rows.size(); row_itr++) {
+    EXPECT_EQ(materialized_rows[row_itr]->buf, streamed_rows[row_itr]->buf);
+  }
+}
+
+}  // namespace test
+}  // namespace peloton
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// hash_aggregate_test.cpp
+//
+// Identification: test/performance/hash_aggregate_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/aggregate_executor.h"
+#include "executor/aggregator.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "expression/expression_util.h"
+#include "planner/aggregate_plan.h"
+#include "storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+#include "executor/mock_executor.h"
+
+// Groups of the throughput test, the table is read 10 times, so 100K rows
+// (raise it to 1M for a run that measures the hash table out of cache)
+#define HASH_AGGREGATE_GROUP_COUNT (10 * 1000)
+
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Hash Aggregate Tests
+//===--------------------------------------------------------------------===//
+
+class HashAggregateTests : public PelotonTest {};
+
+//===------------------------------===//
+// Utility
+//===------------------------------===//
+
+/*
+ * SELECT a, SUM(b) FROM table GROUP BY a;
+ * over the tile groups of the table, each read scan_count times
+ */
+size_t AggregateTable(storage::DataTable *table, size_t scan_count) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+
+  // 1) Set up group-by columns
+  std::vector<oid_t> group_by_columns = {0};
+
+  // 2) Set up project info
+  DirectMapList direct_map_list = {{0, {0, 0}}, {1, {1, 0}}};
+  std::unique_ptr<const planner::ProjectInfo> proj_info(
+      new planner::ProjectInfo(TargetList(), std::move(direct_map_list)));
+
+  // 3) Set up unique aggregates
+  std::vector<planner::AggregatePlan::AggTerm> agg_terms;
+  planner::AggregatePlan::AggTerm sumB(
+      EXPRESSION_TYPE_AGGREGATE_SUM,
+      expression::ExpressionUtil::TupleValueFactory(VALUE_TYPE_INTEGER, 0, 1));
+  agg_terms.push_back(sumB);
+
+  // 4) Set up predicate (empty)
+  std::unique_ptr<const expression::AbstractExpression> predicate(nullptr);
+
+  // 5) Create output table schema
+  auto table_schema = table->GetSchema();
+  std::vector<catalog::Column> columns = {table_schema->GetColumn(0),
+                                          table_schema->GetColumn(1)};
+  std::shared_ptr<const catalog::Schema> output_table_schema(
+      new catalog::Schema(columns));
+
+  planner::AggregatePlan node(std::move(proj_info), std::move(predicate),
+                              std::move(agg_terms), std::move(group_by_columns),
+                              output_table_schema, AGGREGATE_TYPE_HASH);
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  executor::AggregateExecutor executor(&node, context.get());
+  MockExecutor child_executor;
+  executor.AddChild(&child_executor);
+
+  // Hand out every tile group scan_count times
+  size_t tile_group_count = table->GetTileGroupCount();
+  size_t tile_count = tile_group_count * scan_count;
+  size_t tile_itr = 0;
+
+  EXPECT_CALL(child_executor, DInit()).WillOnce(Return(true));
+  EXPECT_CALL(child_executor, DExecute())
+      .WillRepeatedly(Invoke([&tile_itr, tile_count] {
+        return tile_itr < tile_count;
+      }));
+  EXPECT_CALL(child_executor, GetOutput())
+      .WillRepeatedly(Invoke([&tile_itr, tile_group_count, table] {
+        return executor::LogicalTileFactory::WrapTileGroup(
+            table->GetTileGroup(tile_itr++ % tile_group_count));
+      }));
+
+  EXPECT_TRUE(executor.Init());
+
+  size_t group_count = 0;
+  while (executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(executor.GetOutput());
+    group_count += result_tile->GetTupleCount();
+  }
+
+  txn_manager.CommitTransaction();
+
+  return group_count;
+}
+
+TEST_F(HashAggregateTests, GroupByThroughputTest) {
+  // Every row of the table is read 10 times
+  const size_t group_count = HASH_AGGREGATE_GROUP_COUNT;
+  const size_t scan_count = 10;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(DEFAULT_TUPLES_PER_TILEGROUP, false));
+  ExecutorTestsUtil::PopulateTable(data_table.get(), group_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  for (int thread_count : {1, 4}) {
+    peloton_aggregate_thread_count = thread_count;
+
+    Timer<> timer;
+    timer.Start();
+
+    auto result_count = AggregateTable(data_table.get(), scan_count);
+
+    timer.Stop();
+    auto duration = timer.GetDuration();
+
+    LOG_INFO("Threads: %d Rows: %lu Groups: %lu Duration: %.2lf", thread_count,
+             group_count * scan_count, result_count, duration);
+
+    EXPECT_EQ(group_count, result_count);
+  }
+
+  peloton_aggregate_thread_count = 0;
+}
+
+}  // namespace test
+}  // namespace peloton
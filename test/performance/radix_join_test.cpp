@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// radix_join_test.cpp
+//
+// Identification: test/performance/radix_join_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <memory>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "common/timer.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/hash_executor.h"
+#include "executor/hash_join_executor.h"
+#include "executor/logical_tile.h"
+#include "executor/logical_tile_factory.h"
+#include "expression/tuple_value_expression.h"
+#include "planner/hash_join_plan.h"
+#include "planner/hash_plan.h"
+#include "storage/data_table.h"
+
+#include "executor/executor_tests_util.h"
+#include "executor/join_tests_util.h"
+#include "executor/mock_executor.h"
+
+// Rows of each side of the throughput test (raise it to 1M for a run that
+// measures the hash table out of cache)
+#define RADIX_JOIN_TUPLE_COUNT (100 * 1000)
+
+using ::testing::Invoke;
+using ::testing::Return;
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Radix Join Tests
+//===--------------------------------------------------------------------===//
+
+class RadixJoinTests : public PelotonTest {};
+
+//===------------------------------===//
+// Utility
+//===------------------------------===//
+
+void ExpectTableTiles(MockExecutor *executor, storage::DataTable *table,
+                      size_t *tile_itr) {
+  size_t tile_group_count = table->GetTileGroupCount();
+
+  EXPECT_CALL(*executor, DInit()).WillOnce(Return(true));
+  EXPECT_CALL(*executor, DExecute())
+      .WillRepeatedly(Invoke([tile_itr, tile_group_count] {
+        return *tile_itr < tile_group_count;
+      }));
+  EXPECT_CALL(*executor, GetOutput())
+      .WillRepeatedly(Invoke([tile_itr, table] {
+        return executor::LogicalTileFactory::WrapTileGroup(
+            table->GetTileGroup((*tile_itr)++));
+      }));
+}
+
+/*
+ * SELECT * FROM left_table INNER JOIN right_table
+ *   ON left_table.b = right_table.b;
+ */
+size_t HashJoinTables(storage::DataTable *left_table,
+                      storage::DataTable *right_table) {
+  std::vector<std::unique_ptr<const expression::AbstractExpression>> hash_keys;
+  hash_keys.emplace_back(
+      new expression::TupleValueExpression(VALUE_TYPE_INTEGER, 1, 1));
+  planner::HashPlan hash_plan_node(hash_keys);
+
+  std::shared_ptr<const catalog::Schema> schema(new catalog::Schema(
+      {ExecutorTestsUtil::GetColumnInfo(1), ExecutorTestsUtil::GetColumnInfo(1),
+       ExecutorTestsUtil::GetColumnInfo(0),
+       ExecutorTestsUtil::GetColumnInfo(0)}));
+  std::unique_ptr<const expression::AbstractExpression> predicate(
+      JoinTestsUtil::CreateJoinPredicate());
+  planner::HashJoinPlan hash_join_plan_node(
+      JOIN_TYPE_INNER, std::move(predicate), JoinTestsUtil::CreateProjection(),
+      schema);
+
+  executor::HashExecutor hash_executor(&hash_plan_node, nullptr);
+  executor::HashJoinExecutor hash_join_executor(&hash_join_plan_node, nullptr);
+
+  MockExecutor left_table_scan_executor, right_table_scan_executor;
+  size_t left_tile_itr = 0, right_tile_itr = 0;
+  ExpectTableTiles(&left_table_scan_executor, left_table, &left_tile_itr);
+  ExpectTableTiles(&right_table_scan_executor, right_table, &right_tile_itr);
+
+  hash_join_executor.AddChild(&left_table_scan_executor);
+  hash_join_executor.AddChild(&hash_executor);
+  hash_executor.AddChild(&right_table_scan_executor);
+
+  EXPECT_TRUE(hash_join_executor.Init());
+
+  size_t result_tuple_count = 0;
+  while (hash_join_executor.Execute() == true) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        hash_join_executor.GetOutput());
+    if (result_tile != nullptr) {
+      result_tuple_count += result_tile->GetTupleCount();
+    }
+  }
+
+  return result_tuple_count;
+}
+
+TEST_F(RadixJoinTests, JoinThroughputTest) {
+  // Every left row matches one right row
+  const size_t tuple_count = RADIX_JOIN_TUPLE_COUNT;
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  std::unique_ptr<storage::DataTable> left_table(
+      ExecutorTestsUtil::CreateTable(DEFAULT_TUPLES_PER_TILEGROUP, false));
+  ExecutorTestsUtil::PopulateTable(left_table.get(), tuple_count, false, false,
+                                   false);
+  std::unique_ptr<storage::DataTable> right_table(
+      ExecutorTestsUtil::CreateTable(DEFAULT_TUPLES_PER_TILEGROUP, false));
+  ExecutorTestsUtil::PopulateTable(right_table.get(), tuple_count, false,
+                                   false, false);
+  txn_manager.CommitTransaction();
+
+  // 0 threads is the tuple at a time hash join
+  for (int thread_count : {0, 1, 4}) {
+    peloton_hash_join_thread_count = thread_count;
+
+    txn_manager.BeginTransaction();
+    Timer<> timer;
+    timer.Start();
+
+    auto result_count = HashJoinTables(left_table.get(), right_table.get());
+
+    timer.Stop();
+    txn_manager.CommitTransaction();
+    auto duration = timer.GetDuration();
+
+    LOG_INFO("Threads: %d Rows: %lu Matches: %lu Duration: %.2lf",
+             thread_count, tuple_count, result_count, duration);
+
+    EXPECT_EQ(tuple_count, result_count);
+  }
+
+  peloton_hash_join_thread_count = 0;
+}
+
+}  // namespace test
+}  // namespace peloton
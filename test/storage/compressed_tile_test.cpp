@@ -0,0 +1,256 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// compressed_tile_test.cpp
+//
+// Identification: test/storage/compressed_tile_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "common/value_factory.h"
+#include "common/value_peeker.h"
+#include "concurrency/epoch_manager.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "expression/container_tuple.h"
+#include "expression/expression_batch.h"
+#include "expression/expression_util.h"
+#include "storage/compressed_tile.h"
+#include "storage/tile.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_compressor.h"
+#include "storage/tile_group_header.h"
+#include "storage/tuple.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Compressed Tile Tests
+//===--------------------------------------------------------------------===//
+
+class CompressedTileTests : public PelotonTest {};
+
+namespace {
+
+const int tuple_count = 1000;
+
+void CheckValues(storage::Tile *expected_tile, storage::Tile *tile) {
+  oid_t column_count = expected_tile->GetColumnCount();
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    for (oid_t column_itr = 0; column_itr < column_count; column_itr++) {
+      Value expected = expected_tile->GetValue(tuple_itr, column_itr);
+      Value value = tile->GetValue(tuple_itr, column_itr);
+      if (expected.IsNull()) {
+        EXPECT_TRUE(value.IsNull());
+      } else {
+        EXPECT_TRUE(expected.OpEquals(value).IsTrue());
+      }
+    }
+  }
+}
+
+// Wait until every txn that could still see older versions has exited
+void WaitUntilCold(storage::TileGroup *tile_group) {
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  txn_manager.CommitTransaction();
+
+  for (int attempt = 0; attempt < 100; attempt++) {
+    if (storage::TileGroupCompressor::IsCold(tile_group)) return;
+    std::this_thread::sleep_for(std::chrono::milliseconds(EPOCH_LENGTH));
+  }
+}
+
+}  // namespace
+
+TEST_F(CompressedTileTests, EncodingTest) {
+  std::vector<catalog::Column> columns = {
+      catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                      "A", true),
+      catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                      "B", true),
+      catalog::Column(VALUE_TYPE_VARCHAR, 25, "C", false),
+      catalog::Column(VALUE_TYPE_DOUBLE, GetTypeSize(VALUE_TYPE_DOUBLE), "D",
+                      true),
+      catalog::Column(VALUE_TYPE_INTEGER, GetTypeSize(VALUE_TYPE_INTEGER),
+                      "E", true)};
+  catalog::Schema schema(columns);
+
+  std::unique_ptr<storage::TileGroupHeader> header(
+      new storage::TileGroupHeader(BACKEND_TYPE_MM, tuple_count));
+  std::unique_ptr<storage::Tile> tile(storage::TileFactory::GetTile(
+      BACKEND_TYPE_MM, INVALID_OID, INVALID_OID, INVALID_OID, INVALID_OID,
+      header.get(), schema, nullptr, tuple_count));
+
+  std::vector<std::string> colors = {"red", "green", "blue"};
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    // A narrow range of large integers
+    tile->SetValue(ValueFactory::GetIntegerValue(1000000 + tuple_itr % 100),
+                   tuple_itr, 0);
+    // Long runs
+    tile->SetValue(ValueFactory::GetIntegerValue(tuple_itr / 100), tuple_itr,
+                   1);
+    // Few distinct strings
+    tile->SetValue(ValueFactory::GetStringValue(colors[tuple_itr % 3]),
+                   tuple_itr, 2);
+    // Distinct doubles
+    tile->SetValue(ValueFactory::GetDoubleValue(tuple_itr * 1.5), tuple_itr,
+                   3);
+    // Few distinct integers and NULLs
+    tile->SetValue((tuple_itr % 10 == 0)
+                       ? Value::GetNullValue(VALUE_TYPE_INTEGER)
+                       : ValueFactory::GetIntegerValue(tuple_itr % 7),
+                   tuple_itr, 4);
+  }
+
+  std::unique_ptr<storage::CompressedTile> compressed_tile(
+      new storage::CompressedTile(tile.get()));
+
+  EXPECT_EQ(storage::COLUMN_ENCODING_TYPE_FRAME_OF_REFERENCE,
+            compressed_tile->GetColumnEncoding(0));
+  EXPECT_EQ(storage::COLUMN_ENCODING_TYPE_RUN_LENGTH,
+            compressed_tile->GetColumnEncoding(1));
+  EXPECT_EQ(storage::COLUMN_ENCODING_TYPE_DICTIONARY,
+            compressed_tile->GetColumnEncoding(2));
+  EXPECT_EQ(storage::COLUMN_ENCODING_TYPE_PLAIN,
+            compressed_tile->GetColumnEncoding(3));
+  EXPECT_EQ(storage::COLUMN_ENCODING_TYPE_DICTIONARY,
+            compressed_tile->GetColumnEncoding(4));
+
+  EXPECT_LT(compressed_tile->GetInlinedSize(), tile->GetInlinedSize());
+  EXPECT_TRUE(compressed_tile->IsCompressed());
+
+  CheckValues(tile.get(), compressed_tile.get());
+
+  // The varlens outlive the pool of the tile
+  tile.reset();
+  EXPECT_TRUE(compressed_tile->GetValue(tuple_count - 2, 2)
+                  .OpEquals(ValueFactory::GetStringValue("blue"))
+                  .IsTrue());
+
+  // Materialization reads by column offset
+  Value value = compressed_tile->GetValueFast(
+      7, schema.GetOffset(4), VALUE_TYPE_INTEGER, true);
+  EXPECT_EQ(0, ValuePeeker::PeekInteger(value));
+
+  // Batches are decoded without going through values
+  std::vector<oid_t> tuple_offsets = {999, 0, 10, 501};
+  std::vector<int64_t> values(tuple_offsets.size());
+  for (oid_t column_itr : {0, 1, 4}) {
+    EXPECT_TRUE(compressed_tile->GatherIntegers(
+        column_itr, tuple_offsets.data(), tuple_offsets.size(),
+        values.data()));
+    for (size_t itr = 0; itr < tuple_offsets.size(); itr++) {
+      Value expected =
+          compressed_tile->GetValue(tuple_offsets[itr], column_itr);
+      EXPECT_EQ(expected.IsNull() ? INT64_NULL
+                                  : ValuePeeker::PeekAsBigInt(expected),
+                values[itr]);
+    }
+  }
+  EXPECT_FALSE(compressed_tile->GatherIntegers(
+      2, tuple_offsets.data(), tuple_offsets.size(), values.data()));
+
+  std::vector<double> doubles(tuple_offsets.size());
+  EXPECT_TRUE(compressed_tile->GatherDoubles(
+      3, tuple_offsets.data(), tuple_offsets.size(), doubles.data()));
+  EXPECT_EQ(999 * 1.5, doubles[0]);
+  EXPECT_EQ(501 * 1.5, doubles[3]);
+}
+
+TEST_F(CompressedTileTests, TileGroupTest) {
+  auto tile_group = ExecutorTestsUtil::CreateTileGroup(tuple_count);
+  ExecutorTestsUtil::PopulateTiles(tile_group, tuple_count);
+
+  WaitUntilCold(tile_group.get());
+
+  std::vector<std::shared_ptr<storage::Tile>> plain_tiles;
+  auto is_cold = [&tile_group] {
+    return storage::TileGroupCompressor::IsCold(tile_group.get());
+  };
+  EXPECT_TRUE(tile_group->CompressTiles(is_cold, plain_tiles));
+  EXPECT_TRUE(tile_group->IsCompressed());
+  EXPECT_FALSE(tile_group->CompressTiles(is_cold, plain_tiles));
+  EXPECT_EQ(tile_group->GetTileCount(), plain_tiles.size());
+
+  for (oid_t tile_itr = 0; tile_itr < tile_group->GetTileCount();
+       tile_itr++) {
+    EXPECT_TRUE(tile_group->GetTile(tile_itr)->IsCompressed());
+    CheckValues(plain_tiles[tile_itr].get(), tile_group->GetTile(tile_itr));
+  }
+
+  // Predicates evaluate over the compressed tiles, ATTR0 >= 200 and
+  // ATTR2 < 302.5
+  std::unique_ptr<expression::AbstractExpression> predicate(
+      expression::ExpressionUtil::ConjunctionFactory(
+          EXPRESSION_TYPE_CONJUNCTION_AND,
+          expression::ExpressionUtil::ComparisonFactory(
+              EXPRESSION_TYPE_COMPARE_GREATERTHANOREQUALTO,
+              expression::ExpressionUtil::TupleValueFactory(
+                  VALUE_TYPE_INTEGER, 0, 0),
+              expression::ExpressionUtil::ConstantValueFactory(
+                  ValueFactory::GetIntegerValue(200))),
+          expression::ExpressionUtil::ComparisonFactory(
+              EXPRESSION_TYPE_COMPARE_LESSTHAN,
+              expression::ExpressionUtil::TupleValueFactory(
+                  VALUE_TYPE_DOUBLE, 0, 2),
+              expression::ExpressionUtil::ConstantValueFactory(
+                  ValueFactory::GetDoubleValue(302.5)))));
+
+  expression::SelectionVector selection(tuple_count);
+  std::iota(selection.begin(), selection.end(), 0);
+  expression::BatchSource source(tile_group.get());
+  predicate->EvaluateBatch(source, selection, nullptr);
+
+  expression::SelectionVector expected;
+  for (oid_t tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    expression::ContainerTuple<storage::TileGroup> tuple(tile_group.get(),
+                                                         tuple_itr);
+    if (predicate->Evaluate(&tuple, nullptr, nullptr).IsTrue()) {
+      expected.push_back(tuple_itr);
+    }
+  }
+  EXPECT_EQ(11, expected.size());
+  EXPECT_EQ(expected, selection);
+
+  // A write swaps plain tiles back in
+  std::unique_ptr<catalog::Schema> schema(
+      catalog::Schema::AppendSchemaList(tile_group->GetTileSchemas()));
+  storage::Tuple tuple(schema.get(), true);
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+  tuple.SetValue(0, ValueFactory::GetIntegerValue(-1), testing_pool);
+  tuple.SetValue(1, ValueFactory::GetIntegerValue(-2), testing_pool);
+  tuple.SetValue(2, ValueFactory::GetDoubleValue(-3), testing_pool);
+  tuple.SetValue(3, ValueFactory::GetStringValue("updated"), testing_pool);
+  tile_group->CopyTuple(&tuple, 5);
+
+  EXPECT_FALSE(tile_group->IsCompressed());
+  EXPECT_FALSE(tile_group->GetTile(0)->IsCompressed());
+  EXPECT_EQ(-1, ValuePeeker::PeekInteger(tile_group->GetValue(5, 0)));
+  EXPECT_TRUE(tile_group->GetValue(5, 3)
+                  .OpEquals(ValueFactory::GetStringValue("updated"))
+                  .IsTrue());
+  EXPECT_TRUE(plain_tiles[0]->GetValue(6, 0).OpEquals(
+      tile_group->GetValue(6, 0)).IsTrue());
+
+  storage::TileGroupCompressor::GetInstance().RetireTiles(plain_tiles);
+  EXPECT_TRUE(plain_tiles.empty());
+}
+
+}  // namespace test
+}  // namespace peloton
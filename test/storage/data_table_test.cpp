@@ -11,6 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 
+#include <set>
+#include <thread>
+
 #include "common/harness.h"
 
 #include "storage/data_table.h"
@@ -70,6 +73,58 @@ TEST_F(DataTableTests, TransformTileGroupTest) {
   data_table->TransformTileGroup(0, theta);
 }
 
+void InsertThroughActiveTileGroup(storage::DataTable *table,
+                                  const int tuple_count,
+                                  std::set<oid_t> *tile_group_ids,
+                                  UNUSED_ATTRIBUTE uint64_t thread_itr) {
+  auto testing_pool = TestingHarness::GetInstance().GetTestingPool();
+
+  for (int tuple_itr = 0; tuple_itr < tuple_count; tuple_itr++) {
+    auto tuple = ExecutorTestsUtil::GetTuple(table, tuple_itr, testing_pool);
+    ItemPointer location = table->InsertTuple(tuple.get());
+    EXPECT_NE(INVALID_OID, location.block);
+
+    tile_group_ids->insert(location.block);
+  }
+}
+
+TEST_F(DataTableTests, ActiveTileGroupTest) {
+  const int thread_count = 4;
+  const int tuples_per_tilegroup = 5;
+  const int tuple_count = 2 * tuples_per_tilegroup;
+
+  // Every thread gets an active tile group up front
+  peloton_active_tile_group_count = thread_count;
+  std::unique_ptr<storage::DataTable> data_table(
+      ExecutorTestsUtil::CreateTable(tuples_per_tilegroup, false));
+  peloton_active_tile_group_count = 0;
+
+  EXPECT_EQ(thread_count, (int)data_table->GetTileGroupCount());
+
+  std::vector<std::set<oid_t>> tile_group_ids(thread_count);
+  std::vector<std::thread> threads;
+  for (int thread_itr = 0; thread_itr < thread_count; thread_itr++) {
+    threads.push_back(std::thread(InsertThroughActiveTileGroup,
+                                  data_table.get(), tuple_count,
+                                  &tile_group_ids[thread_itr], thread_itr));
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Threads never share a tile group
+  std::set<oid_t> all_tile_group_ids;
+  for (auto &thread_tile_group_ids : tile_group_ids) {
+    EXPECT_EQ(2, (int)thread_tile_group_ids.size());
+    all_tile_group_ids.insert(thread_tile_group_ids.begin(),
+                              thread_tile_group_ids.end());
+  }
+  EXPECT_EQ(2 * thread_count, (int)all_tile_group_ids.size());
+
+  // Each filled tile group was replaced before the next insert needed it
+  EXPECT_EQ(3 * thread_count, (int)data_table->GetTileGroupCount());
+}
+
 std::unique_ptr<storage::DataTable> data_table_test_table;
 
 TEST_F(DataTableTests, GlobalTableTest) {
@@ -0,0 +1,173 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// tile_group_header_test.cpp
+//
+// Identification: test/storage/tile_group_header_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include <cstring>
+#include <memory>
+
+#include "common/harness.h"
+
+#include "catalog/schema.h"
+#include "common/platform.h"
+#include "concurrency/transaction_manager_factory.h"
+#include "executor/executor_context.h"
+#include "executor/logical_tile.h"
+#include "executor/seq_scan_executor.h"
+#include "planner/seq_scan_plan.h"
+#include "storage/data_table.h"
+#include "storage/table_factory.h"
+#include "storage/tile_group.h"
+#include "storage/tile_group_header.h"
+
+#include "executor/executor_tests_util.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Tile Group Header Tests
+//===--------------------------------------------------------------------===//
+
+class TileGroupHeaderTests : public PelotonTest {};
+
+namespace {
+
+const int tuple_count = 100;
+
+// Give every field of every slot a value derived from the slot
+void FillHeader(storage::TileGroupHeader &header) {
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    header.SetTransactionId(tuple_slot_id, 1000 + tuple_slot_id);
+    header.SetBeginCommitId(tuple_slot_id, 2000 + tuple_slot_id);
+    header.SetEndCommitId(tuple_slot_id, 3000 + tuple_slot_id);
+    header.SetNextItemPointer(tuple_slot_id, ItemPointer(1, tuple_slot_id));
+    header.SetPrevItemPointer(tuple_slot_id, ItemPointer(2, tuple_slot_id));
+    std::memset(header.GetReservedFieldRef(tuple_slot_id), tuple_slot_id,
+                storage::TileGroupHeader::GetReservedSize());
+    header.SetInsertCommit(tuple_slot_id, tuple_slot_id % 2 == 0);
+    header.SetDeleteCommit(tuple_slot_id, tuple_slot_id % 3 == 0);
+  }
+}
+
+void CheckHeader(storage::TileGroupHeader &header) {
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    EXPECT_EQ(1000 + tuple_slot_id, header.GetTransactionId(tuple_slot_id));
+    EXPECT_EQ(2000 + tuple_slot_id, header.GetBeginCommitId(tuple_slot_id));
+    EXPECT_EQ(3000 + tuple_slot_id, header.GetEndCommitId(tuple_slot_id));
+    EXPECT_EQ(1, header.GetNextItemPointer(tuple_slot_id).block);
+    EXPECT_EQ(tuple_slot_id, header.GetNextItemPointer(tuple_slot_id).offset);
+    EXPECT_EQ(2, header.GetPrevItemPointer(tuple_slot_id).block);
+    EXPECT_EQ(tuple_slot_id, header.GetPrevItemPointer(tuple_slot_id).offset);
+    char *reserved_field = header.GetReservedFieldRef(tuple_slot_id);
+    for (size_t byte_itr = 0;
+         byte_itr < storage::TileGroupHeader::GetReservedSize(); byte_itr++) {
+      EXPECT_EQ((char)tuple_slot_id, reserved_field[byte_itr]);
+    }
+    EXPECT_EQ(tuple_slot_id % 2 == 0, header.GetInsertCommit(tuple_slot_id));
+    EXPECT_EQ(tuple_slot_id % 3 == 0, header.GetDeleteCommit(tuple_slot_id));
+  }
+}
+
+}  // namespace
+
+TEST_F(TileGroupHeaderTests, LayoutTest) {
+  storage::TileGroupHeader row_header(BACKEND_TYPE_MM, tuple_count,
+                                      HEADER_LAYOUT_ROW);
+  storage::TileGroupHeader column_header(BACKEND_TYPE_MM, tuple_count,
+                                         HEADER_LAYOUT_COLUMN);
+
+  // Fields must not overlap in either layout
+  FillHeader(row_header);
+  CheckHeader(row_header);
+  FillHeader(column_header);
+  CheckHeader(column_header);
+
+  // Only the column layout exposes the visibility arrays
+  EXPECT_EQ(nullptr, row_header.GetTransactionIdArray());
+
+  const txn_id_t *txn_ids = column_header.GetTransactionIdArray();
+  const cid_t *begin_cids = column_header.GetBeginCommitIdArray();
+  const cid_t *end_cids = column_header.GetEndCommitIdArray();
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(txn_ids) % CACHELINE_SIZE);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(begin_cids) % CACHELINE_SIZE);
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(end_cids) % CACHELINE_SIZE);
+
+  for (oid_t tuple_slot_id = 0; tuple_slot_id < tuple_count; tuple_slot_id++) {
+    EXPECT_EQ(column_header.GetTransactionId(tuple_slot_id),
+              txn_ids[tuple_slot_id]);
+    EXPECT_EQ(column_header.GetBeginCommitId(tuple_slot_id),
+              begin_cids[tuple_slot_id]);
+    EXPECT_EQ(column_header.GetEndCommitId(tuple_slot_id),
+              end_cids[tuple_slot_id]);
+  }
+}
+
+TEST_F(TileGroupHeaderTests, CopyAcrossLayoutsTest) {
+  storage::TileGroupHeader row_header(BACKEND_TYPE_MM, tuple_count,
+                                      HEADER_LAYOUT_ROW);
+  storage::TileGroupHeader column_header(BACKEND_TYPE_MM, tuple_count,
+                                         HEADER_LAYOUT_COLUMN);
+  storage::TileGroupHeader other_row_header(BACKEND_TYPE_MM, tuple_count,
+                                            HEADER_LAYOUT_ROW);
+
+  FillHeader(row_header);
+  column_header = row_header;
+  CheckHeader(column_header);
+
+  other_row_header = column_header;
+  CheckHeader(other_row_header);
+}
+
+// Tuples inserted into a table with the column layout are found by scans
+TEST_F(TileGroupHeaderTests, ColumnLayoutScanTest) {
+  const int tuples_per_tilegroup = 10;
+  const int row_count = 55;
+
+  catalog::Schema *table_schema = new catalog::Schema(
+      {ExecutorTestsUtil::GetColumnInfo(0), ExecutorTestsUtil::GetColumnInfo(1),
+       ExecutorTestsUtil::GetColumnInfo(2),
+       ExecutorTestsUtil::GetColumnInfo(3)});
+  std::unique_ptr<storage::DataTable> table(storage::TableFactory::GetDataTable(
+      INVALID_OID, INVALID_OID, table_schema, "TEST_TABLE",
+      tuples_per_tilegroup, true, false, HEADER_LAYOUT_COLUMN));
+  EXPECT_EQ(HEADER_LAYOUT_COLUMN, table->GetHeaderLayout());
+
+  auto &txn_manager = concurrency::TransactionManagerFactory::GetInstance();
+  txn_manager.BeginTransaction();
+  ExecutorTestsUtil::PopulateTable(table.get(), row_count, false, false,
+                                   false);
+  txn_manager.CommitTransaction();
+
+  EXPECT_EQ(HEADER_LAYOUT_COLUMN,
+            table->GetTileGroup(0)->GetHeader()->GetHeaderLayout());
+
+  auto txn = txn_manager.BeginTransaction();
+  std::unique_ptr<executor::ExecutorContext> context(
+      new executor::ExecutorContext(txn));
+
+  planner::SeqScanPlan scan_node(table.get(), nullptr, {0});
+  executor::SeqScanExecutor scan_executor(&scan_node, context.get());
+
+  size_t result_tuple_count = 0;
+  EXPECT_TRUE(scan_executor.Init());
+  while (scan_executor.Execute()) {
+    std::unique_ptr<executor::LogicalTile> result_tile(
+        scan_executor.GetOutput());
+    result_tuple_count += result_tile->GetTupleCount();
+  }
+  EXPECT_EQ(row_count, result_tuple_count);
+
+  txn_manager.CommitTransaction();
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -0,0 +1,137 @@
+//===----------------------------------------------------------------------===//
+//
+//                         Peloton
+//
+// plan_cache_test.cpp
+//
+// Identification: test/tcop/plan_cache_test.cpp
+//
+// Copyright (c) 2015-16, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+
+#include "common/harness.h"
+
+#include "catalog/catalog.h"
+#include "common/value_peeker.h"
+#include "planner/mock_plan.h"
+#include "tcop/plan_cache.h"
+
+namespace peloton {
+namespace test {
+
+//===--------------------------------------------------------------------===//
+// Plan Cache Test
+//===--------------------------------------------------------------------===//
+
+class PlanCacheTest : public PelotonTest {};
+
+TEST_F(PlanCacheTest, NormalizeLiterals) {
+  std::string normalized_query;
+  std::vector<Value> params;
+
+  EXPECT_TRUE(tcop::PlanCache::NormalizeQuery(
+      "SELECT a, b FROM foo WHERE id = 5 AND name = 'it''s';",
+      normalized_query, params));
+  EXPECT_EQ("SELECT a, b FROM foo WHERE id = $1 AND name = $2",
+            normalized_query);
+  EXPECT_EQ(2, params.size());
+  EXPECT_EQ(5, ValuePeeker::PeekInteger(params[0]));
+  EXPECT_EQ("it's", ValuePeeker::PeekStringCopyWithoutNull(params[1]));
+
+  // Same shape, different literals and spacing
+  std::string other_query;
+  EXPECT_TRUE(tcop::PlanCache::NormalizeQuery(
+      "SELECT  a, b FROM foo\n WHERE id = 7 AND name = 'bar'", other_query,
+      params));
+  EXPECT_EQ(normalized_query, other_query);
+
+  // Positional references, identifiers and type modifiers stay put
+  EXPECT_TRUE(tcop::PlanCache::NormalizeQuery(
+      "SELECT c1, CAST(c2 AS VARCHAR(32)) FROM t2 ORDER BY 1, 2 LIMIT 10",
+      normalized_query, params));
+  EXPECT_EQ("SELECT c1, CAST(c2 AS VARCHAR(32)) FROM t2 ORDER BY 1, 2 LIMIT $1",
+            normalized_query);
+  EXPECT_EQ(1, params.size());
+
+  // Big and floating point numbers
+  EXPECT_TRUE(tcop::PlanCache::NormalizeQuery(
+      "UPDATE foo SET x = 1.5e3 WHERE id = 8589934592", normalized_query,
+      params));
+  EXPECT_EQ("UPDATE foo SET x = $1 WHERE id = $2", normalized_query);
+  EXPECT_EQ(VALUE_TYPE_DOUBLE, params[0].GetValueType());
+  EXPECT_EQ(VALUE_TYPE_BIGINT, params[1].GetValueType());
+
+  // DDL and statements that already carry parameters are not cached
+  EXPECT_FALSE(tcop::PlanCache::NormalizeQuery(
+      "CREATE TABLE foo (id INT, name VARCHAR(32))", normalized_query,
+      params));
+  EXPECT_FALSE(tcop::PlanCache::NormalizeQuery(
+      "SELECT * FROM foo WHERE id = $1", normalized_query, params));
+}
+
+TEST_F(PlanCacheTest, HitMissInvalidate) {
+  tcop::PlanCache plan_cache;
+  std::shared_ptr<planner::AbstractPlan> plan(new MockPlan());
+
+  std::string query = "SELECT * FROM foo WHERE id = $1";
+  EXPECT_EQ(nullptr, plan_cache.Find(query).get());
+  EXPECT_EQ(1, plan_cache.GetMissCount());
+
+  plan_cache.Insert(query, plan);
+  EXPECT_EQ(plan.get(), plan_cache.Find(query).get());
+  EXPECT_EQ(plan.get(), plan_cache.Find(query).get());
+  EXPECT_EQ(2, plan_cache.GetHitCount());
+  EXPECT_EQ(1, plan_cache.GetSize());
+
+  // DDL makes the cached plan stale
+  catalog::Catalog::BumpSchemaVersion();
+  EXPECT_EQ(nullptr, plan_cache.Find(query).get());
+  EXPECT_EQ(1, plan_cache.GetInvalidationCount());
+  EXPECT_EQ(2, plan_cache.GetMissCount());
+
+  // Re-planning replaces the stale entry
+  plan_cache.Insert(query, plan);
+  EXPECT_EQ(plan.get(), plan_cache.Find(query).get());
+  EXPECT_EQ(1, plan_cache.GetSize());
+}
+
+TEST_F(PlanCacheTest, Eviction) {
+  // Every shard keeps a single plan
+  tcop::PlanCache plan_cache(1);
+  std::shared_ptr<planner::AbstractPlan> plan(new MockPlan());
+  const size_t query_count = 100;
+
+  for (size_t query_itr = 0; query_itr < query_count; query_itr++) {
+    plan_cache.Insert("SELECT * FROM foo" + std::to_string(query_itr), plan);
+  }
+
+  EXPECT_LE(plan_cache.GetSize(), PLAN_CACHE_SHARD_COUNT);
+  EXPECT_EQ(query_count - plan_cache.GetSize(),
+            plan_cache.GetEvictionCount());
+}
+
+TEST_F(PlanCacheTest, ConcurrentAccess) {
+  tcop::PlanCache plan_cache;
+  std::shared_ptr<planner::AbstractPlan> plan(new MockPlan());
+  const size_t query_count = 32;
+
+  auto worker = [&plan_cache, &plan, query_count](uint64_t thread_itr) {
+    for (size_t itr = 0; itr < 1000; itr++) {
+      auto query = "SELECT * FROM foo" +
+                   std::to_string((thread_itr + itr) % query_count);
+      if (plan_cache.Find(query).get() == nullptr) {
+        plan_cache.Insert(query, plan);
+      }
+    }
+  };
+
+  LaunchParallelTest(8, worker);
+
+  EXPECT_EQ(query_count, plan_cache.GetSize());
+  EXPECT_EQ(8 * 1000, plan_cache.GetHitCount() + plan_cache.GetMissCount());
+}
+
+}  // End test namespace
+}  // End peloton namespace
@@ -527,6 +527,27 @@ public:
         return (st == ok);
     }
 
+    //! erase_fn runs \p fn on the value associated with \p key and removes
+    //! the key if \p fn returns true, all under the same locks. If \p key is
+    //! not there, it returns false, otherwise it returns true.
+    template <typename Fn>
+    bool erase_fn(const key_type& key, Fn fn) {
+        size_t hv = hashed_key(key);
+        auto b = snapshot_and_lock_two(hv);
+        bool should_erase = false;
+        const cuckoo_status st = cuckoo_update_fn(
+            key, [&fn, &should_erase](mapped_type& val) {
+                should_erase = fn(val);
+            }, hv, b.i[0], b.i[1]);
+        if (st != ok) {
+            return false;
+        }
+        if (should_erase) {
+            cuckoo_delete(key, hv, b.i[0], b.i[1]);
+        }
+        return true;
+    }
+
     //! update changes the value associated with \p key to \p val. If \p key is
     //! not there, it returns false, otherwise it returns true.
     template <typename V>